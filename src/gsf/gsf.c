@@ -147,6 +147,7 @@
 #include <math.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <pthread.h>
 
 /* rely on the network type definitions of (u_short, and u_int) */
 #if !defined WIN32 && !defined WIN64
@@ -203,18 +204,22 @@
 #define GSF_S_INT_MIN   (-2147483648.0)
 #define GSF_S_INT_MAX    (2147483647.0)
 
-/* Static Global data for this module */
-static unsigned char streamBuff[GSF_MAX_RECORD_SIZE];
+/* Static Global data for this module - the file table slots are claimed
+ * and released under gsfFileTableMutex, after which each slot, including
+ * its record stream buffer, belongs to the thread using that handle.
+ */
 static int      numOpenFiles;
 static GSF_FILE_TABLE gsfFileTable[GSF_MAX_OPEN_FILES];
+static pthread_mutex_t gsfFileTableMutex = PTHREAD_MUTEX_INITIALIZER;
 
 /* Global external data defined in this module */
-int             gsfError;       /* used to report most recent error */
+GSF_THREAD_LOCAL int gsfError;  /* used to report most recent error of this thread */
 
 /* Static functions used, but not exported from this source file */
 static gsfuLong gsfChecksum(unsigned char *buff, unsigned int num_bytes);
 static int      gsfSeekRecord(int handle, gsfDataID *id);
 static int      gsfUnpackStream (int handle, int desiredRecord, gsfDataID *dataID, gsfRecords *rptr, unsigned char *buf, int max_size);
+static int      gsfPackStream (int handle, gsfDataID *id, gsfRecords *rptr);
 static int      gsfSetParam(int handle, int index, const char *val, gsfRecords *rec);
 static int      gsfNumberParams(const char *param);
 
@@ -430,8 +435,10 @@ gsfOpenBuffered(const char *filename, const int mode, int *handle, int buf_size)
     }
 
     /* Check the number of files currently opened. */
+    pthread_mutex_lock(&gsfFileTableMutex);
     if (numOpenFiles >= GSF_MAX_OPEN_FILES)
     {
+        pthread_mutex_unlock(&gsfFileTableMutex);
         gsfError = GSF_TOO_MANY_OPEN_FILES;
         return (-1);
     }
@@ -439,6 +446,7 @@ gsfOpenBuffered(const char *filename, const int mode, int *handle, int buf_size)
     /* Try to open this file */
     if ((fp = fopen(filename, access_mode)) == (FILE *) NULL)
     {
+        pthread_mutex_unlock(&gsfFileTableMutex);
         gsfError = GSF_FOPEN_ERROR;
         return (-1);
     }
@@ -485,6 +493,8 @@ gsfOpenBuffered(const char *filename, const int mode, int *handle, int buf_size)
     /* if still no free table is found error out */
     if (fileTableIndex == GSF_MAX_OPEN_FILES)
     {
+        numOpenFiles--;
+        pthread_mutex_unlock(&gsfFileTableMutex);
         gsfError = GSF_TOO_MANY_OPEN_FILES;
         fclose(fp);
         return (-1);
@@ -493,7 +503,21 @@ gsfOpenBuffered(const char *filename, const int mode, int *handle, int buf_size)
     gsfFileTable[fileTableIndex].fp = fp;
     gsfFileTable[fileTableIndex].buf_size = buf_size;
     gsfFileTable[fileTableIndex].occupied = 1;
+    gsfFileTable[fileTableIndex].last_error = 0;
     *handle = fileTableIndex + 1;
+    pthread_mutex_unlock(&gsfFileTableMutex);
+
+    /* Each file has its own record stream buffer so that separate threads
+     * can read and write separate files at the same time.
+     */
+    gsfFileTable[fileTableIndex].stream_buff = (unsigned char *) malloc(GSF_MAX_RECORD_SIZE);
+    if (gsfFileTable[fileTableIndex].stream_buff == (unsigned char *) NULL)
+    {
+        gsfClose ((int) *handle);
+        gsfError = GSF_MEMORY_ALLOCATION_FAILED;
+        *handle = 0;
+        return (-1);
+    }
 
     /* Set the desired buffer size. */
     if (setvbuf(fp, NULL, _IOFBF, buf_size))
@@ -738,7 +762,12 @@ gsfClose(const int handle)
         ret = -1;
     }
 
-    numOpenFiles--;
+    /* Release the record stream buffer */
+    if (gsfFileTable[handle-1].stream_buff)
+    {
+        free(gsfFileTable[handle-1].stream_buff);
+        gsfFileTable[handle-1].stream_buff = (unsigned char *) NULL;
+    }
 
     /* jsb 05/14/97 Clear the contents of the gsfFileTable fields. We don't
      * want to clear the filename, this allows a performance improvement for
@@ -750,7 +779,6 @@ gsfClose(const int handle)
     gsfFileTable[handle-1].previous_record = 0;
     gsfFileTable[handle-1].buf_size = 0;
     gsfFileTable[handle-1].bufferedBytes = 0;
-    gsfFileTable[handle-1].occupied = 0;
     gsfFileTable[handle-1].update_flag = 0;
     gsfFileTable[handle-1].direct_access = 0;
     gsfFileTable[handle-1].read_write_flag = 0;
@@ -768,6 +796,12 @@ gsfClose(const int handle)
     /* Clear the necessary fields of the gsfRecords data structure */
     memset(&gsfFileTable[handle-1].rec.header, 0, sizeof(gsfHeader));
 
+    /* Release the file table slot last, once it may be reused by another thread */
+    pthread_mutex_lock(&gsfFileTableMutex);
+    gsfFileTable[handle-1].occupied = 0;
+    numOpenFiles--;
+    pthread_mutex_unlock(&gsfFileTableMutex);
+
     return (ret);
 }
 
@@ -966,6 +1000,7 @@ gsfRead(int handle, int desiredRecord, gsfDataID *dataID, gsfRecords *rptr, unsi
         if (ret < 0)
         {
             /* gsfError is set in gsfSeekRecord */
+            gsfFileTable[handle - 1].last_error = gsfError;
             return (-1);
         }
     }
@@ -973,6 +1008,7 @@ gsfRead(int handle, int desiredRecord, gsfDataID *dataID, gsfRecords *rptr, unsi
     ret = gsfUnpackStream (handle, desiredRecord, dataID, rptr, buf, max_size);
 
     gsfFileTable[handle - 1].last_record_type = dataID->recordID;
+    gsfFileTable[handle - 1].last_error = gsfError;
 
     return (ret);
 }
@@ -1040,7 +1076,8 @@ gsfUnpackStream (int handle, int desiredRecord, gsfDataID *dataID, gsfRecords *r
     gsfuLong        did;
     gsfDataID       thisID;
     gsfuLong        temp;
-    unsigned char  *dptr = streamBuff;
+    unsigned char  *streamBuff;
+    unsigned char  *dptr;
     gsfuLong        ckSum;
 
     if ((handle < 1) || (handle > GSF_MAX_OPEN_FILES))
@@ -1048,6 +1085,8 @@ gsfUnpackStream (int handle, int desiredRecord, gsfDataID *dataID, gsfRecords *r
         gsfError = GSF_BAD_FILE_HANDLE;
         return (-1);
     }
+    streamBuff = gsfFileTable[handle - 1].stream_buff;
+    dptr = streamBuff;
 
     /* This loop will read one record at a time until the record type
      * desired by the caller is found.
@@ -1585,6 +1624,47 @@ gsfSeekRecord(int handle, gsfDataID *id)
 int
 gsfWrite(int handle, gsfDataID *id, gsfRecords *rptr)
 {
+    int             ret;
+
+    ret = gsfPackStream (handle, id, rptr);
+
+    /* Keep the error code with the file for gsfHandleIntError */
+    if ((handle >= 1) && (handle <= GSF_MAX_OPEN_FILES))
+    {
+        gsfFileTable[handle - 1].last_error = gsfError;
+    }
+
+    return (ret);
+}
+
+/********************************************************************
+ *
+ * Function Name : gsfPackStream
+ *
+ * Description : gsfPackStream is a static function (not available to
+ *   application programs) which performs the encoding and writing of a
+ *   record for gsfWrite, using the record stream buffer of the file.
+ *
+ * Inputs :
+ *  handle = the handle for this file as returned by gsfOpen
+ *  id = a pointer to a gsfDataID containing the record id information for
+ *       the record to write.
+ *  rptr = a pointer to a gsfRecords structure from which to get the internal
+ *         form of the record to be written to the file.
+ *
+ * Returns :
+ *   This function returns the number of bytes written if successful,
+ *   or -1 if an error occurred.
+ *
+ * Error Conditions :
+ *   See gsfWrite
+ *
+ ********************************************************************/
+
+static int
+gsfPackStream(int handle, gsfDataID *id, gsfRecords *rptr)
+{
+    unsigned char  *streamBuff;
     unsigned char  *ucptr;
     gsfuLong        tmpBuff[3] =
     {0, 0, 0};
@@ -1605,6 +1685,7 @@ gsfWrite(int handle, gsfDataID *id, gsfRecords *rptr)
         gsfError = GSF_BAD_FILE_HANDLE;
         return (-1);
     }
+    streamBuff = gsfFileTable[handle - 1].stream_buff;
 
     /* See if we need to make room for the optional checksum */
     if (id->checksumFlag)
@@ -2404,6 +2485,35 @@ int gsfIntError(void)
     return gsfError;
 }
 
+/********************************************************************
+ *
+ * Function Name : gsfHandleIntError
+ *
+ * Description : This function is used to return the error code of the
+ *   most recent gsfRead or gsfWrite on the specified file.  It is not
+ *   affected by calls made on other files, so it may be used by
+ *   applications which work with several GSF files from several threads.
+ *
+ * Inputs :
+ *   handle = the handle of the GSF file as returned by gsfOpen
+ *
+ * Returns : constant integer value representing the most recent error
+ *   for this file
+ *
+ * Error Conditions : none
+ *
+ ********************************************************************/
+
+int gsfHandleIntError(const int handle)
+{
+    if ((handle < 1) || (handle > GSF_MAX_OPEN_FILES))
+    {
+        return GSF_BAD_FILE_HANDLE;
+    }
+
+    return gsfFileTable[handle - 1].last_error;
+}
+
 /********************************************************************
  *
  * Function Name : gsfStringError
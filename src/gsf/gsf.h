@@ -171,6 +171,15 @@
 #define OPTLK
 #endif
 
+/* Storage class of gsfError, which is kept per thread so that separate
+ * threads may each work with their own GSF files.
+ */
+#if defined(_MSC_VER)
+#define GSF_THREAD_LOCAL __declspec(thread)
+#else
+#define GSF_THREAD_LOCAL __thread
+#endif
+
 #ifdef __cplusplus
 extern          "C"
 {
@@ -184,8 +193,9 @@ extern          "C"
 /* Define largest ever expected record size */
 #define GSF_MAX_RECORD_SIZE    524288
 
-/* Define the maximum number of files which may be open at once */
-#define GSF_MAX_OPEN_FILES     4
+/* Define the maximum number of files which may be open at once - enough
+ * for an input and an output file in each of several threads */
+#define GSF_MAX_OPEN_FILES     32
 
 /* Define the GSF data file access flags */
 #define GSF_CREATE             1
@@ -2704,6 +2714,21 @@ int gsfIntError(void);
  * Error Conditions : none
  */
 
+int gsfHandleIntError(const int handle);
+/* Description : This function is used to return the error code of the
+ *  most recent gsfRead or gsfWrite on the specified file.  Unlike
+ *  gsfIntError it is not affected by calls made on other files, so it may
+ *  be used when several threads each read or write their own GSF file.
+ *
+ * Inputs :
+ *  handle = the handle of the GSF file as returned by gsfOpen
+ *
+ * Returns : constant integer value representing the most recent error
+ *  for this file, or GSF_BAD_FILE_HANDLE
+ *
+ * Error Conditions : none
+ */
+
 const char *gsfStringError(void);
 /* Description : This function is used to return a short message describing
  *  the most recent error encountered.  This function need only be called if
@@ -57,7 +57,7 @@
 
 
 /* Global external data defined in this module */
-extern int gsfError;       /* Defined in gsf.c */
+extern GSF_THREAD_LOCAL int gsfError;       /* Defined in gsf.c */
 
 /* TODO: Remove this from here and in gsf_dec.c and move into the filetable structure.
          The decode routines should be modified to return the (re)allocated array size. */
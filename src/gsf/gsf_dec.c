@@ -139,7 +139,7 @@ short    arraySize[GSF_MAX_OPEN_FILES][GSF_MAX_PING_ARRAY_SUBRECORDS];
 static short   *samplesArraySize[GSF_MAX_OPEN_FILES];
 
 /* Global external data defined in this module */
-extern int      gsfError;  /* Defined in gsf.c */
+extern GSF_THREAD_LOCAL int gsfError;  /* Defined in gsf.c */
 
 int DecodeCompressedUnsignedShortArray (unsigned short **array, const unsigned char *sptr, int num_beams, int compressed_size, int subrecordID, int handle);
 int DecodeCompressedArray (double **array, const unsigned char *sptr, int num_beams, int compressed_size, const gsfScaleFactors *sf, int subrecordID, int handle);
@@ -131,7 +131,7 @@
 #include "gsf_enc.h"
 
 /* Global external data defined in this module */
-extern int      gsfError;  /* Defined in gsf.c */
+extern GSF_THREAD_LOCAL int gsfError;  /* Defined in gsf.c */
 
 int EncodeCompressedUnsignedShortArray (unsigned char *sptr, const unsigned short *array, int num_beams, int subrecordID);
 int EncodeCompressedArray (unsigned char *sptr, const double *array, int num_beams, const gsfScaleFactors *sf, int subrecordID);
@@ -109,6 +109,8 @@ typedef struct t_gsfFileTable
     int             last_record_type;              /* Record type of the last record we successfully read (or wrote) */
     INDEX_DATA      index_data;                    /* Index information used for direct file access */
     gsfRecords      rec;                           /* Our copy of pointers to dynamic memory and scale factors */
+    unsigned char  *stream_buff;                   /* Record byte stream buffer of GSF_MAX_RECORD_SIZE bytes */
+    int             last_error;                    /* gsfError from the most recent read, write or seek */
 }
 GSF_FILE_TABLE;
 
@@ -52,7 +52,7 @@
 #include "gsf.h"
 
 /* Global external data defined in this module */
-extern int      gsfError;  /* Defined in gsf.c */
+extern GSF_THREAD_LOCAL int gsfError;  /* Defined in gsf.c */
 
 /********************************************************************
  *
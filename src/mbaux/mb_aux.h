@@ -221,10 +221,16 @@ void mb_plot_string(double x, double y, double hgt, double angle, char *label);
 /* mb_surface function prototypes */
 int mb_surface(int verbose, int ndat, float *xdat, float *ydat, float *zdat, double xxmin, double xxmax, double yymin,
                double yymax, double xxinc, double yyinc, double ttension, float *sgrid);
+int mb_surface_threads(int verbose, int ndat, float *xdat, float *ydat, float *zdat, double xxmin, double xxmax, double yymin,
+               double yymax, double xxinc, double yyinc, double ttension, int nthreads, float *sgrid);
 int mb_zgrid(float *z, int *n_columns, int *n_rows, float *x1, float *y1, float *dx, float *dy, float *xyz, int *n, float *zpij, int *knxt,
              bool *imnew, float *cay, int *nrng);
 int mb_zgrid2(float *z, int *n_columns, int *n_rows, float *x1, float *y1, float *dx, float *dy, float *xyz, int *n, float *zpij, int *knxt,
               bool *imnew, float *cay, int *nrng);
+int mb_zgrid_threads(float *z, int *n_columns, int *n_rows, float *x1, float *y1, float *dx, float *dy, float *xyz, int *n,
+                     float *zpij, int *knxt, bool *imnew, float *cay, int *nrng, int nthreads);
+int mb_zgrid2_threads(float *z, int *n_columns, int *n_rows, float *x1, float *y1, float *dx, float *dy, float *xyz, int *n,
+                      float *zpij, int *knxt, bool *imnew, float *cay, int *nrng, int nthreads);
 
 /* mb_delaun function prototypes */
 int mb_delaun(int verbose, int npts, double *p1, double *p2, int *ed, int *ntri, int *iv1, int *iv2, int *iv3, int *ct1, int *ct2,
@@ -288,6 +294,31 @@ void mblsqr_lsqr(int m, int n, void (*aprod)(int mode, int m, int n, double x[],
                  int *istop_out, int *itn_out, double *anorm_out, double *acond_out, double *rnorm_out, double *arnorm_out,
                  double *xnorm_out);
 
+/* sparse matrix for mblsqr_lsqr(), used by passing mb_sparse_aprod() as
+   aprod and the mb_sparse_struct as UsrWrk */
+struct mb_sparse_struct {
+  int m;              /* number of rows */
+  int n;              /* number of columns */
+  int nnz;            /* number of nonzero elements */
+  int *row_start;     /* elements of row i are row_start[i] to row_start[i+1]-1 */
+  int *row_col;       /* column of each element by row */
+  double *row_a;      /* value of each element by row */
+  int *col_start;     /* elements of column j are col_start[j] to col_start[j+1]-1 */
+  int *col_row;       /* row of each element by column */
+  double *col_a;      /* value of each element by column */
+  double *scale;      /* column scaling of the preconditioner, or NULL */
+  int nthreads;       /* number of threads computing products */
+  int *row_split;     /* rows computed by each thread */
+  int *col_split;     /* columns computed by each thread */
+  void *pool;         /* thread pool */
+};
+
+int mb_sparse_init(int verbose, int m, int n, int ia_dim, const int *nia, const int *ia, const double *a, int nthreads,
+                   bool precondition, struct mb_sparse_struct *sparse, int *error);
+void mb_sparse_aprod(int mode, int m, int n, double x[], double y[], void *UsrWrk);
+int mb_sparse_unscale(int verbose, struct mb_sparse_struct *sparse, double *x, double *se, int *error);
+int mb_sparse_deall(int verbose, struct mb_sparse_struct *sparse, int *error);
+
 #define ZERO 0.0
 #define ONE 1.0
 
@@ -62,7 +62,9 @@
  *
  */
 
+#include <float.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -504,18 +506,13 @@ void mbcblas_daxpy(const int N, const double alpha, const double *X, const int i
 	if (alpha == 0.0)
 		return;
 
+	/* unit stride loops are written plainly with restrict pointers so
+	   that the compiler emits packed SIMD instructions for them */
 	if (incX == 1 && incY == 1) {
-		const int m = N % 4;
-
-		for (int i = 0; i < m; i++)
-			Y[i] += alpha * X[i];
-
-		for (int i = m; i + 3 < N; i += 4) {
-			Y[i] += alpha * X[i];
-			Y[i + 1] += alpha * X[i + 1];
-			Y[i + 2] += alpha * X[i + 2];
-			Y[i + 3] += alpha * X[i + 3];
-		}
+		const double *restrict xx = X;
+		double *restrict yy = Y;
+		for (int i = 0; i < N; i++)
+			yy[i] += alpha * xx[i];
 	}
 	else {
 		int ix = MBCBLAS_OFFSET(N, incX);
@@ -537,6 +534,12 @@ void mbcblas_daxpy(const int N, const double alpha, const double *X, const int i
   \param[in]     incY
 */
 void mbcblas_dcopy(const int N, const double *X, const int incX, double *Y, const int incY) {
+	if (incX == 1 && incY == 1) {
+		if (N > 0)
+			memcpy(Y, X, N * sizeof(double));
+		return;
+	}
+
 	int ix = MBCBLAS_OFFSET(N, incX);
 	int iy = MBCBLAS_OFFSET(N, incY);
 
@@ -584,6 +587,35 @@ double mbcblas_dnrm2(const int N, const double *X, const int incX) {
 	else if (N == 1)
 		return fabs(X[0]);
 
+	/* unit stride: find the largest element and then sum the squares
+	   scaled by it with independent partial sums, which vectorizes,
+	   rather than rescaling element by element */
+	if (incX == 1) {
+		double amax = 0.0;
+		for (int i = 0; i < N; i++) {
+			const double ax = fabs(X[i]);
+			amax = ax > amax ? ax : amax;
+		}
+		if (amax == 0.0)
+			return 0.0;
+		if (amax >= DBL_MIN && amax <= DBL_MAX) {
+			const double rscale = 1.0 / amax;
+			double ssq[4] = {0.0, 0.0, 0.0, 0.0};
+			int i = 0;
+			for (; i + 3 < N; i += 4) {
+				for (int j = 0; j < 4; j++) {
+					const double xs = X[i + j] * rscale;
+					ssq[j] += xs * xs;
+				}
+			}
+			for (; i < N; i++) {
+				const double xs = X[i] * rscale;
+				ssq[0] += xs * xs;
+			}
+			return amax * sqrt((ssq[0] + ssq[1]) + (ssq[2] + ssq[3]));
+		}
+	}
+
 	double scale = 0.0;
 	double ssq = 1.0;
 	int ix = 0;
@@ -617,6 +649,13 @@ void mbcblas_dscal(const int N, const double alpha, double *X, const int incX) {
 	if (incX <= 0)
 		return;
 
+	if (incX == 1) {
+		double *restrict xx = X;
+		for (int i = 0; i < N; i++)
+			xx[i] *= alpha;
+		return;
+	}
+
 	int ix = MBCBLAS_OFFSET(N, incX);
 
 	for (int i = 0; i < N; i++) {
@@ -1330,3 +1369,376 @@ void mblsqr_lsqr(int m, int n, void (*aprod)(int mode, int m, int n, double x[],
 	return;
 }
 // ---------------------------------------------------------------------
+
+/*----------------------------------------------------------------------
+ *
+ * Sparse matrix products for mblsqr_lsqr().
+ *
+ * The matrix is held in compressed sparse row (CSR) form and also by
+ * columns, so that both y = y + A*x and x = x + A'*y are computed as
+ * gathers with each output element owned by a single thread. The rows
+ * and columns are split between the threads by the number of nonzero
+ * elements, and the threads of a pool persist between products because
+ * LSQR calls mb_sparse_aprod() twice per iteration. The elements are
+ * summed in the same order as the dense row storage used by mb_aprod(),
+ * so the products do not depend on the number of threads.
+ *
+ * If requested the columns are scaled to unit norm (a Jacobi or
+ * diagonal preconditioner), in which case LSQR solves for the scaled
+ * model and mb_sparse_unscale() recovers the solution and its standard
+ * errors.
+ */
+
+/* minimum number of nonzero elements per thread worth a thread */
+#define MB_SPARSE_THREAD_NNZ 32768
+
+struct mb_sparse_pool_struct;
+
+struct mb_sparse_thread_struct {
+	struct mb_sparse_pool_struct *pool;
+	int ithread;
+	pthread_t thread;
+};
+
+struct mb_sparse_pool_struct {
+	struct mb_sparse_struct *sparse;
+	pthread_mutex_t mutex;
+	pthread_cond_t start;
+	pthread_cond_t done;
+	int generation;
+	int ndone;
+	bool quit;
+	int mode;
+	double *x;
+	double *y;
+	int nthreads_started;
+	struct mb_sparse_thread_struct threads[MB_THREAD_MAX];
+};
+
+/*--------------------------------------------------------------------*/
+static void mb_sparse_product(const struct mb_sparse_struct *sparse, int ithread, int mode, double *x, double *y) {
+	if (mode == 1) {
+		const int *row_start = sparse->row_start;
+		const int *row_col = sparse->row_col;
+		const double *row_a = sparse->row_a;
+		for (int i = sparse->row_split[ithread]; i < sparse->row_split[ithread + 1]; i++) {
+			double sum = y[i];
+			for (int k = row_start[i]; k < row_start[i + 1]; k++)
+				sum += row_a[k] * x[row_col[k]];
+			y[i] = sum;
+		}
+	}
+	else if (mode == 2) {
+		const int *col_start = sparse->col_start;
+		const int *col_row = sparse->col_row;
+		const double *col_a = sparse->col_a;
+		for (int j = sparse->col_split[ithread]; j < sparse->col_split[ithread + 1]; j++) {
+			double sum = x[j];
+			for (int k = col_start[j]; k < col_start[j + 1]; k++)
+				sum += col_a[k] * y[col_row[k]];
+			x[j] = sum;
+		}
+	}
+}
+
+/*--------------------------------------------------------------------*/
+static void *mb_sparse_worker(void *arg) {
+	struct mb_sparse_thread_struct *thread = (struct mb_sparse_thread_struct *)arg;
+	struct mb_sparse_pool_struct *pool = thread->pool;
+
+	/* the pool starts at generation zero, before any product is requested */
+	int generation = 0;
+	pthread_mutex_lock(&pool->mutex);
+	while (true) {
+		while (pool->generation == generation && !pool->quit)
+			pthread_cond_wait(&pool->start, &pool->mutex);
+		if (pool->quit)
+			break;
+		generation = pool->generation;
+		const int mode = pool->mode;
+		double *x = pool->x;
+		double *y = pool->y;
+		pthread_mutex_unlock(&pool->mutex);
+
+		mb_sparse_product(pool->sparse, thread->ithread, mode, x, y);
+
+		pthread_mutex_lock(&pool->mutex);
+		pool->ndone++;
+		if (pool->ndone == pool->sparse->nthreads - 1)
+			pthread_cond_signal(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+
+	return (NULL);
+}
+
+/*--------------------------------------------------------------------*/
+/* split count items with cumulative nonzero counts start[] into nsplit
+   ranges of similar numbers of nonzero elements */
+static void mb_sparse_split(int count, const int *start, int nsplit, int *split) {
+	const double nnz = (double)start[count];
+	int i = 0;
+	split[0] = 0;
+	for (int isplit = 1; isplit < nsplit; isplit++) {
+		const double target = nnz * isplit / nsplit;
+		while (i < count && start[i] < target)
+			i++;
+		split[isplit] = i;
+	}
+	split[nsplit] = count;
+}
+
+/*--------------------------------------------------------------------*/
+int mb_sparse_init(int verbose, int m, int n, int ia_dim, const int *nia, const int *ia, const double *a, int nthreads,
+                   bool precondition, struct mb_sparse_struct *sparse, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:      %d\n", verbose);
+		fprintf(stderr, "dbg2       m:            %d\n", m);
+		fprintf(stderr, "dbg2       n:            %d\n", n);
+		fprintf(stderr, "dbg2       ia_dim:       %d\n", ia_dim);
+		fprintf(stderr, "dbg2       nia:          %p\n", (void *)nia);
+		fprintf(stderr, "dbg2       ia:           %p\n", (void *)ia);
+		fprintf(stderr, "dbg2       a:            %p\n", (void *)a);
+		fprintf(stderr, "dbg2       nthreads:     %d\n", nthreads);
+		fprintf(stderr, "dbg2       precondition: %d\n", precondition);
+	}
+
+	memset(sparse, 0, sizeof(struct mb_sparse_struct));
+	sparse->m = m;
+	sparse->n = n;
+	*error = MB_ERROR_NO_ERROR;
+
+	/* count the nonzero elements by row and by column */
+	int nnz = 0;
+	for (int i = 0; i < m; i++)
+		nnz += nia[i];
+	sparse->nnz = nnz;
+	int status = mb_mallocd(verbose, __FILE__, __LINE__, (m + 1) * sizeof(int), (void **)&sparse->row_start, error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, (n + 1) * sizeof(int), (void **)&sparse->col_start, error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, (nnz + 1) * sizeof(int), (void **)&sparse->row_col, error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, (nnz + 1) * sizeof(double), (void **)&sparse->row_a, error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, (nnz + 1) * sizeof(int), (void **)&sparse->col_row, error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, (nnz + 1) * sizeof(double), (void **)&sparse->col_a, error);
+	if (status == MB_SUCCESS && precondition)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, n * sizeof(double), (void **)&sparse->scale, error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, (MB_THREAD_MAX + 1) * sizeof(int), (void **)&sparse->row_split, error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, (MB_THREAD_MAX + 1) * sizeof(int), (void **)&sparse->col_split, error);
+	if (status == MB_FAILURE) {
+		int error2;
+		mb_sparse_deall(verbose, sparse, &error2);
+		return (status);
+	}
+
+	/* copy the rows, then build the columns by counting sort so that
+	   each column holds its elements in row order */
+	memset(sparse->col_start, 0, (n + 1) * sizeof(int));
+	sparse->row_start[0] = 0;
+	for (int i = 0; i < m; i++) {
+		const int k0 = sparse->row_start[i];
+		for (int j = 0; j < nia[i]; j++) {
+			sparse->row_col[k0 + j] = ia[ia_dim * i + j];
+			sparse->row_a[k0 + j] = a[ia_dim * i + j];
+			sparse->col_start[ia[ia_dim * i + j] + 1]++;
+		}
+		sparse->row_start[i + 1] = k0 + nia[i];
+	}
+	for (int j = 0; j < n; j++)
+		sparse->col_start[j + 1] += sparse->col_start[j];
+	for (int i = 0; i < m; i++) {
+		for (int k = sparse->row_start[i]; k < sparse->row_start[i + 1]; k++) {
+			const int j = sparse->row_col[k];
+			const int kk = sparse->col_start[j]++;
+			sparse->col_row[kk] = i;
+			sparse->col_a[kk] = sparse->row_a[k];
+		}
+	}
+	for (int j = n; j > 0; j--)
+		sparse->col_start[j] = sparse->col_start[j - 1];
+	sparse->col_start[0] = 0;
+
+	/* scale each column to unit norm */
+	if (precondition) {
+		for (int j = 0; j < n; j++) {
+			double norm = 0.0;
+			for (int k = sparse->col_start[j]; k < sparse->col_start[j + 1]; k++)
+				norm += sparse->col_a[k] * sparse->col_a[k];
+			sparse->scale[j] = norm > 0.0 ? 1.0 / sqrt(norm) : 1.0;
+			for (int k = sparse->col_start[j]; k < sparse->col_start[j + 1]; k++)
+				sparse->col_a[k] *= sparse->scale[j];
+		}
+		for (int k = 0; k < nnz; k++)
+			sparse->row_a[k] *= sparse->scale[sparse->row_col[k]];
+	}
+
+	/* start the threads - small problems are done by the calling thread */
+	nthreads = MIN(nthreads, MB_THREAD_MAX);
+	nthreads = MIN(nthreads, nnz / MB_SPARSE_THREAD_NNZ);
+	sparse->nthreads = 1;
+	if (nthreads > 1) {
+		struct mb_sparse_pool_struct *pool = NULL;
+		status = mb_mallocd(verbose, __FILE__, __LINE__, sizeof(struct mb_sparse_pool_struct), (void **)&pool, error);
+		if (status == MB_SUCCESS) {
+			memset(pool, 0, sizeof(struct mb_sparse_pool_struct));
+			pool->sparse = sparse;
+			pthread_mutex_init(&pool->mutex, NULL);
+			pthread_cond_init(&pool->start, NULL);
+			pthread_cond_init(&pool->done, NULL);
+			sparse->pool = pool;
+
+			/* thread 0 is the calling thread; if a thread cannot be
+			   started the work is split between those that were */
+			int nstarted = 1;
+			for (int ithread = 1; ithread < nthreads; ithread++) {
+				pool->threads[ithread].pool = pool;
+				pool->threads[ithread].ithread = ithread;
+				if (pthread_create(&pool->threads[ithread].thread, NULL, mb_sparse_worker, &pool->threads[ithread]) != 0)
+					break;
+				nstarted++;
+			}
+			pool->nthreads_started = nstarted;
+			sparse->nthreads = nstarted;
+		}
+		else {
+			*error = MB_ERROR_NO_ERROR;
+			status = MB_SUCCESS;
+		}
+	}
+	mb_sparse_split(m, sparse->row_start, sparse->nthreads, sparse->row_split);
+	mb_sparse_split(n, sparse->col_start, sparse->nthreads, sparse->col_split);
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       nnz:          %d\n", sparse->nnz);
+		fprintf(stderr, "dbg2       nthreads:     %d\n", sparse->nthreads);
+		fprintf(stderr, "dbg2       error:        %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:       %d\n", status);
+	}
+
+	return (status);
+}
+
+/*--------------------------------------------------------------------*/
+void mb_sparse_aprod(int mode, int m, int n, double x[], double y[], void *UsrWrk) {
+	(void)m;  // Unused parameter
+	(void)n;  // Unused parameter
+	// mode == 1 : compute y = y + A*x
+	// mode == 2 : compute x = x + A(transpose)*y
+	struct mb_sparse_struct *sparse = (struct mb_sparse_struct *)UsrWrk;
+	struct mb_sparse_pool_struct *pool = (struct mb_sparse_pool_struct *)sparse->pool;
+
+	if (pool == NULL || sparse->nthreads <= 1) {
+		mb_sparse_product(sparse, 0, mode, x, y);
+		return;
+	}
+
+	pthread_mutex_lock(&pool->mutex);
+	pool->mode = mode;
+	pool->x = x;
+	pool->y = y;
+	pool->ndone = 0;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->mutex);
+
+	mb_sparse_product(sparse, 0, mode, x, y);
+
+	pthread_mutex_lock(&pool->mutex);
+	while (pool->ndone < sparse->nthreads - 1)
+		pthread_cond_wait(&pool->done, &pool->mutex);
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+/*--------------------------------------------------------------------*/
+int mb_sparse_unscale(int verbose, struct mb_sparse_struct *sparse, double *x, double *se, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:      %d\n", verbose);
+		fprintf(stderr, "dbg2       sparse:       %p\n", (void *)sparse);
+		fprintf(stderr, "dbg2       x:            %p\n", (void *)x);
+		fprintf(stderr, "dbg2       se:           %p\n", (void *)se);
+	}
+
+	/* the solution of the scaled problem is scale * x */
+	if (sparse->scale != NULL) {
+		for (int j = 0; j < sparse->n; j++) {
+			x[j] *= sparse->scale[j];
+			if (se != NULL)
+				se[j] *= sparse->scale[j];
+		}
+	}
+
+	const int status = MB_SUCCESS;
+	*error = MB_ERROR_NO_ERROR;
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       error:        %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:       %d\n", status);
+	}
+
+	return (status);
+}
+
+/*--------------------------------------------------------------------*/
+int mb_sparse_deall(int verbose, struct mb_sparse_struct *sparse, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:      %d\n", verbose);
+		fprintf(stderr, "dbg2       sparse:       %p\n", (void *)sparse);
+	}
+
+	/* stop the threads */
+	struct mb_sparse_pool_struct *pool = (struct mb_sparse_pool_struct *)sparse->pool;
+	if (pool != NULL) {
+		pthread_mutex_lock(&pool->mutex);
+		pool->quit = true;
+		pthread_cond_broadcast(&pool->start);
+		pthread_mutex_unlock(&pool->mutex);
+		for (int ithread = 1; ithread < pool->nthreads_started; ithread++)
+			pthread_join(pool->threads[ithread].thread, NULL);
+		pthread_cond_destroy(&pool->done);
+		pthread_cond_destroy(&pool->start);
+		pthread_mutex_destroy(&pool->mutex);
+		mb_freed(verbose, __FILE__, __LINE__, (void **)&sparse->pool, error);
+	}
+
+	mb_freed(verbose, __FILE__, __LINE__, (void **)&sparse->row_start, error);
+	mb_freed(verbose, __FILE__, __LINE__, (void **)&sparse->row_col, error);
+	mb_freed(verbose, __FILE__, __LINE__, (void **)&sparse->row_a, error);
+	mb_freed(verbose, __FILE__, __LINE__, (void **)&sparse->col_start, error);
+	mb_freed(verbose, __FILE__, __LINE__, (void **)&sparse->col_row, error);
+	mb_freed(verbose, __FILE__, __LINE__, (void **)&sparse->col_a, error);
+	mb_freed(verbose, __FILE__, __LINE__, (void **)&sparse->scale, error);
+	mb_freed(verbose, __FILE__, __LINE__, (void **)&sparse->row_split, error);
+	mb_freed(verbose, __FILE__, __LINE__, (void **)&sparse->col_split, error);
+	sparse->nthreads = 0;
+
+	const int status = MB_SUCCESS;
+	*error = MB_ERROR_NO_ERROR;
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       error:        %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:       %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------*/
@@ -65,12 +65,18 @@
  * Author:	D. W. Caress
  * Date:	May 2, 1994
  *
+ * The former file scope variables are now held in a struct mb_surface_struct
+ * local to each call, so that mb_surface() is reentrant, and
+ * mb_surface_threads() optionally splits the relaxation sweeps between
+ * threads.
  *
  */
 
 #include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "mb_aux.h"
 #include "mb_define.h"
@@ -90,234 +96,286 @@ struct MB_SURFACE_DATA {
 	float y;
 	float z;
 	int index;
+	double distance; /* Squared distance to the node given by index, used to sort points within a cell */
 };
 
 struct MB_SURFACE_BRIGGS {
 	double b[6];
 };
 
-static int npoints = 0; /* Number of data points */
-static int n_columns = 0;      /* Number of nodes in x-dir. */
-static int n_rows = 0;      /* Number of nodes in y-dir. (Final grid) */
-static int m_columns = 0;
-static int m_rows = 0;
-static int ij_sw_corner, ij_se_corner, ij_nw_corner, ij_ne_corner;
-static int block_n_columns;             /* Number of nodes in x-dir for a given grid factor */
-static int block_n_rows;             /* Number of nodes in y-dir for a given grid factor */
-static int max_iterations = 250; /* Max iter per call to iterate */
-static int total_iterations = 0;
-static int grid, old_grid; /* Node spacings  */
-static int grid_east;
-static int n_fact = 0;  /* Number of factors in common (n_rows-1, n_columns-1) */
-static int factors[32]; /* Array of common factors */
-static int local_verbose = FALSE;
-static int local_error = MB_ERROR_NO_ERROR;
-static int status = MB_SUCCESS;
-// static int n_empty;                                     /* No of unconstrained nodes at initialization  */
-static int set_low = 0;                                 /* 0 unconstrained,1 = by min data value, 2 = by user value */
-static int set_high = 0;                                /* 0 unconstrained,1 = by max data value, 2 = by user value */
-static int constrained = FALSE;                         /* TRUE if set_low or set_high is TRUE */
-static double low_limit, high_limit;                    /* Constrains on range of solution */
-static double xmin, xmax, ymin, ymax;                   /* minmax coordinates */
-static float *lower, *upper;                            /* arrays for minmax values, if set */
-static double xinc, yinc;                               /* Size of each grid cell (final size) */
-static double grid_xinc, grid_yinc;                     /* size of each grid cell for a given grid factor */
-static double r_xinc, r_yinc, r_grid_xinc, r_grid_yinc; /* Reciprocals  */
-static double converge_limit = 0.0;                     /* Convergence limit */
-static double radius = 0.0;                             /* Search radius for initializing grid  */
-static double tension = 0.00;                           /* Tension parameter on the surface  */
-static double boundary_tension = 0.0;
-static double interior_tension = 0.0;
-static double a0_const_1, a0_const_2; /* Constants for off grid point equation  */
-static double e_2, e_m2, one_plus_e2;
-static double eps_p2, eps_m2, two_plus_ep2, two_plus_em2;
-static double x_edge_const, y_edge_const;
-static double epsilon = 1.0;
-static double z_mean;
-static double z_scale = 1.0;                /* Root mean square range of z after removing planar trend  */
-static double r_z_scale = 1.0;              /* reciprocal of z_scale  */
-static double plane_c0, plane_c1, plane_c2; /* Coefficients of best fitting plane to data  */
-static double smalldistance;                /* Let data point coincide with node if distance < smalldistance */
-static float *u;                            /* Pointer to grid array */
-static char *iu;                            /* Pointer to grid info array */
-static char mode_type[2] = {'I', 'D'};      /* D means include data points when iterating
+/* Minimum number of nodes in a sweep for the relaxation to be multithreaded */
+#define MB_SURFACE_THREAD_MIN_NODES 4096
+
+/* Number of colors in the multithreaded relaxation - nodes of the same color
+    are at least three nodes apart in x or y and so never share the 12 point stencil */
+#define MB_SURFACE_NCOLOR 5
+
+struct mb_surface_struct;
+
+/* Relaxation worker thread */
+struct mb_surface_worker {
+	struct mb_surface_struct *s;
+	pthread_t thread;
+	int ithread;
+	double max_change;
+};
+
+/* The complete state of one spline interpolation, so that any number may run at once */
+struct mb_surface_struct {
+	int npoints; /* Number of data points */
+	int n_columns;      /* Number of nodes in x-dir. */
+	int n_rows;      /* Number of nodes in y-dir. (Final grid) */
+	int m_columns;
+	int m_rows;
+	int ij_sw_corner, ij_se_corner, ij_nw_corner, ij_ne_corner;
+	int block_n_columns;             /* Number of nodes in x-dir for a given grid factor */
+	int block_n_rows;             /* Number of nodes in y-dir for a given grid factor */
+	int max_iterations; /* Max iter per call to iterate */
+	int total_iterations;
+	int grid, old_grid; /* Node spacings  */
+	int grid_east;
+	int n_fact;  /* Number of factors in common (n_rows-1, n_columns-1) */
+	int factors[32]; /* Array of common factors */
+	int local_verbose;
+	int local_error;
+	int status;
+	// int n_empty;                                     /* No of unconstrained nodes at initialization  */
+	int set_low;                                 /* 0 unconstrained,1 = by min data value, 2 = by user value */
+	int set_high;                                /* 0 unconstrained,1 = by max data value, 2 = by user value */
+	int constrained;                         /* TRUE if set_low or set_high is TRUE */
+	double low_limit, high_limit;                    /* Constrains on range of solution */
+	double xmin, xmax, ymin, ymax;                   /* minmax coordinates */
+	float *lower, *upper;                            /* arrays for minmax values, if set */
+	double xinc, yinc;                               /* Size of each grid cell (final size) */
+	double grid_xinc, grid_yinc;                     /* size of each grid cell for a given grid factor */
+	double r_xinc, r_yinc, r_grid_xinc, r_grid_yinc; /* Reciprocals  */
+	double converge_limit;                     /* Convergence limit */
+	double radius;                             /* Search radius for initializing grid  */
+	double tension;                           /* Tension parameter on the surface  */
+	double boundary_tension;
+	double interior_tension;
+	double a0_const_1, a0_const_2; /* Constants for off grid point equation  */
+	double e_2, e_m2, one_plus_e2;
+	double eps_p2, eps_m2, two_plus_ep2, two_plus_em2;
+	double x_edge_const, y_edge_const;
+	double epsilon;
+	double z_mean;
+	double z_scale;                /* Root mean square range of z after removing planar trend  */
+	double r_z_scale;              /* reciprocal of z_scale  */
+	double plane_c0, plane_c1, plane_c2; /* Coefficients of best fitting plane to data  */
+	double smalldistance;                /* Let data point coincide with node if distance < smalldistance */
+	float *u;                            /* Pointer to grid array */
+	char *iu;                            /* Pointer to grid info array */
+	int *ibriggs;                        /* Index into briggs of each constrained node, if multithreaded */
+
+	int offset[25][12];  /* Indices of 12 nearby points in 25 cases of edge conditions  */
+	double coeff[2][12]; /* Coefficients for 12 nearby points, constrained and unconstrained  */
+
+	double relax_old, relax_new; /* Coefficients for relaxation factor to speed up convergence */
+
+	struct MB_SURFACE_DATA *data;     /* Data point and index to node it currently constrains  */
+	struct MB_SURFACE_BRIGGS *briggs; /* Coefficients in Taylor series for Laplacian(z) a la I. C. Briggs (1974)  */
+
+	/* relaxation threads - the calling thread does the share of worker 0 */
+	int nthreads;
+	struct mb_surface_worker workers[MB_THREAD_MAX];
+	pthread_mutex_t thread_mutex;
+	pthread_cond_t thread_start;
+	pthread_cond_t thread_done;
+	int thread_generation;
+	int thread_busy;
+	int thread_quit;
+	int sweep_color;
+};
+
+static const char mode_type[2] = {'I', 'D'};      /* D means include data points when iterating
                                              * I means just interpolate from larger grid */
 
-static int offset[25][12];  /* Indices of 12 nearby points in 25 cases of edge conditions  */
-static double coeff[2][12]; /* Coefficients for 12 nearby points, constrained and unconstrained  */
-
-static double relax_old, relax_new = 1.4; /* Coefficients for relaxation factor to speed up convergence */
-
-static struct MB_SURFACE_DATA *data;     /* Data point and index to node it currently constrains  */
-static struct MB_SURFACE_BRIGGS *briggs; /* Coefficients in Taylor series for Laplacian(z) a la I. C. Briggs (1974)  */
-
-void set_coefficients() {
-	const double loose = 1.0 - interior_tension;
-	e_2 = epsilon * epsilon;
-	const double e_4 = e_2 * e_2;
-	eps_p2 = e_2;
-	eps_m2 = 1.0 / e_2;
-	one_plus_e2 = 1.0 + e_2;
-	two_plus_ep2 = 2.0 + 2.0 * eps_p2;
-	two_plus_em2 = 2.0 + 2.0 * eps_m2;
-
-	x_edge_const = 4 * one_plus_e2 - 2 * (interior_tension / loose);
-	e_m2 = 1.0 / e_2;
-	y_edge_const = 4 * (1.0 + e_m2) - 2 * (interior_tension * e_m2 / loose);
-
-	const double a0 = 1.0 / ((6 * e_4 * loose + 10 * e_2 * loose + 8 * loose - 2 * one_plus_e2) + 4 * interior_tension * one_plus_e2);
-	a0_const_1 = 2 * loose * (1.0 + e_4);
-	a0_const_2 = 2.0 - interior_tension + 2 * loose * e_2;
-
-	coeff[1][4] = coeff[1][7] = -loose;
-	coeff[1][0] = coeff[1][11] = -loose * e_4;
-	coeff[0][4] = coeff[0][7] = -loose * a0;
-	coeff[0][0] = coeff[0][11] = -loose * e_4 * a0;
-	coeff[1][5] = coeff[1][6] = 2 * loose * one_plus_e2;
-	coeff[0][5] = coeff[0][6] = (2 * coeff[1][5] + interior_tension) * a0;
-	coeff[1][2] = coeff[1][9] = coeff[1][5] * e_2;
-	coeff[0][2] = coeff[0][9] = coeff[0][5] * e_2;
-	coeff[1][1] = coeff[1][3] = coeff[1][8] = coeff[1][10] = -2 * loose * e_2;
-	coeff[0][1] = coeff[0][3] = coeff[0][8] = coeff[0][10] = coeff[1][1] * a0;
-
-	e_2 *= 2; /* We will need these in boundary conditions  */
-	e_m2 *= 2;
-
-	ij_sw_corner = 2 * m_rows + 2; /*  Corners of array of actual data  */
-	ij_se_corner = ij_sw_corner + (n_columns - 1) * m_rows;
-	ij_nw_corner = ij_sw_corner + (n_rows - 1);
-	ij_ne_corner = ij_se_corner + (n_rows - 1);
+static void set_coefficients(struct mb_surface_struct *s) {
+	const double loose = 1.0 - s->interior_tension;
+	s->e_2 = s->epsilon * s->epsilon;
+	const double e_4 = s->e_2 * s->e_2;
+	s->eps_p2 = s->e_2;
+	s->eps_m2 = 1.0 / s->e_2;
+	s->one_plus_e2 = 1.0 + s->e_2;
+	s->two_plus_ep2 = 2.0 + 2.0 * s->eps_p2;
+	s->two_plus_em2 = 2.0 + 2.0 * s->eps_m2;
+
+	s->x_edge_const = 4 * s->one_plus_e2 - 2 * (s->interior_tension / loose);
+	s->e_m2 = 1.0 / s->e_2;
+	s->y_edge_const = 4 * (1.0 + s->e_m2) - 2 * (s->interior_tension * s->e_m2 / loose);
+
+	const double a0 = 1.0 / ((6 * e_4 * loose + 10 * s->e_2 * loose + 8 * loose - 2 * s->one_plus_e2) + 4 * s->interior_tension * s->one_plus_e2);
+	s->a0_const_1 = 2 * loose * (1.0 + e_4);
+	s->a0_const_2 = 2.0 - s->interior_tension + 2 * loose * s->e_2;
+
+	s->coeff[1][4] = s->coeff[1][7] = -loose;
+	s->coeff[1][0] = s->coeff[1][11] = -loose * e_4;
+	s->coeff[0][4] = s->coeff[0][7] = -loose * a0;
+	s->coeff[0][0] = s->coeff[0][11] = -loose * e_4 * a0;
+	s->coeff[1][5] = s->coeff[1][6] = 2 * loose * s->one_plus_e2;
+	s->coeff[0][5] = s->coeff[0][6] = (2 * s->coeff[1][5] + s->interior_tension) * a0;
+	s->coeff[1][2] = s->coeff[1][9] = s->coeff[1][5] * s->e_2;
+	s->coeff[0][2] = s->coeff[0][9] = s->coeff[0][5] * s->e_2;
+	s->coeff[1][1] = s->coeff[1][3] = s->coeff[1][8] = s->coeff[1][10] = -2 * loose * s->e_2;
+	s->coeff[0][1] = s->coeff[0][3] = s->coeff[0][8] = s->coeff[0][10] = s->coeff[1][1] * a0;
+
+	s->e_2 *= 2; /* We will need these in boundary conditions  */
+	s->e_m2 *= 2;
+
+	s->ij_sw_corner = 2 * s->m_rows + 2; /*  Corners of array of actual data  */
+	s->ij_se_corner = s->ij_sw_corner + (s->n_columns - 1) * s->m_rows;
+	s->ij_nw_corner = s->ij_sw_corner + (s->n_rows - 1);
+	s->ij_ne_corner = s->ij_se_corner + (s->n_rows - 1);
 }
 
-void set_offset() {
+static void set_offset(struct mb_surface_struct *s) {
 	/* Make these const. */
 	int add_w[5];
-	add_w[0] = -m_rows;
-	add_w[1] = add_w[2] = add_w[3] = add_w[4] = -grid_east;
+	add_w[0] = -s->m_rows;
+	add_w[1] = add_w[2] = add_w[3] = add_w[4] = -s->grid_east;
 	int add_w2[5];
-	add_w2[0] = -2 * m_rows;
-	add_w2[1] = -m_rows - grid_east;
-	add_w2[2] = add_w2[3] = add_w2[4] = -2 * grid_east;
+	add_w2[0] = -2 * s->m_rows;
+	add_w2[1] = -s->m_rows - s->grid_east;
+	add_w2[2] = add_w2[3] = add_w2[4] = -2 * s->grid_east;
 	int add_e[5];
-	add_e[4] = m_rows;
-	add_e[0] = add_e[1] = add_e[2] = add_e[3] = grid_east;
+	add_e[4] = s->m_rows;
+	add_e[0] = add_e[1] = add_e[2] = add_e[3] = s->grid_east;
 	int add_e2[5];
-	add_e2[4] = 2 * m_rows;
-	add_e2[3] = m_rows + grid_east;
-	add_e2[2] = add_e2[1] = add_e2[0] = 2 * grid_east;
+	add_e2[4] = 2 * s->m_rows;
+	add_e2[3] = s->m_rows + s->grid_east;
+	add_e2[2] = add_e2[1] = add_e2[0] = 2 * s->grid_east;
 
 	int add_n[5];
 	add_n[4] = 1;
-	add_n[3] = add_n[2] = add_n[1] = add_n[0] = grid;
+	add_n[3] = add_n[2] = add_n[1] = add_n[0] = s->grid;
 	int add_n2[5];
 	add_n2[4] = 2;
-	add_n2[3] = grid + 1;
-	add_n2[2] = add_n2[1] = add_n2[0] = 2 * grid;
+	add_n2[3] = s->grid + 1;
+	add_n2[2] = add_n2[1] = add_n2[0] = 2 * s->grid;
 	int add_s[5];
 	add_s[0] = -1;
-	add_s[1] = add_s[2] = add_s[3] = add_s[4] = -grid;
+	add_s[1] = add_s[2] = add_s[3] = add_s[4] = -s->grid;
 	int add_s2[5];
 	add_s2[0] = -2;
-	add_s2[1] = -grid - 1;
-	add_s2[2] = add_s2[3] = add_s2[4] = -2 * grid;
+	add_s2[1] = -s->grid - 1;
+	add_s2[2] = add_s2[3] = add_s2[4] = -2 * s->grid;
 
 	for (int i = 0, kase = 0; i < 5; i++) {
 		for (int j = 0; j < 5; j++, kase++) {
-			offset[kase][0] = add_n2[j];
-			offset[kase][1] = add_n[j] + add_w[i];
-			offset[kase][2] = add_n[j];
-			offset[kase][3] = add_n[j] + add_e[i];
-			offset[kase][4] = add_w2[i];
-			offset[kase][5] = add_w[i];
-			offset[kase][6] = add_e[i];
-			offset[kase][7] = add_e2[i];
-			offset[kase][8] = add_s[j] + add_w[i];
-			offset[kase][9] = add_s[j];
-			offset[kase][10] = add_s[j] + add_e[i];
-			offset[kase][11] = add_s2[j];
+			s->offset[kase][0] = add_n2[j];
+			s->offset[kase][1] = add_n[j] + add_w[i];
+			s->offset[kase][2] = add_n[j];
+			s->offset[kase][3] = add_n[j] + add_e[i];
+			s->offset[kase][4] = add_w2[i];
+			s->offset[kase][5] = add_w[i];
+			s->offset[kase][6] = add_e[i];
+			s->offset[kase][7] = add_e2[i];
+			s->offset[kase][8] = add_s[j] + add_w[i];
+			s->offset[kase][9] = add_s[j];
+			s->offset[kase][10] = add_s[j] + add_e[i];
+			s->offset[kase][11] = add_s2[j];
 		}
 	}
 }
 
-void fill_in_forecast() {
+static void fill_in_forecast(struct mb_surface_struct *s) {
 	// Fills in bilinear estimates into new node locations
 	// after grid is divided.
 
-	const double old_size = 1.0 / (double)old_grid;
+	const double old_size = 1.0 / (double)s->old_grid;
 
 	/* first do from southwest corner */
-	for (int i = 0; i < n_columns - 1; i += old_grid) {
-		for (int j = 0; j < n_rows - 1; j += old_grid) {
+	for (int i = 0; i < s->n_columns - 1; i += s->old_grid) {
+		for (int j = 0; j < s->n_rows - 1; j += s->old_grid) {
 
 			/* get indices of bilinear square */
-			const int index_0 = ij_sw_corner + i * m_rows + j;
-			const int index_1 = index_0 + old_grid * m_rows;
-			const int index_2 = index_1 + old_grid;
-			const int index_3 = index_0 + old_grid;
+			const int index_0 = s->ij_sw_corner + i * s->m_rows + j;
+			const int index_1 = index_0 + s->old_grid * s->m_rows;
+			const int index_2 = index_1 + s->old_grid;
+			const int index_3 = index_0 + s->old_grid;
 
 			/* get coefficients */
-			const double a0 = u[index_0];
-			const double a1 = u[index_1] - a0;
-			const double a2 = u[index_3] - a0;
-			const double a3 = u[index_2] - a0 - a1 - a2;
+			const double a0 = s->u[index_0];
+			const double a1 = s->u[index_1] - a0;
+			const double a2 = s->u[index_3] - a0;
+			const double a3 = s->u[index_2] - a0 - a1 - a2;
 
 			/* find all possible new fill ins */
 
-			for (int ii = i; ii < i + old_grid; ii += grid) {
+			for (int ii = i; ii < i + s->old_grid; ii += s->grid) {
 				const double delta_x = (ii - i) * old_size;
-				for (int jj = j; jj < j + old_grid; jj += grid) {
-					const int index_new = ij_sw_corner + ii * m_rows + jj;
+				for (int jj = j; jj < j + s->old_grid; jj += s->grid) {
+					const int index_new = s->ij_sw_corner + ii * s->m_rows + jj;
 					if (index_new == index_0)
 						continue;
 					const double delta_y = (jj - j) * old_size;
-					u[index_new] = a0 + a1 * delta_x + delta_y * (a2 + a3 * delta_x);
-					iu[index_new] = 0;
+					s->u[index_new] = a0 + a1 * delta_x + delta_y * (a2 + a3 * delta_x);
+					s->iu[index_new] = 0;
 				}
 			}
-			iu[index_0] = 5;
+			s->iu[index_0] = 5;
 		}
 	}
 
 	/* now do linear guess along east edge */
 
-	for (int j = 0; j < (n_rows - 1); j += old_grid) {
-		const int index_0 = ij_se_corner + j;
-		const int index_3 = index_0 + old_grid;
-		for (int jj = j; jj < j + old_grid; jj += grid) {
-			const int index_new = ij_se_corner + jj;
+	for (int j = 0; j < (s->n_rows - 1); j += s->old_grid) {
+		const int index_0 = s->ij_se_corner + j;
+		const int index_3 = index_0 + s->old_grid;
+		for (int jj = j; jj < j + s->old_grid; jj += s->grid) {
+			const int index_new = s->ij_se_corner + jj;
 			const double delta_y = (jj - j) * old_size;
-			u[index_new] = u[index_0] + delta_y * (u[index_3] - u[index_0]);
-			iu[index_new] = 0;
+			s->u[index_new] = s->u[index_0] + delta_y * (s->u[index_3] - s->u[index_0]);
+			s->iu[index_new] = 0;
 		}
-		iu[index_0] = 5;
+		s->iu[index_0] = 5;
 	}
 	/* now do linear guess along north edge */
-	for (int i = 0; i < (n_columns - 1); i += old_grid) {
-		const int index_0 = ij_nw_corner + i * m_rows;
-		const int index_1 = index_0 + old_grid * m_rows;
-		for (int ii = i; ii < i + old_grid; ii += grid) {
-			const int index_new = ij_nw_corner + ii * m_rows;
+	for (int i = 0; i < (s->n_columns - 1); i += s->old_grid) {
+		const int index_0 = s->ij_nw_corner + i * s->m_rows;
+		const int index_1 = index_0 + s->old_grid * s->m_rows;
+		for (int ii = i; ii < i + s->old_grid; ii += s->grid) {
+			const int index_new = s->ij_nw_corner + ii * s->m_rows;
 			const double delta_x = (ii - i) * old_size;
-			u[index_new] = u[index_0] + delta_x * (u[index_1] - u[index_0]);
-			iu[index_new] = 0;
+			s->u[index_new] = s->u[index_0] + delta_x * (s->u[index_1] - s->u[index_0]);
+			s->iu[index_new] = 0;
 		}
-		iu[index_0] = 5;
+		s->iu[index_0] = 5;
 	}
 	/* now set northeast corner to fixed and we're done */
-	iu[ij_ne_corner] = 5;
+	s->iu[s->ij_ne_corner] = 5;
 }
 
-void smart_divide() {
+static void smart_divide(struct mb_surface_struct *s) {
 	/* Divide grid by its largest prime factor */
-	grid /= factors[n_fact - 1];
-	n_fact--;
+	s->grid /= s->factors[s->n_fact - 1];
+	s->n_fact--;
+}
+
+static void set_distances(struct mb_surface_struct *s) {
+	/* Computes the squared distance of each point to the node given by its index
+	    so that compare_points needs no state beyond the points themselves. */
+	for (int k = 0; k < s->npoints; k++) {
+		if (s->data[k].index == OUTSIDE) {
+			s->data[k].distance = 0.0;
+			continue;
+		}
+		const int block_i = s->data[k].index / s->block_n_rows;
+		const int block_j = s->data[k].index % s->block_n_rows;
+		const double x0 = s->xmin + block_i * s->grid_xinc;
+		const double y0 = s->ymin + block_j * s->grid_yinc;
+		s->data[k].distance = (s->data[k].x - x0) * (s->data[k].x - x0) + (s->data[k].y - y0) * (s->data[k].y - y0);
+	}
 }
 
-int compare_points(struct MB_SURFACE_DATA *point_1, struct MB_SURFACE_DATA *point_2) {
+static int compare_points(const void *p1, const void *p2) {
 	/*  Routine for qsort to sort data structure for fast access to data by node location.
 	    Sorts on index first, then on radius to node corresponding to index, so that index
 	    goes from low to high, and so does radius.
 	*/
+	const struct MB_SURFACE_DATA *point_1 = (const struct MB_SURFACE_DATA *)p1;
+	const struct MB_SURFACE_DATA *point_2 = (const struct MB_SURFACE_DATA *)p2;
 	const int index_1 = point_1->index;
 	const int index_2 = point_2->index;
 	if (index_1 < index_2)
@@ -328,151 +386,148 @@ int compare_points(struct MB_SURFACE_DATA *point_1, struct MB_SURFACE_DATA *poin
 		return (0);
 
 	/* Points are in same grid cell, find the one who is nearest to grid point */
-	const int block_i = point_1->index / block_n_rows;
-	const int block_j = point_1->index % block_n_rows;
-	const double x0 = xmin + block_i * grid_xinc;
-	const double y0 = ymin + block_j * grid_yinc;
-	const double dist_1 = (point_1->x - x0) * (point_1->x - x0) + (point_1->y - y0) * (point_1->y - y0);
-	const double dist_2 = (point_2->x - x0) * (point_2->x - x0) + (point_2->y - y0) * (point_2->y - y0);
-	if (dist_1 < dist_2)
+	if (point_1->distance < point_2->distance)
 		return (-1);
-	if (dist_1 > dist_2)
+	if (point_1->distance > point_2->distance)
 		return (1);
 	else
 		return (0);
 }
 
-void set_index() {
+static void set_index(struct mb_surface_struct *s) {
 	/* recomputes data[k].index for new value of grid,
 	   sorts data on index and radii, and throws away
 	   data which are now outside the useable limits. */
 	int k_skipped = 0;
 
-	for (int k = 0; k < npoints; k++) {
-		const int i = floor(((data[k].x - xmin) * r_grid_xinc) + 0.5);
-		const int j = floor(((data[k].y - ymin) * r_grid_yinc) + 0.5);
-		if (i < 0 || i >= block_n_columns || j < 0 || j >= block_n_rows) {
-			data[k].index = OUTSIDE;
+	for (int k = 0; k < s->npoints; k++) {
+		const int i = floor(((s->data[k].x - s->xmin) * s->r_grid_xinc) + 0.5);
+		const int j = floor(((s->data[k].y - s->ymin) * s->r_grid_yinc) + 0.5);
+		if (i < 0 || i >= s->block_n_columns || j < 0 || j >= s->block_n_rows) {
+			s->data[k].index = OUTSIDE;
 			k_skipped++;
 		}
 		else
-			data[k].index = i * block_n_rows + j;
+			s->data[k].index = i * s->block_n_rows + j;
 	}
 
-	qsort((char *)data, npoints, sizeof(struct MB_SURFACE_DATA), (void *)compare_points);
+	set_distances(s);
+	qsort((char *)s->data, s->npoints, sizeof(struct MB_SURFACE_DATA), compare_points);
 
-	npoints -= k_skipped;
+	s->npoints -= k_skipped;
 }
 
-void find_nearest_point() {
-	smalldistance = 0.05 * ((grid_xinc < grid_yinc) ? grid_xinc : grid_yinc);
+static void find_nearest_point(struct mb_surface_struct *s) {
+	s->smalldistance = 0.05 * ((s->grid_xinc < s->grid_yinc) ? s->grid_xinc : s->grid_yinc);
 
-	for (int i = 0; i < n_columns; i += grid) /* Reset grid info */
-		for (int j = 0; j < n_rows; j += grid)
-			iu[ij_sw_corner + i * m_rows + j] = 0;
+	for (int i = 0; i < s->n_columns; i += s->grid) /* Reset grid info */
+		for (int j = 0; j < s->n_rows; j += s->grid)
+			s->iu[s->ij_sw_corner + i * s->m_rows + j] = 0;
 
 	int last_index = -1;
 	int briggs_index = 0;
-	for (int k = 0; k < npoints; k++) { /* Find constraining value  */
-		if (data[k].index != last_index) {
-			const int block_i = data[k].index / block_n_rows;
-			const int block_j = data[k].index % block_n_rows;
-			last_index = data[k].index;
-			const int iu_index = ij_sw_corner + (block_i * m_rows + block_j) * grid;
-			const double x0 = xmin + block_i * grid_xinc;
-			const double y0 = ymin + block_j * grid_yinc;
-			double dx = (data[k].x - x0) * r_grid_xinc;
-			double dy = (data[k].y - y0) * r_grid_yinc;
-			if (fabs(dx) < smalldistance && fabs(dy) < smalldistance) {
-				iu[iu_index] = 5;
-				u[iu_index] = data[k].z;
+	for (int k = 0; k < s->npoints; k++) { /* Find constraining value  */
+		if (s->data[k].index != last_index) {
+			const int block_i = s->data[k].index / s->block_n_rows;
+			const int block_j = s->data[k].index % s->block_n_rows;
+			last_index = s->data[k].index;
+			const int iu_index = s->ij_sw_corner + (block_i * s->m_rows + block_j) * s->grid;
+			const double x0 = s->xmin + block_i * s->grid_xinc;
+			const double y0 = s->ymin + block_j * s->grid_yinc;
+			double dx = (s->data[k].x - x0) * s->r_grid_xinc;
+			double dy = (s->data[k].y - y0) * s->r_grid_yinc;
+			if (fabs(dx) < s->smalldistance && fabs(dy) < s->smalldistance) {
+				s->iu[iu_index] = 5;
+				s->u[iu_index] = s->data[k].z;
 			}
 			else {
 				if (dx >= 0.0) {
 					if (dy >= 0.0)
-						iu[iu_index] = 1;
+						s->iu[iu_index] = 1;
 					else
-						iu[iu_index] = 4;
+						s->iu[iu_index] = 4;
 				}
 				else {
 					if (dy >= 0.0)
-						iu[iu_index] = 2;
+						s->iu[iu_index] = 2;
 					else
-						iu[iu_index] = 3;
+						s->iu[iu_index] = 3;
 				}
 				dx = fabs(dx);
 				dy = fabs(dy);
-				const double btemp = 2 * one_plus_e2 / ((dx + dy) * (1.0 + dx + dy));
+				const double btemp = 2 * s->one_plus_e2 / ((dx + dy) * (1.0 + dx + dy));
 				const double b0 = 1.0 - 0.5 * (dx + (dx * dx)) * btemp;
-				const double b3 = 0.5 * (e_2 - (dy + (dy * dy)) * btemp);
+				const double b3 = 0.5 * (s->e_2 - (dy + (dy * dy)) * btemp);
 				const double xys = 1.0 + dx + dy;
 				const double xy1 = 1.0 / xys;
-				const double b1 = (e_2 * xys - 4 * dy) * xy1;
+				const double b1 = (s->e_2 * xys - 4 * dy) * xy1;
 				const double b2 = 2 * (dy - dx + 1.0) * xy1;
 				const double b4 = b0 + b1 + b2 + b3 + btemp;
-				const double b5 = btemp * data[k].z;
-				briggs[briggs_index].b[0] = b0;
-				briggs[briggs_index].b[1] = b1;
-				briggs[briggs_index].b[2] = b2;
-				briggs[briggs_index].b[3] = b3;
-				briggs[briggs_index].b[4] = b4;
-				briggs[briggs_index].b[5] = b5;
+				const double b5 = btemp * s->data[k].z;
+				s->briggs[briggs_index].b[0] = b0;
+				s->briggs[briggs_index].b[1] = b1;
+				s->briggs[briggs_index].b[2] = b2;
+				s->briggs[briggs_index].b[3] = b3;
+				s->briggs[briggs_index].b[4] = b4;
+				s->briggs[briggs_index].b[5] = b5;
+				if (s->ibriggs != NULL)
+					s->ibriggs[iu_index] = briggs_index;
 				briggs_index++;
 			}
 		}
 	}
 }
 
-void set_grid_parameters() {
-	block_n_rows = (n_rows - 1) / grid + 1;
-	block_n_columns = (n_columns - 1) / grid + 1;
-	grid_xinc = grid * xinc;
-	grid_yinc = grid * yinc;
-	grid_east = grid * m_rows;
-	r_grid_xinc = 1.0 / grid_xinc;
-	r_grid_yinc = 1.0 / grid_yinc;
+static void set_grid_parameters(struct mb_surface_struct *s) {
+	s->block_n_rows = (s->n_rows - 1) / s->grid + 1;
+	s->block_n_columns = (s->n_columns - 1) / s->grid + 1;
+	s->grid_xinc = s->grid * s->xinc;
+	s->grid_yinc = s->grid * s->yinc;
+	s->grid_east = s->grid * s->m_rows;
+	s->r_grid_xinc = 1.0 / s->grid_xinc;
+	s->r_grid_yinc = 1.0 / s->grid_yinc;
 }
 
-void initialize_grid() {
+static void initialize_grid(struct mb_surface_struct *s) {
 	// For the initial gridsize, compute weighted averages of data inside the search radius
 	// and assign the values to u[i,j] where i,j are multiples of gridsize.
-	const int irad = ceil(radius / grid_xinc);
-	const int jrad = ceil(radius / grid_yinc);
-	const double rfact = -4.5 / (radius * radius);
-
-	for (int i = 0; i < block_n_columns; i++) {
-		const double x0 = xmin + i * grid_xinc;
-		for (int j = 0; j < block_n_rows; j++) {
-			const double y0 = ymin + j * grid_yinc;
+	const int irad = ceil(s->radius / s->grid_xinc);
+	const int jrad = ceil(s->radius / s->grid_yinc);
+	const double rfact = -4.5 / (s->radius * s->radius);
+
+	for (int i = 0; i < s->block_n_columns; i++) {
+		const double x0 = s->xmin + i * s->grid_xinc;
+		for (int j = 0; j < s->block_n_rows; j++) {
+			const double y0 = s->ymin + j * s->grid_yinc;
 			int imin = i - irad;
 			if (imin < 0)
 				imin = 0;
 			int imax = i + irad;
-			if (imax >= block_n_columns)
-				imax = block_n_columns - 1;
+			if (imax >= s->block_n_columns)
+				imax = s->block_n_columns - 1;
 			int jmin = j - jrad;
 			if (jmin < 0)
 				jmin = 0;
 			int jmax = j + jrad;
-			if (jmax >= block_n_rows)
-				jmax = block_n_rows - 1;
-			const int index_1 = imin * block_n_rows + jmin;
-			const int index_2 = imax * block_n_rows + jmax + 1;
+			if (jmax >= s->block_n_rows)
+				jmax = s->block_n_rows - 1;
+			const int index_1 = imin * s->block_n_rows + jmin;
+			const int index_2 = imax * s->block_n_rows + jmax + 1;
 			double sum_w = 0.0;
                         double sum_zw = 0.0;
 			int k = 0;
-			while (k < npoints && data[k].index < index_1)
+			while (k < s->npoints && s->data[k].index < index_1)
 				k++;
-			for (int ki = imin; k < npoints && ki <= imax && data[k].index < index_2; ki++) {
-				for (int kj = jmin; k < npoints && kj <= jmax && data[k].index < index_2; kj++) {
-					const int k_index = ki * block_n_rows + kj;
-					while (k < npoints && data[k].index < k_index)
+			for (int ki = imin; k < s->npoints && ki <= imax && s->data[k].index < index_2; ki++) {
+				for (int kj = jmin; k < s->npoints && kj <= jmax && s->data[k].index < index_2; kj++) {
+					const int k_index = ki * s->block_n_rows + kj;
+					while (k < s->npoints && s->data[k].index < k_index)
 						k++;
-					while (k < npoints && data[k].index == k_index) {
-						const double r = (data[k].x - x0) * (data[k].x - x0) + (data[k].y - y0) * (data[k].y - y0);
+					while (k < s->npoints && s->data[k].index == k_index) {
+						const double r = (s->data[k].x - x0) * (s->data[k].x - x0) + (s->data[k].y - y0) * (s->data[k].y - y0);
 						const double weight = exp(rfact * r);
 						sum_w += weight;
-						sum_zw += weight * data[k].z;
+						sum_zw += weight * s->data[k].z;
 						k++;
 					}
 				}
@@ -481,35 +536,35 @@ void initialize_grid() {
 				/*
 				fprintf (stderr, "surface: Warning: no data inside search radius at: %.8lg %.8lg\n", x0, y0);
 				*/
-				u[ij_sw_corner + (i * m_rows + j) * grid] = z_mean;
+				s->u[s->ij_sw_corner + (i * s->m_rows + j) * s->grid] = s->z_mean;
 			}
 			else {
-				u[ij_sw_corner + (i * m_rows + j) * grid] = sum_zw / sum_w;
+				s->u[s->ij_sw_corner + (i * s->m_rows + j) * s->grid] = sum_zw / sum_w;
 			}
 		}
 	}
 }
 
 /* This function rewritten by D.W. Caress 5/3/94 */
-void read_data(int ndat, float *xdat, float *ydat, float *zdat) {
+static void read_data(struct mb_surface_struct *s, int ndat, float *xdat, float *ydat, float *zdat) {
 	int kmax = 0;
 	int kmin = 0;
 	double zmin = 1.0e38;
 	double zmax = -1.0e38;
 
-	status = mb_mallocd(local_verbose, __FILE__, __LINE__, ndat * sizeof(struct MB_SURFACE_DATA), (void **)&data, &local_error);
+	s->status = mb_mallocd(s->local_verbose, __FILE__, __LINE__, ndat * sizeof(struct MB_SURFACE_DATA), (void **)&s->data, &s->local_error);
 
 	/* Read in xyz data and computes index no and store it in a structure */
 	int k = 0;
-	z_mean = 0;
+	s->z_mean = 0;
 	for (int idat = 0; idat < ndat; idat++) {
-		const int i = floor(((xdat[idat] - xmin) * r_grid_xinc) + 0.5);
-		const int j = floor(((ydat[idat] - ymin) * r_grid_yinc) + 0.5);
-		if (i >= 0 && i < block_n_columns && j >= 0 && j < block_n_rows) {
-			data[k].index = i * block_n_rows + j;
-			data[k].x = xdat[idat];
-			data[k].y = ydat[idat];
-			data[k].z = zdat[idat];
+		const int i = floor(((xdat[idat] - s->xmin) * s->r_grid_xinc) + 0.5);
+		const int j = floor(((ydat[idat] - s->ymin) * s->r_grid_yinc) + 0.5);
+		if (i >= 0 && i < s->block_n_columns && j >= 0 && j < s->block_n_rows) {
+			s->data[k].index = i * s->block_n_rows + j;
+			s->data[k].x = xdat[idat];
+			s->data[k].y = ydat[idat];
+			s->data[k].z = zdat[idat];
 			if (zmin > zdat[idat]) {
 				zmin = zdat[idat];
 				kmin = k;
@@ -519,14 +574,14 @@ void read_data(int ndat, float *xdat, float *ydat, float *zdat) {
 				kmax = k;
 			}
 			k++;
-			z_mean += zdat[idat];
+			s->z_mean += zdat[idat];
 		}
 	}
 
-	npoints = k;
-	z_mean /= k;
-	if (converge_limit == 0.0) {
-		converge_limit = 0.001 * z_scale; /* c_l = 1 ppt of L2 scale */
+	s->npoints = k;
+	s->z_mean /= k;
+	if (s->converge_limit == 0.0) {
+		s->converge_limit = 0.001 * s->z_scale; /* c_l = 1 ppt of L2 scale */
 	}
 	/*
 	if (local_verbose) {
@@ -537,17 +592,17 @@ void read_data(int ndat, float *xdat, float *ydat, float *zdat) {
 	}
 	*/
 
-	if (set_low == 1)
-		low_limit = data[kmin].z;
-	else if (set_low == 2 && low_limit > data[kmin].z) {
+	if (s->set_low == 1)
+		s->low_limit = s->data[kmin].z;
+	else if (s->set_low == 2 && s->low_limit > s->data[kmin].z) {
 		/*	low_limit = data[kmin].z;	*/
 		/*
 		fprintf (stderr, "surface: Warning:  Your lower value is > than min data value.\n");
 		*/
 	}
-	if (set_high == 1)
-		high_limit = data[kmax].z;
-	else if (set_high == 2 && high_limit < data[kmax].z) {
+	if (s->set_high == 1)
+		s->high_limit = s->data[kmax].z;
+	else if (s->set_high == 2 && s->high_limit < s->data[kmax].z) {
 		/*	high_limit = data[kmax].z;	*/
 		/*
 		fprintf (stderr, "surface: Warning:  Your upper value is < than max data value.\n");
@@ -556,30 +611,191 @@ void read_data(int ndat, float *xdat, float *ydat, float *zdat) {
 }
 
 /* this function rewritten from write_output() by D.W. Caress 5/3/94 */
-void get_output(float *sgrid) {
-        int index = ij_sw_corner;
-	for (int i = 0; i < n_columns; i++, index += m_rows)
-		for (int j = 0; j < n_rows; j++) {
-			sgrid[j * n_columns + i] = u[index + n_rows - j - 1];
+static void get_output(struct mb_surface_struct *s, float *sgrid) {
+        int index = s->ij_sw_corner;
+	for (int i = 0; i < s->n_columns; i++, index += s->m_rows)
+		for (int j = 0; j < s->n_rows; j++) {
+			sgrid[j * s->n_columns + i] = s->u[index + s->n_rows - j - 1];
+		}
+}
+
+static double relax_node(struct mb_surface_struct *s, int i, int j, int ij, int kase, int briggs_index) {
+	/* Relaxes the free node ij = (i, j) with edge condition kase and returns the
+	    absolute change; briggs_index locates the coefficients of constrained nodes. */
+	double sum_ij = 0.0;
+
+	if (s->iu[ij] == 0) { /* Point is unconstrained  */
+		for (int k = 0; k < 12; k++) {
+			sum_ij += (s->u[ij + s->offset[kase][k]] * s->coeff[0][k]);
 		}
+	}
+	else { /* Point is constrained  */
+
+		const double b0 = s->briggs[briggs_index].b[0];
+		const double b1 = s->briggs[briggs_index].b[1];
+		const double b2 = s->briggs[briggs_index].b[2];
+		const double b3 = s->briggs[briggs_index].b[3];
+		const double b4 = s->briggs[briggs_index].b[4];
+		const double b5 = s->briggs[briggs_index].b[5];
+		double busum;
+		if (s->iu[ij] < 3) {
+			if (s->iu[ij] == 1) { /* Point is in quadrant 1  */
+				busum = b0 * s->u[ij + s->offset[kase][10]] + b1 * s->u[ij + s->offset[kase][9]] + b2 * s->u[ij + s->offset[kase][5]] +
+				        b3 * s->u[ij + s->offset[kase][1]];
+			}
+			else { /* Point is in quadrant 2  */
+				busum = b0 * s->u[ij + s->offset[kase][8]] + b1 * s->u[ij + s->offset[kase][9]] + b2 * s->u[ij + s->offset[kase][6]] +
+				        b3 * s->u[ij + s->offset[kase][3]];
+			}
+		}
+		else {
+			if (s->iu[ij] == 3) { /* Point is in quadrant 3  */
+				busum = b0 * s->u[ij + s->offset[kase][1]] + b1 * s->u[ij + s->offset[kase][2]] + b2 * s->u[ij + s->offset[kase][6]] +
+				        b3 * s->u[ij + s->offset[kase][10]];
+			}
+			else { /* Point is in quadrant 4  */
+				busum = b0 * s->u[ij + s->offset[kase][3]] + b1 * s->u[ij + s->offset[kase][2]] + b2 * s->u[ij + s->offset[kase][5]] +
+				        b3 * s->u[ij + s->offset[kase][8]];
+			}
+		}
+		for (int k = 0; k < 12; k++) {
+			sum_ij += (s->u[ij + s->offset[kase][k]] * s->coeff[1][k]);
+		}
+		sum_ij = (sum_ij + s->a0_const_2 * (busum + b5)) / (s->a0_const_1 + s->a0_const_2 * b4);
+	}
+
+	/* New relaxation here  */
+	sum_ij = s->u[ij] * s->relax_old + sum_ij * s->relax_new;
+
+	if (s->constrained) { /* Must check limits.  Note lower/upper is v2 format and need ij_v2! */
+		const int ij_v2 = (s->n_rows - j - 1) * s->n_columns + i;
+		if (s->set_low /*&& !GMT_is_fnan((double)lower[ij_v2])*/ && sum_ij < s->lower[ij_v2])
+			sum_ij = s->lower[ij_v2];
+		else if (s->set_high /*&& !GMT_is_fnan((double)upper[ij_v2])*/ && sum_ij > s->upper[ij_v2])
+			sum_ij = s->upper[ij_v2];
+	}
+
+	const double change = fabs(sum_ij - s->u[ij]);
+	s->u[ij] = sum_ij;
+	return (change);
+}
+
+static void sweep_color(struct mb_surface_struct *s, struct mb_surface_worker *worker) {
+	/* Relaxes the nodes of the current color in this worker's share of the columns.
+	    A node (block_i, block_j) has color (block_i + 3 * block_j) mod 5, so no two
+	    nodes of one color lie within the 12 point stencil of each other and the nodes
+	    of a color may be relaxed in any order, giving the same result for any number
+	    of threads. */
+	const int block_i_start = (s->block_n_columns * worker->ithread) / s->nthreads;
+	const int block_i_end = (s->block_n_columns * (worker->ithread + 1)) / s->nthreads;
+	double max_change = worker->max_change;
+
+	for (int block_i = block_i_start; block_i < block_i_end; block_i++) {
+		const int x_w_case = block_i;
+		const int x_e_case = s->block_n_columns - 1 - block_i;
+		int x_case;
+		if (x_w_case < 2)
+			x_case = x_w_case;
+		else if (x_e_case < 2)
+			x_case = 4 - x_e_case;
+		else
+			x_case = 2;
+
+		/* first row of this color in this column: block_j = 2 * (color - block_i) mod 5 */
+		int block_j = (2 * (s->sweep_color - block_i % MB_SURFACE_NCOLOR) + 2 * MB_SURFACE_NCOLOR) % MB_SURFACE_NCOLOR;
+		for (; block_j < s->block_n_rows; block_j += MB_SURFACE_NCOLOR) {
+			const int ij = s->ij_sw_corner + (block_i * s->m_rows + block_j) * s->grid;
+			if (s->iu[ij] == 5)
+				continue; /* Point is fixed  */
+
+			const int y_s_case = block_j;
+			const int y_n_case = s->block_n_rows - 1 - block_j;
+			int y_case;
+			if (y_s_case < 2)
+				y_case = y_s_case;
+			else if (y_n_case < 2)
+				y_case = 4 - y_n_case;
+			else
+				y_case = 2;
+
+			const double change = relax_node(s, block_i * s->grid, block_j * s->grid, ij, x_case * 5 + y_case,
+			                                  (s->iu[ij] == 0 ? 0 : s->ibriggs[ij]));
+			if (change > max_change)
+				max_change = change;
+		}
+	}
+
+	worker->max_change = max_change;
 }
 
-int iterate(int mode) {
-	int k, kase, ij_v2;
+static void *surface_worker(void *arg) {
+	/* Worker threads relax their share of each color as the calling thread starts it */
+	struct mb_surface_worker *worker = (struct mb_surface_worker *)arg;
+	struct mb_surface_struct *s = worker->s;
+	int generation = 0;
+
+	pthread_mutex_lock(&s->thread_mutex);
+	while (TRUE) {
+		while (s->thread_generation == generation && !s->thread_quit)
+			pthread_cond_wait(&s->thread_start, &s->thread_mutex);
+		if (s->thread_quit)
+			break;
+		generation = s->thread_generation;
+		pthread_mutex_unlock(&s->thread_mutex);
+
+		sweep_color(s, worker);
+
+		pthread_mutex_lock(&s->thread_mutex);
+		s->thread_busy--;
+		if (s->thread_busy == 0)
+			pthread_cond_signal(&s->thread_done);
+	}
+	pthread_mutex_unlock(&s->thread_mutex);
+
+	return (NULL);
+}
+
+static double sweep_parallel(struct mb_surface_struct *s) {
+	/* One multicolor relaxation sweep over all the free nodes, returning the largest change */
+	for (int ithread = 0; ithread < s->nthreads; ithread++)
+		s->workers[ithread].max_change = -1.0;
+
+	for (int color = 0; color < MB_SURFACE_NCOLOR; color++) {
+		pthread_mutex_lock(&s->thread_mutex);
+		s->sweep_color = color;
+		s->thread_busy = s->nthreads - 1;
+		s->thread_generation++;
+		pthread_cond_broadcast(&s->thread_start);
+		pthread_mutex_unlock(&s->thread_mutex);
+
+		sweep_color(s, &s->workers[0]);
+
+		pthread_mutex_lock(&s->thread_mutex);
+		while (s->thread_busy > 0)
+			pthread_cond_wait(&s->thread_done, &s->thread_mutex);
+		pthread_mutex_unlock(&s->thread_mutex);
+	}
+
+	double max_change = -1.0;
+	for (int ithread = 0; ithread < s->nthreads; ithread++)
+		if (s->workers[ithread].max_change > max_change)
+			max_change = s->workers[ithread].max_change;
+	return (max_change);
+}
+
+static int iterate(struct mb_surface_struct *s, int mode) {
+	int kase;
 	int x_case, y_case, x_w_case, x_e_case, y_s_case, y_n_case;
 	int iteration_count = 0;
 
-	double current_limit = converge_limit / grid;
-	double change;
+	double current_limit = s->converge_limit / s->grid;
 	double max_change = 0.0;
-	double busum, sum_ij;
-	double b0, b1, b2, b3, b4, b5;
 
-	const double x_0_const = 4.0 * (1.0 - boundary_tension) / (2.0 - boundary_tension);
-	const double x_1_const = (3 * boundary_tension - 2.0) / (2.0 - boundary_tension);
-	const double y_denom = 2 * epsilon * (1.0 - boundary_tension) + boundary_tension;
-	const double y_0_const = 4 * epsilon * (1.0 - boundary_tension) / y_denom;
-	const double y_1_const = (boundary_tension - 2 * epsilon * (1.0 - boundary_tension)) / y_denom;
+	const double x_0_const = 4.0 * (1.0 - s->boundary_tension) / (2.0 - s->boundary_tension);
+	const double x_1_const = (3 * s->boundary_tension - 2.0) / (2.0 - s->boundary_tension);
+	const double y_denom = 2 * s->epsilon * (1.0 - s->boundary_tension) + s->boundary_tension;
+	const double y_0_const = 4 * s->epsilon * (1.0 - s->boundary_tension) / y_denom;
+	const double y_1_const = (s->boundary_tension - 2 * s->epsilon * (1.0 - s->boundary_tension)) / y_denom;
 
 	do {
 		int briggs_index = 0; /* Reset the constraint table stack pointer  */
@@ -591,47 +807,47 @@ int iterate(int mode) {
 		/* First set d2[]/dn2 = 0 along edges:  */
 		/* New experiment : (1-T)d2[]/dn2 + Td[]/dn = 0  */
 
-		for (int i = 0; i < n_columns; i += grid) {
+		for (int i = 0; i < s->n_columns; i += s->grid) {
 			/* set d2[]/dy2 = 0 on south side:  */
-			int ij = ij_sw_corner + i * m_rows;
+			int ij = s->ij_sw_corner + i * s->m_rows;
 			/* u[ij - 1] = 2 * u[ij] - u[ij + grid];  */
-			u[ij - 1] = y_0_const * u[ij] + y_1_const * u[ij + grid];
+			s->u[ij - 1] = y_0_const * s->u[ij] + y_1_const * s->u[ij + s->grid];
 			/* set d2[]/dy2 = 0 on north side:  */
-			ij = ij_nw_corner + i * m_rows;
+			ij = s->ij_nw_corner + i * s->m_rows;
 			/* u[ij + 1] = 2 * u[ij] - u[ij - grid];  */
-			u[ij + 1] = y_0_const * u[ij] + y_1_const * u[ij - grid];
+			s->u[ij + 1] = y_0_const * s->u[ij] + y_1_const * s->u[ij - s->grid];
 		}
 
-		for (int j = 0; j < n_rows; j += grid) {
+		for (int j = 0; j < s->n_rows; j += s->grid) {
 			/* set d2[]/dx2 = 0 on west side:  */
-			int ij = ij_sw_corner + j;
+			int ij = s->ij_sw_corner + j;
 			/* u[ij - m_rows] = 2 * u[ij] - u[ij + grid_east];  */
-			u[ij - m_rows] = x_1_const * u[ij + grid_east] + x_0_const * u[ij];
+			s->u[ij - s->m_rows] = x_1_const * s->u[ij + s->grid_east] + x_0_const * s->u[ij];
 			/* set d2[]/dx2 = 0 on east side:  */
-			ij = ij_se_corner + j;
+			ij = s->ij_se_corner + j;
 			/* u[ij + m_rows] = 2 * u[ij] - u[ij - grid_east];  */
-			u[ij + m_rows] = x_1_const * u[ij - grid_east] + x_0_const * u[ij];
+			s->u[ij + s->m_rows] = x_1_const * s->u[ij - s->grid_east] + x_0_const * s->u[ij];
 		}
 
 		/* Now set d2[]/dxdy = 0 at each corner:  */
-		int ij = ij_sw_corner;
-		u[ij - m_rows - 1] = u[ij + grid_east - 1] + u[ij - m_rows + grid] - u[ij + grid_east + grid];
+		int ij = s->ij_sw_corner;
+		s->u[ij - s->m_rows - 1] = s->u[ij + s->grid_east - 1] + s->u[ij - s->m_rows + s->grid] - s->u[ij + s->grid_east + s->grid];
 
-		ij = ij_nw_corner;
-		u[ij - m_rows + 1] = u[ij + grid_east + 1] + u[ij - m_rows - grid] - u[ij + grid_east - grid];
+		ij = s->ij_nw_corner;
+		s->u[ij - s->m_rows + 1] = s->u[ij + s->grid_east + 1] + s->u[ij - s->m_rows - s->grid] - s->u[ij + s->grid_east - s->grid];
 
-		ij = ij_se_corner;
-		u[ij + m_rows - 1] = u[ij - grid_east - 1] + u[ij + m_rows + grid] - u[ij - grid_east + grid];
+		ij = s->ij_se_corner;
+		s->u[ij + s->m_rows - 1] = s->u[ij - s->grid_east - 1] + s->u[ij + s->m_rows + s->grid] - s->u[ij - s->grid_east + s->grid];
 
-		ij = ij_ne_corner;
-		u[ij + m_rows + 1] = u[ij - grid_east + 1] + u[ij + m_rows - grid] - u[ij - grid_east - grid];
+		ij = s->ij_ne_corner;
+		s->u[ij + s->m_rows + 1] = s->u[ij - s->grid_east + 1] + s->u[ij + s->m_rows - s->grid] - s->u[ij - s->grid_east - s->grid];
 
 		/* Now set (1-T)dC/dn + Tdu/dn = 0 at each edge :  */
 		/* New experiment:  only dC/dn = 0  */
 
 		x_w_case = 0;
-		x_e_case = block_n_columns - 1;
-		for (int i = 0; i < n_columns; i += grid, x_w_case++, x_e_case--) {
+		x_e_case = s->block_n_columns - 1;
+		for (int i = 0; i < s->n_columns; i += s->grid, x_w_case++, x_e_case--) {
 
 			if (x_w_case < 2)
 				x_case = x_w_case;
@@ -642,25 +858,25 @@ int iterate(int mode) {
 
 			/* South side :  */
 			kase = x_case * 5;
-			ij = ij_sw_corner + i * m_rows;
-			u[ij + offset[kase][11]] = (u[ij + offset[kase][0]] +
-			                            eps_m2 * (u[ij + offset[kase][1]] + u[ij + offset[kase][3]] - u[ij + offset[kase][8]] -
-			                                      u[ij + offset[kase][10]]) +
-			                            two_plus_em2 * (u[ij + offset[kase][9]] - u[ij + offset[kase][2]]));
+			ij = s->ij_sw_corner + i * s->m_rows;
+			s->u[ij + s->offset[kase][11]] = (s->u[ij + s->offset[kase][0]] +
+			                            s->eps_m2 * (s->u[ij + s->offset[kase][1]] + s->u[ij + s->offset[kase][3]] - s->u[ij + s->offset[kase][8]] -
+			                                      s->u[ij + s->offset[kase][10]]) +
+			                            s->two_plus_em2 * (s->u[ij + s->offset[kase][9]] - s->u[ij + s->offset[kase][2]]));
 			/*  + tense * eps_m2 * (u[ij + offset[kase][2]] - u[ij + offset[kase][9]]) / (1.0 - tense);  */
 			/* North side :  */
 			kase = x_case * 5 + 4;
-			ij = ij_nw_corner + i * m_rows;
-			u[ij + offset[kase][0]] = -(-u[ij + offset[kase][11]] +
-			                            eps_m2 * (u[ij + offset[kase][1]] + u[ij + offset[kase][3]] - u[ij + offset[kase][8]] -
-			                                      u[ij + offset[kase][10]]) +
-			                            two_plus_em2 * (u[ij + offset[kase][9]] - u[ij + offset[kase][2]]));
+			ij = s->ij_nw_corner + i * s->m_rows;
+			s->u[ij + s->offset[kase][0]] = -(-s->u[ij + s->offset[kase][11]] +
+			                            s->eps_m2 * (s->u[ij + s->offset[kase][1]] + s->u[ij + s->offset[kase][3]] - s->u[ij + s->offset[kase][8]] -
+			                                      s->u[ij + s->offset[kase][10]]) +
+			                            s->two_plus_em2 * (s->u[ij + s->offset[kase][9]] - s->u[ij + s->offset[kase][2]]));
 			/*  - tense * eps_m2 * (u[ij + offset[kase][2]] - u[ij + offset[kase][9]]) / (1.0 - tense);  */
 		}
 
 		y_s_case = 0;
-		y_n_case = block_n_rows - 1;
-		for (int j = 0; j < n_rows; j += grid, y_s_case++, y_n_case--) {
+		y_n_case = s->block_n_rows - 1;
+		for (int j = 0; j < s->n_rows; j += s->grid, y_s_case++, y_n_case--) {
 
 			if (y_s_case < 2)
 				y_case = y_s_case;
@@ -671,149 +887,102 @@ int iterate(int mode) {
 
 			/* West side :  */
 			kase = y_case;
-			ij = ij_sw_corner + j;
-			u[ij + offset[kase][4]] = u[ij + offset[kase][7]] +
-			                          eps_p2 * (u[ij + offset[kase][3]] + u[ij + offset[kase][10]] - u[ij + offset[kase][1]] -
-			                                    u[ij + offset[kase][8]]) +
-			                          two_plus_ep2 * (u[ij + offset[kase][5]] - u[ij + offset[kase][6]]);
+			ij = s->ij_sw_corner + j;
+			s->u[ij + s->offset[kase][4]] = s->u[ij + s->offset[kase][7]] +
+			                          s->eps_p2 * (s->u[ij + s->offset[kase][3]] + s->u[ij + s->offset[kase][10]] - s->u[ij + s->offset[kase][1]] -
+			                                    s->u[ij + s->offset[kase][8]]) +
+			                          s->two_plus_ep2 * (s->u[ij + s->offset[kase][5]] - s->u[ij + s->offset[kase][6]]);
 			/*  + tense * (u[ij + offset[kase][6]] - u[ij + offset[kase][5]]) / (1.0 - tense);  */
 			/* East side :  */
 			kase = 20 + y_case;
-			ij = ij_se_corner + j;
-			u[ij + offset[kase][7]] = -(-u[ij + offset[kase][4]] +
-			                            eps_p2 * (u[ij + offset[kase][3]] + u[ij + offset[kase][10]] - u[ij + offset[kase][1]] -
-			                                      u[ij + offset[kase][8]]) +
-			                            two_plus_ep2 * (u[ij + offset[kase][5]] - u[ij + offset[kase][6]]));
+			ij = s->ij_se_corner + j;
+			s->u[ij + s->offset[kase][7]] = -(-s->u[ij + s->offset[kase][4]] +
+			                            s->eps_p2 * (s->u[ij + s->offset[kase][3]] + s->u[ij + s->offset[kase][10]] - s->u[ij + s->offset[kase][1]] -
+			                                      s->u[ij + s->offset[kase][8]]) +
+			                            s->two_plus_ep2 * (s->u[ij + s->offset[kase][5]] - s->u[ij + s->offset[kase][6]]));
 			/*  - tense * (u[ij + offset[kase][6]] - u[ij + offset[kase][5]]) / (1.0 - tense);  */
 		}
 
 		/* That's it for the boundary points.  Now loop over all data  */
 
-		x_w_case = 0;
-		x_e_case = block_n_columns - 1;
-		for (int i = 0; i < n_columns; i += grid, x_w_case++, x_e_case--) {
-
-			if (x_w_case < 2)
-				x_case = x_w_case;
-			else if (x_e_case < 2)
-				x_case = 4 - x_e_case;
-			else
-				x_case = 2;
-
-			y_s_case = 0;
-			y_n_case = block_n_rows - 1;
-
-			ij = ij_sw_corner + i * m_rows;
-
-			for (int j = 0; j < n_rows; j += grid, ij += grid, y_s_case++, y_n_case--) {
-
-				if (iu[ij] == 5)
-					continue; /* Point is fixed  */
-
-				if (y_s_case < 2)
-					y_case = y_s_case;
-				else if (y_n_case < 2)
-					y_case = 4 - y_n_case;
+		if (s->nthreads > 1 && s->block_n_columns * s->block_n_rows >= MB_SURFACE_THREAD_MIN_NODES) {
+			max_change = sweep_parallel(s);
+		}
+		else {
+			x_w_case = 0;
+			x_e_case = s->block_n_columns - 1;
+			for (int i = 0; i < s->n_columns; i += s->grid, x_w_case++, x_e_case--) {
+
+				if (x_w_case < 2)
+					x_case = x_w_case;
+				else if (x_e_case < 2)
+					x_case = 4 - x_e_case;
 				else
-					y_case = 2;
+					x_case = 2;
 
-				kase = x_case * 5 + y_case;
-				sum_ij = 0.0;
+				y_s_case = 0;
+				y_n_case = s->block_n_rows - 1;
 
-				if (iu[ij] == 0) { /* Point is unconstrained  */
-					for (k = 0; k < 12; k++) {
-						sum_ij += (u[ij + offset[kase][k]] * coeff[0][k]);
-					}
-				}
-				else { /* Point is constrained  */
-
-					b0 = briggs[briggs_index].b[0];
-					b1 = briggs[briggs_index].b[1];
-					b2 = briggs[briggs_index].b[2];
-					b3 = briggs[briggs_index].b[3];
-					b4 = briggs[briggs_index].b[4];
-					b5 = briggs[briggs_index].b[5];
-					briggs_index++;
-					if (iu[ij] < 3) {
-						if (iu[ij] == 1) { /* Point is in quadrant 1  */
-							busum = b0 * u[ij + offset[kase][10]] + b1 * u[ij + offset[kase][9]] + b2 * u[ij + offset[kase][5]] +
-							        b3 * u[ij + offset[kase][1]];
-						}
-						else { /* Point is in quadrant 2  */
-							busum = b0 * u[ij + offset[kase][8]] + b1 * u[ij + offset[kase][9]] + b2 * u[ij + offset[kase][6]] +
-							        b3 * u[ij + offset[kase][3]];
-						}
-					}
-					else {
-						if (iu[ij] == 3) { /* Point is in quadrant 3  */
-							busum = b0 * u[ij + offset[kase][1]] + b1 * u[ij + offset[kase][2]] + b2 * u[ij + offset[kase][6]] +
-							        b3 * u[ij + offset[kase][10]];
-						}
-						else { /* Point is in quadrant 4  */
-							busum = b0 * u[ij + offset[kase][3]] + b1 * u[ij + offset[kase][2]] + b2 * u[ij + offset[kase][5]] +
-							        b3 * u[ij + offset[kase][8]];
-						}
-					}
-					for (k = 0; k < 12; k++) {
-						sum_ij += (u[ij + offset[kase][k]] * coeff[1][k]);
-					}
-					sum_ij = (sum_ij + a0_const_2 * (busum + b5)) / (a0_const_1 + a0_const_2 * b4);
-				}
+				ij = s->ij_sw_corner + i * s->m_rows;
 
-				/* New relaxation here  */
-				sum_ij = u[ij] * relax_old + sum_ij * relax_new;
+				for (int j = 0; j < s->n_rows; j += s->grid, ij += s->grid, y_s_case++, y_n_case--) {
 
-				if (constrained) { /* Must check limits.  Note lower/upper is v2 format and need ij_v2! */
-					ij_v2 = (n_rows - j - 1) * n_columns + i;
-					if (set_low /*&& !GMT_is_fnan((double)lower[ij_v2])*/ && sum_ij < lower[ij_v2])
-						sum_ij = lower[ij_v2];
-					else if (set_high /*&& !GMT_is_fnan((double)upper[ij_v2])*/ && sum_ij > upper[ij_v2])
-						sum_ij = upper[ij_v2];
-				}
+					if (s->iu[ij] == 5)
+						continue; /* Point is fixed  */
 
-				change = fabs(sum_ij - u[ij]);
-				u[ij] = sum_ij;
-				if (change > max_change)
-					max_change = change;
+					if (y_s_case < 2)
+						y_case = y_s_case;
+					else if (y_n_case < 2)
+						y_case = 4 - y_n_case;
+					else
+						y_case = 2;
+
+					kase = x_case * 5 + y_case;
+					const double change = relax_node(s, i, j, ij, kase, briggs_index);
+					if (s->iu[ij] != 0)
+						briggs_index++;
+					if (change > max_change)
+						max_change = change;
+				}
 			}
 		}
 		iteration_count++;
-		total_iterations++;
-		max_change *= z_scale; /* Put max_change into z units  */
-		if (local_verbose > 1)
-			fprintf(stderr, "%4d\t%c\t%8d\t%10lg\t%10lg\t%10d\n", grid, mode_type[mode], iteration_count, max_change,
-			        current_limit, total_iterations);
+		s->total_iterations++;
+		max_change *= s->z_scale; /* Put max_change into z units  */
+		if (s->local_verbose > 1)
+			fprintf(stderr, "%4d\t%c\t%8d\t%10lg\t%10lg\t%10d\n", s->grid, mode_type[mode], iteration_count, max_change,
+			        current_limit, s->total_iterations);
 
-	} while (max_change > current_limit && iteration_count < max_iterations);
+	} while (max_change > current_limit && iteration_count < s->max_iterations);
 
-	if (local_verbose)
-		fprintf(stderr, "%4d\t%c\t%8d\t%10lg\t%10lg\t%10d\n", grid, mode_type[mode], iteration_count, max_change, current_limit,
-		        total_iterations);
+	if (s->local_verbose)
+		fprintf(stderr, "%4d\t%c\t%8d\t%10lg\t%10lg\t%10d\n", s->grid, mode_type[mode], iteration_count, max_change, current_limit,
+		        s->total_iterations);
 
 	return (iteration_count);
 }
 
 
-void check_errors() {
-	const double x_0_const = 4.0 * (1.0 - boundary_tension) / (2.0 - boundary_tension);
-	const double x_1_const = (3 * boundary_tension - 2.0) / (2.0 - boundary_tension);
-	const double y_denom = 2 * epsilon * (1.0 - boundary_tension) + boundary_tension;
-	const double y_0_const = 4 * epsilon * (1.0 - boundary_tension) / y_denom;
-	const double y_1_const = (boundary_tension - 2 * epsilon * (1.0 - boundary_tension)) / y_denom;
+static void check_errors(struct mb_surface_struct *s) {
+	const double x_0_const = 4.0 * (1.0 - s->boundary_tension) / (2.0 - s->boundary_tension);
+	const double x_1_const = (3 * s->boundary_tension - 2.0) / (2.0 - s->boundary_tension);
+	const double y_denom = 2 * s->epsilon * (1.0 - s->boundary_tension) + s->boundary_tension;
+	const double y_0_const = 4 * s->epsilon * (1.0 - s->boundary_tension) / y_denom;
+	const double y_1_const = (s->boundary_tension - 2 * s->epsilon * (1.0 - s->boundary_tension)) / y_denom;
 
 	// move_over = offset[kase][12], but grid = 1 so move_over is easy
 	const int move_over[12] = {
 		2,
-		1 - m_rows,
+		1 - s->m_rows,
 		1,
-		1 + m_rows,
-		-2 * m_rows,
-		-m_rows,
-		m_rows,
-		2 * m_rows,
-		-1 - m_rows,
+		1 + s->m_rows,
+		-2 * s->m_rows,
+		-s->m_rows,
+		s->m_rows,
+		2 * s->m_rows,
+		-1 - s->m_rows,
 		-1,
-		-1 + m_rows,
+		-1 + s->m_rows,
 		-2,
 	};
 
@@ -821,106 +990,106 @@ void check_errors() {
 	double mean_squared_error = 0.0;
 
 	/* First update the boundary values  */
-	for (int i = 0; i < n_columns; i++) {
-		int ij = ij_sw_corner + i * m_rows;
-		u[ij - 1] = y_0_const * u[ij] + y_1_const * u[ij + 1];
-		ij = ij_nw_corner + i * m_rows;
-		u[ij + 1] = y_0_const * u[ij] + y_1_const * u[ij - 1];
+	for (int i = 0; i < s->n_columns; i++) {
+		int ij = s->ij_sw_corner + i * s->m_rows;
+		s->u[ij - 1] = y_0_const * s->u[ij] + y_1_const * s->u[ij + 1];
+		ij = s->ij_nw_corner + i * s->m_rows;
+		s->u[ij + 1] = y_0_const * s->u[ij] + y_1_const * s->u[ij - 1];
 	}
 
-	for (int j = 0; j < n_rows; j++) {
-		int ij = ij_sw_corner + j;
-		u[ij - m_rows] = x_1_const * u[ij + m_rows] + x_0_const * u[ij];
-		ij = ij_se_corner + j;
-		u[ij + m_rows] = x_1_const * u[ij - m_rows] + x_0_const * u[ij];
+	for (int j = 0; j < s->n_rows; j++) {
+		int ij = s->ij_sw_corner + j;
+		s->u[ij - s->m_rows] = x_1_const * s->u[ij + s->m_rows] + x_0_const * s->u[ij];
+		ij = s->ij_se_corner + j;
+		s->u[ij + s->m_rows] = x_1_const * s->u[ij - s->m_rows] + x_0_const * s->u[ij];
 	}
 
-	int ij = ij_sw_corner;
-	u[ij - m_rows - 1] = u[ij + m_rows - 1] + u[ij - m_rows + 1] - u[ij + m_rows + 1];
-	ij = ij_nw_corner;
-	u[ij - m_rows + 1] = u[ij + m_rows + 1] + u[ij - m_rows - 1] - u[ij + m_rows - 1];
-	ij = ij_se_corner;
-	u[ij + m_rows - 1] = u[ij - m_rows - 1] + u[ij + m_rows + 1] - u[ij - m_rows + 1];
-	ij = ij_ne_corner;
-	u[ij + m_rows + 1] = u[ij - m_rows + 1] + u[ij + m_rows - 1] - u[ij - m_rows - 1];
-
-	for (int i = 0; i < n_columns; i++) {
-
-		ij = ij_sw_corner + i * m_rows;
-		u[ij + move_over[11]] =
-		    (u[ij + move_over[0]] +
-		     eps_m2 * (u[ij + move_over[1]] + u[ij + move_over[3]] - u[ij + move_over[8]] - u[ij + move_over[10]]) +
-		     two_plus_em2 * (u[ij + move_over[9]] - u[ij + move_over[2]]));
-
-		ij = ij_nw_corner + i * m_rows;
-		u[ij + move_over[0]] =
-		    -(-u[ij + move_over[11]] +
-		      eps_m2 * (u[ij + move_over[1]] + u[ij + move_over[3]] - u[ij + move_over[8]] - u[ij + move_over[10]]) +
-		      two_plus_em2 * (u[ij + move_over[9]] - u[ij + move_over[2]]));
+	int ij = s->ij_sw_corner;
+	s->u[ij - s->m_rows - 1] = s->u[ij + s->m_rows - 1] + s->u[ij - s->m_rows + 1] - s->u[ij + s->m_rows + 1];
+	ij = s->ij_nw_corner;
+	s->u[ij - s->m_rows + 1] = s->u[ij + s->m_rows + 1] + s->u[ij - s->m_rows - 1] - s->u[ij + s->m_rows - 1];
+	ij = s->ij_se_corner;
+	s->u[ij + s->m_rows - 1] = s->u[ij - s->m_rows - 1] + s->u[ij + s->m_rows + 1] - s->u[ij - s->m_rows + 1];
+	ij = s->ij_ne_corner;
+	s->u[ij + s->m_rows + 1] = s->u[ij - s->m_rows + 1] + s->u[ij + s->m_rows - 1] - s->u[ij - s->m_rows - 1];
+
+	for (int i = 0; i < s->n_columns; i++) {
+
+		ij = s->ij_sw_corner + i * s->m_rows;
+		s->u[ij + move_over[11]] =
+		    (s->u[ij + move_over[0]] +
+		     s->eps_m2 * (s->u[ij + move_over[1]] + s->u[ij + move_over[3]] - s->u[ij + move_over[8]] - s->u[ij + move_over[10]]) +
+		     s->two_plus_em2 * (s->u[ij + move_over[9]] - s->u[ij + move_over[2]]));
+
+		ij = s->ij_nw_corner + i * s->m_rows;
+		s->u[ij + move_over[0]] =
+		    -(-s->u[ij + move_over[11]] +
+		      s->eps_m2 * (s->u[ij + move_over[1]] + s->u[ij + move_over[3]] - s->u[ij + move_over[8]] - s->u[ij + move_over[10]]) +
+		      s->two_plus_em2 * (s->u[ij + move_over[9]] - s->u[ij + move_over[2]]));
 	}
 
-	for (int j = 0; j < n_rows; j++) {
+	for (int j = 0; j < s->n_rows; j++) {
 
-		ij = ij_sw_corner + j;
-		u[ij + move_over[4]] =
-		    u[ij + move_over[7]] +
-		    eps_p2 * (u[ij + move_over[3]] + u[ij + move_over[10]] - u[ij + move_over[1]] - u[ij + move_over[8]]) +
-		    two_plus_ep2 * (u[ij + move_over[5]] - u[ij + move_over[6]]);
+		ij = s->ij_sw_corner + j;
+		s->u[ij + move_over[4]] =
+		    s->u[ij + move_over[7]] +
+		    s->eps_p2 * (s->u[ij + move_over[3]] + s->u[ij + move_over[10]] - s->u[ij + move_over[1]] - s->u[ij + move_over[8]]) +
+		    s->two_plus_ep2 * (s->u[ij + move_over[5]] - s->u[ij + move_over[6]]);
 
-		ij = ij_se_corner + j;
-		u[ij + move_over[7]] =
-		    -(-u[ij + move_over[4]] +
-		      eps_p2 * (u[ij + move_over[3]] + u[ij + move_over[10]] - u[ij + move_over[1]] - u[ij + move_over[8]]) +
-		      two_plus_ep2 * (u[ij + move_over[5]] - u[ij + move_over[6]]));
+		ij = s->ij_se_corner + j;
+		s->u[ij + move_over[7]] =
+		    -(-s->u[ij + move_over[4]] +
+		      s->eps_p2 * (s->u[ij + move_over[3]] + s->u[ij + move_over[10]] - s->u[ij + move_over[1]] - s->u[ij + move_over[8]]) +
+		      s->two_plus_ep2 * (s->u[ij + move_over[5]] - s->u[ij + move_over[6]]));
 	}
 
 	/* That resets the boundary values.  Now we can test all data.
 	    Note that this loop checks all values, even though only nearest were used.  */
 
-	for (int k = 0; k < npoints; k++) {
-		int i = data[k].index / n_rows;
-		int j = data[k].index % n_rows;
-		ij = ij_sw_corner + i * m_rows + j;
-		if (iu[ij] == 5)
+	for (int k = 0; k < s->npoints; k++) {
+		int i = s->data[k].index / s->n_rows;
+		int j = s->data[k].index % s->n_rows;
+		ij = s->ij_sw_corner + i * s->m_rows + j;
+		if (s->iu[ij] == 5)
 			continue;
-		const double x0 = xmin + i * xinc;
-		const double y0 = ymin + j * yinc;
-		const double dx = (data[k].x - x0) * r_xinc;
-		const double dy = (data[k].y - y0) * r_yinc;
-
-		const double du_dx = 0.5 * (u[ij + move_over[6]] - u[ij + move_over[5]]);
-		const double du_dy = 0.5 * (u[ij + move_over[2]] - u[ij + move_over[9]]);
-		const double d2u_dx2 = u[ij + move_over[6]] + u[ij + move_over[5]] - 2 * u[ij];
-		const double d2u_dy2 = u[ij + move_over[2]] + u[ij + move_over[9]] - 2 * u[ij];
-		const double d2u_dxdy = 0.25 * (u[ij + move_over[3]] - u[ij + move_over[1]] - u[ij + move_over[10]] + u[ij + move_over[8]]);
-		const double d3u_dx3 = 0.5 * (u[ij + move_over[7]] - 2 * u[ij + move_over[6]] + 2 * u[ij + move_over[5]] - u[ij + move_over[4]]);
-		const double d3u_dy3 = 0.5 * (u[ij + move_over[0]] - 2 * u[ij + move_over[2]] + 2 * u[ij + move_over[9]] - u[ij + move_over[11]]);
-		const double d3u_dx2dy = 0.5 * ((u[ij + move_over[3]] + u[ij + move_over[1]] - 2 * u[ij + move_over[2]]) -
-		                   (u[ij + move_over[10]] + u[ij + move_over[8]] - 2 * u[ij + move_over[9]]));
-		const double d3u_dxdy2 = 0.5 * ((u[ij + move_over[3]] + u[ij + move_over[10]] - 2 * u[ij + move_over[6]]) -
-		                   (u[ij + move_over[1]] + u[ij + move_over[8]] - 2 * u[ij + move_over[5]]));
+		const double x0 = s->xmin + i * s->xinc;
+		const double y0 = s->ymin + j * s->yinc;
+		const double dx = (s->data[k].x - x0) * s->r_xinc;
+		const double dy = (s->data[k].y - y0) * s->r_yinc;
+
+		const double du_dx = 0.5 * (s->u[ij + move_over[6]] - s->u[ij + move_over[5]]);
+		const double du_dy = 0.5 * (s->u[ij + move_over[2]] - s->u[ij + move_over[9]]);
+		const double d2u_dx2 = s->u[ij + move_over[6]] + s->u[ij + move_over[5]] - 2 * s->u[ij];
+		const double d2u_dy2 = s->u[ij + move_over[2]] + s->u[ij + move_over[9]] - 2 * s->u[ij];
+		const double d2u_dxdy = 0.25 * (s->u[ij + move_over[3]] - s->u[ij + move_over[1]] - s->u[ij + move_over[10]] + s->u[ij + move_over[8]]);
+		const double d3u_dx3 = 0.5 * (s->u[ij + move_over[7]] - 2 * s->u[ij + move_over[6]] + 2 * s->u[ij + move_over[5]] - s->u[ij + move_over[4]]);
+		const double d3u_dy3 = 0.5 * (s->u[ij + move_over[0]] - 2 * s->u[ij + move_over[2]] + 2 * s->u[ij + move_over[9]] - s->u[ij + move_over[11]]);
+		const double d3u_dx2dy = 0.5 * ((s->u[ij + move_over[3]] + s->u[ij + move_over[1]] - 2 * s->u[ij + move_over[2]]) -
+		                   (s->u[ij + move_over[10]] + s->u[ij + move_over[8]] - 2 * s->u[ij + move_over[9]]));
+		const double d3u_dxdy2 = 0.5 * ((s->u[ij + move_over[3]] + s->u[ij + move_over[10]] - 2 * s->u[ij + move_over[6]]) -
+		                   (s->u[ij + move_over[1]] + s->u[ij + move_over[8]] - 2 * s->u[ij + move_over[5]]));
 
 		/* 3rd order Taylor approx:  */
 
-		const double z_est = u[ij] + dx * (du_dx + dx * ((0.5 * d2u_dx2) + dx * (d3u_dx3 / 6.0))) +
+		const double z_est = s->u[ij] + dx * (du_dx + dx * ((0.5 * d2u_dx2) + dx * (d3u_dx3 / 6.0))) +
 		        dy * (du_dy + dy * ((0.5 * d2u_dy2) + dy * (d3u_dy3 / 6.0))) + dx * dy * (d2u_dxdy) + (0.5 * dx * d3u_dx2dy) +
 		        (0.5 * dy * d3u_dxdy2);
 
-		const double z_err = z_est - data[k].z;
+		const double z_err = z_est - s->data[k].z;
 		mean_error += z_err;
 		mean_squared_error += (z_err * z_err);
 	}
-	mean_error /= npoints;
-	mean_squared_error = sqrt(mean_squared_error / npoints);
+	mean_error /= s->npoints;
+	mean_squared_error = sqrt(mean_squared_error / s->npoints);
 
-	const int n_nodes = n_columns * n_rows;
+	const int n_nodes = s->n_columns * s->n_rows;
 	double curvature = 0.0;
 
-	for (int i = 0; i < n_columns; i++) {
-		for (int j = 0; j < n_rows; j++) {
-			ij = ij_sw_corner + i * m_rows + j;
-			const double c = u[ij + move_over[6]] + u[ij + move_over[5]] + u[ij + move_over[2]] + u[ij + move_over[9]] -
-			    4.0 * u[ij + move_over[6]];
+	for (int i = 0; i < s->n_columns; i++) {
+		for (int j = 0; j < s->n_rows; j++) {
+			ij = s->ij_sw_corner + i * s->m_rows + j;
+			const double c = s->u[ij + move_over[6]] + s->u[ij + move_over[5]] + s->u[ij + move_over[2]] + s->u[ij + move_over[9]] -
+			    4.0 * s->u[ij + move_over[6]];
 			curvature += (c * c);
 		}
 	}
@@ -930,14 +1099,14 @@ void check_errors() {
 	fprintf (stderr,"\t%8d\t%8d\t%.8lg\t%.8lg\t%.8lg\n", npoints, n_nodes, mean_error, mean_squared_error,
 	   curvature);
    */
-	if (local_verbose) {
+	if (s->local_verbose) {
 		fprintf(stderr, "\nSpline interpolation fit information:\n");
 		fprintf(stderr, "Data points   nodes    mean error     rms error     curvature\n");
-		fprintf(stderr, "%9d %9d   %10g   %10g  %10g\n", npoints, n_nodes, mean_error, mean_squared_error, curvature);
+		fprintf(stderr, "%9d %9d   %10g   %10g  %10g\n", s->npoints, n_nodes, mean_error, mean_squared_error, curvature);
 	}
 }
 
-int remove_planar_trend() {
+static int remove_planar_trend(struct mb_surface_struct *s) {
 	double xx = 0.0;
 	double yy = 0.0;
 	double zz = 0.0;
@@ -950,11 +1119,11 @@ int remove_planar_trend() {
 	double syy = 0.0;
 	double syz = 0.0;
 
-	for (int i = 0; i < npoints; i++) {
+	for (int i = 0; i < s->npoints; i++) {
 
-		xx = (data[i].x - xmin) * r_xinc;
-		yy = (data[i].y - ymin) * r_yinc;
-		zz = data[i].z;
+		xx = (s->data[i].x - s->xmin) * s->r_xinc;
+		yy = (s->data[i].y - s->ymin) * s->r_yinc;
+		zz = s->data[i].z;
 
 		sx += xx;
 		sy += yy;
@@ -966,43 +1135,43 @@ int remove_planar_trend() {
 		syz += (yy * zz);
 	}
 
-	const double d = npoints * sxx * syy + 2 * sx * sy * sxy - npoints * sxy * sxy - sx * sx * syy - sy * sy * sxx;
+	const double d = s->npoints * sxx * syy + 2 * sx * sy * sxy - s->npoints * sxy * sxy - sx * sx * syy - sy * sy * sxx;
 
 	if (d == 0.0) {
-		plane_c0 = plane_c1 = plane_c2 = 0.0;
+		s->plane_c0 = s->plane_c1 = s->plane_c2 = 0.0;
 		return (0);
 	}
 
 	const double a = sz * sxx * syy + sx * sxy * syz + sy * sxy * sxz - sz * sxy * sxy - sx * sxz * syy - sy * syz * sxx;
-	const double b = npoints * sxz * syy + sz * sy * sxy + sy * sx * syz - npoints * sxy * syz - sz * sx * syy - sy * sy * sxz;
-	const double c = npoints * sxx * syz + sx * sy * sxz + sz * sx * sxy - npoints * sxy * sxz - sx * sx * syz - sz * sy * sxx;
+	const double b = s->npoints * sxz * syy + sz * sy * sxy + sy * sx * syz - s->npoints * sxy * syz - sz * sx * syy - sy * sy * sxz;
+	const double c = s->npoints * sxx * syz + sx * sy * sxz + sz * sx * sxy - s->npoints * sxy * sxz - sx * sx * syz - sz * sy * sxx;
 
-	plane_c0 = a / d;
-	plane_c1 = b / d;
-	plane_c2 = c / d;
+	s->plane_c0 = a / d;
+	s->plane_c1 = b / d;
+	s->plane_c2 = c / d;
 
-	for (int i = 0; i < npoints; i++) {
+	for (int i = 0; i < s->npoints; i++) {
 
-		xx = (data[i].x - xmin) * r_xinc;
-		yy = (data[i].y - ymin) * r_yinc;
+		xx = (s->data[i].x - s->xmin) * s->r_xinc;
+		yy = (s->data[i].y - s->ymin) * s->r_yinc;
 
-		data[i].z -= (plane_c0 + plane_c1 * xx + plane_c2 * yy);
+		s->data[i].z -= (s->plane_c0 + s->plane_c1 * xx + s->plane_c2 * yy);
 	}
 
 	return (0);
 }
 
-int replace_planar_trend() {
-	for (int i = 0; i < n_columns; i++) {
-		for (int j = 0; j < n_rows; j++) {
-			const int ij = ij_sw_corner + i * m_rows + j;
-			u[ij] = (u[ij] * z_scale) + (plane_c0 + plane_c1 * i + plane_c2 * j);
+static int replace_planar_trend(struct mb_surface_struct *s) {
+	for (int i = 0; i < s->n_columns; i++) {
+		for (int j = 0; j < s->n_rows; j++) {
+			const int ij = s->ij_sw_corner + i * s->m_rows + j;
+			s->u[ij] = (s->u[ij] * s->z_scale) + (s->plane_c0 + s->plane_c1 * i + s->plane_c2 * j);
 		}
 	}
 	return (0);
 }
 
-int throw_away_unusables() {
+static int throw_away_unusables(struct mb_surface_struct *s) {
 	/* This is a new routine to eliminate data which will become
 	    unusable on the final iteration, when grid = 1.
 	    It assumes grid = 1 and set_grid_parameters has been
@@ -1013,28 +1182,30 @@ int throw_away_unusables() {
 	    of a new implementation using core memory for b[6]
 	    coefficients, eliminating calls to temp file.
 	*/
-	qsort((char *)data, npoints, sizeof(struct MB_SURFACE_DATA), (void *)compare_points);
+	set_distances(s);
+	qsort((char *)s->data, s->npoints, sizeof(struct MB_SURFACE_DATA), compare_points);
 
 	/* If more than one datum is indexed to same node, only the first should be kept.
 	    Mark the additional ones as OUTSIDE
 	*/
 	int last_index = -1;
 	int n_outside = 0;
-	for (int k = 0; k < npoints; k++) {
-		if (data[k].index == last_index) {
-			data[k].index = OUTSIDE;
+	for (int k = 0; k < s->npoints; k++) {
+		if (s->data[k].index == last_index) {
+			s->data[k].index = OUTSIDE;
 			n_outside++;
 		}
 		else {
-			last_index = data[k].index;
+			last_index = s->data[k].index;
 		}
 	}
 	/* Sort again; this time the OUTSIDE points will be thrown away  */
-	qsort((char *)data, npoints, sizeof(struct MB_SURFACE_DATA), (void *)compare_points);
-	npoints -= n_outside;
-	status =
-	    mb_reallocd(local_verbose, __FILE__, __LINE__, npoints * sizeof(struct MB_SURFACE_DATA), (void **)&data, &local_error);
-	if (local_verbose && (n_outside)) {
+	set_distances(s);
+	qsort((char *)s->data, s->npoints, sizeof(struct MB_SURFACE_DATA), compare_points);
+	s->npoints -= n_outside;
+	s->status =
+	    mb_reallocd(s->local_verbose, __FILE__, __LINE__, s->npoints * sizeof(struct MB_SURFACE_DATA), (void **)&s->data, &s->local_error);
+	if (s->local_verbose && (n_outside)) {
 		fprintf(stderr, "surface: %d unusable points were supplied; these will be ignored.\n", n_outside);
 		fprintf(stderr, "\tYou should have pre-processed the data with blockmean or blockmedian.\n");
 	}
@@ -1042,36 +1213,36 @@ int throw_away_unusables() {
 	return (0);
 }
 
-int rescale_z_values() {
+static int rescale_z_values(struct mb_surface_struct *s) {
 	double ssz = 0.0;
 
-	for (int i = 0; i < npoints; i++) {
-		ssz += (data[i].z * data[i].z);
+	for (int i = 0; i < s->npoints; i++) {
+		ssz += (s->data[i].z * s->data[i].z);
 	}
 
 	/* Set z_scale = rms(z):  */
 
-	z_scale = sqrt(ssz / npoints);
-	r_z_scale = 1.0 / z_scale;
+	s->z_scale = sqrt(ssz / s->npoints);
+	s->r_z_scale = 1.0 / s->z_scale;
 
-	for (int i = 0; i < npoints; i++) {
-		data[i].z *= r_z_scale;
+	for (int i = 0; i < s->npoints; i++) {
+		s->data[i].z *= s->r_z_scale;
 	}
 	return (0);
 }
 
-void load_constraints(char *low, char *high) {
+static void load_constraints(struct mb_surface_struct *s, char *low, char *high) {
 	(void)low;  // Unused parameter
 	(void)high;  // Unused parameter
 	/*	struct GRD_HEADER hdr;*/
 
 	/* Load lower/upper limits, verify range, deplane, and rescale */
 
-	if (set_low > 0) {
-		status = mb_mallocd(local_verbose, __FILE__, __LINE__, n_columns * n_rows * sizeof(float), (void **)&lower, &local_error);
-		if (set_low < 3)
-			for (int i = 0; i < n_columns * n_rows; i++)
-				lower[i] = low_limit;
+	if (s->set_low > 0) {
+		s->status = mb_mallocd(s->local_verbose, __FILE__, __LINE__, s->n_columns * s->n_rows * sizeof(float), (void **)&s->lower, &s->local_error);
+		if (s->set_low < 3)
+			for (int i = 0; i < s->n_columns * s->n_rows; i++)
+				s->lower[i] = s->low_limit;
 		/* Comment this out:
 		        else {
 		            if (read_grd_info (low, &hdr)) {
@@ -1095,21 +1266,21 @@ void load_constraints(char *low, char *high) {
 		        }
 		*/
 
-		for (int j = 0, ij = 0; j < n_rows; j++) {
-			const double yy = n_rows - j - 1;  // TODO(schwehr): Why is yy a double?
-			for (int i = 0; i < n_columns; i++, ij++) {
+		for (int j = 0, ij = 0; j < s->n_rows; j++) {
+			const double yy = s->n_rows - j - 1;  // TODO(schwehr): Why is yy a double?
+			for (int i = 0; i < s->n_columns; i++, ij++) {
 				/*if (GMT_is_fnan ((double)lower[ij])) continue;*/
-				lower[ij] -= (plane_c0 + plane_c1 * i + plane_c2 * yy);
-				lower[ij] *= r_z_scale;
+				s->lower[ij] -= (s->plane_c0 + s->plane_c1 * i + s->plane_c2 * yy);
+				s->lower[ij] *= s->r_z_scale;
 			}
 		}
-		constrained = TRUE;
+		s->constrained = TRUE;
 	}
-	if (set_high > 0) {
-		status = mb_mallocd(local_verbose, __FILE__, __LINE__, n_columns * n_rows * sizeof(float), (void **)&upper, &local_error);
-		if (set_high < 3)
-			for (int i = 0; i < n_columns * n_rows; i++)
-				upper[i] = high_limit;
+	if (s->set_high > 0) {
+		s->status = mb_mallocd(s->local_verbose, __FILE__, __LINE__, s->n_columns * s->n_rows * sizeof(float), (void **)&s->upper, &s->local_error);
+		if (s->set_high < 3)
+			for (int i = 0; i < s->n_columns * s->n_rows; i++)
+				s->upper[i] = s->high_limit;
 		/* Comment this out:
 		        else {
 		            if (read_grd_info (high, &hdr)) {
@@ -1132,19 +1303,19 @@ void load_constraints(char *low, char *high) {
 		            if (n_trimmed) fprintf (stderr, "surface: %d upper limit values < max data, reset to max data!\n");
 		        }
 		*/
-		for (int j = 0, ij = 0; j < n_rows; j++) {
-			const double yy = n_rows - j - 1;  // TODO(schwehr): Why is yy a double?
-			for (int i = 0; i < n_columns; i++, ij++) {
+		for (int j = 0, ij = 0; j < s->n_rows; j++) {
+			const double yy = s->n_rows - j - 1;  // TODO(schwehr): Why is yy a double?
+			for (int i = 0; i < s->n_columns; i++, ij++) {
 				/*if (GMT_is_fnan ((double)upper[ij])) continue;*/
-				upper[ij] -= (plane_c0 + plane_c1 * i + plane_c2 * yy);
-				upper[ij] *= r_z_scale;
+				s->upper[ij] -= (s->plane_c0 + s->plane_c1 * i + s->plane_c2 * yy);
+				s->upper[ij] *= s->r_z_scale;
 			}
 		}
-		constrained = TRUE;
+		s->constrained = TRUE;
 	}
 }
 
-int get_prime_factors(int n, int f[]) {
+static int get_prime_factors(int n, int f[]) {
 	/* Fills the integer array f with the prime factors of n.
 	 * Returns the number of locations filled in f, which is
 	 * one if n is prime.
@@ -1260,7 +1431,7 @@ int get_prime_factors(int n, int f[]) {
 // #define IABS(i) (((i) < 0) ? -(i) : (i))
 static int IABS(int i) {return i < 0 ? -i : i;}
 
-int gcd_euclid(int a, int b) {
+static int gcd_euclid(int a, int b) {
 	/* Returns the greatest common divisor of u and v by Euclid's method.
 	 * I have experimented also with Stein's method, which involves only
 	 * subtraction and left/right shifting; Euclid is faster, both for
@@ -1283,6 +1454,16 @@ int gcd_euclid(int a, int b) {
 
 int mb_surface(int verbose, int ndat, float *xdat, float *ydat, float *zdat, double xxmin, double xxmax, double yymin,
                double yymax, double xxinc, double yyinc, double ttension, float *sgrid) {
+	return (mb_surface_threads(verbose, ndat, xdat, ydat, zdat, xxmin, xxmax, yymin, yymax, xxinc, yyinc, ttension, 1, sgrid));
+}
+
+/* The interpolation state is held in a local context so that any number of
+    interpolations may run concurrently. With nthreads > 1 the relaxation
+    sweeps over large grids are split between threads using a five color
+    ordering of the nodes; the result then differs from the single threaded
+    result within the convergence limit but not with the number of threads. */
+int mb_surface_threads(int verbose, int ndat, float *xdat, float *ydat, float *zdat, double xxmin, double xxmax, double yymin,
+               double yymax, double xxinc, double yyinc, double ttension, int nthreads, float *sgrid) {
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBBA function <%s> called\n", __func__);
 		fprintf(stderr, "dbg2  Input arguments:\n");
@@ -1294,29 +1475,44 @@ int mb_surface(int verbose, int ndat, float *xdat, float *ydat, float *zdat, dou
 		fprintf(stderr, "dbg2       xxinc:      %f\n", xxinc);
 		fprintf(stderr, "dbg2       xxinc:      %f\n", xxinc);
 		fprintf(stderr, "dbg2       ttension:   %f\n", ttension);
+		fprintf(stderr, "dbg2       nthreads:   %d\n", nthreads);
 		fprintf(stderr, "dbg2       ndat:       %d\n", ndat);
 		for (int i = 0; i < ndat; i++)
 			fprintf(stderr, "dbg2       data:       %f %f %f\n", xdat[i], ydat[i], zdat[i]);
 	}
 
+	/* initialize the interpolation context */
+	struct mb_surface_struct surface;
+	memset(&surface, 0, sizeof(struct mb_surface_struct));
+	struct mb_surface_struct *s = &surface;
+	s->max_iterations = 250;
+	s->local_error = MB_ERROR_NO_ERROR;
+	s->status = MB_SUCCESS;
+	s->constrained = FALSE;
+	s->epsilon = 1.0;
+	s->z_scale = 1.0;
+	s->r_z_scale = 1.0;
+	s->relax_new = 1.4;
+	s->nthreads = MAX(1, MIN(nthreads, MB_THREAD_MAX));
+
 	/* copy parameters */
-	xmin = xxmin;
-	xmax = xxmax;
-	ymin = yymin;
-	ymax = yymax;
-	xinc = xxinc;
-	yinc = yyinc;
-	tension = ttension;
-	total_iterations = 0;
+	s->xmin = xxmin;
+	s->xmax = xxmax;
+	s->ymin = yymin;
+	s->ymax = yymax;
+	s->xinc = xxinc;
+	s->yinc = yyinc;
+	s->tension = ttension;
+	s->total_iterations = 0;
 
 	/* set local verbose */
 	if (verbose > 0)
-		local_verbose = TRUE;
+		s->local_verbose = TRUE;
 	else
-		local_verbose = FALSE;
+		s->local_verbose = FALSE;
 
 	/* New in v4.3:  Default to unconstrained:  */
-	set_low = set_high = 0;
+	s->set_low = s->set_high = 0;
 
 	// bool serror = false;
 	// if (xmin >= xmax || ymin >= ymax)
@@ -1324,21 +1520,21 @@ int mb_surface(int verbose, int ndat, float *xdat, float *ydat, float *zdat, dou
 	// if (xinc <= 0.0 || yinc <= 0.0)
 	// 	serror = true;
 
-	if (tension != 0.0) {
-		boundary_tension = tension;
-		interior_tension = tension;
+	if (s->tension != 0.0) {
+		s->boundary_tension = s->tension;
+		s->interior_tension = s->tension;
 	}
-	relax_old = 1.0 - relax_new;
+	s->relax_old = 1.0 - s->relax_new;
 
-	n_columns = rint((xmax - xmin) / xinc) + 1;
-	n_rows = rint((ymax - ymin) / yinc) + 1;
-	m_columns = n_columns + 4;
-	m_rows = n_rows + 4;
-	r_xinc = 1.0 / xinc;
-	r_yinc = 1.0 / yinc;
+	s->n_columns = rint((s->xmax - s->xmin) / s->xinc) + 1;
+	s->n_rows = rint((s->ymax - s->ymin) / s->yinc) + 1;
+	s->m_columns = s->n_columns + 4;
+	s->m_rows = s->n_rows + 4;
+	s->r_xinc = 1.0 / s->xinc;
+	s->r_yinc = 1.0 / s->yinc;
 
 	/* New stuff here for v4.3:  Check out the grid dimensions:  */
-	grid = gcd_euclid(n_columns - 1, n_rows - 1);
+	s->grid = gcd_euclid(s->n_columns - 1, s->n_rows - 1);
 
 	/*
 	if (local_verbose || size_query || grid == 1) fprintf (stderr, "W: %.3lf E: %.3lf S: %.3lf N: %.3lf n_columns: %d n_rows: %d\n",
@@ -1352,87 +1548,126 @@ int mb_surface(int verbose, int ndat, float *xdat, float *ydat, float *zdat, dou
 	    away data that can't be used in end game, constraining
 	    size of briggs->b[6] structure.  */
 
-	grid = 1;
-	set_grid_parameters();
-	read_data(ndat, xdat, ydat, zdat);
-	throw_away_unusables();
-	remove_planar_trend();
-	rescale_z_values();
+	s->grid = 1;
+	set_grid_parameters(s);
+	read_data(s, ndat, xdat, ydat, zdat);
+	throw_away_unusables(s);
+	remove_planar_trend(s);
+	rescale_z_values(s);
 
 	char low[100];
 	char high[100];
-	load_constraints(low, high);
+	load_constraints(s, low, high);
 
 	/* Set up factors and reset grid to first value  */
 
-	grid = gcd_euclid(n_columns - 1, n_rows - 1);
-	n_fact = get_prime_factors(grid, factors);
-	set_grid_parameters();
-	while (block_n_columns < 4 || block_n_rows < 4) {
-		smart_divide();
-		set_grid_parameters();
+	s->grid = gcd_euclid(s->n_columns - 1, s->n_rows - 1);
+	s->n_fact = get_prime_factors(s->grid, s->factors);
+	set_grid_parameters(s);
+	while (s->block_n_columns < 4 || s->block_n_rows < 4) {
+		smart_divide(s);
+		set_grid_parameters(s);
 	}
-	set_offset();
-	set_index();
+	set_offset(s);
+	set_index(s);
 	/* Now the data are ready to go for the first iteration.  */
 
 	/* Allocate more space  */
 
-	status =
-	    mb_mallocd(local_verbose, __FILE__, __LINE__, npoints * sizeof(struct MB_SURFACE_BRIGGS), (void **)&briggs, &local_error);
-	status = mb_mallocd(local_verbose, __FILE__, __LINE__, m_columns * m_rows * sizeof(char), (void **)&iu, &local_error);
-	status = mb_mallocd(local_verbose, __FILE__, __LINE__, m_columns * m_rows * sizeof(float), (void **)&u, &local_error);
+	s->status =
+	    mb_mallocd(s->local_verbose, __FILE__, __LINE__, s->npoints * sizeof(struct MB_SURFACE_BRIGGS), (void **)&s->briggs, &s->local_error);
+	s->status = mb_mallocd(s->local_verbose, __FILE__, __LINE__, s->m_columns * s->m_rows * sizeof(char), (void **)&s->iu, &s->local_error);
+	s->status = mb_mallocd(s->local_verbose, __FILE__, __LINE__, s->m_columns * s->m_rows * sizeof(float), (void **)&s->u, &s->local_error);
+	memset(s->iu, 0, s->m_columns * s->m_rows * sizeof(char));
+	memset(s->u, 0, s->m_columns * s->m_rows * sizeof(float));
+
+	/* start the relaxation threads */
+	if (s->nthreads > 1
+	    && mb_mallocd(s->local_verbose, __FILE__, __LINE__, s->m_columns * s->m_rows * sizeof(int), (void **)&s->ibriggs, &s->local_error) != MB_SUCCESS) {
+		s->ibriggs = NULL;
+		s->nthreads = 1;
+	}
+	if (s->nthreads > 1) {
+		pthread_mutex_init(&s->thread_mutex, NULL);
+		pthread_cond_init(&s->thread_start, NULL);
+		pthread_cond_init(&s->thread_done, NULL);
+		for (int ithread = 0; ithread < s->nthreads; ithread++) {
+			s->workers[ithread].s = s;
+			s->workers[ithread].ithread = ithread;
+		}
+		for (int ithread = 1; ithread < s->nthreads; ithread++) {
+			if (pthread_create(&s->workers[ithread].thread, NULL, surface_worker, &s->workers[ithread]) != 0) {
+				s->nthreads = ithread;
+				break;
+			}
+		}
+	}
 
-	if (radius > 0)
-		initialize_grid(); /* Fill in nodes with a weighted avg in a search radius  */
+	if (s->radius > 0)
+		initialize_grid(s); /* Fill in nodes with a weighted avg in a search radius  */
 
 	/*
 	if (local_verbose) fprintf(stderr,"Grid\tMode\tIteration\tMax Change\tConv Limit\tTotal Iterations\n");
 	*/
 
-	set_coefficients();
-
-	old_grid = grid;
-	find_nearest_point();
-	iterate(1);
-
-	while (grid > 1) {
-		smart_divide();
-		set_grid_parameters();
-		set_offset();
-		set_index();
-		fill_in_forecast();
-		iterate(0);
-		old_grid = grid;
-		find_nearest_point();
-		iterate(1);
+	set_coefficients(s);
+
+	s->old_grid = s->grid;
+	find_nearest_point(s);
+	iterate(s, 1);
+
+	while (s->grid > 1) {
+		smart_divide(s);
+		set_grid_parameters(s);
+		set_offset(s);
+		set_index(s);
+		fill_in_forecast(s);
+		iterate(s, 0);
+		s->old_grid = s->grid;
+		find_nearest_point(s);
+		iterate(s, 1);
+	}
+
+	/* stop the relaxation threads */
+	if (s->ibriggs != NULL) {
+		pthread_mutex_lock(&s->thread_mutex);
+		s->thread_quit = TRUE;
+		pthread_cond_broadcast(&s->thread_start);
+		pthread_mutex_unlock(&s->thread_mutex);
+		for (int ithread = 1; ithread < s->nthreads; ithread++)
+			pthread_join(s->workers[ithread].thread, NULL);
+		pthread_cond_destroy(&s->thread_done);
+		pthread_cond_destroy(&s->thread_start);
+		pthread_mutex_destroy(&s->thread_mutex);
 	}
 
-	if (local_verbose)
-		check_errors();
+	if (s->local_verbose)
+		check_errors(s);
 
-	replace_planar_trend();
+	replace_planar_trend(s);
 
-	get_output(sgrid);
+	get_output(s, sgrid);
 
-	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&data, &local_error);
-	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&briggs, &local_error);
-	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&iu, &local_error);
-	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&u, &local_error);
-	if (set_low)
-		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&lower, &local_error);
-	if (set_high)
-		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&upper, &local_error);
+	s->status = mb_freed(verbose, __FILE__, __LINE__, (void **)&s->data, &s->local_error);
+	s->status = mb_freed(verbose, __FILE__, __LINE__, (void **)&s->briggs, &s->local_error);
+	s->status = mb_freed(verbose, __FILE__, __LINE__, (void **)&s->iu, &s->local_error);
+	s->status = mb_freed(verbose, __FILE__, __LINE__, (void **)&s->u, &s->local_error);
+	if (s->ibriggs != NULL)
+		s->status = mb_freed(verbose, __FILE__, __LINE__, (void **)&s->ibriggs, &s->local_error);
+	if (s->set_low)
+		s->status = mb_freed(verbose, __FILE__, __LINE__, (void **)&s->lower, &s->local_error);
+	if (s->set_high)
+		s->status = mb_freed(verbose, __FILE__, __LINE__, (void **)&s->upper, &s->local_error);
 
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
 		fprintf(stderr, "dbg2  Return values:\n");
-		fprintf(stderr, "dbg2       error:      %d\n", local_error);
-		for (int i = 0; i < m_columns * m_rows; i++)
+		fprintf(stderr, "dbg2       error:      %d\n", s->local_error);
+		for (int i = 0; i < s->m_columns * s->m_rows; i++)
 			fprintf(stderr, "dbg2       grid:       %d %f\n", i, sgrid[i]);
 		fprintf(stderr, "dbg2  Return status:\n");
-		fprintf(stderr, "dbg2       status:     %d\n", status);
+		fprintf(stderr, "dbg2       status:     %d\n", s->status);
 	}
 
-	return (status);
+	return (s->status);
 }
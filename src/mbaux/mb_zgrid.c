@@ -116,11 +116,24 @@
  * David W. Caress
  * 2 October 2012
  *
+ * Added functions mb_zgrid_threads() and mb_zgrid2_threads() which
+ * split the relaxation sweeps over large grids between threads. The
+ * nodes are relaxed in five colors, color = (i + 3j) mod 5, so that no
+ * two nodes of one color lie within two nodes of each other along a row
+ * or column, which is the reach of the laplace-spline stencil. The
+ * result then does not depend on the number of threads. Both orderings
+ * stop on the same convergence test, which leaves the solution short of
+ * full convergence, so the multithreaded result differs from the single
+ * threaded one by roughly the residual either has from the converged
+ * surface. mb_zgrid() and mb_zgrid2() are unchanged and single threaded.
+ * October 2026
+ *
  *--------------------------------------------------------------------*/
 
 /* TODO(schwehr): Remove gotos */
 
 #include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -135,15 +148,253 @@ const int ITERTRANSITION = 100;
 
 const int ZGRID_DIMENSION_MAX = 500;
 
+/* Minimum number of grid nodes for the relaxation to be multithreaded */
+#define MB_ZGRID_THREAD_MIN_NODES 4096
+
+/* Number of colors in the multithreaded relaxation */
+#define MB_ZGRID_NCOLOR 5
+
+struct mb_zgrid_sweep_struct;
+
+/* Relaxation worker thread */
+struct mb_zgrid_worker {
+	struct mb_zgrid_sweep_struct *sweep;
+	pthread_t thread;
+	int ithread;
+	int npg;
+	float dzmax;
+};
+
+/* State shared by the relaxation threads - the calling thread does the
+    share of worker 0 */
+struct mb_zgrid_sweep_struct {
+	float *z; /* grid with the fortran style offset already applied */
+	int z_dim1;
+	int nx;
+	int ny;
+	float cay;
+	float big;
+	float relax;
+	float *dzrms_column; /* sum of squared changes in each column */
+	int color;
+
+	int nthreads;
+	struct mb_zgrid_worker workers[MB_THREAD_MAX];
+	pthread_mutex_t thread_mutex;
+	pthread_cond_t thread_start;
+	pthread_cond_t thread_done;
+	int thread_generation;
+	int thread_busy;
+	bool thread_quit;
+};
+
+/*----------------------------------------------------------------------- */
+/* Applies point over-relaxation using the laplace-spline equation to
+    non-data grid point (i, j), returning false for data points and
+    points outside the region */
+static bool mb_zgrid_relax_node(float *z, int z_dim1, int nx, int ny, int i, int j, float cay, float big, float relax,
+                                float *dz) {
+	const float z00 = z[i + j * z_dim1];
+	if (z00 - big >= 0.0f || z00 < 0.0f)
+		return (false);
+
+	float wgt = 0.0f;
+	float zsum = 0.0f;
+
+	int im = 0;
+	float zim = 0.0f;
+	if (i - 1 > 0) {
+		zim = (float)fabs((double)z[i - 1 + j * z_dim1]);
+		if (zim - big < 0.0f) {
+			im = 1;
+			wgt += 1.0f;
+			zsum += zim;
+			if (i - 2 > 0) {
+				const float zimm = (float)fabs((double)z[i - 2 + j * z_dim1]);
+				if (zimm - big < 0.0f) {
+					wgt += cay;
+					zsum -= cay * (zimm - zim * 2.0f);
+				}
+			}
+		}
+	}
+	if (nx - i > 0) {
+		const float zip = (float)fabs((double)z[i + 1 + j * z_dim1]);
+		if (zip - big < 0.0f) {
+			wgt += 1.0f;
+			zsum += zip;
+			if (im > 0) {
+				wgt += cay * 4.0f;
+				zsum += cay * 2.0f * (zim + zip);
+			}
+			if (nx - 1 - i > 0) {
+				const float zipp = (float)fabs((double)z[i + 2 + j * z_dim1]);
+				if (zipp - big < 0.0f) {
+					wgt += cay;
+					zsum -= cay * (zipp - zip * 2.0f);
+				}
+			}
+		}
+	}
+
+	int jm = 0;
+	float zjm = 0.0f;
+	if (j - 1 > 0) {
+		zjm = (float)fabs((double)z[i + (j - 1) * z_dim1]);
+		if (zjm - big < 0.0f) {
+			jm = 1;
+			wgt += 1.0f;
+			zsum += zjm;
+			if (j - 2 > 0) {
+				const float zjmm = (float)fabs((double)z[i + (j - 2) * z_dim1]);
+				if (zjmm - big < 0.0f) {
+					wgt += cay;
+					zsum -= cay * (zjmm - zjm * 2.0f);
+				}
+			}
+		}
+	}
+	if (ny - j > 0) {
+		const float zjp = (float)fabs((double)z[i + (j + 1) * z_dim1]);
+		if (zjp - big < 0.0f) {
+			wgt += 1.0f;
+			zsum += zjp;
+			if (jm > 0) {
+				wgt += cay * 4.0f;
+				zsum += cay * 2.0f * (zjm + zjp);
+			}
+			if (ny - 1 - j > 0) {
+				const float zjpp = (float)fabs((double)z[i + (j + 2) * z_dim1]);
+				if (zjpp - big < 0.0f) {
+					wgt += cay;
+					zsum -= cay * (zjpp - zjp * 2.0f);
+				}
+			}
+		}
+	}
+
+	*dz = zsum / wgt - z00;
+	z[i + j * z_dim1] = z00 + *dz * relax;
+	return (true);
+}
+
+/*----------------------------------------------------------------------- */
+/* Relaxes the nodes of the current color in this worker's share of the
+    columns. Node (i, j) has color (i + 3j) mod 5, so nodes of one color are
+    at least three nodes apart along each row and column and may be relaxed
+    in any order. */
+static void mb_zgrid_sweep_color(struct mb_zgrid_sweep_struct *sweep, struct mb_zgrid_worker *worker) {
+	const int i_start = 1 + (sweep->nx * worker->ithread) / sweep->nthreads;
+	const int i_end = 1 + (sweep->nx * (worker->ithread + 1)) / sweep->nthreads;
+	int npg = worker->npg;
+	float dzmax = worker->dzmax;
+
+	for (int i = i_start; i < i_end; i++) {
+		/* first row of this color in this column: j = 2 * (color - i) mod 5 */
+		int j = (2 * (sweep->color - i % MB_ZGRID_NCOLOR) + 2 * MB_ZGRID_NCOLOR) % MB_ZGRID_NCOLOR;
+		if (j == 0)
+			j = MB_ZGRID_NCOLOR;
+		float dzrms = sweep->dzrms_column[i - 1];
+		for (; j <= sweep->ny; j += MB_ZGRID_NCOLOR) {
+			float dz;
+			if (mb_zgrid_relax_node(sweep->z, sweep->z_dim1, sweep->nx, sweep->ny, i, j, sweep->cay, sweep->big,
+			                        sweep->relax, &dz)) {
+				++npg;
+				dzrms += dz * dz;
+				dzmax = MAX((float)fabs((double)dz), dzmax);
+			}
+		}
+		sweep->dzrms_column[i - 1] = dzrms;
+	}
+
+	worker->npg = npg;
+	worker->dzmax = dzmax;
+}
+
+/*----------------------------------------------------------------------- */
+/* Worker threads relax their share of each color as the calling thread starts it */
+static void *mb_zgrid_worker_thread(void *arg) {
+	struct mb_zgrid_worker *worker = (struct mb_zgrid_worker *)arg;
+	struct mb_zgrid_sweep_struct *sweep = worker->sweep;
+	int generation = 0;
+
+	pthread_mutex_lock(&sweep->thread_mutex);
+	while (true) {
+		while (sweep->thread_generation == generation && !sweep->thread_quit)
+			pthread_cond_wait(&sweep->thread_start, &sweep->thread_mutex);
+		if (sweep->thread_quit)
+			break;
+		generation = sweep->thread_generation;
+		pthread_mutex_unlock(&sweep->thread_mutex);
+
+		mb_zgrid_sweep_color(sweep, worker);
+
+		pthread_mutex_lock(&sweep->thread_mutex);
+		sweep->thread_busy--;
+		if (sweep->thread_busy == 0)
+			pthread_cond_signal(&sweep->thread_done);
+	}
+	pthread_mutex_unlock(&sweep->thread_mutex);
+
+	return (NULL);
+}
+
+/*----------------------------------------------------------------------- */
+/* One multicolor relaxation sweep over all the non-data points. The
+    squared changes are summed by column and then in column order so that
+    the convergence test does not depend on the number of threads. */
+static void mb_zgrid_sweep_parallel(struct mb_zgrid_sweep_struct *sweep, float relax, int *npg, float *dzrms,
+                                    float *dzmax) {
+	sweep->relax = relax;
+	for (int i = 0; i < sweep->nx; i++)
+		sweep->dzrms_column[i] = 0.0f;
+	for (int ithread = 0; ithread < sweep->nthreads; ithread++) {
+		sweep->workers[ithread].npg = 0;
+		sweep->workers[ithread].dzmax = 0.0f;
+	}
+
+	for (int color = 0; color < MB_ZGRID_NCOLOR; color++) {
+		pthread_mutex_lock(&sweep->thread_mutex);
+		sweep->color = color;
+		sweep->thread_busy = sweep->nthreads - 1;
+		sweep->thread_generation++;
+		pthread_cond_broadcast(&sweep->thread_start);
+		pthread_mutex_unlock(&sweep->thread_mutex);
+
+		mb_zgrid_sweep_color(sweep, &sweep->workers[0]);
+
+		pthread_mutex_lock(&sweep->thread_mutex);
+		while (sweep->thread_busy > 0)
+			pthread_cond_wait(&sweep->thread_done, &sweep->thread_mutex);
+		pthread_mutex_unlock(&sweep->thread_mutex);
+	}
+
+	*npg = 0;
+	*dzrms = 0.0f;
+	*dzmax = 0.0f;
+	for (int ithread = 0; ithread < sweep->nthreads; ithread++) {
+		*npg += sweep->workers[ithread].npg;
+		*dzmax = MAX(sweep->workers[ithread].dzmax, *dzmax);
+	}
+	for (int i = 0; i < sweep->nx; i++)
+		*dzrms += sweep->dzrms_column[i];
+}
+
 /*----------------------------------------------------------------------- */
 int mb_zgrid2(float *z, int *nx, int *ny, float *x1, float *y1, float *dx, float *dy, float *xyz, int *n, float *zpij, int *knxt,
               bool *imnew, float *cay, int *nrng) {
+	return (mb_zgrid2_threads(z, nx, ny, x1, y1, dx, dy, xyz, n, zpij, knxt, imnew, cay, nrng, 1));
+}
+
+/*----------------------------------------------------------------------- */
+int mb_zgrid2_threads(float *z, int *nx, int *ny, float *x1, float *y1, float *dx, float *dy, float *xyz, int *n, float *zpij,
+                      int *knxt, bool *imnew, float *cay, int *nrng, int nthreads) {
 	int status = MB_SUCCESS;
 
 	/* if nx and ny < ZGRID_DIMENSION_MAX just call zgrid() */
 	if (*nx < ZGRID_DIMENSION_MAX && *ny < ZGRID_DIMENSION_MAX) {
 		fprintf(stderr, "Zgrid2 calling zgrid with unchanged grid dimensions %d %d\n", *nx, *ny);
-		mb_zgrid(z, nx, ny, x1, y1, dx, dy, xyz, n, zpij, knxt, imnew, cay, nrng);
+		mb_zgrid_threads(z, nx, ny, x1, y1, dx, dy, xyz, n, zpij, knxt, imnew, cay, nrng, nthreads);
 	}
 
 	/* else set up to call zgrid() to generate a smaller grid and then
@@ -171,7 +422,7 @@ int mb_zgrid2(float *z, int *nx, int *ny, float *x1, float *y1, float *dx, float
 		/* call zgrid() */
 		fprintf(stderr, "Smooth surface being calculated for grid with dimensions reduced from %d %d to %d %d\n", *nx, *ny, snx,
 		        sny);
-		mb_zgrid(sz, &snx, &sny, x1, y1, &sdx, &sdy, xyz, n, zpij, knxt, imnew, cay, &snrng);
+		mb_zgrid_threads(sz, &snx, &sny, x1, y1, &sdx, &sdy, xyz, n, zpij, knxt, imnew, cay, &snrng, nthreads);
 
 		/* now fill in the full resolution grid by bilinear interpolation */
 		fprintf(stderr, "Smooth surface mapped onto full resolution grid using bilinear interpolation\n");
@@ -222,6 +473,12 @@ int mb_zgrid2(float *z, int *nx, int *ny, float *x1, float *y1, float *dx, float
 /*----------------------------------------------------------------------- */
 int mb_zgrid(float *z, int *nx, int *ny, float *x1, float *y1, float *dx, float *dy, float *xyz, int *n, float *zpij, int *knxt,
              bool *imnew, float *cay, int *nrng) {
+	return (mb_zgrid_threads(z, nx, ny, x1, y1, dx, dy, xyz, n, zpij, knxt, imnew, cay, nrng, 1));
+}
+
+/*----------------------------------------------------------------------- */
+int mb_zgrid_threads(float *z, int *nx, int *ny, float *x1, float *y1, float *dx, float *dy, float *xyz, int *n, float *zpij,
+                     int *knxt, bool *imnew, float *cay, int *nrng, int nthreads) {
 	/* Parameter adjustments */
 	int z_dim1 = *nx;
 	int z_offset = z_dim1 + 1;
@@ -271,12 +528,11 @@ int mb_zgrid(float *z, int *nx, int *ny, float *x1, float *y1, float *dx, float
 	float r__1;
 	float delz;
 	int nnew;
-	float zijn, zimm, zjmm, zipp, zjpp;
+	float zijn;
 	float root, zsum, zpxy, a, b, c, d;
 	int j;
 	float x, y, delzm;
 	float dzmax, dzrms;
-	int im, jm;
 	float dzrms8 = 0.0f;  // TODO(schwehr): -Wmaybe-uninitialized
 	float z00;
 	float dz;
@@ -284,9 +540,8 @@ int mb_zgrid(float *z, int *nx, int *ny, float *x1, float *y1, float *dx, float
 	float zn, zs, zw;
 	float dzmaxf, convtest, relaxn, rootgs, dzrmsp, abz;
 	int npg;
-	float zim, zjm;
 	int npt;
-	float wgt, zip, zjp, tpy, zxy;
+	float tpy, zxy;
 	int ii, jj, kkk;
 
 	// set pointer array knxt
@@ -459,6 +714,40 @@ L200:
 	/*     using the laplace-spline equation  (carres method is used) */
 	/* **********************************************************************
 	 */
+	/* start the relaxation threads for large grids */
+	struct mb_zgrid_sweep_struct sweep;
+	memset(&sweep, 0, sizeof(sweep));
+	sweep.z = z;
+	sweep.z_dim1 = z_dim1;
+	sweep.nx = *nx;
+	sweep.ny = *ny;
+	sweep.cay = *cay;
+	sweep.big = big;
+	sweep.nthreads = MAX(1, MIN(nthreads, MB_THREAD_MAX));
+	if (sweep.nthreads > 1 && (*nx < sweep.nthreads || *nx * *ny < MB_ZGRID_THREAD_MIN_NODES))
+		sweep.nthreads = 1;
+	if (sweep.nthreads > 1) {
+		sweep.dzrms_column = (float *)calloc(*nx, sizeof(float));
+		if (sweep.dzrms_column == NULL)
+			sweep.nthreads = 1;
+	}
+	if (sweep.nthreads > 1) {
+		pthread_mutex_init(&sweep.thread_mutex, NULL);
+		pthread_cond_init(&sweep.thread_start, NULL);
+		pthread_cond_init(&sweep.thread_done, NULL);
+		for (int ithread = 0; ithread < sweep.nthreads; ithread++) {
+			sweep.workers[ithread].sweep = &sweep;
+			sweep.workers[ithread].ithread = ithread;
+		}
+		for (int ithread = 1; ithread < sweep.nthreads; ithread++) {
+			if (pthread_create(&sweep.workers[ithread].thread, NULL, mb_zgrid_worker_thread, &sweep.workers[ithread]) != 0) {
+				sweep.nthreads = ithread;
+				break;
+			}
+		}
+	}
+	const int nthreads_started = sweep.nthreads;
+
 	fprintf(stderr, "Zgrid starting iterations\n");
 	dzrmsp = zrange;
 	float relax = 1.0f;
@@ -466,200 +755,20 @@ L200:
 		dzrms = 0.0f;
 		dzmax = 0.0f;
 		npg = 0;
-		i__2 = *nx;
-		for (int i = 1; i <= i__2; ++i) {
-			i__1 = *ny;
-			for (j = 1; j <= i__1; ++j) {
-				z00 = z[i + j * z_dim1];
-				if (z00 - big >= 0.0f) {
-					goto L2000;
-				}
-				else {
-					goto L205;
-				}
-			L205:
-				if (z00 >= 0.0f) {
-					goto L208;
-				}
-				else {
-					goto L2000;
-				}
-			L208:
-				wgt = 0.0f;
-				zsum = 0.0f;
-
-				im = 0;
-				if (i - 1 <= 0) {
-					goto L570;
-				}
-				else {
-					goto L510;
-				}
-			L510:
-				zim = (r__1 = z[i - 1 + j * z_dim1], (float)fabs((double)r__1));
-				if (zim - big >= 0.0f) {
-					goto L570;
-				}
-				else {
-					goto L530;
-				}
-			L530:
-				im = 1;
-				wgt += 1.0f;
-				zsum += zim;
-				if (i - 2 <= 0) {
-					goto L570;
-				}
-				else {
-					goto L540;
-				}
-			L540:
-				zimm = (r__1 = z[i - 2 + j * z_dim1], (float)fabs((double)r__1));
-				if (zimm - big >= 0.0f) {
-					goto L570;
-				}
-				else {
-					goto L560;
-				}
-			L560:
-				wgt += *cay;
-				zsum -= *cay * (zimm - zim * 2.0f);
-			L570:
-				if (*nx - i <= 0) {
-					goto L700;
-				}
-				else {
-					goto L580;
-				}
-			L580:
-				zip = (r__1 = z[i + 1 + j * z_dim1], (float)fabs((double)r__1));
-				if (zip - big >= 0.0f) {
-					goto L700;
-				}
-				else {
-					goto L600;
-				}
-			L600:
-				wgt += 1.0f;
-				zsum += zip;
-				if (im <= 0) {
-					goto L620;
-				}
-				else {
-					goto L610;
-				}
-			L610:
-				wgt += *cay * 4.0f;
-				zsum += *cay * 2.0f * (zim + zip);
-			L620:
-				if (*nx - 1 - i <= 0) {
-					goto L700;
-				}
-				else {
-					goto L630;
-				}
-			L630:
-				zipp = (r__1 = z[i + 2 + j * z_dim1], (float)fabs((double)r__1));
-				if (zipp - big >= 0.0f) {
-					goto L700;
-				}
-				else {
-					goto L650;
-				}
-			L650:
-				wgt += *cay;
-				zsum -= *cay * (zipp - zip * 2.0f);
-			L700:
-
-				jm = 0;
-				if (j - 1 <= 0) {
-					goto L1570;
-				}
-				else {
-					goto L1510;
-				}
-			L1510:
-				zjm = (r__1 = z[i + (j - 1) * z_dim1], (float)fabs((double)r__1));
-				if (zjm - big >= 0.0f) {
-					goto L1570;
-				}
-				else {
-					goto L1530;
-				}
-			L1530:
-				jm = 1;
-				wgt += 1.0f;
-				zsum += zjm;
-				if (j - 2 <= 0) {
-					goto L1570;
-				}
-				else {
-					goto L1540;
-				}
-			L1540:
-				zjmm = (r__1 = z[i + (j - 2) * z_dim1], (float)fabs((double)r__1));
-				if (zjmm - big >= 0.0f) {
-					goto L1570;
-				}
-				else {
-					goto L1560;
-				}
-			L1560:
-				wgt += *cay;
-				zsum -= *cay * (zjmm - zjm * 2.0f);
-			L1570:
-				if (*ny - j <= 0) {
-					goto L1700;
-				}
-				else {
-					goto L1580;
-				}
-			L1580:
-				zjp = (r__1 = z[i + (j + 1) * z_dim1], (float)fabs((double)r__1));
-				if (zjp - big >= 0.0f) {
-					goto L1700;
-				}
-				else {
-					goto L1600;
-				}
-			L1600:
-				wgt += 1.0f;
-				zsum += zjp;
-				if (jm <= 0) {
-					goto L1620;
-				}
-				else {
-					goto L1610;
-				}
-			L1610:
-				wgt += *cay * 4.0f;
-				zsum += *cay * 2.0f * (zjm + zjp);
-			L1620:
-				if (*ny - 1 - j <= 0) {
-					goto L1700;
-				}
-				else {
-					goto L1630;
-				}
-			L1630:
-				zjpp = (r__1 = z[i + (j + 2) * z_dim1], (float)fabs((double)r__1));
-				if (zjpp - big >= 0.0f) {
-					goto L1700;
-				}
-				else {
-					goto L1650;
+		if (sweep.nthreads > 1) {
+			mb_zgrid_sweep_parallel(&sweep, relax, &npg, &dzrms, &dzmax);
+		}
+		else {
+			i__2 = *nx;
+			for (int i = 1; i <= i__2; ++i) {
+				i__1 = *ny;
+				for (j = 1; j <= i__1; ++j) {
+					if (mb_zgrid_relax_node(z, z_dim1, *nx, *ny, i, j, *cay, big, relax, &dz)) {
+						++npg;
+						dzrms += dz * dz;
+						dzmax = MAX((float)fabs((double)dz), dzmax);
+					}
 				}
-			L1650:
-				wgt += *cay;
-				zsum -= *cay * (zjpp - zjp * 2.0f);
-			L1700:
-
-				dz = zsum / wgt - z00;
-				++npg;
-				dzrms += dz * dz;
-				dzmax = MAX((float)fabs((double)dz), dzmax);
-				z[i + j * z_dim1] = z00 + dz * relax;
-			L2000:;
 			}
 		}
 
@@ -956,6 +1065,20 @@ L200:
 	}
 L4010:
 
+	/* stop the relaxation threads */
+	if (nthreads_started > 1) {
+		pthread_mutex_lock(&sweep.thread_mutex);
+		sweep.thread_quit = true;
+		pthread_cond_broadcast(&sweep.thread_start);
+		pthread_mutex_unlock(&sweep.thread_mutex);
+		for (int ithread = 1; ithread < nthreads_started; ithread++)
+			pthread_join(sweep.workers[ithread].thread, NULL);
+		pthread_cond_destroy(&sweep.thread_done);
+		pthread_cond_destroy(&sweep.thread_start);
+		pthread_mutex_destroy(&sweep.thread_mutex);
+	}
+	free(sweep.dzrms_column);
+
 	/*     remove zbase from array z and return. */
 	/* ***********************************************************************/
 
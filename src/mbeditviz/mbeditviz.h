@@ -137,6 +137,8 @@ struct mbev_ping_struct {
 	double *ttimes;
 	double *bheave;
 	double *alongtrack_offset;
+	bool bathxy_bounds_valid; /* bounds of bathx and bathy over the usable beams */
+	double bathxy_bounds[4];
 };
 struct mbev_file_struct {
 	int load_status;
@@ -221,6 +223,12 @@ struct mbev_grid_struct {
   	float *val;
 
 	float *sgm;
+
+        /// Cells changed by edits awaiting recalculation, 2 if they must be regridded
+	char *dirty;
+
+        /// Bounds (minimum column, maximum column, minimum row, maximum row) of the cells awaiting recalculation
+	int dirty_bounds[4];
 };
 
 /*--------------------------------------------------------------------*/
@@ -365,6 +373,8 @@ int mbeditviz_make_grid(void);
 int mbeditviz_grid_beam(struct mbev_file_struct *file, struct mbev_ping_struct *ping, int ibeam,
                         bool beam_ok, bool apply_now);
 
+/** Recalculate and display the grid cells changed by edits since the last flush */
+int mbeditviz_grid_flush(void);
 int mbeditviz_make_grid_simple(void);
 int mbeditviz_destroy_grid(void);
 int mbeditviz_selectregion(size_t instance);
@@ -34,6 +34,7 @@
 
 #include <ctype.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -157,6 +158,7 @@ int mbeditviz_init(int argc, char **argv,
   mbev_grid.wgt = NULL;
   mbev_grid.val = NULL;
   mbev_grid.sgm = NULL;
+  mbev_grid.dirty = NULL;
   for (int i = 0; i < 4; i++) {
     mbev_grid_bounds[i] = 0.0;
     mbev_grid_boundsutm[i] = 0.0;
@@ -776,6 +778,7 @@ int mbeditviz_load_file(int ifile, bool assertLock) {
 
         /* allocate memory for pings */
         if (mbev_error == MB_ERROR_NO_ERROR && kind == MB_DATA_DATA) {
+          ping->bathxy_bounds_valid = false;
           if ((ping->beamflag = (char *)malloc(ping->beams_bath)) == NULL)
             mbev_error = MB_ERROR_MEMORY_FAIL;
           if ((ping->beamflagorg = (char *)malloc(ping->beams_bath)) == NULL)
@@ -2406,6 +2409,14 @@ int mbeditviz_get_grid_bounds() {
   return (mbev_status);
 }
 
+/*--------------------------------------------------------------------*/
+static void mbeditviz_grid_dirty_reset() {
+  mbev_grid.dirty_bounds[0] = mbev_grid.n_columns;
+  mbev_grid.dirty_bounds[1] = -1;
+  mbev_grid.dirty_bounds[2] = mbev_grid.n_rows;
+  mbev_grid.dirty_bounds[3] = -1;
+}
+
 /*--------------------------------------------------------------------*/
 int mbeditviz_setup_grid() {
   if (mbev_verbose >= 2) {
@@ -2511,11 +2522,15 @@ int mbeditviz_setup_grid() {
       mbev_error = MB_ERROR_MEMORY_FAIL;
     if ((mbev_grid.sgm = (float *)malloc(mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float))) == NULL)
       mbev_error = MB_ERROR_MEMORY_FAIL;
+    if ((mbev_grid.dirty = (char *)malloc(mbev_grid.n_columns * mbev_grid.n_rows * sizeof(char))) == NULL)
+      mbev_error = MB_ERROR_MEMORY_FAIL;
     if (mbev_error == MB_ERROR_NO_ERROR) {
       memset(mbev_grid.sum, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
       memset(mbev_grid.wgt, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
       memset(mbev_grid.val, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
       memset(mbev_grid.sgm, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
+      memset(mbev_grid.dirty, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(char));
+      mbeditviz_grid_dirty_reset();
     }
     else
       mbev_status = MB_FAILURE;
@@ -2533,125 +2548,218 @@ int mbeditviz_setup_grid() {
 }
 
 /*--------------------------------------------------------------------*/
-int mbeditviz_project_soundings() {
-  if (mbev_verbose >= 2) {
-    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
-    fprintf(stderr, "dbg2  Input arguments:\n");
-  }
+/*
+ * Projection and gridding of the loaded soundings are done in parallel,
+ * each thread claiming whole files in turn. Each thread projects with its
+ * own copy of the projection, and grids into its own partial grid arrays,
+ * which are merged into mbev_grid once all of the threads are done.
+ * Thread 0 uses the projection and arrays of mbev_grid directly.
+ */
+struct mbev_thread_work_struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  int next_file;
+  int num_done;
+  int num_running;
+};
+struct mbev_thread_struct {
+  struct mbev_thread_work_struct *work;
+  void *ctxptr;
+  void *pjptr;
+  float *sum;
+  float *wgt;
+  float *sgm;
+  int error;
+};
 
-  /* project all soundings into the grid coordinates */
-  if (mbev_status == MB_SUCCESS) {
-    /* loop over loaded files */
-    int filecount = 0;
-    for (int ifile = 0; ifile < mbev_num_files; ifile++) {
-      struct mbev_file_struct *file = &mbev_files[ifile];
-      if (file->load_status) {
-        filecount++;
-        snprintf(message, sizeof(message), "Projecting file %d of %d...", filecount, mbev_num_files_loaded);
-        (*showMessage)(message);
-        for (int iping = 0; iping < file->num_pings; iping++) {
-          struct mbev_ping_struct *ping = &(file->pings[iping]);
-          mb_proj_forward(mbev_verbose, mbev_grid.pjptr, ping->navlon, ping->navlat, &ping->navlonx, &ping->navlaty,
-                          &mbev_error);
-          for (int ibeam = 0; ibeam < ping->beams_bath; ibeam++) {
-            if (!mb_beam_check_flag_unusable(ping->beamflag[ibeam])) {
-              mb_proj_forward(mbev_verbose, mbev_grid.pjptr, ping->bathlon[ibeam], ping->bathlat[ibeam],
-                              &ping->bathx[ibeam], &ping->bathy[ibeam], &mbev_error);
-            }
-          }
-        }
-      }
+/*--------------------------------------------------------------------*/
+static int mbeditviz_num_threads() {
+  const long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+  const int nthreads = ncpu > 0 ? (int)MIN(ncpu, MB_THREAD_MAX) : 1;
+  return (MAX(1, MIN(nthreads, mbev_num_files_loaded)));
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbeditviz_claim_file returns the next loaded file to be
+ * processed by a thread, or -1 once all files have been claimed
+ */
+static int mbeditviz_claim_file(struct mbev_thread_work_struct *work, bool done) {
+  pthread_mutex_lock(&work->mutex);
+  if (done) {
+    work->num_done++;
+    pthread_cond_broadcast(&work->cond);
+  }
+  int ifile = -1;
+  while (ifile < 0 && work->next_file < mbev_num_files) {
+    if (mbev_files[work->next_file].load_status)
+      ifile = work->next_file;
+    work->next_file++;
+  }
+  pthread_mutex_unlock(&work->mutex);
+  return (ifile);
+}
+
+/*--------------------------------------------------------------------*/
+static void mbeditviz_thread_finish(struct mbev_thread_work_struct *work) {
+  pthread_mutex_lock(&work->mutex);
+  work->num_running--;
+  pthread_cond_broadcast(&work->cond);
+  pthread_mutex_unlock(&work->mutex);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbeditviz_run_threads runs worker on nthreads threads and
+ * reports progress from the calling (user interface) thread until
+ * all of the loaded files have been processed - the calling thread
+ * blocks while waiting, so only the progress messages are shown and no
+ * other user interface events are handled until the work is done
+ */
+static void mbeditviz_run_threads(void *(*worker)(void *), struct mbev_thread_struct *threads, int nthreads,
+                                  const char *label) {
+  struct mbev_thread_work_struct work;
+  pthread_mutex_init(&work.mutex, NULL);
+  pthread_cond_init(&work.cond, NULL);
+  work.next_file = 0;
+  work.num_done = 0;
+  work.num_running = 0;
+
+  /* start the threads, doing the work here if no thread can be started */
+  pthread_t thread_ids[MB_THREAD_MAX];
+  bool started[MB_THREAD_MAX];
+  for (int ithread = 0; ithread < nthreads; ithread++) {
+    threads[ithread].work = &work;
+    pthread_mutex_lock(&work.mutex);
+    work.num_running++;
+    pthread_mutex_unlock(&work.mutex);
+    started[ithread] = pthread_create(&thread_ids[ithread], NULL, worker, &threads[ithread]) == 0;
+    if (!started[ithread]) {
+      pthread_mutex_lock(&work.mutex);
+      work.num_running--;
+      pthread_mutex_unlock(&work.mutex);
     }
   }
-
-  if (mbev_verbose >= 2) {
-    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
-    fprintf(stderr, "dbg2  Return values:\n");
-    fprintf(stderr, "dbg2       error:      %d\n", mbev_error);
-    fprintf(stderr, "dbg2  Return status:\n");
-    fprintf(stderr, "dbg2       mbev_status: %d\n", mbev_status);
+  if (!started[0]) {
+    pthread_mutex_lock(&work.mutex);
+    work.num_running++;
+    pthread_mutex_unlock(&work.mutex);
+    (*worker)(&threads[0]);
+  }
+
+  /* report progress as files are finished */
+  int num_shown = -1;
+  pthread_mutex_lock(&work.mutex);
+  while (work.num_running > 0) {
+    if (work.num_done != num_shown) {
+      num_shown = work.num_done;
+      pthread_mutex_unlock(&work.mutex);
+      snprintf(message, sizeof(message), "%s file %d of %d...", label, MIN(num_shown + 1, mbev_num_files_loaded),
+               mbev_num_files_loaded);
+      (*showMessage)(message);
+      pthread_mutex_lock(&work.mutex);
+    }
+    else {
+      pthread_cond_wait(&work.cond, &work.mutex);
+    }
   }
+  pthread_mutex_unlock(&work.mutex);
 
-  return (mbev_status);
+  for (int ithread = 0; ithread < nthreads; ithread++)
+    if (started[ithread])
+      pthread_join(thread_ids[ithread], NULL);
+  pthread_cond_destroy(&work.cond);
+  pthread_mutex_destroy(&work.mutex);
 }
 
 /*--------------------------------------------------------------------*/
-int mbeditviz_make_grid() {
-  if (mbev_verbose >= 2) {
-    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
-    fprintf(stderr, "dbg2  Input arguments:\n");
+/*
+ * function mbeditviz_ping_bathxy_bounds finds the bounds of the projected
+ * positions of the usable soundings of a ping, so that regridding can skip
+ * pings that cannot contribute to the cells being recalculated.
+ */
+static void mbeditviz_ping_bathxy_bounds(struct mbev_ping_struct *ping) {
+  bool first = true;
+  for (int ibeam = 0; ibeam < ping->beams_bath; ibeam++) {
+    if (!mb_beam_check_flag_unusable(ping->beamflag[ibeam])) {
+      if (first) {
+        ping->bathxy_bounds[0] = ping->bathx[ibeam];
+        ping->bathxy_bounds[1] = ping->bathx[ibeam];
+        ping->bathxy_bounds[2] = ping->bathy[ibeam];
+        ping->bathxy_bounds[3] = ping->bathy[ibeam];
+        first = false;
+      }
+      else {
+        ping->bathxy_bounds[0] = MIN(ping->bathxy_bounds[0], ping->bathx[ibeam]);
+        ping->bathxy_bounds[1] = MAX(ping->bathxy_bounds[1], ping->bathx[ibeam]);
+        ping->bathxy_bounds[2] = MIN(ping->bathxy_bounds[2], ping->bathy[ibeam]);
+        ping->bathxy_bounds[3] = MAX(ping->bathxy_bounds[3], ping->bathy[ibeam]);
+      }
+    }
   }
 
-  fprintf(stderr, "\nGenerating Grid:\n----------------\n");
-  fprintf(stderr, "Grid bounds (longitude latitude): %.7f %.7f %.7f %.7f\n",
-          mbev_grid_bounds[0], mbev_grid_bounds[1],
-          mbev_grid_bounds[2], mbev_grid_bounds[3]);
-  fprintf(stderr, "Grid bounds (eastings northings): %.3f %.3f %.3f %.3f\n",
-          mbev_grid_boundsutm[0], mbev_grid_boundsutm[1],
-          mbev_grid_boundsutm[2], mbev_grid_boundsutm[3]);
-  fprintf(stderr, "Cell size:%.3f\nGrid Dimensions: %d %d\n",
-          mbev_grid_cellsize, mbev_grid_n_columns, mbev_grid_n_rows);
-  if (mbev_grid_algorithm == MBEV_GRID_ALGORITHM_SIMPLEMEAN)
-    fprintf(stderr, "Algorithm: Simple Mean\n");
-  else if (mbev_grid_algorithm == MBEV_GRID_ALGORITHM_FOOTPRINT)
-    fprintf(stderr, "Algorithm: Footprint\n");
-  else //if (mbev_grid_algorithm == MBEV_GRID_ALGORITHM_SHOALBIAS)
-    fprintf(stderr, "Algorithm: Shoal Bias\n");
-  fprintf(stderr, "Interpolation: %d\n\n", mbev_grid_interpolation);
+  /* a ping without usable soundings never overlaps anything */
+  if (first) {
+    ping->bathxy_bounds[0] = 1.0;
+    ping->bathxy_bounds[1] = 0.0;
+    ping->bathxy_bounds[2] = 1.0;
+    ping->bathxy_bounds[3] = 0.0;
+  }
+  ping->bathxy_bounds_valid = true;
+}
 
-  /* zero the grid arrays */
-  memset(mbev_grid.sum, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
-  memset(mbev_grid.wgt, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
-  /* memset(mbev_grid.val, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));*/
-  memset(mbev_grid.sgm, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
+/*--------------------------------------------------------------------*/
+static void *mbeditviz_project_thread(void *arg) {
+  struct mbev_thread_struct *thread = (struct mbev_thread_struct *)arg;
 
-  /* loop over loaded files */
-  int filecount = 0;
-  for (int ifile = 0; ifile < mbev_num_files; ifile++) {
+  for (int ifile = mbeditviz_claim_file(thread->work, false); ifile >= 0;
+       ifile = mbeditviz_claim_file(thread->work, true)) {
     struct mbev_file_struct *file = &mbev_files[ifile];
-    if (file->load_status) {
-      filecount++;
-      snprintf(message, sizeof(message), "Gridding file %d of %d...", filecount, mbev_num_files_loaded);
-      (*showMessage)(message);
-      for (int iping = 0; iping < file->num_pings; iping++) {
-        struct mbev_ping_struct *ping = &(file->pings[iping]);
-        for (int ibeam = 0; ibeam < ping->beams_bath; ibeam++) {
-          if (mb_beam_ok(ping->beamflag[ibeam])) {
-            mbeditviz_grid_beam(file, ping, ibeam, true, false);
-          }
+    for (int iping = 0; iping < file->num_pings; iping++) {
+      struct mbev_ping_struct *ping = &(file->pings[iping]);
+      mb_proj_forward(mbev_verbose, thread->pjptr, ping->navlon, ping->navlat, &ping->navlonx, &ping->navlaty,
+                      &thread->error);
+      for (int ibeam = 0; ibeam < ping->beams_bath; ibeam++) {
+        if (!mb_beam_check_flag_unusable(ping->beamflag[ibeam])) {
+          mb_proj_forward(mbev_verbose, thread->pjptr, ping->bathlon[ibeam], ping->bathlat[ibeam],
+                          &ping->bathx[ibeam], &ping->bathy[ibeam], &thread->error);
         }
       }
+      mbeditviz_ping_bathxy_bounds(ping);
     }
   }
-  mbev_grid.nodatavalue = MBEV_NODATA;
-  bool first = true;
-  for (int i = 0; i < mbev_grid.n_columns; i++)
-    for (int j = 0; j < mbev_grid.n_rows; j++) {
-      const int k = i * mbev_grid.n_rows + j;
-      if (mbev_grid.wgt[k] > 0.0) {
-        mbev_grid.val[k] = mbev_grid.sum[k] / mbev_grid.wgt[k];
-        mbev_grid.sgm[k] = sqrt(fabs(mbev_grid.sgm[k] / mbev_grid.wgt[k] - mbev_grid.val[k] * mbev_grid.val[k]));
-        if (first) {
-          mbev_grid.min = mbev_grid.val[k];
-          mbev_grid.max = mbev_grid.val[k];
-          mbev_grid.smin = mbev_grid.sgm[k];
-          mbev_grid.smax = mbev_grid.sgm[k];
-          first = false;
-        }
-        else {
-          mbev_grid.min = MIN(mbev_grid.min, mbev_grid.val[k]);
-          mbev_grid.max = MAX(mbev_grid.max, mbev_grid.val[k]);
-          mbev_grid.smin = MIN(mbev_grid.smin, mbev_grid.sgm[k]);
-          mbev_grid.smax = MAX(mbev_grid.smax, mbev_grid.sgm[k]);
-        }
-      }
-      else {
-        mbev_grid.val[k] = mbev_grid.nodatavalue;
-        mbev_grid.sgm[k] = mbev_grid.nodatavalue;
+
+  mbeditviz_thread_finish(thread->work);
+  return (NULL);
+}
+
+/*--------------------------------------------------------------------*/
+int mbeditviz_project_soundings() {
+  if (mbev_verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+  }
+
+  /* project all soundings into the grid coordinates */
+  if (mbev_status == MB_SUCCESS) {
+    /* get a copy of the projection for each thread after the first */
+    struct mbev_thread_struct threads[MB_THREAD_MAX];
+    memset(threads, 0, sizeof(threads));
+    int nthreads = mbeditviz_num_threads();
+    threads[0].pjptr = mbev_grid.pjptr;
+    for (int ithread = 1; ithread < nthreads; ithread++) {
+      if (mb_proj_clone(mbev_verbose, mbev_grid.pjptr, &threads[ithread].ctxptr, &threads[ithread].pjptr,
+                        &threads[ithread].error) != MB_SUCCESS) {
+        nthreads = ithread;
       }
     }
-  if (mbev_grid.status == MBEV_GRID_NONE)
-    mbev_grid.status = MBEV_GRID_NOTVIEWED;
+
+    /* loop over loaded files */
+    mbeditviz_run_threads(mbeditviz_project_thread, threads, nthreads, "Projecting");
+
+    for (int ithread = 1; ithread < nthreads; ithread++)
+      mb_proj_clone_free(mbev_verbose, &threads[ithread].ctxptr, &threads[ithread].pjptr, &threads[ithread].error);
+  }
 
   if (mbev_verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
@@ -2665,20 +2773,34 @@ int mbeditviz_make_grid() {
 }
 
 /*--------------------------------------------------------------------*/
-int mbeditviz_grid_beam(struct mbev_file_struct *file, struct mbev_ping_struct *ping, int ibeam,
-                        bool beam_ok,
-                        bool apply_now
-                        ) {
-  if (mbev_verbose >= 2) {
-    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
-    fprintf(stderr, "dbg2  Input arguments:\n");
-    fprintf(stderr, "dbg2       file:       %p\n", file);
-    fprintf(stderr, "dbg2       ping:       %p\n", ping);
-    fprintf(stderr, "dbg2       ibeam:      %d\n", ibeam);
-    fprintf(stderr, "dbg2       beam_ok:    %d\n", beam_ok);
-    fprintf(stderr, "dbg2       apply_now:  %d\n", apply_now);
-  }
+/*
+ * function mbeditviz_grid_dirty marks a grid cell to be recalculated by
+ * the next call to mbeditviz_grid_flush(), regridding it from the
+ * soundings if regrid is true
+ */
+static void mbeditviz_grid_dirty(int i, int j, bool regrid) {
+  if (mbev_grid.dirty == NULL)
+    return;
+  const int kk = i * mbev_grid.n_rows + j;
+  if (regrid)
+    mbev_grid.dirty[kk] = 2;
+  else if (mbev_grid.dirty[kk] == 0)
+    mbev_grid.dirty[kk] = 1;
+  mbev_grid.dirty_bounds[0] = MIN(mbev_grid.dirty_bounds[0], i);
+  mbev_grid.dirty_bounds[1] = MAX(mbev_grid.dirty_bounds[1], i);
+  mbev_grid.dirty_bounds[2] = MIN(mbev_grid.dirty_bounds[2], j);
+  mbev_grid.dirty_bounds[3] = MAX(mbev_grid.dirty_bounds[3], j);
+}
 
+/*--------------------------------------------------------------------*/
+/*
+ * function mbeditviz_grid_beam_accumulate adds (or removes if beam_ok is
+ * false) the contribution of a sounding to the sum, weight and sigma arrays
+ * of either mbev_grid or a partial grid. If mark_dirty is true the cells
+ * changed are marked for recalculation by mbeditviz_grid_flush().
+ */
+static void mbeditviz_grid_beam_accumulate(struct mbev_file_struct *file, struct mbev_ping_struct *ping, int ibeam,
+                                           bool beam_ok, float *sum, float *wgt, float *sgm, bool mark_dirty) {
   /* find location of beam center */
   const int i = (ping->bathx[ibeam] - mbev_grid.boundsutm[0] + 0.5 * mbev_grid.dx) / mbev_grid.dx;
   const int j = (ping->bathy[ibeam] - mbev_grid.boundsutm[2] + 0.5 * mbev_grid.dy) / mbev_grid.dy;
@@ -2707,31 +2829,18 @@ int mbeditviz_grid_beam(struct mbev_file_struct *file, struct mbev_ping_struct *
                 ping->bathalongtrack[ibeam]);
       }
 
-      /* add to weights and sums */
-      if (beam_ok && (-ping->bathcorr[ibeam]) >  mbev_grid.sum[kk]) {
-        mbev_grid.wgt[kk] = 1.0;
-        mbev_grid.sum[kk] = (-ping->bathcorr[ibeam]);
-        mbev_grid.sgm[kk] = ping->bathcorr[ibeam] * ping->bathcorr[ibeam];
+      /* keep the shoalest sounding - removing the shoalest sounding
+          requires the cell to be regridded from the remaining soundings */
+      if (beam_ok && (wgt[kk] <= 0.0 || (-ping->bathcorr[ibeam]) > sum[kk])) {
+        wgt[kk] = 1.0;
+        sum[kk] = (-ping->bathcorr[ibeam]);
+        sgm[kk] = ping->bathcorr[ibeam] * ping->bathcorr[ibeam];
+        if (mark_dirty)
+          mbeditviz_grid_dirty(i, j, false);
       }
-
-      /* recalculate grid cell if desired */
-      if (apply_now) {
-        /* recalculate grid cell */
-        if (mbev_grid.wgt[kk] > 0.0) {
-          mbev_grid.val[kk] = mbev_grid.sum[kk] / mbev_grid.wgt[kk];
-          mbev_grid.sgm[kk] = sqrt(fabs(mbev_grid.sgm[kk] / mbev_grid.wgt[kk] - mbev_grid.val[kk] * mbev_grid.val[kk]));
-          mbev_grid.min = MIN(mbev_grid.min, mbev_grid.val[kk]);
-          mbev_grid.max = MAX(mbev_grid.max, mbev_grid.val[kk]);
-          mbev_grid.smin = MIN(mbev_grid.smin, mbev_grid.sgm[kk]);
-          mbev_grid.smax = MAX(mbev_grid.smax, mbev_grid.sgm[kk]);
-        }
-        else {
-          mbev_grid.val[kk] = mbev_grid.nodatavalue;
-          mbev_grid.sgm[kk] = mbev_grid.nodatavalue;
-        }
-
-        /* update grid in mbview display */
-        mbview_updateprimarygridcell(mbev_verbose, 0, i, j, mbev_grid.val[kk], &mbev_error);
+      else if (!beam_ok && wgt[kk] > 0.0 && (-ping->bathcorr[ibeam]) >= sum[kk]) {
+        if (mark_dirty)
+          mbeditviz_grid_dirty(i, j, true);
       }
     }
 
@@ -2752,37 +2861,21 @@ int mbeditviz_grid_beam(struct mbev_file_struct *file, struct mbev_ping_struct *
 
       /* add to weights and sums */
       if (beam_ok) {
-        mbev_grid.wgt[kk] += 1.0;
-        mbev_grid.sum[kk] += (-ping->bathcorr[ibeam]);
-        mbev_grid.sgm[kk] += ping->bathcorr[ibeam] * ping->bathcorr[ibeam];
+        wgt[kk] += 1.0;
+        sum[kk] += (-ping->bathcorr[ibeam]);
+        sgm[kk] += ping->bathcorr[ibeam] * ping->bathcorr[ibeam];
       }
       else {
-        mbev_grid.wgt[kk] -= 1.0;
-        mbev_grid.sum[kk] -= (-ping->bathcorr[ibeam]);
-        mbev_grid.sgm[kk] -= ping->bathcorr[ibeam] * ping->bathcorr[ibeam];
-        if (mbev_grid.wgt[kk] < MBEV_GRID_WEIGHT_TINY)
-          mbev_grid.wgt[kk] = 0.0;
+        wgt[kk] -= 1.0;
+        sum[kk] -= (-ping->bathcorr[ibeam]);
+        sgm[kk] -= ping->bathcorr[ibeam] * ping->bathcorr[ibeam];
+        if (wgt[kk] < MBEV_GRID_WEIGHT_TINY)
+          wgt[kk] = 0.0;
       }
 
-      /* recalculate grid cell if desired */
-      if (apply_now) {
-        /* recalculate grid cell */
-        if (mbev_grid.wgt[kk] > 0.0) {
-          mbev_grid.val[kk] = mbev_grid.sum[kk] / mbev_grid.wgt[kk];
-          mbev_grid.sgm[kk] = sqrt(fabs(mbev_grid.sgm[kk] / mbev_grid.wgt[kk] - mbev_grid.val[kk] * mbev_grid.val[kk]));
-          mbev_grid.min = MIN(mbev_grid.min, mbev_grid.val[kk]);
-          mbev_grid.max = MAX(mbev_grid.max, mbev_grid.val[kk]);
-          mbev_grid.smin = MIN(mbev_grid.smin, mbev_grid.sgm[kk]);
-          mbev_grid.smax = MAX(mbev_grid.smax, mbev_grid.sgm[kk]);
-        }
-        else {
-          mbev_grid.val[kk] = mbev_grid.nodatavalue;
-          mbev_grid.sgm[kk] = mbev_grid.nodatavalue;
-        }
-
-        /* update grid in mbview display */
-        mbview_updateprimarygridcell(mbev_verbose, 0, i, j, mbev_grid.val[kk], &mbev_error);
-      }
+      /* recalculate grid cell at the next flush */
+      if (mark_dirty)
+        mbeditviz_grid_dirty(i, j, false);
     }
 
     /* else footprint gridding algorithm */
@@ -2866,41 +2959,279 @@ int mbeditviz_grid_beam(struct mbev_file_struct *file, struct mbev_ping_struct *
 
             /* add to weights and sums */
             if (beam_ok) {
-              mbev_grid.wgt[kk] += weight;
-              mbev_grid.sum[kk] += weight * (-ping->bathcorr[ibeam]);
-              mbev_grid.sgm[kk] += weight * ping->bathcorr[ibeam] * ping->bathcorr[ibeam];
+              wgt[kk] += weight;
+              sum[kk] += weight * (-ping->bathcorr[ibeam]);
+              sgm[kk] += weight * ping->bathcorr[ibeam] * ping->bathcorr[ibeam];
             }
             else {
-              mbev_grid.wgt[kk] -= weight;
-              mbev_grid.sum[kk] -= weight * (-ping->bathcorr[ibeam]);
-              mbev_grid.sgm[kk] -= weight * ping->bathcorr[ibeam] * ping->bathcorr[ibeam];
-              if (mbev_grid.wgt[kk] < MBEV_GRID_WEIGHT_TINY)
-                mbev_grid.wgt[kk] = 0.0;
+              wgt[kk] -= weight;
+              sum[kk] -= weight * (-ping->bathcorr[ibeam]);
+              sgm[kk] -= weight * ping->bathcorr[ibeam] * ping->bathcorr[ibeam];
+              if (wgt[kk] < MBEV_GRID_WEIGHT_TINY)
+                wgt[kk] = 0.0;
             }
 
-            /* recalculate grid cell if desired */
-            if (apply_now) {
-              /* recalculate grid cell */
-              if (mbev_grid.wgt[kk] > 0.0) {
-                mbev_grid.val[kk] = mbev_grid.sum[kk] / mbev_grid.wgt[kk];
-                mbev_grid.sgm[kk] =
-                    sqrt(fabs(mbev_grid.sgm[kk] / mbev_grid.wgt[kk] - mbev_grid.val[kk] * mbev_grid.val[kk]));
-                mbev_grid.min = MIN(mbev_grid.min, mbev_grid.val[kk]);
-                mbev_grid.max = MAX(mbev_grid.max, mbev_grid.val[kk]);
-                mbev_grid.smin = MIN(mbev_grid.smin, mbev_grid.sgm[kk]);
-                mbev_grid.smax = MAX(mbev_grid.smax, mbev_grid.sgm[kk]);
-              }
-              else {
-                mbev_grid.val[kk] = mbev_grid.nodatavalue;
-                mbev_grid.sgm[kk] = mbev_grid.nodatavalue;
-              }
+            /* recalculate grid cell at the next flush */
+            if (mark_dirty)
+              mbeditviz_grid_dirty(ii, jj, false);
+          }
+        }
+    }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+static void *mbeditviz_grid_thread(void *arg) {
+  struct mbev_thread_struct *thread = (struct mbev_thread_struct *)arg;
+
+  for (int ifile = mbeditviz_claim_file(thread->work, false); ifile >= 0;
+       ifile = mbeditviz_claim_file(thread->work, true)) {
+    struct mbev_file_struct *file = &mbev_files[ifile];
+    for (int iping = 0; iping < file->num_pings; iping++) {
+      struct mbev_ping_struct *ping = &(file->pings[iping]);
+      for (int ibeam = 0; ibeam < ping->beams_bath; ibeam++) {
+        if (mb_beam_ok(ping->beamflag[ibeam])) {
+          mbeditviz_grid_beam_accumulate(file, ping, ibeam, true, thread->sum, thread->wgt, thread->sgm, false);
+        }
+      }
+    }
+  }
+
+  mbeditviz_thread_finish(thread->work);
+  return (NULL);
+}
+
+/*--------------------------------------------------------------------*/
+int mbeditviz_make_grid() {
+  if (mbev_verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+  }
+
+  fprintf(stderr, "\nGenerating Grid:\n----------------\n");
+  fprintf(stderr, "Grid bounds (longitude latitude): %.7f %.7f %.7f %.7f\n",
+          mbev_grid_bounds[0], mbev_grid_bounds[1],
+          mbev_grid_bounds[2], mbev_grid_bounds[3]);
+  fprintf(stderr, "Grid bounds (eastings northings): %.3f %.3f %.3f %.3f\n",
+          mbev_grid_boundsutm[0], mbev_grid_boundsutm[1],
+          mbev_grid_boundsutm[2], mbev_grid_boundsutm[3]);
+  fprintf(stderr, "Cell size:%.3f\nGrid Dimensions: %d %d\n",
+          mbev_grid_cellsize, mbev_grid_n_columns, mbev_grid_n_rows);
+  if (mbev_grid_algorithm == MBEV_GRID_ALGORITHM_SIMPLEMEAN)
+    fprintf(stderr, "Algorithm: Simple Mean\n");
+  else if (mbev_grid_algorithm == MBEV_GRID_ALGORITHM_FOOTPRINT)
+    fprintf(stderr, "Algorithm: Footprint\n");
+  else //if (mbev_grid_algorithm == MBEV_GRID_ALGORITHM_SHOALBIAS)
+    fprintf(stderr, "Algorithm: Shoal Bias\n");
+  fprintf(stderr, "Interpolation: %d\n\n", mbev_grid_interpolation);
+
+  /* zero the grid arrays */
+  const size_t ncells = (size_t)mbev_grid.n_columns * mbev_grid.n_rows;
+  memset(mbev_grid.sum, 0, ncells * sizeof(float));
+  memset(mbev_grid.wgt, 0, ncells * sizeof(float));
+  /* memset(mbev_grid.val, 0, ncells * sizeof(float));*/
+  memset(mbev_grid.sgm, 0, ncells * sizeof(float));
+
+  /* any edits waiting to be flushed are included in the new grid */
+  memset(mbev_grid.dirty, 0, ncells * sizeof(char));
+  mbeditviz_grid_dirty_reset();
+
+  /* allocate partial grids for each thread after the first, using
+      fewer threads if memory runs short */
+  struct mbev_thread_struct threads[MB_THREAD_MAX];
+  memset(threads, 0, sizeof(threads));
+  int nthreads = mbeditviz_num_threads();
+  threads[0].sum = mbev_grid.sum;
+  threads[0].wgt = mbev_grid.wgt;
+  threads[0].sgm = mbev_grid.sgm;
+  for (int ithread = 1; ithread < nthreads; ithread++) {
+    threads[ithread].sum = (float *)calloc(ncells, sizeof(float));
+    threads[ithread].wgt = (float *)calloc(ncells, sizeof(float));
+    threads[ithread].sgm = (float *)calloc(ncells, sizeof(float));
+    if (threads[ithread].sum == NULL || threads[ithread].wgt == NULL || threads[ithread].sgm == NULL) {
+      free(threads[ithread].sum);
+      free(threads[ithread].wgt);
+      free(threads[ithread].sgm);
+      nthreads = ithread;
+    }
+  }
+
+  /* loop over loaded files */
+  mbeditviz_run_threads(mbeditviz_grid_thread, threads, nthreads, "Gridding");
+
+  /* merge the partial grids */
+  for (int ithread = 1; ithread < nthreads; ithread++) {
+    struct mbev_thread_struct *thread = &threads[ithread];
+    if (mbev_grid_algorithm == MBEV_GRID_ALGORITHM_SHOALBIAS) {
+      for (size_t k = 0; k < ncells; k++) {
+        if (thread->wgt[k] > 0.0 && (mbev_grid.wgt[k] <= 0.0 || thread->sum[k] > mbev_grid.sum[k])) {
+          mbev_grid.wgt[k] = thread->wgt[k];
+          mbev_grid.sum[k] = thread->sum[k];
+          mbev_grid.sgm[k] = thread->sgm[k];
+        }
+      }
+    }
+    else {
+      for (size_t k = 0; k < ncells; k++) {
+        mbev_grid.wgt[k] += thread->wgt[k];
+        mbev_grid.sum[k] += thread->sum[k];
+        mbev_grid.sgm[k] += thread->sgm[k];
+      }
+    }
+    free(thread->sum);
+    free(thread->wgt);
+    free(thread->sgm);
+  }
+
+  mbev_grid.nodatavalue = MBEV_NODATA;
+  bool first = true;
+  for (int i = 0; i < mbev_grid.n_columns; i++)
+    for (int j = 0; j < mbev_grid.n_rows; j++) {
+      const int k = i * mbev_grid.n_rows + j;
+      if (mbev_grid.wgt[k] > 0.0) {
+        mbev_grid.val[k] = mbev_grid.sum[k] / mbev_grid.wgt[k];
+        mbev_grid.sgm[k] = sqrt(fabs(mbev_grid.sgm[k] / mbev_grid.wgt[k] - mbev_grid.val[k] * mbev_grid.val[k]));
+        if (first) {
+          mbev_grid.min = mbev_grid.val[k];
+          mbev_grid.max = mbev_grid.val[k];
+          mbev_grid.smin = mbev_grid.sgm[k];
+          mbev_grid.smax = mbev_grid.sgm[k];
+          first = false;
+        }
+        else {
+          mbev_grid.min = MIN(mbev_grid.min, mbev_grid.val[k]);
+          mbev_grid.max = MAX(mbev_grid.max, mbev_grid.val[k]);
+          mbev_grid.smin = MIN(mbev_grid.smin, mbev_grid.sgm[k]);
+          mbev_grid.smax = MAX(mbev_grid.smax, mbev_grid.sgm[k]);
+        }
+      }
+      else {
+        mbev_grid.val[k] = mbev_grid.nodatavalue;
+        mbev_grid.sgm[k] = mbev_grid.nodatavalue;
+      }
+    }
+  if (mbev_grid.status == MBEV_GRID_NONE)
+    mbev_grid.status = MBEV_GRID_NOTVIEWED;
 
-              /* update grid in mbview display */
-              mbview_updateprimarygridcell(mbev_verbose, 0, ii, jj, mbev_grid.val[kk], &mbev_error);
+  if (mbev_verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:      %d\n", mbev_error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       mbev_status: %d\n", mbev_status);
+  }
+
+  return (mbev_status);
+}
+
+/*--------------------------------------------------------------------*/
+int mbeditviz_grid_beam(struct mbev_file_struct *file, struct mbev_ping_struct *ping, int ibeam,
+                        bool beam_ok,
+                        bool apply_now
+                        ) {
+  if (mbev_verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       file:       %p\n", file);
+    fprintf(stderr, "dbg2       ping:       %p\n", ping);
+    fprintf(stderr, "dbg2       ibeam:      %d\n", ibeam);
+    fprintf(stderr, "dbg2       beam_ok:    %d\n", beam_ok);
+    fprintf(stderr, "dbg2       apply_now:  %d\n", apply_now);
+  }
+
+  /* add or remove the sounding, marking the changed cells to be
+      recalculated and displayed by mbeditviz_grid_flush() if desired */
+  mbeditviz_grid_beam_accumulate(file, ping, ibeam, beam_ok, mbev_grid.sum, mbev_grid.wgt, mbev_grid.sgm, apply_now);
+
+  if (mbev_verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:      %d\n", mbev_error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       mbev_status: %d\n", mbev_status);
+  }
+
+  return (mbev_status);
+}
+
+/*--------------------------------------------------------------------*/
+int mbeditviz_grid_flush() {
+  if (mbev_verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+  }
+
+  const int i1 = mbev_grid.dirty_bounds[0];
+  const int i2 = mbev_grid.dirty_bounds[1];
+  const int j1 = mbev_grid.dirty_bounds[2];
+  const int j2 = mbev_grid.dirty_bounds[3];
+
+  if (mbev_grid.dirty != NULL && i1 <= i2 && j1 <= j2) {
+    /* regrid the cells that lost their shoalest sounding from the
+        soundings falling in those cells */
+    bool regrid = false;
+    for (int i = i1; i <= i2; i++)
+      for (int j = j1; j <= j2; j++) {
+        const int kk = i * mbev_grid.n_rows + j;
+        if (mbev_grid.dirty[kk] == 2) {
+          mbev_grid.wgt[kk] = 0.0;
+          mbev_grid.sum[kk] = 0.0;
+          mbev_grid.sgm[kk] = 0.0;
+          regrid = true;
+        }
+      }
+    if (regrid) {
+      /* only pings with soundings inside the dirty cells can contribute */
+      const double xmin = mbev_grid.boundsutm[0] + (i1 - 0.5) * mbev_grid.dx;
+      const double xmax = mbev_grid.boundsutm[0] + (i2 + 0.5) * mbev_grid.dx;
+      const double ymin = mbev_grid.boundsutm[2] + (j1 - 0.5) * mbev_grid.dy;
+      const double ymax = mbev_grid.boundsutm[2] + (j2 + 0.5) * mbev_grid.dy;
+      for (int ifile = 0; ifile < mbev_num_files; ifile++) {
+        struct mbev_file_struct *file = &mbev_files[ifile];
+        if (file->load_status) {
+          for (int iping = 0; iping < file->num_pings; iping++) {
+            struct mbev_ping_struct *ping = &(file->pings[iping]);
+            if (!ping->bathxy_bounds_valid)
+              mbeditviz_ping_bathxy_bounds(ping);
+            if (ping->bathxy_bounds[1] < xmin || ping->bathxy_bounds[0] > xmax || ping->bathxy_bounds[3] < ymin ||
+                ping->bathxy_bounds[2] > ymax)
+              continue;
+            for (int ibeam = 0; ibeam < ping->beams_bath; ibeam++) {
+              if (mb_beam_ok(ping->beamflag[ibeam])) {
+                const int i = (ping->bathx[ibeam] - mbev_grid.boundsutm[0] + 0.5 * mbev_grid.dx) / mbev_grid.dx;
+                const int j = (ping->bathy[ibeam] - mbev_grid.boundsutm[2] + 0.5 * mbev_grid.dy) / mbev_grid.dy;
+                if (i >= i1 && i <= i2 && j >= j1 && j <= j2 && mbev_grid.dirty[i * mbev_grid.n_rows + j] == 2)
+                  mbeditviz_grid_beam_accumulate(file, ping, ibeam, true, mbev_grid.sum, mbev_grid.wgt, mbev_grid.sgm,
+                                                 false);
+              }
             }
           }
         }
+      }
     }
+
+    /* recalculate the changed cells and update them in mbview */
+    for (int i = i1; i <= i2; i++)
+      for (int j = j1; j <= j2; j++) {
+        const int kk = i * mbev_grid.n_rows + j;
+        if (mbev_grid.dirty[kk] != 0) {
+          if (mbev_grid.wgt[kk] > 0.0) {
+            mbev_grid.val[kk] = mbev_grid.sum[kk] / mbev_grid.wgt[kk];
+            mbev_grid.sgm[kk] = sqrt(fabs(mbev_grid.sgm[kk] / mbev_grid.wgt[kk] - mbev_grid.val[kk] * mbev_grid.val[kk]));
+            mbev_grid.min = MIN(mbev_grid.min, mbev_grid.val[kk]);
+            mbev_grid.max = MAX(mbev_grid.max, mbev_grid.val[kk]);
+            mbev_grid.smin = MIN(mbev_grid.smin, mbev_grid.sgm[kk]);
+            mbev_grid.smax = MAX(mbev_grid.smax, mbev_grid.sgm[kk]);
+          }
+          else {
+            mbev_grid.val[kk] = mbev_grid.nodatavalue;
+            mbev_grid.sgm[kk] = mbev_grid.nodatavalue;
+          }
+          mbview_updateprimarygridcell(mbev_verbose, 0, i, j, mbev_grid.val[kk], &mbev_error);
+          mbev_grid.dirty[kk] = 0;
+        }
+      }
+    mbeditviz_grid_dirty_reset();
   }
 
   if (mbev_verbose >= 2) {
@@ -3076,11 +3407,15 @@ int mbeditviz_make_grid_simple() {
       mbev_error = MB_ERROR_MEMORY_FAIL;
     if ((mbev_grid.sgm = (float *)malloc(mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float))) == NULL)
       mbev_error = MB_ERROR_MEMORY_FAIL;
+    if ((mbev_grid.dirty = (char *)malloc(mbev_grid.n_columns * mbev_grid.n_rows * sizeof(char))) == NULL)
+      mbev_error = MB_ERROR_MEMORY_FAIL;
     if (mbev_error == MB_ERROR_NO_ERROR) {
       memset(mbev_grid.sum, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
       memset(mbev_grid.wgt, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
       memset(mbev_grid.val, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
       memset(mbev_grid.sgm, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(float));
+      memset(mbev_grid.dirty, 0, mbev_grid.n_columns * mbev_grid.n_rows * sizeof(char));
+      mbeditviz_grid_dirty_reset();
     }
     else
       mbev_status = MB_FAILURE;
@@ -3102,6 +3437,7 @@ int mbeditviz_make_grid_simple() {
             if (!mb_beam_check_flag_unusable(ping->beamflag[ibeam])) {
               mb_proj_forward(mbev_verbose, mbev_grid.pjptr, ping->bathlon[ibeam], ping->bathlat[ibeam],
                               &ping->bathx[ibeam], &ping->bathy[ibeam], &mbev_error);
+              ping->bathxy_bounds_valid = false;
             }
             if (mb_beam_ok(ping->beamflag[ibeam])) {
               const int i = (ping->bathx[ibeam] - mbev_grid.boundsutm[0] + 0.5 * mbev_grid.dx) / mbev_grid.dx;
@@ -3265,10 +3601,13 @@ int mbeditviz_destroy_grid() {
       free(mbev_grid.val);
     if (mbev_grid.sgm != NULL)
       free(mbev_grid.sgm);
+    if (mbev_grid.dirty != NULL)
+      free(mbev_grid.dirty);
     mbev_grid.sum = NULL;
     mbev_grid.wgt = NULL;
     mbev_grid.val = NULL;
     mbev_grid.sgm = NULL;
+    mbev_grid.dirty = NULL;
 
     /* release projection */
     mb_proj_free(mbev_verbose, &(mbev_grid.pjptr), &mbev_error);
@@ -3413,6 +3752,7 @@ int mbeditviz_selectregion(size_t instance) {
                     heading, &(ping->bathcorr[ibeam]), &(ping->bathlon[ibeam]), &(ping->bathlat[ibeam]));
                 mb_proj_forward(mbev_verbose, mbev_grid.pjptr, ping->bathlon[ibeam], ping->bathlat[ibeam],
                                 &ping->bathx[ibeam], &ping->bathy[ibeam], &mbev_error);
+                ping->bathxy_bounds_valid = false;
 
                 /* get local position in selected region */
                 const double x = ping->bathx[ibeam] - mbev_selected.xorigin;
@@ -3585,6 +3925,7 @@ int mbeditviz_selectarea(size_t instance) {
                     heading, &(ping->bathcorr[ibeam]), &(ping->bathlon[ibeam]), &(ping->bathlat[ibeam]));
                 mb_proj_forward(mbev_verbose, mbev_grid.pjptr, ping->bathlon[ibeam], ping->bathlat[ibeam],
                                 &ping->bathx[ibeam], &ping->bathy[ibeam], &mbev_error);
+                ping->bathxy_bounds_valid = false;
                 x = ping->bathx[ibeam] - mbev_selected.xorigin;
                 y = ping->bathy[ibeam] - mbev_selected.yorigin;
                 yy = -x * mbev_selected.cosbearing + y * mbev_selected.sinbearing;
@@ -3745,6 +4086,7 @@ int mbeditviz_selectnav(size_t instance) {
                   heading, &(ping->bathcorr[ibeam]), &(ping->bathlon[ibeam]), &(ping->bathlat[ibeam]));
               mb_proj_forward(mbev_verbose, mbev_grid.pjptr, ping->bathlon[ibeam], ping->bathlat[ibeam],
                               &ping->bathx[ibeam], &ping->bathy[ibeam], &mbev_error);
+              ping->bathxy_bounds_valid = false;
 
               /* get local position in selected region */
               mbev_selected.soundings[mbev_selected.num_soundings].x = ping->bathx[ibeam];
@@ -3954,8 +4296,9 @@ void mbeditviz_mb3dsoundings_edit(int ifile, int iping, int ibeam, char beamflag
     ping->beamflag[ibeam] = beamflag;
   }
 
-  /* redisplay grid if flush specified */
+  /* recalculate the edited grid cells and redisplay grid if flush specified */
   if (flush != MB3DSDG_EDIT_NOFLUSH) {
+    mbeditviz_grid_flush();
     mbview_plothigh(0);
   }
 
@@ -4067,6 +4410,7 @@ void mbeditviz_mb3dsoundings_bias(double rollbias, double pitchbias, double head
                             heading, &(ping->bathcorr[ibeam]), &(ping->bathlon[ibeam]), &(ping->bathlat[ibeam]));
     mb_proj_forward(mbev_verbose, mbev_grid.pjptr, ping->bathlon[ibeam], ping->bathlat[ibeam], &ping->bathx[ibeam],
                     &ping->bathy[ibeam], &mbev_error);
+    ping->bathxy_bounds_valid = false;
     const double x = ping->bathx[ibeam] - mbev_selected.xorigin;
     const double y = ping->bathy[ibeam] - mbev_selected.yorigin;
     const double xx = x * mbev_selected.sinbearing + y * mbev_selected.cosbearing;
@@ -4164,15 +4508,14 @@ void mbeditviz_mb3dsoundings_biasapply(double rollbias, double pitchbias, double
             mbeditviz_beam_position(ping->navlon, ping->navlat, mtodeglon, mtodeglat,
                         beam_z, beam_xtrack, beam_ltrack, sensordepth, rolldelta, pitchdelta, heading,
                         &(ping->bathcorr[ibeam]), &(ping->bathlon[ibeam]), &(ping->bathlat[ibeam]));
-            mb_proj_forward(mbev_verbose, mbev_grid.pjptr, ping->bathlon[ibeam], ping->bathlat[ibeam],
-                    &ping->bathx[ibeam], &ping->bathy[ibeam], &mbev_error);
           }
         }
       }
     }
   }
 
-  /* recalculate grid */
+  /* project the moved soundings and recalculate grid */
+  mbeditviz_project_soundings();
   mbeditviz_make_grid();
 
   /* update the grid to mbview */
@@ -148,7 +148,10 @@ int mb_dimensions(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int *
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_dimensions)(verbose, mbio_ptr, store_ptr, kind, nbath, namp, nss, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -252,8 +255,11 @@ int mb_beamwidths(int verbose, void *mbio_ptr, double *beamwidth_xtrack, double
   struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
 
   /* extract the values from the mb_io structure */
+  int lock_error = MB_ERROR_NO_ERROR;
+  mb_readahead_lock(verbose, mbio_ptr, &lock_error);
   *beamwidth_xtrack = mb_io_ptr->beamwidth_xtrack;
   *beamwidth_ltrack = mb_io_ptr->beamwidth_ltrack;
+  mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   const int status = MB_SUCCESS;
   *error = MB_ERROR_NO_ERROR;
 
@@ -297,7 +303,10 @@ int mb_sonartype(int verbose, void *mbio_ptr, void *store_ptr, int *sonartype, i
   if (mb_io_ptr->mb_io_sonartype != NULL) {
     if (store_ptr == NULL)
       store_ptr = (void *)mb_io_ptr->store_data;
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_sonartype)(verbose, mbio_ptr, store_ptr, sonartype, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
 
   /* Some systems are definitively echosounders */
@@ -376,7 +385,10 @@ int mb_sidescantype(int verbose, void *mbio_ptr, void *store_ptr, int *ss_type,
   if (mb_io_ptr->mb_io_sidescantype != NULL) {
     if (store_ptr == NULL)
       store_ptr = (void *)mb_io_ptr->store_data;
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_sidescantype)(verbose, mbio_ptr, store_ptr, ss_type, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -412,7 +424,10 @@ int mb_preprocess(int verbose, void *mbio_ptr, void *store_ptr, void *platform_p
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_preprocess != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_preprocess)(verbose, mbio_ptr, store_ptr, platform_ptr, preprocess_pars_ptr, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
 
   else {
@@ -449,7 +464,10 @@ int mb_extract_platform(int verbose, void *mbio_ptr, void *store_ptr, int *kind,
   struct mb_platform_struct *platform = NULL;
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract_platform != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract_platform)(verbose, mbio_ptr, store_ptr, kind, platform_ptr, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
 
     if (status == MB_SUCCESS && *platform_ptr == NULL) {
       status = MB_FAILURE;
@@ -566,8 +584,12 @@ int mb_sensorhead(int verbose, void *mbio_ptr, void *store_ptr, int *sensorhead,
   if (mb_io_ptr->mb_io_sensorhead != NULL) {
     if (store_ptr == NULL)
       store_ptr = (void *)mb_io_ptr->store_data;
-    if (store_ptr != NULL)
+    if (store_ptr != NULL) {
+      int lock_error = MB_ERROR_NO_ERROR;
+      mb_readahead_lock(verbose, mbio_ptr, &lock_error);
       status = (*mb_io_ptr->mb_io_sensorhead)(verbose, mbio_ptr, store_ptr, sensorhead, error);
+      mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
+    }
   }
 
   /* else set error so calling function knows to use timestamp comparison
@@ -608,9 +630,12 @@ int mb_extract(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int time
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract)(verbose, mbio_ptr, store_ptr, kind, time_i, time_d, navlon, navlat, speed, heading,
                                          nbath, namp, nss, beamflag, bath, amp, bathacrosstrack, bathalongtrack, ss,
                                          ssacrosstrack, ssalongtrack, comment, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -714,9 +739,12 @@ int mb_extract_lonlat(int verbose, void *mbio_ptr, void *store_ptr, int *kind, i
   double *ssacrosstrack = sslon;
   double *ssalongtrack = sslat;
   if (mb_io_ptr->mb_io_extract != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract)(verbose, mbio_ptr, store_ptr, kind, time_i, time_d, navlon, navlat, speed, heading,
                                          nbath, namp, nss, beamflag, bath, amp, bathacrosstrack, bathalongtrack, ss,
                                          ssacrosstrack, ssalongtrack, comment, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -898,9 +926,12 @@ int mb_insert(int verbose, void *mbio_ptr, void *store_ptr, int kind, int time_i
 
   /* call the appropriate mbsys_ insertion routine */
   if (mb_io_ptr->mb_io_insert != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status &= (*mb_io_ptr->mb_io_insert)(verbose, mbio_ptr, store_ptr, kind, time_i, time_d, navlon, navlat, speed, heading,
                                         nbath, namp, nss, beamflag, bath, amp, bathacrosstrack, bathalongtrack, ss,
                                         ssacrosstrack, ssalongtrack, comment, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -935,8 +966,11 @@ int mb_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract_nav != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract_nav)(verbose, mbio_ptr, store_ptr, kind, time_i, time_d, navlon, navlat, speed,
                                              heading, draft, roll, pitch, heave, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1018,12 +1052,18 @@ int mb_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int nmax, int
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract_nnav != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract_nnav)(verbose, mbio_ptr, store_ptr, nmax, kind, n, time_i, time_d, navlon, navlat,
                                               speed, heading, draft, roll, pitch, heave, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else if (mb_io_ptr->mb_io_extract_nav != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract_nav)(verbose, mbio_ptr, store_ptr, kind, time_i, time_d, navlon, navlat, speed,
                                              heading, draft, roll, pitch, heave, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
     if (status == MB_SUCCESS)
       *n = 1;
     else
@@ -1163,8 +1203,11 @@ int mb_insert_nav(int verbose, void *mbio_ptr, void *store_ptr, int time_i[7], d
   /* call the appropriate mbsys_ insertion routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_insert_nav != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_insert_nav)(verbose, mbio_ptr, store_ptr, time_i, time_d, navlon, navlat, speed, heading,
                                             draft, roll, pitch, heave, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1197,7 +1240,10 @@ int mb_extract_altitude(int verbose, void *mbio_ptr, void *store_ptr, int *kind,
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract_altitude != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract_altitude)(verbose, mbio_ptr, store_ptr, kind, transducer_depth, altitude, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1234,7 +1280,10 @@ int mb_insert_altitude(int verbose, void *mbio_ptr, void *store_ptr, double tran
   /* call the appropriate mbsys_ insertion routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_insert_altitude != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_insert_altitude)(verbose, mbio_ptr, store_ptr, transducer_depth, altitude, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1267,7 +1316,10 @@ int mb_extract_svp(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract_svp != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract_svp)(verbose, mbio_ptr, store_ptr, kind, nsvp, depth, velocity, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1306,7 +1358,10 @@ int mb_insert_svp(int verbose, void *mbio_ptr, void *store_ptr, int nsvp, double
   /* call the appropriate mbsys_ insertion routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_insert_svp != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_insert_svp)(verbose, mbio_ptr, store_ptr, nsvp, depth, velocity, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1509,8 +1564,11 @@ int mb_ttimes(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int *nbea
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_ttimes != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_ttimes)(verbose, mbio_ptr, store_ptr, kind, nbeams, ttimes, angles, angles_forward,
                                         angles_null, heave, alongtrack_offset, draft, ssv, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1553,7 +1611,10 @@ int mb_detects(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int *nbe
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_detects != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_detects)(verbose, mbio_ptr, store_ptr, kind, nbeams, detects, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     for (int i = 0; i < *nbeams; i++)
@@ -1593,7 +1654,10 @@ int mb_pulses(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int *nbea
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_pulses != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_pulses)(verbose, mbio_ptr, store_ptr, kind, nbeams, pulses, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1634,7 +1698,10 @@ int mb_gains(int verbose, void *mbio_ptr, void *store_ptr, int *kind, double *tr
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_gains != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_gains)(verbose, mbio_ptr, store_ptr, kind, transmit_gain, pulse_length, receive_gain, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1680,8 +1747,11 @@ int mb_gains(int verbose, void *mbio_ptr, void *store_ptr, int *kind, double *tr
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_makess != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_makess)(verbose, mbio_ptr, store_ptr, pixel_size_set, pixel_size,
                            swath_width_set, swath_width, pixel_int, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1716,8 +1786,11 @@ int mb_extract_rawssdimensions(int verbose, void *mbio_ptr, void *store_ptr, int
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract_rawssdimensions != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract_rawssdimensions)(verbose, mbio_ptr, store_ptr, kind, sample_interval,
                                                          num_samples_port, num_samples_stbd, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1755,9 +1828,12 @@ int mb_extract_rawss(int verbose, void *mbio_ptr, void *store_ptr, int *kind, in
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract_rawss != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract_rawss)(verbose, mbio_ptr, store_ptr, kind, sidescan_type, sample_interval,
                                                beamwidth_xtrack, beamwidth_ltrack, num_samples_port, rawss_port,
                                                num_samples_stbd, rawss_stbd, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1813,9 +1889,12 @@ int mb_insert_rawss(int verbose, void *mbio_ptr, void *store_ptr, int kind, int
   /* call the appropriate mbsys_ insertion routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_insert_rawss != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status =
         (*mb_io_ptr->mb_io_insert_rawss)(verbose, mbio_ptr, store_ptr, kind, sidescan_type, sample_interval, beamwidth_xtrack,
                                          beamwidth_ltrack, num_samples_port, rawss_port, num_samples_stbd, rawss_stbd, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1850,7 +1929,10 @@ int mb_extract_segytraceheader(int verbose, void *mbio_ptr, void *store_ptr, int
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract_segy != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract_segytraceheader)(verbose, mbio_ptr, store_ptr, kind, segytraceheader_ptr, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -1953,8 +2035,11 @@ int mb_extract_segy(int verbose, void *mbio_ptr, void *store_ptr, int *samplefor
   /* call the appropriate mbsys_ extraction routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_extract_segy != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_extract_segy)(verbose, mbio_ptr, store_ptr, sampleformat, kind, segytraceheader_ptr, segydata,
                                               error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -2127,7 +2212,10 @@ int mb_insert_segy(int verbose, void *mbio_ptr, void *store_ptr, int kind, void
   /* call the appropriate mbsys_ insertion routine */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_insert_segy != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_insert_segy)(verbose, mbio_ptr, store_ptr, kind, segytraceheader_ptr, segydata, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -2161,8 +2249,11 @@ int mb_ctd(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int *nctd, d
   /* note: the arrays should be allocated to MB_CTD_MAX length */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_ctd != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_ctd)(verbose, mbio_ptr, store_ptr, kind, nctd, time_d, conductivity, temperature, depth,
                                      salinity, soundspeed, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     status = MB_FAILURE;
@@ -2211,8 +2302,11 @@ int mb_ancilliarysensor(int verbose, void *mbio_ptr, void *store_ptr, int *kind,
   /* note: the arrays should be allocated to MB_CTD_MAX length */
   int status = MB_SUCCESS;
   if (mb_io_ptr->mb_io_ancilliarysensor != NULL) {
+    int lock_error = MB_ERROR_NO_ERROR;
+    mb_readahead_lock(verbose, mbio_ptr, &lock_error);
     status = (*mb_io_ptr->mb_io_ancilliarysensor)(verbose, mbio_ptr, store_ptr, kind, nsensor, time_d, sensor1, sensor2,
                                                   sensor3, sensor4, sensor5, sensor6, sensor7, sensor8, error);
+    mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
   }
   else {
     *nsensor = 0;
@@ -2380,3 +2474,47 @@ int mb_indextableapply(int verbose, void *mbio_ptr, int num_indextable, void *in
   return (status);
 }
 /*--------------------------------------------------------------------*/
+int mb_seek_time(int verbose, void *mbio_ptr, double time_d, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:           %d\n", verbose);
+    fprintf(stderr, "dbg2       mbio_ptr:          %p\n", (void *)mbio_ptr);
+    fprintf(stderr, "dbg2       time_d:            %f\n", time_d);
+  }
+
+  /* get mbio descriptor */
+  struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+
+  /* call the format seek routine if the format supports indexed access,
+      discarding any partly read ping and asynchronous data held from
+      before the new position - records already decoded by a read
+      ahead thread cannot be discarded, so seeking is not allowed then */
+  int status = MB_SUCCESS;
+  if (mb_io_ptr->mb_io_seek_time != NULL && mb_io_ptr->readahead == NULL) {
+    status = (*mb_io_ptr->mb_io_seek_time)(verbose, mbio_ptr, time_d, error);
+    if (status == MB_SUCCESS) {
+      mb_io_ptr->need_new_ping = true;
+      mb_asynch_reset(verbose, &mb_io_ptr->asynch_fix, error);
+      mb_asynch_reset(verbose, &mb_io_ptr->asynch_attitude, error);
+      mb_asynch_reset(verbose, &mb_io_ptr->asynch_heading, error);
+      mb_asynch_reset(verbose, &mb_io_ptr->asynch_sensordepth, error);
+      mb_asynch_reset(verbose, &mb_io_ptr->asynch_altitude, error);
+    }
+  }
+  else {
+    status = MB_FAILURE;
+    *error = MB_ERROR_BAD_USAGE;
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:             %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:            %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
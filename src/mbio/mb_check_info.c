@@ -27,7 +27,8 @@
  * output must be in an ascii file with a name consisting of the
  * data file name followed by a ".inf" suffix. If the ".inf" file
  * does not exist then the file is assumed to have data within the
- * specified bounds.
+ * specified bounds. The parsed ".inf" contents are cached in binary
+ * ".inb" files alongside the data files and datalists.
  *
  * Author:	D. W. Caress
  * Date:	September 3, 1996
@@ -35,18 +36,480 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include "mb_define.h"
 #include "mb_format.h"
 #include "mb_info.h"
+#include "mb_io.h"
 #include "mb_status.h"
+#include "mbsys_ldeoih.h"
 
+/*--------------------------------------------------------------------*/
+/*
+ * The ".inf" text files remain the authoritative record of mbinfo output,
+ * but parsing them dominates the time taken to scan large datalists. The
+ * parsed contents are therefore cached in binary ".inb" files holding a
+ * header followed by fixed size records. The sidecar alongside each swath
+ * file holds a single record, and the index alongside a datalist holds one
+ * record per listed file in datalist order. A record is only used while
+ * the modification time and size of its ".inf" file are unchanged, and
+ * records are only written for ".inf" files that are at least two seconds
+ * old so that a rewrite within the same second cannot leave a stale cache.
+ * Failures to write the cache files are ignored.
+ */
+
+#define MB_INFO_CACHE_MAGIC 0x31424e49 /* "INB1" */
+#define MB_INFO_CACHE_VERSION 1
+#define MB_INFO_CACHE_SUFFIX ".inb"
+#define MB_INFO_CACHE_MASK_MAX 32
+
+/* the cached part of mb_info_struct is everything following the file name */
+#define MB_INFO_CACHE_INFO_OFFSET offsetof(struct mb_info_struct, nrecords)
+#define MB_INFO_CACHE_INFO_SIZE (sizeof(struct mb_info_struct) - MB_INFO_CACHE_INFO_OFFSET)
+
+struct mb_info_cache_header_struct {
+	int32_t magic;
+	int32_t version;
+	int32_t record_size;
+	int32_t nrecord;
+};
+
+struct mb_info_cache_record_struct {
+	uint64_t path_hash;
+	int64_t inf_mtime;
+	int64_t inf_size;
+	int32_t mask_nx;
+	int32_t mask_ny;
+	unsigned char mask[MB_INFO_CACHE_MASK_MAX * MB_INFO_CACHE_MASK_MAX / 8];
+	unsigned char info[MB_INFO_CACHE_INFO_SIZE];
+};
+
+/* datalist index mapped into memory */
+struct mb_info_cache_index_struct {
+	void *data;
+	size_t size;
+	int nrecord;
+	const struct mb_info_cache_record_struct *records;
+};
+
+/*--------------------------------------------------------------------*/
+static uint64_t mb_info_cache_hash(const char *path) {
+	/* 64 bit FNV-1a hash of the file path */
+	uint64_t hash = 14695981039346656037ULL;
+	for (const unsigned char *c = (const unsigned char *)path; *c != '\0'; c++) {
+		hash ^= *c;
+		hash *= 1099511628211ULL;
+	}
+	return (hash);
+}
+/*--------------------------------------------------------------------*/
+static bool mb_info_cache_stat(const char *file_inf, int64_t *inf_mtime, int64_t *inf_size) {
+	struct stat file_status;
+	if (stat(file_inf, &file_status) != 0 || (file_status.st_mode & S_IFMT) == S_IFDIR)
+		return (false);
+	*inf_mtime = (int64_t)file_status.st_mtime;
+	*inf_size = (int64_t)file_status.st_size;
+	return (true);
+}
+/*--------------------------------------------------------------------*/
+static bool mb_info_cache_header_ok(const struct mb_info_cache_header_struct *header) {
+	return (header->magic == MB_INFO_CACHE_MAGIC && header->version == MB_INFO_CACHE_VERSION &&
+	        header->record_size == (int32_t)sizeof(struct mb_info_cache_record_struct) && header->nrecord >= 0);
+}
+/*--------------------------------------------------------------------*/
+static bool mb_info_cache_mask_get(const struct mb_info_cache_record_struct *record, int i, int j) {
+	const int k = i + j * record->mask_nx;
+	return ((record->mask[k / 8] >> (k % 8)) & 1) != 0;
+}
+/*--------------------------------------------------------------------*/
+static void mb_info_cache_write(int verbose, const char *path, const struct mb_info_cache_record_struct *records,
+                                int nrecord) {
+#ifndef _WIN32
+	/* write to a uniquely named temporary file and rename it into place so
+	    that readers never see a partially written cache, even when several
+	    processes or threads write the same cache at once */
+	char path_tmp[MB_PATH_MAXLINE + 32];
+	snprintf(path_tmp, sizeof(path_tmp), "%s.XXXXXX", path);
+	const int fd = mkstemp(path_tmp);
+	FILE *fp = NULL;
+	if (fd >= 0) {
+		fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+		if ((fp = fdopen(fd, "wb")) == NULL) {
+			close(fd);
+			remove(path_tmp);
+		}
+	}
+	if (fp == NULL) {
+		if (verbose >= 2)
+			fprintf(stderr, "dbg2  Unable to write inf cache file: %s\n", path);
+		return;
+	}
+	struct mb_info_cache_header_struct header;
+	header.magic = MB_INFO_CACHE_MAGIC;
+	header.version = MB_INFO_CACHE_VERSION;
+	header.record_size = (int32_t)sizeof(struct mb_info_cache_record_struct);
+	header.nrecord = nrecord;
+	bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+	if (ok && nrecord > 0)
+		ok = fwrite(records, sizeof(struct mb_info_cache_record_struct), (size_t)nrecord, fp) == (size_t)nrecord;
+	if (fclose(fp) != 0)
+		ok = false;
+	if (!ok || rename(path_tmp, path) != 0) {
+		remove(path_tmp);
+		if (verbose >= 2)
+			fprintf(stderr, "dbg2  Unable to write inf cache file: %s\n", path);
+	}
+#else
+	(void)verbose;
+	(void)path;
+	(void)records;
+	(void)nrecord;
+#endif
+}
+/*--------------------------------------------------------------------*/
+/*
+ * mb_info_cache_index_map maps the records of a datalist index into
+ * memory, leaving the index empty if the file is missing or invalid
+ */
+static void mb_info_cache_index_map(int verbose, const char *path, struct mb_info_cache_index_struct *index) {
+	memset(index, 0, sizeof(struct mb_info_cache_index_struct));
+#ifndef _WIN32
+	FILE *fp = fopen(path, "rb");
+	if (fp == NULL)
+		return;
+	struct stat file_status;
+	if (fstat(fileno(fp), &file_status) == 0 && file_status.st_size >= (off_t)sizeof(struct mb_info_cache_header_struct)) {
+		void *data = mmap(NULL, (size_t)file_status.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+		if (data != MAP_FAILED) {
+			const struct mb_info_cache_header_struct *header = (const struct mb_info_cache_header_struct *)data;
+			const size_t size = sizeof(struct mb_info_cache_header_struct) +
+			                    (size_t)header->nrecord * sizeof(struct mb_info_cache_record_struct);
+			if (mb_info_cache_header_ok(header) && size == (size_t)file_status.st_size) {
+				index->data = data;
+				index->size = size;
+				index->nrecord = header->nrecord;
+				index->records = (const struct mb_info_cache_record_struct *)(header + 1);
+			}
+			else {
+				munmap(data, (size_t)file_status.st_size);
+				if (verbose >= 2)
+					fprintf(stderr, "dbg2  Ignoring invalid inf cache index: %s\n", path);
+			}
+		}
+	}
+	fclose(fp);
+#else
+	(void)verbose;
+	(void)path;
+#endif
+}
+/*--------------------------------------------------------------------*/
+static void mb_info_cache_index_unmap(struct mb_info_cache_index_struct *index) {
+#ifndef _WIN32
+	if (index->data != NULL)
+		munmap(index->data, index->size);
+#endif
+	memset(index, 0, sizeof(struct mb_info_cache_index_struct));
+}
+/*--------------------------------------------------------------------*/
+/*
+ * mb_info_parse reads the text of an inf file into mb_info, leaving
+ * nrecords at -1 if no record count is listed, and sets the coverage
+ * mask bitmap of record. Masks larger than the bitmap are coarsened so
+ * that a cell is set if any of the mask cells it covers is set.
+ */
+static void mb_info_parse(int verbose, FILE *fp, struct mb_info_struct *mb_info, struct mb_info_cache_record_struct *record) {
+	/* initialize the parameters */
+	int error = MB_ERROR_NO_ERROR;
+	mb_info_init(verbose, mb_info, &error);
+	mb_info->nrecords = -1;
+	record->mask_nx = 0;
+	record->mask_ny = 0;
+	memset(record->mask, 0, sizeof(record->mask));
+
+	/* read the inf file */
+	char line[MB_PATH_MAXLINE];
+	while (fgets(line, MB_PATH_MAXLINE, fp) != NULL) {
+		char *startptr;
+		int nscan;
+		int nproblem;
+		int problemid;
+		double speedkts;
+		if (strncmp(line, "Number of Records:", 18) == 0) {
+			int nrecords_read;
+			nscan = sscanf(line, "Number of Records: %d", &nrecords_read);
+			if (nscan == 1)
+				mb_info->nrecords = nrecords_read;
+		}
+		else if (strncmp(line, "Number of Subbottom Records:", 28) == 0) {
+			nscan = sscanf(line, "Number of Subbottom Records: %d", &mb_info->nrecords_sbp);
+		}
+		else if (strncmp(line, "Number of Secondary Sidescan Records:", 37) == 0) {
+			nscan = sscanf(line, "Number of Secondary Sidescan Records: %d", &mb_info->nrecords_ss1);
+		}
+		else if (strncmp(line, "Number of Tertiary Sidescan Records:", 36) == 0) {
+			nscan = sscanf(line, "Number of Tertiary Sidescan Records: %d", &mb_info->nrecords_ss2);
+		}
+
+		else if (strncmp(line, "Bathymetry Data (", 17) == 0) {
+			nscan = sscanf(line, "Bathymetry Data (%d beams):", &mb_info->nbeams_bath);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Beams: %d", &mb_info->nbeams_bath_total);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Good Beams: %d", &mb_info->nbeams_bath_good);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Zero Beams: %d", &mb_info->nbeams_bath_zero);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Flagged Beams: %d", &mb_info->nbeams_bath_flagged);
+		}
+
+		else if (strncmp(line, "Amplitude Data (", 16) == 0) {
+			nscan = sscanf(line, "Amplitude Data (%d beams):", &mb_info->nbeams_amp);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Beams: %d", &mb_info->nbeams_amp_total);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Good Beams: %d", &mb_info->nbeams_amp_good);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Zero Beams: %d", &mb_info->nbeams_amp_zero);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Flagged Beams: %d", &mb_info->nbeams_amp_flagged);
+		}
+
+		else if (strncmp(line, "Sidescan Data (", 15) == 0) {
+			nscan = sscanf(line, "Sidescan Data (%d pixels):", &mb_info->npixels_ss);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Pixels: %d", &mb_info->npixels_ss_total);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Good Pixels: %d", &mb_info->npixels_ss_good);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Zero Pixels: %d", &mb_info->npixels_ss_zero);
+			if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
+				nscan = sscanf(line, "  Number of Flagged Pixels: %d", &mb_info->npixels_ss_flagged);
+		}
+
+		else if (strncmp(line, "Total Time:", 11) == 0) {
+			nscan = sscanf(line, "Total Time: %lf hours", &mb_info->time_total);
+		}
+		else if (strncmp(line, "Total Track Length:", 19) == 0) {
+			nscan = sscanf(line, "Total Track Length: %lf km", &mb_info->dist_total);
+		}
+		else if (strncmp(line, "Average Speed:", 14) == 0) {
+			nscan = sscanf(line, "Average Speed: %lf km/hr", &mb_info->speed_avg);
+		}
+
+		else if (strncmp(line, "Start of Data:", 14) == 0) {
+			if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
+				int time_i[7];
+				nscan = sscanf(line, "Time:  %d %d %d %d:%d:%d.%d  JD", &time_i[1], &time_i[2], &time_i[0], &time_i[3],
+				               &time_i[4], &time_i[5], &time_i[6]);
+				if (nscan == 7)
+					mb_get_time(verbose, time_i, &(mb_info->time_start));
+			}
+			if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
+				nscan = sscanf(line, "Lon: %lf	 Lat: %lf Depth: %lf meters", &mb_info->lon_start, &mb_info->lat_start,
+				               &mb_info->depth_start);
+			}
+			if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
+				nscan = sscanf(line, "Speed: %lf km/hr ( %lf knots)  Heading: %lf degrees", &mb_info->speed_start, &speedkts,
+				               &mb_info->heading_start);
+			}
+			if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
+				nscan = sscanf(line, "Sonar Depth:  %lf m  Sonar Altitude:   %lf m", &mb_info->sensordepth_start,
+				               &mb_info->sonaraltitude_start);
+			}
+		}
+
+		else if (strncmp(line, "End of Data:", 12) == 0) {
+			if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
+				int time_i[7];
+				nscan = sscanf(line, "Time:  %d %d %d %d:%d:%d.%d  JD", &time_i[1], &time_i[2], &time_i[0], &time_i[3],
+				               &time_i[4], &time_i[5], &time_i[6]);
+				if (nscan == 7)
+					mb_get_time(verbose, time_i, &(mb_info->time_end));
+			}
+			if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
+				nscan = sscanf(line, "Lon: %lf	 Lat: %lf Depth: %lf meters", &mb_info->lon_end, &mb_info->lat_end,
+				               &mb_info->depth_end);
+			}
+			if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
+				nscan = sscanf(line, "Speed: %lf km/hr ( %lf knots)  Heading: %lf degrees", &mb_info->speed_end, &speedkts,
+				               &mb_info->heading_end);
+			}
+			if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
+				nscan = sscanf(line, "Sonar Depth:  %lf m  Sonar Altitude:   %lf m", &mb_info->sensordepth_end,
+				               &mb_info->sonaraltitude_end);
+			}
+		}
+
+		else if (strncmp(line, "Minimum Longitude:", 18) == 0)
+			sscanf(line, "Minimum Longitude: %lf Maximum Longitude: %lf", &mb_info->lon_min, &mb_info->lon_max);
+		else if (strncmp(line, "Minimum Latitude:", 17) == 0)
+			sscanf(line, "Minimum Latitude: %lf Maximum Latitude: %lf", &mb_info->lat_min, &mb_info->lat_max);
+
+		else if (strncmp(line, "Minimum Sonar Depth:", 20) == 0)
+			sscanf(line, "Minimum Sonar Depth: %lf Maximum Sonar Depth: %lf", &mb_info->sensordepth_min,
+			       &mb_info->sensordepth_max);
+
+		else if (strncmp(line, "Minimum Altitude:", 17) == 0)
+			sscanf(line, "Minimum Altitude: %lf Maximum Altitude: %lf", &mb_info->altitude_min, &mb_info->altitude_max);
+
+		else if (strncmp(line, "Minimum Depth:", 14) == 0)
+			sscanf(line, "Minimum Depth: %lf Maximum Depth: %lf", &mb_info->depth_min, &mb_info->depth_max);
+
+		else if (strncmp(line, "Minimum Amplitude:", 18) == 0)
+			sscanf(line, "Minimum Amplitude: %lf Maximum Amplitude: %lf", &mb_info->amp_min, &mb_info->amp_max);
+
+		else if (strncmp(line, "Minimum Sidescan:", 17) == 0)
+			sscanf(line, "Minimum Sidescan: %lf Maximum Sidescan: %lf", &mb_info->ss_min, &mb_info->ss_max);
+
+		else if (strncmp(line, "PN:", 3) == 0) {
+			sscanf(line, "PN: %d DATA PROBLEM (ID=%d):", &nproblem, &problemid);
+			if (problemid == MB_PROBLEM_NO_DATA)
+				mb_info->problem_nodata += nproblem;
+			else if (problemid == MB_PROBLEM_ZERO_NAV)
+				mb_info->problem_zeronav += nproblem;
+			else if (problemid == MB_PROBLEM_TOO_FAST)
+				mb_info->problem_toofast += nproblem;
+			else if (problemid == MB_PROBLEM_AVG_TOO_FAST)
+				mb_info->problem_avgtoofast += nproblem;
+			else if (problemid == MB_PROBLEM_TOO_DEEP)
+				mb_info->problem_toodeep += nproblem;
+			else if (problemid == MB_PROBLEM_BAD_DATAGRAM)
+				mb_info->problem_baddatagram += nproblem;
+		}
+
+		else if (strncmp(line, "CM dimensions:", 14) == 0) {
+			int mask_nx = 0;
+			int mask_ny = 0;
+			sscanf(line, "CM dimensions: %d %d", &mask_nx, &mask_ny);
+			if (mask_nx > 0 && mask_ny > 0) {
+				record->mask_nx = MIN(mask_nx, MB_INFO_CACHE_MASK_MAX);
+				record->mask_ny = MIN(mask_ny, MB_INFO_CACHE_MASK_MAX);
+			}
+			for (int j = mask_ny - 1; j >= 0; j--) {
+				if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL && mask_nx > 0) {
+					startptr = &line[6];
+					const int jj = (int)(((long)j * record->mask_ny) / mask_ny);
+					for (int i = 0; i < mask_nx; i++) {
+						char *endptr = NULL;
+						const long value = strtol(startptr, &endptr, 0);
+						startptr = endptr;
+						if (value == 1) {
+							const int k = (int)(((long)i * record->mask_nx) / mask_nx) + jj * record->mask_nx;
+							record->mask[k / 8] |= (unsigned char)(1 << (k % 8));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+/*--------------------------------------------------------------------*/
+/*
+ * mb_info_cache_load gets the cache record for a swath file, either from
+ * the ".inb" sidecar if it is current or by parsing the ".inf" file, in
+ * which case the sidecar is rewritten.
+ */
+static int mb_info_cache_load(int verbose, const char *file, struct mb_info_cache_record_struct *record, int *error) {
+	/* get info file path */
+	char file_inf[MB_PATH_MAXLINE + 4];
+	snprintf(file_inf, sizeof(file_inf), "%s.inf", file);
+
+	int64_t inf_mtime;
+	int64_t inf_size;
+	if (!mb_info_cache_stat(file_inf, &inf_mtime, &inf_size)) {
+		*error = MB_ERROR_OPEN_FAIL;
+		return (MB_FAILURE);
+	}
+	const uint64_t path_hash = mb_info_cache_hash(file);
+
+	/* use the sidecar if it matches the inf file */
+	char file_inb[MB_PATH_MAXLINE + sizeof(MB_INFO_CACHE_SUFFIX)];
+	snprintf(file_inb, sizeof(file_inb), "%s%s", file, MB_INFO_CACHE_SUFFIX);
+	FILE *fp = fopen(file_inb, "rb");
+	if (fp != NULL) {
+		struct mb_info_cache_header_struct header;
+		const bool ok = fread(&header, sizeof(header), 1, fp) == 1 && mb_info_cache_header_ok(&header) &&
+		                header.nrecord == 1 && fread(record, sizeof(struct mb_info_cache_record_struct), 1, fp) == 1;
+		fclose(fp);
+		if (ok && record->path_hash == path_hash && record->inf_mtime == inf_mtime && record->inf_size == inf_size) {
+			*error = MB_ERROR_NO_ERROR;
+			return (MB_SUCCESS);
+		}
+	}
+
+	/* else parse the inf file */
+	if ((fp = fopen(file_inf, "r")) == NULL) {
+		*error = MB_ERROR_OPEN_FAIL;
+		return (MB_FAILURE);
+	}
+	memset(record, 0, sizeof(struct mb_info_cache_record_struct));
+	struct mb_info_struct mb_info;
+	mb_info_parse(verbose, fp, &mb_info, record);
+	fclose(fp);
+	record->path_hash = path_hash;
+	record->inf_mtime = inf_mtime;
+	record->inf_size = inf_size;
+	memcpy(record->info, (const char *)&mb_info + MB_INFO_CACHE_INFO_OFFSET, MB_INFO_CACHE_INFO_SIZE);
+
+	/* only cache inf files that cannot be rewritten within the same second */
+	if (inf_mtime + 1 < (int64_t)time(NULL))
+		mb_info_cache_write(verbose, file_inb, record, 1);
+	else
+		record->inf_mtime = -1;
+
+	*error = MB_ERROR_NO_ERROR;
+	return (MB_SUCCESS);
+}
+/*--------------------------------------------------------------------*/
+/*
+ * mb_info_cache_unpack copies the cached inf contents into mb_info and
+ * applies lonflip, leaving nrecords at -1 if the inf file listed none
+ */
+static void mb_info_cache_unpack(const char *file, const struct mb_info_cache_record_struct *record, int lonflip,
+                                 struct mb_info_struct *mb_info) {
+	memcpy((char *)mb_info + MB_INFO_CACHE_INFO_OFFSET, record->info, MB_INFO_CACHE_INFO_SIZE);
+	mb_info->loaded = false;
+	strcpy(mb_info->file, file);
+
+	/* apply lonflip if needed */
+	if (lonflip == -1 && mb_info->lon_min > 0.0) {
+		mb_info->lon_min -= 360.0;
+		mb_info->lon_max -= 360.0;
+		mb_info->lon_start -= 360.0;
+		mb_info->lon_end -= 360.0;
+	}
+	else if (lonflip == 0 && mb_info->lon_max < -180.0) {
+		mb_info->lon_min += 360.0;
+		mb_info->lon_max += 360.0;
+		mb_info->lon_start += 360.0;
+		mb_info->lon_end += 360.0;
+	}
+	else if (lonflip == 0 && mb_info->lon_min > 180.0) {
+		mb_info->lon_min -= 360.0;
+		mb_info->lon_max -= 360.0;
+		mb_info->lon_start -= 360.0;
+		mb_info->lon_end -= 360.0;
+	}
+	else if (lonflip == 1 && mb_info->lon_max < 0.0) {
+		mb_info->lon_min += 360.0;
+		mb_info->lon_max += 360.0;
+		mb_info->lon_start += 360.0;
+		mb_info->lon_end += 360.0;
+	}
+}
 /*--------------------------------------------------------------------*/
 int mb_check_info(int verbose, char *file, int lonflip, double bounds[4], bool *file_in_bounds, int *error) {
 	if (verbose >= 2) {
@@ -74,75 +537,21 @@ int mb_check_info(int verbose, char *file, int lonflip, double bounds[4], bool *
 
 	/* check for inf file */
 	else {
-		/* get info file path */
-		char file_inf[MB_PATH_MAXLINE];
-		strcpy(file_inf, file);
-		strcat(file_inf, ".inf");
-
-		/* open if possible */
-		FILE *fp = fopen(file_inf, "r");
-		if (fp != NULL) {
-			/* initialize the parameters */
-			int nrecords = -1;
-			double lon_min = 0.0;
-			double lon_max = 0.0;
-			double lat_min = 0.0;
-			double lat_max = 0.0;
-			int mask_nx = 0;
-			int mask_ny = 0;
-		  int *mask = NULL;
-
-			/* read the inf file */
-			char line[MB_PATH_MAXLINE];
-			while (fgets(line, MB_PATH_MAXLINE, fp) != NULL) {
-				if (strncmp(line, "Number of Records:", 18) == 0) {
-					int nrecords_read;
-					const int nscan = sscanf(line, "Number of Records: %d", &nrecords_read);
-					if (nscan == 1)
-						nrecords = nrecords_read;
-				}
-				else if (strncmp(line, "Minimum Longitude:", 18) == 0)
-					sscanf(line, "Minimum Longitude: %lf Maximum Longitude: %lf", &lon_min, &lon_max);
-				else if (strncmp(line, "Minimum Latitude:", 17) == 0)
-					sscanf(line, "Minimum Latitude: %lf Maximum Latitude: %lf", &lat_min, &lat_max);
-				else if (strncmp(line, "CM dimensions:", 14) == 0) {
-					sscanf(line, "CM dimensions: %d %d", &mask_nx, &mask_ny);
-					status = mb_mallocd(verbose, __FILE__, __LINE__, mask_nx * mask_ny * sizeof(int), (void **)&mask, error);
-					for (int j = mask_ny - 1; j >= 0; j--) {
-						char *startptr = NULL;
-						if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
-							startptr = &line[6];
-							for (int i = 0; i < mask_nx; i++) {
-								int k = i + j * mask_nx;
-								char *endptr = NULL;
-								mask[k] = strtol(startptr, &endptr, 0);
-								startptr = endptr;
-							}
-						}
-					}
-				}
-			}
+		/* load the inf file contents if possible */
+		struct mb_info_cache_record_struct record;
+		if (mb_info_cache_load(verbose, file, &record, error) == MB_SUCCESS) {
+			struct mb_info_struct mb_info;
+			mb_info_cache_unpack(file, &record, lonflip, &mb_info);
+			const int nrecords = mb_info.nrecords;
+			const double lon_min = mb_info.lon_min;
+			const double lon_max = mb_info.lon_max;
+			const double lat_min = mb_info.lat_min;
+			const double lat_max = mb_info.lat_max;
+			const int mask_nx = record.mask_nx;
+			const int mask_ny = record.mask_ny;
 
 			/* check bounds if there is data */
 			if (nrecords > 0) {
-				/* set lon lat min max according to lonflip */
-				if (lonflip == -1 && lon_min > 0.0) {
-					lon_min -= 360.0;
-					lon_max -= 360.0;
-				}
-				else if (lonflip == 0 && lon_max < -180.0) {
-					lon_min += 360.0;
-					lon_max += 360.0;
-				}
-				else if (lonflip == 0 && lon_min > 180.0) {
-					lon_min -= 360.0;
-					lon_max -= 360.0;
-				}
-				else if (lonflip == 1 && lon_max < 0.0) {
-					lon_min += 360.0;
-					lon_max += 360.0;
-				}
-
 				/* check for lonflip conflict with bounds */
 				if (lon_min > lon_max || lat_min > lat_max)
 					*file_in_bounds = true;
@@ -154,13 +563,12 @@ int mb_check_info(int verbose, char *file, int lonflip, double bounds[4], bool *
 					const double mask_dy = (lat_max - lat_min) / mask_ny;
 					for (int i = 0; i < mask_nx && !*file_in_bounds; i++)
 						for (int j = 0; j < mask_ny && !*file_in_bounds; j++) {
-							int k = i + j * mask_nx;
 							const double lonwest = lon_min + i * mask_dx;
 							const double loneast = lonwest + mask_dx;
 							const double latsouth = lat_min + j * mask_dy;
 							const double latnorth = latsouth + mask_dy;
-							if (mask[k] == 1 && lonwest < bounds[1] && loneast > bounds[0] && latsouth < bounds[3] &&
-							    latnorth > bounds[2])
+							if (mb_info_cache_mask_get(&record, i, j) && lonwest < bounds[1] && loneast > bounds[0] &&
+							    latsouth < bounds[3] && latnorth > bounds[2])
 								*file_in_bounds = true;
 						}
 				}
@@ -199,14 +607,6 @@ int mb_check_info(int verbose, char *file, int lonflip, double bounds[4], bool *
 				if (verbose >= 4)
 					fprintf(stderr, "dbg4  No data listed in inf file so cannot check bounds...\n");
 			}
-
-    /* free the mask array */
-    if (mask_nx > 0 && mask_ny > 0 && mask != NULL) {
-      	mb_freed(verbose, __FILE__, __LINE__, (void **)&mask, error);
-    }
-
-			/* close the file */
-			fclose(fp);
 		}
 
 		/* if no inf file assume file has data in bounds */
@@ -247,21 +647,16 @@ int mb_get_info(int verbose, char *file, struct mb_info_struct *mb_info, int lon
 	/* initialize the parameters */
 	mb_info_init(verbose, mb_info, error);
 
-	/* get info file path */
-	char file_inf[MB_PATH_MAXLINE];
-	strcpy(file_inf, file);
-	strcat(file_inf, ".inf");
-
-	/* open if possible */
+	/* load the inf file contents if possible */
 	int status = MB_SUCCESS;
-	FILE *fp = fopen(file_inf, "r");
-	if (fp == NULL) {
+	struct mb_info_cache_record_struct record;
+	if (mb_info_cache_load(verbose, file, &record, error) != MB_SUCCESS) {
 		/* set error */
 		*error = MB_ERROR_OPEN_FAIL;
 		status = MB_FAILURE;
 
 		if (verbose >= 2) {
-			fprintf(stderr, "dbg2  Cannot open requested inf file: %s\n", file_inf);
+			fprintf(stderr, "dbg2  Cannot open requested inf file: %s.inf\n", file);
 		}
 
   	if (verbose >= 2) {
@@ -277,196 +672,10 @@ int mb_get_info(int verbose, char *file, struct mb_info_struct *mb_info, int lon
   	return (status);
 	}
 
-	/* load information from inf file */
-	else {
-		/* set file name */
-		strcpy(mb_info->file, file);
-
-		/* read the inf file */
-		char line[MB_PATH_MAXLINE];
-		while (fgets(line, MB_PATH_MAXLINE, fp) != NULL) {
-			char *startptr;
-			int nscan;
-			int nproblem;
-			int problemid;
-			double speedkts;
-			if (strncmp(line, "Number of Records:", 18) == 0) {
-				nscan = sscanf(line, "Number of Records: %d", &mb_info->nrecords);
-			}
-			else if (strncmp(line, "Number of Subbottom Records:", 28) == 0) {
-				nscan = sscanf(line, "Number of Subbottom Records: %d", &mb_info->nrecords_sbp);
-			}
-			else if (strncmp(line, "Number of Secondary Sidescan Records:", 37) == 0) {
-				nscan = sscanf(line, "Number of Secondary Sidescan Records: %d", &mb_info->nrecords_ss1);
-			}
-			else if (strncmp(line, "Number of Tertiary Sidescan Records:", 36) == 0) {
-				nscan = sscanf(line, "Number of Tertiary Sidescan Records: %d", &mb_info->nrecords_ss2);
-			}
-
-			else if (strncmp(line, "Bathymetry Data (", 17) == 0) {
-				nscan = sscanf(line, "Bathymetry Data (%d beams):", &mb_info->nbeams_bath);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Beams: %d", &mb_info->nbeams_bath_total);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Good Beams: %d", &mb_info->nbeams_bath_good);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Zero Beams: %d", &mb_info->nbeams_bath_zero);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Flagged Beams: %d", &mb_info->nbeams_bath_flagged);
-			}
-
-			else if (strncmp(line, "Amplitude Data (", 16) == 0) {
-				nscan = sscanf(line, "Amplitude Data (%d beams):", &mb_info->nbeams_amp);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Beams: %d", &mb_info->nbeams_amp_total);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Good Beams: %d", &mb_info->nbeams_amp_good);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Zero Beams: %d", &mb_info->nbeams_amp_zero);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Flagged Beams: %d", &mb_info->nbeams_amp_flagged);
-			}
-
-			else if (strncmp(line, "Sidescan Data (", 15) == 0) {
-				nscan = sscanf(line, "Sidescan Data (%d pixels):", &mb_info->npixels_ss);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Pixels: %d", &mb_info->npixels_ss_total);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Good Pixels: %d", &mb_info->npixels_ss_good);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Zero Pixels: %d", &mb_info->npixels_ss_zero);
-				if (fgets(line, MB_PATH_MAXLINE, fp) != NULL)
-					nscan = sscanf(line, "  Number of Flagged Pixels: %d", &mb_info->npixels_ss_flagged);
-			}
-
-			else if (strncmp(line, "Total Time:", 11) == 0) {
-				nscan = sscanf(line, "Total Time: %lf hours", &mb_info->time_total);
-			}
-			else if (strncmp(line, "Total Track Length:", 19) == 0) {
-				nscan = sscanf(line, "Total Track Length: %lf km", &mb_info->dist_total);
-			}
-			else if (strncmp(line, "Average Speed:", 14) == 0) {
-				nscan = sscanf(line, "Average Speed: %lf km/hr", &mb_info->speed_avg);
-			}
-
-			else if (strncmp(line, "Start of Data:", 14) == 0) {
-				if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
-					int time_i[7];
-					nscan = sscanf(line, "Time:  %d %d %d %d:%d:%d.%d  JD", &time_i[1], &time_i[2], &time_i[0], &time_i[3],
-					               &time_i[4], &time_i[5], &time_i[6]);
-					if (nscan == 7)
-						mb_get_time(verbose, time_i, &(mb_info->time_start));
-				}
-				if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
-					nscan = sscanf(line, "Lon: %lf	 Lat: %lf Depth: %lf meters", &mb_info->lon_start, &mb_info->lat_start,
-					               &mb_info->depth_start);
-				}
-				if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
-					nscan = sscanf(line, "Speed: %lf km/hr ( %lf knots)  Heading: %lf degrees", &mb_info->speed_start, &speedkts,
-					               &mb_info->heading_start);
-				}
-				if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
-					nscan = sscanf(line, "Sonar Depth:  %lf m  Sonar Altitude:   %lf m", &mb_info->sensordepth_start,
-					               &mb_info->sonaraltitude_start);
-				}
-			}
-
-			else if (strncmp(line, "End of Data:", 12) == 0) {
-				if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
-					int time_i[7];
-					nscan = sscanf(line, "Time:  %d %d %d %d:%d:%d.%d  JD", &time_i[1], &time_i[2], &time_i[0], &time_i[3],
-					               &time_i[4], &time_i[5], &time_i[6]);
-					if (nscan == 7)
-						mb_get_time(verbose, time_i, &(mb_info->time_end));
-				}
-				if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
-					nscan = sscanf(line, "Lon: %lf	 Lat: %lf Depth: %lf meters", &mb_info->lon_end, &mb_info->lat_end,
-					               &mb_info->depth_end);
-				}
-				if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
-					nscan = sscanf(line, "Speed: %lf km/hr ( %lf knots)  Heading: %lf degrees", &mb_info->speed_end, &speedkts,
-					               &mb_info->heading_end);
-				}
-				if ((startptr = fgets(line, MB_PATH_MAXLINE, fp)) != NULL) {
-					nscan = sscanf(line, "Sonar Depth:  %lf m  Sonar Altitude:   %lf m", &mb_info->sensordepth_end,
-					               &mb_info->sonaraltitude_end);
-				}
-			}
-
-			else if (strncmp(line, "Minimum Longitude:", 18) == 0)
-				sscanf(line, "Minimum Longitude: %lf Maximum Longitude: %lf", &mb_info->lon_min, &mb_info->lon_max);
-			else if (strncmp(line, "Minimum Latitude:", 17) == 0)
-				sscanf(line, "Minimum Latitude: %lf Maximum Latitude: %lf", &mb_info->lat_min, &mb_info->lat_max);
-
-			else if (strncmp(line, "Minimum Sonar Depth:", 20) == 0)
-				sscanf(line, "Minimum Sonar Depth: %lf Maximum Sonar Depth: %lf", &mb_info->sensordepth_min,
-				       &mb_info->sensordepth_max);
-
-			else if (strncmp(line, "Minimum Altitude:", 17) == 0)
-				sscanf(line, "Minimum Altitude: %lf Maximum Altitude: %lf", &mb_info->altitude_min, &mb_info->altitude_max);
-
-			else if (strncmp(line, "Minimum Depth:", 14) == 0)
-				sscanf(line, "Minimum Depth: %lf Maximum Depth: %lf", &mb_info->depth_min, &mb_info->depth_max);
-
-			else if (strncmp(line, "Minimum Amplitude:", 18) == 0)
-				sscanf(line, "Minimum Amplitude: %lf Maximum Amplitude: %lf", &mb_info->amp_min, &mb_info->amp_max);
-
-			else if (strncmp(line, "Minimum Sidescan:", 17) == 0)
-				sscanf(line, "Minimum Sidescan: %lf Maximum Sidescan: %lf", &mb_info->ss_min, &mb_info->ss_max);
-
-			else if (strncmp(line, "PN:", 3) == 0) {
-				sscanf(line, "PN: %d DATA PROBLEM (ID=%d):", &nproblem, &problemid);
-				if (problemid == MB_PROBLEM_NO_DATA)
-					mb_info->problem_nodata += nproblem;
-				else if (problemid == MB_PROBLEM_ZERO_NAV)
-					mb_info->problem_zeronav += nproblem;
-				else if (problemid == MB_PROBLEM_TOO_FAST)
-					mb_info->problem_toofast += nproblem;
-				else if (problemid == MB_PROBLEM_AVG_TOO_FAST)
-					mb_info->problem_avgtoofast += nproblem;
-				else if (problemid == MB_PROBLEM_TOO_DEEP)
-					mb_info->problem_toodeep += nproblem;
-				else if (problemid == MB_PROBLEM_BAD_DATAGRAM)
-					mb_info->problem_baddatagram += nproblem;
-			}
-
-			else if (strncmp(line, "CM dimensions:", 14) == 0) {
-				int mask_nx;
-				int mask_ny;
-				sscanf(line, "CM dimensions: %d %d", &mask_nx, &mask_ny);
-				for (int j = 0; j < mask_ny; j++)
-					startptr = fgets(line, MB_PATH_MAXLINE, fp);
-			}
-		}
-
-		fclose(fp);
-
-		/* apply lonflip if needed */
-		if (lonflip == -1 && mb_info->lon_min > 0.0) {
-			mb_info->lon_min -= 360.0;
-			mb_info->lon_max -= 360.0;
-			mb_info->lon_start -= 360.0;
-			mb_info->lon_end -= 360.0;
-		}
-		else if (lonflip == 0 && mb_info->lon_max < -180.0) {
-			mb_info->lon_min += 360.0;
-			mb_info->lon_max += 360.0;
-			mb_info->lon_start += 360.0;
-			mb_info->lon_end += 360.0;
-		}
-		else if (lonflip == 0 && mb_info->lon_min > 180.0) {
-			mb_info->lon_min -= 360.0;
-			mb_info->lon_max -= 360.0;
-			mb_info->lon_start -= 360.0;
-			mb_info->lon_end -= 360.0;
-		}
-		else if (lonflip == 1 && mb_info->lon_max < 0.0) {
-			mb_info->lon_min += 360.0;
-			mb_info->lon_max += 360.0;
-			mb_info->lon_start += 360.0;
-			mb_info->lon_end += 360.0;
-		}
-	}
+	/* set the information, treating an unlisted record count as zero */
+	mb_info_cache_unpack(file, &record, lonflip, mb_info);
+	if (mb_info->nrecords < 0)
+		mb_info->nrecords = 0;
 
 	/* set error and status (if you got here you succeeded */
 	*error = MB_ERROR_NO_ERROR;
@@ -602,6 +811,904 @@ bool mb_should_make_fnv(int verbose, int format) {
 }
 /*--------------------------------------------------------------------*/
 
+/*
+ * The ancillary files are made in process rather than by running other
+ * programs, so that mb_make_info() may be called concurrently from several
+ * threads. The same functions serve the programs when they are asked for
+ * these files:
+ *   mb_make_info_inf()  mbinfo -F format -I file -G -N -O -M10/10
+ *   mb_make_info_fbt()  mbcopy -F format/71 -I file -D -O file.fbt
+ *   mb_make_info_fnv()  mblist -F format -I file -O%fnv -UN
+ */
+#define MB_MAKE_INFO_SPEED_THRESHOLD 50.0
+
+/* apply a changed lonflip to longitudes already read */
+static void mb_make_info_lonflip(int lonflip, double *lon) {
+	if (lonflip == -1) {
+		if (*lon > 0.0)
+			*lon -= 360.0;
+	}
+	else if (lonflip == 1) {
+		if (*lon < 0.0)
+			*lon += 360.0;
+	}
+	else {
+		if (*lon < -180.0)
+			*lon += 360.0;
+		if (*lon > 180.0)
+			*lon -= 360.0;
+	}
+}
+/*--------------------------------------------------------------------*/
+int mb_make_info_inf(int verbose, char *file, int format, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       file:       %s\n", file);
+		fprintf(stderr, "dbg2       format:     %d\n", format);
+	}
+
+	int pings;
+	int lonflip;
+	double bounds[4];
+	int btime_i[7];
+	int etime_i[7];
+	double speedmin;
+	double timegap;
+	int format_default;
+	mb_defaults(verbose, &format_default, &pings, &lonflip, bounds, btime_i, etime_i, &speedmin, &timegap);
+	pings = 1;
+
+	char inffile[MB_PATH_MAXLINE];
+	snprintf(inffile, sizeof(inffile), "%s.inf", file);
+	FILE *output = fopen(inffile, "w");
+	if (output == NULL) {
+		*error = MB_ERROR_OPEN_FAIL;
+		return (MB_FAILURE);
+	}
+
+	int notice_list[MB_NOTICE_MAX];
+	for (int i = 0; i < MB_NOTICE_MAX; i++)
+		notice_list[i] = 0;
+	int timbeg_i[7] = {0, 0, 0, 0, 0, 0, 0};
+	int timend_i[7] = {0, 0, 0, 0, 0, 0, 0};
+	int timbeg_j[5];
+	int timend_j[5];
+	double lonmin = 0.0, lonmax = 0.0, latmin = 0.0, latmax = 0.0;
+	double sdpmin = 0.0, sdpmax = 0.0, altmin = 0.0, altmax = 0.0;
+	double bathmin = 0.0, bathmax = 0.0, ampmin = 0.0, ampmax = 0.0, ssmin = 0.0, ssmax = 0.0;
+	double bathbeg = 0.0, lonbeg = 0.0, latbeg = 0.0, spdbeg = 0.0, hdgbeg = 0.0, sdpbeg = 0.0, altbeg = 0.0;
+	double bathend = 0.0, lonend = 0.0, latend = 0.0, spdend = 0.0, hdgend = 0.0, sdpend = 0.0, altend = 0.0;
+	double timbeg = 0.0, timend = 0.0, timtot = 0.0, distot = 0.0, spdavg = 0.0;
+	int irec = 0;
+	int ntdbeams = 0, ngdbeams = 0, nzdbeams = 0, nfdbeams = 0;
+	int ntabeams = 0, ngabeams = 0, nzabeams = 0, nfabeams = 0;
+	int ntsbeams = 0, ngsbeams = 0, nzsbeams = 0, nfsbeams = 0;
+	int beams_bath_max = 0, beams_amp_max = 0, pixels_ss_max = 0;
+	bool beginnav = false, beginsdp = false, beginalt = false;
+	bool beginbath = false, beginamp = false, beginss = false;
+	bool lonflip_set = false;
+	bool imetadata = false;
+	bool meta_seen[18];
+	for (int i = 0; i < 18; i++)
+		meta_seen[i] = false;
+	double maskbounds[4] = {0.0, 0.0, 0.0, 0.0};
+	double mask_dx = 0.0;
+	double mask_dy = 0.0;
+	int mask[MB_MAKE_INFO_MASK_NX * MB_MAKE_INFO_MASK_NY];
+	for (int i = 0; i < MB_MAKE_INFO_MASK_NX * MB_MAKE_INFO_MASK_NY; i++)
+		mask[i] = 0;
+
+	/* the first pass gets the statistics, the second the coverage mask */
+	int status = MB_SUCCESS;
+	for (int pass = 0; pass < 2 && status == MB_SUCCESS; pass++) {
+		void *mbio_ptr = NULL;
+		double btime_d;
+		double etime_d;
+		int beams_bath_alloc;
+		int beams_amp_alloc;
+		int pixels_ss_alloc;
+		if (mb_read_init(verbose, file, format, pings, lonflip, bounds, btime_i, etime_i, speedmin, timegap, &mbio_ptr, &btime_d,
+		                 &etime_d, &beams_bath_alloc, &beams_amp_alloc, &pixels_ss_alloc, error) != MB_SUCCESS) {
+			status = MB_FAILURE;
+			break;
+		}
+		char *beamflag = NULL;
+		double *bath = NULL;
+		double *amp = NULL;
+		double *bathlon = NULL;
+		double *bathlat = NULL;
+		double *ss = NULL;
+		double *sslon = NULL;
+		double *sslat = NULL;
+		if (*error == MB_ERROR_NO_ERROR)
+			mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char), (void **)&beamflag, error);
+		if (*error == MB_ERROR_NO_ERROR)
+			mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bath, error);
+		if (*error == MB_ERROR_NO_ERROR)
+			mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double), (void **)&amp, error);
+		if (*error == MB_ERROR_NO_ERROR)
+			mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathlon, error);
+		if (*error == MB_ERROR_NO_ERROR)
+			mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathlat, error);
+		if (*error == MB_ERROR_NO_ERROR)
+			mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ss, error);
+		if (*error == MB_ERROR_NO_ERROR)
+			mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&sslon, error);
+		if (*error == MB_ERROR_NO_ERROR)
+			mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&sslat, error);
+		if (*error != MB_ERROR_NO_ERROR) {
+			int tmp_error;
+			mb_close(verbose, &mbio_ptr, &tmp_error);
+			status = MB_FAILURE;
+			break;
+		}
+
+		if (pass == 0) {
+			char *fileprint = strrchr(file, '/') == NULL ? file : strrchr(file, '/') + 1;
+			char format_description[MB_DESCRIPTION_LENGTH];
+			int tmp_error;
+			int format_use = format;
+			mb_format_description(verbose, &format_use, format_description, &tmp_error);
+			fprintf(output, "\nSwath Data File:      %s\n", fileprint);
+			fprintf(output, "MBIO Data Format ID:  %d\n", format_use);
+			fprintf(output, "%s", format_description);
+		}
+		else {
+			maskbounds[0] = lonmin;
+			maskbounds[1] = lonmax;
+			maskbounds[2] = latmin;
+			maskbounds[3] = latmax;
+			mask_dx = (maskbounds[1] - maskbounds[0]) / MB_MAKE_INFO_MASK_NX;
+			mask_dy = (maskbounds[3] - maskbounds[2]) / MB_MAKE_INFO_MASK_NY;
+		}
+
+		int irecfile = 0;
+		double timbegfile = 0.0;
+		double timendfile = 0.0;
+		double distotfile = 0.0;
+		double time_d_last = 0.0;
+		while (*error <= MB_ERROR_NO_ERROR) {
+			int kind;
+			int pings_read;
+			int time_i[7];
+			double time_d;
+			double navlon;
+			double navlat;
+			double speed;
+			double heading;
+			double distance;
+			double altitude;
+			double sensordepth;
+			int beams_bath = 0;
+			int beams_amp = 0;
+			int pixels_ss = 0;
+			char comment[MB_COMMENT_MAXLINE];
+			*error = MB_ERROR_NO_ERROR;
+			mb_read(verbose, mbio_ptr, &kind, &pings_read, time_i, &time_d, &navlon, &navlat, &speed, &heading, &distance,
+			        &altitude, &sensordepth, &beams_bath, &beams_amp, &pixels_ss, beamflag, bath, amp, bathlon, bathlat, ss, sslon,
+			        sslat, comment, error);
+			const bool good_record = *error == MB_ERROR_NO_ERROR || *error == MB_ERROR_TIME_GAP;
+
+			/* print metadata */
+			if (pass == 0 && *error == MB_ERROR_COMMENT && strncmp(comment, "META", 4) == 0) {
+				static const char *meta_tags[18] = {
+				    "METAVESSEL:", "METAINSTITUTION:", "METAPLATFORM:", "METASONARVERSION:", "METASONAR:", "METACRUISEID:",
+				    "METACRUISENAME:", "METAPI:", "METAPIINSTITUTION:", "METACLIENT:", "METASVCORRECTED:",
+				    "METATIDECORRECTED:", "METABATHEDITMANUAL:", "METABATHEDITAUTO:", "METAROLLBIAS:", "METAPITCHBIAS:",
+				    "METAHEADINGBIAS:", "METADRAFT:"};
+				static const char *meta_labels[18] = {
+				    "Vessel:                 ", "Institution:            ", "Platform:               ",
+				    "Sonar Version:          ", "Sonar:                  ", "Cruise ID:              ",
+				    "Cruise Name:            ", "PI:                     ", "PI Institution:         ",
+				    "Client:                 ", "Corrected Depths:       ", "Tide Corrected:         ",
+				    "Depths Manually Edited: ", "Depths Auto-Edited:     ", "Roll Bias:              ",
+				    "Pitch Bias:             ", "Heading Bias:           ", "Draft:                  "};
+				if (!imetadata) {
+					fprintf(output, "\nMetadata:\n");
+					imetadata = true;
+				}
+				for (int i = 0; i < 18; i++) {
+					const size_t len = strlen(meta_tags[i]);
+					if (strncmp(comment, meta_tags[i], len) == 0) {
+						const char *value = &comment[len];
+						if (!meta_seen[i]) {
+							if (i < 10) {
+								fprintf(output, "%s%s\n", meta_labels[i], value);
+							}
+							else if (i < 14) {
+								int val_int = 0;
+								sscanf(value, "%d", &val_int);
+								fprintf(output, "%s%s\n", meta_labels[i], val_int ? "YES" : "NO");
+							}
+							else {
+								double val_double = 0.0;
+								sscanf(value, "%lf", &val_double);
+								fprintf(output, "%s%f %s\n", meta_labels[i], val_double, i < 17 ? "degrees" : "m");
+							}
+						}
+						meta_seen[i] = true;
+						break;
+					}
+				}
+			}
+
+			beams_bath_max = MAX(beams_bath_max, beams_bath);
+			beams_amp_max = MAX(beams_amp_max, beams_amp);
+			pixels_ss_max = MAX(pixels_ss_max, pixels_ss);
+
+			double speed_apparent = 0.0;
+			if (pass == 0 && good_record) {
+				irec++;
+				irecfile++;
+				ntdbeams += beams_bath;
+				ntabeams += beams_amp;
+				ntsbeams += pixels_ss;
+
+				/* set lonflip from the first navigation */
+				if (!lonflip_set && (navlon != 0.0 || navlat != 0.0)) {
+					lonflip_set = true;
+					int lonflip_use = 0;
+					if (navlon >= -270.0 && navlon < -90.0)
+						lonflip_use = -1;
+					else if (navlon >= 90.0 && navlon < 270.0)
+						lonflip_use = 1;
+					if (lonflip_use != lonflip) {
+						struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+						mb_io_ptr->lonflip = lonflip_use;
+						lonflip = lonflip_use;
+						mb_make_info_lonflip(lonflip_use, &navlon);
+						for (int i = 0; i < beams_bath; i++)
+							mb_make_info_lonflip(lonflip_use, &bathlon[i]);
+						for (int i = 0; i < pixels_ss; i++)
+							mb_make_info_lonflip(lonflip_use, &sslon[i]);
+					}
+				}
+
+				/* get beginning values */
+				const int center = beams_bath / 2;
+				if (irec == 1) {
+					if (beams_bath > 0)
+						bathbeg = mb_beam_ok(beamflag[center]) ? bath[center] : altitude + sensordepth;
+					lonbeg = navlon;
+					latbeg = navlat;
+					timbeg = time_d;
+					timbegfile = time_d;
+					for (int i = 0; i < 7; i++)
+						timbeg_i[i] = time_i[i];
+					spdbeg = speed;
+					hdgbeg = heading;
+					sdpbeg = sensordepth;
+					altbeg = altitude;
+				}
+				else if (lonbeg == 0.0 && latbeg == 0.0 && navlon != 0.0 && navlat != 0.0) {
+					lonbeg = navlon;
+					if (beams_bath > 0)
+						bathbeg = mb_beam_ok(beamflag[center]) ? bath[center] : altitude + sensordepth;
+					latbeg = navlat;
+					if (spdbeg == 0.0 && speed != 0.0)
+						spdbeg = speed;
+					if (hdgbeg == 0.0 && heading != 0.0)
+						hdgbeg = heading;
+					if (sdpbeg == 0.0 && sensordepth != 0.0)
+						sdpbeg = sensordepth;
+					if (altbeg == 0.0 && altitude != 0.0)
+						altbeg = altitude;
+				}
+
+				/* reset ending values each time */
+				if (beams_bath > 0)
+					bathend = mb_beam_ok(beamflag[center]) ? bath[center] : altitude + sensordepth;
+				lonend = navlon;
+				latend = navlat;
+				spdend = speed;
+				hdgend = heading;
+				sdpend = sensordepth;
+				altend = altitude;
+				timend = time_d;
+				timendfile = time_d;
+				for (int i = 0; i < 7; i++)
+					timend_i[i] = time_i[i];
+
+				/* only use good navigation */
+				speed_apparent = 3600.0 * distance / (time_d - time_d_last);
+				bool good_nav = true;
+				if (navlon > -0.005 && navlon < 0.005 && navlat > -0.005 && navlat < 0.005)
+					good_nav = false;
+				else if (beginnav && speed_apparent >= MB_MAKE_INFO_SPEED_THRESHOLD)
+					good_nav = false;
+				if (good_nav && speed_apparent < MB_MAKE_INFO_SPEED_THRESHOLD) {
+					distot += distance;
+					distotfile += distance;
+				}
+
+				/* get starting mins and maxs */
+				if (!beginnav && good_nav) {
+					lonmin = navlon;
+					lonmax = navlon;
+					latmin = navlat;
+					latmax = navlat;
+					beginnav = true;
+				}
+				if (!beginsdp && sensordepth > 0.0) {
+					sdpmin = sensordepth;
+					sdpmax = sensordepth;
+					beginsdp = true;
+				}
+				if (!beginalt && altitude > 0.0) {
+					altmin = altitude;
+					altmax = altitude;
+					beginalt = true;
+				}
+				if (!beginbath)
+					for (int i = 0; i < beams_bath; i++)
+						if (mb_beam_ok(beamflag[i])) {
+							bathmin = bath[i];
+							bathmax = bath[i];
+							beginbath = true;
+						}
+				if (!beginamp)
+					for (int i = 0; i < beams_amp; i++)
+						if (mb_beam_ok(beamflag[i])) {
+							ampmin = amp[i];
+							ampmax = amp[i];
+							beginamp = true;
+						}
+				if (!beginss)
+					for (int i = 0; i < pixels_ss; i++)
+						if (ss[i] > MB_SIDESCAN_NULL) {
+							ssmin = ss[i];
+							ssmax = ss[i];
+							beginss = true;
+						}
+
+				/* get mins and maxs */
+				if (good_nav && beginnav) {
+					lonmin = MIN(lonmin, navlon);
+					lonmax = MAX(lonmax, navlon);
+					latmin = MIN(latmin, navlat);
+					latmax = MAX(latmax, navlat);
+				}
+				if (beginsdp) {
+					sdpmin = MIN(sdpmin, sensordepth);
+					sdpmax = MAX(sdpmax, sensordepth);
+				}
+				if (beginalt) {
+					altmin = MIN(altmin, altitude);
+					altmax = MAX(altmax, altitude);
+				}
+				for (int i = 0; i < beams_bath; i++) {
+					if (mb_beam_ok(beamflag[i])) {
+						if (good_nav && beginnav) {
+							lonmin = MIN(lonmin, bathlon[i]);
+							lonmax = MAX(lonmax, bathlon[i]);
+							latmin = MIN(latmin, bathlat[i]);
+							latmax = MAX(latmax, bathlat[i]);
+						}
+						bathmin = MIN(bathmin, bath[i]);
+						bathmax = MAX(bathmax, bath[i]);
+						ngdbeams++;
+					}
+					else if (beamflag[i] == MB_FLAG_NULL)
+						nzdbeams++;
+					else
+						nfdbeams++;
+				}
+				for (int i = 0; i < beams_amp; i++) {
+					if (mb_beam_ok(beamflag[i])) {
+						ampmin = MIN(ampmin, amp[i]);
+						ampmax = MAX(ampmax, amp[i]);
+						ngabeams++;
+					}
+					else if (beamflag[i] == MB_FLAG_NULL)
+						nzabeams++;
+					else
+						nfabeams++;
+				}
+				for (int i = 0; i < pixels_ss; i++) {
+					if (ss[i] > MB_SIDESCAN_NULL) {
+						if (good_nav && beginnav) {
+							lonmin = MIN(lonmin, sslon[i]);
+							lonmax = MAX(lonmax, sslon[i]);
+							latmin = MIN(latmin, sslat[i]);
+							latmax = MAX(latmax, sslat[i]);
+						}
+						ssmin = MIN(ssmin, ss[i]);
+						ssmax = MAX(ssmax, ss[i]);
+						ngsbeams++;
+					}
+					else if (ss[i] == 0.0)
+						nzsbeams++;
+					else
+						nfsbeams++;
+				}
+
+				/* look for problems */
+				if (navlon == 0.0 || navlat == 0.0)
+					mb_notice_log_problem(verbose, mbio_ptr, MB_PROBLEM_ZERO_NAV);
+				else if (beginnav && speed_apparent >= MB_MAKE_INFO_SPEED_THRESHOLD)
+					mb_notice_log_problem(verbose, mbio_ptr, MB_PROBLEM_TOO_FAST);
+				for (int i = 0; i < beams_bath; i++)
+					if (mb_beam_ok(beamflag[i]) && bath[i] > 11000.0)
+						mb_notice_log_problem(verbose, mbio_ptr, MB_PROBLEM_TOO_DEEP);
+
+				time_d_last = time_d;
+			}
+
+			/* update coverage mask */
+			if (pass == 1 && good_record && mask_dx > 0.0 && mask_dy > 0.0) {
+				int ix = (int)((navlon - maskbounds[0]) / mask_dx);
+				int iy = (int)((navlat - maskbounds[2]) / mask_dy);
+				if (ix >= 0 && ix < MB_MAKE_INFO_MASK_NX && iy >= 0 && iy < MB_MAKE_INFO_MASK_NY)
+					mask[ix + iy * MB_MAKE_INFO_MASK_NX] = 1;
+				for (int i = 0; i < beams_bath; i++) {
+					if (mb_beam_ok(beamflag[i])) {
+						ix = (int)((bathlon[i] - maskbounds[0]) / mask_dx);
+						iy = (int)((bathlat[i] - maskbounds[2]) / mask_dy);
+						if (ix >= 0 && ix < MB_MAKE_INFO_MASK_NX && iy >= 0 && iy < MB_MAKE_INFO_MASK_NY)
+							mask[ix + iy * MB_MAKE_INFO_MASK_NX] = 1;
+					}
+				}
+				for (int i = 0; i < pixels_ss; i++) {
+					if (ss[i] > MB_SIDESCAN_NULL) {
+						ix = (int)((sslon[i] - maskbounds[0]) / mask_dx);
+						iy = (int)((sslat[i] - maskbounds[2]) / mask_dy);
+						if (ix >= 0 && ix < MB_MAKE_INFO_MASK_NX && iy >= 0 && iy < MB_MAKE_INFO_MASK_NY)
+							mask[ix + iy * MB_MAKE_INFO_MASK_NX] = 1;
+					}
+				}
+			}
+		}
+
+		/* look for problems and get the notices */
+		if (pass == 0) {
+			const double timtotfile = (timendfile - timbegfile) / 3600.0;
+			if (irecfile <= 0)
+				mb_notice_log_problem(verbose, mbio_ptr, MB_PROBLEM_NO_DATA);
+			else if (timtotfile > 0.0 && distotfile / timtotfile >= MB_MAKE_INFO_SPEED_THRESHOLD)
+				mb_notice_log_problem(verbose, mbio_ptr, MB_PROBLEM_AVG_TOO_FAST);
+			mb_notice_get_list(verbose, mbio_ptr, notice_list);
+		}
+
+		*error = MB_ERROR_NO_ERROR;
+		status = mb_close(verbose, &mbio_ptr, error);
+	}
+
+	if (status == MB_SUCCESS) {
+		const double ngd_percent = ntdbeams > 0 ? 100.0 * ngdbeams / ntdbeams : 0.0;
+		const double nzd_percent = ntdbeams > 0 ? 100.0 * nzdbeams / ntdbeams : 0.0;
+		const double nfd_percent = ntdbeams > 0 ? 100.0 * nfdbeams / ntdbeams : 0.0;
+		const double nga_percent = ntabeams > 0 ? 100.0 * ngabeams / ntabeams : 0.0;
+		const double nza_percent = ntabeams > 0 ? 100.0 * nzabeams / ntabeams : 0.0;
+		const double nfa_percent = ntabeams > 0 ? 100.0 * nfabeams / ntabeams : 0.0;
+		const double ngs_percent = ntsbeams > 0 ? 100.0 * ngsbeams / ntsbeams : 0.0;
+		const double nzs_percent = ntsbeams > 0 ? 100.0 * nzsbeams / ntsbeams : 0.0;
+		const double nfs_percent = ntsbeams > 0 ? 100.0 * nfsbeams / ntsbeams : 0.0;
+		timtot = (timend - timbeg) / 3600.0;
+		if (timtot > 0.0)
+			spdavg = distot / timtot;
+		mb_get_jtime(verbose, timbeg_i, timbeg_j);
+		mb_get_jtime(verbose, timend_i, timend_j);
+
+		fprintf(output, "\nData Totals:\n");
+		fprintf(output, "Number of Records:                    %8d\n", irec);
+		const int isbtmrec = notice_list[MB_DATA_SUBBOTTOM_MCS] + notice_list[MB_DATA_SUBBOTTOM_CNTRBEAM] +
+		                     notice_list[MB_DATA_SUBBOTTOM_SUBBOTTOM];
+		if (isbtmrec > 0)
+			fprintf(output, "Number of Subbottom Records:          %8d\n", isbtmrec);
+		if (notice_list[MB_DATA_SIDESCAN2] > 0)
+			fprintf(output, "Number of Secondary Sidescan Records: %8d\n", notice_list[MB_DATA_SIDESCAN2]);
+		if (notice_list[MB_DATA_SIDESCAN3] > 0)
+			fprintf(output, "Number of Tertiary Sidescan Records:  %8d\n", notice_list[MB_DATA_SIDESCAN3]);
+		if (notice_list[MB_DATA_WATER_COLUMN] > 0)
+			fprintf(output, "Number of Water Column Records:       %8d\n", notice_list[MB_DATA_WATER_COLUMN]);
+		fprintf(output, "Bathymetry Data (%d beams):\n", beams_bath_max);
+		fprintf(output, "  Number of Beams:         %8d\n", ntdbeams);
+		fprintf(output, "  Number of Good Beams:    %8d     %5.2f%%\n", ngdbeams, ngd_percent);
+		fprintf(output, "  Number of Zero Beams:    %8d     %5.2f%%\n", nzdbeams, nzd_percent);
+		fprintf(output, "  Number of Flagged Beams: %8d     %5.2f%%\n", nfdbeams, nfd_percent);
+		fprintf(output, "Amplitude Data (%d beams):\n", beams_amp_max);
+		fprintf(output, "  Number of Beams:         %8d\n", ntabeams);
+		fprintf(output, "  Number of Good Beams:    %8d     %5.2f%%\n", ngabeams, nga_percent);
+		fprintf(output, "  Number of Zero Beams:    %8d     %5.2f%%\n", nzabeams, nza_percent);
+		fprintf(output, "  Number of Flagged Beams: %8d     %5.2f%%\n", nfabeams, nfa_percent);
+		fprintf(output, "Sidescan Data (%d pixels):\n", pixels_ss_max);
+		fprintf(output, "  Number of Pixels:        %8d\n", ntsbeams);
+		fprintf(output, "  Number of Good Pixels:   %8d     %5.2f%%\n", ngsbeams, ngs_percent);
+		fprintf(output, "  Number of Zero Pixels:   %8d     %5.2f%%\n", nzsbeams, nzs_percent);
+		fprintf(output, "  Number of Flagged Pixels:%8d     %5.2f%%\n", nfsbeams, nfs_percent);
+		fprintf(output, "\nNavigation Totals:\n");
+		fprintf(output, "Total Time:         %10.4f hours\n", timtot);
+		fprintf(output, "Total Track Length: %10.4f km\n", distot);
+		fprintf(output, "Average Speed:      %10.4f km/hr (%7.4f knots)\n", spdavg, spdavg / 1.85);
+		fprintf(output, "\nStart of Data:\n");
+		fprintf(output, "Time:  %2.2d %2.2d %4.4d %2.2d:%2.2d:%2.2d.%6.6d  JD%d (%4.4d-%2.2d-%2.2dT%2.2d:%2.2d:%2.2d.%6.6d)\n",
+		        timbeg_i[1], timbeg_i[2], timbeg_i[0], timbeg_i[3], timbeg_i[4], timbeg_i[5], timbeg_i[6], timbeg_j[1],
+		        timbeg_i[0], timbeg_i[1], timbeg_i[2], timbeg_i[3], timbeg_i[4], timbeg_i[5], timbeg_i[6]);
+		fprintf(output, "Lon: %15.9f     Lat: %15.9f     Depth: %10.4f meters\n", lonbeg, latbeg, bathbeg);
+		fprintf(output, "Speed: %7.4f km/hr (%7.4f knots)  Heading:%9.4f degrees\n", spdbeg, spdbeg / 1.85, hdgbeg);
+		fprintf(output, "Sonar Depth:%10.4f m  Sonar Altitude:%10.4f m\n", sdpbeg, altbeg);
+		fprintf(output, "\nEnd of Data:\n");
+		fprintf(output, "Time:  %2.2d %2.2d %4.4d %2.2d:%2.2d:%2.2d.%6.6d  JD%d (%4.4d-%2.2d-%2.2dT%2.2d:%2.2d:%2.2d.%6.6d)\n",
+		        timend_i[1], timend_i[2], timend_i[0], timend_i[3], timend_i[4], timend_i[5], timend_i[6], timend_j[1],
+		        timend_i[0], timend_i[1], timend_i[2], timend_i[3], timend_i[4], timend_i[5], timend_i[6]);
+		fprintf(output, "Lon: %15.9f     Lat: %15.9f     Depth: %10.4f meters\n", lonend, latend, bathend);
+		fprintf(output, "Speed: %7.4f km/hr (%7.4f knots)  Heading:%9.4f degrees\n", spdend, spdend / 1.85, hdgend);
+		fprintf(output, "Sonar Depth:%10.4f m  Sonar Altitude:%10.4f m\n", sdpend, altend);
+		fprintf(output, "\nLimits:\n");
+		fprintf(output, "Minimum Longitude:   %15.9f   Maximum Longitude:   %15.9f\n", lonmin, lonmax);
+		fprintf(output, "Minimum Latitude:    %15.9f   Maximum Latitude:    %15.9f\n", latmin, latmax);
+		fprintf(output, "Minimum Sonar Depth: %10.4f   Maximum Sonar Depth: %10.4f\n", sdpmin, sdpmax);
+		fprintf(output, "Minimum Altitude:    %10.4f   Maximum Altitude:    %10.4f\n", altmin, altmax);
+		if (ngdbeams > 0)
+			fprintf(output, "Minimum Depth:       %10.4f   Maximum Depth:       %10.4f\n", bathmin, bathmax);
+		if (ngabeams > 0)
+			fprintf(output, "Minimum Amplitude:   %10.4f   Maximum Amplitude:   %10.4f\n", ampmin, ampmax);
+		if (ngsbeams > 0)
+			fprintf(output, "Minimum Sidescan:    %10.4f   Maximum Sidescan:    %10.4f\n", ssmin, ssmax);
+
+		fprintf(output, "\nData Record Type Notices:\n");
+		for (int i = 0; i <= MB_DATA_KINDS; i++) {
+			if (notice_list[i] > 0) {
+				char *notice_message;
+				mb_notice_message(verbose, i, &notice_message);
+				fprintf(output, "DN: %d %s\n", notice_list[i], notice_message);
+			}
+		}
+		fprintf(output, "\nNonfatal Error Notices:\n");
+		for (int i = MB_DATA_KINDS + 1; i <= MB_DATA_KINDS - (MB_ERROR_MIN); i++) {
+			if (notice_list[i] > 0) {
+				char *notice_message;
+				mb_notice_message(verbose, i, &notice_message);
+				fprintf(output, "EN: %d %s\n", notice_list[i], notice_message);
+			}
+		}
+		fprintf(output, "\nProblem Notices:\n");
+		for (int i = MB_DATA_KINDS - (MB_ERROR_MIN) + 1; i < MB_NOTICE_MAX; i++) {
+			if (notice_list[i] > 0) {
+				char *notice_message;
+				mb_notice_message(verbose, i, &notice_message);
+				fprintf(output, "PN: %d %s\n", notice_list[i], notice_message);
+			}
+		}
+
+		fprintf(output, "\nCoverage Mask:\nCM dimensions: %d %d\n", MB_MAKE_INFO_MASK_NX, MB_MAKE_INFO_MASK_NY);
+		for (int j = MB_MAKE_INFO_MASK_NY - 1; j >= 0; j--) {
+			fprintf(output, "CM:  ");
+			for (int i = 0; i < MB_MAKE_INFO_MASK_NX; i++)
+				fprintf(output, " %1d", mask[i + j * MB_MAKE_INFO_MASK_NX]);
+			fprintf(output, "\n");
+		}
+	}
+	fclose(output);
+
+	/* do not leave a partial inf file behind */
+	if (status != MB_SUCCESS)
+		remove(inffile);
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------*/
+int mb_make_info_fbt(int verbose, char *file, int format, char *fbtfile, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       file:       %s\n", file);
+		fprintf(stderr, "dbg2       format:     %d\n", format);
+		fprintf(stderr, "dbg2       fbtfile:    %s\n", fbtfile);
+	}
+
+	int pings;
+	int lonflip;
+	double bounds[4];
+	int btime_i[7];
+	int etime_i[7];
+	double speedmin;
+	double timegap;
+	int format_default;
+	mb_defaults(verbose, &format_default, &pings, &lonflip, bounds, btime_i, etime_i, &speedmin, &timegap);
+	pings = 1;
+	int fbtversion;
+	mb_fbtversion(verbose, &fbtversion);
+
+	void *imbio_ptr = NULL;
+	void *ombio_ptr = NULL;
+	double btime_d;
+	double etime_d;
+	int beams_bath;
+	int beams_amp;
+	int pixels_ss;
+	int obeams_bath;
+	int obeams_amp;
+	int opixels_ss;
+	if (mb_read_init(verbose, file, format, pings, lonflip, bounds, btime_i, etime_i, speedmin, timegap, &imbio_ptr, &btime_d,
+	                 &etime_d, &beams_bath, &beams_amp, &pixels_ss, error) != MB_SUCCESS)
+		return (MB_FAILURE);
+	if (mb_write_init(verbose, fbtfile, MBF_MBLDEOIH, &ombio_ptr, &obeams_bath, &obeams_amp, &opixels_ss, error) != MB_SUCCESS) {
+		int tmp_error;
+		mb_close(verbose, &imbio_ptr, &tmp_error);
+		return (MB_FAILURE);
+	}
+	struct mb_io_struct *imb_io_ptr = (struct mb_io_struct *)imbio_ptr;
+	struct mb_io_struct *omb_io_ptr = (struct mb_io_struct *)ombio_ptr;
+	omb_io_ptr->save1 = fbtversion;
+
+	char *beamflag = NULL;
+	double *bath = NULL;
+	double *amp = NULL;
+	double *bathacrosstrack = NULL;
+	double *bathalongtrack = NULL;
+	double *ss = NULL;
+	double *ssacrosstrack = NULL;
+	double *ssalongtrack = NULL;
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char), (void **)&beamflag, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bath, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double), (void **)&amp, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathacrosstrack, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathalongtrack, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ss, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssacrosstrack, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssalongtrack, error);
+
+	int status = *error == MB_ERROR_NO_ERROR ? MB_SUCCESS : MB_FAILURE;
+
+	/* write comments to beginning of output file */
+	if (status == MB_SUCCESS) {
+		char comment[MB_COMMENT_MAXLINE];
+		char user[256], host[256], date[32];
+		int tmp_error;
+		mb_user_host_date(verbose, user, host, date, &tmp_error);
+		snprintf(comment, sizeof(comment), "These data copied by MBIO function %s", __func__);
+		mb_put_comment(verbose, ombio_ptr, comment, &tmp_error);
+		snprintf(comment, sizeof(comment), "MB-system Version %s", MB_VERSION);
+		mb_put_comment(verbose, ombio_ptr, comment, &tmp_error);
+		snprintf(comment, sizeof(comment), "Run by user <%s> on cpu <%s> at <%s>", user, host, date);
+		mb_put_comment(verbose, ombio_ptr, comment, &tmp_error);
+		snprintf(comment, sizeof(comment), "Control Parameters:");
+		mb_put_comment(verbose, ombio_ptr, comment, &tmp_error);
+		snprintf(comment, sizeof(comment), "  Input file:         %s", file);
+		mb_put_comment(verbose, ombio_ptr, comment, &tmp_error);
+		snprintf(comment, sizeof(comment), "  Input MBIO format:  %d", format);
+		mb_put_comment(verbose, ombio_ptr, comment, &tmp_error);
+		snprintf(comment, sizeof(comment), "  Output file:        %s", fbtfile);
+		mb_put_comment(verbose, ombio_ptr, comment, &tmp_error);
+		snprintf(comment, sizeof(comment), "  Output MBIO format: %d", MBF_MBLDEOIH);
+		mb_put_comment(verbose, ombio_ptr, comment, &tmp_error);
+		snprintf(comment, sizeof(comment), " ");
+		mb_put_comment(verbose, ombio_ptr, comment, &tmp_error);
+	}
+
+	/* copy bathymetry and comments, dropping amplitude and sidescan */
+	while (status == MB_SUCCESS && *error <= MB_ERROR_NO_ERROR) {
+		void *istore_ptr = NULL;
+		int kind;
+		int time_i[7];
+		double time_d;
+		double navlon;
+		double navlat;
+		double speed;
+		double heading;
+		double distance;
+		double altitude;
+		double sensordepth;
+		double draft = 0.0;
+		double roll = 0.0;
+		double pitch = 0.0;
+		double heave = 0.0;
+		int nbath = 0;
+		int namp = 0;
+		int nss = 0;
+		int sensorhead = 0;
+		int sensortype = 0;
+		char comment[MB_COMMENT_MAXLINE];
+		*error = MB_ERROR_NO_ERROR;
+		mb_get_all(verbose, imbio_ptr, &istore_ptr, &kind, time_i, &time_d, &navlon, &navlat, &speed, &heading, &distance,
+		           &altitude, &sensordepth, &nbath, &namp, &nss, beamflag, bath, amp, bathacrosstrack, bathalongtrack, ss,
+		           ssacrosstrack, ssalongtrack, comment, error);
+		if (*error == MB_ERROR_TIME_GAP)
+			*error = MB_ERROR_NO_ERROR;
+		if (*error != MB_ERROR_NO_ERROR || (kind != MB_DATA_DATA && kind != MB_DATA_COMMENT))
+			continue;
+
+		struct mbsys_ldeoih_struct *ostore = (struct mbsys_ldeoih_struct *)omb_io_ptr->store_data;
+		if (kind == MB_DATA_DATA) {
+			int tmp_error;
+			mb_extract_nav(verbose, imbio_ptr, istore_ptr, &kind, time_i, &time_d, &navlon, &navlat, &speed, &heading, &draft,
+			               &roll, &pitch, &heave, error);
+			mb_sensorhead(verbose, imbio_ptr, istore_ptr, &sensorhead, &tmp_error);
+			mb_sonartype(verbose, imbio_ptr, istore_ptr, &sensortype, &tmp_error);
+		}
+		ostore->sensorhead = sensorhead;
+		ostore->topo_type = sensortype;
+		ostore->beam_xwidth = imb_io_ptr->beamwidth_xtrack;
+		ostore->beam_lwidth = imb_io_ptr->beamwidth_ltrack;
+		ostore->kind = kind;
+		if (kind == MB_DATA_DATA) {
+			mb_insert_nav(verbose, ombio_ptr, (void *)ostore, time_i, time_d, navlon, navlat, speed, heading, draft, roll, pitch,
+			              heave, error);
+			mb_insert_altitude(verbose, ombio_ptr, (void *)ostore, draft, altitude, error);
+		}
+		mb_insert(verbose, ombio_ptr, (void *)ostore, kind, time_i, time_d, navlon, navlat, speed, heading, nbath, 0, 0, beamflag,
+		          bath, amp, bathacrosstrack, bathalongtrack, ss, ssacrosstrack, ssalongtrack, comment, error);
+		if (*error == MB_ERROR_NO_ERROR)
+			status = mb_put_all(verbose, ombio_ptr, (void *)ostore, false, kind, time_i, time_d, navlon, navlat, speed, heading,
+			                    nbath, 0, 0, beamflag, bath, amp, bathacrosstrack, bathalongtrack, ss, ssacrosstrack,
+			                    ssalongtrack, comment, error);
+	}
+	if (status == MB_SUCCESS)
+		*error = MB_ERROR_NO_ERROR;
+
+	int tmp_error;
+	mb_close(verbose, &imbio_ptr, &tmp_error);
+	mb_close(verbose, &ombio_ptr, &tmp_error);
+	if (status != MB_SUCCESS)
+		remove(fbtfile);
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------*/
+int mb_make_info_fnv(int verbose, char *file, int format, FILE *fp, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       file:       %s\n", file);
+		fprintf(stderr, "dbg2       format:     %d\n", format);
+		fprintf(stderr, "dbg2       fp:         %p\n", (void *)fp);
+	}
+
+	int pings;
+	int lonflip;
+	double bounds[4];
+	int btime_i[7];
+	int etime_i[7];
+	double speedmin;
+	double timegap;
+	int format_default;
+	mb_defaults(verbose, &format_default, &pings, &lonflip, bounds, btime_i, etime_i, &speedmin, &timegap);
+	pings = 1;
+
+	void *mbio_ptr = NULL;
+	double btime_d;
+	double etime_d;
+	int beams_bath_alloc;
+	int beams_amp_alloc;
+	int pixels_ss_alloc;
+	if (mb_read_init(verbose, file, format, pings, lonflip, bounds, btime_i, etime_i, speedmin, timegap, &mbio_ptr, &btime_d,
+	                 &etime_d, &beams_bath_alloc, &beams_amp_alloc, &pixels_ss_alloc, error) != MB_SUCCESS)
+		return (MB_FAILURE);
+
+	char *beamflag = NULL;
+	double *bath = NULL;
+	double *amp = NULL;
+	double *bathacrosstrack = NULL;
+	double *bathalongtrack = NULL;
+	double *ss = NULL;
+	double *ssacrosstrack = NULL;
+	double *ssalongtrack = NULL;
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char), (void **)&beamflag, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bath, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double), (void **)&amp, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathacrosstrack, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathalongtrack, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ss, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssacrosstrack, error);
+	if (*error == MB_ERROR_NO_ERROR)
+		mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssalongtrack, error);
+	int status = *error == MB_ERROR_NO_ERROR ? MB_SUCCESS : MB_FAILURE;
+
+	/* list the sensor navigation and attitude with the swath edges,
+	    skipping pings with zero navigation */
+	while (status == MB_SUCCESS && *error <= MB_ERROR_NO_ERROR) {
+		void *store_ptr = NULL;
+		int kind;
+		int time_i[7];
+		double time_d;
+		double navlon;
+		double navlat;
+		double speed;
+		double heading;
+		double distance;
+		double altitude;
+		double sensordepth;
+		int beams_bath = 0;
+		int beams_amp = 0;
+		int pixels_ss = 0;
+		char comment[MB_COMMENT_MAXLINE];
+		*error = MB_ERROR_NO_ERROR;
+		mb_get_all(verbose, mbio_ptr, &store_ptr, &kind, time_i, &time_d, &navlon, &navlat, &speed, &heading, &distance,
+		           &altitude, &sensordepth, &beams_bath, &beams_amp, &pixels_ss, beamflag, bath, amp, bathacrosstrack,
+		           bathalongtrack, ss, ssacrosstrack, ssalongtrack, comment, error);
+		if (*error == MB_ERROR_TIME_GAP)
+			*error = MB_ERROR_NO_ERROR;
+		if (*error != MB_ERROR_NO_ERROR || kind != MB_DATA_DATA || navlon == 0.0 || navlat == 0.0)
+			continue;
+
+		double tnavlon, tnavlat, tspeed, theading;
+		double draft = 0.0;
+		double roll = 0.0;
+		double pitch = 0.0;
+		double heave = 0.0;
+		mb_extract_nav(verbose, mbio_ptr, store_ptr, &kind, time_i, &time_d, &tnavlon, &tnavlat, &tspeed, &theading, &draft, &roll,
+		               &pitch, &heave, error);
+		if (*error != MB_ERROR_NO_ERROR)
+			continue;
+
+		int beam_port, beam_vertical, beam_stbd;
+		int pixel_port, pixel_vertical, pixel_stbd;
+		mb_swathbounds(verbose, true, beams_bath, pixels_ss, beamflag, bathacrosstrack, ss, ssacrosstrack, &beam_port,
+		               &beam_vertical, &beam_stbd, &pixel_port, &pixel_vertical, &pixel_stbd, error);
+		double mtodeglon;
+		double mtodeglat;
+		mb_coor_scale(verbose, navlat, &mtodeglon, &mtodeglat);
+		const double headingx = sin(DTR * heading);
+		const double headingy = cos(DTR * heading);
+		double portlon = navlon;
+		double portlat = navlat;
+		double stbdlon = navlon;
+		double stbdlat = navlat;
+		if (beams_bath > 0) {
+			portlon += headingy * mtodeglon * bathacrosstrack[beam_port] + headingx * mtodeglon * bathalongtrack[beam_port];
+			portlat += -headingx * mtodeglat * bathacrosstrack[beam_port] + headingy * mtodeglat * bathalongtrack[beam_port];
+			stbdlon += headingy * mtodeglon * bathacrosstrack[beam_stbd] + headingx * mtodeglon * bathalongtrack[beam_stbd];
+			stbdlat += -headingx * mtodeglat * bathacrosstrack[beam_stbd] + headingy * mtodeglat * bathalongtrack[beam_stbd];
+		}
+		fprintf(fp,
+		        "%.4d %.2d %.2d %.2d %.2d %09.6f\t%.6f\t%15.10f\t%15.10f\t%7.3f\t%6.3f\t%.4f\t%6.3f\t%6.3f\t%7.4f"
+		        "\t%15.10f\t%15.10f\t%15.10f\t%15.10f\n",
+		        time_i[0], time_i[1], time_i[2], time_i[3], time_i[4], time_i[5] + 1e-6 * time_i[6], time_d, navlon, navlat,
+		        heading, speed, sensordepth, roll, pitch, heave, portlon, portlat, stbdlon, stbdlat);
+	}
+	if (status == MB_SUCCESS)
+		*error = MB_ERROR_NO_ERROR;
+
+	int tmp_error;
+	mb_close(verbose, &mbio_ptr, &tmp_error);
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------*/
 int mb_make_info(int verbose, bool force, char *file, int format, int *error) {
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
@@ -640,44 +1747,44 @@ int mb_make_info(int verbose, bool force, char *file, int format, int *error) {
 	}
 
 	int status = MB_SUCCESS;
-	int shellstatus = 0;
 
 	/* make new inf file if not there or out of date */
 	if (force || (datmodtime > 0 && datmodtime > infmodtime)) {
 		if (verbose >= 1)
 			fprintf(stderr, "\nGenerating inf file for %s\n", file);
-		char command[MB_PATH_MAXLINE];
-		sprintf(command, "mbinfo -F %d -I %s -G -N -O -M10/10", format, file);
-		if (verbose >= 2)
-			fprintf(stderr, "\t%s\n", command);
-		if ((shellstatus = system(command)) != 0)
-      status = MB_FAILURE;
+		if (mb_make_info_inf(verbose, file, format, error) != MB_SUCCESS)
+			status = MB_FAILURE;
 	}
 
 	/* make new fbt file if not there or out of date */
 	if ((force || (datmodtime > 0 && datmodtime > fbtmodtime)) && mb_should_make_fbt(verbose, format)) {
 		if (verbose >= 1)
 			fprintf(stderr, "Generating fbt file for %s\n", file);
-		  char command[MB_PATH_MAXLINE];
-		  sprintf(command, "mbcopy -F %d/71 -I %s -D -O %s.fbt", format, file, file);
-		  if ((shellstatus = system(command)) != 0)
-        status = MB_FAILURE;
+		if (mb_make_info_fbt(verbose, file, format, fbtfile, error) != MB_SUCCESS)
+			status = MB_FAILURE;
 	}
 
 	/* make new fnv file if not there or out of date */
 	if ((force || (datmodtime > 0 && datmodtime > fnvmodtime)) && mb_should_make_fnv(verbose, format)) {
 		if (verbose >= 1)
 			fprintf(stderr, "Generating fnv file for %s\n", file);
-	  char command[MB_PATH_MAXLINE];
-    sprintf(command,  "echo \"## <yyyy mm dd hh mm ss.ssssss> <epoch seconds> "
-                      "<longitude (deg)> <latitude (deg)> <heading (deg)> <speed (km/hr)> "
-                      "<draft (m)> <roll (deg)> <pitch (deg)> <heave (m)> <portlon (deg)> "
-                      "<portlat (deg)> <stbdlon (deg)> <stbdlat (deg)>\"  > %s.fnv", file);
-	  if ((shellstatus = system(command)) != 0)
-      status = MB_FAILURE;
-	  sprintf(command, "mblist -F %d -I %s -O tMXYHScRPr=X=Y+X+Y -UN >> %s.fnv", format, file, file);
-	  if ((shellstatus = system(command)) != 0)
-      status = MB_FAILURE;
+		FILE *fp = fopen(fnvfile, "w");
+		if (fp == NULL) {
+			*error = MB_ERROR_OPEN_FAIL;
+			status = MB_FAILURE;
+		}
+		else {
+			fprintf(fp, "## <yyyy mm dd hh mm ss.ssssss> <epoch seconds> "
+			            "<longitude (deg)> <latitude (deg)> <heading (deg)> <speed (km/hr)> "
+			            "<draft (m)> <roll (deg)> <pitch (deg)> <heave (m)> <portlon (deg)> "
+			            "<portlat (deg)> <stbdlon (deg)> <stbdlat (deg)>\n");
+			const int fnv_status = mb_make_info_fnv(verbose, file, format, fp, error);
+			fclose(fp);
+			if (fnv_status != MB_SUCCESS) {
+				remove(fnvfile);
+				status = MB_FAILURE;
+			}
+		}
 	}
 
 	if (verbose >= 2) {
@@ -1143,12 +2250,54 @@ int mb_get_info_datalist(int verbose, char *read_file, int *format, struct mb_in
 		read_data = true;
 	}
 
+	/* map the inf cache index of the datalist if one exists */
+	char file_index[MB_PATH_MAXLINE + sizeof(MB_INFO_CACHE_SUFFIX)];
+	struct mb_info_cache_index_struct index;
+	memset(&index, 0, sizeof(index));
+	if (read_datalist) {
+		snprintf(file_index, sizeof(file_index), "%s%s", read_file, MB_INFO_CACHE_SUFFIX);
+		mb_info_cache_index_map(verbose, file_index, &index);
+	}
+	struct mb_info_cache_record_struct *records = NULL;
+	int nrecord = 0;
+	int nrecord_alloc = 0;
+
 	/* loop over all files to be read */
 	int nfile = 0;
 	while (read_data) {
-		/* read inf file */
+		/* read inf file contents, from the datalist index if current */
 		struct mb_info_struct mb_info_file;
-		status = mb_get_info(verbose, swathfile, &mb_info_file, lonflip, error);
+		mb_info_init(verbose, &mb_info_file, error);
+		struct mb_info_cache_record_struct record_file;
+		const struct mb_info_cache_record_struct *record = NULL;
+		if (read_datalist) {
+			char file_inf[MB_PATH_MAXLINE + 4];
+			snprintf(file_inf, sizeof(file_inf), "%s.inf", swathfile);
+			int64_t inf_mtime;
+			int64_t inf_size;
+			if (nrecord < index.nrecord && mb_info_cache_stat(file_inf, &inf_mtime, &inf_size)) {
+				record = &index.records[nrecord];
+				if (record->path_hash != mb_info_cache_hash(swathfile) || record->inf_mtime != inf_mtime ||
+				    record->inf_size != inf_size)
+					record = NULL;
+			}
+		}
+		if (record == NULL && mb_info_cache_load(verbose, swathfile, &record_file, error) == MB_SUCCESS)
+			record = &record_file;
+		if (record != NULL) {
+			mb_info_cache_unpack(swathfile, record, lonflip, &mb_info_file);
+
+			/* save the record for the rewritten index */
+			if (read_datalist) {
+				if (nrecord >= nrecord_alloc) {
+					nrecord_alloc = MAX(2 * nrecord_alloc, 1024);
+					status = mb_reallocd(verbose, __FILE__, __LINE__,
+					                     nrecord_alloc * sizeof(struct mb_info_cache_record_struct), (void **)&records, error);
+				}
+				if (records != NULL)
+					memcpy(&records[nrecord++], record, sizeof(struct mb_info_cache_record_struct));
+			}
+		}
 
 		/* only use if there are data */
 		if (mb_info_file.nrecords > 0) {
@@ -1274,6 +2423,18 @@ int mb_get_info_datalist(int verbose, char *read_file, int *format, struct mb_in
 	if (read_datalist)
 		mb_datalist_close(verbose, &datalist, error);
 
+	/* rewrite the index only if its contents have changed */
+	if (read_datalist) {
+		const bool index_changed =
+		    nrecord != index.nrecord ||
+		    (nrecord > 0 && memcmp(records, index.records, nrecord * sizeof(struct mb_info_cache_record_struct)) != 0);
+		if (records != NULL && index_changed)
+			mb_info_cache_write(verbose, file_index, records, nrecord);
+		mb_info_cache_index_unmap(&index);
+		if (records != NULL)
+			mb_freed(verbose, __FILE__, __LINE__, (void **)&records, error);
+	}
+
 	/* check memory */
 	if (verbose >= 4)
 		/* status = */ mb_memory_list(verbose, error);
@@ -57,8 +57,11 @@ int mb_close(int verbose, void **mbio_ptr, int *error) {
   /* get pointer to mbio descriptor */
   struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)*mbio_ptr;
 
+  /* stop any reader thread before the format structures go away */
+  int status = mb_readahead_deall(verbose, *mbio_ptr, error);
+
   /* deallocate format dependent structures */
-  int status = (*mb_io_ptr->mb_io_format_free)(verbose, *mbio_ptr, error);
+  status &= (*mb_io_ptr->mb_io_format_free)(verbose, *mbio_ptr, error);
 
   /* deallocate system dependent structures */
   /*status = (*mb_io_ptr->mb_io_store_free)
@@ -74,6 +77,7 @@ int mb_close(int verbose, void **mbio_ptr, int *error) {
   if (mb_io_ptr->hdr_comment != NULL)
     status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&mb_io_ptr->hdr_comment, error);
   status &= mb_deall_ioarrays(verbose, *mbio_ptr, error);
+  status &= mb_asynch_deall(verbose, *mbio_ptr, error);
 
   /* close the files if normal */
   if (mb_io_ptr->filetype == MB_FILETYPE_NORMAL || mb_io_ptr->filetype == MB_FILETYPE_XDR) {
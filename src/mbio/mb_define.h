@@ -35,6 +35,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 /* Define version and date for this release */
 #define MB_VERSION "5.8.2beta17"
@@ -175,6 +176,17 @@ typedef char mb_command[MB_COMMAND_LENGTH];
 /* maximum number of asynchronous data saved */
 #define MB_ASYNCH_SAVE_MAX 10000
 
+/* time (seconds) before and after a requested time window within which
+    asynchronous data are still read when seeking to the window */
+#define MB_SEEK_TIME_MARGIN 60.0
+
+/* maximum number of records decoded ahead of the application */
+#define MB_READAHEAD_MAX 64
+
+/* dimensions of the coverage mask in inf files made by mb_make_info() */
+#define MB_MAKE_INFO_MASK_NX 10
+#define MB_MAKE_INFO_MASK_NY 10
+
 /* maximum size of SVP profiles */
 #define MB_SVP_MAX 1024
 
@@ -371,6 +383,9 @@ int mb_check_info(int verbose, char *file, int lonflip, double bounds[4], bool *
 bool mb_should_make_fbt(int verbose, int format);
 bool mb_should_make_fnv(int verbose, int format);
 int mb_make_info(int verbose, bool force, char *file, int format, int *error);
+int mb_make_info_inf(int verbose, char *file, int format, int *error);
+int mb_make_info_fbt(int verbose, char *file, int format, char *fbtfile, int *error);
+int mb_make_info_fnv(int verbose, char *file, int format, FILE *fp, int *error);
 int mb_get_fbt(int verbose, char *file, int *format, int *error);
 int mb_get_fnv(int verbose, char *file, int *format, int *error);
 int mb_get_ffa(int verbose, char *file, int *format, int *error);
@@ -401,6 +416,11 @@ int mb_write_init(int verbose, char *file, int format, void **mbio_ptr, int *bea
                   int *error);
 int mb_close(int verbose, void **mbio_ptr, int *error);
 int mb_read_ping(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int *error);
+int mb_readahead_init(int verbose, void *mbio_ptr, int nqueue, int *error);
+int mb_readahead_read(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int *error);
+int mb_readahead_lock(int verbose, void *mbio_ptr, int *error);
+int mb_readahead_unlock(int verbose, void *mbio_ptr, int *error);
+int mb_readahead_deall(int verbose, void *mbio_ptr, int *error);
 int mb_get_all(int verbose, void *mbio_ptr, void **store_ptr, int *kind, int time_i[7], double *time_d, double *navlon,
                   double *navlat, double *speed, double *heading, double *distance, double *altitude, double *sensordepth, int *nbath,
                   int *namp, int *nss, char *beamflag, double *bath, double *amp, double *bathacrosstrack, double *bathalongtrack,
@@ -422,7 +442,10 @@ int mb_put_comment(int verbose, void *mbio_ptr, char *comment, int *error);
 int mb_fileio_open(int verbose, void *mbio_ptr, int *error);
 int mb_fileio_close(int verbose, void *mbio_ptr, int *error);
 int mb_fileio_get(int verbose, void *mbio_ptr, char *buffer, size_t *size, int *error);
+int mb_fileio_get_slice(int verbose, void *mbio_ptr, char *buffer, char **data, size_t *size, int *error);
 int mb_fileio_put(int verbose, void *mbio_ptr, char *buffer, size_t *size, int *error);
+int mb_fileio_seek(int verbose, void *mbio_ptr, long offset, int whence, int *error);
+long mb_fileio_tell(int verbose, void *mbio_ptr);
 int mb_copyfile(int verbose, const char *src, const char *dst, int *error);
 int mb_catfiles(int verbose, const char *src1, const char *src2, const char *dst, int *error);
 int mb_alloc(int verbose, void *mbio_ptr, void **store_ptr, int *error);
@@ -493,6 +516,7 @@ int mb_copyrecord(int verbose, void *mbio_ptr, void *store_ptr, void *copy_ptr,
 int mb_indextable(int verbose, void *mbio_ptr, int *num_indextable, void **indextable_ptr, int *error);
 int mb_indextablefix(int verbose, void *mbio_ptr, int num_indextable, void *indextable_ptr, int *error);
 int mb_indextableapply(int verbose, void *mbio_ptr, int num_indextable, void *indextable_ptr, int n_file, int *error);
+int mb_seek_time(int verbose, void *mbio_ptr, double time_d, int *error);
 
 int mb_platform_init(int verbose, void **platform_ptr, int *error);
 int mb_platform_setinfo(int verbose, void *platform_ptr, int type, char *name, char *organization, char *documentation_url,
@@ -597,6 +621,10 @@ int mb_notice_log_error(int verbose, void *mbio_ptr, int error_id);
 int mb_notice_log_problem(int verbose, void *mbio_ptr, int problem_id);
 int mb_notice_get_list(int verbose, void *mbio_ptr, int *notice_list);
 int mb_notice_message(int verbose, int notice, char **message);
+int mb_asynch_deall(int verbose, void *mbio_ptr, int *error);
+int mb_asynch_reset(int verbose, void *asynch_ptr, int *error);
+int mb_asynch_sample(int verbose, void *asynch_ptr, int isample, double *time_d, double *value, int *error);
+int mb_asynch_unroll(int verbose, void *asynch_ptr, int *nsample, double **time_d, double **value, int *error);
 int mb_navint_add(int verbose, void *mbio_ptr, double time_d, double lon_easting, double lat_northing, int *error);
 int mb_navint_interp(int verbose, void *mbio_ptr, double time_d, double heading, double rawspeed, double *lon, double *lat,
                      double *speed, int *error);
@@ -694,6 +722,7 @@ int mb_freed(int verbose, const char *sourcefile, int sourceline, void **ptr, in
 int mb_memory_clear(int verbose, int *error);
 int mb_memory_status(int verbose, int *nalloc, int *nallocmax, int *overflow, size_t *allocsize, int *error);
 int mb_memory_list(int verbose, int *error);
+int mb_memory_sites(int verbose, int *error);
 int mb_register_array(int verbose, void *mbio_ptr, int type, size_t size, void **handle, int *error);
 int mb_update_arrays(int verbose, void *mbio_ptr, int nbath, int namp, int nss, int *error);
 int mb_update_arrayptr(int verbose, void *mbio_ptr, void **handle, int *error);
@@ -710,8 +739,11 @@ int mb_unfix_y2k(int verbose, int year_long, int *year_short);
 
 int mb_proj_init(int verbose, char *projection, void **pjptr, int *error);
 int mb_proj_free(int verbose, void **pjptr, int *error);
+int mb_proj_clone(int verbose, void *pjptr, void **ctxptr, void **pjptr_clone, int *error);
+int mb_proj_clone_free(int verbose, void **ctxptr, void **pjptr_clone, int *error);
 int mb_proj_forward(int verbose, void *pjptr, double lon, double lat, double *easting, double *northing, int *error);
 int mb_proj_inverse(int verbose, void *pjptr, double easting, double northing, double *lon, double *lat, int *error);
+int mb_proj_wkt(int verbose, void *pjptr, char *wkt, int wkt_size, int *error);
 int mb_geod_init(int verbose, double radius_equatorial, double flattening, void **g_ptr, int *error);
 int mb_geod_free(int verbose, void **g_ptr, int *error);
 int mb_geod_inverse(int verbose, void *g_ptr,
@@ -743,6 +775,8 @@ int mb_rt(int verbose, void *modelptr, double source_depth, double source_angle,
           double surface_vel, double null_angle, int nplot_max,
           int *nplot, double *xplot, double *zplot, double *tplot,
           double *x, double *z, double *travel_time, int *ray_stat, int *error);
+int mb_rt_table(int verbose, void *modelptr, double source_depth, double source_angle, double end_time, int ssv_mode,
+                double surface_vel, double null_angle, double *x, double *z, double *travel_time, int *ray_stat, int *error);
 
 #ifdef __cplusplus
 }  /* extern "C" */
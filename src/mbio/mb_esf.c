@@ -121,7 +121,10 @@ int mb_esf_load(int verbose, const char *program_name, char *swathfile, bool loa
 	esf->edit = NULL;
 	esf->esffp = NULL;
 	esf->essfp = NULL;
-	esf->startnextsearch = 0;
+	esf->nbeam_alloc = 0;
+	esf->beam_edit = NULL;
+	esf->nnext_alloc = 0;
+	esf->edit_next = NULL;
 
 	/* get name of existing or new esffile, then load old edits
 	    and/or open new esf file */
@@ -195,7 +198,10 @@ int mb_esf_open(int verbose, const char *program_name, char *esffile, bool load,
 	esf->edit = NULL;
 	esf->esffp = NULL;
 	esf->essfp = NULL;
-	esf->startnextsearch = 0;
+	esf->nbeam_alloc = 0;
+	esf->beam_edit = NULL;
+	esf->nnext_alloc = 0;
+	esf->edit_next = NULL;
 
 	/* load edits from existing esf file if requested */
 	if (load) {
@@ -397,7 +403,6 @@ int mb_esf_open(int verbose, const char *program_name, char *esffile, bool load,
 		fprintf(stderr, "dbg2       esf->essfp:            %p\n", (void *)esf->essfp);
 		fprintf(stderr, "dbg2       esf->byteswapped:      %d\n", esf->byteswapped);
 		fprintf(stderr, "dbg2       esf->version:          %d\n", esf->version);
-		fprintf(stderr, "dbg2       esf->startnextsearch:  %d\n", esf->startnextsearch);
 		fprintf(stderr, "dbg2       error:                 %d\n", *error);
 		fprintf(stderr, "dbg2  Return status:\n");
 		fprintf(stderr, "dbg2       status:                %d\n", status);
@@ -497,18 +502,23 @@ int mb_esf_apply(int verbose, struct mb_esf_struct *esf, double time_d, int ping
 	else
 		maxtimediff = MB_ESF_MAXTIMEDIFF;
 
-	/* find first and last edits for this ping - take ping multiplicity into account */
-	if (esf->nedit > 0 && esf->startnextsearch > 0
-		&& time_d < (esf->edit[esf->startnextsearch].time_d - maxtimediff)
-			&& time_d < (esf->edit[esf->startnextsearch - 1].time_d - maxtimediff))
-		firstedit = 0;
-	else if (esf->nedit > 0 && esf->startnextsearch > 0
-		&& fabs(time_d - esf->edit[esf->startnextsearch - 1].time_d) <= maxtimediff
-		&& (esf->edit[esf->startnextsearch - 1].beam < beamoffset
-				|| esf->edit[esf->startnextsearch-1].beam > beamoffsetmax))
-		firstedit = 0;
-	else
-		firstedit = esf->startnextsearch;
+	/* find first and last edits for this ping - take ping multiplicity into account.
+	    The edits were sorted by time when loaded, so a binary search finds the
+	    first edit that may belong to this ping whatever order the pings are
+	    read in. The sort treats timestamps within maxtimediff as equal, so
+	    step back over neighbours that may be slightly out of order. */
+	int lo = 0;
+	int hi = esf->nedit;
+	while (lo < hi) {
+		const int mid = lo + (hi - lo) / 2;
+		if (esf->edit[mid].time_d <= time_d - maxtimediff)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	while (lo > 0 && esf->edit[lo - 1].time_d > time_d - maxtimediff)
+		lo--;
+	firstedit = lo;
 	lastedit = firstedit - 1;
 	for (j = firstedit; j < esf->nedit && time_d >= (esf->edit[j].time_d - maxtimediff); j++) {
 		if (fabs(esf->edit[j].time_d - time_d) < maxtimediff && esf->edit[j].beam >= beamoffset &&
@@ -527,6 +537,31 @@ int mb_esf_apply(int verbose, struct mb_esf_struct *esf, double time_d, int ping
 				esf->edit[j].use += 10000;
 		}
 
+		/* chain the edits of each beam together in the order they
+		    were created so each beam only visits its own edits */
+		int status_alloc = MB_SUCCESS;
+		if (nbath > esf->nbeam_alloc) {
+			status_alloc = mb_reallocd(verbose, __FILE__, __LINE__, nbath * sizeof(int), (void **)&esf->beam_edit, error);
+			esf->nbeam_alloc = status_alloc == MB_SUCCESS ? nbath : 0;
+		}
+		if (status_alloc == MB_SUCCESS && lastedit - firstedit + 1 > esf->nnext_alloc) {
+			status_alloc = mb_reallocd(verbose, __FILE__, __LINE__, (lastedit - firstedit + 1) * sizeof(int),
+			                           (void **)&esf->edit_next, error);
+			esf->nnext_alloc = status_alloc == MB_SUCCESS ? lastedit - firstedit + 1 : 0;
+		}
+		if (status_alloc != MB_SUCCESS) {
+			*error = MB_ERROR_MEMORY_FAIL;
+			return (MB_FAILURE);
+		}
+		for (int i = 0; i < nbath; i++)
+			esf->beam_edit[i] = -1;
+		for (j = lastedit; j >= firstedit; j--) {
+			if (esf->edit[j].beam >= beamoffset && esf->edit[j].beam - beamoffset < nbath) {
+				esf->edit_next[j - firstedit] = esf->beam_edit[esf->edit[j].beam - beamoffset];
+				esf->beam_edit[esf->edit[j].beam - beamoffset] = j;
+			}
+		}
+
 		bool apply;
 
 		/* loop over all beams */
@@ -537,7 +572,7 @@ int mb_esf_apply(int verbose, struct mb_esf_struct *esf, double time_d, int ping
 			/* loop over all edits for this ping */
 			apply = false;
 			beamflagorg = beamflag[i];
-			for (j = firstedit; j <= lastedit; j++) {
+			for (j = esf->beam_edit[i]; j >= 0; j = esf->edit_next[j - firstedit]) {
 				/* apply the edits for this beam in the
 				   order they were created so that the last
 				   edit event is applied last - only the
@@ -629,11 +664,6 @@ int mb_esf_apply(int verbose, struct mb_esf_struct *esf, double time_d, int ping
 			if (apply && esf->essfp != NULL && beamflag[i] != beamflagorg)
 				mb_ess_save(verbose, esf, time_d, ibeam, action, error);
 		}
-
-		/* reset startnextsearch */
-		esf->startnextsearch = lastedit + 1;
-		if (esf->startnextsearch >= esf->nedit)
-			esf->startnextsearch = esf->nedit - 1;
 	}
 
 	const int status = MB_SUCCESS;
@@ -795,6 +825,12 @@ int mb_esf_close(int verbose, struct mb_esf_struct *esf, int *error) {
 	if (esf->edit != NULL)
 		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(esf->edit), error);
 	esf->nedit = 0;
+	if (esf->beam_edit != NULL)
+		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(esf->beam_edit), error);
+	esf->nbeam_alloc = 0;
+	if (esf->edit_next != NULL)
+		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(esf->edit_next), error);
+	esf->nnext_alloc = 0;
 
 	/* close the esf file */
 	if (esf->esffp != NULL) {
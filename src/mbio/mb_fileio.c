@@ -31,7 +31,18 @@
  *   mb_fileio_open  - initialize i/o, called by mb_read_init() and mb_write_init()
  *   mb_fileio_close  - cleanup i/o, called by mb_close()
  *   mb_fileio_get  - get bytes from input
+ *   mb_fileio_get_slice  - get pointer to bytes from input, without copying
+ *                          when the input file is memory mapped
  *   mb_fileio_put  - put bytes to output
+ *   mb_fileio_seek  - set the input or output position
+ *   mb_fileio_tell  - get the input or output position
+ *
+ * When the fileiobuffer default (set with mbdefaults) is negative, input
+ * files are memory mapped and read sequentially from the mapped view.
+ * The FILE pointer mb_io_ptr->mbfp remains open in this case, but format
+ * modules must use mb_fileio_seek() and mb_fileio_tell() rather than
+ * fseek() and ftell() so that the position within the mapped view is
+ * used.
  *
  * Author:  D. W. Caress
  * Date:  23 May 2012
@@ -40,6 +51,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 
 #include "mb_define.h"
 #include "mb_io.h"
@@ -86,8 +102,34 @@ int mb_fileio_open(int verbose, void *mbio_ptr, int *error) {
                       >0  use fread() and fwrite() with user defined buffer
                       <0  use mmap for file i/o */
   int fileiobuffer;
+  mb_io_ptr->file_mmap = NULL;
+  mb_io_ptr->file_mmap_size = 0;
+  mb_io_ptr->file_mmap_pos = 0;
   if (status == MB_SUCCESS) {
     mb_fileiobuffer(verbose, &fileiobuffer);
+#ifndef _WIN32
+    /* map the entire input file into memory, falling back to standard
+       buffering if the file is empty or cannot be mapped */
+    if (fileiobuffer < 0 && mb_io_ptr->filemode == MB_FILEMODE_READ) {
+      struct stat file_status;
+      if (fstat(fileno(mb_io_ptr->mbfp), &file_status) == 0
+          && S_ISREG(file_status.st_mode) && file_status.st_size > 0) {
+        /* the mapping is private and writable so that format modules may
+           modify record slices in place without altering the file */
+        void *file_mmap = mmap(NULL, (size_t)file_status.st_size, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE, fileno(mb_io_ptr->mbfp), 0);
+        if (file_mmap != MAP_FAILED) {
+          mb_io_ptr->file_mmap = (char *)file_mmap;
+          mb_io_ptr->file_mmap_size = (size_t)file_status.st_size;
+          mb_io_ptr->file_mmap_pos = 0;
+          posix_madvise(file_mmap, mb_io_ptr->file_mmap_size, POSIX_MADV_SEQUENTIAL);
+        }
+        else if (verbose > 0) {
+          fprintf(stderr, "\nUnable to memory map file %s, using standard file i/o\n", mb_io_ptr->file);
+        }
+      }
+    }
+#endif
     if (fileiobuffer > 0) {
       /* the buffer size must be a multiple of 512, plus 8 to be efficient */
       const size_t fileiobufferbytes = (fileiobuffer * 1024) + 8;
@@ -107,6 +149,8 @@ int mb_fileio_open(int verbose, void *mbio_ptr, int *error) {
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
     fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       file_mmap:  %p\n", (void *)mb_io_ptr->file_mmap);
+    fprintf(stderr, "dbg2       file_mmap_size: %zu\n", mb_io_ptr->file_mmap_size);
     fprintf(stderr, "dbg2       error:      %d\n", *error);
     fprintf(stderr, "dbg2  Return status:\n");
     fprintf(stderr, "dbg2       status:  %d\n", status);
@@ -125,12 +169,23 @@ int mb_fileio_close(int verbose, void *mbio_ptr, int *error) {
 
   struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
 
+#ifndef _WIN32
+  if (mb_io_ptr->file_mmap != NULL) {
+    munmap((void *)mb_io_ptr->file_mmap, mb_io_ptr->file_mmap_size);
+    mb_io_ptr->file_mmap = NULL;
+    mb_io_ptr->file_mmap_size = 0;
+    mb_io_ptr->file_mmap_pos = 0;
+  }
+#endif
+
   if (mb_io_ptr->mbfp != NULL) {
     fclose(mb_io_ptr->mbfp);
     mb_io_ptr->mbfp = NULL;
   }
 
-  const int status = MB_SUCCESS;
+  int status = MB_SUCCESS;
+  if (mb_io_ptr->file_iobuffer != NULL)
+    status = mb_freed(verbose, __FILE__, __LINE__, (void **)&mb_io_ptr->file_iobuffer, error);
 
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
@@ -159,7 +214,26 @@ int mb_fileio_get(int verbose, void *mbio_ptr, char *buffer, size_t *size, int *
   int status = MB_SUCCESS;
 
   size_t read_len = 0;
-  if (mb_io_ptr->mbfp != NULL) {
+  if (mb_io_ptr->file_mmap != NULL) {
+      /* copy expected number of bytes from the mapped file into buffer */
+      read_len = *size;
+      if (mb_io_ptr->file_mmap_pos >= mb_io_ptr->file_mmap_size)
+          read_len = 0;
+      else if (read_len > mb_io_ptr->file_mmap_size - mb_io_ptr->file_mmap_pos)
+          read_len = mb_io_ptr->file_mmap_size - mb_io_ptr->file_mmap_pos;
+      if (read_len > 0)
+          memcpy(buffer, &mb_io_ptr->file_mmap[mb_io_ptr->file_mmap_pos], read_len);
+      mb_io_ptr->file_mmap_pos += read_len;
+      if (read_len != *size) {
+          status = MB_FAILURE;
+          *error = MB_ERROR_EOF;
+          *size = read_len;
+      }
+      else {
+          *error = MB_ERROR_NO_ERROR;
+      }
+  }
+  else if (mb_io_ptr->mbfp != NULL) {
       /* read expected number of bytes into buffer */
       if ((read_len = fread(buffer, 1, *size, mb_io_ptr->mbfp)) != *size) {
           status = MB_FAILURE;
@@ -193,6 +267,64 @@ int mb_fileio_get(int verbose, void *mbio_ptr, char *buffer, size_t *size, int *
   return (status);
 }
 /*--------------------------------------------------------------------*/
+/*
+ * mb_fileio_get_slice() returns in *data a pointer to the next *size bytes
+ * of input. If the input file is memory mapped the pointer refers directly
+ * to the mapped file and no bytes are copied; otherwise the bytes are read
+ * into buffer with mb_fileio_get() and *data is set to buffer. The slice
+ * remains valid until the file is closed or, in the unmapped case, until
+ * buffer is reused.
+ */
+int mb_fileio_get_slice(int verbose, void *mbio_ptr, char *buffer, char **data, size_t *size, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+    fprintf(stderr, "dbg2       buffer:     %p\n", (void *)buffer);
+    fprintf(stderr, "dbg2       size:       %p\n", (void *)size);
+    fprintf(stderr, "dbg2       *size:      %zu\n", *size);
+  }
+
+  struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+
+  int status = MB_SUCCESS;
+
+  if (mb_io_ptr->file_mmap != NULL) {
+    size_t read_len = *size;
+    if (mb_io_ptr->file_mmap_pos >= mb_io_ptr->file_mmap_size)
+      read_len = 0;
+    else if (read_len > mb_io_ptr->file_mmap_size - mb_io_ptr->file_mmap_pos)
+      read_len = mb_io_ptr->file_mmap_size - mb_io_ptr->file_mmap_pos;
+    *data = &mb_io_ptr->file_mmap[mb_io_ptr->file_mmap_pos];
+    mb_io_ptr->file_mmap_pos += read_len;
+    if (read_len != *size) {
+      status = MB_FAILURE;
+      *error = MB_ERROR_EOF;
+      *size = read_len;
+    }
+    else {
+      *error = MB_ERROR_NO_ERROR;
+    }
+  }
+  else {
+    *data = buffer;
+    status = mb_fileio_get(verbose, mbio_ptr, buffer, size, error);
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       data:       %p\n", (void *)*data);
+    fprintf(stderr, "dbg2       *size:      %zu\n", *size);
+    fprintf(stderr, "dbg2       error:      %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:  %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
 int mb_fileio_put(int verbose, void *mbio_ptr, char *buffer, size_t *size, int *error) {
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
@@ -232,6 +364,82 @@ int mb_fileio_put(int verbose, void *mbio_ptr, char *buffer, size_t *size, int *
   return (status);
 }
 /*--------------------------------------------------------------------*/
+int mb_fileio_seek(int verbose, void *mbio_ptr, long offset, int whence, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+    fprintf(stderr, "dbg2       offset:     %ld\n", offset);
+    fprintf(stderr, "dbg2       whence:     %d\n", whence);
+  }
+
+  struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+
+  /* like fseek(), this leaves the error value unchanged on success */
+  int status = MB_SUCCESS;
+
+  if (mb_io_ptr->file_mmap != NULL) {
+    long position = offset;
+    if (whence == SEEK_CUR)
+      position += (long)mb_io_ptr->file_mmap_pos;
+    else if (whence == SEEK_END)
+      position += (long)mb_io_ptr->file_mmap_size;
+    if (position < 0) {
+      status = MB_FAILURE;
+      *error = MB_ERROR_EOF;
+    }
+    else {
+      mb_io_ptr->file_mmap_pos = (size_t)position;
+    }
+  }
+  else if (mb_io_ptr->mbfp != NULL) {
+    if (fseek(mb_io_ptr->mbfp, offset, whence) != 0) {
+      status = MB_FAILURE;
+      *error = MB_ERROR_EOF;
+    }
+  }
+  else {
+    status = MB_FAILURE;
+    *error = MB_ERROR_EOF;
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:      %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:  %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+long mb_fileio_tell(int verbose, void *mbio_ptr) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+  }
+
+  struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+
+  long position = -1;
+  if (mb_io_ptr->file_mmap != NULL)
+    position = (long)mb_io_ptr->file_mmap_pos;
+  else if (mb_io_ptr->mbfp != NULL)
+    position = ftell(mb_io_ptr->mbfp);
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       position:   %ld\n", position);
+  }
+
+  return (position);
+}
+/*--------------------------------------------------------------------*/
 int mb_copyfile(int verbose, const char *src, const char *dst, int *error)
 {
   /* The code here is modified from an example within a comment to the
@@ -87,6 +87,11 @@ int mb_get(int verbose, void *mbio_ptr, int *kind, int *pings, int time_i[7], do
 	double headingx = 0.0;
 	double headingy = 0.0;
 
+	/* with read ahead enabled the values left in the mbio descriptor are
+	    locked against the reader thread except while waiting for a ping */
+	int lock_error = MB_ERROR_NO_ERROR;
+	mb_readahead_lock(verbose, mbio_ptr, &lock_error);
+
 	/* read the data */
 	bool done = false;
 	while (!done) {
@@ -102,7 +107,9 @@ int mb_get(int verbose, void *mbio_ptr, int *kind, int *pings, int time_i[7], do
 
 		/* get next ping */
 		if (mb_io_ptr->need_new_ping) {
+			mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
 			status = mb_read_ping(verbose, mbio_ptr, store_ptr, &mb_io_ptr->new_kind, error);
+			mb_readahead_lock(verbose, mbio_ptr, &lock_error);
 
 			/* log errors */
 			if (*error < MB_ERROR_NO_ERROR)
@@ -709,6 +716,8 @@ int mb_get(int verbose, void *mbio_ptr, int *kind, int *pings, int time_i[7], do
 		fprintf(stderr, "dbg2       status:     %d\n", status);
 	}
 
+	mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
+
 	return (status);
 }
 /*--------------------------------------------------------------------*/
@@ -68,7 +68,19 @@ int mb_get_all(int verbose, void *mbio_ptr, void **store_ptr, int *kind, int tim
 		fprintf(stderr, "dbg2       error:         %d\n", *error);
 	}
 
-	int status = mb_read_ping(verbose, mbio_ptr, *store_ptr, kind, error);
+	/* with read ahead enabled the record is handed over in the mbio
+	    descriptor's store, and format state is locked against the reader
+	    thread while values are extracted */
+	int status;
+	int lock_error = MB_ERROR_NO_ERROR;
+	if (mb_io_ptr->readahead != NULL) {
+		status = mb_read_ping(verbose, mbio_ptr, NULL, kind, error);
+		*store_ptr = mb_io_ptr->store_data;
+		mb_readahead_lock(verbose, mbio_ptr, &lock_error);
+	}
+	else {
+		status = mb_read_ping(verbose, mbio_ptr, *store_ptr, kind, error);
+	}
 
 	/* if io arrays have been reallocated, update the
 	    pointers of arrays passed into this function,
@@ -378,6 +390,9 @@ int mb_get_all(int verbose, void *mbio_ptr, void **store_ptr, int *kind, int tim
 		mb_io_ptr->old_nlat = *navlat;
 	}
 
+	if (mb_io_ptr->readahead != NULL)
+		mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
+
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
 		fprintf(stderr, "dbg2  Return values:\n");
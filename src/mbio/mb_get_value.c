@@ -65,15 +65,7 @@ int mb_get_int(int *value, char *str, int nchar) {
  *	a buffer, swapping if necessary
  */
 int mb_get_binary_short(bool swapped, void *buffer, const void *ptr) {
-	short *value = (short *)ptr;
-	memcpy(value, buffer, sizeof(short));
-#ifdef BYTESWAPPED
-	if (!swapped)
-		*value = mb_swap_short(*((short *)value));
-#else
-	if (swapped)
-		*value = mb_swap_short(*value);
-#endif
+	mb_get_binary_short_inline(swapped, buffer, (void *)ptr);
 	return (0);
 }
 /*--------------------------------------------------------------------*/
@@ -81,15 +73,7 @@ int mb_get_binary_short(bool swapped, void *buffer, const void *ptr) {
  *	a buffer, swapping if necessary
  */
 int mb_get_binary_int(bool swapped, void *buffer, const void *ptr) {
-	int *value = (int *)ptr;
-	memcpy(value, buffer, sizeof(int));
-#ifdef BYTESWAPPED
-	if (!swapped)
-		*value = mb_swap_int(*value);
-#else
-	if (swapped)
-		*value = mb_swap_int(*value);
-#endif
+	mb_get_binary_int_inline(swapped, buffer, (void *)ptr);
 	return (0);
 }
 /*--------------------------------------------------------------------*/
@@ -97,15 +81,7 @@ int mb_get_binary_int(bool swapped, void *buffer, const void *ptr) {
  *	a buffer, swapping if necessary
  */
 int mb_get_binary_float(bool swapped, void *buffer, const void *ptr) {
-	float *value = (float *)ptr;
-	memcpy(value, buffer, sizeof(float));
-#ifdef BYTESWAPPED
-	if (!swapped)
-		mb_swap_float(value);
-#else
-	if (swapped)
-		mb_swap_float(value);
-#endif
+	mb_get_binary_float_inline(swapped, buffer, (void *)ptr);
 	return (0);
 }
 /*--------------------------------------------------------------------*/
@@ -113,15 +89,7 @@ int mb_get_binary_float(bool swapped, void *buffer, const void *ptr) {
  *	a buffer, swapping if necessary
  */
 int mb_get_binary_double(bool swapped, void *buffer, const void *ptr) {
-	double *value = (double *)ptr;
-	memcpy(value, buffer, sizeof(double));
-#ifdef BYTESWAPPED
-	if (!swapped)
-		mb_swap_double(value);
-#else
-	if (swapped)
-		mb_swap_double(value);
-#endif
+	mb_get_binary_double_inline(swapped, buffer, (void *)ptr);
 	return (0);
 }
 /*--------------------------------------------------------------------*/
@@ -129,15 +97,7 @@ int mb_get_binary_double(bool swapped, void *buffer, const void *ptr) {
  *	a buffer, swapping if necessary
  */
 int mb_get_binary_long(bool swapped, void *buffer, const void *ptr) {
-	mb_s_long *value = (mb_s_long *)ptr;
-	memcpy(value, buffer, sizeof(mb_s_long));
-#ifdef BYTESWAPPED
-	if (!swapped)
-		mb_swap_long(value);
-#else
-	if (swapped)
-		mb_swap_long(value);
-#endif
+	mb_get_binary_long_inline(swapped, buffer, (void *)ptr);
 	return (0);
 }
 /*--------------------------------------------------------------------*/
@@ -455,6 +455,23 @@ struct mb_io_ping_struct {
   double *sslat;
 };
 
+/* MBIO asynchronous data buffer used to interpolate navigation and
+    attitude - a ring buffer holding up to MB_ASYNCH_SAVE_MAX samples
+    that is allocated as samples are added, sample i (0 is the oldest)
+    being stored at (first + i) % nalloc with nvalue values per sample */
+struct mb_asynch_struct {
+  int nalloc;
+  int nsample;
+  int first;
+  int cursor; /* interval found by the last interpolation */
+  int nvalue;
+  double *time_d;
+  double *value;
+  int nunroll;    /* allocated size of unroll */
+  double *unroll; /* samples copied in order by mb_asynch_unroll() */
+  bool unroll_current; /* unroll holds the current samples */
+};
+
 /* MBIO input/output control structure */
 struct mb_io_struct {
   /* system byte swapping */
@@ -514,6 +531,9 @@ struct mb_io_struct {
   long file_pos;               /* file position at start of last record read */
   long file_bytes;             /* number of bytes read from file */
   char *file_iobuffer;         /* file i/o buffer for fread() and fwrite() calls */
+  char *file_mmap;             /* memory mapped view of file for mmap based input */
+  size_t file_mmap_size;       /* number of bytes in memory mapped view */
+  size_t file_mmap_pos;        /* current position within memory mapped view */
   FILE *mbfp2;                 /* file descriptor #2 */
   char file2[MB_PATH_MAXLINE]; /* file name #2 */
   long file2_pos;              /* file position #2 at start of last record read */
@@ -558,6 +578,9 @@ struct mb_io_struct {
   void *raw_data;
   void *store_data;
 
+  /* background reader queue, NULL unless enabled with mb_readahead_init() */
+  void *readahead;
+
   /* working variables */
   int ping_count;    /* number of pings read or written so far */
   int nav_count;     /* number of nav records read or written so far */
@@ -625,41 +648,30 @@ struct mb_io_struct {
 
   /* variables for interpolating/extrapolating navigation
       for formats containing nav as asynchronous
-      position records separate from ping data */
-  int nfix;
-  double fix_time_d[MB_ASYNCH_SAVE_MAX];
-  double fix_lon[MB_ASYNCH_SAVE_MAX];
-  double fix_lat[MB_ASYNCH_SAVE_MAX];
+      position records separate from ping data
+      - the values of each fix are lon and lat */
+  struct mb_asynch_struct asynch_fix;
 
   /* variables for interpolating/extrapolating attitude
       for formats containing attitude as asynchronous
-      data records separate from ping data */
-  int nattitude;
-  double attitude_time_d[MB_ASYNCH_SAVE_MAX];
-  double attitude_heave[MB_ASYNCH_SAVE_MAX];
-  double attitude_roll[MB_ASYNCH_SAVE_MAX];
-  double attitude_pitch[MB_ASYNCH_SAVE_MAX];
+      data records separate from ping data
+      - the values of each fix are heave, roll and pitch */
+  struct mb_asynch_struct asynch_attitude;
 
   /* variables for interpolating/extrapolating heading
       for formats containing heading as asynchronous
       data records separate from ping data */
-  int nheading;
-  double heading_time_d[MB_ASYNCH_SAVE_MAX];
-  double heading_heading[MB_ASYNCH_SAVE_MAX];
+  struct mb_asynch_struct asynch_heading;
 
   /* variables for interpolating/extrapolating sonar depth
       for formats containing sonar depth as asynchronous
       data records separate from ping data */
-  int nsensordepth;
-  double sensordepth_time_d[MB_ASYNCH_SAVE_MAX];
-  double sensordepth_sensordepth[MB_ASYNCH_SAVE_MAX];
+  struct mb_asynch_struct asynch_sensordepth;
 
   /* variables for interpolating/extrapolating altitude
       for formats containing altitude as asynchronous
       data records separate from ping data */
-  int naltitude;
-  double altitude_time_d[MB_ASYNCH_SAVE_MAX];
-  double altitude_altitude[MB_ASYNCH_SAVE_MAX];
+  struct mb_asynch_struct asynch_altitude;
 
   /* preprocessing parameter structure used by some formats */
   struct mb_preprocess_struct preprocess_pars;
@@ -811,6 +823,9 @@ struct mb_io_struct {
     int (*mb_io_indextablefix)(int verbose, void *mbio_ptr, int num_indextable, void *indextable_ptr, int *error);
     int (*mb_io_indextableapply)(int verbose, void *mbio_ptr, int num_indextable, void *indextable_ptr, int n_file, int *error);
 
+  /* function pointer for positioning input at a time using a file index */
+  int (*mb_io_seek_time)(int verbose, void *mbio_ptr, double time_d, int *error);
+
   /* function pointers for reading from application defined input */
   int (*mb_io_input_open)(int verbose, void *mbio_ptr, char *definition, int *error);
   int (*mb_io_input_read)(int verbose, void *mbio_ptr, size_t *size, char *buffer, int *error);
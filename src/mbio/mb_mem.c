@@ -31,7 +31,10 @@
  * Date:  March 1, 1993
  */
 
+#include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -40,18 +43,274 @@
 #include "mb_io.h"
 #include "mb_status.h"
 
-/* memory allocation list variables */
+/* memory allocation list variables
+ *
+ * The allocated memory list is a hash table keyed by pointer that is split
+ * into MB_MEMORY_SHARDS shards, each with its own mutex, so that the list can
+ * be kept by multithreaded programs. Each shard grows as needed, so there is
+ * no limit on the number of allocations tracked. Every allocation refers to
+ * a call site (source file and line) in a second sharded table that counts
+ * the bytes currently allocated, the peak and the number of allocations made
+ * from that site - these are reported by mb_memory_sites().
+ * Locks are never nested except that a site mutex may be taken while an
+ * allocation shard mutex is held. */
 static const int MB_MEMORY_ALLOC_STEP = 100;
-#define MB_MEMORY_HEAP_MAX 10000
+#define MB_MEMORY_SHARDS 64
+#define MB_MEMORY_BUCKETS_INIT 64
 static bool mb_memory_list_enabled = true;
 static bool mb_mem_debug = false;
-static int n_mb_alloc = 0;
-static void *mb_alloc_ptr[MB_MEMORY_HEAP_MAX];
-static size_t mb_alloc_size[MB_MEMORY_HEAP_MAX];
-static mb_name mb_alloc_sourcefile[MB_MEMORY_HEAP_MAX];
-static int mb_alloc_sourceline[MB_MEMORY_HEAP_MAX];
 static bool mb_alloc_overflow = false;
 
+struct mb_mem_site_struct {
+  mb_name sourcefile;
+  int sourceline;
+  int shard;
+  size_t size;     /* bytes currently allocated */
+  size_t size_max; /* peak bytes allocated */
+  size_t nalloc;   /* number of allocations currently held */
+  size_t ncall;    /* number of allocations and reallocations made */
+  struct mb_mem_site_struct *next;
+};
+
+struct mb_mem_alloc_struct {
+  void *ptr;
+  size_t size;
+  struct mb_mem_site_struct *site;
+  struct mb_mem_alloc_struct *next;
+};
+
+struct mb_mem_shard_struct {
+  pthread_mutex_t mutex;
+  struct mb_mem_alloc_struct **bucket;
+  size_t nbucket;
+  size_t nalloc;
+  size_t allocsize;
+  struct mb_mem_alloc_struct *spare;
+};
+
+struct mb_mem_site_shard_struct {
+  pthread_mutex_t mutex;
+  struct mb_mem_site_struct *site;
+};
+
+static pthread_once_t mb_mem_once = PTHREAD_ONCE_INIT;
+static struct mb_mem_shard_struct mb_mem_shards[MB_MEMORY_SHARDS];
+static struct mb_mem_site_shard_struct mb_mem_site_shards[MB_MEMORY_SHARDS];
+
+/*--------------------------------------------------------------------*/
+static void mb_mem_init(void) {
+  for (int i = 0; i < MB_MEMORY_SHARDS; i++) {
+    pthread_mutex_init(&mb_mem_shards[i].mutex, NULL);
+    pthread_mutex_init(&mb_mem_site_shards[i].mutex, NULL);
+  }
+}
+/*--------------------------------------------------------------------*/
+static size_t mb_mem_hash(const void *ptr) {
+  /* mix the pointer bits since allocations are aligned */
+  uint64_t hash = (uint64_t)(uintptr_t)ptr;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return (size_t)hash;
+}
+/*--------------------------------------------------------------------*/
+/* get the call site for sourcefile and sourceline, adding it if needed */
+static struct mb_mem_site_struct *mb_mem_site_get(const char *sourcefile, int sourceline) {
+  if (sourcefile == NULL)
+    sourcefile = "";
+  size_t hash = (size_t)sourceline;
+  for (const char *c = sourcefile; *c != '\0'; c++)
+    hash = 31 * hash + (unsigned char)*c;
+  const int ishard = (int)(hash % MB_MEMORY_SHARDS);
+  struct mb_mem_site_shard_struct *shard = &mb_mem_site_shards[ishard];
+
+  pthread_once(&mb_mem_once, mb_mem_init);
+  pthread_mutex_lock(&shard->mutex);
+  struct mb_mem_site_struct *site = shard->site;
+  while (site != NULL
+         && (site->sourceline != sourceline || strncmp(site->sourcefile, sourcefile, MB_NAME_LENGTH - 1) != 0))
+    site = site->next;
+  if (site == NULL && (site = (struct mb_mem_site_struct *)calloc(1, sizeof(struct mb_mem_site_struct))) != NULL) {
+    strncpy(site->sourcefile, sourcefile, MB_NAME_LENGTH - 1);
+    site->sourceline = sourceline;
+    site->shard = ishard;
+    site->next = shard->site;
+    shard->site = site;
+  }
+  pthread_mutex_unlock(&shard->mutex);
+  return (site);
+}
+/*--------------------------------------------------------------------*/
+static void mb_mem_site_add(struct mb_mem_site_struct *site, size_t size) {
+  if (site == NULL)
+    return;
+  pthread_mutex_t *mutex = &mb_mem_site_shards[site->shard].mutex;
+  pthread_mutex_lock(mutex);
+  site->size += size;
+  if (site->size > site->size_max)
+    site->size_max = site->size;
+  site->nalloc++;
+  site->ncall++;
+  pthread_mutex_unlock(mutex);
+}
+/*--------------------------------------------------------------------*/
+static void mb_mem_site_subtract(struct mb_mem_site_struct *site, size_t size) {
+  if (site == NULL)
+    return;
+  pthread_mutex_t *mutex = &mb_mem_site_shards[site->shard].mutex;
+  pthread_mutex_lock(mutex);
+  site->size -= size;
+  site->nalloc--;
+  pthread_mutex_unlock(mutex);
+}
+/*--------------------------------------------------------------------*/
+/* add ptr to the allocated memory list, returning false if the list
+    could not be extended */
+static bool mb_mem_list_insert(void *ptr, size_t size, struct mb_mem_site_struct *site) {
+  const size_t hash = mb_mem_hash(ptr);
+  struct mb_mem_shard_struct *shard = &mb_mem_shards[hash % MB_MEMORY_SHARDS];
+
+  pthread_once(&mb_mem_once, mb_mem_init);
+  pthread_mutex_lock(&shard->mutex);
+
+  /* double the number of buckets whenever the chains average one entry */
+  if (shard->nalloc >= shard->nbucket) {
+    const size_t nbucket = shard->nbucket > 0 ? 2 * shard->nbucket : MB_MEMORY_BUCKETS_INIT;
+    struct mb_mem_alloc_struct **bucket =
+        (struct mb_mem_alloc_struct **)calloc(nbucket, sizeof(struct mb_mem_alloc_struct *));
+    if (bucket != NULL) {
+      for (size_t i = 0; i < shard->nbucket; i++) {
+        while (shard->bucket[i] != NULL) {
+          struct mb_mem_alloc_struct *alloc = shard->bucket[i];
+          shard->bucket[i] = alloc->next;
+          const size_t ibucket = (mb_mem_hash(alloc->ptr) / MB_MEMORY_SHARDS) & (nbucket - 1);
+          alloc->next = bucket[ibucket];
+          bucket[ibucket] = alloc;
+        }
+      }
+      free(shard->bucket);
+      shard->bucket = bucket;
+      shard->nbucket = nbucket;
+    }
+  }
+
+  struct mb_mem_alloc_struct *alloc = shard->spare;
+  if (alloc != NULL)
+    shard->spare = alloc->next;
+  else if (shard->nbucket > 0)
+    alloc = (struct mb_mem_alloc_struct *)malloc(sizeof(struct mb_mem_alloc_struct));
+  if (alloc != NULL) {
+    const size_t ibucket = (hash / MB_MEMORY_SHARDS) & (shard->nbucket - 1);
+    alloc->ptr = ptr;
+    alloc->size = size;
+    alloc->site = site;
+    alloc->next = shard->bucket[ibucket];
+    shard->bucket[ibucket] = alloc;
+    shard->nalloc++;
+    shard->allocsize += size;
+  }
+
+  pthread_mutex_unlock(&shard->mutex);
+  return (alloc != NULL);
+}
+/*--------------------------------------------------------------------*/
+/* remove ptr from the allocated memory list, returning false if it
+    was not in the list */
+static bool mb_mem_list_remove(void *ptr, size_t *size, struct mb_mem_site_struct **site) {
+  if (ptr == NULL)
+    return (false);
+  const size_t hash = mb_mem_hash(ptr);
+  struct mb_mem_shard_struct *shard = &mb_mem_shards[hash % MB_MEMORY_SHARDS];
+
+  pthread_once(&mb_mem_once, mb_mem_init);
+  pthread_mutex_lock(&shard->mutex);
+  bool found = false;
+  if (shard->nbucket > 0) {
+    struct mb_mem_alloc_struct **link = &shard->bucket[(hash / MB_MEMORY_SHARDS) & (shard->nbucket - 1)];
+    while (*link != NULL && (*link)->ptr != ptr)
+      link = &(*link)->next;
+    if (*link != NULL) {
+      struct mb_mem_alloc_struct *alloc = *link;
+      *link = alloc->next;
+      *size = alloc->size;
+      *site = alloc->site;
+      alloc->next = shard->spare;
+      shard->spare = alloc;
+      shard->nalloc--;
+      shard->allocsize -= *size;
+      found = true;
+    }
+  }
+  pthread_mutex_unlock(&shard->mutex);
+  return (found);
+}
+/*--------------------------------------------------------------------*/
+/* count the allocations in the list and the bytes they hold */
+static int mb_mem_list_count(size_t *allocsize) {
+  size_t nalloc = 0;
+  if (allocsize != NULL)
+    *allocsize = 0;
+  pthread_once(&mb_mem_once, mb_mem_init);
+  for (int ishard = 0; ishard < MB_MEMORY_SHARDS; ishard++) {
+    struct mb_mem_shard_struct *shard = &mb_mem_shards[ishard];
+    pthread_mutex_lock(&shard->mutex);
+    nalloc += shard->nalloc;
+    if (allocsize != NULL)
+      *allocsize += shard->allocsize;
+    pthread_mutex_unlock(&shard->mutex);
+  }
+  return (nalloc < INT_MAX ? (int)nalloc : INT_MAX);
+}
+/*--------------------------------------------------------------------*/
+static int mb_mem_alloc_compare(const void *a, const void *b) {
+  const struct mb_mem_alloc_struct *alloc_a = (const struct mb_mem_alloc_struct *)a;
+  const struct mb_mem_alloc_struct *alloc_b = (const struct mb_mem_alloc_struct *)b;
+  const char *sourcefile_a = alloc_a->site != NULL ? alloc_a->site->sourcefile : "";
+  const char *sourcefile_b = alloc_b->site != NULL ? alloc_b->site->sourcefile : "";
+  const int cmp = strcmp(sourcefile_a, sourcefile_b);
+  if (cmp != 0)
+    return (cmp);
+  const int sourceline_a = alloc_a->site != NULL ? alloc_a->site->sourceline : 0;
+  const int sourceline_b = alloc_b->site != NULL ? alloc_b->site->sourceline : 0;
+  if (sourceline_a != sourceline_b)
+    return (sourceline_a < sourceline_b ? -1 : 1);
+  if ((uintptr_t)alloc_a->ptr != (uintptr_t)alloc_b->ptr)
+    return ((uintptr_t)alloc_a->ptr < (uintptr_t)alloc_b->ptr ? -1 : 1);
+  return (0);
+}
+/*--------------------------------------------------------------------*/
+/* print the allocated memory list ordered by source location, each line
+    starting with prefix */
+static void mb_mem_list_print(const char *prefix) {
+  /* copy the list so that no lock is held while printing */
+  size_t nlist = 0;
+  size_t nlist_alloc = 0;
+  struct mb_mem_alloc_struct *list = NULL;
+  pthread_once(&mb_mem_once, mb_mem_init);
+  for (int ishard = 0; ishard < MB_MEMORY_SHARDS; ishard++) {
+    struct mb_mem_shard_struct *shard = &mb_mem_shards[ishard];
+    pthread_mutex_lock(&shard->mutex);
+    if (nlist + shard->nalloc > nlist_alloc) {
+      struct mb_mem_alloc_struct *list_new = (struct mb_mem_alloc_struct *)realloc(
+          list, (nlist + shard->nalloc + MB_MEMORY_ALLOC_STEP) * sizeof(struct mb_mem_alloc_struct));
+      if (list_new != NULL) {
+        list = list_new;
+        nlist_alloc = nlist + shard->nalloc + MB_MEMORY_ALLOC_STEP;
+      }
+    }
+    for (size_t i = 0; i < shard->nbucket; i++)
+      for (struct mb_mem_alloc_struct *alloc = shard->bucket[i]; alloc != NULL && nlist < nlist_alloc; alloc = alloc->next)
+        list[nlist++] = *alloc;
+    pthread_mutex_unlock(&shard->mutex);
+  }
+
+  if (nlist > 1)
+    qsort(list, nlist, sizeof(struct mb_mem_alloc_struct), mb_mem_alloc_compare);
+  for (size_t i = 0; i < nlist; i++)
+    fprintf(stderr, "%si:%zu  ptr:%p  size:%zu source:%s line:%d\n", prefix, i, list[i].ptr, list[i].size,
+            list[i].site != NULL ? list[i].site->sourcefile : "", list[i].site != NULL ? list[i].site->sourceline : 0);
+  free(list);
+}
 /*--------------------------------------------------------------------*/
 int mb_mem_list_enable(int verbose, int *error) {
 
@@ -66,9 +325,7 @@ int mb_mem_list_enable(int verbose, int *error) {
 
   if (verbose >= 6 || mb_mem_debug) {
     fprintf(stderr, "\ndbg6  Allocated memory list in MBIO function <%s>\n", __func__);
-    for (int i = 0; i < n_mb_alloc; i++)
-      fprintf(stderr, "dbg6       i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i],
-              mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
+    mb_mem_list_print("dbg6       ");
   }
 
   const int status = MB_SUCCESS;
@@ -124,9 +381,7 @@ int mb_mem_debug_on(int verbose, int *error) {
 
   /* if (verbose >= 6 || mb_mem_debug) */ {
     fprintf(stderr, "\ndbg6  Allocated memory list in MBIO function <%s>\n", __func__);
-    for (int i = 0; i < n_mb_alloc; i++)
-      fprintf(stderr, "dbg6       i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i],
-              mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
+    mb_mem_list_print("dbg6       ");
   }
 
   const int status = MB_SUCCESS;
@@ -156,9 +411,7 @@ int mb_mem_debug_off(int verbose, int *error) {
 
   if (verbose >= 6) {
     fprintf(stderr, "\ndbg6  Allocated memory list in MBIO function <%s>\n", __func__);
-    for (int i = 0; i < n_mb_alloc; i++)
-      fprintf(stderr, "dbg6       i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i],
-              mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
+    mb_mem_list_print("dbg6       ");
   }
 
   const int status = MB_SUCCESS;
@@ -176,73 +429,7 @@ int mb_mem_debug_off(int verbose, int *error) {
 
 /*--------------------------------------------------------------------*/
 int mb_malloc(int verbose, size_t size, void **ptr, int *error) {
-  if (verbose >= 2 || mb_mem_debug) {
-    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
-    fprintf(stderr, "dbg2  Input arguments:\n");
-    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
-    fprintf(stderr, "dbg2       size:       %zu\n", size);
-    fprintf(stderr, "dbg2       ptr:        %p\n", (void *)ptr);
-    fprintf(stderr, "dbg2       *ptr:       %p\n", (void *)*ptr);
-  }
-
-  /* allocate memory */
-  *ptr = NULL;
-  int status = MB_SUCCESS;
-  if (size > 0) {
-    if ((*ptr = (char *)malloc(size)) == NULL) {
-      *error = MB_ERROR_MEMORY_FAIL;
-      status = MB_FAILURE;
-    }
-    else {
-      *error = MB_ERROR_NO_ERROR;
-      status = MB_SUCCESS;
-    }
-  }
-  else {
-    *ptr = NULL;
-    *error = MB_ERROR_NO_ERROR;
-    status = MB_SUCCESS;
-  }
-
-  if ((verbose >= 5 || mb_mem_debug) && size > 0) {
-    fprintf(stderr, "\ndbg5  Memory allocated in MBIO function <%s>\n", __func__);
-    fprintf(stderr, "dbg5       i:%d  ptr:%p  size:%zu\n", n_mb_alloc, (void *)*ptr, size);
-  }
-
-  /* keep list of allocated memory */
-  if (mb_memory_list_enabled) {
-    /* add to list if size > 0 */
-    if (size > 0) {
-      if (n_mb_alloc < MB_MEMORY_HEAP_MAX) {
-        mb_alloc_ptr[n_mb_alloc] = *ptr;
-        mb_alloc_size[n_mb_alloc] = size;
-        n_mb_alloc++;
-      }
-      else {
-        mb_alloc_overflow = true;
-#ifdef MB_MEM_DEBUG
-        fprintf(stderr, "NOTICE: mbm_mem overflow pointer allocated %d in function %s\n", *ptr, __func__);
-#endif
-      }
-    }
-
-    if (verbose >= 6 || mb_mem_debug) {
-      fprintf(stderr, "\ndbg6  Allocated memory list in MBIO function <%s>\n", __func__);
-      for (int i = 0; i < n_mb_alloc; i++)
-        fprintf(stderr, "dbg6       i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i],
-                mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
-    }
-  }
-  if (verbose >= 2 || mb_mem_debug) {
-    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
-    fprintf(stderr, "dbg2  Return values:\n");
-    fprintf(stderr, "dbg2       ptr:        %p\n", (void *)*ptr);
-    fprintf(stderr, "dbg2       error:      %d\n", *error);
-    fprintf(stderr, "dbg2  Return status:\n");
-    fprintf(stderr, "dbg2       status:  %d\n", status);
-  }
-
-  return (status);
+  return (mb_mallocd(verbose, NULL, 0, size, ptr, error));
 }
 /*--------------------------------------------------------------------*/
 int mb_mallocd(int verbose, const char *sourcefile, int sourceline, size_t size, void **ptr, int *error) {
@@ -250,7 +437,7 @@ int mb_mallocd(int verbose, const char *sourcefile, int sourceline, size_t size,
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
     fprintf(stderr, "dbg2  Input arguments:\n");
     fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
-    fprintf(stderr, "dbg2       sourcefile: %s\n", sourcefile);
+    fprintf(stderr, "dbg2       sourcefile: %s\n", sourcefile != NULL ? sourcefile : "");
     fprintf(stderr, "dbg2       sourceline: %d\n", sourceline);
     fprintf(stderr, "dbg2       size:       %zu\n", size);
     fprintf(stderr, "dbg2       ptr:        %p\n", (void *)ptr);
@@ -278,34 +465,28 @@ int mb_mallocd(int verbose, const char *sourcefile, int sourceline, size_t size,
 
   /* keep list of allocated memory */
   if (mb_memory_list_enabled) {
-
-    if ((verbose >= 5 || mb_mem_debug) && size > 0) {
-      fprintf(stderr, "\ndbg5  Memory allocated in MBIO function <%s>\n", __func__);
-      fprintf(stderr, "dbg5       i:%d  ptr:%p  size:%zu\n", n_mb_alloc, (void *)*ptr, size);
-    }
-
     /* add to list if size > 0 */
-    if (size > 0) {
-      if (n_mb_alloc < MB_MEMORY_HEAP_MAX) {
-        mb_alloc_ptr[n_mb_alloc] = *ptr;
-        mb_alloc_size[n_mb_alloc] = size;
-        strncpy(mb_alloc_sourcefile[n_mb_alloc], sourcefile, MB_NAME_LENGTH - 1);
-        mb_alloc_sourceline[n_mb_alloc] = sourceline;
-        n_mb_alloc++;
+    if (status == MB_SUCCESS && size > 0) {
+      struct mb_mem_site_struct *site = mb_mem_site_get(sourcefile, sourceline);
+      if (mb_mem_list_insert(*ptr, size, site)) {
+        mb_mem_site_add(site, size);
       }
       else {
         mb_alloc_overflow = true;
-#ifdef MB_MEM_DEBUG
-        fprintf(stderr, "NOTICE: mbm_mem overflow pointer allocated %d in function %s\n", *ptr, __func__);
-#endif
+        if (mb_mem_debug)
+          fprintf(stderr, "NOTICE: mbm_mem overflow pointer allocated %p in function %s\n", *ptr, __func__);
       }
     }
 
+    if ((verbose >= 5 || mb_mem_debug) && size > 0) {
+      fprintf(stderr, "\ndbg5  Memory allocated in MBIO function <%s>\n", __func__);
+      fprintf(stderr, "dbg5       i:%d  ptr:%p  size:%zu source:%s line:%d\n", mb_mem_list_count(NULL), (void *)*ptr, size,
+              sourcefile != NULL ? sourcefile : "", sourceline);
+    }
+
     if (verbose >= 6 || mb_mem_debug) {
       fprintf(stderr, "\ndbg6  Allocated memory list in MBIO function <%s>\n", __func__);
-      for (int i = 0; i < n_mb_alloc; i++)
-        fprintf(stderr, "dbg6       i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i],
-                mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
+      mb_mem_list_print("dbg6       ");
     }
   }
 
@@ -321,25 +502,18 @@ int mb_mallocd(int verbose, const char *sourcefile, int sourceline, size_t size,
   return (status);
 }
 /*--------------------------------------------------------------------*/
-int mb_realloc(int verbose, size_t size, void **ptr, int *error) {
-  if (verbose >= 2 || mb_mem_debug) {
-    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
-    fprintf(stderr, "dbg2  Input arguments:\n");
-    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
-    fprintf(stderr, "dbg2       size:       %zu\n", size);
-    fprintf(stderr, "dbg2       ptr:        %p\n", (void *)ptr);
-    fprintf(stderr, "dbg2       *ptr:       %p\n", (void *)*ptr);
-  }
-
-
-  /* keep list of allocated memory */
-  int iptr = -1;
-  if (mb_memory_list_enabled) {
-    /* check if pointer is in list */
-    for (int i = 0; i < n_mb_alloc; i++)
-      if (mb_alloc_ptr[i] == *ptr)
-        iptr = i;
-  }
+/* reallocate *ptr - if sourcefile is NULL a tracked allocation keeps its
+    original call site */
+static int mb_mem_realloc(int verbose, const char *sourcefile, int sourceline, size_t size, void **ptr, int *error) {
+  /* keep list of allocated memory - the pointer is taken out of the list
+      before realloc so another thread cannot be given the same address
+      while it is still listed */
+  bool listed = false;
+  size_t oldsize = 0;
+  struct mb_mem_site_struct *oldsite = NULL;
+  void *oldptr = *ptr;
+  if (mb_memory_list_enabled)
+    listed = mb_mem_list_remove(*ptr, &oldsize, &oldsite);
 
   /* if pointer is non-NULL use realloc */
   if (*ptr != NULL)
@@ -354,170 +528,64 @@ int mb_realloc(int verbose, size_t size, void **ptr, int *error) {
   if (size > 0 && *ptr == NULL) {
     *error = MB_ERROR_MEMORY_FAIL;
     status = MB_FAILURE;
-  } else {
+  }
+  else {
     *error = MB_ERROR_NO_ERROR;
     status = MB_SUCCESS;
   }
 
   /* keep list of allocated memory */
   if (mb_memory_list_enabled) {
-    /* if pointer was already in list update it */
-    if (status == MB_SUCCESS && iptr > -1) {
-      /* if pointer non-NULL update it */
-      if (size > 0 && *ptr != NULL) {
-        mb_alloc_ptr[iptr] = *ptr;
-        mb_alloc_size[iptr] = size;
-      }
-
-      /* else remove it from list */
-      else {
-        for (int i = iptr; i < n_mb_alloc - 1; i++) {
-          mb_alloc_ptr[i] = mb_alloc_ptr[i + 1];
-          mb_alloc_size[i] = mb_alloc_size[i + 1];
-        }
-        n_mb_alloc--;
-      }
+    /* on failure the original memory is untouched so put it back */
+    if (status == MB_FAILURE && listed) {
+      *ptr = oldptr;
+      mb_mem_list_insert(oldptr, oldsize, oldsite);
     }
 
-    /* else add to list if possible if size > 0 */
-    else if (status == MB_SUCCESS && size > 0) {
-      if (n_mb_alloc < MB_MEMORY_HEAP_MAX) {
-        mb_alloc_ptr[n_mb_alloc] = *ptr;
-        mb_alloc_size[n_mb_alloc] = size;
-        n_mb_alloc++;
-      }
-      else {
-        mb_alloc_overflow = true;
-#ifdef MB_MEM_DEBUG
-        fprintf(stderr, "NOTICE: mbm_mem overflow pointer allocated %p in function %s\n", *ptr, __func__);
-#endif
+    /* else update the list */
+    else if (status == MB_SUCCESS) {
+      if (listed)
+        mb_mem_site_subtract(oldsite, oldsize);
+      if (size > 0 && *ptr != NULL) {
+        struct mb_mem_site_struct *site =
+            (sourcefile != NULL || oldsite == NULL) ? mb_mem_site_get(sourcefile, sourceline) : oldsite;
+        if (mb_mem_list_insert(*ptr, size, site)) {
+          mb_mem_site_add(site, size);
+        }
+        else {
+          mb_alloc_overflow = true;
+          if (mb_mem_debug)
+            fprintf(stderr, "NOTICE: mbm_mem overflow pointer allocated %p in function %s\n", *ptr, __func__);
+        }
       }
     }
 
     if ((verbose >= 5 || mb_mem_debug) && size > 0) {
       fprintf(stderr, "\ndbg5  Memory reallocated in MBIO function <%s>\n", __func__);
-      fprintf(stderr, "dbg5       i:%d  ptr:%p  size:%zu\n", n_mb_alloc, (void *)*ptr, size);
+      fprintf(stderr, "dbg5       i:%d  ptr:%p  size:%zu source:%s line:%d\n", mb_mem_list_count(NULL), (void *)*ptr, size,
+              sourcefile != NULL ? sourcefile : "", sourceline);
     }
 
     if (verbose >= 6 || mb_mem_debug) {
       fprintf(stderr, "\ndbg6  Allocated memory list in MBIO function <%s>\n", __func__);
-      for (int i = 0; i < n_mb_alloc; i++)
-        fprintf(stderr, "dbg6       i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i],
-                mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
+      mb_mem_list_print("dbg6       ");
     }
   }
 
-  /* assume success */
-  *error = MB_ERROR_NO_ERROR;
-  status = MB_SUCCESS;
-
-  if (verbose >= 2 || mb_mem_debug) {
-    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
-    fprintf(stderr, "dbg2  Return value:\n");
-    fprintf(stderr, "dbg2       ptr:        %p\n", (void *)*ptr);
-    fprintf(stderr, "dbg2       error:      %d\n", *error);
-    fprintf(stderr, "dbg2  Return status:\n");
-    fprintf(stderr, "dbg2       status:     %d\n", status);
-  }
-
   return (status);
 }
 /*--------------------------------------------------------------------*/
-int mb_reallocd(int verbose, const char *sourcefile, int sourceline, size_t size, void **ptr, int *error) {
+int mb_realloc(int verbose, size_t size, void **ptr, int *error) {
   if (verbose >= 2 || mb_mem_debug) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
     fprintf(stderr, "dbg2  Input arguments:\n");
     fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
-    fprintf(stderr, "dbg2       sourcefile: %s\n", sourcefile);
-    fprintf(stderr, "dbg2       sourceline: %d\n", sourceline);
     fprintf(stderr, "dbg2       size:       %zu\n", size);
     fprintf(stderr, "dbg2       ptr:        %p\n", (void *)ptr);
     fprintf(stderr, "dbg2       *ptr:       %p\n", (void *)*ptr);
   }
 
-  /* keep list of allocated memory */
-  int iptr = -1;
-  if (mb_memory_list_enabled) {
-    /* check if pointer is in list */
-    for (int i = 0; i < n_mb_alloc; i++) {
-      if (mb_alloc_ptr[i] == *ptr) {
-        iptr = i;
-      }
-    }
-  }
-
-  /* if pointer is non-NULL use realloc */
-  if (*ptr != NULL)
-    *ptr = (char *)realloc(*ptr, size);
-
-  /* if pointer is NULL use malloc */
-  else if (size > 0)
-    *ptr = (char *)malloc(size);
-
-  /* check for success */
-  int status = MB_SUCCESS;
-  if (size > 0 && *ptr == NULL) {
-    *error = MB_ERROR_MEMORY_FAIL;
-    status = MB_FAILURE;
-  }
-  else {
-    *error = MB_ERROR_NO_ERROR;
-    status = MB_SUCCESS;
-  }
-
-  /* keep list of allocated memory */
-  if (mb_memory_list_enabled) {
-    /* if pointer was already in list update it */
-    if (status == MB_SUCCESS && iptr > -1) {
-      /* if pointer non-NULL update it */
-      if (size > 0 && *ptr != NULL) {
-        mb_alloc_ptr[iptr] = *ptr;
-        mb_alloc_size[iptr] = size;
-        strncpy(mb_alloc_sourcefile[iptr], sourcefile, MB_NAME_LENGTH - 1);
-        mb_alloc_sourceline[iptr] = sourceline;
-      }
-
-      /* else remove it from list */
-      else {
-        for (int i = iptr; i < n_mb_alloc - 1; i++) {
-          mb_alloc_ptr[i] = mb_alloc_ptr[i + 1];
-          mb_alloc_size[i] = mb_alloc_size[i + 1];
-          strncpy(mb_alloc_sourcefile[i], mb_alloc_sourcefile[i + 1], MB_NAME_LENGTH - 1);
-          mb_alloc_sourceline[i] = mb_alloc_sourceline[i + 1];
-        }
-        n_mb_alloc--;
-      }
-    }
-
-    /* else add to list if possible if size > 0 */
-    else if (status == MB_SUCCESS && size > 0) {
-      if (n_mb_alloc < MB_MEMORY_HEAP_MAX) {
-        mb_alloc_ptr[n_mb_alloc] = *ptr;
-        mb_alloc_size[n_mb_alloc] = size;
-        strncpy(mb_alloc_sourcefile[n_mb_alloc], sourcefile, MB_NAME_LENGTH - 1);
-        mb_alloc_sourceline[n_mb_alloc] = sourceline;
-        n_mb_alloc++;
-      }
-      else {
-        mb_alloc_overflow = true;
-        if (mb_mem_debug)
-          fprintf(stderr, "NOTICE: mbm_mem overflow pointer allocated %p in function %s\n", *ptr, __func__);
-      }
-    }
-
-    if ((verbose >= 5 || mb_mem_debug) && size > 0) {
-      fprintf(stderr, "\ndbg5  Memory reallocated in MBIO function <%s>\n", __func__);
-      fprintf(stderr, "dbg5       i:%d  ptr:%p  size:%zu source:%s line:%d\n", n_mb_alloc, (void *)*ptr, size, sourcefile,
-              sourceline);
-    }
-
-    if (verbose >= 6 || mb_mem_debug) {
-      fprintf(stderr, "\ndbg6  Allocated memory list in MBIO function <%s>\n", __func__);
-      for (int i = 0; i < n_mb_alloc; i++)
-        fprintf(stderr, "dbg6       i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i],
-                mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
-    }
-  }
+  int status = mb_mem_realloc(verbose, NULL, 0, size, ptr, error);
 
   /* assume success */
   *error = MB_ERROR_NO_ERROR;
@@ -535,85 +603,28 @@ int mb_reallocd(int verbose, const char *sourcefile, int sourceline, size_t size
   return (status);
 }
 /*--------------------------------------------------------------------*/
-int mb_free(int verbose, void **ptr, int *error) {
-  verbose = 5;
+int mb_reallocd(int verbose, const char *sourcefile, int sourceline, size_t size, void **ptr, int *error) {
   if (verbose >= 2 || mb_mem_debug) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
     fprintf(stderr, "dbg2  Input arguments:\n");
     fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
-    fprintf(stderr, "dbg2       ptr:        %p\n", (void *)*ptr);
-  }
-
-  /* if keeping list of allocated memory then free memory only if it is in
-      the list or list has overflowed */
-  if (mb_memory_list_enabled) {
-    /* check if pointer is in list */
-    int iptr = -1;
-    for (int i = 0; i < n_mb_alloc; i++) {
-      if (mb_alloc_ptr[i] == *ptr) {
-        iptr = i;
-      }
-    }
-
-    /* if pointer is in list remove it from list */
-    size_t ptrsize;
-    void *ptrvalue;
-    if (iptr > -1) {
-      /* remove it from list */
-      ptrvalue = mb_alloc_ptr[iptr];
-      ptrsize = mb_alloc_size[iptr];
-      for (int i = iptr; i < n_mb_alloc - 1; i++) {
-        mb_alloc_ptr[i] = mb_alloc_ptr[i + 1];
-        mb_alloc_size[i] = mb_alloc_size[i + 1];
-        strncpy(mb_alloc_sourcefile[i], mb_alloc_sourcefile[i + 1], MB_NAME_LENGTH - 1);
-        mb_alloc_sourceline[i] = mb_alloc_sourceline[i + 1];
-      }
-      n_mb_alloc--;
-
-      /* free the memory */
-      if (*ptr != NULL) {
-        free(*ptr);
-        *ptr = NULL;
-      }
-    }
-
-    /* else heap overflow has occurred */
-    else if (mb_alloc_overflow && *ptr != NULL) {
-#ifdef MB_MEM_DEBUG
-      fprintf(stderr, "NOTICE: mbm_mem overflow pointer freed %d in function %s\n", *ptr, __func__);
-#endif
-
-      /* free the memory */
-      free(*ptr);
-      *ptr = NULL;
-    }
-
-    if ((verbose >= 5 || mb_mem_debug) && iptr > -1) {
-      fprintf(stderr, "\ndbg5  Allocated memory freed in MBIO function <%s>\n", __func__);
-      fprintf(stderr, "dbg5       i:%d  ptr:%p  size:%zu\n", iptr, ptrvalue, ptrsize);
-    }
-
-    if (verbose >= 6 || mb_mem_debug) {
-      fprintf(stderr, "\ndbg6  Allocated memory list in MBIO function <%s>\n", __func__);
-      for (int i = 0; i < n_mb_alloc; i++)
-        fprintf(stderr, "dbg6       i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i],
-                mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
-    }
+    fprintf(stderr, "dbg2       sourcefile: %s\n", sourcefile);
+    fprintf(stderr, "dbg2       sourceline: %d\n", sourceline);
+    fprintf(stderr, "dbg2       size:       %zu\n", size);
+    fprintf(stderr, "dbg2       ptr:        %p\n", (void *)ptr);
+    fprintf(stderr, "dbg2       *ptr:       %p\n", (void *)*ptr);
   }
 
-  /* else if memory list is not being kept and *ptr != NULL, just free the memory */
-  else if (*ptr != NULL) {
-    free(*ptr);
-    *ptr = NULL;
-  }
+  int status = mb_mem_realloc(verbose, sourcefile != NULL ? sourcefile : "", sourceline, size, ptr, error);
 
   /* assume success */
   *error = MB_ERROR_NO_ERROR;
-  const int status = MB_SUCCESS;
+  status = MB_SUCCESS;
 
   if (verbose >= 2 || mb_mem_debug) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
     fprintf(stderr, "dbg2  Return value:\n");
+    fprintf(stderr, "dbg2       ptr:        %p\n", (void *)*ptr);
     fprintf(stderr, "dbg2       error:      %d\n", *error);
     fprintf(stderr, "dbg2  Return status:\n");
     fprintf(stderr, "dbg2       status:     %d\n", status);
@@ -622,12 +633,16 @@ int mb_free(int verbose, void **ptr, int *error) {
   return (status);
 }
 /*--------------------------------------------------------------------*/
+int mb_free(int verbose, void **ptr, int *error) {
+  return (mb_freed(verbose, NULL, 0, ptr, error));
+}
+/*--------------------------------------------------------------------*/
 int mb_freed(int verbose, const char *sourcefile, int sourceline, void **ptr, int *error) {
   if (verbose >= 2 || mb_mem_debug) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
     fprintf(stderr, "dbg2  Input arguments:\n");
     fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
-    fprintf(stderr, "dbg2       sourcefile: %s\n", sourcefile);
+    fprintf(stderr, "dbg2       sourcefile: %s\n", sourcefile != NULL ? sourcefile : "");
     fprintf(stderr, "dbg2       sourceline: %d\n", sourceline);
     fprintf(stderr, "dbg2       *ptr:       %p\n", (void *)ptr);
     fprintf(stderr, "dbg2       ptr:        %p\n", (void *)*ptr);
@@ -636,55 +651,37 @@ int mb_freed(int verbose, const char *sourcefile, int sourceline, void **ptr, in
   /* if keeping list of allocated memory then free memory only if it is in
       the list or list has overflowed */
   if (mb_memory_list_enabled) {
-    /* check if pointer is in list */
-    int iptr = -1;
-    for (int i = 0; i < n_mb_alloc; i++)
-      if (ptr != NULL && mb_alloc_ptr[i] == *ptr)
-        iptr = i;
-
     /* if pointer is in list remove it from list */
-    size_t ptrsize;
-    long ptrvalue;
-    if (iptr > -1) {
-      /* remove it from list */
-      ptrvalue = (size_t)mb_alloc_ptr[iptr];
-      ptrsize = mb_alloc_size[iptr];
-      for (int i = iptr; i < n_mb_alloc - 1; i++) {
-        mb_alloc_ptr[i] = mb_alloc_ptr[i + 1];
-        mb_alloc_size[i] = mb_alloc_size[i + 1];
-        strncpy(mb_alloc_sourcefile[i], mb_alloc_sourcefile[i + 1], MB_NAME_LENGTH - 1);
-        mb_alloc_sourceline[i] = mb_alloc_sourceline[i + 1];
-      }
-      n_mb_alloc--;
+    size_t ptrsize = 0;
+    struct mb_mem_site_struct *site = NULL;
+    void *ptrvalue = *ptr;
+    const bool listed = mb_mem_list_remove(*ptr, &ptrsize, &site);
+    if (listed) {
+      mb_mem_site_subtract(site, ptrsize);
 
       /* free the memory */
-      if (*ptr != NULL) {
-        free(*ptr);
-        *ptr = NULL;
-      }
+      free(*ptr);
+      *ptr = NULL;
     }
 
-    /* else  heap overflow has occurred */
+    /* else heap overflow has occurred */
     else if (mb_alloc_overflow && *ptr != NULL) {
-  #ifdef MB_MEM_DEBUG
-      fprintf(stderr, "NOTICE: mbm_mem overflow pointer freed %d in function %s\n", *ptr, __func__);
-  #endif
+      if (mb_mem_debug)
+        fprintf(stderr, "NOTICE: mbm_mem overflow pointer freed %p in function %s\n", *ptr, __func__);
 
       /* free the memory */
       free(*ptr);
       *ptr = NULL;
     }
 
-    if ((verbose >= 5 || mb_mem_debug) && iptr > -1) {
+    if ((verbose >= 5 || mb_mem_debug) && listed) {
       fprintf(stderr, "\ndbg5  Allocated memory freed in MBIO function <%s>\n", __func__);
-      fprintf(stderr, "dbg5       i:%d  ptr:%p  size:%zu\n", iptr, (void *)ptrvalue, ptrsize);
+      fprintf(stderr, "dbg5       i:%d  ptr:%p  size:%zu\n", mb_mem_list_count(NULL), ptrvalue, ptrsize);
     }
 
     if (verbose >= 6 || mb_mem_debug) {
       fprintf(stderr, "\ndbg6  Allocated memory list in MBIO function <%s>\n", __func__);
-      for (int i = 0; i < n_mb_alloc; i++)
-        fprintf(stderr, "dbg6       i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i],
-                mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
+      mb_mem_list_print("dbg6       ");
     }
   }
 
@@ -719,21 +716,32 @@ int mb_memory_clear(int verbose, int *error) {
   /* keep list of allocated memory */
   if (mb_memory_list_enabled) {
     /* loop over all allocated memory */
-    for (int i = 0; i < n_mb_alloc; i++) {
-      if (verbose >= 5 || mb_mem_debug) {
-        fprintf(stderr, "\ndbg5  Allocated memory freed in MBIO function <%s>\n", __func__);
-        fprintf(stderr, "dbg4       i:%d  ptr:%12p  size:%zu\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i]);
+    int i = 0;
+    pthread_once(&mb_mem_once, mb_mem_init);
+    for (int ishard = 0; ishard < MB_MEMORY_SHARDS; ishard++) {
+      struct mb_mem_shard_struct *shard = &mb_mem_shards[ishard];
+      pthread_mutex_lock(&shard->mutex);
+      for (size_t ibucket = 0; ibucket < shard->nbucket; ibucket++) {
+        while (shard->bucket[ibucket] != NULL) {
+          struct mb_mem_alloc_struct *alloc = shard->bucket[ibucket];
+          if (verbose >= 5 || mb_mem_debug) {
+            fprintf(stderr, "\ndbg5  Allocated memory freed in MBIO function <%s>\n", __func__);
+            fprintf(stderr, "dbg4       i:%d  ptr:%12p  size:%zu\n", i, alloc->ptr, alloc->size);
+          }
+          i++;
+
+          /* free the memory */
+          free(alloc->ptr);
+          mb_mem_site_subtract(alloc->site, alloc->size);
+          shard->bucket[ibucket] = alloc->next;
+          alloc->next = shard->spare;
+          shard->spare = alloc;
+        }
       }
-
-      /* free the memory */
-      if (mb_alloc_ptr[i] != NULL)
-        free(mb_alloc_ptr[i]);
-      mb_alloc_ptr[i] = NULL;
-      mb_alloc_size[i] = 0;
-      (mb_alloc_sourcefile[i])[0] = 0;
-      mb_alloc_sourceline[i] = 0;
+      shard->nalloc = 0;
+      shard->allocsize = 0;
+      pthread_mutex_unlock(&shard->mutex);
     }
-    n_mb_alloc = 0;
   }
 
   /* assume success */
@@ -765,13 +773,10 @@ int mb_memory_status(int verbose, int *nalloc, int *nallocmax, int *overflow, si
 
   /* keep list of allocated memory */
   if (mb_memory_list_enabled) {
-    /* get status */
-    *nalloc = n_mb_alloc;
-    *nallocmax = MB_MEMORY_HEAP_MAX;
+    /* get status - the list has no fixed size limit */
+    *nalloc = mb_mem_list_count(allocsize);
+    *nallocmax = INT_MAX;
     *overflow = mb_alloc_overflow;
-    *allocsize = 0;
-    for (int i = 0; i < n_mb_alloc; i++)
-      *allocsize += mb_alloc_size[i];
   }
 
   /* assume success */
@@ -802,22 +807,19 @@ int mb_memory_list(int verbose, int *error) {
 
   /* keep list of allocated memory */
   if (mb_memory_list_enabled) {
+    const int nalloc = mb_mem_list_count(NULL);
     if (verbose >= 4 || mb_mem_debug) {
-      if (n_mb_alloc > 0) {
+      if (nalloc > 0) {
         fprintf(stderr, "\ndbg4  Allocated memory list in MBIO function <%s>\n", __func__);
-        for (int i = 0; i < n_mb_alloc; i++)
-          fprintf(stderr, "dbg6       i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i],
-                  mb_alloc_size[i], mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
+        mb_mem_list_print("dbg6       ");
       }
       else {
         fprintf(stderr, "\ndbg4  No memory currently allocated in MBIO function <%s>\n", __func__);
       }
     }
-    else if (n_mb_alloc > 0) {
+    else if (nalloc > 0) {
       fprintf(stderr, "\nWarning: some objects are still allocated in memory:\n");
-      for (int i = 0; i < n_mb_alloc; i++)
-        fprintf(stderr, "     i:%d  ptr:%p  size:%zu source:%s line:%d\n", i, (void *)mb_alloc_ptr[i], mb_alloc_size[i],
-                mb_alloc_sourcefile[i], mb_alloc_sourceline[i]);
+      mb_mem_list_print("     ");
       fprintf(stderr, "Probable failure in MB-System garbage collection...\n");
     }
   }
@@ -837,6 +839,74 @@ int mb_memory_list(int verbose, int *error) {
   return (status);
 }
 /*--------------------------------------------------------------------*/
+static int mb_mem_site_compare(const void *a, const void *b) {
+  const struct mb_mem_site_struct *site_a = (const struct mb_mem_site_struct *)a;
+  const struct mb_mem_site_struct *site_b = (const struct mb_mem_site_struct *)b;
+  if (site_a->size != site_b->size)
+    return (site_a->size > site_b->size ? -1 : 1);
+  if (site_a->size_max != site_b->size_max)
+    return (site_a->size_max > site_b->size_max ? -1 : 1);
+  const int cmp = strcmp(site_a->sourcefile, site_b->sourcefile);
+  if (cmp != 0)
+    return (cmp);
+  return (site_a->sourceline - site_b->sourceline);
+}
+/*--------------------------------------------------------------------*/
+int mb_memory_sites(int verbose, int *error) {
+  if (verbose >= 2 || mb_mem_debug) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+  }
+
+  /* copy the call sites so that no lock is held while printing */
+  size_t nsite = 0;
+  size_t nsite_alloc = 0;
+  struct mb_mem_site_struct *sites = NULL;
+  pthread_once(&mb_mem_once, mb_mem_init);
+  for (int ishard = 0; ishard < MB_MEMORY_SHARDS; ishard++) {
+    struct mb_mem_site_shard_struct *shard = &mb_mem_site_shards[ishard];
+    pthread_mutex_lock(&shard->mutex);
+    for (struct mb_mem_site_struct *site = shard->site; site != NULL; site = site->next) {
+      if (nsite >= nsite_alloc) {
+        struct mb_mem_site_struct *sites_new = (struct mb_mem_site_struct *)realloc(
+            sites, (nsite_alloc + MB_MEMORY_ALLOC_STEP) * sizeof(struct mb_mem_site_struct));
+        if (sites_new == NULL)
+          break;
+        sites = sites_new;
+        nsite_alloc += MB_MEMORY_ALLOC_STEP;
+      }
+      sites[nsite++] = *site;
+    }
+    pthread_mutex_unlock(&shard->mutex);
+  }
+
+  /* list the call sites holding the most memory first */
+  if (nsite > 1)
+    qsort(sites, nsite, sizeof(struct mb_mem_site_struct), mb_mem_site_compare);
+  fprintf(stderr, "\nMemory allocated by source location:\n");
+  fprintf(stderr, "  %14s %14s %10s %10s  %s\n", "bytes", "peak bytes", "allocated", "calls", "source:line");
+  for (size_t i = 0; i < nsite; i++)
+    fprintf(stderr, "  %14zu %14zu %10zu %10zu  %s:%d\n", sites[i].size, sites[i].size_max, sites[i].nalloc,
+            sites[i].ncall, sites[i].sourcefile, sites[i].sourceline);
+  free(sites);
+
+  /* assume success */
+  *error = MB_ERROR_NO_ERROR;
+  const int status = MB_SUCCESS;
+
+  if (verbose >= 2 || mb_mem_debug) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return value:\n");
+    fprintf(stderr, "dbg2       nsite:      %zu\n", nsite);
+    fprintf(stderr, "dbg2       error:      %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:  %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
 int mb_register_array(int verbose, void *mbio_ptr, int type, size_t size, void **handle, int *error) {
   if (verbose >= 2 || mb_mem_debug) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
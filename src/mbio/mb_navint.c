@@ -46,6 +46,296 @@
 //    #define MB_DEPINT_DEBUG 1
 //    #define MB_ALTINT_DEBUG 1
 
+/*--------------------------------------------------------------------*/
+/* 	The asynchronous data used for interpolation are held in ring
+        buffers (struct mb_asynch_struct) that are allocated as samples
+        arrive, doubling in size up to MB_ASYNCH_SAVE_MAX samples, after
+        which each new sample replaces the oldest. Samples are indexed
+        from the oldest (0) to the newest (nsample - 1). */
+
+/* initial number of samples allocated in an asynchronous data buffer */
+#define MB_ASYNCH_SAVE_START 64
+
+/* ring buffer location of sample i */
+static inline int mb_asynch_ring(const struct mb_asynch_struct *asynch, int i) {
+	const int k = asynch->first + i;
+	return (k < asynch->nalloc ? k : k - asynch->nalloc);
+}
+
+/* time stamp of sample i */
+static inline double mb_asynch_time(const struct mb_asynch_struct *asynch, int i) {
+	return (asynch->time_d[mb_asynch_ring(asynch, i)]);
+}
+
+/* value j of sample i */
+static inline double mb_asynch_value(const struct mb_asynch_struct *asynch, int i, int j) {
+	return (asynch->value[mb_asynch_ring(asynch, i) * asynch->nvalue + j]);
+}
+
+/*--------------------------------------------------------------------*/
+/* 	function mb_asynch_add appends a sample with nvalue values to an
+        asynchronous data buffer. */
+static int mb_asynch_add(int verbose, struct mb_asynch_struct *asynch, int nvalue, double time_d, const double *value,
+                         int *error) {
+	int status = MB_SUCCESS;
+
+	/* if the buffer is full either enlarge it or drop the oldest sample */
+	if (asynch->nsample >= asynch->nalloc) {
+		if (asynch->nalloc < MB_ASYNCH_SAVE_MAX) {
+			const int nalloc = MIN(MAX(2 * asynch->nalloc, MB_ASYNCH_SAVE_START), MB_ASYNCH_SAVE_MAX);
+			double *time_d_new = NULL;
+			double *value_new = NULL;
+			status = mb_mallocd(verbose, __FILE__, __LINE__, nalloc * sizeof(double), (void **)&time_d_new, error);
+			if (status == MB_SUCCESS)
+				status = mb_mallocd(verbose, __FILE__, __LINE__, nalloc * nvalue * sizeof(double), (void **)&value_new, error);
+			if (status != MB_SUCCESS) {
+				if (time_d_new != NULL)
+					mb_freed(verbose, __FILE__, __LINE__, (void **)&time_d_new, error);
+				*error = MB_ERROR_MEMORY_FAIL;
+				return (MB_FAILURE);
+			}
+
+			/* copy the samples in order, oldest first */
+			for (int i = 0; i < asynch->nsample; i++) {
+				const int k = mb_asynch_ring(asynch, i);
+				time_d_new[i] = asynch->time_d[k];
+				memcpy(&value_new[i * nvalue], &asynch->value[k * nvalue], nvalue * sizeof(double));
+			}
+			if (asynch->time_d != NULL)
+				mb_freed(verbose, __FILE__, __LINE__, (void **)&asynch->time_d, error);
+			if (asynch->value != NULL)
+				mb_freed(verbose, __FILE__, __LINE__, (void **)&asynch->value, error);
+			asynch->time_d = time_d_new;
+			asynch->value = value_new;
+			asynch->nalloc = nalloc;
+			asynch->first = 0;
+		}
+		else {
+			asynch->first = mb_asynch_ring(asynch, 1);
+			asynch->nsample--;
+			asynch->cursor--;
+		}
+	}
+
+	/* add the new sample */
+	asynch->unroll_current = false;
+	const int k = mb_asynch_ring(asynch, asynch->nsample);
+	asynch->nvalue = nvalue;
+	asynch->time_d[k] = time_d;
+	memcpy(&asynch->value[k * nvalue], value, nvalue * sizeof(double));
+	asynch->nsample++;
+
+	return (status);
+}
+
+/*--------------------------------------------------------------------*/
+/* 	function mb_asynch_find returns the index i of the sample such that
+        time_d falls between the time stamps of samples i - 1 and i. The
+        buffer must hold at least two samples spanning time_d. The
+        search starts from the interval found by the previous call, as
+        successive pings usually fall in the same or the next interval,
+        and otherwise bisects the time stamps. */
+static int mb_asynch_find(struct mb_asynch_struct *asynch, double time_d) {
+	/* check the cached interval and the one after it */
+	for (int ifix = asynch->cursor; ifix <= asynch->cursor + 1; ifix++) {
+		if (ifix >= 1 && ifix < asynch->nsample && mb_asynch_time(asynch, ifix - 1) <= time_d &&
+		    time_d <= mb_asynch_time(asynch, ifix)) {
+			asynch->cursor = ifix;
+			return (ifix);
+		}
+	}
+
+	/* find the first sample at or after time_d */
+	int ilo = 1;
+	int ihi = asynch->nsample - 1;
+	while (ilo < ihi) {
+		const int imid = (ilo + ihi) / 2;
+		if (mb_asynch_time(asynch, imid) < time_d)
+			ilo = imid + 1;
+		else
+			ihi = imid;
+	}
+	asynch->cursor = ilo;
+	return (ilo);
+}
+
+/*--------------------------------------------------------------------*/
+/* 	function mb_asynch_deall frees the asynchronous data buffers
+        used for interpolation/extrapolation. */
+int mb_asynch_deall(int verbose, void *mbio_ptr, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+	}
+
+	/* get pointers to mbio descriptor and data structures */
+	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+
+	int status = MB_SUCCESS;
+	struct mb_asynch_struct *asynchs[5] = {&mb_io_ptr->asynch_fix, &mb_io_ptr->asynch_attitude, &mb_io_ptr->asynch_heading,
+	                                       &mb_io_ptr->asynch_sensordepth, &mb_io_ptr->asynch_altitude};
+	for (int i = 0; i < 5; i++) {
+		if (asynchs[i]->time_d != NULL)
+			status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&asynchs[i]->time_d, error);
+		if (asynchs[i]->value != NULL)
+			status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&asynchs[i]->value, error);
+		if (asynchs[i]->unroll != NULL)
+			status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&asynchs[i]->unroll, error);
+		memset(asynchs[i], 0, sizeof(struct mb_asynch_struct));
+	}
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return value:\n");
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+
+/*--------------------------------------------------------------------*/
+/* 	function mb_asynch_reset discards the samples held in an asynchronous
+        data buffer without releasing its memory. */
+int mb_asynch_reset(int verbose, void *asynch_ptr, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       asynch_ptr: %p\n", (void *)asynch_ptr);
+	}
+
+	struct mb_asynch_struct *asynch = (struct mb_asynch_struct *)asynch_ptr;
+	asynch->nsample = 0;
+	asynch->first = 0;
+	asynch->cursor = 0;
+	asynch->unroll_current = false;
+
+	const int status = MB_SUCCESS;
+	*error = MB_ERROR_NO_ERROR;
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return value:\n");
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+
+/*--------------------------------------------------------------------*/
+/* 	function mb_asynch_sample returns the time stamp and values of sample
+        isample of an asynchronous data buffer, counting from the oldest
+        (0) to the newest (nsample - 1). The value array must hold as
+        many values as the buffer stores per sample. */
+int mb_asynch_sample(int verbose, void *asynch_ptr, int isample, double *time_d, double *value, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       asynch_ptr: %p\n", (void *)asynch_ptr);
+		fprintf(stderr, "dbg2       isample:    %d\n", isample);
+	}
+
+	struct mb_asynch_struct *asynch = (struct mb_asynch_struct *)asynch_ptr;
+
+	int status = MB_SUCCESS;
+	if (isample >= 0 && isample < asynch->nsample) {
+		*time_d = mb_asynch_time(asynch, isample);
+		for (int j = 0; j < asynch->nvalue; j++)
+			value[j] = mb_asynch_value(asynch, isample, j);
+		*error = MB_ERROR_NO_ERROR;
+	}
+	else {
+		*time_d = 0.0;
+		status = MB_FAILURE;
+		*error = MB_ERROR_NOT_ENOUGH_DATA;
+	}
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return value:\n");
+		fprintf(stderr, "dbg2       time_d:     %f\n", *time_d);
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+
+/*--------------------------------------------------------------------*/
+/* 	function mb_asynch_unroll copies the samples of an asynchronous data
+        buffer in time order into contiguous arrays for code that expects
+        plain arrays, e.g. the preprocess parameters. On return time_d
+        holds the nsample time stamps and value holds the nsample values
+        of the first quantity followed by those of each later quantity,
+        i.e. value j of sample i is value[j * nsample + i]. The arrays
+        belong to the buffer and are valid until the next call. The
+        samples are only copied again if the buffer has changed since
+        the previous call. */
+int mb_asynch_unroll(int verbose, void *asynch_ptr, int *nsample, double **time_d, double **value, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       asynch_ptr: %p\n", (void *)asynch_ptr);
+	}
+
+	struct mb_asynch_struct *asynch = (struct mb_asynch_struct *)asynch_ptr;
+
+	int status = MB_SUCCESS;
+	*error = MB_ERROR_NO_ERROR;
+	const int n = asynch->nsample;
+	const int nunroll = asynch->nalloc * (1 + asynch->nvalue);
+	if (asynch->nunroll < nunroll) {
+		asynch->unroll_current = false;
+		status = mb_reallocd(verbose, __FILE__, __LINE__, nunroll * sizeof(double), (void **)&asynch->unroll, error);
+		if (status == MB_SUCCESS)
+			asynch->nunroll = nunroll;
+		else
+			asynch->nunroll = 0;
+	}
+
+	if (status == MB_SUCCESS && n > 0) {
+		*nsample = n;
+		*time_d = asynch->unroll;
+		*value = &asynch->unroll[n];
+		if (!asynch->unroll_current) {
+			for (int i = 0; i < n; i++) {
+				const int k = mb_asynch_ring(asynch, i);
+				(*time_d)[i] = asynch->time_d[k];
+				for (int j = 0; j < asynch->nvalue; j++)
+					(*value)[j * n + i] = asynch->value[k * asynch->nvalue + j];
+			}
+			asynch->unroll_current = true;
+		}
+	}
+	else {
+		*nsample = 0;
+		*time_d = NULL;
+		*value = NULL;
+	}
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return value:\n");
+		fprintf(stderr, "dbg2       nsample:    %d\n", *nsample);
+		fprintf(stderr, "dbg2       time_d:     %p\n", (void *)*time_d);
+		fprintf(stderr, "dbg2       value:      %p\n", (void *)*value);
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+
 /*--------------------------------------------------------------------*/
 /* 	function mb_navint_add adds a nav fix to the internal
         list used for interpolation/extrapolation. */
@@ -62,49 +352,36 @@ int mb_navint_add(int verbose, void *mbio_ptr, double time_d, double lon_easting
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *fix = &mb_io_ptr->asynch_fix;
 
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  Current nav fix values:\n");
-		for (int i = 0; i < mb_io_ptr->nfix; i++)
-			fprintf(stderr, "dbg2       nav fix[%2d]:   %f %f %f\n", i, mb_io_ptr->fix_time_d[i], mb_io_ptr->fix_lon[i],
-			        mb_io_ptr->fix_lat[i]);
+		for (int i = 0; i < fix->nsample; i++)
+			fprintf(stderr, "dbg2       nav fix[%2d]:   %f %f %f\n", i, mb_asynch_time(fix, i), mb_asynch_value(fix, i, 0),
+			        mb_asynch_value(fix, i, 1));
 	}
 
-	/* add another fix only if time stamp has changed */
-	if (mb_io_ptr->nfix == 0 || (time_d > mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1])) {
-		/* if list if full make room for another nav fix */
-		if (mb_io_ptr->nfix >= MB_ASYNCH_SAVE_MAX) {
-			int shift = MB_ASYNCH_SAVE_MAX / 2;
-			for (int i = 0; i < mb_io_ptr->nfix - shift; i++) {
-				mb_io_ptr->fix_time_d[i] = mb_io_ptr->fix_time_d[i + shift];
-				mb_io_ptr->fix_lon[i] = mb_io_ptr->fix_lon[i + shift];
-				mb_io_ptr->fix_lat[i] = mb_io_ptr->fix_lat[i + shift];
-			}
-			mb_io_ptr->nfix -= shift;
-		}
+	int status = MB_SUCCESS;
 
+	/* add another fix only if time stamp has changed */
+	if (fix->nsample == 0 || (time_d > mb_asynch_time(fix, fix->nsample - 1))) {
 		/* add new fix to list */
-		mb_io_ptr->fix_time_d[mb_io_ptr->nfix] = time_d;
-		mb_io_ptr->fix_lon[mb_io_ptr->nfix] = lon_easting;
-		mb_io_ptr->fix_lat[mb_io_ptr->nfix] = lat_northing;
-		mb_io_ptr->nfix++;
+		const double value[2] = {lon_easting, lat_northing};
+		status = mb_asynch_add(verbose, fix, 2, time_d, value, error);
 #ifdef MB_NAVINT_DEBUG
-		fprintf(stderr, "mb_navint_add:    Nav fix %d %f %f added\n", mb_io_ptr->nfix, lon_easting, lat_northing);
+		fprintf(stderr, "mb_navint_add:    Nav fix %d %f %f added\n", fix->nsample, lon_easting, lat_northing);
 #endif
 
-		if (verbose >= 4) {
+		if (verbose >= 4 && status == MB_SUCCESS) {
 			fprintf(stderr, "\ndbg4  Nav fix added to list by MBIO function <%s>\n", __func__);
 			fprintf(stderr, "dbg4  New fix values:\n");
-			fprintf(stderr, "dbg4       nfix:       %d\n", mb_io_ptr->nfix);
-			fprintf(stderr, "dbg4       time_d:     %f\n", mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1]);
-			fprintf(stderr, "dbg4       fix_lon:    %f\n", mb_io_ptr->fix_lon[mb_io_ptr->nfix - 1]);
-			fprintf(stderr, "dbg4       fix_lat:    %f\n", mb_io_ptr->fix_lat[mb_io_ptr->nfix - 1]);
+			fprintf(stderr, "dbg4       nfix:       %d\n", fix->nsample);
+			fprintf(stderr, "dbg4       time_d:     %f\n", mb_asynch_time(fix, fix->nsample - 1));
+			fprintf(stderr, "dbg4       fix_lon:    %f\n", mb_asynch_value(fix, fix->nsample - 1, 0));
+			fprintf(stderr, "dbg4       fix_lat:    %f\n", mb_asynch_value(fix, fix->nsample - 1, 1));
 		}
 	}
 
-	/* assume success */
-	int status = MB_SUCCESS;
-
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
 		fprintf(stderr, "dbg2  Return value:\n");
@@ -112,12 +389,11 @@ int mb_navint_add(int verbose, void *mbio_ptr, double time_d, double lon_easting
 		fprintf(stderr, "dbg2  Return status:\n");
 		fprintf(stderr, "dbg2       status:     %d\n", status);
 		fprintf(stderr, "\ndbg2  Current nav fix values:\n");
-		for (int i = 0; i < mb_io_ptr->nfix; i++)
-			fprintf(stderr, "dbg2       nav fix[%2d]:   %f %f %f\n", i, mb_io_ptr->fix_time_d[i], mb_io_ptr->fix_lon[i],
-			        mb_io_ptr->fix_lat[i]);
+		for (int i = 0; i < fix->nsample; i++)
+			fprintf(stderr, "dbg2       nav fix[%2d]:   %f %f %f\n", i, mb_asynch_time(fix, i), mb_asynch_value(fix, i, 0),
+			        mb_asynch_value(fix, i, 1));
 	}
 
-	/* return success */
 	return (status);
 }
 /*--------------------------------------------------------------------*/
@@ -145,37 +421,31 @@ int mb_navint_interp(int verbose, void *mbio_ptr, double time_d, double heading,
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *fix = &mb_io_ptr->asynch_fix;
+	const int nfix = fix->nsample;
 
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  Current nav fix values:\n");
-		for (int i = 0; i < mb_io_ptr->nfix; i++)
-			fprintf(stderr, "dbg2       nav fix[%2d]:   %f %f %f\n", i, mb_io_ptr->fix_time_d[i], mb_io_ptr->fix_lon[i],
-			        mb_io_ptr->fix_lat[i]);
+		for (int i = 0; i < nfix; i++)
+			fprintf(stderr, "dbg2       nav fix[%2d]:   %f %f %f\n", i, mb_asynch_time(fix, i), mb_asynch_value(fix, i, 0),
+			        mb_asynch_value(fix, i, 1));
 	}
 
 	/* get degrees to meters conversion if fix available */
-	if (mb_io_ptr->nfix > 0) {
-		mb_coor_scale(verbose, mb_io_ptr->fix_lat[mb_io_ptr->nfix - 1], &mtodeglon, &mtodeglat);
+	if (nfix > 0) {
+		mb_coor_scale(verbose, mb_asynch_value(fix, nfix - 1, 1), &mtodeglon, &mtodeglat);
 	}
 
 	/* find location of time_d in the list arrays */
-	if (mb_io_ptr->nfix > 1) {
-		if (time_d <= mb_io_ptr->fix_time_d[0])
+	if (nfix > 1) {
+		if (time_d < mb_asynch_time(fix, 0))
 			ifix = 0;
-		else if (time_d >= mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1])
-			ifix = mb_io_ptr->nfix - 1;
-		else {
-			ifix = (mb_io_ptr->nfix - 1) * (time_d - mb_io_ptr->fix_time_d[0]) /
-			       (mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1] - mb_io_ptr->fix_time_d[0]);
-			while (time_d > mb_io_ptr->fix_time_d[ifix]) {
-				ifix++;
-			}
-			while (time_d < mb_io_ptr->fix_time_d[ifix - 1]) {
-				ifix--;
-			}
-		}
+		else if (time_d > mb_asynch_time(fix, nfix - 1))
+			ifix = nfix - 1;
+		else
+			ifix = mb_asynch_find(fix, time_d);
 	}
-	else if (mb_io_ptr->nfix == 1) {
+	else if (nfix == 1) {
 		ifix = 0;
 	}
 
@@ -184,12 +454,12 @@ int mb_navint_interp(int verbose, void *mbio_ptr, double time_d, double heading,
 		*speed = rawspeed; /* km/hr */
 
 	/* else get speed averaged over as many as 100 fixes */
-	else if (mb_io_ptr->nfix > 1) {
+	else if (nfix > 1) {
 		ifix0 = MAX(ifix - 50, 0);
-		ifix1 = MIN(ifix + 50, mb_io_ptr->nfix - 1);
-		dx = (mb_io_ptr->fix_lon[ifix1] - mb_io_ptr->fix_lon[ifix0]) / mtodeglon;
-		dy = (mb_io_ptr->fix_lat[ifix1] - mb_io_ptr->fix_lat[ifix0]) / mtodeglat;
-		dt = mb_io_ptr->fix_time_d[ifix1] - mb_io_ptr->fix_time_d[ifix0];
+		ifix1 = MIN(ifix + 50, nfix - 1);
+		dx = (mb_asynch_value(fix, ifix1, 0) - mb_asynch_value(fix, ifix0, 0)) / mtodeglon;
+		dy = (mb_asynch_value(fix, ifix1, 1) - mb_asynch_value(fix, ifix0, 1)) / mtodeglat;
+		dt = mb_asynch_time(fix, ifix1) - mb_asynch_time(fix, ifix0);
 		*speed = 3.6 * sqrt(dx * dx + dy * dy) / dt; /* km/hr */
 	}
 
@@ -203,46 +473,46 @@ int mb_navint_interp(int verbose, void *mbio_ptr, double time_d, double heading,
 	int status = MB_SUCCESS;
 
 	/* interpolate if possible */
-	if (mb_io_ptr->nfix > 1 && (time_d >= mb_io_ptr->fix_time_d[0]) && (time_d <= mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1])) {
-		factor = (time_d - mb_io_ptr->fix_time_d[ifix - 1]) / (mb_io_ptr->fix_time_d[ifix] - mb_io_ptr->fix_time_d[ifix - 1]);
-		*lon = mb_io_ptr->fix_lon[ifix - 1] + factor * (mb_io_ptr->fix_lon[ifix] - mb_io_ptr->fix_lon[ifix - 1]);
-		*lat = mb_io_ptr->fix_lat[ifix - 1] + factor * (mb_io_ptr->fix_lat[ifix] - mb_io_ptr->fix_lat[ifix - 1]);
+	if (nfix > 1 && (time_d >= mb_asynch_time(fix, 0)) && (time_d <= mb_asynch_time(fix, nfix - 1))) {
+		factor = (time_d - mb_asynch_time(fix, ifix - 1)) / (mb_asynch_time(fix, ifix) - mb_asynch_time(fix, ifix - 1));
+		*lon = mb_asynch_value(fix, ifix - 1, 0) + factor * (mb_asynch_value(fix, ifix, 0) - mb_asynch_value(fix, ifix - 1, 0));
+		*lat = mb_asynch_value(fix, ifix - 1, 1) + factor * (mb_asynch_value(fix, ifix, 1) - mb_asynch_value(fix, ifix - 1, 1));
 		status = MB_SUCCESS;
 #ifdef MB_NAVINT_DEBUG
-		fprintf(stderr, "mb_navint_interp: Nav  %f %f interpolated at fix %d of %d with factor:%f\n", *lon, *lat, ifix,
-		        mb_io_ptr->nfix, factor);
+		fprintf(stderr, "mb_navint_interp: Nav  %f %f interpolated at fix %d of %d with factor:%f\n", *lon, *lat, ifix, nfix,
+		        factor);
 #endif
 	}
 
 	/* extrapolate from last fix - note zero speed
 	    results in just using the last fix */
-	else if (mb_io_ptr->nfix > 1 && (time_d > mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1])) {
+	else if (nfix > 1 && (time_d > mb_asynch_time(fix, nfix - 1))) {
 		/* extrapolated position using average speed */
-		dd = (time_d - mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1]) * speed_mps; /* meters */
+		dd = (time_d - mb_asynch_time(fix, nfix - 1)) * speed_mps; /* meters */
 		headingx = sin(DTR * heading);
 		headingy = cos(DTR * heading);
-		*lon = mb_io_ptr->fix_lon[mb_io_ptr->nfix - 1] + headingx * mtodeglon * dd;
-		*lat = mb_io_ptr->fix_lat[mb_io_ptr->nfix - 1] + headingy * mtodeglat * dd;
+		*lon = mb_asynch_value(fix, nfix - 1, 0) + headingx * mtodeglon * dd;
+		*lat = mb_asynch_value(fix, nfix - 1, 1) + headingy * mtodeglat * dd;
 		status = MB_SUCCESS;
 #ifdef MB_NAVINT_DEBUG
 		fprintf(stderr, "mb_navint_interp: Nav %f %f extrapolated from last fix of %d with distance:%f and speed:%f\n", *lon,
-		        *lat, mb_io_ptr->nfix, dd, speed_mps);
+		        *lat, nfix, dd, speed_mps);
 #endif
 	}
 
 	/* extrapolate from first fix - note zero speed
 	    results in just using the first fix */
-	else if (mb_io_ptr->nfix >= 1) {
+	else if (nfix >= 1) {
 		/* extrapolated position using average speed */
-		dd = (time_d - mb_io_ptr->fix_time_d[0]) * speed_mps; /* meters */
+		dd = (time_d - mb_asynch_time(fix, 0)) * speed_mps; /* meters */
 		headingx = sin(DTR * heading);
 		headingy = cos(DTR * heading);
-		*lon = mb_io_ptr->fix_lon[0] + headingx * mtodeglon * dd;
-		*lat = mb_io_ptr->fix_lat[0] + headingy * mtodeglat * dd;
+		*lon = mb_asynch_value(fix, 0, 0) + headingx * mtodeglon * dd;
+		*lat = mb_asynch_value(fix, 0, 1) + headingy * mtodeglat * dd;
 		status = MB_SUCCESS;
 #ifdef MB_NAVINT_DEBUG
 		fprintf(stderr, "mb_navint_interp: Nav %f %f extrapolated from first fix of %d with distance %f and speed:%f\n", *lon,
-		        *lat, mb_io_ptr->nfix, dd, speed_mps);
+		        *lat, nfix, dd, speed_mps);
 #endif
 	}
 
@@ -297,32 +567,26 @@ int mb_navint_prjinterp(int verbose, void *mbio_ptr, double time_d, double headi
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *fix = &mb_io_ptr->asynch_fix;
+	const int nfix = fix->nsample;
 
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  Current nav fix values:\n");
-		for (int i = 0; i < mb_io_ptr->nfix; i++)
-			fprintf(stderr, "dbg2       nav fix[%2d]:   %f %f %f\n", i, mb_io_ptr->fix_time_d[i], mb_io_ptr->fix_lon[i],
-			        mb_io_ptr->fix_lat[i]);
+		for (int i = 0; i < nfix; i++)
+			fprintf(stderr, "dbg2       nav fix[%2d]:   %f %f %f\n", i, mb_asynch_time(fix, i), mb_asynch_value(fix, i, 0),
+			        mb_asynch_value(fix, i, 1));
 	}
 
 	/* find location of time_d in the list arrays */
-	if (mb_io_ptr->nfix > 1) {
-		if (time_d <= mb_io_ptr->fix_time_d[0])
+	if (nfix > 1) {
+		if (time_d < mb_asynch_time(fix, 0))
 			ifix = 0;
-		else if (time_d >= mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1])
-			ifix = mb_io_ptr->nfix - 1;
-		else {
-			ifix = (mb_io_ptr->nfix - 1) * (time_d - mb_io_ptr->fix_time_d[0]) /
-			       (mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1] - mb_io_ptr->fix_time_d[0]);
-			while (time_d > mb_io_ptr->fix_time_d[ifix]) {
-				ifix++;
-			}
-			while (time_d < mb_io_ptr->fix_time_d[ifix - 1]) {
-				ifix--;
-			}
-		}
+		else if (time_d > mb_asynch_time(fix, nfix - 1))
+			ifix = nfix - 1;
+		else
+			ifix = mb_asynch_find(fix, time_d);
 	}
-	else if (mb_io_ptr->nfix == 1) {
+	else if (nfix == 1) {
 		ifix = 0;
 	}
 
@@ -331,12 +595,12 @@ int mb_navint_prjinterp(int verbose, void *mbio_ptr, double time_d, double headi
 		*speed = rawspeed; /* km/hr */
 
 	/* else get speed averaged over as many as 100 fixes */
-	else if (mb_io_ptr->nfix > 1) {
+	else if (nfix > 1) {
 		ifix0 = MAX(ifix - 50, 0);
-		ifix1 = MIN(ifix + 50, mb_io_ptr->nfix - 1);
-		dx = (mb_io_ptr->fix_lon[ifix1] - mb_io_ptr->fix_lon[ifix0]);
-		dy = (mb_io_ptr->fix_lat[ifix1] - mb_io_ptr->fix_lat[ifix0]);
-		dt = mb_io_ptr->fix_time_d[ifix1] - mb_io_ptr->fix_time_d[ifix0];
+		ifix1 = MIN(ifix + 50, nfix - 1);
+		dx = (mb_asynch_value(fix, ifix1, 0) - mb_asynch_value(fix, ifix0, 0));
+		dy = (mb_asynch_value(fix, ifix1, 1) - mb_asynch_value(fix, ifix0, 1));
+		dt = mb_asynch_time(fix, ifix1) - mb_asynch_time(fix, ifix0);
 		*speed = 3.6 * sqrt(dx * dx + dy * dy) / dt; /* km/hr */
 	}
 
@@ -350,46 +614,48 @@ int mb_navint_prjinterp(int verbose, void *mbio_ptr, double time_d, double headi
 	int status = MB_SUCCESS;
 
 	/* interpolate if possible */
-	if (mb_io_ptr->nfix > 1 && (time_d >= mb_io_ptr->fix_time_d[0]) && (time_d <= mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1])) {
-		factor = (time_d - mb_io_ptr->fix_time_d[ifix - 1]) / (mb_io_ptr->fix_time_d[ifix] - mb_io_ptr->fix_time_d[ifix - 1]);
-		*easting = mb_io_ptr->fix_lon[ifix - 1] + factor * (mb_io_ptr->fix_lon[ifix] - mb_io_ptr->fix_lon[ifix - 1]);
-		*northing = mb_io_ptr->fix_lat[ifix - 1] + factor * (mb_io_ptr->fix_lat[ifix] - mb_io_ptr->fix_lat[ifix - 1]);
+	if (nfix > 1 && (time_d >= mb_asynch_time(fix, 0)) && (time_d <= mb_asynch_time(fix, nfix - 1))) {
+		factor = (time_d - mb_asynch_time(fix, ifix - 1)) / (mb_asynch_time(fix, ifix) - mb_asynch_time(fix, ifix - 1));
+		*easting =
+		    mb_asynch_value(fix, ifix - 1, 0) + factor * (mb_asynch_value(fix, ifix, 0) - mb_asynch_value(fix, ifix - 1, 0));
+		*northing =
+		    mb_asynch_value(fix, ifix - 1, 1) + factor * (mb_asynch_value(fix, ifix, 1) - mb_asynch_value(fix, ifix - 1, 1));
 		status = MB_SUCCESS;
 #ifdef MB_NAVINT_DEBUG
 		fprintf(stderr, "mb_navint_interp: Nav  %f %f interpolated at fix %d of %d with factor:%f\n", *easting, *northing, ifix,
-		        mb_io_ptr->nfix, factor);
+		        nfix, factor);
 #endif
 	}
 
 	/* extrapolate from last fix - note zero speed
 	    results in just using the last fix */
-	else if (mb_io_ptr->nfix > 1 && (time_d > mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1])) {
+	else if (nfix > 1 && (time_d > mb_asynch_time(fix, nfix - 1))) {
 		/* extrapolated position using average speed */
-		dd = (time_d - mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1]) * speed_mps; /* meters */
+		dd = (time_d - mb_asynch_time(fix, nfix - 1)) * speed_mps; /* meters */
 		headingx = sin(DTR * heading);
 		headingy = cos(DTR * heading);
-		*easting = mb_io_ptr->fix_lon[mb_io_ptr->nfix - 1] + headingx * dd;
-		*northing = mb_io_ptr->fix_lat[mb_io_ptr->nfix - 1] + headingy * dd;
+		*easting = mb_asynch_value(fix, nfix - 1, 0) + headingx * dd;
+		*northing = mb_asynch_value(fix, nfix - 1, 1) + headingy * dd;
 		status = MB_SUCCESS;
 #ifdef MB_NAVINT_DEBUG
 		fprintf(stderr, "mb_navint_interp: Nav %f %f extrapolated from last fix of %d with distance:%f and speed:%f\n", *easting,
-		        *northing, mb_io_ptr->nfix, dd, speed_mps);
+		        *northing, nfix, dd, speed_mps);
 #endif
 	}
 
 	/* extrapolate from first fix - note zero speed
 	    results in just using the first fix */
-	else if (mb_io_ptr->nfix >= 1) {
+	else if (nfix >= 1) {
 		/* extrapolated position using average speed */
-		dd = (time_d - mb_io_ptr->fix_time_d[0]) * speed_mps; /* meters */
+		dd = (time_d - mb_asynch_time(fix, 0)) * speed_mps; /* meters */
 		headingx = sin(DTR * heading);
 		headingy = cos(DTR * heading);
-		*easting = mb_io_ptr->fix_lon[0] + headingx * dd;
-		*northing = mb_io_ptr->fix_lat[0] + headingy * dd;
+		*easting = mb_asynch_value(fix, 0, 0) + headingx * dd;
+		*northing = mb_asynch_value(fix, 0, 1) + headingy * dd;
 		status = MB_SUCCESS;
 #ifdef MB_NAVINT_DEBUG
 		fprintf(stderr, "mb_navint_interp: Nav %f %f extrapolated from first fix of %d with distance %f and speed:%f\n", *easting,
-		        *northing, mb_io_ptr->nfix, dd, speed_mps);
+		        *northing, nfix, dd, speed_mps);
 #endif
 	}
 
@@ -436,46 +702,31 @@ int mb_attint_add(int verbose, void *mbio_ptr, double time_d, double heave, doub
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *attitude = &mb_io_ptr->asynch_attitude;
 
-	/* add another attitude fix only if time stamp has changed */
-	if (mb_io_ptr->nattitude == 0 || (time_d > mb_io_ptr->attitude_time_d[mb_io_ptr->nattitude - 1])) {
-		/* if list if full make room for another attitude fix */
-		if (mb_io_ptr->nattitude >= MB_ASYNCH_SAVE_MAX) {
-			int shift = MB_ASYNCH_SAVE_MAX / 2;
-			for (int i = 0; i < mb_io_ptr->nattitude - shift; i++) {
-				mb_io_ptr->attitude_time_d[i] = mb_io_ptr->attitude_time_d[i  + shift];
-				mb_io_ptr->attitude_heave[i] = mb_io_ptr->attitude_heave[i  + shift];
-				mb_io_ptr->attitude_roll[i] = mb_io_ptr->attitude_roll[i  + shift];
-				mb_io_ptr->attitude_pitch[i] = mb_io_ptr->attitude_pitch[i  + shift];
-			}
-			mb_io_ptr->nattitude -= shift;
-		}
+	int status = MB_SUCCESS;
 
+	/* add another attitude fix only if time stamp has changed */
+	if (attitude->nsample == 0 || (time_d > mb_asynch_time(attitude, attitude->nsample - 1))) {
 		/* add new fix to list */
-		mb_io_ptr->attitude_time_d[mb_io_ptr->nattitude] = time_d;
-		mb_io_ptr->attitude_heave[mb_io_ptr->nattitude] = heave;
-		mb_io_ptr->attitude_roll[mb_io_ptr->nattitude] = roll;
-		mb_io_ptr->attitude_pitch[mb_io_ptr->nattitude] = pitch;
-		mb_io_ptr->nattitude++;
+		const double value[3] = {heave, roll, pitch};
+		status = mb_asynch_add(verbose, attitude, 3, time_d, value, error);
 #ifdef MB_ATTINT_DEBUG
-		fprintf(stderr, "mb_attint_add:    Attitude fix %d time_d:%f roll:%f pitch:%f heave:%f added\n", mb_io_ptr->nattitude,
+		fprintf(stderr, "mb_attint_add:    Attitude fix %d time_d:%f roll:%f pitch:%f heave:%f added\n", attitude->nsample,
 		        time_d, roll, pitch, heave);
 #endif
 
-		if (verbose >= 4) {
+		if (verbose >= 4 && status == MB_SUCCESS) {
 			fprintf(stderr, "\ndbg4  Attitude fix added to list by MBIO function <%s>\n", __func__);
 			fprintf(stderr, "dbg4  New fix values:\n");
-			fprintf(stderr, "dbg4       nattitude:       %d\n", mb_io_ptr->nattitude);
-			fprintf(stderr, "dbg4       time_d:     %f\n", mb_io_ptr->attitude_time_d[mb_io_ptr->nattitude - 1]);
-			fprintf(stderr, "dbg4       attitude_heave:    %f\n", mb_io_ptr->attitude_heave[mb_io_ptr->nattitude - 1]);
-			fprintf(stderr, "dbg4       attitude_roll:     %f\n", mb_io_ptr->attitude_roll[mb_io_ptr->nattitude - 1]);
-			fprintf(stderr, "dbg4       attitude_pitch:    %f\n", mb_io_ptr->attitude_pitch[mb_io_ptr->nattitude - 1]);
+			fprintf(stderr, "dbg4       nattitude:       %d\n", attitude->nsample);
+			fprintf(stderr, "dbg4       time_d:     %f\n", mb_asynch_time(attitude, attitude->nsample - 1));
+			fprintf(stderr, "dbg4       attitude_heave:    %f\n", mb_asynch_value(attitude, attitude->nsample - 1, 0));
+			fprintf(stderr, "dbg4       attitude_roll:     %f\n", mb_asynch_value(attitude, attitude->nsample - 1, 1));
+			fprintf(stderr, "dbg4       attitude_pitch:    %f\n", mb_asynch_value(attitude, attitude->nsample - 1, 2));
 		}
 	}
 
-	/* assume success */
-	const int status = MB_SUCCESS;
-
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
 		fprintf(stderr, "dbg2  Return value:\n");
@@ -484,7 +735,6 @@ int mb_attint_add(int verbose, void *mbio_ptr, double time_d, double heave, doub
 		fprintf(stderr, "dbg2       status:     %d\n", status);
 	}
 
-	/* return success */
 	return (status);
 }
 /*--------------------------------------------------------------------*/
@@ -506,48 +756,31 @@ int mb_attint_nadd(int verbose, void *mbio_ptr, int nsamples, double *time_d, do
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *attitude = &mb_io_ptr->asynch_attitude;
 
-	/* if necessary make room for attitude fixes */
-	if (mb_io_ptr->nattitude + nsamples >= MB_ASYNCH_SAVE_MAX) {
-		int shift = MB_ASYNCH_SAVE_MAX / 2;
-		if (mb_io_ptr->nattitude - shift + nsamples >= MB_ASYNCH_SAVE_MAX)
-			shift = mb_io_ptr->nattitude + nsamples - MB_ASYNCH_SAVE_MAX;
-		for (int i = 0; i < mb_io_ptr->nattitude - shift; i++) {
-			mb_io_ptr->attitude_time_d[i] = mb_io_ptr->attitude_time_d[i + shift];
-			mb_io_ptr->attitude_heave[i] = mb_io_ptr->attitude_heave[i + shift];
-			mb_io_ptr->attitude_roll[i] = mb_io_ptr->attitude_roll[i + shift];
-			mb_io_ptr->attitude_pitch[i] = mb_io_ptr->attitude_pitch[i + shift];
-		}
-		mb_io_ptr->nattitude = mb_io_ptr->nattitude - shift;
-	}
+	int status = MB_SUCCESS;
 
 	/* add fixes */
-	for (int i = 0; i < nsamples; i++) {
+	for (int i = 0; i < nsamples && status == MB_SUCCESS; i++) {
 		/* add new fix to list */
-		mb_io_ptr->attitude_time_d[mb_io_ptr->nattitude] = time_d[i];
-		mb_io_ptr->attitude_heave[mb_io_ptr->nattitude] = heave[i];
-		mb_io_ptr->attitude_roll[mb_io_ptr->nattitude] = roll[i];
-		mb_io_ptr->attitude_pitch[mb_io_ptr->nattitude] = pitch[i];
+		const double value[3] = {heave[i], roll[i], pitch[i]};
+		status = mb_asynch_add(verbose, attitude, 3, time_d[i], value, error);
 #ifdef MB_ATTINT_DEBUG
 		fprintf(stderr, "mb_attint_add:    Attitude fix %d of %d: time:%f roll:%f pitch:%f heave:%f added\n", i,
-		        mb_io_ptr->nattitude, time_d[i], roll[i], pitch[i], heave[i]);
+		        attitude->nsample, time_d[i], roll[i], pitch[i], heave[i]);
 #endif
-		mb_io_ptr->nattitude++;
 
-		if (verbose >= 4) {
+		if (verbose >= 4 && status == MB_SUCCESS) {
 			fprintf(stderr, "\ndbg4  Attitude fixes added to list by MBIO function <%s>\n", __func__);
 			fprintf(stderr, "dbg4  New fix values:\n");
-			fprintf(stderr, "dbg4       nattitude:       %d\n", mb_io_ptr->nattitude);
-			fprintf(stderr, "dbg4       time_d:     %f\n", mb_io_ptr->attitude_time_d[mb_io_ptr->nattitude - 1]);
-			fprintf(stderr, "dbg4       attitude_heave:    %f\n", mb_io_ptr->attitude_heave[mb_io_ptr->nattitude - 1]);
-			fprintf(stderr, "dbg4       attitude_roll:     %f\n", mb_io_ptr->attitude_roll[mb_io_ptr->nattitude - 1]);
-			fprintf(stderr, "dbg4       attitude_pitch:    %f\n", mb_io_ptr->attitude_pitch[mb_io_ptr->nattitude - 1]);
+			fprintf(stderr, "dbg4       nattitude:       %d\n", attitude->nsample);
+			fprintf(stderr, "dbg4       time_d:     %f\n", mb_asynch_time(attitude, attitude->nsample - 1));
+			fprintf(stderr, "dbg4       attitude_heave:    %f\n", mb_asynch_value(attitude, attitude->nsample - 1, 0));
+			fprintf(stderr, "dbg4       attitude_roll:     %f\n", mb_asynch_value(attitude, attitude->nsample - 1, 1));
+			fprintf(stderr, "dbg4       attitude_pitch:    %f\n", mb_asynch_value(attitude, attitude->nsample - 1, 2));
 		}
 	}
 
-	/* assume success */
-	const int status = MB_SUCCESS;
-
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
 		fprintf(stderr, "dbg2  Return value:\n");
@@ -556,7 +789,6 @@ int mb_attint_nadd(int verbose, void *mbio_ptr, int nsamples, double *time_d, do
 		fprintf(stderr, "dbg2       status:     %d\n", status);
 	}
 
-	/* return success */
 	return (status);
 }
 /*--------------------------------------------------------------------*/
@@ -576,58 +808,54 @@ int mb_attint_interp(int verbose, void *mbio_ptr, double time_d, double *heave,
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *attitude = &mb_io_ptr->asynch_attitude;
+	const int nattitude = attitude->nsample;
 
 	int status = MB_SUCCESS;
 
 	/* interpolate if possible */
-	if (mb_io_ptr->nattitude > 1 && (mb_io_ptr->attitude_time_d[mb_io_ptr->nattitude - 1] >= time_d) &&
-	    (mb_io_ptr->attitude_time_d[0] <= time_d)) {
+	if (nattitude > 1 && (mb_asynch_time(attitude, nattitude - 1) >= time_d) && (mb_asynch_time(attitude, 0) <= time_d)) {
 		/* get interpolated position */
-		ifix = (mb_io_ptr->nattitude - 1) * (time_d - mb_io_ptr->attitude_time_d[0]) /
-		       (mb_io_ptr->attitude_time_d[mb_io_ptr->nattitude - 1] - mb_io_ptr->attitude_time_d[0]);
-		while (time_d > mb_io_ptr->attitude_time_d[ifix])
-			ifix++;
-		while (time_d < mb_io_ptr->attitude_time_d[ifix - 1])
-			ifix--;
-
-		factor = (time_d - mb_io_ptr->attitude_time_d[ifix - 1]) /
-		         (mb_io_ptr->attitude_time_d[ifix] - mb_io_ptr->attitude_time_d[ifix - 1]);
-		*heave = mb_io_ptr->attitude_heave[ifix - 1] +
-		         factor * (mb_io_ptr->attitude_heave[ifix] - mb_io_ptr->attitude_heave[ifix - 1]);
-		*roll =
-		    mb_io_ptr->attitude_roll[ifix - 1] + factor * (mb_io_ptr->attitude_roll[ifix] - mb_io_ptr->attitude_roll[ifix - 1]);
-		*pitch = mb_io_ptr->attitude_pitch[ifix - 1] +
-		         factor * (mb_io_ptr->attitude_pitch[ifix] - mb_io_ptr->attitude_pitch[ifix - 1]);
+		ifix = mb_asynch_find(attitude, time_d);
+
+		factor = (time_d - mb_asynch_time(attitude, ifix - 1)) /
+		         (mb_asynch_time(attitude, ifix) - mb_asynch_time(attitude, ifix - 1));
+		*heave = mb_asynch_value(attitude, ifix - 1, 0) +
+		         factor * (mb_asynch_value(attitude, ifix, 0) - mb_asynch_value(attitude, ifix - 1, 0));
+		*roll = mb_asynch_value(attitude, ifix - 1, 1) +
+		        factor * (mb_asynch_value(attitude, ifix, 1) - mb_asynch_value(attitude, ifix - 1, 1));
+		*pitch = mb_asynch_value(attitude, ifix - 1, 2) +
+		         factor * (mb_asynch_value(attitude, ifix, 2) - mb_asynch_value(attitude, ifix - 1, 2));
 		status = MB_SUCCESS;
 #ifdef MB_ATTINT_DEBUG
 		fprintf(stderr,
 		        "mb_attint_interp: Attitude time_d:%f roll:%f pitch:%f heave:%f interpolated at fix %d of %d with factor:%f\n",
-		        time_d, *roll, *pitch, *heave, ifix, mb_io_ptr->nattitude, factor);
+		        time_d, *roll, *pitch, *heave, ifix, nattitude, factor);
 #endif
 	}
 
 	/* extrapolate from last fix */
-	else if (mb_io_ptr->nattitude > 1 && (mb_io_ptr->attitude_time_d[mb_io_ptr->nattitude - 1] < time_d)) {
+	else if (nattitude > 1 && (mb_asynch_time(attitude, nattitude - 1) < time_d)) {
 		/* extrapolated position using average speed */
-		*heave = mb_io_ptr->attitude_heave[mb_io_ptr->nattitude - 1];
-		*roll = mb_io_ptr->attitude_roll[mb_io_ptr->nattitude - 1];
-		*pitch = mb_io_ptr->attitude_pitch[mb_io_ptr->nattitude - 1];
+		*heave = mb_asynch_value(attitude, nattitude - 1, 0);
+		*roll = mb_asynch_value(attitude, nattitude - 1, 1);
+		*pitch = mb_asynch_value(attitude, nattitude - 1, 2);
 		status = MB_SUCCESS;
 #ifdef MB_ATTINT_DEBUG
 		fprintf(stderr, "mb_attint_interp: Attitude time_d:%f roll:%f pitch:%f heave:%f extrapolated from last fix of %d\n",
-		        time_d, *roll, *pitch, *heave, mb_io_ptr->nattitude);
+		        time_d, *roll, *pitch, *heave, nattitude);
 #endif
 	}
 
 	/* extrapolate from first fix */
-	else if (mb_io_ptr->nattitude >= 1) {
-		*heave = mb_io_ptr->attitude_heave[0];
-		*roll = mb_io_ptr->attitude_roll[0];
-		*pitch = mb_io_ptr->attitude_pitch[0];
+	else if (nattitude >= 1) {
+		*heave = mb_asynch_value(attitude, 0, 0);
+		*roll = mb_asynch_value(attitude, 0, 1);
+		*pitch = mb_asynch_value(attitude, 0, 2);
 		status = MB_SUCCESS;
 #ifdef MB_ATTINT_DEBUG
 		fprintf(stderr, "mb_attint_interp: Attitude time_d:%f roll:%f pitch:%f heave:%f extrapolated from first fix of %d\n",
-		        time_d, *roll, *pitch, *heave, mb_io_ptr->nattitude);
+		        time_d, *roll, *pitch, *heave, nattitude);
 #endif
 	}
 
@@ -672,39 +900,27 @@ int mb_hedint_add(int verbose, void *mbio_ptr, double time_d, double heading, in
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *asynch = &mb_io_ptr->asynch_heading;
 
-	/* add another fix only if time stamp has changed */
-	if (mb_io_ptr->nheading == 0 || (time_d > mb_io_ptr->heading_time_d[mb_io_ptr->nheading - 1])) {
-		/* if list if full make room for another heading fix */
-		if (mb_io_ptr->nheading >= MB_ASYNCH_SAVE_MAX) {
-			int shift = MB_ASYNCH_SAVE_MAX / 2;
-			for (int i = 0; i < mb_io_ptr->nheading - shift; i++) {
-				mb_io_ptr->heading_time_d[i] = mb_io_ptr->heading_time_d[i + shift];
-				mb_io_ptr->heading_heading[i] = mb_io_ptr->heading_heading[i + shift];
-			}
-			mb_io_ptr->nheading -= shift;
-		}
+	int status = MB_SUCCESS;
 
+	/* add another fix only if time stamp has changed */
+	if (asynch->nsample == 0 || (time_d > mb_asynch_time(asynch, asynch->nsample - 1))) {
 		/* add new fix to list */
-		mb_io_ptr->heading_time_d[mb_io_ptr->nheading] = time_d;
-		mb_io_ptr->heading_heading[mb_io_ptr->nheading] = heading;
-		mb_io_ptr->nheading++;
+		status = mb_asynch_add(verbose, asynch, 1, time_d, &heading, error);
 #ifdef MB_HEDINT_DEBUG
-		fprintf(stderr, "mb_hedint_add:    Heading fix %d %f added\n", mb_io_ptr->nheading, heading);
+		fprintf(stderr, "mb_hedint_add:    Heading fix %d %f added\n", asynch->nsample, heading);
 #endif
 
-		if (verbose >= 4) {
+		if (verbose >= 4 && status == MB_SUCCESS) {
 			fprintf(stderr, "\ndbg4  Heading fix added to list by MBIO function <%s>\n", __func__);
 			fprintf(stderr, "dbg4  New fix values:\n");
-			fprintf(stderr, "dbg4       nheading:       %d\n", mb_io_ptr->nheading);
-			fprintf(stderr, "dbg4       time_d:     %f\n", mb_io_ptr->heading_time_d[mb_io_ptr->nheading - 1]);
-			fprintf(stderr, "dbg4       heading_heading:  %f\n", mb_io_ptr->heading_heading[mb_io_ptr->nheading - 1]);
+			fprintf(stderr, "dbg4       nheading:       %d\n", asynch->nsample);
+			fprintf(stderr, "dbg4       time_d:     %f\n", mb_asynch_time(asynch, asynch->nsample - 1));
+			fprintf(stderr, "dbg4       heading_heading:  %f\n", mb_asynch_value(asynch, asynch->nsample - 1, 0));
 		}
 	}
 
-	/* assume success */
-	const int status = MB_SUCCESS;
-
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
 		fprintf(stderr, "dbg2  Return value:\n");
@@ -713,7 +929,6 @@ int mb_hedint_add(int verbose, void *mbio_ptr, double time_d, double heading, in
 		fprintf(stderr, "dbg2       status:     %d\n", status);
 	}
 
-	/* return success */
 	return (status);
 }
 /*--------------------------------------------------------------------*/
@@ -734,41 +949,27 @@ int mb_hedint_nadd(int verbose, void *mbio_ptr, int nsamples, double *time_d, do
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *asynch = &mb_io_ptr->asynch_heading;
 
-	/* if necessary make room for heading fixes */
-	if (mb_io_ptr->nheading + nsamples >= MB_ASYNCH_SAVE_MAX) {
-		int shift = MB_ASYNCH_SAVE_MAX / 2;
-		if (mb_io_ptr->nheading - shift + nsamples >= MB_ASYNCH_SAVE_MAX)
-			shift = mb_io_ptr->nheading + nsamples - MB_ASYNCH_SAVE_MAX;
-		for (int i = 0; i < mb_io_ptr->nheading - shift; i++) {
-			mb_io_ptr->heading_time_d[i] = mb_io_ptr->heading_time_d[i + shift];
-			mb_io_ptr->heading_heading[i] = mb_io_ptr->heading_heading[i + shift];
-		}
-		mb_io_ptr->nheading = mb_io_ptr->nheading - shift;
-	}
+	int status = MB_SUCCESS;
 
 	/* add fixes */
-	for (int i = 0; i < nsamples; i++) {
+	for (int i = 0; i < nsamples && status == MB_SUCCESS; i++) {
 		/* add new fix to list */
-		mb_io_ptr->heading_time_d[mb_io_ptr->nheading] = time_d[i];
-		mb_io_ptr->heading_heading[mb_io_ptr->nheading] = heading[i];
+		status = mb_asynch_add(verbose, asynch, 1, time_d[i], &heading[i], error);
 #ifdef MB_HEDINT_DEBUG
-		fprintf(stderr, "mb_hedint_nadd:    Heading fix %d of %d: %f added\n", i, mb_io_ptr->nheading, heading[i]);
+		fprintf(stderr, "mb_hedint_nadd:    Heading fix %d of %d: %f added\n", i, asynch->nsample, heading[i]);
 #endif
-		mb_io_ptr->nheading++;
 
-		if (verbose >= 4) {
+		if (verbose >= 4 && status == MB_SUCCESS) {
 			fprintf(stderr, "\ndbg4  Heading fixes added to list by MBIO function <%s>\n", __func__);
 			fprintf(stderr, "dbg4  New fix values:\n");
-			fprintf(stderr, "dbg4       nheading:       %d\n", mb_io_ptr->nheading);
-			fprintf(stderr, "dbg4       time_d:          %f\n", mb_io_ptr->heading_time_d[mb_io_ptr->nheading - 1]);
-			fprintf(stderr, "dbg4       heading_heading: %f\n", mb_io_ptr->heading_heading[mb_io_ptr->nheading - 1]);
+			fprintf(stderr, "dbg4       nheading:       %d\n", asynch->nsample);
+			fprintf(stderr, "dbg4       time_d:          %f\n", mb_asynch_time(asynch, asynch->nsample - 1));
+			fprintf(stderr, "dbg4       heading_heading: %f\n", mb_asynch_value(asynch, asynch->nsample - 1, 0));
 		}
 	}
 
-	/* assume success */
-	int status = MB_SUCCESS;
-
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
 		fprintf(stderr, "dbg2  Return value:\n");
@@ -777,7 +978,6 @@ int mb_hedint_nadd(int verbose, void *mbio_ptr, int nsamples, double *time_d, do
 		fprintf(stderr, "dbg2       status:     %d\n", status);
 	}
 
-	/* return success */
 	return (status);
 }
 /*--------------------------------------------------------------------*/
@@ -798,24 +998,19 @@ int mb_hedint_interp(int verbose, void *mbio_ptr, double time_d, double *heading
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *asynch = &mb_io_ptr->asynch_heading;
+	const int nheading = asynch->nsample;
 
 	int status = MB_SUCCESS;
 
 	/* interpolate if possible */
-	if (mb_io_ptr->nheading > 1 && (mb_io_ptr->heading_time_d[mb_io_ptr->nheading - 1] >= time_d) &&
-	    (mb_io_ptr->heading_time_d[0] <= time_d)) {
+	if (nheading > 1 && (mb_asynch_time(asynch, nheading - 1) >= time_d) && (mb_asynch_time(asynch, 0) <= time_d)) {
 		/* get interpolated heading */
-		ifix = (mb_io_ptr->nheading - 1) * (time_d - mb_io_ptr->heading_time_d[0]) /
-		       (mb_io_ptr->heading_time_d[mb_io_ptr->nheading - 1] - mb_io_ptr->heading_time_d[0]);
-		while (time_d > mb_io_ptr->heading_time_d[ifix])
-			ifix++;
-		while (time_d < mb_io_ptr->heading_time_d[ifix - 1])
-			ifix--;
-
-		factor = (time_d - mb_io_ptr->heading_time_d[ifix - 1]) /
-		         (mb_io_ptr->heading_time_d[ifix] - mb_io_ptr->heading_time_d[ifix - 1]);
-		heading1 = mb_io_ptr->heading_heading[ifix - 1];
-		heading2 = mb_io_ptr->heading_heading[ifix];
+		ifix = mb_asynch_find(asynch, time_d);
+
+		factor = (time_d - mb_asynch_time(asynch, ifix - 1)) / (mb_asynch_time(asynch, ifix) - mb_asynch_time(asynch, ifix - 1));
+		heading1 = mb_asynch_value(asynch, ifix - 1, 0);
+		heading2 = mb_asynch_value(asynch, ifix, 0);
 		if (heading2 - heading1 > 180.0)
 			heading2 -= 360.0;
 		else if (heading2 - heading1 < -180.0)
@@ -828,26 +1023,26 @@ int mb_hedint_interp(int verbose, void *mbio_ptr, double time_d, double *heading
 		status = MB_SUCCESS;
 #ifdef MB_HEDINT_DEBUG
 		fprintf(stderr, "mb_hedint_interp: Heading %f interpolated at value %d of %d with factor:%f\n", *heading, ifix,
-		        mb_io_ptr->nheading, factor);
+		        nheading, factor);
 #endif
 	}
 
 	/* extrapolate from last fix */
-	else if (mb_io_ptr->nheading > 1 && (mb_io_ptr->heading_time_d[mb_io_ptr->nheading - 1] < time_d)) {
+	else if (nheading > 1 && (mb_asynch_time(asynch, nheading - 1) < time_d)) {
 		/* extrapolated heading using average speed */
-		*heading = mb_io_ptr->heading_heading[mb_io_ptr->nheading - 1];
+		*heading = mb_asynch_value(asynch, nheading - 1, 0);
 		status = MB_SUCCESS;
 #ifdef MB_HEDINT_DEBUG
-		fprintf(stderr, "mb_hedint_interp: Heading %f taken from last value of %d\n", *heading, mb_io_ptr->nheading);
+		fprintf(stderr, "mb_hedint_interp: Heading %f taken from last value of %d\n", *heading, nheading);
 #endif
 	}
 
 	/* extrapolate from first fix */
-	else if (mb_io_ptr->nheading >= 1) {
-		*heading = mb_io_ptr->heading_heading[0];
+	else if (nheading >= 1) {
+		*heading = mb_asynch_value(asynch, 0, 0);
 		status = MB_SUCCESS;
 #ifdef MB_HEDINT_DEBUG
-		fprintf(stderr, "mb_hedint_interp: Heading %f taken from first value of %d\n", *heading, mb_io_ptr->nheading);
+		fprintf(stderr, "mb_hedint_interp: Heading %f taken from first value of %d\n", *heading, nheading);
 #endif
 	}
 
@@ -888,40 +1083,27 @@ int mb_depint_add(int verbose, void *mbio_ptr, double time_d, double sensordepth
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *asynch = &mb_io_ptr->asynch_sensordepth;
 
-	/* add another fix only if time stamp has changed */
-	if (mb_io_ptr->nsensordepth == 0 || (time_d > mb_io_ptr->sensordepth_time_d[mb_io_ptr->nsensordepth - 1])) {
-		/* if list if full make room for another sensordepth fix */
-		if (mb_io_ptr->nsensordepth >= MB_ASYNCH_SAVE_MAX) {
-			int shift = MB_ASYNCH_SAVE_MAX / 2;
-			for (int i = 0; i < mb_io_ptr->nsensordepth - shift; i++) {
-				mb_io_ptr->sensordepth_time_d[i] = mb_io_ptr->sensordepth_time_d[i + shift];
-				mb_io_ptr->sensordepth_sensordepth[i] = mb_io_ptr->sensordepth_sensordepth[i + shift];
-			}
-			mb_io_ptr->nsensordepth -= shift;
-		}
+	int status = MB_SUCCESS;
 
+	/* add another fix only if time stamp has changed */
+	if (asynch->nsample == 0 || (time_d > mb_asynch_time(asynch, asynch->nsample - 1))) {
 		/* add new fix to list */
-		mb_io_ptr->sensordepth_time_d[mb_io_ptr->nsensordepth] = time_d;
-		mb_io_ptr->sensordepth_sensordepth[mb_io_ptr->nsensordepth] = sensordepth;
-		mb_io_ptr->nsensordepth++;
+		status = mb_asynch_add(verbose, asynch, 1, time_d, &sensordepth, error);
 #ifdef MB_DEPINT_DEBUG
-		fprintf(stderr, "mb_depint_add:    sensordepth fix %d %f added\n", mb_io_ptr->nsensordepth, sensordepth);
+		fprintf(stderr, "mb_depint_add:    sensordepth fix %d %f added\n", asynch->nsample, sensordepth);
 #endif
 
-		if (verbose >= 4) {
+		if (verbose >= 4 && status == MB_SUCCESS) {
 			fprintf(stderr, "\ndbg4  Sonar depth fix added to list by MBIO function <%s>\n", __func__);
 			fprintf(stderr, "dbg4  New fix values:\n");
-			fprintf(stderr, "dbg4       nsensordepth:       %d\n", mb_io_ptr->nsensordepth);
-			fprintf(stderr, "dbg4       time_d:     %f\n", mb_io_ptr->sensordepth_time_d[mb_io_ptr->nsensordepth - 1]);
-			fprintf(stderr, "dbg4       sensordepth_sensordepth:  %f\n",
-			        mb_io_ptr->sensordepth_sensordepth[mb_io_ptr->nsensordepth - 1]);
+			fprintf(stderr, "dbg4       nsensordepth:       %d\n", asynch->nsample);
+			fprintf(stderr, "dbg4       time_d:     %f\n", mb_asynch_time(asynch, asynch->nsample - 1));
+			fprintf(stderr, "dbg4       sensordepth_sensordepth:  %f\n", mb_asynch_value(asynch, asynch->nsample - 1, 0));
 		}
 	}
 
-	/* assume success */
-	const int status = MB_SUCCESS;
-
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
 		fprintf(stderr, "dbg2  Return value:\n");
@@ -930,7 +1112,6 @@ int mb_depint_add(int verbose, void *mbio_ptr, double time_d, double sensordepth
 		fprintf(stderr, "dbg2       status:     %d\n", status);
 	}
 
-	/* return success */
 	return (status);
 }
 /*--------------------------------------------------------------------*/
@@ -950,49 +1131,42 @@ int mb_depint_interp(int verbose, void *mbio_ptr, double time_d, double *sensord
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *asynch = &mb_io_ptr->asynch_sensordepth;
+	const int nsensordepth = asynch->nsample;
 
 	int status = MB_SUCCESS;
 
 	/* interpolate if possible */
-	if (mb_io_ptr->nsensordepth > 1 && (mb_io_ptr->sensordepth_time_d[mb_io_ptr->nsensordepth - 1] >= time_d) &&
-	    (mb_io_ptr->sensordepth_time_d[0] <= time_d)) {
+	if (nsensordepth > 1 && (mb_asynch_time(asynch, nsensordepth - 1) >= time_d) && (mb_asynch_time(asynch, 0) <= time_d)) {
 		/* get interpolated position */
-		ifix = (mb_io_ptr->nsensordepth - 1) * (time_d - mb_io_ptr->sensordepth_time_d[0]) /
-		       (mb_io_ptr->sensordepth_time_d[mb_io_ptr->nsensordepth - 1] - mb_io_ptr->sensordepth_time_d[0]);
-		while (time_d > mb_io_ptr->sensordepth_time_d[ifix])
-			ifix++;
-		while (time_d < mb_io_ptr->sensordepth_time_d[ifix - 1])
-			ifix--;
-
-		factor = (time_d - mb_io_ptr->sensordepth_time_d[ifix - 1]) /
-		         (mb_io_ptr->sensordepth_time_d[ifix] - mb_io_ptr->sensordepth_time_d[ifix - 1]);
-		*sensordepth = mb_io_ptr->sensordepth_sensordepth[ifix - 1] +
-		              factor * (mb_io_ptr->sensordepth_sensordepth[ifix] - mb_io_ptr->sensordepth_sensordepth[ifix - 1]);
+		ifix = mb_asynch_find(asynch, time_d);
+
+		factor = (time_d - mb_asynch_time(asynch, ifix - 1)) / (mb_asynch_time(asynch, ifix) - mb_asynch_time(asynch, ifix - 1));
+		*sensordepth = mb_asynch_value(asynch, ifix - 1, 0) +
+		               factor * (mb_asynch_value(asynch, ifix, 0) - mb_asynch_value(asynch, ifix - 1, 0));
 		status = MB_SUCCESS;
 #ifdef MB_DEPINT_DEBUG
 		fprintf(stderr, "mb_depint_interp: sensordepth %f interpolated at fix %d of %d with factor:%f\n", *sensordepth, ifix,
-		        mb_io_ptr->nsensordepth, factor);
+		        nsensordepth, factor);
 #endif
 	}
 
 	/* extrapolate from last value */
-	else if (mb_io_ptr->nsensordepth > 1 && (mb_io_ptr->sensordepth_time_d[mb_io_ptr->nsensordepth - 1] < time_d)) {
+	else if (nsensordepth > 1 && (mb_asynch_time(asynch, nsensordepth - 1) < time_d)) {
 		/* extrapolated depth using last value */
-		*sensordepth = mb_io_ptr->sensordepth_sensordepth[mb_io_ptr->nsensordepth - 1];
+		*sensordepth = mb_asynch_value(asynch, nsensordepth - 1, 0);
 		status = MB_SUCCESS;
 #ifdef MB_DEPINT_DEBUG
-		fprintf(stderr, "mb_depint_interp: sensordepth %f extrapolated from last fix of %d\n", *sensordepth,
-		        mb_io_ptr->nsensordepth);
+		fprintf(stderr, "mb_depint_interp: sensordepth %f extrapolated from last fix of %d\n", *sensordepth, nsensordepth);
 #endif
 	}
 
 	/* extrapolate from first fix */
-	else if (mb_io_ptr->nsensordepth >= 1) {
-		*sensordepth = mb_io_ptr->sensordepth_sensordepth[0];
+	else if (nsensordepth >= 1) {
+		*sensordepth = mb_asynch_value(asynch, 0, 0);
 		status = MB_SUCCESS;
 #ifdef MB_DEPINT_DEBUG
-		fprintf(stderr, "mb_depint_interp: sensordepth %f extrapolated from first fix of %d\n", *sensordepth,
-		        mb_io_ptr->nsensordepth);
+		fprintf(stderr, "mb_depint_interp: sensordepth %f extrapolated from first fix of %d\n", *sensordepth, nsensordepth);
 #endif
 	}
 
@@ -1033,39 +1207,27 @@ int mb_altint_add(int verbose, void *mbio_ptr, double time_d, double altitude, i
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *asynch = &mb_io_ptr->asynch_altitude;
 
-	/* add another fix only if time stamp has changed */
-	if (mb_io_ptr->naltitude == 0 || (time_d > mb_io_ptr->altitude_time_d[mb_io_ptr->naltitude - 1])) {
-		/* if list if full make room for another altitude fix */
-		if (mb_io_ptr->naltitude >= MB_ASYNCH_SAVE_MAX) {
-			int shift = MB_ASYNCH_SAVE_MAX / 2;
-			for (int i = 0; i < mb_io_ptr->naltitude - shift; i++) {
-				mb_io_ptr->altitude_time_d[i] = mb_io_ptr->altitude_time_d[i + shift];
-				mb_io_ptr->altitude_altitude[i] = mb_io_ptr->altitude_altitude[i + shift];
-			}
-			mb_io_ptr->naltitude -= shift;
-		}
+	int status = MB_SUCCESS;
 
+	/* add another fix only if time stamp has changed */
+	if (asynch->nsample == 0 || (time_d > mb_asynch_time(asynch, asynch->nsample - 1))) {
 		/* add new fix to list */
-		mb_io_ptr->altitude_time_d[mb_io_ptr->naltitude] = time_d;
-		mb_io_ptr->altitude_altitude[mb_io_ptr->naltitude] = altitude;
-		mb_io_ptr->naltitude++;
+		status = mb_asynch_add(verbose, asynch, 1, time_d, &altitude, error);
 #ifdef MB_ALTINT_DEBUG
-		fprintf(stderr, "mb_altint_add:    altitude fix %d %f added\n", mb_io_ptr->naltitude, altitude);
+		fprintf(stderr, "mb_altint_add:    altitude fix %d %f added\n", asynch->nsample, altitude);
 #endif
 
-		if (verbose >= 4) {
+		if (verbose >= 4 && status == MB_SUCCESS) {
 			fprintf(stderr, "\ndbg4  Altitude fix added to list by MBIO function <%s>\n", __func__);
 			fprintf(stderr, "dbg4  New fix values:\n");
-			fprintf(stderr, "dbg4       naltitude:       %d\n", mb_io_ptr->naltitude);
-			fprintf(stderr, "dbg4       time_d:     %f\n", mb_io_ptr->altitude_time_d[mb_io_ptr->naltitude - 1]);
-			fprintf(stderr, "dbg4       altitude_altitude:  %f\n", mb_io_ptr->altitude_altitude[mb_io_ptr->naltitude - 1]);
+			fprintf(stderr, "dbg4       naltitude:       %d\n", asynch->nsample);
+			fprintf(stderr, "dbg4       time_d:     %f\n", mb_asynch_time(asynch, asynch->nsample - 1));
+			fprintf(stderr, "dbg4       altitude_altitude:  %f\n", mb_asynch_value(asynch, asynch->nsample - 1, 0));
 		}
 	}
 
-	/* assume success */
-	const int status = MB_SUCCESS;
-
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
 		fprintf(stderr, "dbg2  Return value:\n");
@@ -1074,7 +1236,6 @@ int mb_altint_add(int verbose, void *mbio_ptr, double time_d, double altitude, i
 		fprintf(stderr, "dbg2       status:     %d\n", status);
 	}
 
-	/* return success */
 	return (status);
 }
 /*--------------------------------------------------------------------*/
@@ -1094,47 +1255,42 @@ int mb_altint_interp(int verbose, void *mbio_ptr, double time_d, double *altitud
 
 	/* get pointers to mbio descriptor and data structures */
 	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_asynch_struct *asynch = &mb_io_ptr->asynch_altitude;
+	const int naltitude = asynch->nsample;
 
 	int status = MB_SUCCESS;
 
 	/* interpolate if possible */
-	if (mb_io_ptr->naltitude > 1 && (mb_io_ptr->altitude_time_d[mb_io_ptr->naltitude - 1] >= time_d) &&
-	    (mb_io_ptr->altitude_time_d[0] <= time_d)) {
+	if (naltitude > 1 && (mb_asynch_time(asynch, naltitude - 1) >= time_d) && (mb_asynch_time(asynch, 0) <= time_d)) {
 		/* get interpolated position */
-		ifix = (mb_io_ptr->naltitude - 1) * (time_d - mb_io_ptr->altitude_time_d[0]) /
-		       (mb_io_ptr->altitude_time_d[mb_io_ptr->naltitude - 1] - mb_io_ptr->altitude_time_d[0]);
-		while (time_d > mb_io_ptr->altitude_time_d[ifix])
-			ifix++;
-		while (time_d < mb_io_ptr->fix_time_d[ifix - 1])
-			ifix--;
-
-		factor = (time_d - mb_io_ptr->altitude_time_d[ifix - 1]) /
-		         (mb_io_ptr->altitude_time_d[ifix] - mb_io_ptr->altitude_time_d[ifix - 1]);
-		*altitude = mb_io_ptr->altitude_altitude[ifix - 1] +
-		            factor * (mb_io_ptr->altitude_altitude[ifix] - mb_io_ptr->altitude_altitude[ifix - 1]);
+		ifix = mb_asynch_find(asynch, time_d);
+
+		factor = (time_d - mb_asynch_time(asynch, ifix - 1)) / (mb_asynch_time(asynch, ifix) - mb_asynch_time(asynch, ifix - 1));
+		*altitude = mb_asynch_value(asynch, ifix - 1, 0) +
+		            factor * (mb_asynch_value(asynch, ifix, 0) - mb_asynch_value(asynch, ifix - 1, 0));
 		status = MB_SUCCESS;
 #ifdef MB_ALTINT_DEBUG
 		fprintf(stderr, "mb_altint_interp: altitude %f interpolated at fix %d of %d with factor:%f\n", *altitude, ifix,
-		        mb_io_ptr->naltitude, factor);
+		        naltitude, factor);
 #endif
 	}
 
 	/* extrapolate from last fix */
-	else if (mb_io_ptr->naltitude > 1 && (mb_io_ptr->altitude_time_d[mb_io_ptr->naltitude - 1] < time_d)) {
+	else if (naltitude > 1 && (mb_asynch_time(asynch, naltitude - 1) < time_d)) {
 		/* extrapolated position using average speed */
-		*altitude = mb_io_ptr->altitude_altitude[mb_io_ptr->naltitude - 1];
+		*altitude = mb_asynch_value(asynch, naltitude - 1, 0);
 		status = MB_SUCCESS;
 #ifdef MB_ALTINT_DEBUG
-		fprintf(stderr, "mb_altint_interp: altitude %f extrapolated from last fix of %d\n", *altitude, mb_io_ptr->naltitude);
+		fprintf(stderr, "mb_altint_interp: altitude %f extrapolated from last fix of %d\n", *altitude, naltitude);
 #endif
 	}
 
 	/* extrapolate from first fix */
-	else if (mb_io_ptr->naltitude >= 1) {
-		*altitude = mb_io_ptr->altitude_altitude[0];
+	else if (naltitude >= 1) {
+		*altitude = mb_asynch_value(asynch, 0, 0);
 		status = MB_SUCCESS;
 #ifdef MB_ALTINT_DEBUG
-		fprintf(stderr, "mb_altint_interp: altitude %f extrapolated from first fix of %d\n", *altitude, mb_io_ptr->naltitude);
+		fprintf(stderr, "mb_altint_interp: altitude %f extrapolated from first fix of %d\n", *altitude, naltitude);
 #endif
 	}
 
@@ -1019,7 +1019,10 @@ struct mb_esf_struct {
   struct mb_edit_struct *edit;
   FILE *esffp;
   FILE *essfp;
-  int startnextsearch;
+  int nbeam_alloc;
+  int *beam_edit;
+  int nnext_alloc;
+  int *edit_next;
 };
 
 #ifdef __cplusplus
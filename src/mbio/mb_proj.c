@@ -30,7 +30,10 @@
  * and inverse (mb_proj_inverse()) projections
  * between geographic coordinates (longitude and latitude) and
  * projected coordinates (e.g. eastings and northings in meters).
- * One can also tranlate between coordinate systems using mb_proj_transform().
+ * One can also tranlate between coordinate systems using mb_proj_transform(),
+ * and get the projected coordinate system as WKT using mb_proj_wkt().
+ * A projection used by several threads at once is copied for each thread
+ * with mb_proj_clone(), giving each copy its own context.
  * This code uses libproj. The code in libproj derives without modification
  * from the PROJ.4 distribution. PROJ was originally developed by
  * Gerard Evandim, and is now maintained and distributed by
@@ -199,6 +202,89 @@ int mb_proj_free(int verbose, void **pjptr, int *error) {
   return (status);
 }
 /*--------------------------------------------------------------------*/
+int mb_proj_clone(int verbose, void *pjptr, void **ctxptr, void **pjptr_clone, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       pjptr:      %p\n", pjptr);
+  }
+
+  /* initialize a copy of the projection in its own context so that it
+      can be used by a different thread than the original */
+  projCtx ctx = pj_ctx_alloc();
+  projPJ pj = NULL;
+  if (ctx != NULL && pjptr != NULL) {
+    char *definition = pj_get_def((projPJ)pjptr, 0);
+    if (definition != NULL) {
+      pj = pj_init_plus_ctx(ctx, definition);
+      pj_dalloc(definition);
+    }
+  }
+  if (pj == NULL && ctx != NULL) {
+    pj_ctx_free(ctx);
+    ctx = NULL;
+  }
+  *ctxptr = (void *)ctx;
+  *pjptr_clone = (void *)pj;
+
+  /* check success */
+  int status = MB_SUCCESS;
+  if (*pjptr_clone != NULL) {
+    *error = MB_ERROR_NO_ERROR;
+  }
+  else {
+    *error = MB_ERROR_BAD_PROJECTION;
+    status = MB_FAILURE;
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       ctxptr:          %p\n", (void *)*ctxptr);
+    fprintf(stderr, "dbg2       pjptr_clone:     %p\n", (void *)*pjptr_clone);
+    fprintf(stderr, "dbg2       error:           %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:          %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+int mb_proj_clone_free(int verbose, void **ctxptr, void **pjptr_clone, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       ctxptr:     %p\n", (void *)*ctxptr);
+    fprintf(stderr, "dbg2       pjptr_clone:%p\n", (void *)*pjptr_clone);
+  }
+
+  /* free the projection and then its context */
+  if (*pjptr_clone != NULL) {
+    pj_free((projPJ)*pjptr_clone);
+    *pjptr_clone = NULL;
+  }
+  if (*ctxptr != NULL) {
+    pj_ctx_free((projCtx)*ctxptr);
+    *ctxptr = NULL;
+  }
+
+  /* assume success */
+  *error = MB_ERROR_NO_ERROR;
+  const int status = MB_SUCCESS;
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:           %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:          %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
 int mb_proj_forward(int verbose, void *pjptr, double lon, double lat, double *easting, double *northing, int *error) {
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
@@ -283,6 +369,73 @@ int mb_proj_inverse(int verbose, void *pjptr, double easting, double northing, d
   return (status);
 }
 
+/*--------------------------------------------------------------------*/
+int mb_proj_wkt(int verbose, void *pjptr, char *wkt, int wkt_size, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       pjptr:      %p\n", (void *)pjptr);
+    fprintf(stderr, "dbg2       wkt_size:   %d\n", wkt_size);
+  }
+
+  /* the PROJ 4 API cannot describe a projection as WKT, so the WKT is
+      constructed here from the projection definition - only geographic and
+      UTM coordinates on the WGS84 datum, the projections used to export
+      swath data, are recognized */
+  int status = MB_FAILURE;
+  *error = MB_ERROR_BAD_PROJECTION;
+  if (wkt_size > 0)
+    wkt[0] = '\0';
+  char *definition = pjptr != NULL ? pj_get_def((projPJ)pjptr, 0) : NULL;
+  if (definition != NULL) {
+    const char *geogcs =
+        "GEOGCS[\"WGS 84\",DATUM[\"WGS_1984\",SPHEROID[\"WGS 84\",6378137,298.257223563,AUTHORITY[\"EPSG\",\"7030\"]],"
+        "AUTHORITY[\"EPSG\",\"6326\"]],PRIMEM[\"Greenwich\",0,AUTHORITY[\"EPSG\",\"8901\"]],"
+        "UNIT[\"degree\",0.0174532925199433,AUTHORITY[\"EPSG\",\"9122\"]],AUTHORITY[\"EPSG\",\"4326\"]]";
+    const bool wgs84 = strstr(definition, "+datum=WGS84") != NULL || strstr(definition, "+ellps=WGS84") != NULL;
+    const char *zone_param = strstr(definition, "+zone=");
+    int zone = 0;
+    int nchar = -1;
+    if (!wgs84) {
+      /* other datums are not recognized */
+    }
+    else if (strstr(definition, "+proj=longlat") != NULL || strstr(definition, "+proj=latlong") != NULL) {
+      nchar = snprintf(wkt, wkt_size, "%s", geogcs);
+    }
+    else if (strstr(definition, "+proj=utm") != NULL && zone_param != NULL && sscanf(zone_param, "+zone=%d", &zone) == 1
+             && zone >= 1 && zone <= 60) {
+      const bool south = strstr(definition, "+south") != NULL;
+      nchar = snprintf(wkt, wkt_size,
+                       "PROJCS[\"WGS 84 / UTM zone %d%c\",%s,PROJECTION[\"Transverse_Mercator\"],"
+                       "PARAMETER[\"latitude_of_origin\",0],PARAMETER[\"central_meridian\",%d],"
+                       "PARAMETER[\"scale_factor\",0.9996],PARAMETER[\"false_easting\",500000],"
+                       "PARAMETER[\"false_northing\",%d],UNIT[\"metre\",1,AUTHORITY[\"EPSG\",\"9001\"]],"
+                       "AXIS[\"Easting\",EAST],AXIS[\"Northing\",NORTH],AUTHORITY[\"EPSG\",\"%d\"]]",
+                       zone, south ? 'S' : 'N', geogcs, 6 * zone - 183, south ? 10000000 : 0,
+                       (south ? 32700 : 32600) + zone);
+    }
+    pj_dalloc(definition);
+    if (nchar >= 0 && nchar < wkt_size) {
+      status = MB_SUCCESS;
+      *error = MB_ERROR_NO_ERROR;
+    }
+    else if (wkt_size > 0) {
+      wkt[0] = '\0';
+    }
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:           %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:          %d\n", status);
+  }
+
+  return (status);
+}
+
 /*--------------------------------------------------------------------*/
 /*--------------------------------------------------------------------*/
 // Otherwise use the PROJ 6+ API
@@ -479,6 +632,84 @@ int mb_proj_free(int verbose, void **pjptr, int *error) {
   return (status);
 }
 /*--------------------------------------------------------------------*/
+int mb_proj_clone(int verbose, void *pjptr, void **ctxptr, void **pjptr_clone, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       pjptr:      %p\n", pjptr);
+  }
+
+  /* initialize a copy of the projection in its own context so that it
+      can be used by a different thread than the original */
+  PJ_CONTEXT *ctx = proj_context_create();
+  PJ *p = NULL;
+  if (ctx != NULL && pjptr != NULL)
+    p = proj_clone(ctx, (PJ *)pjptr);
+  if (p == NULL && ctx != NULL) {
+    proj_context_destroy(ctx);
+    ctx = NULL;
+  }
+  *ctxptr = (void *)ctx;
+  *pjptr_clone = (void *)p;
+
+  /* check success */
+  int status = MB_SUCCESS;
+  if (*pjptr_clone != NULL) {
+    *error = MB_ERROR_NO_ERROR;
+  }
+  else {
+    *error = MB_ERROR_BAD_PROJECTION;
+    status = MB_FAILURE;
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       ctxptr:          %p\n", (void *)*ctxptr);
+    fprintf(stderr, "dbg2       pjptr_clone:     %p\n", (void *)*pjptr_clone);
+    fprintf(stderr, "dbg2       error:           %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:          %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+int mb_proj_clone_free(int verbose, void **ctxptr, void **pjptr_clone, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       ctxptr:     %p\n", (void *)*ctxptr);
+    fprintf(stderr, "dbg2       pjptr_clone:%p\n", (void *)*pjptr_clone);
+  }
+
+  /* free the projection and then its context */
+  if (*pjptr_clone != NULL) {
+    proj_destroy((PJ *)*pjptr_clone);
+    *pjptr_clone = NULL;
+  }
+  if (*ctxptr != NULL) {
+    proj_context_destroy((PJ_CONTEXT *)*ctxptr);
+    *ctxptr = NULL;
+  }
+
+  /* assume success */
+  *error = MB_ERROR_NO_ERROR;
+  const int status = MB_SUCCESS;
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:           %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:          %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
 int mb_proj_forward(int verbose, void *pjptr, double u, double v, double *uu, double *vv, int *error) {
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
@@ -557,5 +788,45 @@ int mb_proj_inverse(int verbose, void *pjptr, double u, double v, double *uu, do
   return (status);
 }
 /*--------------------------------------------------------------------*/
+int mb_proj_wkt(int verbose, void *pjptr, char *wkt, int wkt_size, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       pjptr:      %p\n", (void *)pjptr);
+    fprintf(stderr, "dbg2       wkt_size:   %d\n", wkt_size);
+  }
+
+  /* get the target coordinate system of the projection - in MB-System
+      usually the projected coordinate system like UTM - as OGC WKT */
+  *error = MB_ERROR_BAD_PROJECTION;
+  int status = MB_FAILURE;
+  if (wkt_size > 0)
+    wkt[0] = '\0';
+  if (pjptr != NULL) {
+    PJ *crs = proj_get_target_crs(PJ_DEFAULT_CTX, (PJ *) pjptr);
+    if (crs != NULL) {
+      const char *crs_wkt = proj_as_wkt(PJ_DEFAULT_CTX, crs, PJ_WKT1_GDAL, NULL);
+      if (crs_wkt != NULL && (int)strlen(crs_wkt) < wkt_size) {
+        strcpy(wkt, crs_wkt);
+        *error = MB_ERROR_NO_ERROR;
+        status = MB_SUCCESS;
+      }
+      proj_destroy(crs);
+    }
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       wkt:             %s\n", wkt_size > 0 ? wkt : "");
+    fprintf(stderr, "dbg2       error:           %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:          %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
 
 #endif
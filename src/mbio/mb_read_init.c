@@ -598,27 +598,13 @@ int mb_read_init(int verbose, char *file, int format, int pings, int lonflip, do
 	}
 	mb_io_ptr->need_new_ping = true;
 
-	/* initialize variables for interpolating asynchronous data */
-	mb_io_ptr->nfix = 0;
-	mb_io_ptr->nattitude = 0;
-	mb_io_ptr->nheading = 0;
-	mb_io_ptr->nsensordepth = 0;
-	mb_io_ptr->naltitude = 0;
-	for (int i = 0; i < MB_ASYNCH_SAVE_MAX; i++) {
-		mb_io_ptr->fix_time_d[i] = 0.0;
-		mb_io_ptr->fix_lon[i] = 0.0;
-		mb_io_ptr->fix_lat[i] = 0.0;
-		mb_io_ptr->attitude_time_d[i] = 0.0;
-		mb_io_ptr->attitude_heave[i] = 0.0;
-		mb_io_ptr->attitude_roll[i] = 0.0;
-		mb_io_ptr->attitude_pitch[i] = 0.0;
-		mb_io_ptr->heading_time_d[i] = 0.0;
-		mb_io_ptr->heading_heading[i] = 0.0;
-		mb_io_ptr->sensordepth_time_d[i] = 0.0;
-		mb_io_ptr->sensordepth_sensordepth[i] = 0.0;
-		mb_io_ptr->altitude_time_d[i] = 0.0;
-		mb_io_ptr->altitude_altitude[i] = 0.0;
-	}
+	/* initialize variables for interpolating asynchronous data - the
+	    buffers are allocated as data are added */
+	memset(&mb_io_ptr->asynch_fix, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_attitude, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_heading, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_sensordepth, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_altitude, 0, sizeof(struct mb_asynch_struct));
 
 	/* initialize notices */
 	for (int i = 0; i < MB_NOTICE_MAX; i++)
@@ -648,6 +634,14 @@ int mb_read_init(int verbose, char *file, int format, int pings, int lonflip, do
 	  }
 	}
 
+	/* if a time window is specified and the format supports random access,
+	    skip directly to shortly before the start of the window - failure
+	    just means the file is read from the beginning */
+	if (mb_io_ptr->mb_io_seek_time != NULL && mb_io_ptr->etime_d > mb_io_ptr->btime_d) {
+		int seek_error = MB_ERROR_NO_ERROR;
+		mb_seek_time(verbose, (void *)mb_io_ptr, mb_io_ptr->btime_d - MB_SEEK_TIME_MARGIN, &seek_error);
+	}
+
 	/* set error and status (if you got here you succeeded */
 	*error = MB_ERROR_NO_ERROR;
 	status = MB_SUCCESS;
@@ -1261,27 +1255,13 @@ int mb_input_init(int verbose, char *socket_definition, int format,
 	}
 	mb_io_ptr->need_new_ping = true;
 
-	/* initialize variables for interpolating asynchronous data */
-	mb_io_ptr->nfix = 0;
-	mb_io_ptr->nattitude = 0;
-	mb_io_ptr->nheading = 0;
-	mb_io_ptr->nsensordepth = 0;
-	mb_io_ptr->naltitude = 0;
-	for (int i = 0; i < MB_ASYNCH_SAVE_MAX; i++) {
-		mb_io_ptr->fix_time_d[i] = 0.0;
-		mb_io_ptr->fix_lon[i] = 0.0;
-		mb_io_ptr->fix_lat[i] = 0.0;
-		mb_io_ptr->attitude_time_d[i] = 0.0;
-		mb_io_ptr->attitude_heave[i] = 0.0;
-		mb_io_ptr->attitude_roll[i] = 0.0;
-		mb_io_ptr->attitude_pitch[i] = 0.0;
-		mb_io_ptr->heading_time_d[i] = 0.0;
-		mb_io_ptr->heading_heading[i] = 0.0;
-		mb_io_ptr->sensordepth_time_d[i] = 0.0;
-		mb_io_ptr->sensordepth_sensordepth[i] = 0.0;
-		mb_io_ptr->altitude_time_d[i] = 0.0;
-		mb_io_ptr->altitude_altitude[i] = 0.0;
-	}
+	/* initialize variables for interpolating asynchronous data - the
+	    buffers are allocated as data are added */
+	memset(&mb_io_ptr->asynch_fix, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_attitude, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_heading, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_sensordepth, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_altitude, 0, sizeof(struct mb_asynch_struct));
 
 	/* initialize notices */
 	for (int i = 0; i < MB_NOTICE_MAX; i++)
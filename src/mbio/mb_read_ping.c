@@ -56,30 +56,48 @@ int mb_read_ping(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int *e
 
 	int status = MB_SUCCESS;
 
-	/* call the appropriate mbr_ read and translate routine */
-	if (mb_io_ptr->mb_io_read_ping != NULL) {
-		status = (*mb_io_ptr->mb_io_read_ping)(verbose, mbio_ptr, store_ptr, error);
+	/* if read ahead is enabled take the next record decoded by the reader
+	    thread - a NULL store_ptr hands the record over in the mbio
+	    descriptor's own store, otherwise it is copied into store_ptr */
+	if (mb_io_ptr->readahead != NULL) {
+		status = mb_readahead_read(verbose, mbio_ptr, store_ptr, kind, error);
+		if (store_ptr == NULL)
+			store_ptr = mb_io_ptr->store_data;
 	}
+
+	/* else call the appropriate mbr_ read and translate routine */
 	else {
-		status = MB_FAILURE;
-		*error = MB_ERROR_BAD_FORMAT;
-	}
+		if (store_ptr == NULL)
+			store_ptr = mb_io_ptr->store_data;
+		if (mb_io_ptr->mb_io_read_ping != NULL) {
+			status = (*mb_io_ptr->mb_io_read_ping)(verbose, mbio_ptr, store_ptr, error);
+		}
+		else {
+			status = MB_FAILURE;
+			*error = MB_ERROR_BAD_FORMAT;
+		}
 
-	/* set data record kind */
-	if (status == MB_SUCCESS) {
-		*kind = mb_io_ptr->new_kind;
-		mb_notice_log_datatype(verbose, mb_io_ptr, *kind);
+		/* set data record kind */
+		if (status == MB_SUCCESS) {
+			*kind = mb_io_ptr->new_kind;
+			mb_notice_log_datatype(verbose, mb_io_ptr, *kind);
+		}
+		else
+			*kind = MB_DATA_NONE;
 	}
-	else
-		*kind = MB_DATA_NONE;
 
 	/* check that io arrays are large enough, allocate larger arrays if necessary */
-	if (status == MB_SUCCESS && mb_io_ptr->new_kind == MB_DATA_DATA) {
+	if (status == MB_SUCCESS && *kind == MB_DATA_DATA) {
 		/* check size of arrays needed for newly read data */
 		int localkind;
 		int beams_bath;
 		int beams_amp;
 		int pixels_ss;
+
+		/* the reader thread may be running the format routine, which can
+		    use the arrays and maxima held in the mbio descriptor */
+		int lock_error = MB_ERROR_NO_ERROR;
+		mb_readahead_lock(verbose, mbio_ptr, &lock_error);
 		status = mb_dimensions(verbose, mbio_ptr, store_ptr, &localkind, &beams_bath, &beams_amp, &pixels_ss, error);
 
 		/* if existing allocations are insufficient, allocate larger arrays
@@ -92,6 +110,7 @@ int mb_read_ping(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int *e
 		mb_io_ptr->beams_bath_max = MAX(mb_io_ptr->beams_bath_max, beams_bath);
 		mb_io_ptr->beams_amp_max = MAX(mb_io_ptr->beams_amp_max, beams_amp);
 		mb_io_ptr->pixels_ss_max = MAX(mb_io_ptr->pixels_ss_max, pixels_ss);
+		mb_readahead_unlock(verbose, mbio_ptr, &lock_error);
 	}
 
 	if (verbose >= 2) {
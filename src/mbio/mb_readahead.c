@@ -0,0 +1,483 @@
+/*--------------------------------------------------------------------
+ *    The MB-system:	mb_readahead.c	10/18/2026
+ *
+ *    Copyright (c) 2026 by
+ *    David W. Caress (caress@mbari.org)
+ *      Monterey Bay Aquarium Research Institute
+ *      Moss Landing, California, USA
+ *    Dale N. Chayes
+ *      Center for Coastal and Ocean Mapping
+ *      University of New Hampshire
+ *      Durham, New Hampshire, USA
+ *    Christian dos Santos Ferreira
+ *      MARUM
+ *      University of Bremen
+ *      Bremen Germany
+ *
+ *    MB-System was created by Caress and Chayes in 1992 at the
+ *      Lamont-Doherty Earth Observatory
+ *      Columbia University
+ *      Palisades, NY 10964
+ *
+ *    See README.md file for copying and redistribution conditions.
+ *--------------------------------------------------------------------*/
+/*
+ * mb_readahead.c includes the "mb_" functions used to read and decode
+ * data records in a background thread ahead of the application. When
+ * enabled with mb_readahead_init() a reader thread calls the format's
+ * read and translate routine into a private working store, copies each
+ * record into a free slot of a bounded queue, and mb_read_ping() takes
+ * the records from the queue in file order. Records are handed to
+ * mb_get_all() by exchanging the queue store with the store owned by
+ * the mbio descriptor, so no copy is made on the application side.
+ *
+ * The reader thread holds the readahead lock while the format routine
+ * runs. Formats keep the state they carry between records in the mbio
+ * descriptor (the save* values, saveptr1 and saveptr2, the asynchronous
+ * navigation, attitude and heading buffers and the array maxima), so
+ * that state is shared by both threads. The lock is recursive: the
+ * mb_access functions (mb_extract(), mb_extract_nav(), mb_ttimes(),
+ * mb_insert() and the rest) take it around the format routines, and
+ * mb_read(), mb_get() and mb_get_all() hold it while they use the values
+ * left in the descriptor. Applications that read fields of the mbio
+ * descriptor directly should bracket that with mb_readahead_lock() and
+ * mb_readahead_unlock(), and must release the lock before reading the
+ * next record.
+ *
+ * Because the reader thread runs ahead, the state held in the mbio
+ * descriptor reflects the last record read by the reader thread rather
+ * than the record being used by the application. Interpolation from the
+ * asynchronous buffers is unaffected (more values are available, not
+ * fewer), but values that formats only store in the descriptor, such as
+ * ping numbers, may belong to a later record.
+ *
+ * Read ahead requires the format to provide store allocation and the
+ * record copy function. The reader thread decodes into a private working
+ * store so that any values the format carries from record to record in
+ * the store itself are kept, and copies each record into the queue.
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mb_define.h"
+#include "mb_io.h"
+#include "mb_status.h"
+
+/* one decoded record waiting to be consumed */
+struct mb_readahead_record_struct {
+	void *store_data;
+	int status;
+	int error;
+	int kind;
+	int time_i[7];
+	double time_d;
+};
+
+/* the current ping values the format routines leave in the mbio
+    descriptor, kept separately for the reader thread and the application */
+struct mb_readahead_view_struct {
+	int new_kind;
+	int new_error;
+	int new_time_i[7];
+	double new_time_d;
+	double new_lon;
+	double new_lat;
+	double new_speed;
+	double new_heading;
+};
+
+struct mb_readahead_struct {
+	struct mb_io_struct *mb_io_ptr;
+	int verbose;
+
+	/* reader thread, and the recursive lock serializing access to the
+	    mbio descriptor and to the queue */
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+
+	/* bounded queue of decoded records */
+	int nqueue;
+	int head;
+	int count;
+	struct mb_readahead_record_struct *queue;
+	bool stop; /* set by the application to end the reader thread */
+	bool done; /* set by the reader after a fatal error such as end of file */
+	int done_status;
+	int done_error;
+
+	/* store and current ping values used by the reader thread */
+	void *work_store;
+	struct mb_readahead_view_struct view;
+};
+
+/*--------------------------------------------------------------------*/
+static void mb_readahead_swap_view(struct mb_io_struct *mb_io_ptr, struct mb_readahead_view_struct *view) {
+	struct mb_readahead_view_struct save;
+	save.new_kind = mb_io_ptr->new_kind;
+	save.new_error = mb_io_ptr->new_error;
+	for (int i = 0; i < 7; i++)
+		save.new_time_i[i] = mb_io_ptr->new_time_i[i];
+	save.new_time_d = mb_io_ptr->new_time_d;
+	save.new_lon = mb_io_ptr->new_lon;
+	save.new_lat = mb_io_ptr->new_lat;
+	save.new_speed = mb_io_ptr->new_speed;
+	save.new_heading = mb_io_ptr->new_heading;
+
+	mb_io_ptr->new_kind = view->new_kind;
+	mb_io_ptr->new_error = view->new_error;
+	for (int i = 0; i < 7; i++)
+		mb_io_ptr->new_time_i[i] = view->new_time_i[i];
+	mb_io_ptr->new_time_d = view->new_time_d;
+	mb_io_ptr->new_lon = view->new_lon;
+	mb_io_ptr->new_lat = view->new_lat;
+	mb_io_ptr->new_speed = view->new_speed;
+	mb_io_ptr->new_heading = view->new_heading;
+
+	*view = save;
+}
+/*--------------------------------------------------------------------*/
+static void *mb_readahead_thread(void *arg) {
+	struct mb_readahead_struct *readahead = (struct mb_readahead_struct *)arg;
+	struct mb_io_struct *mb_io_ptr = readahead->mb_io_ptr;
+	const int verbose = readahead->verbose;
+
+	pthread_mutex_lock(&readahead->mutex);
+	while (true) {
+		/* wait for a free slot - the slot after the last queued record
+		    is not touched by the application until it is published */
+		while (readahead->count == readahead->nqueue && !readahead->stop)
+			pthread_cond_wait(&readahead->not_full, &readahead->mutex);
+		if (readahead->stop)
+			break;
+		struct mb_readahead_record_struct *record =
+		    &readahead->queue[(readahead->head + readahead->count) % readahead->nqueue];
+
+		/* read and translate the next record */
+		int error = MB_ERROR_NO_ERROR;
+		mb_readahead_swap_view(mb_io_ptr, &readahead->view);
+		mb_io_ptr->new_kind = MB_DATA_NONE;
+		int status = (*mb_io_ptr->mb_io_read_ping)(verbose, (void *)mb_io_ptr, readahead->work_store, &error);
+		record->kind = mb_io_ptr->new_kind;
+		record->time_d = mb_io_ptr->new_time_d;
+		for (int i = 0; i < 7; i++)
+			record->time_i[i] = mb_io_ptr->new_time_i[i];
+		mb_readahead_swap_view(mb_io_ptr, &readahead->view);
+		pthread_mutex_unlock(&readahead->mutex);
+
+		/* copy it into the queue, the working store keeps any state
+		    carried from record to record */
+		if (status == MB_SUCCESS) {
+			int copy_error = MB_ERROR_NO_ERROR;
+			status = (*mb_io_ptr->mb_io_copyrecord)(verbose, (void *)mb_io_ptr, readahead->work_store, record->store_data,
+			                                        &copy_error);
+			if (status == MB_FAILURE)
+				error = copy_error;
+		}
+		record->status = status;
+		record->error = error;
+
+		/* publish the record, stopping after fatal errors */
+		pthread_mutex_lock(&readahead->mutex);
+		readahead->count++;
+		pthread_cond_signal(&readahead->not_empty);
+		if (status == MB_FAILURE && error > MB_ERROR_NO_ERROR) {
+			readahead->done = true;
+			readahead->done_status = status;
+			readahead->done_error = error;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&readahead->mutex);
+
+	return (NULL);
+}
+/*--------------------------------------------------------------------*/
+int mb_readahead_init(int verbose, void *mbio_ptr, int nqueue, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+		fprintf(stderr, "dbg2       nqueue:     %d\n", nqueue);
+	}
+
+	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+
+	int status = MB_SUCCESS;
+	*error = MB_ERROR_NO_ERROR;
+
+	/* read ahead is only possible for input with formats that can
+	    allocate and copy their stores */
+	if (mb_io_ptr == NULL || mb_io_ptr->readahead != NULL || mb_io_ptr->mb_io_read_ping == NULL ||
+	    mb_io_ptr->mb_io_store_alloc == NULL || mb_io_ptr->mb_io_store_free == NULL || mb_io_ptr->mb_io_copyrecord == NULL ||
+	    mb_io_ptr->store_data == NULL || nqueue < 1) {
+		status = MB_FAILURE;
+		*error = MB_ERROR_BAD_USAGE;
+	}
+
+	struct mb_readahead_struct *readahead = NULL;
+	if (status == MB_SUCCESS) {
+		nqueue = MIN(nqueue, MB_READAHEAD_MAX);
+		readahead = (struct mb_readahead_struct *)calloc(1, sizeof(struct mb_readahead_struct));
+		if (readahead != NULL)
+			readahead->queue =
+			    (struct mb_readahead_record_struct *)calloc(nqueue, sizeof(struct mb_readahead_record_struct));
+		if (readahead == NULL || readahead->queue == NULL) {
+			free(readahead);
+			readahead = NULL;
+			status = MB_FAILURE;
+			*error = MB_ERROR_MEMORY_FAIL;
+		}
+	}
+
+	/* allocate the working store, starting from the current store so
+	    that any state already read is carried forward, and the queue stores */
+	if (status == MB_SUCCESS) {
+		readahead->mb_io_ptr = mb_io_ptr;
+		readahead->verbose = verbose;
+		readahead->nqueue = nqueue;
+		readahead->view.new_kind = mb_io_ptr->new_kind;
+		readahead->view.new_time_d = mb_io_ptr->new_time_d;
+		status = (*mb_io_ptr->mb_io_store_alloc)(verbose, mbio_ptr, &readahead->work_store, error);
+		if (status == MB_SUCCESS)
+			status = (*mb_io_ptr->mb_io_copyrecord)(verbose, mbio_ptr, mb_io_ptr->store_data, readahead->work_store, error);
+		for (int i = 0; i < nqueue && status == MB_SUCCESS; i++)
+			status = (*mb_io_ptr->mb_io_store_alloc)(verbose, mbio_ptr, &readahead->queue[i].store_data, error);
+	}
+
+	/* start the reader thread */
+	if (status == MB_SUCCESS) {
+		pthread_mutexattr_t mutexattr;
+		pthread_mutexattr_init(&mutexattr);
+		pthread_mutexattr_settype(&mutexattr, PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_init(&readahead->mutex, &mutexattr);
+		pthread_mutexattr_destroy(&mutexattr);
+		pthread_cond_init(&readahead->not_empty, NULL);
+		pthread_cond_init(&readahead->not_full, NULL);
+		if (pthread_create(&readahead->thread, NULL, mb_readahead_thread, (void *)readahead) == 0) {
+			mb_io_ptr->readahead = (void *)readahead;
+		}
+		else {
+			pthread_mutex_destroy(&readahead->mutex);
+			pthread_cond_destroy(&readahead->not_empty);
+			pthread_cond_destroy(&readahead->not_full);
+			status = MB_FAILURE;
+			*error = MB_ERROR_MEMORY_FAIL;
+		}
+	}
+
+	/* clean up after failure */
+	if (status == MB_FAILURE && readahead != NULL) {
+		int free_error = MB_ERROR_NO_ERROR;
+		if (readahead->work_store != NULL)
+			(*mb_io_ptr->mb_io_store_free)(verbose, mbio_ptr, &readahead->work_store, &free_error);
+		for (int i = 0; i < readahead->nqueue; i++)
+			if (readahead->queue[i].store_data != NULL)
+				(*mb_io_ptr->mb_io_store_free)(verbose, mbio_ptr, &readahead->queue[i].store_data, &free_error);
+		free(readahead->queue);
+		free(readahead);
+	}
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------*/
+int mb_readahead_read(int verbose, void *mbio_ptr, void *store_ptr, int *kind, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+		fprintf(stderr, "dbg2       store_ptr:  %p\n", (void *)store_ptr);
+	}
+
+	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_readahead_struct *readahead = (struct mb_readahead_struct *)mb_io_ptr->readahead;
+
+	int status = MB_SUCCESS;
+	*error = MB_ERROR_NO_ERROR;
+	*kind = MB_DATA_NONE;
+
+	if (readahead == NULL) {
+		status = MB_FAILURE;
+		*error = MB_ERROR_BAD_USAGE;
+	}
+
+	/* wait for the next record */
+	else {
+		pthread_mutex_lock(&readahead->mutex);
+		while (readahead->count == 0 && !readahead->done)
+			pthread_cond_wait(&readahead->not_empty, &readahead->mutex);
+
+		/* once the queue is drained after a fatal error keep reporting it */
+		if (readahead->count == 0) {
+			status = readahead->done_status;
+			*error = readahead->done_error;
+			mb_io_ptr->new_kind = MB_DATA_NONE;
+			mb_io_ptr->new_error = *error;
+		}
+
+		else {
+			struct mb_readahead_record_struct *record = &readahead->queue[readahead->head];
+			status = record->status;
+			*error = record->error;
+			mb_io_ptr->new_kind = record->kind;
+			mb_io_ptr->new_error = record->error;
+			mb_io_ptr->new_time_d = record->time_d;
+			for (int i = 0; i < 7; i++)
+				mb_io_ptr->new_time_i[i] = record->time_i[i];
+
+			/* hand over the record by exchanging stores with the mbio
+			    descriptor, or copy it into a store supplied by the caller */
+			if (store_ptr == NULL) {
+				void *store_tmp = mb_io_ptr->store_data;
+				mb_io_ptr->store_data = record->store_data;
+				record->store_data = store_tmp;
+			}
+			else if (status == MB_SUCCESS) {
+				int copy_error = MB_ERROR_NO_ERROR;
+				status = (*mb_io_ptr->mb_io_copyrecord)(verbose, mbio_ptr, record->store_data, store_ptr, &copy_error);
+				if (status == MB_FAILURE)
+					*error = copy_error;
+			}
+
+			readahead->head = (readahead->head + 1) % readahead->nqueue;
+			readahead->count--;
+			pthread_cond_signal(&readahead->not_full);
+		}
+
+		/* set data record kind */
+		if (status == MB_SUCCESS) {
+			*kind = mb_io_ptr->new_kind;
+			mb_notice_log_datatype(verbose, mbio_ptr, *kind);
+		}
+		pthread_mutex_unlock(&readahead->mutex);
+	}
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       kind:       %d\n", *kind);
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------*/
+int mb_readahead_lock(int verbose, void *mbio_ptr, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+	}
+
+	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_readahead_struct *readahead = (struct mb_readahead_struct *)mb_io_ptr->readahead;
+
+	/* without read ahead there is nothing to lock */
+	if (readahead != NULL)
+		pthread_mutex_lock(&readahead->mutex);
+
+	*error = MB_ERROR_NO_ERROR;
+	const int status = MB_SUCCESS;
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------*/
+int mb_readahead_unlock(int verbose, void *mbio_ptr, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+	}
+
+	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_readahead_struct *readahead = (struct mb_readahead_struct *)mb_io_ptr->readahead;
+
+	if (readahead != NULL)
+		pthread_mutex_unlock(&readahead->mutex);
+
+	*error = MB_ERROR_NO_ERROR;
+	const int status = MB_SUCCESS;
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------*/
+int mb_readahead_deall(int verbose, void *mbio_ptr, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+		fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+	}
+
+	struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+	struct mb_readahead_struct *readahead = (struct mb_readahead_struct *)mb_io_ptr->readahead;
+
+	int status = MB_SUCCESS;
+	*error = MB_ERROR_NO_ERROR;
+
+	if (readahead != NULL) {
+		/* stop the reader thread, which finishes any record in progress */
+		pthread_mutex_lock(&readahead->mutex);
+		readahead->stop = true;
+		pthread_cond_signal(&readahead->not_full);
+		pthread_mutex_unlock(&readahead->mutex);
+		pthread_join(readahead->thread, NULL);
+
+		/* free the stores and the queue */
+		status = (*mb_io_ptr->mb_io_store_free)(verbose, mbio_ptr, &readahead->work_store, error);
+		for (int i = 0; i < readahead->nqueue; i++)
+			status &= (*mb_io_ptr->mb_io_store_free)(verbose, mbio_ptr, &readahead->queue[i].store_data, error);
+		pthread_mutex_destroy(&readahead->mutex);
+		pthread_cond_destroy(&readahead->not_empty);
+		pthread_cond_destroy(&readahead->not_full);
+		free(readahead->queue);
+		free(readahead);
+		mb_io_ptr->readahead = NULL;
+	}
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------*/
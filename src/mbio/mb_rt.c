@@ -27,6 +27,10 @@
  * the velocity structure. The ray is traced until it either exits
  * the model or exhausts the specified travel time.
  *
+ * mb_rt_table() returns the same result by interpolating in a table
+ * of rays traced once from the top of the model, falling back to
+ * mb_rt() for rays the table does not cover.
+ *
  * Author:	D. W. Caress
  * Date:	November 14, 1994
  */
@@ -57,6 +61,17 @@ static const int MB_RT_PLOT_MODE_TABLE = 2;
 static const int MB_SSV_CORRECT = 1;
 static const int MB_SSV_INCORRECT = 2;
 
+/* raytracing lookup table defines - the table holds rays leaving the top
+    of the model at takeoff angles up to MB_RT_TABLE_ANGLE_MAX degrees,
+    sampled every MB_RT_TABLE_ANGLE_STEP degrees and every
+    MB_RT_TABLE_TIME_STEP seconds of one way travel time, up to at most
+    MB_RT_TABLE_TIME_LIMIT seconds - longer rays are traced directly */
+static const double MB_RT_TABLE_ANGLE_MAX = 85.0;
+static const double MB_RT_TABLE_ANGLE_STEP = 0.2;
+static const double MB_RT_TABLE_TIME_STEP = 0.005;
+static const double MB_RT_TABLE_TIME_GROWTH = 1.5;
+static const double MB_RT_TABLE_TIME_LIMIT = 20.0;
+
 struct velocity_model {
 	/* velocity model */
 	int number_node;
@@ -96,6 +111,20 @@ struct velocity_model {
 	double *xx_plot;
 	double *zz_plot;
 	double *tt_plot;
+
+	/* raytracing lookup table - for each takeoff angle at the top of
+	    the model the lateral distance and depth of the ray are stored
+	    every table_dtime seconds up to table_time_max, or up to the
+	    sample where the ray leaves the model */
+	int table_nangle;
+	int table_ntime;
+	double table_dangle;
+	double table_dtime;
+	double table_time_max;
+	int *table_nvalid;
+	int *table_iturn;
+	float *table_x;
+	float *table_z;
 };
 
 /*--------------------------------------------------------------------------*/
@@ -175,6 +204,17 @@ int mb_rt_init(int verbose, int number_node, double *depth, double *velocity, vo
 	model->zz_plot = NULL;
 	model->tt_plot = NULL;
 
+	/* the raytracing lookup table is built on first use by mb_rt_table() */
+	model->table_nangle = 0;
+	model->table_ntime = 0;
+	model->table_dangle = 0.0;
+	model->table_dtime = 0.0;
+	model->table_time_max = 0.0;
+	model->table_nvalid = NULL;
+	model->table_iturn = NULL;
+	model->table_x = NULL;
+	model->table_z = NULL;
+
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
 		fprintf(stderr, "dbg2  Return values:\n");
@@ -197,7 +237,14 @@ int mb_rt_deall(int verbose, void **modelptr, int *error) {
 
 	/* deallocate memory for velocity model */
   struct velocity_model *model = (struct velocity_model *)*modelptr;
-	int status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->depth), error);
+	int status = MB_SUCCESS;
+	if (model->table_nangle > 0) {
+		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_nvalid), error);
+		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_iturn), error);
+		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_x), error);
+		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_z), error);
+	}
+	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->depth), error);
 	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->velocity), error);
 	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->layer_mode), error);
 	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->layer_gradient), error);
@@ -1033,3 +1080,298 @@ int mb_rt(int verbose, void *modelptr, double source_depth, double source_angle,
 	return (status);
 }
 /*--------------------------------------------------------------------------*/
+static int mb_rt_table_build(int verbose, void *modelptr, double time_max, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:          %d\n", verbose);
+		fprintf(stderr, "dbg2       modelptr:         %p\n", (void *)modelptr);
+		fprintf(stderr, "dbg2       time_max:         %f\n", time_max);
+	}
+
+	/* get velocity model struct * */
+	struct velocity_model *model = (struct velocity_model *)modelptr;
+
+	/* release any previous table */
+	int status = MB_SUCCESS;
+	if (model->table_nangle > 0) {
+		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_nvalid), error);
+		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_iturn), error);
+		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_x), error);
+		status = mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_z), error);
+		model->table_nangle = 0;
+	}
+
+	/* allocate the table and arrays for the traced raypaths - a ray
+	    crosses each layer at most twice */
+	const int nangle = (int)(MB_RT_TABLE_ANGLE_MAX / MB_RT_TABLE_ANGLE_STEP + 0.5) + 1;
+	const int ntime = (int)(time_max / MB_RT_TABLE_TIME_STEP) + 2;
+	const int npath = 2 * model->number_layer * MB_RT_NUMBER_SEGMENTS + 2;
+	double *xpath = NULL;
+	double *zpath = NULL;
+	double *tpath = NULL;
+	status = mb_mallocd(verbose, __FILE__, __LINE__, nangle * sizeof(int), (void **)&(model->table_nvalid), error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, nangle * sizeof(int), (void **)&(model->table_iturn), error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, nangle * ntime * sizeof(float), (void **)&(model->table_x), error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, nangle * ntime * sizeof(float), (void **)&(model->table_z), error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, npath * sizeof(double), (void **)&xpath, error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, npath * sizeof(double), (void **)&zpath, error);
+	if (status == MB_SUCCESS)
+		status = mb_mallocd(verbose, __FILE__, __LINE__, npath * sizeof(double), (void **)&tpath, error);
+	if (status == MB_FAILURE) {
+		int free_error = MB_ERROR_NO_ERROR;
+		mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_nvalid), &free_error);
+		mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_iturn), &free_error);
+		mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_x), &free_error);
+		mb_freed(verbose, __FILE__, __LINE__, (void **)&(model->table_z), &free_error);
+		mb_freed(verbose, __FILE__, __LINE__, (void **)&xpath, &free_error);
+		mb_freed(verbose, __FILE__, __LINE__, (void **)&zpath, &free_error);
+		mb_freed(verbose, __FILE__, __LINE__, (void **)&tpath, &free_error);
+		return (status);
+	}
+	model->table_nangle = nangle;
+	model->table_ntime = ntime;
+	model->table_dangle = MB_RT_TABLE_ANGLE_STEP;
+	model->table_dtime = MB_RT_TABLE_TIME_STEP;
+	model->table_time_max = (ntime - 1) * MB_RT_TABLE_TIME_STEP;
+
+	/* trace a ray from the top of the model for each takeoff angle and
+	    resample the raypath at regular travel times - within each layer
+	    the path is a straight line or a circular arc split into
+	    MB_RT_NUMBER_SEGMENTS chords, so linear interpolation along the
+	    path is accurate to well below a centimeter */
+	for (int iangle = 0; iangle < nangle; iangle++) {
+		float *xrow = &model->table_x[iangle * ntime];
+		float *zrow = &model->table_z[iangle * ntime];
+		int nplot = 0;
+		double x;
+		double z;
+		double travel_time;
+		int ray_stat;
+		int rt_error = MB_ERROR_NO_ERROR;
+		mb_rt(0, modelptr, model->depth[0], iangle * MB_RT_TABLE_ANGLE_STEP, model->table_time_max, 0, 0.0, 0.0, npath, &nplot,
+		      xpath, zpath, tpath, &x, &z, &travel_time, &ray_stat, &rt_error);
+
+		/* get the travel time to each point of the raypath - the velocity
+		    varies linearly along each chord, so the time along the chord
+		    is its length times the mean slowness */
+		tpath[0] = 0.0;
+		int inode = 0;
+		double v0 = model->velocity[0];
+		for (int i = 1; i < nplot; i++) {
+			while (inode > 0 && zpath[i] < model->depth[inode])
+				inode--;
+			while (inode < model->number_node - 2 && zpath[i] > model->depth[inode + 1])
+				inode++;
+			const double dz = model->depth[inode + 1] - model->depth[inode];
+			const double v1 = dz > 0.0 ? model->velocity[inode] + (zpath[i] - model->depth[inode]) *
+			                                 (model->velocity[inode + 1] - model->velocity[inode]) / dz
+			                           : model->velocity[inode];
+			const double length = sqrt((xpath[i] - xpath[i - 1]) * (xpath[i] - xpath[i - 1]) +
+			                           (zpath[i] - zpath[i - 1]) * (zpath[i] - zpath[i - 1]));
+			if (fabs(v1 - v0) > MB_RT_GRADIENT_TOLERANCE)
+				tpath[i] = tpath[i - 1] + length * log(v1 / v0) / (v1 - v0);
+			else
+				tpath[i] = tpath[i - 1] + length / v0;
+			v0 = v1;
+		}
+
+		int ipath = 0;
+		int ivalid = 0;
+		for (int itime = 0; itime < ntime; itime++) {
+			const double tt = itime * MB_RT_TABLE_TIME_STEP;
+			while (ipath < nplot - 2 && tpath[ipath + 1] < tt)
+				ipath++;
+			if (nplot < 2 || tt > tpath[nplot - 1])
+				break;
+			const double dtpath = tpath[ipath + 1] - tpath[ipath];
+			const double factor = dtpath > 0.0 ? (tt - tpath[ipath]) / dtpath : 0.0;
+			xrow[itime] = (float)fabs(xpath[ipath] + factor * (xpath[ipath + 1] - xpath[ipath]));
+			zrow[itime] = (float)(zpath[ipath] + factor * (zpath[ipath + 1] - zpath[ipath]));
+			ivalid = itime + 1;
+		}
+		model->table_nvalid[iangle] = ivalid;
+
+		/* find the deepest sample, beyond which the ray is going up */
+		int iturn = 0;
+		for (int itime = 1; itime < ivalid; itime++) {
+			if (zrow[itime] >= zrow[iturn])
+				iturn = itime;
+		}
+		model->table_iturn[iangle] = iturn;
+	}
+
+	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&xpath, error);
+	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&zpath, error);
+	status = mb_freed(verbose, __FILE__, __LINE__, (void **)&tpath, error);
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       table_nangle:     %d\n", model->table_nangle);
+		fprintf(stderr, "dbg2       table_ntime:      %d\n", model->table_ntime);
+		fprintf(stderr, "dbg2       error:            %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:           %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------------*/
+/* Find the position along one tabulated ray of a ray leaving depth
+    source_depth and travelling for end_time seconds. The ray from the
+    source follows the same path as the tabulated ray from the top of the
+    model, offset by the time and distance the tabulated ray takes to
+    reach the source depth. Returns false if the table does not cover
+    the ray. */
+static bool mb_rt_table_row(struct velocity_model *model, int iangle, double source_depth, double end_time, double *x,
+                            double *z, bool *turned) {
+	const float *xrow = &model->table_x[iangle * model->table_ntime];
+	const float *zrow = &model->table_z[iangle * model->table_ntime];
+	const int iturn = model->table_iturn[iangle];
+	if (source_depth > zrow[iturn])
+		return (false);
+
+	/* bisect the downgoing part of the ray for the source depth */
+	int i0 = 0;
+	int i1 = iturn;
+	while (i1 - i0 > 1) {
+		const int i = (i0 + i1) / 2;
+		if (zrow[i] > source_depth)
+			i1 = i;
+		else
+			i0 = i;
+	}
+	double factor = zrow[i1] > zrow[i0] ? (source_depth - zrow[i0]) / (zrow[i1] - zrow[i0]) : 0.0;
+	const double x0 = xrow[i0] + factor * (xrow[i1] - xrow[i0]);
+	const double time = (i0 + factor + end_time / model->table_dtime);
+
+	/* interpolate the ray position at the end time */
+	const int itime = (int)time;
+	if (itime + 1 >= model->table_nvalid[iangle])
+		return (false);
+	factor = time - itime;
+	*x = xrow[itime] + factor * (xrow[itime + 1] - xrow[itime]) - x0;
+	*z = zrow[itime] + factor * (zrow[itime + 1] - zrow[itime]);
+	*turned = itime >= iturn;
+
+	return (true);
+}
+/*--------------------------------------------------------------------------*/
+int mb_rt_table(int verbose, void *modelptr, double source_depth, double source_angle, double end_time, int ssv_mode,
+                double surface_vel, double null_angle, double *x, double *z, double *travel_time, int *ray_stat, int *error) {
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+		fprintf(stderr, "dbg2  Input arguments:\n");
+		fprintf(stderr, "dbg2       verbose:          %d\n", verbose);
+		fprintf(stderr, "dbg2       modelptr:         %p\n", (void *)modelptr);
+		fprintf(stderr, "dbg2       source_depth:     %f\n", source_depth);
+		fprintf(stderr, "dbg2       source_angle:     %f\n", source_angle);
+		fprintf(stderr, "dbg2       end_time:         %f\n", end_time);
+		fprintf(stderr, "dbg2       ssv_mode:         %d\n", ssv_mode);
+		fprintf(stderr, "dbg2       surface_vel:      %f\n", surface_vel);
+		fprintf(stderr, "dbg2       null_angle:       %f\n", null_angle);
+	}
+
+	/* get velocity model struct * */
+	struct velocity_model *model = (struct velocity_model *)modelptr;
+
+	int status = MB_SUCCESS;
+
+	/* build the table on first use, and rebuild it with more travel
+	    time if needed - it does not depend on the source depth, so
+	    changes in draft and heave never require a rebuild, and its size
+	    is bounded by MB_RT_TABLE_TIME_LIMIT */
+	if ((model->table_nangle == 0 || end_time > model->table_time_max) && end_time <= MB_RT_TABLE_TIME_LIMIT) {
+		const double time_max =
+		    MIN(MB_RT_TABLE_TIME_GROWTH * MAX(end_time, model->table_time_max), MB_RT_TABLE_TIME_LIMIT);
+		status = mb_rt_table_build(verbose, modelptr, time_max, error);
+	}
+
+	/* find the source layer and velocity */
+	bool use_table = status == MB_SUCCESS && model->table_nangle > 0 && end_time >= 0.0 &&
+	                 end_time <= model->table_time_max && model->number_layer > 0 &&
+	                 source_depth >= model->depth[0] && source_depth <= model->depth[model->number_node - 1];
+	double angle = source_angle;
+	double pp = 0.0;
+	if (use_table) {
+		int i0 = 0;
+		int i1 = model->number_node - 1;
+		while (i1 - i0 > 1) {
+			const int i = (i0 + i1) / 2;
+			if (model->depth[i] > source_depth)
+				i1 = i;
+			else
+				i0 = i;
+		}
+		const double vv_source = model->layer_vel_top[i0] + model->layer_gradient[i0] * (source_depth - model->layer_depth_top[i0]);
+
+		/* reset takeoff angle because of surface sound velocity change
+		    exactly as in mb_rt() */
+		if (ssv_mode == MB_SSV_CORRECT && surface_vel > 0.0) {
+			pp = sin(DTR * angle) / surface_vel;
+			angle = asin(MIN(1.0, pp * vv_source)) * RTD;
+		}
+		else if (ssv_mode == MB_SSV_INCORRECT && surface_vel > 0.0) {
+			double diff_angle = angle - null_angle;
+			pp = sin(DTR * diff_angle) / surface_vel;
+			diff_angle = asin(MIN(1.0, pp * vv_source)) * RTD;
+			angle = null_angle + diff_angle;
+		}
+		angle = fabs(angle);
+		pp = sin(DTR * angle) / vv_source;
+		use_table = angle < 90.0;
+	}
+
+	/* get the takeoff angle of the same ray at the top of the model and
+	    interpolate between the bracketing tabulated rays */
+	if (use_table) {
+		const double sin_top = pp * model->velocity[0];
+		const double angle_top = sin_top < 1.0 ? asin(sin_top) * RTD : 90.0;
+		const double fangle = angle_top / model->table_dangle;
+		const int iangle = (int)fangle;
+		const double factor = fangle - iangle;
+		double x0;
+		double z0;
+		double x1 = 0.0;
+		double z1 = 0.0;
+		bool turned0 = false;
+		bool turned1 = false;
+		use_table = iangle + 1 < model->table_nangle &&
+		            mb_rt_table_row(model, iangle, source_depth, end_time, &x0, &z0, &turned0) &&
+		            mb_rt_table_row(model, iangle + 1, source_depth, end_time, &x1, &z1, &turned1);
+		if (use_table) {
+			*x = x0 + factor * (x1 - x0);
+			*z = z0 + factor * (z1 - z0);
+			*travel_time = end_time;
+			*ray_stat = (turned0 || turned1) ? MB_RT_UP_TURN : MB_RT_DOWN;
+		}
+	}
+
+	/* else trace the ray directly */
+	if (!use_table) {
+		int nplot;
+		status = mb_rt(verbose, modelptr, source_depth, source_angle, end_time, ssv_mode, surface_vel, null_angle, 0, &nplot,
+		               NULL, NULL, NULL, x, z, travel_time, ray_stat, error);
+	}
+
+	if (verbose >= 2) {
+		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+		fprintf(stderr, "dbg2  Return values:\n");
+		fprintf(stderr, "dbg2       x:          %f\n", *x);
+		fprintf(stderr, "dbg2       z:          %f\n", *z);
+		fprintf(stderr, "dbg2       travel_time:%f\n", *travel_time);
+		fprintf(stderr, "dbg2       raystat:    %d\n", *ray_stat);
+		fprintf(stderr, "dbg2       error:      %d\n", *error);
+		fprintf(stderr, "dbg2  Return status:\n");
+		fprintf(stderr, "dbg2       status:     %d\n", status);
+	}
+
+	return (status);
+}
+/*--------------------------------------------------------------------------*/
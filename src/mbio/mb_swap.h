@@ -40,9 +40,138 @@
 #ifndef MB_SWAP_H_
 #define MB_SWAP_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
 #define mb_swap_short(a) (((a & 0xff) << 8) | ((unsigned short)(a) >> 8))
 
 #define mb_swap_int(a) (((a) << 24) | (((a) << 8) & 0x00ff0000) | (((a) >> 8) & 0x0000ff00) | ((unsigned int)(a) >> 24))
 
+/*
+ * Inline decoders for binary values in data records. The swapped argument
+ * has the same meaning as for mb_get_binary_short() and friends: true if
+ * the values are stored little-endian, false if stored big-endian. The
+ * per value decoders are for record parsers that decode fields one at a
+ * time in beam loops; the array decoders convert whole arrays of values,
+ * and are written as simple loops of unaligned loads, byte swaps and
+ * stores that the compiler vectorizes.
+ */
+
+/* true if values stored with the given byte order must be swapped */
+#ifdef BYTESWAPPED
+#define MB_SWAP_NEEDED(swapped) (!(swapped))
+#else
+#define MB_SWAP_NEEDED(swapped) (swapped)
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define mb_bswap16(a) __builtin_bswap16(a)
+#define mb_bswap32(a) __builtin_bswap32(a)
+#define mb_bswap64(a) __builtin_bswap64(a)
+#else
+static inline uint16_t mb_bswap16(uint16_t a) {
+	return (uint16_t)((a << 8) | (a >> 8));
+}
+static inline uint32_t mb_bswap32(uint32_t a) {
+	return (a << 24) | ((a << 8) & 0x00ff0000) | ((a >> 8) & 0x0000ff00) | (a >> 24);
+}
+static inline uint64_t mb_bswap64(uint64_t a) {
+	return ((uint64_t)mb_bswap32((uint32_t)a) << 32) | mb_bswap32((uint32_t)(a >> 32));
+}
+#endif
+
+static inline void mb_get_binary_short_inline(bool swapped, const void *buffer, void *ptr) {
+	uint16_t value;
+	memcpy(&value, buffer, sizeof(value));
+	if (MB_SWAP_NEEDED(swapped))
+		value = mb_bswap16(value);
+	memcpy(ptr, &value, sizeof(value));
+}
+static inline void mb_get_binary_int_inline(bool swapped, const void *buffer, void *ptr) {
+	uint32_t value;
+	memcpy(&value, buffer, sizeof(value));
+	if (MB_SWAP_NEEDED(swapped))
+		value = mb_bswap32(value);
+	memcpy(ptr, &value, sizeof(value));
+}
+static inline void mb_get_binary_float_inline(bool swapped, const void *buffer, void *ptr) {
+	mb_get_binary_int_inline(swapped, buffer, ptr);
+}
+static inline void mb_get_binary_long_inline(bool swapped, const void *buffer, void *ptr) {
+	uint64_t value;
+	memcpy(&value, buffer, sizeof(value));
+	if (MB_SWAP_NEEDED(swapped))
+		value = mb_bswap64(value);
+	memcpy(ptr, &value, sizeof(value));
+}
+static inline void mb_get_binary_double_inline(bool swapped, const void *buffer, void *ptr) {
+	mb_get_binary_long_inline(swapped, buffer, ptr);
+}
+
+/* decode n contiguous 2, 4 or 8 byte values - buffer and values may be
+    the same array but must not otherwise overlap */
+static inline void mb_get_binary_short_array(bool swapped, const void *buffer, int n, void *values) {
+	if (MB_SWAP_NEEDED(swapped)) {
+		const unsigned char *src = (const unsigned char *)buffer;
+		unsigned char *dst = (unsigned char *)values;
+		for (int i = 0; i < n; i++) {
+			uint16_t value;
+			memcpy(&value, src + 2 * i, sizeof(value));
+			value = mb_bswap16(value);
+			memcpy(dst + 2 * i, &value, sizeof(value));
+		}
+	}
+	else if (buffer != values && n > 0) {
+		memcpy(values, buffer, 2 * (size_t)n);
+	}
+}
+static inline void mb_get_binary_int_array(bool swapped, const void *buffer, int n, void *values) {
+	if (MB_SWAP_NEEDED(swapped)) {
+		const unsigned char *src = (const unsigned char *)buffer;
+		unsigned char *dst = (unsigned char *)values;
+		for (int i = 0; i < n; i++) {
+			uint32_t value;
+			memcpy(&value, src + 4 * i, sizeof(value));
+			value = mb_bswap32(value);
+			memcpy(dst + 4 * i, &value, sizeof(value));
+		}
+	}
+	else if (buffer != values && n > 0) {
+		memcpy(values, buffer, 4 * (size_t)n);
+	}
+}
+static inline void mb_get_binary_float_array(bool swapped, const void *buffer, int n, float *values) {
+	mb_get_binary_int_array(swapped, buffer, n, values);
+}
+static inline void mb_get_binary_double_array(bool swapped, const void *buffer, int n, double *values) {
+	if (MB_SWAP_NEEDED(swapped)) {
+		const unsigned char *src = (const unsigned char *)buffer;
+		unsigned char *dst = (unsigned char *)values;
+		for (int i = 0; i < n; i++) {
+			uint64_t value;
+			memcpy(&value, src + 8 * i, sizeof(value));
+			value = mb_bswap64(value);
+			memcpy(dst + 8 * i, &value, sizeof(value));
+		}
+	}
+	else if ((const void *)buffer != (const void *)values && n > 0) {
+		memcpy(values, buffer, 8 * (size_t)n);
+	}
+}
+
+/* decode n 4 byte floats spaced stride bytes apart into a contiguous array */
+static inline void mb_get_binary_float_strided(bool swapped, const void *buffer, int stride, int n, float *values) {
+	const unsigned char *src = (const unsigned char *)buffer;
+	const bool swap = MB_SWAP_NEEDED(swapped);
+	for (int i = 0; i < n; i++) {
+		uint32_t value;
+		memcpy(&value, src + (size_t)i * stride, sizeof(value));
+		if (swap)
+			value = mb_bswap32(value);
+		memcpy(&values[i], &value, sizeof(value));
+	}
+}
+
 #endif  /* MB_SWAP_H_ */
 
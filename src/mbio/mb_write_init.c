@@ -541,27 +541,13 @@ int mb_write_init(int verbose, char *file, int format, void **mbio_ptr, int *bea
 	}
 	mb_io_ptr->need_new_ping = true;
 
-	/* initialize variables for interpolating asynchronous data */
-	mb_io_ptr->nfix = 0;
-	mb_io_ptr->nattitude = 0;
-	mb_io_ptr->nheading = 0;
-	mb_io_ptr->nsensordepth = 0;
-	mb_io_ptr->naltitude = 0;
-	for (int i = 0; i < MB_ASYNCH_SAVE_MAX; i++) {
-		mb_io_ptr->fix_time_d[i] = 0.0;
-		mb_io_ptr->fix_lon[i] = 0.0;
-		mb_io_ptr->fix_lat[i] = 0.0;
-		mb_io_ptr->attitude_time_d[i] = 0.0;
-		mb_io_ptr->attitude_heave[i] = 0.0;
-		mb_io_ptr->attitude_roll[i] = 0.0;
-		mb_io_ptr->attitude_pitch[i] = 0.0;
-		mb_io_ptr->heading_time_d[i] = 0.0;
-		mb_io_ptr->heading_heading[i] = 0.0;
-		mb_io_ptr->sensordepth_time_d[i] = 0.0;
-		mb_io_ptr->sensordepth_sensordepth[i] = 0.0;
-		mb_io_ptr->altitude_time_d[i] = 0.0;
-		mb_io_ptr->altitude_altitude[i] = 0.0;
-	}
+	/* initialize variables for interpolating asynchronous data - the
+	    buffers are allocated as data are added */
+	memset(&mb_io_ptr->asynch_fix, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_attitude, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_heading, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_sensordepth, 0, sizeof(struct mb_asynch_struct));
+	memset(&mb_io_ptr->asynch_altitude, 0, sizeof(struct mb_asynch_struct));
 
 	/* initialize notices */
 	for (int i = 0; i < MB_NOTICE_MAX; i++)
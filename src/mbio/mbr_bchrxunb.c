@@ -1385,7 +1385,7 @@ int mbr_rt_bchrxunb(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 
 	/* interpolate navigation for survey pings if needed */
 	if (status == MB_SUCCESS && data->kind == MB_DATA_DATA && data->profile[0].longitude == 0 && data->profile[0].latitude == 0 &&
-	    mb_io_ptr->nfix >= 1) {
+	    mb_io_ptr->asynch_fix.nsample >= 1) {
 		mb_fix_y2k(verbose, data->profile[0].year, &time_i[0]);
 		time_i[1] = data->profile[0].month;
 		time_i[2] = data->profile[0].day;
@@ -1310,7 +1310,7 @@ int mbr_rt_cbat8101(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 
 	/* interpolate navigation for survey pings if needed */
 	if (status == MB_SUCCESS && data->kind == MB_DATA_DATA && data->longitude == 0 && data->latitude == 0 &&
-	    mb_io_ptr->nfix >= 1) {
+	    mb_io_ptr->asynch_fix.nsample >= 1) {
 		mb_fix_y2k(verbose, data->year, &time_i[0]);
 		time_i[1] = data->month;
 		time_i[2] = data->day;
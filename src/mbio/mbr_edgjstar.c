@@ -626,25 +626,25 @@ __FILE__, __LINE__, __FUNCTION__, ftell(mb_io_ptr->mbfp));
 				mb_get_time(verbose, time_i, &time_d);
 
 				/* set navigation and attitude if needed and available */
-				if (sbp->heading == 0 && mb_io_ptr->nheading > 0) {
+				if (sbp->heading == 0 && mb_io_ptr->asynch_heading.nsample > 0) {
 					mb_hedint_interp(verbose, mbio_ptr, time_d, &heading, error);
 					sbp->heading = (short)(100.0 * heading);
 				}
-				if ((sbp->coordX == 0 || sbp->coordY == 0 || sbp->coordUnits == 2) && mb_io_ptr->nfix > 0) {
+				if ((sbp->coordX == 0 || sbp->coordY == 0 || sbp->coordUnits == 2) && mb_io_ptr->asynch_fix.nsample > 0) {
 					mb_navint_interp(verbose, mbio_ptr, time_d, heading, 0.0, &navlon, &navlat, &speed, error);
 					sbp->coordX = (int)(600000.0 * navlon);
 					sbp->coordY = (int)(600000.0 * navlat);
 				}
-				if ((sbp->roll == 0 || sbp->pitch == 0) && mb_io_ptr->nattitude > 0) {
+				if ((sbp->roll == 0 || sbp->pitch == 0) && mb_io_ptr->asynch_attitude.nsample > 0) {
 					mb_attint_interp(verbose, mbio_ptr, time_d, &heave, &roll, &pitch, error);
 					sbp->roll = 32768 * roll / 180.0;
 					sbp->pitch = 32768 * pitch / 180.0;
 				}
-				if (sbp->sonarAltitude == 0 && mb_io_ptr->naltitude > 0) {
+				if (sbp->sonarAltitude == 0 && mb_io_ptr->asynch_altitude.nsample > 0) {
 					mb_altint_interp(verbose, mbio_ptr, time_d, &altitude, error);
 					sbp->sonarAltitude = altitude / 1000.0;
 				}
-				if (sbp->sonarDepth == 0 && mb_io_ptr->nsensordepth > 0) {
+				if (sbp->sonarDepth == 0 && mb_io_ptr->asynch_sensordepth.nsample > 0) {
 					mb_depint_interp(verbose, mbio_ptr, time_d, &sensordepth, error);
 					sbp->sonarDepth = sensordepth / 1000.0;
 				}
@@ -888,25 +888,25 @@ __FILE__, __LINE__, __FUNCTION__, ftell(mb_io_ptr->mbfp));
 				mb_get_time(verbose, time_i, &time_d);
 
 				/* set navigation and attitude if needed and available */
-				if (ss->heading == 0 && mb_io_ptr->nheading > 0) {
+				if (ss->heading == 0 && mb_io_ptr->asynch_heading.nsample > 0) {
 					mb_hedint_interp(verbose, mbio_ptr, time_d, &heading, error);
 					ss->heading = (short)(100.0 * heading);
 				}
-				if ((ss->coordX == 0 || ss->coordY == 0 || ss->coordUnits == 2) && mb_io_ptr->nfix > 0) {
+				if ((ss->coordX == 0 || ss->coordY == 0 || ss->coordUnits == 2) && mb_io_ptr->asynch_fix.nsample > 0) {
 					mb_navint_interp(verbose, mbio_ptr, time_d, heading, 0.0, &navlon, &navlat, &speed, error);
 					ss->coordX = (int)(600000.0 * navlon);
 					ss->coordY = (int)(600000.0 * navlat);
 				}
-				if ((ss->roll == 0 || ss->pitch == 0) && mb_io_ptr->nattitude > 0) {
+				if ((ss->roll == 0 || ss->pitch == 0) && mb_io_ptr->asynch_attitude.nsample > 0) {
 					mb_attint_interp(verbose, mbio_ptr, time_d, &heave, &roll, &pitch, error);
 					ss->roll = 32768 * roll / 180.0;
 					ss->pitch = 32768 * pitch / 180.0;
 				}
-				if (ss->sonarAltitude == 0 && mb_io_ptr->naltitude > 0) {
+				if (ss->sonarAltitude == 0 && mb_io_ptr->asynch_altitude.nsample > 0) {
 					mb_altint_interp(verbose, mbio_ptr, time_d, &altitude, error);
 					ss->sonarAltitude = 1000 * altitude;
 				}
-				if (ss->sonarDepth == 0 && mb_io_ptr->nsensordepth > 0) {
+				if (ss->sonarDepth == 0 && mb_io_ptr->asynch_sensordepth.nsample > 0) {
 					mb_depint_interp(verbose, mbio_ptr, time_d, &sensordepth, error);
 					ss->sonarDepth = 1000 * sensordepth;
 				}
@@ -1150,25 +1150,25 @@ __FILE__, __LINE__, __FUNCTION__, ftell(mb_io_ptr->mbfp));
 				mb_get_time(verbose, time_i, &time_d);
 
 				/* set navigation and attitude if needed and available */
-				if (sbp->heading == 0 && mb_io_ptr->nheading > 0) {
+				if (sbp->heading == 0 && mb_io_ptr->asynch_heading.nsample > 0) {
 					mb_hedint_interp(verbose, mbio_ptr, time_d, &heading, error);
 					sbp->heading = (short)(100.0 * heading);
 				}
-				if ((sbp->coordX == 0 || sbp->coordY == 0 || sbp->coordUnits == 2) && mb_io_ptr->nfix > 0) {
+				if ((sbp->coordX == 0 || sbp->coordY == 0 || sbp->coordUnits == 2) && mb_io_ptr->asynch_fix.nsample > 0) {
 					mb_navint_interp(verbose, mbio_ptr, time_d, heading, 0.0, &navlon, &navlat, &speed, error);
 					sbp->coordX = (int)(600000.0 * navlon);
 					sbp->coordY = (int)(600000.0 * navlat);
 				}
-				if ((sbp->roll == 0 || sbp->pitch == 0) && mb_io_ptr->nattitude > 0) {
+				if ((sbp->roll == 0 || sbp->pitch == 0) && mb_io_ptr->asynch_attitude.nsample > 0) {
 					mb_attint_interp(verbose, mbio_ptr, time_d, &heave, &roll, &pitch, error);
 					sbp->roll = 32768 * roll / 180.0;
 					sbp->pitch = 32768 * pitch / 180.0;
 				}
-				if (sbp->sonarAltitude == 0 && mb_io_ptr->naltitude > 0) {
+				if (sbp->sonarAltitude == 0 && mb_io_ptr->asynch_altitude.nsample > 0) {
 					mb_altint_interp(verbose, mbio_ptr, time_d, &altitude, error);
 					sbp->sonarAltitude = altitude / 1000.0;
 				}
-				if (sbp->sonarDepth == 0 && mb_io_ptr->nsensordepth > 0) {
+				if (sbp->sonarDepth == 0 && mb_io_ptr->asynch_sensordepth.nsample > 0) {
 					mb_depint_interp(verbose, mbio_ptr, time_d, &sensordepth, error);
 					sbp->sonarDepth = sensordepth / 1000.0;
 				}
@@ -1396,25 +1396,25 @@ __FILE__, __LINE__, __FUNCTION__, ftell(mb_io_ptr->mbfp));
 				mb_get_time(verbose, time_i, &time_d);
 
 				/* set navigation and attitude if needed and available */
-				if (ss->heading == 0 && mb_io_ptr->nheading > 0) {
+				if (ss->heading == 0 && mb_io_ptr->asynch_heading.nsample > 0) {
 					mb_hedint_interp(verbose, mbio_ptr, time_d, &heading, error);
 					ss->heading = (short)(100.0 * heading);
 				}
-				if ((ss->coordX == 0 || ss->coordY == 0 || ss->coordUnits == 2) && mb_io_ptr->nfix > 0) {
+				if ((ss->coordX == 0 || ss->coordY == 0 || ss->coordUnits == 2) && mb_io_ptr->asynch_fix.nsample > 0) {
 					mb_navint_interp(verbose, mbio_ptr, time_d, heading, 0.0, &navlon, &navlat, &speed, error);
 					ss->coordX = (int)(600000.0 * navlon);
 					ss->coordY = (int)(600000.0 * navlat);
 				}
-				if ((ss->roll == 0 || ss->pitch == 0) && mb_io_ptr->nattitude > 0) {
+				if ((ss->roll == 0 || ss->pitch == 0) && mb_io_ptr->asynch_attitude.nsample > 0) {
 					mb_attint_interp(verbose, mbio_ptr, time_d, &heave, &roll, &pitch, error);
 					ss->roll = 32768 * roll / 180.0;
 					ss->pitch = 32768 * pitch / 180.0;
 				}
-				if (ss->sonarAltitude == 0 && mb_io_ptr->naltitude > 0) {
+				if (ss->sonarAltitude == 0 && mb_io_ptr->asynch_altitude.nsample > 0) {
 					mb_altint_interp(verbose, mbio_ptr, time_d, &altitude, error);
 					ss->sonarAltitude = 1000 * altitude;
 				}
-				if (ss->sonarDepth == 0 && mb_io_ptr->nsensordepth > 0) {
+				if (ss->sonarDepth == 0 && mb_io_ptr->asynch_sensordepth.nsample > 0) {
 					mb_depint_interp(verbose, mbio_ptr, time_d, &sensordepth, error);
 					ss->sonarDepth = 1000 * sensordepth;
 				}
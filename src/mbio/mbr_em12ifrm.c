@@ -816,7 +816,12 @@ int mbr_em12ifrm_rd_data(int verbose, void *mbio_ptr, int *error) {
 		mb_get_time(verbose, ptime_i, &ptime_d);
 
 		/* see if nav is needed and potentially available */
-		if (*nav_available && (mb_io_ptr->nfix == 0 || mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1] < ptime_d)) {
+		double fix_time_d = 0.0;
+		double fix_lonlat[2];
+		int fix_error = MB_ERROR_NO_ERROR;
+		if (*nav_available && (mb_asynch_sample(verbose, &mb_io_ptr->asynch_fix, mb_io_ptr->asynch_fix.nsample - 1, &fix_time_d,
+		                                        fix_lonlat, &fix_error) == MB_FAILURE ||
+		                       fix_time_d < ptime_d)) {
 			bool navdone = false;
 			while (!navdone) {
 				if ((result = fgets(line, MBF_EM12IFRM_RECORD_SIZE, mb_io_ptr->mbfp3)) != line) {
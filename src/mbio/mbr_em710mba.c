@@ -4356,7 +4356,6 @@ int mbr_em710mba_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
 
 	/* get pointer to raw data structure */
 	struct mbsys_simrad3_struct *store = (struct mbsys_simrad3_struct *)store_ptr;
-	FILE *mbfp = mb_io_ptr->mbfp;
 
 	/* get saved values */
 	int *databyteswapped = (int *)&mb_io_ptr->save1;
@@ -4926,7 +4925,7 @@ Have a nice day...\n");
 			done = true;
 
 		/* if necessary read over unread but expected bytes */
-		bytes_read = ftell(mbfp) - mb_io_ptr->file_bytes - 4;
+		bytes_read = mb_fileio_tell(verbose, mbio_ptr) - mb_io_ptr->file_bytes - 4;
 		if (!*label_save_flag && !good_end_bytes && bytes_read < record_size) {
 #ifdef MBR_EM710MBA_DEBUG
 			fprintf(stderr, "skip over %d unread bytes of supported datagram type %x\n", record_size - bytes_read, type);
@@ -4939,7 +4938,7 @@ Have a nice day...\n");
 
 #ifdef MBR_EM710MBA_DEBUG
 		fprintf(stderr, "record_size:%d bytes read:%ld file_pos old:%ld new:%ld\n", record_size,
-		        ftell(mbfp) - mb_io_ptr->file_bytes, mb_io_ptr->file_bytes, ftell(mbfp));
+		        mb_fileio_tell(verbose, mbio_ptr) - mb_io_ptr->file_bytes, mb_io_ptr->file_bytes, mb_fileio_tell(verbose, mbio_ptr));
 		fprintf(stderr, "done:%d status:%d error:%d\n", done, status, *error);
 		fprintf(stderr, "end of mbr_em710mba_rd_data loop:\n\n");
 #endif
@@ -4950,9 +4949,9 @@ Have a nice day...\n");
 
 		/* get file position */
 		if (*label_save_flag)
-			mb_io_ptr->file_bytes = ftell(mbfp) - 2;
+			mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr) - 2;
 		else
-			mb_io_ptr->file_bytes = ftell(mbfp);
+			mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr);
 	}
 
 	if (verbose >= 2) {
@@ -4544,7 +4544,7 @@ store->pings[store->ping_index].png_ss_count);
 		/* if necessary read over unread but expected bytes */
         if(mbfp != NULL){
             // reading from file
-            bytes_read = ftell(mbfp) - mb_io_ptr->file_bytes - 4;
+            bytes_read = mb_fileio_tell(verbose, mbio_ptr) - mb_io_ptr->file_bytes - 4;
         }
 //        else if(mbsp != NULL) {
 //            // reading from socket
@@ -4565,7 +4565,7 @@ store->pings[store->ping_index].png_ss_count);
 
 #ifdef MBR_EM710RAW_DEBUG
         if(mbfp != NULL)
-            fprintf(stderr, "record_size:%d bytes read:%ld file_pos old:%ld new:%ld\n", record_size, ftell(mbfp) - mb_io_ptr->file_bytes, mb_io_ptr->file_bytes, ftell(mbfp));
+            fprintf(stderr, "record_size:%d bytes read:%ld file_pos old:%ld new:%ld\n", record_size, mb_fileio_tell(verbose, mbio_ptr) - mb_io_ptr->file_bytes, mb_io_ptr->file_bytes, mb_fileio_tell(verbose, mbio_ptr));
 		fprintf(stderr, "done:%d status:%d error:%d\n", done, status, *error);
 		fprintf(stderr, "end of mbr_em710raw_rd_data loop:\n\n");
 #endif
@@ -4577,11 +4577,11 @@ store->pings[store->ping_index].png_ss_count);
 		/* get file position */
         if (*label_save_flag) {
             if(mbfp != NULL) {
-                mb_io_ptr->file_bytes = ftell(mbfp) - 2;
+                mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr) - 2;
             }
         } else {
             if(mbfp != NULL){
-                mb_io_ptr->file_bytes = ftell(mbfp);
+                mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr);
             }
         }
 	}
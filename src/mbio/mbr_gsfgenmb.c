@@ -46,9 +46,6 @@
 #include "mbf_gsfgenmb.h"
 #include "mbsys_gsf.h"
 
-/* GSF error value */
-extern int gsfError;
-
 /*--------------------------------------------------------------------*/
 int mbr_info_gsfgenmb(int verbose, int *system, int *beams_bath_max, int *beams_amp_max, int *pixels_ss_max, char *format_name,
                       char *system_name, char *format_description, int *numfile, int *filetype, int *variable_beams,
@@ -213,13 +210,10 @@ int mbr_rt_gsfgenmb(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 
 	/* deal with errors */
 	if (ret < 0) {
-#ifndef WIN32
-		if (gsfError == GSF_READ_TO_END_OF_FILE || gsfError == GSF_PARTIAL_RECORD_AT_END_OF_FILE)
-#else
-		/* On Windows the external gsfError set in gsf.c is not visible here */
-		if (ret < 0)
-#endif
-		{
+		/* use the error kept with this file rather than gsfError so that
+		    several threads can read GSF files at once */
+		const int gsf_error = gsfHandleIntError((int)mb_io_ptr->gsfid);
+		if (gsf_error == GSF_READ_TO_END_OF_FILE || gsf_error == GSF_PARTIAL_RECORD_AT_END_OF_FILE) {
 			status = MB_FAILURE;
 			*error = MB_ERROR_EOF;
 		}
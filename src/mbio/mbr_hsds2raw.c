@@ -969,9 +969,13 @@ int mbr_hsds2raw_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
 	}
 
 	/* look for navigation if needed */
+	double fix_time_d = 0.0;
+	double fix_lonlat[2];
+	int fix_error = MB_ERROR_NO_ERROR;
 	if ((XDR *)mb_io_ptr->xdrs2 != NULL &&
-	    ((mb_io_ptr->nfix > 0 && mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1] < store->tt_transmit_time_d) ||
-	     mb_io_ptr->nfix <= 0)) {
+	    (mb_asynch_sample(verbose, &mb_io_ptr->asynch_fix, mb_io_ptr->asynch_fix.nsample - 1, &fix_time_d, fix_lonlat,
+	                      &fix_error) == MB_FAILURE ||
+	     fix_time_d < store->tt_transmit_time_d)) {
 		done = false;
 		while (!done) {
 			/* get system telegram */
@@ -1260,7 +1264,9 @@ int mbr_hsds2raw_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
 			/* add to nav fix list */
 			if (xdr_status) {
 				mb_navint_add(verbose, mbio_ptr, sys_pos_time, (RTD * sys_pos_lon), (RTD * sys_pos_lat), error);
-				if (mb_io_ptr->fix_time_d[mb_io_ptr->nfix - 1] >= store->tt_transmit_time_d)
+				mb_asynch_sample(verbose, &mb_io_ptr->asynch_fix, mb_io_ptr->asynch_fix.nsample - 1, &fix_time_d, fix_lonlat,
+				                 &fix_error);
+				if (fix_time_d >= store->tt_transmit_time_d)
 					done = true;
 			}
 			else
@@ -1269,7 +1275,7 @@ int mbr_hsds2raw_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
 	}
 
 	/* now interpolate navigation if available */
-	if (mb_io_ptr->nfix > 0) {
+	if (mb_io_ptr->asynch_fix.nsample > 0) {
 		mb_navint_interp(verbose, mbio_ptr, store->tt_transmit_time_d, store->start_heading, 0.0, &(store->pr_navlon),
 		                 &(store->pr_navlat), &pspeed, error);
 		store->pr_speed = pspeed / 3.6;
@@ -1107,7 +1107,7 @@ int mbr_rt_hsmdldih(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 	}
 
 	/* interpolate navigation for survey pings if needed */
-	if (status == MB_SUCCESS && data->kind == MB_DATA_DATA && data->lon == 0.0 && data->lat == 0.0 && mb_io_ptr->nfix >= 1) {
+	if (status == MB_SUCCESS && data->kind == MB_DATA_DATA && data->lon == 0.0 && data->lat == 0.0 && mb_io_ptr->asynch_fix.nsample >= 1) {
 		time_i[0] = data->year;
 		time_i[1] = data->month;
 		time_i[2] = data->day;
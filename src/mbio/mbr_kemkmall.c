@@ -37,19 +37,45 @@
 
 #include <assert.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 
 #include "mb_define.h"
 #include "mb_format.h"
 #include "mb_io.h"
 #include "mb_status.h"
+#include "mb_swap.h"
 #include "mbsys_kmbes.h"
 
 /* turn on debug statements here */
 // #define MBR_KEMKMALL_DEBUG 1
 
+/* The datagram index built the first time a file is read is saved in a
+    sidecar file (<file>.kix) and reused while the size and modification
+    time of the kmall file are unchanged. The index entries are stored in
+    host byte order, so a sidecar written on a different architecture
+    simply fails the header check and the file is indexed again. */
+#define MBR_KEMKMALL_INDEX_SUFFIX ".kix"
+#define MBR_KEMKMALL_INDEX_MAGIC 0x58494b4d /* "MKIX" */
+#define MBR_KEMKMALL_INDEX_VERSION 1
+
+struct mbr_kemkmall_index_header_struct {
+  int32_t magic;
+  int32_t version;
+  int32_t entry_size;
+  int32_t watercolumn;
+  int64_t file_size;
+  int64_t file_mtime;
+  int64_t dgm_count;
+};
+
 /*--------------------------------------------------------------------*/
 int mbr_info_kemkmall(int verbose, int *system, int *beams_bath_max, int *beams_amp_max, int *pixels_ss_max, char *format_name,
            char *system_name, char *format_description, int *numfile, int *filetype, int *variable_beams,
@@ -157,6 +183,8 @@ int mbr_alm_kemkmall(int verbose, void *mbio_ptr, int *error) {
   /* prep memory for data datagram index table */
   mb_io_ptr->saveptr1 = NULL;
   mb_io_ptr->save1 = 0;
+  mb_io_ptr->save7 = 0;  // number of leading parameter datagrams in index table
+  mb_io_ptr->save8 = -1; // index table entry to seek to once leading datagrams are read
 
   /* set store variables for asynchronous data sources */
   int *nav_saved = (int *)&mb_io_ptr->save3;
@@ -1847,9 +1875,9 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
   int index = MBSYS_KMBES_HEADER_SIZE;
 
   /* EMdgmMpartition - data partition information */
-  mb_get_binary_short(true, &buffer[index], &(partition.numOfDgms));
+  mb_get_binary_short_inline(true, &buffer[index], &(partition.numOfDgms));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(partition.dgmNum));
+  mb_get_binary_short_inline(true, &buffer[index], &(partition.dgmNum));
   index += 2;
 
   if (verbose >= 5) {
@@ -1859,10 +1887,10 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
   }
 
   /* EMdgmMbody - information of transmitter and receiver used to find data in datagram */
-  mb_get_binary_short(true, &buffer[index], &(cmnPart.numBytesCmnPart));
+  mb_get_binary_short_inline(true, &buffer[index], &(cmnPart.numBytesCmnPart));
   index_EMdgmMbody = index;
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(cmnPart.pingCnt));
+  mb_get_binary_short_inline(true, &buffer[index], &(cmnPart.pingCnt));
   index += 2;
   cmnPart.rxFansPerPing = buffer[index];
   index++;
@@ -1909,13 +1937,13 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
   index = index_pingInfo;
 
   /* EMdgmMRZ_pingInfo - ping info */
-  mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.numBytesInfoData));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.numBytesInfoData));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.padding0));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.padding0));
   index += 2;
 
   /* Ping info */
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.pingRate_Hz));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.pingRate_Hz));
   index += 4;
 
   mrz->pingInfo.beamSpacing = buffer[index];
@@ -1931,76 +1959,76 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
   mrz->pingInfo.pulseForm = buffer[index];
   index++;
 
-  mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.padding1));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.padding1));
   index += 2;
 
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.frequencyMode_Hz));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.frequencyMode_Hz));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.freqRangeLowLim_Hz));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.freqRangeLowLim_Hz));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.freqRangeHighLim_Hz));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.freqRangeHighLim_Hz));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.maxTotalTxPulseLength_sec));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.maxTotalTxPulseLength_sec));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.maxEffTxPulseLength_sec));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.maxEffTxPulseLength_sec));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.maxEffTxBandWidth_Hz));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.maxEffTxBandWidth_Hz));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.absCoeff_dBPerkm));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.absCoeff_dBPerkm));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.portSectorEdge_deg));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.portSectorEdge_deg));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.starbSectorEdge_deg));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.starbSectorEdge_deg));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.portMeanCov_deg));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.portMeanCov_deg));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.starbMeanCov_deg));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.starbMeanCov_deg));
   index += 4;
 
-  mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.portMeanCov_m));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.portMeanCov_m));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.starbMeanCov_m));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.starbMeanCov_m));
   index += 2;
 
   mrz->pingInfo.modeAndStabilisation = buffer[index];
   index++;
   mrz->pingInfo.runtimeFilter1 = buffer[index];
   index++;
-  mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.runtimeFilter2));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.runtimeFilter2));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(mrz->pingInfo.pipeTrackingStatus));
+  mb_get_binary_int_inline(true, &buffer[index], &(mrz->pingInfo.pipeTrackingStatus));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.transmitArraySizeUsed_deg));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.transmitArraySizeUsed_deg));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.receiveArraySizeUsed_deg));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.receiveArraySizeUsed_deg));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.transmitPower_dB));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.transmitPower_dB));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.SLrampUpTimeRemaining));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.SLrampUpTimeRemaining));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.padding2));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.padding2));
   index += 2;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.yawAngle_deg));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.yawAngle_deg));
   index += 4;
 
   /* Info of tx sector data block, EMdgmMRZ_txSectorInfo */
-  mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.numTxSectors));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.numTxSectors));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.numBytesPerTxSector));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.numBytesPerTxSector));
   index += 2;
 
   /* Info at time of midpoint of first tx pulse */
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.headingVessel_deg));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.headingVessel_deg));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.soundSpeedAtTxDepth_mPerSec));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.soundSpeedAtTxDepth_mPerSec));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.txTransducerDepth_m));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.txTransducerDepth_m));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.z_waterLevelReRefPoint_m));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.z_waterLevelReRefPoint_m));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.x_kmallToall_m));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.x_kmallToall_m));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.y_kmallToall_m));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.y_kmallToall_m));
   index += 4;
 
   mrz->pingInfo.latLongInfo = buffer[index];
@@ -2012,21 +2040,21 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
   mrz->pingInfo.padding2 = buffer[index];
   index++;
 
-  mb_get_binary_double(true, &buffer[index], &(mrz->pingInfo.latitude_deg));
+  mb_get_binary_double_inline(true, &buffer[index], &(mrz->pingInfo.latitude_deg));
   index += 8;
-  mb_get_binary_double(true, &buffer[index], &(mrz->pingInfo.longitude_deg));
+  mb_get_binary_double_inline(true, &buffer[index], &(mrz->pingInfo.longitude_deg));
   index += 8;
-  mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.ellipsoidHeightReRefPoint_m));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.ellipsoidHeightReRefPoint_m));
   index += 4;
 
   if (mrz->header.dgmVersion >= 1) {
-    mb_get_binary_float(true, &buffer[index], &(mrz->pingInfo.bsCorrectionOffset_dB));
+    mb_get_binary_float_inline(true, &buffer[index], &(mrz->pingInfo.bsCorrectionOffset_dB));
     index += 4;
     mrz->pingInfo.lambertsLawApplied = buffer[index];
     index++;
     mrz->pingInfo.iceWindow = buffer[index];
     index++;
-    mb_get_binary_short(true, &buffer[index], &(mrz->pingInfo.activeModes));
+    mb_get_binary_short_inline(true, &buffer[index], &(mrz->pingInfo.activeModes));
     index += 2;
   }
 
@@ -2103,33 +2131,33 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
     index++;
     mrz->sectorInfo[i].padding0 = buffer[index];
     index++;
-    mb_get_binary_float(true, &buffer[index], &(mrz->sectorInfo[i].sectorTransmitDelay_sec));
+    mb_get_binary_float_inline(true, &buffer[index], &(mrz->sectorInfo[i].sectorTransmitDelay_sec));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(mrz->sectorInfo[i].tiltAngleReTx_deg));
+    mb_get_binary_float_inline(true, &buffer[index], &(mrz->sectorInfo[i].tiltAngleReTx_deg));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(mrz->sectorInfo[i].txNominalSourceLevel_dB));
+    mb_get_binary_float_inline(true, &buffer[index], &(mrz->sectorInfo[i].txNominalSourceLevel_dB));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(mrz->sectorInfo[i].txFocusRange_m));
+    mb_get_binary_float_inline(true, &buffer[index], &(mrz->sectorInfo[i].txFocusRange_m));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(mrz->sectorInfo[i].centreFreq_Hz));
+    mb_get_binary_float_inline(true, &buffer[index], &(mrz->sectorInfo[i].centreFreq_Hz));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(mrz->sectorInfo[i].signalBandWidth_Hz));
+    mb_get_binary_float_inline(true, &buffer[index], &(mrz->sectorInfo[i].signalBandWidth_Hz));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(mrz->sectorInfo[i].totalSignalLength_sec));
+    mb_get_binary_float_inline(true, &buffer[index], &(mrz->sectorInfo[i].totalSignalLength_sec));
     index += 4;
     mrz->sectorInfo[i].pulseShading = buffer[index];
     index++;
     mrz->sectorInfo[i].signalWaveForm = buffer[index];
     index++;
-    mb_get_binary_short(true, &buffer[index], &(mrz->sectorInfo[i].padding1));
+    mb_get_binary_short_inline(true, &buffer[index], &(mrz->sectorInfo[i].padding1));
     index += 2;
 
     if (mrz->header.dgmVersion >= 1) {
-      mb_get_binary_float(true, &buffer[index], &(mrz->sectorInfo[i].highVoltageLevel_dB));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sectorInfo[i].highVoltageLevel_dB));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sectorInfo[i].sectorTrackingCorr_dB));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sectorInfo[i].sectorTrackingCorr_dB));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sectorInfo[i].effectiveSignalLength_sec));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sectorInfo[i].effectiveSignalLength_sec));
       index += 4;
     }
 
@@ -2162,31 +2190,31 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
   index = index_rxInfo;
 
   /* EMdgmMRZ_rxInfo - receiver specific info */
-  mb_get_binary_short(true, &buffer[index], &(mrz->rxInfo.numBytesRxInfo));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->rxInfo.numBytesRxInfo));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mrz->rxInfo.numSoundingsMaxMain));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->rxInfo.numSoundingsMaxMain));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mrz->rxInfo.numSoundingsValidMain));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->rxInfo.numSoundingsValidMain));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mrz->rxInfo.numBytesPerSounding));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->rxInfo.numBytesPerSounding));
   index += 2;
 
-  mb_get_binary_float(true, &buffer[index], &(mrz->rxInfo.WCSampleRate));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->rxInfo.WCSampleRate));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->rxInfo.seabedImageSampleRate));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->rxInfo.seabedImageSampleRate));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->rxInfo.BSnormal_dB));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->rxInfo.BSnormal_dB));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mrz->rxInfo.BSoblique_dB));
+  mb_get_binary_float_inline(true, &buffer[index], &(mrz->rxInfo.BSoblique_dB));
   index += 4;
 
-  mb_get_binary_short(true, &buffer[index], &(mrz->rxInfo.extraDetectionAlarmFlag));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->rxInfo.extraDetectionAlarmFlag));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mrz->rxInfo.numExtraDetections));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->rxInfo.numExtraDetections));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mrz->rxInfo.numExtraDetectionClasses));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->rxInfo.numExtraDetectionClasses));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mrz->rxInfo.numBytesPerClass));
+  mb_get_binary_short_inline(true, &buffer[index], &(mrz->rxInfo.numBytesPerClass));
   index += 2;
 
   if (verbose >= 5) {
@@ -2227,7 +2255,7 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
         - this avoids breaking the decoding if fields have been added to txSectorInfo */
       index = index_extraDetClassInfo + i * mrz->rxInfo.numBytesPerClass;
 
-      mb_get_binary_short(true, &buffer[index], &(mrz->extraDetClassInfo[i].numExtraDetInClass));
+      mb_get_binary_short_inline(true, &buffer[index], &(mrz->extraDetClassInfo[i].numExtraDetInClass));
       index += 2;
       mrz->extraDetClassInfo[i].padding = buffer[index];
       index++;
@@ -2255,7 +2283,7 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
         - this avoids breaking the decoding if fields have been added to sounding */
       index = index_sounding + i * mrz->rxInfo.numBytesPerSounding;
 
-      mb_get_binary_short(true, &buffer[index], &(mrz->sounding[i].soundingIndex));
+      mb_get_binary_short_inline(true, &buffer[index], &(mrz->sounding[i].soundingIndex));
       index += 2;
       mrz->sounding[i].txSectorNumb = buffer[index];
       index++;
@@ -2278,81 +2306,81 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
       /* These two bytes specified as padding in the Kongsberg specification but are
          here used for the MB-System beam flag - if the first mb_u_char == 1 then the
          second byte is an MB-System beamflag */
-      // mb_get_binary_short(true, &buffer[index], &(mrz->sounding[i].padding));
+      // mb_get_binary_short_inline(true, &buffer[index], &(mrz->sounding[i].padding));
       // index += 2;
       mrz->sounding[i].beamflag_enabled = buffer[index];
       index++;
       mrz->sounding[i].beamflag = buffer[index];
       index++;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].rangeFactor));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].rangeFactor));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].qualityFactor));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].qualityFactor));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].detectionUncertaintyVer_m));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].detectionUncertaintyVer_m));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].detectionUncertaintyHor_m));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].detectionUncertaintyHor_m));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].detectionWindowLength_sec));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].detectionWindowLength_sec));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].echoLength_sec));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].echoLength_sec));
       index += 4;
 
       /* Water column paramters. */
-      mb_get_binary_short(true, &buffer[index], &(mrz->sounding[i].WCBeamNumb));
+      mb_get_binary_short_inline(true, &buffer[index], &(mrz->sounding[i].WCBeamNumb));
       index += 2;
-      mb_get_binary_short(true, &buffer[index], &(mrz->sounding[i].WCrange_samples));
+      mb_get_binary_short_inline(true, &buffer[index], &(mrz->sounding[i].WCrange_samples));
       index += 2;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].WCNomBeamAngleAcross_deg));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].WCNomBeamAngleAcross_deg));
       index += 4;
 
       /* Reflectivity data (backscatter (BS) data). */
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].meanAbsCoeff_dBPerkm));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].meanAbsCoeff_dBPerkm));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].reflectivity1_dB));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].reflectivity1_dB));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].reflectivity2_dB));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].reflectivity2_dB));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].receiverSensitivityApplied_dB));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].receiverSensitivityApplied_dB));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].sourceLevelApplied_dB));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].sourceLevelApplied_dB));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].BScalibration_dB));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].BScalibration_dB));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].TVG_dB));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].TVG_dB));
       index += 4;
 
       /* Range and angle data. */
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].beamAngleReRx_deg));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].beamAngleReRx_deg));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].beamAngleCorrection_deg));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].beamAngleCorrection_deg));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].twoWayTravelTime_sec));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].twoWayTravelTime_sec));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].twoWayTravelTimeCorrection_sec));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].twoWayTravelTimeCorrection_sec));
       index += 4;
 
       /* Georeferenced depth points. */
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].deltaLatitude_deg));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].deltaLatitude_deg));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].deltaLongitude_deg));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].deltaLongitude_deg));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].z_reRefPoint_m));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].z_reRefPoint_m));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].y_reRefPoint_m));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].y_reRefPoint_m));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].x_reRefPoint_m));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].x_reRefPoint_m));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(mrz->sounding[i].beamIncAngleAdj_deg));
+      mb_get_binary_float_inline(true, &buffer[index], &(mrz->sounding[i].beamIncAngleAdj_deg));
       index += 4;
-      mb_get_binary_short(true, &buffer[index], &(mrz->sounding[i].realTimeCleanInfo));
+      mb_get_binary_short_inline(true, &buffer[index], &(mrz->sounding[i].realTimeCleanInfo));
       index += 2;
 
       /* Seabed image. */
-      mb_get_binary_short(true, &buffer[index], &(mrz->sounding[i].SIstartRange_samples));
+      mb_get_binary_short_inline(true, &buffer[index], &(mrz->sounding[i].SIstartRange_samples));
       index += 2;
-      mb_get_binary_short(true, &buffer[index], &(mrz->sounding[i].SIcentreSample));
+      mb_get_binary_short_inline(true, &buffer[index], &(mrz->sounding[i].SIcentreSample));
       index += 2;
-      mb_get_binary_short(true, &buffer[index], &(mrz->sounding[i].SInumSamples));
+      mb_get_binary_short_inline(true, &buffer[index], &(mrz->sounding[i].SInumSamples));
       index += 2;
 
       numSidescanSamples += mrz->sounding[i].SInumSamples;
@@ -2431,11 +2459,8 @@ int mbr_kemkmall_rd_mrz(int verbose, char *buffer, void *store_ptr, void *header
     index_SIsample = index_sounding + numSoundings * mrz->rxInfo.numBytesPerSounding;
     index = index_SIsample;
 
-    for (int i = 0; i < numSidescanSamples; i++)
-    {
-      mb_get_binary_short(true, &buffer[index], &(mrz->SIsample_desidB[i]));
-      index += 2;
-    }
+    mb_get_binary_short_array(true, &buffer[index], numSidescanSamples, mrz->SIsample_desidB);
+    index += 2 * numSidescanSamples;
   }
 
   /* set kind */
@@ -2491,9 +2516,9 @@ int mbr_kemkmall_rd_mwc(int verbose, char *buffer, void *store_ptr, void *header
   int index = MBSYS_KMBES_HEADER_SIZE;
 
   /* EMdgmMpartition - data partition information */
-  mb_get_binary_short(true, &buffer[index], &(partition.numOfDgms));
+  mb_get_binary_short_inline(true, &buffer[index], &(partition.numOfDgms));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(partition.dgmNum));
+  mb_get_binary_short_inline(true, &buffer[index], &(partition.dgmNum));
   index += 2;
 
   if (verbose >= 5) {
@@ -2503,9 +2528,9 @@ int mbr_kemkmall_rd_mwc(int verbose, char *buffer, void *store_ptr, void *header
   }
 
   /* EMdgmMbody - information of transmitter and receiver used to find data in datagram */
-  mb_get_binary_short(true, &buffer[index], &(cmnPart.numBytesCmnPart));
+  mb_get_binary_short_inline(true, &buffer[index], &(cmnPart.numBytesCmnPart));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(cmnPart.pingCnt));
+  mb_get_binary_short_inline(true, &buffer[index], &(cmnPart.pingCnt));
   index += 2;
   cmnPart.rxFansPerPing = buffer[index];
   index++;
@@ -2547,15 +2572,15 @@ int mbr_kemkmall_rd_mwc(int verbose, char *buffer, void *store_ptr, void *header
   mwc->cmnPart = cmnPart;
 
   /* EMdgmMWCtxInfo - transmit sectors, general info for all sectors */
-  mb_get_binary_short(true, &buffer[index], &(mwc->txInfo.numBytesTxInfo));
+  mb_get_binary_short_inline(true, &buffer[index], &(mwc->txInfo.numBytesTxInfo));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mwc->txInfo.numTxSectors));
+  mb_get_binary_short_inline(true, &buffer[index], &(mwc->txInfo.numTxSectors));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mwc->txInfo.numBytesPerTxSector));
+  mb_get_binary_short_inline(true, &buffer[index], &(mwc->txInfo.numBytesPerTxSector));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mwc->txInfo.padding));
+  mb_get_binary_short_inline(true, &buffer[index], &(mwc->txInfo.padding));
   index += 2;
-  mb_get_binary_float(true, &buffer[index], &(mwc->txInfo.heave_m));
+  mb_get_binary_float_inline(true, &buffer[index], &(mwc->txInfo.heave_m));
   index += 4;
 
   if (verbose >= 5) {
@@ -2569,15 +2594,15 @@ int mbr_kemkmall_rd_mwc(int verbose, char *buffer, void *store_ptr, void *header
 
   /* EMdgmMWCtxSectorData - transmit sector data, loop for all i = numTxSectors */
   for (int i=0; i<(mwc->txInfo.numTxSectors); i++) {
-    mb_get_binary_float(true, &buffer[index], &(mwc->sectorData[i].tiltAngleReTx_deg));
+    mb_get_binary_float_inline(true, &buffer[index], &(mwc->sectorData[i].tiltAngleReTx_deg));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(mwc->sectorData[i].centreFreq_Hz));
+    mb_get_binary_float_inline(true, &buffer[index], &(mwc->sectorData[i].centreFreq_Hz));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(mwc->sectorData[i].txBeamWidthAlong_deg));
+    mb_get_binary_float_inline(true, &buffer[index], &(mwc->sectorData[i].txBeamWidthAlong_deg));
     index += 4;
-    mb_get_binary_short(true, &buffer[index], &(mwc->sectorData[i].txSectorNum));
+    mb_get_binary_short_inline(true, &buffer[index], &(mwc->sectorData[i].txSectorNum));
     index += 2;
-    mb_get_binary_short(true, &buffer[index], &(mwc->sectorData[i].padding));
+    mb_get_binary_short_inline(true, &buffer[index], &(mwc->sectorData[i].padding));
     index += 2;
 
     if (verbose >= 5) {
@@ -2592,9 +2617,9 @@ int mbr_kemkmall_rd_mwc(int verbose, char *buffer, void *store_ptr, void *header
   }
 
   /* EMdgmMWCrxInfo - receiver, general info */
-  mb_get_binary_short(true, &buffer[index], &(mwc->rxInfo.numBytesRxInfo));
+  mb_get_binary_short_inline(true, &buffer[index], &(mwc->rxInfo.numBytesRxInfo));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(mwc->rxInfo.numBeams));
+  mb_get_binary_short_inline(true, &buffer[index], &(mwc->rxInfo.numBeams));
   index += 2;
   mwc->rxInfo.numBytesPerBeamEntry = buffer[index];
   index ++;
@@ -2604,9 +2629,9 @@ int mbr_kemkmall_rd_mwc(int verbose, char *buffer, void *store_ptr, void *header
   index ++;
   mwc->rxInfo.TVGoffset_dB = buffer[index];
   index ++;
-  mb_get_binary_float(true, &buffer[index], &(mwc->rxInfo.sampleFreq_Hz));
+  mb_get_binary_float_inline(true, &buffer[index], &(mwc->rxInfo.sampleFreq_Hz));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(mwc->rxInfo.soundVelocity_mPerSec));
+  mb_get_binary_float_inline(true, &buffer[index], &(mwc->rxInfo.soundVelocity_mPerSec));
   index += 4;
 
   if (verbose >= 5) {
@@ -2637,18 +2662,18 @@ int mbr_kemkmall_rd_mwc(int verbose, char *buffer, void *store_ptr, void *header
 
   if (status == MB_SUCCESS) {
     for (int i=0; i<(mwc->rxInfo.numBeams) && status == MB_SUCCESS; i++) {
-      mb_get_binary_float(true, &buffer[index], &(mwc->beamData_p[i].beamPointAngReVertical_deg));
+      mb_get_binary_float_inline(true, &buffer[index], &(mwc->beamData_p[i].beamPointAngReVertical_deg));
       index += 4;
-      mb_get_binary_short(true, &buffer[index], &(mwc->beamData_p[i].startRangeSampleNum));
+      mb_get_binary_short_inline(true, &buffer[index], &(mwc->beamData_p[i].startRangeSampleNum));
       index += 2;
-      mb_get_binary_short(true, &buffer[index], &(mwc->beamData_p[i].detectedRangeInSamples));
+      mb_get_binary_short_inline(true, &buffer[index], &(mwc->beamData_p[i].detectedRangeInSamples));
       index += 2;
-      mb_get_binary_short(true, &buffer[index], &(mwc->beamData_p[i].beamTxSectorNum));
+      mb_get_binary_short_inline(true, &buffer[index], &(mwc->beamData_p[i].beamTxSectorNum));
       index += 2;
-      mb_get_binary_short(true, &buffer[index], &(mwc->beamData_p[i].numSampleData));
+      mb_get_binary_short_inline(true, &buffer[index], &(mwc->beamData_p[i].numSampleData));
       index += 2;
       if (mwc->header.dgmVersion >= 1) {
-        mb_get_binary_float(true, &buffer[index], &(mwc->beamData_p[i].detectedRangeInSamplesHighResolution));
+        mb_get_binary_float_inline(true, &buffer[index], &(mwc->beamData_p[i].detectedRangeInSamplesHighResolution));
         index += 4;
       } else {
         mwc->beamData_p[i].detectedRangeInSamplesHighResolution = mwc->beamData_p[i].detectedRangeInSamples;
@@ -2711,10 +2736,9 @@ int mbr_kemkmall_rd_mwc(int verbose, char *buffer, void *store_ptr, void *header
                 mwc->beamData_p[i].samplePhase16bit_alloc_size = 0;
             }
             if (status == MB_SUCCESS) {
-              for (int k = 0; k<mwc->beamData_p[i].numSampleData; k++) {
-                mb_get_binary_short(true, &buffer[index], &(mwc->beamData_p[i].samplePhase16bit[k]));
-                index += 2;
-              }
+              mb_get_binary_short_array(true, &buffer[index], mwc->beamData_p[i].numSampleData,
+                                        mwc->beamData_p[i].samplePhase16bit);
+              index += 2 * mwc->beamData_p[i].numSampleData;
             }
             break;
         }
@@ -3692,9 +3716,9 @@ int mbr_kemkmall_rd_xmt(int verbose, char *buffer, void *store_ptr, void *header
   int index = MBSYS_KMBES_HEADER_SIZE;
 
   /* EMdgmMpartition - data partition information */
-  mb_get_binary_short(true, &buffer[index], &(partition.numOfDgms));
+  mb_get_binary_short_inline(true, &buffer[index], &(partition.numOfDgms));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(partition.dgmNum));
+  mb_get_binary_short_inline(true, &buffer[index], &(partition.dgmNum));
   index += 2;
 
   if (verbose >= 5) {
@@ -3704,10 +3728,10 @@ int mbr_kemkmall_rd_xmt(int verbose, char *buffer, void *store_ptr, void *header
   }
 
   /* EMdgmMbody - information of transmitter and receiver used to find data in datagram */
-  mb_get_binary_short(true, &buffer[index], &(cmnPart.numBytesCmnPart));
+  mb_get_binary_short_inline(true, &buffer[index], &(cmnPart.numBytesCmnPart));
   index_EMdgmMbody = index;
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(cmnPart.pingCnt));
+  mb_get_binary_short_inline(true, &buffer[index], &(cmnPart.pingCnt));
   index += 2;
   cmnPart.rxFansPerPing = buffer[index];
   index++;
@@ -3754,29 +3778,29 @@ int mbr_kemkmall_rd_xmt(int verbose, char *buffer, void *store_ptr, void *header
   index = index_pingInfo;
 
   /* mbsys_kmbes_xmt_ping_info - ping info */
-  mb_get_binary_short(true, &buffer[index], &(xmt->xmtPingInfo.numBytesInfoData));
+  mb_get_binary_short_inline(true, &buffer[index], &(xmt->xmtPingInfo.numBytesInfoData));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(xmt->xmtPingInfo.numBytesPerSounding));
+  mb_get_binary_short_inline(true, &buffer[index], &(xmt->xmtPingInfo.numBytesPerSounding));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(xmt->xmtPingInfo.padding0));
+  mb_get_binary_int_inline(true, &buffer[index], &(xmt->xmtPingInfo.padding0));
   index += 4;
-  mb_get_binary_double(true, &buffer[index], &(xmt->xmtPingInfo.longitude));
+  mb_get_binary_double_inline(true, &buffer[index], &(xmt->xmtPingInfo.longitude));
   index += 8;
-  mb_get_binary_double(true, &buffer[index], &(xmt->xmtPingInfo.latitude));
+  mb_get_binary_double_inline(true, &buffer[index], &(xmt->xmtPingInfo.latitude));
   index += 8;
-  mb_get_binary_double(true, &buffer[index], &(xmt->xmtPingInfo.sensordepth));
+  mb_get_binary_double_inline(true, &buffer[index], &(xmt->xmtPingInfo.sensordepth));
   index += 8;
-  mb_get_binary_double(true, &buffer[index], &(xmt->xmtPingInfo.heading));
+  mb_get_binary_double_inline(true, &buffer[index], &(xmt->xmtPingInfo.heading));
   index += 8;
-  mb_get_binary_float(true, &buffer[index], &(xmt->xmtPingInfo.speed));
+  mb_get_binary_float_inline(true, &buffer[index], &(xmt->xmtPingInfo.speed));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(xmt->xmtPingInfo.roll));
+  mb_get_binary_float_inline(true, &buffer[index], &(xmt->xmtPingInfo.roll));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(xmt->xmtPingInfo.pitch));
+  mb_get_binary_float_inline(true, &buffer[index], &(xmt->xmtPingInfo.pitch));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(xmt->xmtPingInfo.heave));
+  mb_get_binary_float_inline(true, &buffer[index], &(xmt->xmtPingInfo.heave));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(xmt->xmtPingInfo.numSoundings));
+  mb_get_binary_float_inline(true, &buffer[index], &(xmt->xmtPingInfo.numSoundings));
   index += 4;
 
   if (verbose >= 5) {
@@ -3806,19 +3830,19 @@ int mbr_kemkmall_rd_xmt(int verbose, char *buffer, void *store_ptr, void *header
        - this avoids breaking the decoding if fields have been added to sounding */
     index = index_sounding + i * xmt->xmtPingInfo.numBytesPerSounding;
 
-    mb_get_binary_short(true, &buffer[index], &(xmt->xmtSounding[i].soundingIndex));
+    mb_get_binary_short_inline(true, &buffer[index], &(xmt->xmtSounding[i].soundingIndex));
     index += 2;
-    mb_get_binary_short(true, &buffer[index], &(xmt->xmtSounding[i].padding0));
+    mb_get_binary_short_inline(true, &buffer[index], &(xmt->xmtSounding[i].padding0));
     index += 2;
-    mb_get_binary_float(true, &buffer[index], &(xmt->xmtSounding[i].twtt));
+    mb_get_binary_float_inline(true, &buffer[index], &(xmt->xmtSounding[i].twtt));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(xmt->xmtSounding[i].angle_vertical));
+    mb_get_binary_float_inline(true, &buffer[index], &(xmt->xmtSounding[i].angle_vertical));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(xmt->xmtSounding[i].angle_azimuthal));
+    mb_get_binary_float_inline(true, &buffer[index], &(xmt->xmtSounding[i].angle_azimuthal));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(xmt->xmtSounding[i].beam_heave));
+    mb_get_binary_float_inline(true, &buffer[index], &(xmt->xmtSounding[i].beam_heave));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(xmt->xmtSounding[i].alongtrack_offset));
+    mb_get_binary_float_inline(true, &buffer[index], &(xmt->xmtSounding[i].alongtrack_offset));
     index += 4;
 
     if (verbose >= 5) {
@@ -3897,14 +3921,10 @@ int mbr_kemkmall_rd_xms(int verbose, char *buffer, void *store_ptr, void *header
     xms->unused[i] = buffer[index];
     index++;
   }
-  for (int i=0;i<xms->pixels_ss;i++) {
-    mb_get_binary_float(true, &buffer[index], &xms->ss[i]);
-    index += 4;
-  }
-  for (int i=0;i<xms->pixels_ss;i++) {
-    mb_get_binary_float(true, &buffer[index], &xms->ss_alongtrack[i]);
-    index += 4;
-  }
+  mb_get_binary_float_array(true, &buffer[index], xms->pixels_ss, xms->ss);
+  index += 4 * xms->pixels_ss;
+  mb_get_binary_float_array(true, &buffer[index], xms->pixels_ss, xms->ss_alongtrack);
+  index += 4 * xms->pixels_ss;
 
   if (verbose >= 5) {
     fprintf(stderr, "\ndbg5  Values read in MBIO function <%s>\n", __func__);
@@ -3994,6 +4014,163 @@ int mbr_kemkmall_rd_unknown(int verbose, char *buffer, void *store_ptr, void *he
 };
 /*--------------------------------------------------------------------*/
 
+/*
+ * mbr_kemkmall_index_leading returns the number of datagrams at the start of
+ * the sorted index (comments and installation, runtime, sound velocity,
+ * calibration and MB-System parameters) that precede the time ordered data
+ */
+static int mbr_kemkmall_index_leading(const struct mbsys_kmbes_index_table *dgm_index_table) {
+  int nleading = 0;
+  while ((size_t)nleading < dgm_index_table->dgm_count) {
+    const mbsys_kmbes_emdgm_type emdgm_type = dgm_index_table->indextable[nleading].emdgm_type;
+    if (emdgm_type != XMC && emdgm_type != IIP && emdgm_type != IOP && emdgm_type != SVP && emdgm_type != FCF &&
+        emdgm_type != XMB)
+      break;
+    nleading++;
+  }
+  return (nleading);
+}
+/*--------------------------------------------------------------------*/
+/*
+ * mbr_kemkmall_index_load reads the datagram index from the sidecar file,
+ * failing if the sidecar is missing, invalid or older than the data file
+ */
+int mbr_kemkmall_index_load(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+    fprintf(stderr, "dbg2       store_ptr:  %p\n", (void *)store_ptr);
+  }
+
+  struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+  struct mbsys_kmbes_struct *store = (struct mbsys_kmbes_struct *)store_ptr;
+  struct mbsys_kmbes_index_table *dgm_index_table = (struct mbsys_kmbes_index_table *)mb_io_ptr->saveptr1;
+
+  int status = MB_FAILURE;
+  *error = MB_ERROR_OPEN_FAIL;
+
+  struct stat file_status;
+  char index_file[MB_PATH_MAXLINE + sizeof(MBR_KEMKMALL_INDEX_SUFFIX)];
+  snprintf(index_file, sizeof(index_file), "%s%s", mb_io_ptr->file, MBR_KEMKMALL_INDEX_SUFFIX);
+  FILE *fp = NULL;
+  if (stat(mb_io_ptr->file, &file_status) == 0 && (fp = fopen(index_file, "rb")) != NULL) {
+    struct mbr_kemkmall_index_header_struct header;
+    if (fread(&header, sizeof(header), 1, fp) == 1 && header.magic == MBR_KEMKMALL_INDEX_MAGIC &&
+        header.version == MBR_KEMKMALL_INDEX_VERSION && header.entry_size == (int32_t)sizeof(struct mbsys_kmbes_index) &&
+        header.file_size == (int64_t)file_status.st_size && header.file_mtime == (int64_t)file_status.st_mtime &&
+        header.dgm_count > 0) {
+      const size_t dgm_count = (size_t)header.dgm_count;
+      status = MB_SUCCESS;
+      if (dgm_index_table->num_alloc < dgm_count) {
+        status = mb_reallocd(verbose, __FILE__, __LINE__, dgm_count * sizeof(struct mbsys_kmbes_index),
+                             (void **)(&dgm_index_table->indextable), error);
+        dgm_index_table->num_alloc = status == MB_SUCCESS ? dgm_count : 0;
+      }
+      if (status == MB_SUCCESS &&
+          fread(dgm_index_table->indextable, sizeof(struct mbsys_kmbes_index), dgm_count, fp) == dgm_count) {
+        dgm_index_table->dgm_count = dgm_count;
+        if (header.watercolumn)
+          store->xmb.watercolumn = 1;
+        *error = MB_ERROR_NO_ERROR;
+      }
+      else {
+        dgm_index_table->dgm_count = 0;
+        status = MB_FAILURE;
+        *error = MB_ERROR_EOF;
+      }
+    }
+    fclose(fp);
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       dgm_count:  %zu\n", dgm_index_table->dgm_count);
+    fprintf(stderr, "dbg2       error:      %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:  %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+/*
+ * mbr_kemkmall_index_save writes the datagram index to the sidecar file -
+ * failure to write the sidecar is not an error
+ */
+int mbr_kemkmall_index_save(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+    fprintf(stderr, "dbg2       store_ptr:  %p\n", (void *)store_ptr);
+  }
+
+  struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+  struct mbsys_kmbes_struct *store = (struct mbsys_kmbes_struct *)store_ptr;
+  struct mbsys_kmbes_index_table *dgm_index_table = (struct mbsys_kmbes_index_table *)mb_io_ptr->saveptr1;
+
+  /* only save the index of a file that is not being written - a file
+      modified within the last second could still be growing */
+  struct stat file_status;
+  if (dgm_index_table->dgm_count > 0 && stat(mb_io_ptr->file, &file_status) == 0 &&
+      file_status.st_mtime + 1 < time(NULL)) {
+#ifndef _WIN32
+    /* write to a uniquely named temporary file and rename it into place so
+        that readers never see a partially written index, even when several
+        processes or threads save the same index at once */
+    char index_file[MB_PATH_MAXLINE + sizeof(MBR_KEMKMALL_INDEX_SUFFIX)];
+    char index_file_tmp[sizeof(index_file) + sizeof(".XXXXXX")];
+    snprintf(index_file, sizeof(index_file), "%s%s", mb_io_ptr->file, MBR_KEMKMALL_INDEX_SUFFIX);
+    snprintf(index_file_tmp, sizeof(index_file_tmp), "%s.XXXXXX", index_file);
+    const int fd = mkstemp(index_file_tmp);
+    FILE *fp = NULL;
+    if (fd >= 0) {
+      fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+      if ((fp = fdopen(fd, "wb")) == NULL) {
+        close(fd);
+        remove(index_file_tmp);
+      }
+    }
+    if (fp != NULL) {
+      struct mbr_kemkmall_index_header_struct header;
+      memset(&header, 0, sizeof(header));
+      header.magic = MBR_KEMKMALL_INDEX_MAGIC;
+      header.version = MBR_KEMKMALL_INDEX_VERSION;
+      header.entry_size = (int32_t)sizeof(struct mbsys_kmbes_index);
+      header.watercolumn = store->xmb.watercolumn ? 1 : 0;
+      header.file_size = (int64_t)file_status.st_size;
+      header.file_mtime = (int64_t)file_status.st_mtime;
+      header.dgm_count = (int64_t)dgm_index_table->dgm_count;
+      bool ok = fwrite(&header, sizeof(header), 1, fp) == 1 &&
+                fwrite(dgm_index_table->indextable, sizeof(struct mbsys_kmbes_index), dgm_index_table->dgm_count, fp) ==
+                    dgm_index_table->dgm_count;
+      if (fclose(fp) != 0)
+        ok = false;
+      if (!ok || rename(index_file_tmp, index_file) != 0)
+        remove(index_file_tmp);
+    }
+#endif
+  }
+
+  const int status = MB_SUCCESS;
+  *error = MB_ERROR_NO_ERROR;
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:      %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:  %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+
 int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
   struct mbsys_kmbes_index_table *dgm_index_table = NULL;
   struct mbsys_kmbes_index dgm_index;
@@ -4025,7 +4202,8 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
   assert(store_ptr != NULL);
 
   /* create a datagram index table in mbio descriptor */
-  mbr_kemkmall_create_dgm_index_table(verbose, mbio_ptr, store_ptr, error);
+  if (((struct mb_io_struct *)mbio_ptr)->saveptr1 == NULL)
+    mbr_kemkmall_create_dgm_index_table(verbose, mbio_ptr, store_ptr, error);
 
   /* get pointer to mbio descriptor */
   struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
@@ -4042,8 +4220,8 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
   *file_indexed = false;
 
   /* set file position to the start */
-  fseek(mb_io_ptr->mbfp, 0, SEEK_SET);
-  mb_io_ptr->file_pos = ftell(mb_io_ptr->mbfp);
+  mb_fileio_seek(verbose, mbio_ptr, 0, SEEK_SET, error);
+  mb_io_ptr->file_pos = mb_fileio_tell(verbose, mbio_ptr);
 
   /* set status */
   int status = MB_SUCCESS;
@@ -4082,7 +4260,7 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
               "and make a data sample available. \n"
               "Have a nice day...\n");
       fprintf(stderr, "MBF_KEMKMALL skipped %d bytes before record %.4s at file pos %ld\n",
-                      skip, header.dgmType, ftell(mb_io_ptr->mbfp));
+                      skip, header.dgmType, mb_fileio_tell(verbose, mbio_ptr));
     }
 
     /* now parse the header and index the datagram */
@@ -4090,9 +4268,9 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
 
       /* verify datagram is intact - seek to end of the datagram and read last int
          - make survey mb_io_ptr->file_pos records the position of the start of the datagram */
-      mb_io_ptr->file_pos = ftell(mb_io_ptr->mbfp) - MBSYS_KMBES_HEADER_SIZE;
+      mb_io_ptr->file_pos = mb_fileio_tell(verbose, mbio_ptr) - MBSYS_KMBES_HEADER_SIZE;
       offset = (header.numBytesDgm - MBSYS_KMBES_HEADER_SIZE - sizeof(int));
-      fseek(mb_io_ptr->mbfp, offset, SEEK_CUR);
+      mb_fileio_seek(verbose, mbio_ptr, offset, SEEK_CUR, error);
 
       read_len = sizeof(int);
       status = mb_fileio_get(verbose, mbio_ptr, (void *)&buffer[0], &read_len, error);
@@ -4111,7 +4289,7 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
                 header.dgmType, mb_io_ptr->file_pos, header.numBytesDgm, num_bytes_dgm_end);
 #endif
           mb_io_ptr->file_pos += HEADER_SKIP;
-          fseek(mb_io_ptr->mbfp, mb_io_ptr->file_pos, SEEK_SET);
+          mb_fileio_seek(verbose, mbio_ptr, mb_io_ptr->file_pos, SEEK_SET, error);
           emdgm_type = UNKNOWN;
           // valid_id = false;
         }
@@ -4138,7 +4316,7 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
             /* get ping info */
             /* skip past the header and the 2 shorts that make up the dgm partition part */
             offset = (mb_io_ptr->file_pos + MBSYS_KMBES_HEADER_SIZE + sizeof(int));
-            fseek(mb_io_ptr->mbfp, offset, SEEK_SET);
+            mb_fileio_seek(verbose, mbio_ptr, offset, SEEK_SET, error);
 
             read_len = 12;
             status = mb_fileio_get(verbose, mbio_ptr, (void *)&buffer[0], &read_len, error);
@@ -4193,7 +4371,7 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
 
             if (status == MB_SUCCESS) {
               offset = (size_t) (mb_io_ptr->file_pos + header.numBytesDgm);
-              fseek(mb_io_ptr->mbfp, offset, SEEK_SET);
+              mb_fileio_seek(verbose, mbio_ptr, offset, SEEK_SET, error);
             }
             // TODO: what happens if alloc fails - while condition?
             break;
@@ -4206,7 +4384,7 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
             /* get ping info */
             /* skip past the header and the 2 shorts that make up the dgm partition part */
             offset = (mb_io_ptr->file_pos + MBSYS_KMBES_HEADER_SIZE + sizeof(int));
-            fseek(mb_io_ptr->mbfp, offset, SEEK_SET);
+            mb_fileio_seek(verbose, mbio_ptr, offset, SEEK_SET, error);
 
             read_len = 12;
             status = mb_fileio_get(verbose, mbio_ptr, (void *)&buffer[0], &read_len, error);
@@ -4261,7 +4439,7 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
 
             if (status == MB_SUCCESS) {
               offset = (size_t) (mb_io_ptr->file_pos + header.numBytesDgm);
-              fseek(mb_io_ptr->mbfp, offset, SEEK_SET);
+              mb_fileio_seek(verbose, mbio_ptr, offset, SEEK_SET, error);
             }
             // TODO: what happens if alloc fails - while condition?
             break;
@@ -4274,7 +4452,7 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
             /* get ping info */
             /* skip past the header and the 2 shorts that make up the dgm partition part */
             offset = (mb_io_ptr->file_pos + MBSYS_KMBES_HEADER_SIZE + sizeof(int));
-            fseek(mb_io_ptr->mbfp, offset, SEEK_SET);
+            mb_fileio_seek(verbose, mbio_ptr, offset, SEEK_SET, error);
 
             read_len = 12;
             status = mb_fileio_get(verbose, mbio_ptr, (void *)&buffer[0], &read_len, error);
@@ -4310,7 +4488,7 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
 
             if (status == MB_SUCCESS) {
               offset = (size_t) (mb_io_ptr->file_pos + header.numBytesDgm);
-              fseek(mb_io_ptr->mbfp, offset, SEEK_SET);
+              mb_fileio_seek(verbose, mbio_ptr, offset, SEEK_SET, error);
             }
             // TODO: what happens if alloc fails - while condition?
             break;
@@ -4344,13 +4522,13 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
 
             if (status == MB_SUCCESS) {
               offset = (size_t) (mb_io_ptr->file_pos + header.numBytesDgm);
-              fseek(mb_io_ptr->mbfp, offset, SEEK_SET);
+              mb_fileio_seek(verbose, mbio_ptr, offset, SEEK_SET, error);
             }
             break;
         }
 
         /* update file position */
-        mb_io_ptr->file_pos = ftell(mb_io_ptr->mbfp);
+        mb_io_ptr->file_pos = mb_fileio_tell(verbose, mbio_ptr);
       }
     }
   }
@@ -4422,8 +4600,14 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
   fprintf(stderr, "\n");
 #endif
 
+  /* save the index for the next time the file is read */
+  if (status == MB_SUCCESS && dgm_index_table->dgm_count > 0) {
+    int save_error = MB_ERROR_NO_ERROR;
+    mbr_kemkmall_index_save(verbose, mbio_ptr, store_ptr, &save_error);
+  }
+
   /* set file position back to the start */
-  fseek(mb_io_ptr->mbfp, 0, SEEK_SET);
+  mb_fileio_seek(verbose, mbio_ptr, 0, SEEK_SET, error);
 
     if (verbose >= 2) {
         fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
@@ -4439,6 +4623,108 @@ int mbr_kemkmall_index_data(int verbose, void *mbio_ptr, void *store_ptr, int *e
 };
 /*--------------------------------------------------------------------*/
 
+/*
+ * mbr_kemkmall_index_file indexes the datagrams of the file being read,
+ * using the index saved in the sidecar file if it is current
+ */
+int mbr_kemkmall_index_file(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+    fprintf(stderr, "dbg2       store_ptr:  %p\n", (void *)store_ptr);
+  }
+
+  struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+  int *file_indexed = (int *)&mb_io_ptr->save2;
+  int *nleading = (int *)&mb_io_ptr->save7;
+
+  int status = MB_SUCCESS;
+  if (mb_io_ptr->saveptr1 == NULL)
+    status = mbr_kemkmall_create_dgm_index_table(verbose, mbio_ptr, store_ptr, error);
+  if (status == MB_SUCCESS && mbr_kemkmall_index_load(verbose, mbio_ptr, store_ptr, error) == MB_SUCCESS) {
+    mb_io_ptr->save1 = 0;
+    *file_indexed = true;
+  }
+  else if (status == MB_SUCCESS) {
+    status = mbr_kemkmall_index_data(verbose, mbio_ptr, store_ptr, error);
+  }
+  if (mb_io_ptr->saveptr1 != NULL)
+    *nleading = mbr_kemkmall_index_leading((struct mbsys_kmbes_index_table *)mb_io_ptr->saveptr1);
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       nleading:   %d\n", *nleading);
+    fprintf(stderr, "dbg2       error:      %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:  %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+/*
+ * mbr_kemkmall_seek_time positions the reader at the first ping or other
+ * time ordered datagram at or after time_d using the datagram index. Any
+ * leading parameter datagrams not yet read are still returned first.
+ */
+int mbr_kemkmall_seek_time(int verbose, void *mbio_ptr, double time_d, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       mbio_ptr:   %p\n", (void *)mbio_ptr);
+    fprintf(stderr, "dbg2       time_d:     %f\n", time_d);
+  }
+
+  struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+  int *file_indexed = (int *)&mb_io_ptr->save2;
+  int *nleading = (int *)&mb_io_ptr->save7;
+  int *seek_id = (int *)&mb_io_ptr->save8;
+
+  int status = MB_SUCCESS;
+  *error = MB_ERROR_NO_ERROR;
+
+  /* only files can be indexed */
+  if (mb_io_ptr->mbfp == NULL) {
+    status = MB_FAILURE;
+    *error = MB_ERROR_BAD_USAGE;
+  }
+  else if (!*file_indexed) {
+    status = mbr_kemkmall_index_file(verbose, mbio_ptr, mb_io_ptr->store_data, error);
+  }
+
+  /* bisect the time ordered part of the index - the datagrams of a ping
+      share the time stamp of the ping so this finds the start of a ping */
+  if (status == MB_SUCCESS) {
+    const struct mbsys_kmbes_index_table *dgm_index_table = (struct mbsys_kmbes_index_table *)mb_io_ptr->saveptr1;
+    size_t ilo = (size_t)*nleading;
+    size_t ihi = dgm_index_table->dgm_count;
+    while (ilo < ihi) {
+      const size_t imid = (ilo + ihi) / 2;
+      if (dgm_index_table->indextable[imid].time_d < time_d)
+        ilo = imid + 1;
+      else
+        ihi = imid;
+    }
+    *seek_id = (int)ilo;
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       seek_id:    %d\n", *seek_id);
+    fprintf(stderr, "dbg2       error:      %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:  %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+
 int mbr_kemkmall_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
@@ -4479,10 +4765,21 @@ int mbr_kemkmall_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
   int status = MB_SUCCESS;
   *error = MB_ERROR_NO_ERROR;
 
-  /* check index to see if more datagrams can be read */
+  /* apply any pending seek once the leading parameter datagrams have been read */
+  int *nleading = (int *)&mb_io_ptr->save7;
+  int *seek_id = (int *)&mb_io_ptr->save8;
+  if (mb_io_ptr->mbfp != NULL && *seek_id >= 0 && *dgm_id >= (unsigned int)*nleading) {
+    *dgm_id = (unsigned int)*seek_id;
+    *seek_id = -1;
+  }
+
+  /* check index to see if more datagrams can be read - datagrams well
+      after the end of the time window need not be read */
   bool done = false;
   if (mb_io_ptr->mbfp != NULL) {
-    if (*dgm_id < dgm_index_table->dgm_count) {
+    if (*dgm_id < dgm_index_table->dgm_count
+        && !(mb_io_ptr->etime_d > mb_io_ptr->btime_d && *dgm_id >= (unsigned int)*nleading
+             && dgm_index_table->indextable[*dgm_id].time_d > mb_io_ptr->etime_d + MB_SEEK_TIME_MARGIN)) {
       done = false;
     }
     else {
@@ -4517,11 +4814,12 @@ int mbr_kemkmall_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
         }
       }
 
-      /* read the next datagram */
+      /* read the next datagram - if the file is memory mapped then buffer
+         points directly into the mapped file and no bytes are copied */
       if (status == MB_SUCCESS) {
-        fseek(mb_io_ptr->mbfp, dgm_index->file_pos, SEEK_SET);
-        status = mb_fileio_get(verbose, mbio_ptr, (void *)&buffer[0], &read_len, error);
-        mb_io_ptr->file_pos = ftell(mb_io_ptr->mbfp);
+        mb_fileio_seek(verbose, mbio_ptr, dgm_index->file_pos, SEEK_SET, error);
+        status = mb_fileio_get_slice(verbose, mbio_ptr, (char *)*bufferptr, &buffer, &read_len, error);
+        mb_io_ptr->file_pos = mb_fileio_tell(verbose, mbio_ptr);
       }
 
       // check for partitioned datagrams (i.e. multiple UDP packets that have
@@ -4885,7 +5183,10 @@ numOfDgms, dgmNum, header.numBytesDgm, dgm_index->index_org, dgm_index->ping_num
       (*dgm_id)++;
 
     /* if not done but no more data in index then done with error */
-    if (!done && mb_io_ptr->mbfp != NULL && *dgm_id >= dgm_index_table->dgm_count) {
+    if (!done && mb_io_ptr->mbfp != NULL
+        && (*dgm_id >= dgm_index_table->dgm_count
+            || (mb_io_ptr->etime_d > mb_io_ptr->btime_d && *dgm_id >= (unsigned int)*nleading
+                && dgm_index_table->indextable[*dgm_id].time_d > mb_io_ptr->etime_d + MB_SEEK_TIME_MARGIN))) {
       done = true;
       *error = MB_ERROR_EOF;
       status = MB_FAILURE;
@@ -4895,7 +5196,7 @@ numOfDgms, dgmNum, header.numBytesDgm, dgm_index->index_org, dgm_index->ping_num
 
   /* get file position */
   if (mb_io_ptr->mbfp != NULL)
-    mb_io_ptr->file_bytes = ftell(mb_io_ptr->mbfp);
+    mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr);
 
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
@@ -4935,7 +5236,7 @@ int mbr_rt_kemkmall(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 #ifdef MBR_KEMKMALL_DEBUG
   fprintf(stderr, "About to call mbr_kemkmall_index_data...\n");
 #endif
-    status = mbr_kemkmall_index_data(verbose, mbio_ptr, store_ptr, error);
+    status = mbr_kemkmall_index_file(verbose, mbio_ptr, store_ptr, error);
   }
 
 #ifdef MBR_KEMKMALL_DEBUG
@@ -4956,7 +5257,7 @@ int mbr_rt_kemkmall(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       if (*nav_saved == MB_DATA_NONE || *nav_saved == MB_DATA_NAV || *nav_saved == MB_DATA_NAV2) {
         spo_time_d = spo->sensorData.timeFromSensor_sec + 0.000000001 * spo->sensorData.timeFromSensor_nanosec;
         if (*nav_saved != MB_DATA_NAV) {
-          mb_io_ptr->nfix = 0;
+          mb_asynch_reset(verbose, &mb_io_ptr->asynch_fix, error);
           *nav_saved = MB_DATA_NAV;
         }
         mb_navint_add(verbose, mbio_ptr, spo_time_d, spo->sensorData.correctedLong_deg,
@@ -4972,7 +5273,7 @@ int mbr_rt_kemkmall(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
           skm_time_d = skm->sample[i].KMdefault.time_sec + 0.000000001 * skm->sample[i].KMdefault.time_nanosec;
           if (!(skm->sample[i].KMdefault.status & 0x00000001)) {
             if (*nav_saved != MB_DATA_NAV1) {
-              mb_io_ptr->nfix = 0;
+              mb_asynch_reset(verbose, &mb_io_ptr->asynch_fix, error);
               *nav_saved = MB_DATA_NAV1;
             }
             mb_navint_add(verbose, mbio_ptr, skm_time_d, skm->sample[i].KMdefault.longitude_deg,
@@ -4990,7 +5291,7 @@ int mbr_rt_kemkmall(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
           }
           if (!(skm->sample[i].KMdefault.status & 0x00000002)) {
             if (*attitude_saved != MB_DATA_NAV1) {
-              mb_io_ptr->nattitude = 0;
+              mb_asynch_reset(verbose, &mb_io_ptr->asynch_attitude, error);
               *attitude_saved = MB_DATA_NAV1;
             }
 			      mb_attint_add(verbose, mbio_ptr, skm_time_d, skm_heave,
@@ -5004,7 +5305,7 @@ int mbr_rt_kemkmall(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
           skm_time_d = skm->sample[i].KMdefault.time_sec + 0.000000001 * skm->sample[i].KMdefault.time_nanosec;
           if (!(skm->sample[i].KMdefault.status & 0x00000004)) {
             if (*heading_saved != MB_DATA_NAV1) {
-              mb_io_ptr->nheading = 0;
+              mb_asynch_reset(verbose, &mb_io_ptr->asynch_heading, error);
               *heading_saved = MB_DATA_NAV1;
             }
 			      mb_hedint_add(verbose, mbio_ptr, skm_time_d, skm->sample[i].KMdefault.heading_deg, error);
@@ -5083,25 +5384,23 @@ int mbr_rt_kemkmall(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
     preprocess_pars_ptr->target_sensor = 0;
     preprocess_pars_ptr->timestamp_changed = false;
     preprocess_pars_ptr->time_d = 0.0;
-    preprocess_pars_ptr->n_nav = mb_io_ptr->nfix;
-    preprocess_pars_ptr->nav_time_d = mb_io_ptr->fix_time_d;
-    preprocess_pars_ptr->nav_lon = mb_io_ptr->fix_lon;
-    preprocess_pars_ptr->nav_lat = mb_io_ptr->fix_lat;
+    double *values = NULL;
+    mb_asynch_unroll(verbose, &mb_io_ptr->asynch_fix, &preprocess_pars_ptr->n_nav,
+                     &preprocess_pars_ptr->nav_time_d, &values, error);
+    preprocess_pars_ptr->nav_lon = values;
+    preprocess_pars_ptr->nav_lat = &values[preprocess_pars_ptr->n_nav];
     preprocess_pars_ptr->nav_speed = NULL;
-    preprocess_pars_ptr->n_sensordepth = mb_io_ptr->nsensordepth;
-    preprocess_pars_ptr->sensordepth_time_d = mb_io_ptr->sensordepth_time_d;
-    preprocess_pars_ptr->sensordepth_sensordepth = mb_io_ptr->sensordepth_sensordepth;
-    preprocess_pars_ptr->n_heading = mb_io_ptr->nheading;
-    preprocess_pars_ptr->heading_time_d = mb_io_ptr->heading_time_d;
-    preprocess_pars_ptr->heading_heading = mb_io_ptr->heading_heading;
-    preprocess_pars_ptr->n_altitude = mb_io_ptr->naltitude;
-    preprocess_pars_ptr->altitude_time_d = mb_io_ptr->altitude_time_d;
-    preprocess_pars_ptr->altitude_altitude = mb_io_ptr->altitude_altitude;
-    preprocess_pars_ptr->n_attitude = mb_io_ptr->nattitude;
-    preprocess_pars_ptr->attitude_time_d = mb_io_ptr->attitude_time_d;
-    preprocess_pars_ptr->attitude_roll = mb_io_ptr->attitude_roll;
-    preprocess_pars_ptr->attitude_pitch = mb_io_ptr->attitude_pitch;
-    preprocess_pars_ptr->attitude_heave = mb_io_ptr->attitude_heave;
+    mb_asynch_unroll(verbose, &mb_io_ptr->asynch_sensordepth, &preprocess_pars_ptr->n_sensordepth,
+                     &preprocess_pars_ptr->sensordepth_time_d, &preprocess_pars_ptr->sensordepth_sensordepth, error);
+    mb_asynch_unroll(verbose, &mb_io_ptr->asynch_heading, &preprocess_pars_ptr->n_heading,
+                     &preprocess_pars_ptr->heading_time_d, &preprocess_pars_ptr->heading_heading, error);
+    mb_asynch_unroll(verbose, &mb_io_ptr->asynch_altitude, &preprocess_pars_ptr->n_altitude,
+                     &preprocess_pars_ptr->altitude_time_d, &preprocess_pars_ptr->altitude_altitude, error);
+    mb_asynch_unroll(verbose, &mb_io_ptr->asynch_attitude, &preprocess_pars_ptr->n_attitude,
+                     &preprocess_pars_ptr->attitude_time_d, &values, error);
+    preprocess_pars_ptr->attitude_heave = values;
+    preprocess_pars_ptr->attitude_roll = &values[preprocess_pars_ptr->n_attitude];
+    preprocess_pars_ptr->attitude_pitch = &values[2 * preprocess_pars_ptr->n_attitude];
     preprocess_pars_ptr->n_soundspeed = 0;
     preprocess_pars_ptr->soundspeed_time_d = NULL;
     preprocess_pars_ptr->soundspeed_soundspeed = NULL;
@@ -9204,6 +9503,7 @@ int mbr_register_kemkmall(int verbose, void *mbio_ptr, int *error) {
   mb_io_ptr->mb_io_insert_segy = NULL;
   mb_io_ptr->mb_io_ctd = NULL;
   mb_io_ptr->mb_io_ancilliarysensor = NULL;
+  mb_io_ptr->mb_io_seek_time = &mbr_kemkmall_seek_time;
 
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
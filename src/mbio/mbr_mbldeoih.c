@@ -776,21 +776,13 @@ int mbr_rt_mbldeoih(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 		mb_io_ptr->file_bytes += status;
 
 /* byte swap the data if necessary */
-#ifdef BYTESWAPPED
-		for (int i = 0; i < store->beams_bath; i++) {
-			store->bath[i] = mb_swap_short(store->bath[i]);
-			store->bath_acrosstrack[i] = mb_swap_short(store->bath_acrosstrack[i]);
-			store->bath_alongtrack[i] = mb_swap_short(store->bath_alongtrack[i]);
-		}
-		for (int i = 0; i < store->beams_amp; i++) {
-			store->amp[i] = mb_swap_short(store->amp[i]);
-		}
-		for (int i = 0; i < store->pixels_ss; i++) {
-			store->ss[i] = mb_swap_short(store->ss[i]);
-			store->ss_acrosstrack[i] = mb_swap_short(store->ss_acrosstrack[i]);
-			store->ss_alongtrack[i] = mb_swap_short(store->ss_alongtrack[i]);
-		}
-#endif
+		mb_get_binary_short_array(false, store->bath, store->beams_bath, store->bath);
+		mb_get_binary_short_array(false, store->bath_acrosstrack, store->beams_bath, store->bath_acrosstrack);
+		mb_get_binary_short_array(false, store->bath_alongtrack, store->beams_bath, store->bath_alongtrack);
+		mb_get_binary_short_array(false, store->amp, store->beams_amp, store->amp);
+		mb_get_binary_short_array(false, store->ss, store->pixels_ss, store->ss);
+		mb_get_binary_short_array(false, store->ss_acrosstrack, store->pixels_ss, store->ss_acrosstrack);
+		mb_get_binary_short_array(false, store->ss_alongtrack, store->pixels_ss, store->ss_alongtrack);
 
 		/* subtract the transducer depth from the bathymetry if version
 		    1 or 2 data has been read */
@@ -1240,21 +1232,13 @@ int mbr_wt_mbldeoih(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 	}
 	else if (store->kind == MB_DATA_DATA) {
 /* byte swap the data if necessary */
-#ifdef BYTESWAPPED
-		for (int i = 0; i < store->beams_bath; i++) {
-			store->bath[i] = mb_swap_short(store->bath[i]);
-			store->bath_acrosstrack[i] = mb_swap_short(store->bath_acrosstrack[i]);
-			store->bath_alongtrack[i] = mb_swap_short(store->bath_alongtrack[i]);
-		}
-		for (int i = 0; i < store->beams_amp; i++) {
-			store->amp[i] = mb_swap_short(store->amp[i]);
-		}
-		for (int i = 0; i < store->pixels_ss; i++) {
-			store->ss[i] = mb_swap_short(store->ss[i]);
-			store->ss_acrosstrack[i] = mb_swap_short(store->ss_acrosstrack[i]);
-			store->ss_alongtrack[i] = mb_swap_short(store->ss_alongtrack[i]);
-		}
-#endif
+		mb_get_binary_short_array(false, store->bath, store->beams_bath, store->bath);
+		mb_get_binary_short_array(false, store->bath_acrosstrack, store->beams_bath, store->bath_acrosstrack);
+		mb_get_binary_short_array(false, store->bath_alongtrack, store->beams_bath, store->bath_alongtrack);
+		mb_get_binary_short_array(false, store->amp, store->beams_amp, store->amp);
+		mb_get_binary_short_array(false, store->ss, store->pixels_ss, store->ss);
+		mb_get_binary_short_array(false, store->ss_acrosstrack, store->pixels_ss, store->ss_acrosstrack);
+		mb_get_binary_short_array(false, store->ss_alongtrack, store->pixels_ss, store->ss_alongtrack);
 
 		/* write bathymetry */
 		write_size = sizeof(char) * store->beams_bath;
@@ -559,7 +559,7 @@ int mbr_photgram_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
 	}
 
 	/* get file position */
-	mb_io_ptr->file_bytes = ftell(mb_io_ptr->mbfp);
+	mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr);
 
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
@@ -3842,28 +3842,20 @@ int mbr_reson7k3_rd_BeamGeometry(int verbose, char *buffer, void *store_ptr, int
 
   /* extract the data */
   index = header->Offset + 4;
-  mb_get_binary_long(true, &buffer[index], &(BeamGeometry->serial_number));
+  mb_get_binary_long_inline(true, &buffer[index], &(BeamGeometry->serial_number));
   index += 8;
-  mb_get_binary_int(true, &buffer[index], &(BeamGeometry->number_beams));
+  mb_get_binary_int_inline(true, &buffer[index], &(BeamGeometry->number_beams));
   index += 4;
 
   /* extract the data */
-  for (unsigned int i = 0; i < BeamGeometry->number_beams; i++) {
-    mb_get_binary_float(true, &buffer[index], &(BeamGeometry->angle_alongtrack[i]));
-    index += 4;
-  }
-  for (unsigned int i = 0; i < BeamGeometry->number_beams; i++) {
-    mb_get_binary_float(true, &buffer[index], &(BeamGeometry->angle_acrosstrack[i]));
-    index += 4;
-  }
-  for (unsigned int i = 0; i < BeamGeometry->number_beams; i++) {
-    mb_get_binary_float(true, &buffer[index], &(BeamGeometry->beamwidth_alongtrack[i]));
-    index += 4;
-  }
-  for (unsigned int i = 0; i < BeamGeometry->number_beams; i++) {
-    mb_get_binary_float(true, &buffer[index], &(BeamGeometry->beamwidth_acrosstrack[i]));
-    index += 4;
-  }
+  mb_get_binary_float_array(true, &buffer[index], BeamGeometry->number_beams, BeamGeometry->angle_alongtrack);
+  index += 4 * BeamGeometry->number_beams;
+  mb_get_binary_float_array(true, &buffer[index], BeamGeometry->number_beams, BeamGeometry->angle_acrosstrack);
+  index += 4 * BeamGeometry->number_beams;
+  mb_get_binary_float_array(true, &buffer[index], BeamGeometry->number_beams, BeamGeometry->beamwidth_alongtrack);
+  index += 4 * BeamGeometry->number_beams;
+  mb_get_binary_float_array(true, &buffer[index], BeamGeometry->number_beams, BeamGeometry->beamwidth_acrosstrack);
+  index += 4 * BeamGeometry->number_beams;
 
   /* set kind */
   if (status == MB_SUCCESS) {
@@ -3931,13 +3923,13 @@ int mbr_reson7k3_rd_Bathymetry(int verbose, char *buffer, void *store_ptr, int *
 
   /* extract the data */
   index = header->Offset + 4;
-  mb_get_binary_long(true, &buffer[index], &(Bathymetry->serial_number));
+  mb_get_binary_long_inline(true, &buffer[index], &(Bathymetry->serial_number));
   index += 8;
-  mb_get_binary_int(true, &buffer[index], &(Bathymetry->ping_number));
+  mb_get_binary_int_inline(true, &buffer[index], &(Bathymetry->ping_number));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(Bathymetry->multi_ping));
+  mb_get_binary_short_inline(true, &buffer[index], &(Bathymetry->multi_ping));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(Bathymetry->number_beams));
+  mb_get_binary_int_inline(true, &buffer[index], &(Bathymetry->number_beams));
   index += 4;
 
   /* deal with version 5 records */
@@ -3946,7 +3938,7 @@ int mbr_reson7k3_rd_Bathymetry(int verbose, char *buffer, void *store_ptr, int *
     index++;
     Bathymetry->sound_vel_flag = buffer[index];
     index++;
-    mb_get_binary_float(true, &buffer[index], &(Bathymetry->sound_velocity));
+    mb_get_binary_float_inline(true, &buffer[index], &(Bathymetry->sound_velocity));
     index += 4;
   }
   else {
@@ -3956,66 +3948,52 @@ int mbr_reson7k3_rd_Bathymetry(int verbose, char *buffer, void *store_ptr, int *
   }
 
   /* extract the data */
-  for (unsigned int i = 0; i < Bathymetry->number_beams; i++) {
-    mb_get_binary_float(true, &buffer[index], &(Bathymetry->range[i]));
-    index += 4;
-  }
+  mb_get_binary_float_array(true, &buffer[index], Bathymetry->number_beams, Bathymetry->range);
+  index += 4 * Bathymetry->number_beams;
   for (unsigned int i = 0; i < Bathymetry->number_beams; i++) {
     Bathymetry->quality[i] = buffer[index];
     index++;
   }
-  for (unsigned int i = 0; i < Bathymetry->number_beams; i++) {
-    mb_get_binary_float(true, &buffer[index], &(Bathymetry->intensity[i]));
-    index += 4;
-  }
+  mb_get_binary_float_array(true, &buffer[index], Bathymetry->number_beams, Bathymetry->intensity);
+  index += 4 * Bathymetry->number_beams;
   if ((header->OptionalDataOffset == 0 && header->Size >= 92 + 17 * Bathymetry->number_beams) ||
       (header->OptionalDataOffset > 0 && header->Size >= 137 + 37 * Bathymetry->number_beams)) {
-    for (unsigned int i = 0; i < Bathymetry->number_beams; i++) {
-      mb_get_binary_float(true, &buffer[index], &(Bathymetry->min_depth_gate[i]));
-      index += 4;
-    }
-    for (unsigned int i = 0; i < Bathymetry->number_beams; i++) {
-      mb_get_binary_float(true, &buffer[index], &(Bathymetry->max_depth_gate[i]));
-      index += 4;
-    }
+    mb_get_binary_float_array(true, &buffer[index], Bathymetry->number_beams, Bathymetry->min_depth_gate);
+    index += 4 * Bathymetry->number_beams;
+    mb_get_binary_float_array(true, &buffer[index], Bathymetry->number_beams, Bathymetry->max_depth_gate);
+    index += 4 * Bathymetry->number_beams;
   }
 
   /* extract the optional data */
   if (header->OptionalDataOffset > 0) {
     index = header->OptionalDataOffset;
     Bathymetry->optionaldata = true;
-    mb_get_binary_float(true, &buffer[index], &(Bathymetry->frequency));
+    mb_get_binary_float_inline(true, &buffer[index], &(Bathymetry->frequency));
     index += 4;
-    mb_get_binary_double(true, &buffer[index], &(Bathymetry->latitude));
+    mb_get_binary_double_inline(true, &buffer[index], &(Bathymetry->latitude));
     index += 8;
-    mb_get_binary_double(true, &buffer[index], &(Bathymetry->longitude));
+    mb_get_binary_double_inline(true, &buffer[index], &(Bathymetry->longitude));
     index += 8;
-    mb_get_binary_float(true, &buffer[index], &(Bathymetry->heading));
+    mb_get_binary_float_inline(true, &buffer[index], &(Bathymetry->heading));
     index += 4;
     Bathymetry->height_source = buffer[index];
     index++;
-    mb_get_binary_float(true, &buffer[index], &(Bathymetry->tide));
+    mb_get_binary_float_inline(true, &buffer[index], &(Bathymetry->tide));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(Bathymetry->roll));
+    mb_get_binary_float_inline(true, &buffer[index], &(Bathymetry->roll));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(Bathymetry->pitch));
+    mb_get_binary_float_inline(true, &buffer[index], &(Bathymetry->pitch));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(Bathymetry->heave));
+    mb_get_binary_float_inline(true, &buffer[index], &(Bathymetry->heave));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(Bathymetry->vehicle_depth));
+    mb_get_binary_float_inline(true, &buffer[index], &(Bathymetry->vehicle_depth));
     index += 4;
-    for (unsigned int i = 0; i < Bathymetry->number_beams; i++) {
-      mb_get_binary_float(true, &buffer[index], &(Bathymetry->depth[i]));
-      index += 4;
-      mb_get_binary_float(true, &buffer[index], &(Bathymetry->alongtrack[i]));
-      index += 4;
-      mb_get_binary_float(true, &buffer[index], &(Bathymetry->acrosstrack[i]));
-      index += 4;
-      mb_get_binary_float(true, &buffer[index], &(Bathymetry->pointing_angle[i]));
-      index += 4;
-      mb_get_binary_float(true, &buffer[index], &(Bathymetry->azimuth_angle[i]));
-      index += 4;
-    }
+    mb_get_binary_float_strided(true, &buffer[index], 20, Bathymetry->number_beams, Bathymetry->depth);
+    mb_get_binary_float_strided(true, &buffer[index + 4], 20, Bathymetry->number_beams, Bathymetry->alongtrack);
+    mb_get_binary_float_strided(true, &buffer[index + 8], 20, Bathymetry->number_beams, Bathymetry->acrosstrack);
+    mb_get_binary_float_strided(true, &buffer[index + 12], 20, Bathymetry->number_beams, Bathymetry->pointing_angle);
+    mb_get_binary_float_strided(true, &buffer[index + 16], 20, Bathymetry->number_beams, Bathymetry->azimuth_angle);
+    index += 20 * Bathymetry->number_beams;
   }
   else {
     Bathymetry->optionaldata = false;
@@ -4294,36 +4272,36 @@ int mbr_reson7k3_rd_WaterColumn(int verbose, char *buffer, void *store_ptr, int
 
   /* extract the data */
   index = header->Offset + 4;
-  mb_get_binary_long(true, &buffer[index], &(WaterColumn->serial_number));
+  mb_get_binary_long_inline(true, &buffer[index], &(WaterColumn->serial_number));
   index += 8;
-  mb_get_binary_int(true, &buffer[index], &(WaterColumn->ping_number));
+  mb_get_binary_int_inline(true, &buffer[index], &(WaterColumn->ping_number));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(WaterColumn->multi_ping));
+  mb_get_binary_short_inline(true, &buffer[index], &(WaterColumn->multi_ping));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(WaterColumn->number_beams));
+  mb_get_binary_short_inline(true, &buffer[index], &(WaterColumn->number_beams));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(WaterColumn->reserved));
+  mb_get_binary_short_inline(true, &buffer[index], &(WaterColumn->reserved));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(WaterColumn->samples));
+  mb_get_binary_int_inline(true, &buffer[index], &(WaterColumn->samples));
   index += 4;
   WaterColumn->subset_flag = buffer[index];
   index++;
   WaterColumn->column_flag = buffer[index];
   index++;
-  mb_get_binary_short(true, &buffer[index], &(WaterColumn->reserved2));
+  mb_get_binary_short_inline(true, &buffer[index], &(WaterColumn->reserved2));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(WaterColumn->sample_type));
+  mb_get_binary_int_inline(true, &buffer[index], &(WaterColumn->sample_type));
   index += 4;
   sample_type_amp = WaterColumn->sample_type & 15;
   sample_type_phase = (WaterColumn->sample_type >> 4) & 15;
   sample_type_iandq = (WaterColumn->sample_type >> 8) & 15;
   for (unsigned int i = 0; i < WaterColumn->number_beams; i++) {
     wcd = &WaterColumn->wcd[i];
-    mb_get_binary_short(true, &buffer[index], &(wcd->beam_number));
+    mb_get_binary_short_inline(true, &buffer[index], &(wcd->beam_number));
     index += 2;
-    mb_get_binary_int(true, &buffer[index], &(wcd->begin_sample));
+    mb_get_binary_int_inline(true, &buffer[index], &(wcd->begin_sample));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(wcd->end_sample));
+    mb_get_binary_int_inline(true, &buffer[index], &(wcd->end_sample));
     index += 4;
   }
 
@@ -4378,12 +4356,12 @@ int mbr_reson7k3_rd_WaterColumn(int verbose, char *buffer, void *store_ptr, int
         }
         else if (sample_type_amp == 2) {
           ushortptr = (unsigned short *)wcd->amplitude;
-          mb_get_binary_short(true, &buffer[index], &(ushortptr[j]));
+          mb_get_binary_short_inline(true, &buffer[index], &(ushortptr[j]));
           index += 2;
         }
         else if (sample_type_amp == 3) {
           uintptr = (unsigned int *)wcd->amplitude;
-          mb_get_binary_int(true, &buffer[index], &(uintptr[j]));
+          mb_get_binary_int_inline(true, &buffer[index], &(uintptr[j]));
           index += 4;
         }
         if (sample_type_phase == 1) {
@@ -4393,28 +4371,28 @@ int mbr_reson7k3_rd_WaterColumn(int verbose, char *buffer, void *store_ptr, int
         }
         else if (sample_type_phase == 2) {
           ushortptr = (unsigned short *)wcd->phase;
-          mb_get_binary_short(true, &buffer[index], &(ushortptr[j]));
+          mb_get_binary_short_inline(true, &buffer[index], &(ushortptr[j]));
           index += 2;
         }
         else if (sample_type_phase == 3) {
           uintptr = (unsigned int *)wcd->phase;
-          mb_get_binary_int(true, &buffer[index], &(uintptr[j]));
+          mb_get_binary_int_inline(true, &buffer[index], &(uintptr[j]));
           index += 4;
         }
         if (sample_type_iandq == 1) {
           shortptramp = (short *)wcd->amplitude;
           shortptrphase = (short *)wcd->phase;
-          mb_get_binary_short(true, &buffer[index], &(shortptramp[j]));
+          mb_get_binary_short_inline(true, &buffer[index], &(shortptramp[j]));
           index += 2;
-          mb_get_binary_short(true, &buffer[index], &(shortptrphase[j]));
+          mb_get_binary_short_inline(true, &buffer[index], &(shortptrphase[j]));
           index += 2;
         }
         else if (sample_type_iandq == 2) {
           intptramp = (int *)wcd->amplitude;
           intptrphase = (int *)wcd->phase;
-          mb_get_binary_int(true, &buffer[index], &(intptramp[j]));
+          mb_get_binary_int_inline(true, &buffer[index], &(intptramp[j]));
           index += 4;
-          mb_get_binary_int(true, &buffer[index], &(intptrphase[j]));
+          mb_get_binary_int_inline(true, &buffer[index], &(intptrphase[j]));
           index += 4;
         }
       }
@@ -5052,65 +5030,65 @@ int mbr_reson7k3_rd_DetectionDataSetup(int verbose, char *buffer, void *store_pt
 
   /* extract the data */
   index = header->Offset + 4;
-  mb_get_binary_long(true, &buffer[index], &(DetectionDataSetup->serial_number));
+  mb_get_binary_long_inline(true, &buffer[index], &(DetectionDataSetup->serial_number));
   index += 8;
-  mb_get_binary_int(true, &buffer[index], &(DetectionDataSetup->ping_number));
+  mb_get_binary_int_inline(true, &buffer[index], &(DetectionDataSetup->ping_number));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(DetectionDataSetup->multi_ping));
+  mb_get_binary_short_inline(true, &buffer[index], &(DetectionDataSetup->multi_ping));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(DetectionDataSetup->number_beams));
+  mb_get_binary_int_inline(true, &buffer[index], &(DetectionDataSetup->number_beams));
   index += 4;
-  mb_get_binary_int(true, &buffer[index], &(DetectionDataSetup->data_block_size));
+  mb_get_binary_int_inline(true, &buffer[index], &(DetectionDataSetup->data_block_size));
   index += 4;
   DetectionDataSetup->detection_algorithm = buffer[index];
   index++;
-  mb_get_binary_int(true, &buffer[index], &(DetectionDataSetup->detection_flags));
+  mb_get_binary_int_inline(true, &buffer[index], &(DetectionDataSetup->detection_flags));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->minimum_depth));
+  mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->minimum_depth));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->maximum_depth));
+  mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->maximum_depth));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->minimum_range));
+  mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->minimum_range));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->maximum_range));
+  mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->maximum_range));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->minimum_nadir_search));
+  mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->minimum_nadir_search));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->maximum_nadir_search));
+  mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->maximum_nadir_search));
   index += 4;
   DetectionDataSetup->automatic_filter_window = buffer[index];
   index++;
-  mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->applied_roll));
+  mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->applied_roll));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->depth_gate_tilt));
+  mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->depth_gate_tilt));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->nadir_depth));
+  mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->nadir_depth));
   index += 4;
   for (unsigned int i = 0; i < 13; i++) {
-    mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->reserved[i]));
+    mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->reserved[i]));
     index += 4;
   }
 
   /* extract DetectionDataSetup data */
   for (unsigned int i = 0; i < DetectionDataSetup->number_beams; i++) {
-    mb_get_binary_short(true, &buffer[index], &(DetectionDataSetup->beam_descriptor[i]));
+    mb_get_binary_short_inline(true, &buffer[index], &(DetectionDataSetup->beam_descriptor[i]));
     index += 2;
-    mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->detection_point[i]));
+    mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->detection_point[i]));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(DetectionDataSetup->flags[i]));
+    mb_get_binary_int_inline(true, &buffer[index], &(DetectionDataSetup->flags[i]));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(DetectionDataSetup->auto_limits_min_sample[i]));
+    mb_get_binary_int_inline(true, &buffer[index], &(DetectionDataSetup->auto_limits_min_sample[i]));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(DetectionDataSetup->auto_limits_max_sample[i]));
+    mb_get_binary_int_inline(true, &buffer[index], &(DetectionDataSetup->auto_limits_max_sample[i]));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(DetectionDataSetup->user_limits_min_sample[i]));
+    mb_get_binary_int_inline(true, &buffer[index], &(DetectionDataSetup->user_limits_min_sample[i]));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(DetectionDataSetup->user_limits_max_sample[i]));
+    mb_get_binary_int_inline(true, &buffer[index], &(DetectionDataSetup->user_limits_max_sample[i]));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(DetectionDataSetup->quality[i]));
+    mb_get_binary_int_inline(true, &buffer[index], &(DetectionDataSetup->quality[i]));
     index += 4;
     if (DetectionDataSetup->data_block_size >= R7KRDTSIZE_DetectionDataSetup) {
-      mb_get_binary_float(true, &buffer[index], &(DetectionDataSetup->uncertainty[i]));
+      mb_get_binary_float_inline(true, &buffer[index], &(DetectionDataSetup->uncertainty[i]));
       index += 4;
     } else {
       DetectionDataSetup->uncertainty[i] = 0.0;
@@ -5189,18 +5167,18 @@ int mbr_reson7k3_rd_Beamformed(int verbose, char *buffer, void *store_ptr, int *
 
   /* extract the data */
   index = header->Offset + 4;
-  mb_get_binary_long(true, &buffer[index], &(Beamformed->serial_number));
+  mb_get_binary_long_inline(true, &buffer[index], &(Beamformed->serial_number));
   index += 8;
-  mb_get_binary_int(true, &buffer[index], &(Beamformed->ping_number));
+  mb_get_binary_int_inline(true, &buffer[index], &(Beamformed->ping_number));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(Beamformed->multi_ping));
+  mb_get_binary_short_inline(true, &buffer[index], &(Beamformed->multi_ping));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(Beamformed->number_beams));
+  mb_get_binary_short_inline(true, &buffer[index], &(Beamformed->number_beams));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(Beamformed->number_samples));
+  mb_get_binary_int_inline(true, &buffer[index], &(Beamformed->number_samples));
   index += 4;
   for (unsigned int i = 0; i < 8; i++) {
-    mb_get_binary_int(true, &buffer[index], &(Beamformed->reserved[i]));
+    mb_get_binary_int_inline(true, &buffer[index], &(Beamformed->reserved[i]));
     index += 4;
   }
 
@@ -5227,9 +5205,9 @@ int mbr_reson7k3_rd_Beamformed(int verbose, char *buffer, void *store_ptr, int *
 
     /* extract Beamformed data */
     for (unsigned int j = 0; j < Beamformed->number_samples; j++) {
-      mb_get_binary_short(true, &buffer[index], &(amplitudephase->amplitude[j]));
+      mb_get_binary_short_inline(true, &buffer[index], &(amplitudephase->amplitude[j]));
       index += 2;
-      mb_get_binary_short(true, &buffer[index], &(amplitudephase->phase[j]));
+      mb_get_binary_short_inline(true, &buffer[index], &(amplitudephase->phase[j]));
       index += 2;
     }
     amplitudephase->beam_number = i;
@@ -5788,58 +5766,58 @@ int mbr_reson7k3_rd_RawDetection(int verbose, char *buffer, void *store_ptr, int
 
   /* extract the data */
   index = header->Offset + 4;
-  mb_get_binary_long(true, &buffer[index], &(RawDetection->serial_number));
+  mb_get_binary_long_inline(true, &buffer[index], &(RawDetection->serial_number));
   index += 8;
-  mb_get_binary_int(true, &buffer[index], &(RawDetection->ping_number));
+  mb_get_binary_int_inline(true, &buffer[index], &(RawDetection->ping_number));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(RawDetection->multi_ping));
+  mb_get_binary_short_inline(true, &buffer[index], &(RawDetection->multi_ping));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(RawDetection->number_beams));
+  mb_get_binary_int_inline(true, &buffer[index], &(RawDetection->number_beams));
   index += 4;
-  mb_get_binary_int(true, &buffer[index], &(RawDetection->data_field_size));
+  mb_get_binary_int_inline(true, &buffer[index], &(RawDetection->data_field_size));
   index += 4;
   RawDetection->detection_algorithm = buffer[index];
   index++;
-  mb_get_binary_int(true, &buffer[index], &(RawDetection->flags));
+  mb_get_binary_int_inline(true, &buffer[index], &(RawDetection->flags));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(RawDetection->sampling_rate));
+  mb_get_binary_float_inline(true, &buffer[index], &(RawDetection->sampling_rate));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(RawDetection->tx_angle));
+  mb_get_binary_float_inline(true, &buffer[index], &(RawDetection->tx_angle));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(RawDetection->applied_roll));
+  mb_get_binary_float_inline(true, &buffer[index], &(RawDetection->applied_roll));
   index += 4;
   for (unsigned int i = 0; i < 15; i++) {
-    mb_get_binary_int(true, &buffer[index], &(RawDetection->reserved[i]));
+    mb_get_binary_int_inline(true, &buffer[index], &(RawDetection->reserved[i]));
     index += 4;
   }
 
   /* extract the data */
   for (unsigned int i = 0; i < RawDetection->number_beams; i++) {
     rawdetectiondata = (s7k3_rawdetectiondata *)&RawDetection->rawdetectiondata[i];
-    mb_get_binary_short(true, &buffer[index], &(rawdetectiondata->beam_descriptor));
+    mb_get_binary_short_inline(true, &buffer[index], &(rawdetectiondata->beam_descriptor));
     index += 2;
-    mb_get_binary_float(true, &buffer[index], &(rawdetectiondata->detection_point));
+    mb_get_binary_float_inline(true, &buffer[index], &(rawdetectiondata->detection_point));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(rawdetectiondata->rx_angle));
+    mb_get_binary_float_inline(true, &buffer[index], &(rawdetectiondata->rx_angle));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(rawdetectiondata->flags));
+    mb_get_binary_int_inline(true, &buffer[index], &(rawdetectiondata->flags));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(rawdetectiondata->quality));
+    mb_get_binary_int_inline(true, &buffer[index], &(rawdetectiondata->quality));
     index += 4;
     if (RawDetection->data_field_size >= 22) {
-      mb_get_binary_float(true, &buffer[index], &(rawdetectiondata->uncertainty));
+      mb_get_binary_float_inline(true, &buffer[index], &(rawdetectiondata->uncertainty));
       index += 4;
     }
     if (RawDetection->data_field_size >= 26) {
-      mb_get_binary_float(true, &buffer[index], &(rawdetectiondata->signal_strength));
+      mb_get_binary_float_inline(true, &buffer[index], &(rawdetectiondata->signal_strength));
       index += 4;
     }
     if (RawDetection->data_field_size >= 30) {
-      mb_get_binary_float(true, &buffer[index], &(rawdetectiondata->min_limit));
+      mb_get_binary_float_inline(true, &buffer[index], &(rawdetectiondata->min_limit));
       index += 4;
     }
     if (RawDetection->data_field_size >= 34) {
-      mb_get_binary_float(true, &buffer[index], &(rawdetectiondata->max_limit));
+      mb_get_binary_float_inline(true, &buffer[index], &(rawdetectiondata->max_limit));
       index += 4;
     }
 
@@ -5853,37 +5831,37 @@ int mbr_reson7k3_rd_RawDetection(int verbose, char *buffer, void *store_ptr, int
     RawDetection->optionaldata = true;
     index = header->OptionalDataOffset;
 
-    mb_get_binary_float(true, &buffer[index], &(RawDetection->frequency));
+    mb_get_binary_float_inline(true, &buffer[index], &(RawDetection->frequency));
     index += 4;
-    mb_get_binary_double(true, &buffer[index], &(RawDetection->latitude));
+    mb_get_binary_double_inline(true, &buffer[index], &(RawDetection->latitude));
     index += 8;
-    mb_get_binary_double(true, &buffer[index], &(RawDetection->longitude));
+    mb_get_binary_double_inline(true, &buffer[index], &(RawDetection->longitude));
     index += 8;
-    mb_get_binary_float(true, &buffer[index], &(RawDetection->heading));
+    mb_get_binary_float_inline(true, &buffer[index], &(RawDetection->heading));
     index += 4;
     RawDetection->height_source = buffer[index];
     index += 1;
-    mb_get_binary_float(true, &buffer[index], &(RawDetection->tide));
+    mb_get_binary_float_inline(true, &buffer[index], &(RawDetection->tide));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(RawDetection->roll));
+    mb_get_binary_float_inline(true, &buffer[index], &(RawDetection->roll));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(RawDetection->pitch));
+    mb_get_binary_float_inline(true, &buffer[index], &(RawDetection->pitch));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(RawDetection->heave));
+    mb_get_binary_float_inline(true, &buffer[index], &(RawDetection->heave));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(RawDetection->vehicle_depth));
+    mb_get_binary_float_inline(true, &buffer[index], &(RawDetection->vehicle_depth));
     index += 4;
     for (unsigned int i = 0; i < RawDetection->number_beams; i++) {
       bathydata = (s7k3_bathydata *)&RawDetection->bathydata[i];
-      mb_get_binary_float(true, &buffer[index], &(bathydata->depth));
+      mb_get_binary_float_inline(true, &buffer[index], &(bathydata->depth));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(bathydata->alongtrack));
+      mb_get_binary_float_inline(true, &buffer[index], &(bathydata->alongtrack));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(bathydata->acrosstrack));
+      mb_get_binary_float_inline(true, &buffer[index], &(bathydata->acrosstrack));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(bathydata->pointing_angle));
+      mb_get_binary_float_inline(true, &buffer[index], &(bathydata->pointing_angle));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(bathydata->azimuth_angle));
+      mb_get_binary_float_inline(true, &buffer[index], &(bathydata->azimuth_angle));
       index += 4;
     }
   }
@@ -5972,22 +5950,22 @@ int mbr_reson7k3_rd_Snippet(int verbose, char *buffer, void *store_ptr, int *err
 
   /* extract the data */
   index = header->Offset + 4;
-  mb_get_binary_long(true, &buffer[index], &(Snippet->serial_number));
+  mb_get_binary_long_inline(true, &buffer[index], &(Snippet->serial_number));
   index += 8;
-  mb_get_binary_int(true, &buffer[index], &(Snippet->ping_number));
+  mb_get_binary_int_inline(true, &buffer[index], &(Snippet->ping_number));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(Snippet->multi_ping));
+  mb_get_binary_short_inline(true, &buffer[index], &(Snippet->multi_ping));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(Snippet->number_beams));
+  mb_get_binary_short_inline(true, &buffer[index], &(Snippet->number_beams));
   index += 2;
   Snippet->error_flag = buffer[index];
   index++;
   Snippet->control_flags = buffer[index];
   index++;
-  mb_get_binary_int(true, &buffer[index], &(Snippet->flags));
+  mb_get_binary_int_inline(true, &buffer[index], &(Snippet->flags));
   index += 4;
   for (unsigned int i = 0; i < 6; i++) {
-    mb_get_binary_int(true, &buffer[index], &(Snippet->reserved[i]));
+    mb_get_binary_int_inline(true, &buffer[index], &(Snippet->reserved[i]));
     index += 4;
   }
 
@@ -5996,13 +5974,13 @@ int mbr_reson7k3_rd_Snippet(int verbose, char *buffer, void *store_ptr, int *err
     snippetdata = (s7k3_snippetdata *)&(Snippet->snippetdata[i]);
 
     /* extract snippet data */
-    mb_get_binary_short(true, &buffer[index], &(snippetdata->beam_number));
+    mb_get_binary_short_inline(true, &buffer[index], &(snippetdata->beam_number));
     index += 2;
-    mb_get_binary_int(true, &buffer[index], &(snippetdata->begin_sample));
+    mb_get_binary_int_inline(true, &buffer[index], &(snippetdata->begin_sample));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(snippetdata->detect_sample));
+    mb_get_binary_int_inline(true, &buffer[index], &(snippetdata->detect_sample));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(snippetdata->end_sample));
+    mb_get_binary_int_inline(true, &buffer[index], &(snippetdata->end_sample));
     index += 4;
 
     /* allocate memory for snippet data if needed */
@@ -6032,7 +6010,7 @@ int mbr_reson7k3_rd_Snippet(int verbose, char *buffer, void *store_ptr, int *err
         u32_ptr = (u32 *)snippetdata->amplitude;
         nsample = snippetdata->end_sample - snippetdata->begin_sample + 1;
         for (int j = 0; j < nsample; j++) {
-          mb_get_binary_int(true, &buffer[index], &(u32_ptr[j]));
+          mb_get_binary_int_inline(true, &buffer[index], &(u32_ptr[j]));
           index += 4;
         }
       }
@@ -6043,7 +6021,7 @@ int mbr_reson7k3_rd_Snippet(int verbose, char *buffer, void *store_ptr, int *err
         u16_ptr = (u16 *)snippetdata->amplitude;
         nsample = snippetdata->end_sample - snippetdata->begin_sample + 1;
         for (int j = 0; j < nsample; j++) {
-          mb_get_binary_short(true, &buffer[index], &(u16_ptr[j]));
+          mb_get_binary_short_inline(true, &buffer[index], &(u16_ptr[j]));
           index += 2;
         }
       }
@@ -6055,20 +6033,20 @@ int mbr_reson7k3_rd_Snippet(int verbose, char *buffer, void *store_ptr, int *err
     Snippet->optionaldata = true;
     index = header->OptionalDataOffset;
 
-    mb_get_binary_float(true, &buffer[index], &(Snippet->frequency));
+    mb_get_binary_float_inline(true, &buffer[index], &(Snippet->frequency));
     index += 4;
-    mb_get_binary_double(true, &buffer[index], &(Snippet->latitude));
+    mb_get_binary_double_inline(true, &buffer[index], &(Snippet->latitude));
     index += 8;
-    mb_get_binary_double(true, &buffer[index], &(Snippet->longitude));
+    mb_get_binary_double_inline(true, &buffer[index], &(Snippet->longitude));
     index += 8;
-    mb_get_binary_float(true, &buffer[index], &(Snippet->heading));
+    mb_get_binary_float_inline(true, &buffer[index], &(Snippet->heading));
     index += 4;
     for (unsigned int i = 0; i < Snippet->number_beams; i++) {
-      mb_get_binary_float(true, &buffer[index], &(Snippet->beam_alongtrack[i]));
+      mb_get_binary_float_inline(true, &buffer[index], &(Snippet->beam_alongtrack[i]));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(Snippet->beam_acrosstrack[i]));
+      mb_get_binary_float_inline(true, &buffer[index], &(Snippet->beam_acrosstrack[i]));
       index += 4;
-      mb_get_binary_int(true, &buffer[index], &(Snippet->center_sample[i]));
+      mb_get_binary_int_inline(true, &buffer[index], &(Snippet->center_sample[i]));
       index += 4;
     }
   }
@@ -6512,27 +6490,27 @@ int mbr_reson7k3_rd_CompressedWaterColumn(int verbose, char *buffer, void *store
 
   /* extract the data */
   index = header->Offset + 4;
-  mb_get_binary_long(true, &buffer[index], &(CompressedWaterColumn->serial_number));
+  mb_get_binary_long_inline(true, &buffer[index], &(CompressedWaterColumn->serial_number));
   index += 8;
-  mb_get_binary_int(true, &buffer[index], &(CompressedWaterColumn->ping_number));
+  mb_get_binary_int_inline(true, &buffer[index], &(CompressedWaterColumn->ping_number));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(CompressedWaterColumn->multi_ping));
+  mb_get_binary_short_inline(true, &buffer[index], &(CompressedWaterColumn->multi_ping));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(CompressedWaterColumn->number_beams));
+  mb_get_binary_short_inline(true, &buffer[index], &(CompressedWaterColumn->number_beams));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(CompressedWaterColumn->samples));
+  mb_get_binary_int_inline(true, &buffer[index], &(CompressedWaterColumn->samples));
   index += 4;
-  mb_get_binary_int(true, &buffer[index], &(CompressedWaterColumn->compressed_samples));
+  mb_get_binary_int_inline(true, &buffer[index], &(CompressedWaterColumn->compressed_samples));
   index += 4;
-  mb_get_binary_int(true, &buffer[index], &(CompressedWaterColumn->flags));
+  mb_get_binary_int_inline(true, &buffer[index], &(CompressedWaterColumn->flags));
   index += 4;
-  mb_get_binary_int(true, &buffer[index], &(CompressedWaterColumn->first_sample));
+  mb_get_binary_int_inline(true, &buffer[index], &(CompressedWaterColumn->first_sample));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(CompressedWaterColumn->sample_rate));
+  mb_get_binary_float_inline(true, &buffer[index], &(CompressedWaterColumn->sample_rate));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(CompressedWaterColumn->compression_factor));
+  mb_get_binary_float_inline(true, &buffer[index], &(CompressedWaterColumn->compression_factor));
   index += 4;
-  mb_get_binary_int(true, &buffer[index], &(CompressedWaterColumn->reserved));
+  mb_get_binary_int_inline(true, &buffer[index], &(CompressedWaterColumn->reserved));
   index += 4;
 
   /* calculate bytes per sample and allocate memory for time series if needed */
@@ -6612,13 +6590,13 @@ int mbr_reson7k3_rd_CompressedWaterColumn(int verbose, char *buffer, void *store
     compressedwatercolumndata = (s7k3_compressedwatercolumndata *)&(CompressedWaterColumn->compressedwatercolumndata[i]);
 
     /* extract CompressedWaterColumn data */
-    mb_get_binary_short(true, &buffer[index], &(compressedwatercolumndata->beam_number));
+    mb_get_binary_short_inline(true, &buffer[index], &(compressedwatercolumndata->beam_number));
     index += 2;
     if (segmentnumbersvalid) {
       compressedwatercolumndata->segment_number = buffer[index];
       index += 1;
     }
-    mb_get_binary_int(true, &buffer[index], &(compressedwatercolumndata->samples));
+    mb_get_binary_int_inline(true, &buffer[index], &(compressedwatercolumndata->samples));
     index += 4;
 
     /* allocate memory for compressedwatercolumndata data if needed */
@@ -6713,67 +6691,67 @@ int mbr_reson7k3_rd_SegmentedRawDetection(int verbose, char *buffer, void *store
   /* extract the data */
   index = header->Offset + 4;
 
-  mb_get_binary_short(true, &buffer[index], &(SegmentedRawDetection->record_header_size));
+  mb_get_binary_short_inline(true, &buffer[index], &(SegmentedRawDetection->record_header_size));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(SegmentedRawDetection->n_segments));
+  mb_get_binary_int_inline(true, &buffer[index], &(SegmentedRawDetection->n_segments));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(SegmentedRawDetection->segment_field_size));
+  mb_get_binary_short_inline(true, &buffer[index], &(SegmentedRawDetection->segment_field_size));
   index += 2;
-  mb_get_binary_int(true, &buffer[index], &(SegmentedRawDetection->n_rx));
+  mb_get_binary_int_inline(true, &buffer[index], &(SegmentedRawDetection->n_rx));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(SegmentedRawDetection->rx_field_size));
+  mb_get_binary_short_inline(true, &buffer[index], &(SegmentedRawDetection->rx_field_size));
   index += 2;
-  mb_get_binary_long(true, &buffer[index], &(SegmentedRawDetection->serial_number));
+  mb_get_binary_long_inline(true, &buffer[index], &(SegmentedRawDetection->serial_number));
   index += 8;
-  mb_get_binary_int(true, &buffer[index], &(SegmentedRawDetection->ping_number));
+  mb_get_binary_int_inline(true, &buffer[index], &(SegmentedRawDetection->ping_number));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(SegmentedRawDetection->multi_ping));
+  mb_get_binary_short_inline(true, &buffer[index], &(SegmentedRawDetection->multi_ping));
   index += 2;
-  mb_get_binary_float(true, &buffer[index], &(SegmentedRawDetection->sound_velocity));
+  mb_get_binary_float_inline(true, &buffer[index], &(SegmentedRawDetection->sound_velocity));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(SegmentedRawDetection->rx_delay));
+  mb_get_binary_float_inline(true, &buffer[index], &(SegmentedRawDetection->rx_delay));
   index += 4;
 
   /* extract the data */
   for (unsigned int i = 0; i < SegmentedRawDetection->n_segments; i++) {
     segmentedrawdetectiontxdata = (s7k3_segmentedrawdetectiontxdata *)&SegmentedRawDetection->segmentedrawdetectiontxdata[i];
-    mb_get_binary_short(true, &buffer[index], &(segmentedrawdetectiontxdata->segment_number));
+    mb_get_binary_short_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->segment_number));
     index += 2;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_angle_along));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_angle_along));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_angle_across));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_angle_across));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_delay));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_delay));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->frequency));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->frequency));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(segmentedrawdetectiontxdata->pulse_type));
+    mb_get_binary_int_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->pulse_type));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->pulse_bandwidth));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->pulse_bandwidth));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_pulse_width));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_pulse_width));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_pulse_width_across));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_pulse_width_across));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_pulse_width_along));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_pulse_width_along));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_pulse_envelope));
+    mb_get_binary_int_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_pulse_envelope));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_pulse_envelope_parameter));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_pulse_envelope_parameter));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_relative_src_level));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->tx_relative_src_level));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->rx_beam_width));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->rx_beam_width));
     index += 4;
     segmentedrawdetectiontxdata->detection_algorithm = buffer[index];
     index += 1;
-    mb_get_binary_int(true, &buffer[index], &(segmentedrawdetectiontxdata->flags));
+    mb_get_binary_int_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->flags));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->sampling_rate));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->sampling_rate));
     index += 4;
     segmentedrawdetectiontxdata->tvg = buffer[index];
     index += 1;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectiontxdata->rx_bandwidth));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectiontxdata->rx_bandwidth));
     index += 4;
 
     /* skip extra data if it exists */
@@ -6783,23 +6761,23 @@ int mbr_reson7k3_rd_SegmentedRawDetection(int verbose, char *buffer, void *store
 
   for (unsigned int i = 0;i<SegmentedRawDetection->n_rx;i++) {
     segmentedrawdetectionrxdata = (s7k3_segmentedrawdetectionrxdata *)&(SegmentedRawDetection->segmentedrawdetectionrxdata[i]);
-    mb_get_binary_short(true, &buffer[index], &(segmentedrawdetectionrxdata->beam_number));
+    mb_get_binary_short_inline(true, &buffer[index], &(segmentedrawdetectionrxdata->beam_number));
     index += 2;
-    mb_get_binary_short(true, &buffer[index], &(segmentedrawdetectionrxdata->used_segment));
+    mb_get_binary_short_inline(true, &buffer[index], &(segmentedrawdetectionrxdata->used_segment));
     index += 2;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectionrxdata->detection_point));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectionrxdata->detection_point));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectionrxdata->rx_angle_cross));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectionrxdata->rx_angle_cross));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(segmentedrawdetectionrxdata->flags2));
+    mb_get_binary_int_inline(true, &buffer[index], &(segmentedrawdetectionrxdata->flags2));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(segmentedrawdetectionrxdata->quality));
+    mb_get_binary_int_inline(true, &buffer[index], &(segmentedrawdetectionrxdata->quality));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectionrxdata->uncertainty));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectionrxdata->uncertainty));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectionrxdata->signal_strength));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectionrxdata->signal_strength));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(segmentedrawdetectionrxdata->sn_ratio));
+    mb_get_binary_float_inline(true, &buffer[index], &(segmentedrawdetectionrxdata->sn_ratio));
     index += 4;
 
     /* skip extra data if it exists */
@@ -6812,37 +6790,37 @@ int mbr_reson7k3_rd_SegmentedRawDetection(int verbose, char *buffer, void *store
     SegmentedRawDetection->optionaldata = true;
     index = header->OptionalDataOffset;
 
-    mb_get_binary_float(true, &buffer[index], &(SegmentedRawDetection->frequency));
+    mb_get_binary_float_inline(true, &buffer[index], &(SegmentedRawDetection->frequency));
     index += 4;
-    mb_get_binary_double(true, &buffer[index], &(SegmentedRawDetection->latitude));
+    mb_get_binary_double_inline(true, &buffer[index], &(SegmentedRawDetection->latitude));
     index += 8;
-    mb_get_binary_double(true, &buffer[index], &(SegmentedRawDetection->longitude));
+    mb_get_binary_double_inline(true, &buffer[index], &(SegmentedRawDetection->longitude));
     index += 8;
-    mb_get_binary_float(true, &buffer[index], &(SegmentedRawDetection->heading));
+    mb_get_binary_float_inline(true, &buffer[index], &(SegmentedRawDetection->heading));
     index += 4;
     SegmentedRawDetection->height_source = buffer[index];
     index += 1;
-    mb_get_binary_float(true, &buffer[index], &(SegmentedRawDetection->tide));
+    mb_get_binary_float_inline(true, &buffer[index], &(SegmentedRawDetection->tide));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(SegmentedRawDetection->roll));
+    mb_get_binary_float_inline(true, &buffer[index], &(SegmentedRawDetection->roll));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(SegmentedRawDetection->pitch));
+    mb_get_binary_float_inline(true, &buffer[index], &(SegmentedRawDetection->pitch));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(SegmentedRawDetection->heave));
+    mb_get_binary_float_inline(true, &buffer[index], &(SegmentedRawDetection->heave));
     index += 4;
-    mb_get_binary_float(true, &buffer[index], &(SegmentedRawDetection->vehicle_depth));
+    mb_get_binary_float_inline(true, &buffer[index], &(SegmentedRawDetection->vehicle_depth));
     index += 4;
     for (unsigned int i = 0; i < SegmentedRawDetection->n_rx; i++) {
       bathydata = (s7k3_bathydata *)&SegmentedRawDetection->bathydata[i];
-      mb_get_binary_float(true, &buffer[index], &(bathydata->depth));
+      mb_get_binary_float_inline(true, &buffer[index], &(bathydata->depth));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(bathydata->alongtrack));
+      mb_get_binary_float_inline(true, &buffer[index], &(bathydata->alongtrack));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(bathydata->acrosstrack));
+      mb_get_binary_float_inline(true, &buffer[index], &(bathydata->acrosstrack));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(bathydata->pointing_angle));
+      mb_get_binary_float_inline(true, &buffer[index], &(bathydata->pointing_angle));
       index += 4;
-      mb_get_binary_float(true, &buffer[index], &(bathydata->azimuth_angle));
+      mb_get_binary_float_inline(true, &buffer[index], &(bathydata->azimuth_angle));
       index += 4;
     }
   }
@@ -7673,22 +7651,22 @@ int mbr_reson7k3_rd_SnippetBackscatteringStrength(int verbose, char *buffer, voi
 
   /* extract the data */
   index = header->Offset + 4;
-  mb_get_binary_long(true, &buffer[index], &(SnippetBackscatteringStrength->serial_number));
+  mb_get_binary_long_inline(true, &buffer[index], &(SnippetBackscatteringStrength->serial_number));
   index += 8;
-  mb_get_binary_int(true, &buffer[index], &(SnippetBackscatteringStrength->ping_number));
+  mb_get_binary_int_inline(true, &buffer[index], &(SnippetBackscatteringStrength->ping_number));
   index += 4;
-  mb_get_binary_short(true, &buffer[index], &(SnippetBackscatteringStrength->multi_ping));
+  mb_get_binary_short_inline(true, &buffer[index], &(SnippetBackscatteringStrength->multi_ping));
   index += 2;
-  mb_get_binary_short(true, &buffer[index], &(SnippetBackscatteringStrength->number_beams));
+  mb_get_binary_short_inline(true, &buffer[index], &(SnippetBackscatteringStrength->number_beams));
   index += 2;
   SnippetBackscatteringStrength->error_flag = buffer[index];
   index++;
-  mb_get_binary_int(true, &buffer[index], &(SnippetBackscatteringStrength->control_flags));
+  mb_get_binary_int_inline(true, &buffer[index], &(SnippetBackscatteringStrength->control_flags));
   index += 4;
-  mb_get_binary_float(true, &buffer[index], &(SnippetBackscatteringStrength->absorption));
+  mb_get_binary_float_inline(true, &buffer[index], &(SnippetBackscatteringStrength->absorption));
   index += 4;
   for (unsigned int i = 0; i < 6; i++) {
-    mb_get_binary_int(true, &buffer[index], &(SnippetBackscatteringStrength->reserved[i]));
+    mb_get_binary_int_inline(true, &buffer[index], &(SnippetBackscatteringStrength->reserved[i]));
     index += 4;
   }
 
@@ -7698,13 +7676,13 @@ int mbr_reson7k3_rd_SnippetBackscatteringStrength(int verbose, char *buffer, voi
         = &(SnippetBackscatteringStrength->snippetbackscatteringstrengthdata[i]);
 
     /* extract snippettimeseries data */
-    mb_get_binary_short(true, &buffer[index], &(snippetbackscatteringstrengthdata->beam_number));
+    mb_get_binary_short_inline(true, &buffer[index], &(snippetbackscatteringstrengthdata->beam_number));
     index += 2;
-    mb_get_binary_int(true, &buffer[index], &(snippetbackscatteringstrengthdata->begin_sample));
+    mb_get_binary_int_inline(true, &buffer[index], &(snippetbackscatteringstrengthdata->begin_sample));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(snippetbackscatteringstrengthdata->bottom_sample));
+    mb_get_binary_int_inline(true, &buffer[index], &(snippetbackscatteringstrengthdata->bottom_sample));
     index += 4;
-    mb_get_binary_int(true, &buffer[index], &(snippetbackscatteringstrengthdata->end_sample));
+    mb_get_binary_int_inline(true, &buffer[index], &(snippetbackscatteringstrengthdata->end_sample));
     index += 4;
 
     /* allocate memory for snippettimeseries if needed */
@@ -7734,7 +7712,7 @@ int mbr_reson7k3_rd_SnippetBackscatteringStrength(int verbose, char *buffer, voi
           j < (snippetbackscatteringstrengthdata->end_sample
             - snippetbackscatteringstrengthdata->begin_sample + 1);
           j++) {
-        mb_get_binary_float(true, &buffer[index], &(snippetbackscatteringstrengthdata->bs[j]));
+        mb_get_binary_float_inline(true, &buffer[index], &(snippetbackscatteringstrengthdata->bs[j]));
         index += 4;
       }
     }
@@ -7748,7 +7726,7 @@ int mbr_reson7k3_rd_SnippetBackscatteringStrength(int verbose, char *buffer, voi
             j < (snippetbackscatteringstrengthdata->end_sample
               - snippetbackscatteringstrengthdata->begin_sample + 1);
             j++) {
-          mb_get_binary_float(true, &buffer[index], &(snippetbackscatteringstrengthdata->footprints[j]));
+          mb_get_binary_float_inline(true, &buffer[index], &(snippetbackscatteringstrengthdata->footprints[j]));
           index += 4;
         }
       }
@@ -9726,7 +9704,7 @@ int mbr_reson7k3_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
       /* if FileCatalog has been read then set file pointer to read the next
           record header on the sorted list of records */
       if (store->FileCatalog_read.n > 0 && *icatalog < store->FileCatalog_read.n) {
-        fseek(mb_io_ptr->mbfp, store->FileCatalog_read.filecatalogdata[*icatalog].offset, SEEK_SET);
+        mb_fileio_seek(verbose, mbio_ptr, store->FileCatalog_read.filecatalogdata[*icatalog].offset, SEEK_SET, error);
         (*icatalog)++;
       }
 
@@ -10628,10 +10606,10 @@ Have a nice day...:                              %4.4X | %d\n", store->type, sto
             && store->FileHeader.file_catalog_offset > 0
             && mb_io_ptr->mbfp != NULL) {
           // save current file location
-          int fpos_current = ftell(mb_io_ptr->mbfp);
+          int fpos_current = mb_fileio_tell(verbose, mbio_ptr);
 
           // move to start of FileCatalog record
-          /* int fstatus = */ fseek(mb_io_ptr->mbfp, store->FileHeader.file_catalog_offset, SEEK_SET);
+          /* int fstatus = */ mb_fileio_seek(verbose, mbio_ptr, store->FileHeader.file_catalog_offset, SEEK_SET, error);
 
           // Most of the time the FileHeader.file_catalog_size value is the size
           // of the entire FileCatalog record as per the format spec, but sometimes
@@ -10682,7 +10660,7 @@ Have a nice day...:                              %4.4X | %d\n", store->type, sto
           store->type = R7KRECID_FileHeader;
 
           // reset file position
-          /* fstatus = */ fseek(mb_io_ptr->mbfp, fpos_current, SEEK_SET);
+          /* fstatus = */ mb_fileio_seek(verbose, mbio_ptr, fpos_current, SEEK_SET, error);
           *icatalog = 1;
 
         }
@@ -10846,9 +10824,9 @@ Have a nice day...:                              %4.4X | %d\n", store->type, sto
   /* get file position - check file and socket, use appropriate ftell */
   if (mb_io_ptr->mbfp != NULL) {
        if (*save_flag)
-          mb_io_ptr->file_bytes = ftell(mb_io_ptr->mbfp) - *size;
+          mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr) - *size;
       else
-          mb_io_ptr->file_bytes = ftell(mb_io_ptr->mbfp);
+          mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr);
   }
 #ifdef MBTRN_ENABLED
   else if (mb_io_ptr->mbsp != NULL) {
@@ -10953,7 +10931,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       // add position (clear old data from other sources if needed)
       if (*asynch_source_nav != MB_DATA_NAV) {
         *asynch_source_nav = MB_DATA_NAV;
-        mb_io_ptr->nfix = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_fix, error);
       }
       mb_navint_add(verbose, mbio_ptr, store->time_d,
                       (double)(RTD * Navigation->longitude),
@@ -10962,7 +10940,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       // add heading (clear old data from other sources if needed)
       if (*asynch_source_heading != MB_DATA_NAV) {
         *asynch_source_heading = MB_DATA_NAV;
-        mb_io_ptr->nheading = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_heading, error);
       }
       mb_hedint_add(verbose, mbio_ptr, (double)(store->time_d),
                     (double)(RTD * Navigation->heading), error);
@@ -10981,7 +10959,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       // add attitude (clear old data from other sources if needed)
       if (*asynch_source_attitude != MB_DATA_ATTITUDE) {
         *asynch_source_attitude = MB_DATA_ATTITUDE;
-        mb_io_ptr->nattitude = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_attitude, error);
       }
       for (unsigned int i = 0; i < Attitude->n; i++) {
         mb_attint_add(verbose, mbio_ptr, (double)(store->time_d + 0.001 * ((double)Attitude->delta_time[i])),
@@ -10992,7 +10970,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       // add heading (clear old data from other sources if needed)
       if (*asynch_source_heading != MB_DATA_ATTITUDE) {
         *asynch_source_heading = MB_DATA_ATTITUDE;
-        mb_io_ptr->nheading = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_heading, error);
       }
       for (unsigned int i = 0; i < Attitude->n; i++) {
         mb_hedint_add(verbose, mbio_ptr, (double)(store->time_d + 0.001 * ((double)Attitude->delta_time[i])),
@@ -11007,7 +10985,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       // add position (clear old data from other sources if needed)
       if (*asynch_source_nav == MB_DATA_NONE) {
         *asynch_source_nav = MB_DATA_NAV1;
-        mb_io_ptr->nfix = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_fix, error);
       }
       if (*asynch_source_nav == MB_DATA_NAV1) {
         mb_navint_add(verbose, mbio_ptr, store->time_d,
@@ -11030,7 +11008,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       if (*asynch_source_heading == MB_DATA_NONE
           || *asynch_source_heading == MB_DATA_ATTITUDE2) {
         *asynch_source_heading = MB_DATA_HEADING;
-        mb_io_ptr->nheading = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_heading, error);
       }
       if (*asynch_source_heading == MB_DATA_HEADING) {
         mb_hedint_add(verbose, mbio_ptr, (double)(store->time_d),
@@ -11046,7 +11024,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       if (*asynch_source_attitude == MB_DATA_NONE
         || *asynch_source_attitude == MB_DATA_ATTITUDE2) {
         *asynch_source_attitude = MB_DATA_ATTITUDE1;
-        mb_io_ptr->nattitude = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_attitude, error);
       }
       if (*asynch_source_attitude == MB_DATA_ATTITUDE1) {
         mb_attint_add(verbose, mbio_ptr, (double)(store->time_d),
@@ -11063,7 +11041,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       // add attitude (clear old data from other sources if needed)
       if (*asynch_source_attitude == MB_DATA_NONE) {
         *asynch_source_attitude = MB_DATA_ATTITUDE2;
-        mb_io_ptr->nattitude = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_attitude, error);
       }
       if (*asynch_source_attitude == MB_DATA_ATTITUDE2) {
         for (unsigned int i = 0; i < CustomAttitude->n; i++) {
@@ -11079,7 +11057,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       // add heading (clear old data from other sources if needed)
       if (*asynch_source_heading == MB_DATA_NONE) {
         *asynch_source_heading = MB_DATA_ATTITUDE2;
-        mb_io_ptr->nheading = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_heading, error);
       }
       if (*asynch_source_heading == MB_DATA_ATTITUDE2) {
         for (unsigned int i = 0; i < CustomAttitude->n; i++) {
@@ -11097,7 +11075,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       // add sensordepth (clear old data from other sources if needed)
       if (*asynch_source_sensordepth != MB_DATA_SENSORDEPTH) {
         *asynch_source_sensordepth = MB_DATA_SENSORDEPTH;
-        mb_io_ptr->nsensordepth = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_sensordepth, error);
       }
       if (*asynch_source_sensordepth == MB_DATA_SENSORDEPTH) {
         mb_depint_add(verbose, mbio_ptr, (double)(store->time_d),
@@ -11112,7 +11090,7 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       // add altitude (clear old data from other sources if needed)
       if (*asynch_source_altitude == MB_DATA_NONE) {
         *asynch_source_altitude = MB_DATA_ALTITUDE;
-        mb_io_ptr->naltitude = 0;
+        mb_asynch_reset(verbose, &mb_io_ptr->asynch_altitude, error);
       }
       if (*asynch_source_altitude == MB_DATA_ALTITUDE) {
         mb_altint_add(verbose, mbio_ptr, (double)(store->time_d),
@@ -11146,30 +11124,8 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
         preprocess_pars->timestamp_changed = false;
         preprocess_pars->time_d = 0.0;
 
-        preprocess_pars->n_nav = mb_io_ptr->nfix;
-        preprocess_pars->nav_time_d = mb_io_ptr->fix_time_d;
-        preprocess_pars->nav_lon = mb_io_ptr->fix_lon;
-        preprocess_pars->nav_lat = mb_io_ptr->fix_lat;
         preprocess_pars->nav_speed = NULL;
 
-        preprocess_pars->n_sensordepth = mb_io_ptr->nsensordepth;
-        preprocess_pars->sensordepth_time_d = mb_io_ptr->sensordepth_time_d;
-        preprocess_pars->sensordepth_sensordepth = mb_io_ptr->sensordepth_sensordepth;
-
-        preprocess_pars->n_heading = mb_io_ptr->nheading;
-        preprocess_pars->heading_time_d = mb_io_ptr->heading_time_d;
-        preprocess_pars->heading_heading = mb_io_ptr->heading_heading;
-
-        preprocess_pars->n_altitude = mb_io_ptr->naltitude;
-        preprocess_pars->altitude_time_d = mb_io_ptr->altitude_time_d;
-        preprocess_pars->altitude_altitude = mb_io_ptr->altitude_altitude;
-
-        preprocess_pars->n_attitude = mb_io_ptr->nattitude;
-        preprocess_pars->attitude_time_d = mb_io_ptr->attitude_time_d;
-        preprocess_pars->attitude_roll = mb_io_ptr->attitude_roll;
-        preprocess_pars->attitude_pitch = mb_io_ptr->attitude_pitch;
-        preprocess_pars->attitude_heave = mb_io_ptr->attitude_heave;
-
         preprocess_pars->n_soundspeed = 1;
         soundspeed = SonarSettings->sound_velocity;
         preprocess_pars->soundspeed_time_d = &store->time_d;
@@ -11200,14 +11156,27 @@ int mbr_rt_reson7k3(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
         preprocess_pars->head2_offsets_pitch = 0.0;
 
         preprocess_pars->n_kluge = 0;
-      } else {
-        preprocess_pars->n_nav = mb_io_ptr->nfix;
-        preprocess_pars->n_sensordepth = mb_io_ptr->nsensordepth;
-        preprocess_pars->n_heading = mb_io_ptr->nheading;
-        preprocess_pars->n_altitude = mb_io_ptr->naltitude;
-        preprocess_pars->n_attitude = mb_io_ptr->nattitude;
       }
 
+      /* copy the buffered ancilliary data into arrays, which only recopies
+         buffers that have changed since the last ping */
+      double *values = NULL;
+      mb_asynch_unroll(verbose, &mb_io_ptr->asynch_fix, &preprocess_pars->n_nav,
+                       &preprocess_pars->nav_time_d, &values, error);
+      preprocess_pars->nav_lon = values;
+      preprocess_pars->nav_lat = &values[preprocess_pars->n_nav];
+      mb_asynch_unroll(verbose, &mb_io_ptr->asynch_sensordepth, &preprocess_pars->n_sensordepth,
+                       &preprocess_pars->sensordepth_time_d, &preprocess_pars->sensordepth_sensordepth, error);
+      mb_asynch_unroll(verbose, &mb_io_ptr->asynch_heading, &preprocess_pars->n_heading,
+                       &preprocess_pars->heading_time_d, &preprocess_pars->heading_heading, error);
+      mb_asynch_unroll(verbose, &mb_io_ptr->asynch_altitude, &preprocess_pars->n_altitude,
+                       &preprocess_pars->altitude_time_d, &preprocess_pars->altitude_altitude, error);
+      mb_asynch_unroll(verbose, &mb_io_ptr->asynch_attitude, &preprocess_pars->n_attitude,
+                       &preprocess_pars->attitude_time_d, &values, error);
+      preprocess_pars->attitude_heave = values;
+      preprocess_pars->attitude_roll = &values[preprocess_pars->n_attitude];
+      preprocess_pars->attitude_pitch = &values[2 * preprocess_pars->n_attitude];
+
       status = mbsys_reson7k3_preprocess(verbose, mbio_ptr, store_ptr,
                   *platform_ptr, preprocess_pars, error);
     }
@@ -7746,7 +7746,6 @@ int mbr_reson7kr_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
   double *edgetech_time_d;
   double *edgetech_dt;
   double *last_7k_time_d;
-  FILE *mbfp;
   size_t read_len;
   int *current_ping;
   int *last_ping;
@@ -7784,7 +7783,6 @@ int mbr_reson7kr_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
 
   /* get pointer to raw data structure */
   struct mbsys_reson7k_struct *store = (struct mbsys_reson7k_struct *)store_ptr;
-  mbfp = mb_io_ptr->mbfp;
 
   /* get saved values */
   save_flag = (int *)&mb_io_ptr->save_flag;
@@ -8921,9 +8919,9 @@ store->read_beam,store->read_verticaldepth,store->read_tvg,store->read_image);
   /* get file position - check file and socket, use appropriate ftelln */
     if (mb_io_ptr->mbfp != NULL) {
          if (*save_flag)
-            mb_io_ptr->file_bytes = ftell(mbfp) - *size;
+            mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr) - *size;
         else
-            mb_io_ptr->file_bytes = ftell(mbfp);
+            mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr);
     }
 #ifdef MBTRN_ENABLED
     else if (mb_io_ptr->mbsp != NULL) {
@@ -9032,8 +9030,12 @@ int mbr_rt_reson7kr(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
       mb_attint_add(verbose, mbio_ptr, (double)(bluefin->nav[i].position_time), (double)(0.0),
                     (double)(RTD * bluefin->nav[i].roll), (double)(RTD * bluefin->nav[i].pitch), error);
       mb_hedint_add(verbose, mbio_ptr, (double)(bluefin->nav[i].position_time), (double)(RTD * bluefin->nav[i].yaw), error);
-      if (mb_io_ptr->nsensordepth == 0 ||
-          (bluefin->nav[i].depth != mb_io_ptr->sensordepth_sensordepth[mb_io_ptr->nsensordepth - 1])) {
+      double sensordepth_time_d = 0.0;
+      double sensordepth = 0.0;
+      int sensordepth_error = MB_ERROR_NO_ERROR;
+      if (mb_asynch_sample(verbose, &mb_io_ptr->asynch_sensordepth, mb_io_ptr->asynch_sensordepth.nsample - 1,
+                           &sensordepth_time_d, &sensordepth, &sensordepth_error) == MB_FAILURE ||
+          bluefin->nav[i].depth != sensordepth) {
         if (bluefin->nav[i].depth_time <= 0.0)
           bluefin->nav[i].depth_time = bluefin->nav[i].position_time;
         mb_depint_add(verbose, mbio_ptr, (double)(bluefin->nav[i].depth_time), (double)(bluefin->nav[i].depth), error);
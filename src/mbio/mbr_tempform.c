@@ -259,9 +259,9 @@ int mbr_tempform_rd_data(int verbose, void *mbio_ptr, void *store_ptr, int *erro
 
 	/* get file position */
 	if (*save_flag)
-		mb_io_ptr->file_bytes = ftell(mbfp) - *size;
+		mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr) - *size;
 	else
-		mb_io_ptr->file_bytes = ftell(mbfp);
+		mb_io_ptr->file_bytes = mb_fileio_tell(verbose, mbio_ptr);
 
 	if (verbose >= 2) {
 		fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
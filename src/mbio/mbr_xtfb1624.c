@@ -1591,7 +1591,7 @@ int mbr_rt_xtfb1624(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 		store->png_speed = data->pingheader.SensorSpeed;
 
 		/* interpolate attitude if possible */
-		if (mb_io_ptr->nattitude > 1) {
+		if (mb_io_ptr->asynch_attitude.nsample > 1) {
 #ifdef JRBENTH
 			/* time tag is on receive;  average reception is closer
 		to the midpoint of the two way travel time
@@ -1609,9 +1609,15 @@ int mbr_rt_xtfb1624(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 			mb_attint_interp(verbose, mbio_ptr, timetag, &(store->png_heave), &(store->png_roll), &(store->png_pitch), error);
 			mb_hedint_interp(verbose, mbio_ptr, timetag, &(store->png_heading), error);
 #ifdef MBR_XTFB1624_DEBUG
-			fprintf(stderr, "roll: %d %f %f %f %f   latency:%f time:%f %f roll:%f\n", mb_io_ptr->nattitude,
-			        mb_io_ptr->attitude_time_d[0], mb_io_ptr->attitude_time_d[mb_io_ptr->nattitude - 1],
-			        mb_io_ptr->attitude_roll[0], mb_io_ptr->attitude_roll[mb_io_ptr->nattitude - 1], store->png_latency,
+			/* each attitude sample holds heave, roll and pitch */
+			double time_first, time_last;
+			double attitude_first[3];
+			double attitude_last[3];
+			mb_asynch_sample(verbose, &mb_io_ptr->asynch_attitude, 0, &time_first, attitude_first, error);
+			mb_asynch_sample(verbose, &mb_io_ptr->asynch_attitude, mb_io_ptr->asynch_attitude.nsample - 1, &time_last,
+			                 attitude_last, error);
+			fprintf(stderr, "roll: %d %f %f %f %f   latency:%f time:%f %f roll:%f\n", mb_io_ptr->asynch_attitude.nsample,
+			        time_first, time_last, attitude_first[1], attitude_last[1], store->png_latency,
 			        (double)(0.001 * data->pingheader.AttitudeTimeTag), timetag, store->png_roll);
 #endif
 #endif
@@ -1624,7 +1630,7 @@ int mbr_rt_xtfb1624(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 		}
 
 		/* interpolate nav if possible */
-		if (mb_io_ptr->nfix > 0) {
+		if (mb_io_ptr->asynch_fix.nsample > 0) {
 			mb_navint_interp(verbose, mbio_ptr, store->png_time_d, store->png_heading, 0.0, &(store->png_longitude),
 			                 &(store->png_latitude), &(store->png_speed), error);
 
@@ -1750,7 +1750,7 @@ int mbr_rt_xtfr8101(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 		store->png_speed = 0.0;
 
 		/* interpolate attitude if possible */
-		if (mb_io_ptr->nattitude > 1) {
+		if (mb_io_ptr->asynch_attitude.nsample > 1) {
 			/* time tag is on receive;  average reception is closer
 		to the midpoint of the two way travel time
 		but will vary on beam angle and water depth
@@ -1767,9 +1767,13 @@ int mbr_rt_xtfr8101(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 			mb_attint_interp(verbose, mbio_ptr, timetag, &(store->png_heave), &(store->png_roll), &(store->png_pitch), error);
 			mb_hedint_interp(verbose, mbio_ptr, timetag, &(store->png_heading), error);
 #ifdef MBR_XTFR8101_DEBUG
-			fprintf(stderr, "roll: %d %f %f %f %f   latency:%f time:%f %f roll:%f\n", mb_io_ptr->nattitude,
-			        mb_io_ptr->attitude_time_d[0], mb_io_ptr->attitude_time_d[mb_io_ptr->nattitude - 1],
-			        mb_io_ptr->attitude_roll[0], mb_io_ptr->attitude_roll[mb_io_ptr->nattitude - 1], store->png_latency,
+			double attitude_first[4];
+			double attitude_last[4];
+			mb_asynch_sample(verbose, &mb_io_ptr->asynch_attitude, 0, &attitude_first[0], &attitude_first[1], error);
+			mb_asynch_sample(verbose, &mb_io_ptr->asynch_attitude, mb_io_ptr->asynch_attitude.nsample - 1, &attitude_last[0],
+			                 &attitude_last[1], error);
+			fprintf(stderr, "roll: %d %f %f %f %f   latency:%f time:%f %f roll:%f\n", mb_io_ptr->asynch_attitude.nsample,
+			        attitude_first[0], attitude_last[0], attitude_first[2], attitude_last[2], store->png_latency,
 			        (double)(0.001 * data->bathheader.AttitudeTimeTag), timetag, store->png_roll);
 #endif
 		}
@@ -1781,7 +1785,7 @@ int mbr_rt_xtfr8101(int verbose, void *mbio_ptr, void *store_ptr, int *error) {
 		}
 
 		/* interpolate nav if possible */
-		if (mb_io_ptr->nfix > 0) {
+		if (mb_io_ptr->asynch_fix.nsample > 0) {
 			mb_navint_interp(verbose, mbio_ptr, store->png_time_d, store->png_heading, 0.0, &(store->png_longitude),
 			                 &(store->png_latitude), &(store->png_speed), error);
 
@@ -1306,7 +1306,7 @@ int mbsys_hysweep_extract(int verbose, void *mbio_ptr, void *store_ptr, int *kin
 
 		/* get interpolated nav heading and speed  */
 		*speed = 0.0;
-		if (mb_io_ptr->nfix > 0)
+		if (mb_io_ptr->asynch_fix.nsample > 0)
 			mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
 		/* get heading */
@@ -1409,12 +1409,12 @@ int mbsys_hysweep_extract(int verbose, void *mbio_ptr, void *store_ptr, int *kin
 		*time_d = store->time_d;
 
 		/* get heading */
-		if (mb_io_ptr->nheading > 0)
+		if (mb_io_ptr->asynch_heading.nsample > 0)
 			mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
 		/* get nav and speed */
 		*speed = 0.0;
-		if (mb_io_ptr->nfix > 0)
+		if (mb_io_ptr->asynch_fix.nsample > 0)
 			mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
 		/* get navigation - actually return the easting northing because
@@ -1998,7 +1998,7 @@ int mbsys_hysweep_extract_altitude(int verbose, void *mbio_ptr, void *store_ptr,
 
 		/* get altitude */
 		bool altitude_found = false;
-		if (mb_io_ptr->naltitude > 0) {
+		if (mb_io_ptr->asynch_altitude.nsample > 0) {
 			mb_altint_interp(verbose, mbio_ptr, store->time_d, altitudev, error);
 			altitude_found = true;
 		}
@@ -2084,7 +2084,7 @@ int mbsys_hysweep_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
 		/* get interpolated nav heading and speed  */
 		*speed = 0.0;
-		if (mb_io_ptr->nfix > 0)
+		if (mb_io_ptr->asynch_fix.nsample > 0)
 			mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
 		/* get navigation - actually return the easting northing because
@@ -2112,12 +2112,12 @@ int mbsys_hysweep_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 		*time_d = store->time_d;
 
 		/* get heading */
-		if (mb_io_ptr->nheading > 0)
+		if (mb_io_ptr->asynch_heading.nsample > 0)
 			mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
 		/* get speed */
 		*speed = 0.0;
-		if (mb_io_ptr->nfix > 0)
+		if (mb_io_ptr->asynch_fix.nsample > 0)
 			mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
 		/* get navigation - actually return the easting northing because
@@ -2127,13 +2127,13 @@ int mbsys_hysweep_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 		*navlat = store->POS_y;
 
 		/* get roll pitch and heave */
-		if (mb_io_ptr->nattitude > 0) {
+		if (mb_io_ptr->asynch_attitude.nsample > 0) {
 			mb_attint_interp(verbose, mbio_ptr, *time_d, heave, roll, pitch, error);
 		}
 
 		/* get draft  */
-		if (mb_io_ptr->nsensordepth > 0) {
-			if (mb_io_ptr->nsensordepth > 0)
+		if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
+			if (mb_io_ptr->asynch_sensordepth.nsample > 0)
 				mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
 			*heave = 0.0;
 		}
@@ -2150,12 +2150,12 @@ int mbsys_hysweep_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 		*time_d = store->time_d;
 
 		/* get heading */
-		if (mb_io_ptr->nheading > 0)
+		if (mb_io_ptr->asynch_heading.nsample > 0)
 			mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
 		/* get position and speed */
 		*speed = 0.0;
-		if (mb_io_ptr->nfix > 0)
+		if (mb_io_ptr->asynch_fix.nsample > 0)
 			mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
 		/* get roll pitch and heave */
@@ -2164,8 +2164,8 @@ int mbsys_hysweep_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 		*heave = store->HCP_heave;
 
 		/* get draft  */
-		if (mb_io_ptr->nsensordepth > 0) {
-			if (mb_io_ptr->nsensordepth > 0)
+		if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
+			if (mb_io_ptr->asynch_sensordepth.nsample > 0)
 				mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
 			*heave = 0.0;
 		}
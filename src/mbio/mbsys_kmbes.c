@@ -2052,13 +2052,13 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
     *speed = 3.6 * spo->sensorData.speedOverGround_mPerSec;
 
     /* get heading */
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, *time_d, heading, error);
     else
       *heading = spo->sensorData.courseOverGround_deg;
   
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, *time_d, draft, error);
       *heave = 0.0;
     } else {
@@ -2066,7 +2066,7 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
     }
 
     /* get roll pitch and heave */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, *time_d, heave, roll, pitch, error);
     } else {
       *roll = xmt->xmtPingInfo.roll;
@@ -2098,7 +2098,7 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
     *heading = skm->sample[0].KMdefault.heading_deg;
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, *time_d, draft, error);
       *heave = 0.0;
     } else {
@@ -2128,13 +2128,13 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
     *speed = 3.6 * cpo->sensorData.speedOverGround_mPerSec;
  
     /* get heading */
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, *time_d, heading, error);
     else
       *heading = cpo->sensorData.courseOverGround_deg;
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, *time_d, draft, error);
       *heave = 0.0;
     } else {
@@ -2142,7 +2142,7 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
     }
 
     /* get attitude  */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, *time_d, heave, roll, pitch, error);
     }
     else {
@@ -2163,7 +2163,7 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
 
     /* get navigation */
     *speed = 3.6 * xmt->xmtPingInfo.speed;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
     else {
       *navlon = xmt->xmtPingInfo.longitude;
@@ -2171,7 +2171,7 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
     }
 
     /* get heading */
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, *time_d, heading, error);
     else
       *heading = mrz->pingInfo.headingVessel_deg;
@@ -2180,7 +2180,7 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
     *draft = sde->sensorData.depthUsed_m;
 
     /* get attitude  */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, *time_d, heave, roll, pitch, error);
     }
     else {
@@ -2201,7 +2201,7 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
 
     /* get navigation */
     *speed = 3.6 * xmt->xmtPingInfo.speed;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
     else {
       *navlon = xmt->xmtPingInfo.longitude;
@@ -2212,7 +2212,7 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
     *heading = sha->sensorData[0].headingCorrected_deg;
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, *time_d, draft, error);
       *heave = 0.0;
     } else {
@@ -2220,7 +2220,7 @@ int mbsys_kmbes_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int *k
     }
 
     /* get attitude  */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, *time_d, heave, roll, pitch, error);
     }
     else {
@@ -2338,7 +2338,7 @@ int mbsys_kmbes_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int n
       heading[i] = skm->sample[i].KMdefault.heading_deg;
 
       /* get draft  */
-      if (mb_io_ptr->nsensordepth > 0) {
+      if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
         mb_depint_interp(verbose, mbio_ptr, time_d[i], &draft[i], error);
         heave[i] = 0.0;
       } else {
@@ -2376,13 +2376,13 @@ int mbsys_kmbes_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int n
                           &(navlon[i]), &(navlat[i]), &(speed[i]), error);
 
       // get draft from buffered time series
-      if (mb_io_ptr->nsensordepth > 0)
+      if (mb_io_ptr->asynch_sensordepth.nsample > 0)
         mb_depint_interp(verbose, mbio_ptr, time_d[i], &(draft[i]), error);
       else
         draft[i] = 0.0;
 
       /* get roll pitch and heave */
-      if (mb_io_ptr->nattitude > 0) {
+      if (mb_io_ptr->asynch_attitude.nsample > 0) {
         mb_attint_interp(verbose, mbio_ptr, time_d[i], &(heave[i]), &(roll[i]), &(pitch[i]), error);
       }
     }
@@ -5941,7 +5941,7 @@ int mbsys_reson7k_extract(int verbose, void *mbio_ptr, void *store_ptr, int *kin
 
     /* get interpolated nav heading and speed  */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get heading */
@@ -6125,12 +6125,12 @@ int mbsys_reson7k_extract(int verbose, void *mbio_ptr, void *store_ptr, int *kin
     *time_d = store->time_d;
 
     /* get heading */
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
     /* get speed */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get navigation */
@@ -6176,7 +6176,7 @@ int mbsys_reson7k_extract(int verbose, void *mbio_ptr, void *store_ptr, int *kin
 
     /* get speed */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get navigation */
@@ -6223,12 +6223,12 @@ int mbsys_reson7k_extract(int verbose, void *mbio_ptr, void *store_ptr, int *kin
     /* get heading */
     if (fsdwsegyheader->heading != 0)
       *heading = 0.01 * fsdwsegyheader->heading;
-    else if (mb_io_ptr->nheading > 0)
+    else if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
     /* get speed and position */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get position */
@@ -6280,7 +6280,7 @@ int mbsys_reson7k_extract(int verbose, void *mbio_ptr, void *store_ptr, int *kin
     /* get heading */
     if (fsdwssheader->heading != 0)
       *heading = 0.01 * fsdwssheader->heading;
-    else if (mb_io_ptr->nheading > 0)
+    else if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
     /* get speed and position */
@@ -6775,7 +6775,7 @@ int mbsys_reson7k_ttimes(int verbose, void *mbio_ptr, void *store_ptr, int *kind
     if (bathymetry->optionaldata) {
       heave_use = bathymetry->heave;
     }
-    else if (mb_io_ptr->nattitude > 0) {
+    else if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, store->time_d, &heave_use, &roll, &pitch, error);
     }
 
@@ -6784,7 +6784,7 @@ int mbsys_reson7k_ttimes(int verbose, void *mbio_ptr, void *store_ptr, int *kind
       *draft = -bathymetry->vehicle_height + reference->water_z;
       heave_use = 0.0;
     }
-    else if (mb_io_ptr->nsensordepth > 0) {
+    else if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
       heave_use = 0.0;
     }
@@ -7040,10 +7040,10 @@ int mbsys_reson7k_extract_altitude(int verbose, void *mbio_ptr, void *store_ptr,
     if (bathymetry->optionaldata) {
       *transducer_depth = -bathymetry->vehicle_height + reference->water_z;
     }
-    else if (mb_io_ptr->nsensordepth > 0) {
+    else if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, transducer_depth, error);
     }
-    else if (mb_io_ptr->nattitude > 0) {
+    else if (mb_io_ptr->asynch_attitude.nsample > 0) {
       *transducer_depth = reference->water_z;
       mb_attint_interp(verbose, mbio_ptr, store->time_d, &heave, &roll, &pitch, error);
       *transducer_depth += heave;
@@ -7054,7 +7054,7 @@ int mbsys_reson7k_extract_altitude(int verbose, void *mbio_ptr, void *store_ptr,
 
     /* get altitude */
     bool altitude_found = false;
-    if (mb_io_ptr->naltitude > 0) {
+    if (mb_io_ptr->asynch_altitude.nsample > 0) {
       mb_altint_interp(verbose, mbio_ptr, store->time_d, altitudev, error);
       altitude_found = true;
     }
@@ -7180,9 +7180,9 @@ int mbsys_reson7k_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get interpolated nav heading and speed  */
     *speed = 0.0;
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get heading */
@@ -7193,7 +7193,7 @@ int mbsys_reson7k_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
       *navlat = RTD * bathymetry->latitude;
 
       *draft = -bathymetry->vehicle_height + reference->water_z;
-    } else if (mb_io_ptr->nsensordepth > 0) {
+    } else if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
     } else {
       *draft = reference->water_z;
@@ -7206,7 +7206,7 @@ int mbsys_reson7k_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
       *heave = bathymetry->heave;
     }
     else {
-      if (mb_io_ptr->nattitude > 0) {
+      if (mb_io_ptr->asynch_attitude.nsample > 0) {
         mb_attint_interp(verbose, mbio_ptr, store->time_d, heave, roll, pitch, error);
       }
     }
@@ -7226,22 +7226,22 @@ int mbsys_reson7k_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get navigation and heading */
     *speed = 0.0;
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
     *navlon = RTD * position->longitude;
     *navlat = RTD * position->latitude;
 
     /* get roll pitch and heave */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, *time_d, heave, roll, pitch, error);
     }
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       // TODO(schwehr): Was something else intended in the if?
-      // if (mb_io_ptr->nsensordepth > 0)
+      // if (mb_io_ptr->asynch_sensordepth.nsample > 0)
         mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
       *heave = 0.0;
     }
@@ -7268,7 +7268,7 @@ int mbsys_reson7k_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get speed */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get navigation */
@@ -7301,13 +7301,13 @@ int mbsys_reson7k_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
     speed[0] = 0.0;
 
     /* get heading */
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
     else if (bathymetry->optionaldata)
       heading[0] = RTD * bathymetry->heading;
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, &(draft[0]), error);
     }
     else if (bathymetry->optionaldata) {
@@ -7318,7 +7318,7 @@ int mbsys_reson7k_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
     }
 
     /* get attitude  */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, store->time_d, &(heave[0]), &(roll[0]), &(pitch[0]), error);
     }
     else if (bathymetry->optionaldata) {
@@ -7353,7 +7353,7 @@ int mbsys_reson7k_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get speed and position */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get position */
@@ -7367,7 +7367,7 @@ int mbsys_reson7k_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
     *pitch = 0.01 * fsdwsegyheader->pitch;
     *heave = 0.0;
 
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, store->time_d, heave, roll, pitch, error);
     }
 
@@ -7393,12 +7393,12 @@ int mbsys_reson7k_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
     /* get heading */
     if (fsdwssheader->heading != 0)
       *heading = 0.01 * fsdwssheader->heading;
-    else if (mb_io_ptr->nheading > 0)
+    else if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
     /* get speed and position */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get position */
@@ -7540,7 +7540,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
       navlat[0] = RTD * bathymetry->latitude;
 
       draft[0] = -bathymetry->vehicle_height + reference->water_z;
-    } else if (mb_io_ptr->nsensordepth > 0) {
+    } else if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, &(draft[0]), error);
     } else {
       draft[0] = reference->water_z;
@@ -7580,7 +7580,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     mb_attint_interp(verbose, mbio_ptr, *time_d, &(heave[0]), &(roll[0]), &(pitch[0]), error);
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, &draft[0], error);
       heave[0] = 0.0;
     }
@@ -7651,13 +7651,13 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     speed[0] = 0.0;
 
     /* get heading */
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
     else if (bathymetry->optionaldata)
       heading[0] = RTD * bathymetry->heading;
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, &(draft[0]), error);
     }
     else if (bathymetry->optionaldata) {
@@ -7668,7 +7668,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     }
 
     /* get attitude  */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, store->time_d, &(heave[0]), &(roll[0]), &(pitch[0]), error);
     }
     else if (bathymetry->optionaldata) {
@@ -7697,7 +7697,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
       /* get interpolated nav heading and speed  */
       speed[iatt] = 0.0;
       heading[iatt] = RTD * attitude->heading[iatt];
-      if (mb_io_ptr->nfix > 0)
+      if (mb_io_ptr->asynch_fix.nsample > 0)
         mb_navint_interp(verbose, mbio_ptr, time_d[iatt], heading[iatt], speed[iatt], &(navlon[iatt]), &(navlat[iatt]), &(speed[iatt]),
                          error);
       else if (bathymetry->optionaldata) {
@@ -7706,7 +7706,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
       }
 
       /* get draft  */
-      if (mb_io_ptr->nsensordepth > 0) {
+      if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
         mb_depint_interp(verbose, mbio_ptr, time_d[iatt], &(draft[iatt]), error);
       }
       else if (bathymetry->optionaldata) {
@@ -7738,11 +7738,11 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     /* get interpolated nav heading and speed  */
     speed[0] = 0.0;
     heading[0] = 0.0;
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, &(heading[0]), error);
     else if (bathymetry->optionaldata)
       heading[0] = RTD * bathymetry->heading;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, heading[0], speed[0], &(navlon[0]), &(navlat[0]), &(speed[0]),
                        error);
     else if (bathymetry->optionaldata) {
@@ -7751,7 +7751,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     }
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, &(draft[0]), error);
     }
     else if (bathymetry->optionaldata) {
@@ -7781,7 +7781,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
       /* get interpolated nav heading and speed  */
       speed[iatt] = 0.0;
       heading[iatt] = RTD * customattitude->heading[iatt];
-      if (mb_io_ptr->nfix > 0)
+      if (mb_io_ptr->asynch_fix.nsample > 0)
         mb_navint_interp(verbose, mbio_ptr, time_d[iatt], heading[iatt], speed[iatt], &(navlon[iatt]), &(navlat[iatt]), &(speed[iatt]),
                          error);
       else if (bathymetry->optionaldata) {
@@ -7790,7 +7790,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
       }
 
       /* get draft  */
-      if (mb_io_ptr->nsensordepth > 0) {
+      if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
         mb_depint_interp(verbose, mbio_ptr, time_d[iatt], &(draft[iatt]), error);
       }
       else if (bathymetry->optionaldata) {
@@ -7822,7 +7822,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     /* get interpolated nav heading and speed  */
     speed[0] = 0.0;
     heading[0] = RTD * headings->heading;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, heading[0], speed[0], &(navlon[0]), &(navlat[0]), &(speed[0]),
                        error);
     else if (bathymetry->optionaldata) {
@@ -7831,7 +7831,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     }
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, &(draft[0]), error);
     }
     else if (bathymetry->optionaldata) {
@@ -7842,7 +7842,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     }
 
     /* get attitude  */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, store->time_d, &(heave[0]), &(roll[0]), &(pitch[0]), error);
     }
     else if (bathymetry->optionaldata) {
@@ -7872,7 +7872,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     /* get interpolated nav heading and speed  */
     speed[0] = 0.0;
     heading[0] = RTD * headings->heading;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, heading[0], speed[0], &(navlon[0]), &(navlat[0]), &(speed[0]),
                        error);
     else if (bathymetry->optionaldata) {
@@ -7881,7 +7881,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     }
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, &(draft[0]), error);
     }
     else if (bathymetry->optionaldata) {
@@ -7892,7 +7892,7 @@ int mbsys_reson7k_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr, int
     }
 
     /* get attitude  */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, store->time_d, &(heave[0]), &(roll[0]), &(pitch[0]), error);
     }
     else if (bathymetry->optionaldata) {
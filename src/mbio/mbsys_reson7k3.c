@@ -6312,7 +6312,7 @@ int mbsys_reson7k3_extract(int verbose, void *mbio_ptr, void *store_ptr, int *ki
 
       /* get nav heading and speed  */
       *speed = 0.0;
-      if (mb_io_ptr->nfix > 0)
+      if (mb_io_ptr->asynch_fix.nsample > 0)
         mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
       /* get Navigation */
@@ -6381,7 +6381,7 @@ int mbsys_reson7k3_extract(int verbose, void *mbio_ptr, void *store_ptr, int *ki
 
       /* get nav heading and speed  */
       *speed = 0.0;
-      if (mb_io_ptr->nfix > 0)
+      if (mb_io_ptr->asynch_fix.nsample > 0)
         mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
       /* get Navigation */
@@ -6533,12 +6533,12 @@ int mbsys_reson7k3_extract(int verbose, void *mbio_ptr, void *store_ptr, int *ki
     *time_d = store->time_d;
 
     /* get heading */
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
     /* get speed */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get Navigation */
@@ -7348,7 +7348,7 @@ int mbsys_reson7k3_extract_altitude(int verbose, void *mbio_ptr, void *store_ptr
 
     /* get altitude */
     bool altitude_found = false;
-    if (mb_io_ptr->naltitude > 0) {
+    if (mb_io_ptr->asynch_altitude.nsample > 0) {
       mb_altint_interp(verbose, mbio_ptr, store->time_d, altitudev, error);
       altitude_found = true;
     }
@@ -7508,7 +7508,7 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
       /* get interpolated nav and speed  */
       *speed = 0.0;
-      if (mb_io_ptr->nfix > 0)
+      if (mb_io_ptr->asynch_fix.nsample > 0)
         mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
       /* get Navigation */
@@ -7547,7 +7547,7 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
       /* get nav heading and speed  */
       *speed = 0.0;
-      if (mb_io_ptr->nfix > 0)
+      if (mb_io_ptr->asynch_fix.nsample > 0)
         mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
       /* get Navigation */
@@ -7583,7 +7583,7 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get Navigation */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
     *navlon = RTD * Navigation->longitude;
     *navlat = RTD * Navigation->latitude;
@@ -7595,12 +7595,12 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
     *heading = 3.6 * Navigation->speed;
 
     /* get roll pitch and heave */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, *time_d, heave, roll, pitch, error);
     }
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
       *heave = 0.0;
     }
@@ -7619,22 +7619,22 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get navigation */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
     *navlon = RTD * Position->longitude_easting;
     *navlat = RTD * Position->latitude_northing;
 
     /* get heading */
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
     /* get roll pitch and heave */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, *time_d, heave, roll, pitch, error);
     }
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
       *heave = 0.0;
     }
@@ -7655,7 +7655,7 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get navigation */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get heading */
@@ -7667,7 +7667,7 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
     *heave = (double)(Attitude->heave[0]);
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
       *heave = 0.0;
     }
@@ -7688,11 +7688,11 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get navigation */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get heading */
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
     /* get roll pitch and heave */
@@ -7701,7 +7701,7 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
     *heave = (double)(RollPitchHeave->heave);
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
       *heave = 0.0;
     }
@@ -7722,7 +7722,7 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get navigation */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get heading */
@@ -7734,7 +7734,7 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
     *heave = (double)(CustomAttitude->heave[0]);
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
       *heave = 0.0;
     }
@@ -7755,19 +7755,19 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get navigation */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get heading */
     *heading = (double)(RTD * Heading->heading);
 
     /* get roll pitch and heave */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, *time_d, heave, roll, pitch, error);
     }
 
     /* get draft  */
-    if (mb_io_ptr->nsensordepth > 0) {
+    if (mb_io_ptr->asynch_sensordepth.nsample > 0) {
       mb_depint_interp(verbose, mbio_ptr, store->time_d, draft, error);
       *heave = 0.0;
     }
@@ -7788,15 +7788,15 @@ int mbsys_reson7k3_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, int
 
     /* get navigation */
     *speed = 0.0;
-    if (mb_io_ptr->nfix > 0)
+    if (mb_io_ptr->asynch_fix.nsample > 0)
       mb_navint_interp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 
     /* get heading */
-    if (mb_io_ptr->nheading > 0)
+    if (mb_io_ptr->asynch_heading.nsample > 0)
       mb_hedint_interp(verbose, mbio_ptr, store->time_d, heading, error);
 
     /* get roll pitch and heave */
-    if (mb_io_ptr->nattitude > 0) {
+    if (mb_io_ptr->asynch_attitude.nsample > 0) {
       mb_attint_interp(verbose, mbio_ptr, *time_d, heave, roll, pitch, error);
     }
 
@@ -7906,7 +7906,7 @@ int mbsys_reson7k3_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr,
 
       // get navigation from buffered time series
       speed[inav] = 0.0;
-      if (mb_io_ptr->nfix > 0) {
+      if (mb_io_ptr->asynch_fix.nsample > 0) {
         mb_navint_interp(verbose, mbio_ptr, time_d[inav], heading[inav], speed[inav],
                           &(navlon[inav]), &(navlat[inav]), &(speed[inav]), error);
       } else {
@@ -7915,7 +7915,7 @@ int mbsys_reson7k3_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr,
       }
 
       // get draft from buffered time series
-      if (mb_io_ptr->nsensordepth > 0)
+      if (mb_io_ptr->asynch_sensordepth.nsample > 0)
         mb_depint_interp(verbose, mbio_ptr, time_d[inav], &(draft[inav]), error);
       else
         draft[inav] = 0.0;
@@ -7946,7 +7946,7 @@ int mbsys_reson7k3_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr,
 
       // get navigation from buffered time series
       speed[inav] = 0.0;
-      if (mb_io_ptr->nfix > 0) {
+      if (mb_io_ptr->asynch_fix.nsample > 0) {
         mb_navint_interp(verbose, mbio_ptr, time_d[inav], heading[inav], speed[inav],
                           &(navlon[inav]), &(navlat[inav]), &(speed[inav]), error);
       } else {
@@ -7955,7 +7955,7 @@ int mbsys_reson7k3_extract_nnav(int verbose, void *mbio_ptr, void *store_ptr,
       }
 
       // get draft from buffered time series
-      if (mb_io_ptr->nsensordepth > 0)
+      if (mb_io_ptr->asynch_sensordepth.nsample > 0)
         mb_depint_interp(verbose, mbio_ptr, time_d[inav], &(draft[inav]), error);
       else
         draft[inav] = 0.0;
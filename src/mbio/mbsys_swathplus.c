@@ -532,7 +532,7 @@ int mbsys_swathplus_extract(int verbose, void *mbio_ptr, void *store_ptr, int *k
 		/* get speed */
 		*heading = sxp_ping->heading;
 		*speed = 0.0;
-		if (mb_io_ptr->nfix > 0) {
+		if (mb_io_ptr->asynch_fix.nsample > 0) {
 			mb_navint_prjinterp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 		}
 
@@ -1309,7 +1309,7 @@ int mbsys_swathplus_extract_nav(int verbose, void *mbio_ptr, void *store_ptr, in
 
 		/* get speed */
 		*speed = 0.0;
-		if (mb_io_ptr->nfix > 0) {
+		if (mb_io_ptr->asynch_fix.nsample > 0) {
 			mb_navint_prjinterp(verbose, mbio_ptr, store->time_d, *heading, *speed, navlon, navlat, speed, error);
 		}
 
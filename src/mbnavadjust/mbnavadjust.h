@@ -115,6 +115,7 @@ MBNAVADJUST_EXTERNAL double mbna_overlap_lat_max;
 MBNAVADJUST_EXTERNAL double mbna_plotx_scale;
 MBNAVADJUST_EXTERNAL double mbna_ploty_scale;
 MBNAVADJUST_EXTERNAL int mbna_misfit_center;
+MBNAVADJUST_EXTERNAL int mbna_misfit_mode;
 MBNAVADJUST_EXTERNAL double mbna_misfit_xscale;
 MBNAVADJUST_EXTERNAL double mbna_misfit_yscale;
 MBNAVADJUST_EXTERNAL double mbna_misfit_offset_x;
@@ -193,6 +194,13 @@ MBNAVADJUST_EXTERNAL struct mbna_project project;
 /* flag to reset all crossings to unanalyzed when a project is opened */
 MBNAVADJUST_EXTERNAL int mbna_reset_crossings;
 
+/* flag to precondition the LSQR inversions by scaling the model columns */
+MBNAVADJUST_EXTERNAL int mbna_invert_precondition;
+
+/* flag to start navigation inversions from the previous solution when only
+   the ties have changed */
+MBNAVADJUST_EXTERNAL int mbna_invert_incremental;
+
 /* function prototype definitions */
 void do_mbnavadjust_init(int argc, char **argv);
 void do_set_controls(void);
@@ -43,6 +43,10 @@
 #include <time.h>
 #include <unistd.h>
 #include <errno.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 
 #include "mb_aux.h"
 #include "mb_define.h"
@@ -1691,6 +1695,8 @@ int mbnavadjust_close_project(int verbose, struct mbna_project *project, int *er
   struct mbna_file *file;
 
   /* deallocate memory and reset values */
+  if (project->section_cache != NULL)
+    mbnavadjust_section_cache_free(verbose, &project->section_cache, error);
   for (int i = 0; i < project->num_files; i++) {
     file = &project->files[i];
     if (file->sections != NULL)
@@ -2613,6 +2619,9 @@ __FILE__, __LINE__, __FUNCTION__, file->block, ifile, isection, section->distanc
         snprintf(deletefile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.tri", project->datadir, ifile, isection-1);
         remove(deletefile);
 
+        snprintf(deletefile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.swb", project->datadir, ifile, isection-1);
+        remove(deletefile);
+
         snprintf(deletefile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71", project->datadir, ifile, isection);
         remove(deletefile);
 
@@ -2628,6 +2637,9 @@ __FILE__, __LINE__, __FUNCTION__, file->block, ifile, isection, section->distanc
         snprintf(deletefile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.tri", project->datadir, ifile, isection);
         remove(deletefile);
 
+        snprintf(deletefile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.swb", project->datadir, ifile, isection);
+        remove(deletefile);
+
         snprintf(deletefile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4dp.mb71", project->datadir, ifile, isection);
         remove(deletefile);
 
@@ -2665,6 +2677,10 @@ __FILE__, __LINE__, __FUNCTION__, file->block, ifile, isection, section->distanc
           snprintf(oldfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.tri", project->datadir, ifile, jsection+1);
           rename(oldfile, newfile);
 
+          snprintf(newfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.swb", project->datadir, ifile, jsection);
+          snprintf(oldfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.swb", project->datadir, ifile, jsection+1);
+          rename(oldfile, newfile);
+
           snprintf(newfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4dp.mb71", project->datadir, ifile, jsection);
           snprintf(oldfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4dp.mb71", project->datadir, ifile, jsection+1);
           rename(oldfile, newfile);
@@ -3132,6 +3148,8 @@ int mbnavadjust_remove_file_by_id(int verbose, struct mbna_project *project,
     remove(deletefile);
     snprintf(deletefile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.tri", project->datadir, ifile, isection);
     remove(deletefile);
+    snprintf(deletefile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.swb", project->datadir, ifile, isection);
+    remove(deletefile);
     snprintf(deletefile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4dp.mb71", project->datadir, ifile, isection);
     remove(deletefile);
     snprintf(deletefile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4dp.mb71.fnv", project->datadir, ifile, isection);
@@ -3167,6 +3185,9 @@ int mbnavadjust_remove_file_by_id(int verbose, struct mbna_project *project,
       snprintf(oldfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.tri", project->datadir, jfile+1, jsection);
       snprintf(newfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.tri", project->datadir, jfile, jsection);
       rename(oldfile, newfile);
+      snprintf(oldfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.swb", project->datadir, jfile+1, jsection);
+      snprintf(newfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4d.mb71.swb", project->datadir, jfile, jsection);
+      rename(oldfile, newfile);
       snprintf(oldfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4dp.mb71", project->datadir, jfile+1, jsection);
       snprintf(newfile, sizeof(mb_path), "%s/nvs_%4.4d_%4.4dp.mb71", project->datadir, jfile, jsection);
       rename(oldfile, newfile);
@@ -3986,308 +4007,196 @@ int mbnavadjust_write_triangles(int verbose, struct mbna_project *project,
 }
 
 /*--------------------------------------------------------------------*/
-int mbnavadjust_section_load(int verbose, struct mbna_project *project,
-           int file_id, int section_id,
-           void **swathraw_ptr, void **swath_ptr, int *error) {
+/* Initialize the contouring structure used for a section */
+static int mbnavadjust_section_swath_init(int verbose, struct mbna_project *project, struct mbna_section *section,
+           int npings, int beams_bath, void **swath_ptr, int *error) {
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
     fprintf(stderr, "dbg2  Input arguments:\n");
     fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
     fprintf(stderr, "dbg2       project:    %p\n", project);
-    fprintf(stderr, "dbg2       file_id:    %d\n", file_id);
-    fprintf(stderr, "dbg2       section_id:       %d\n", section_id);
-    fprintf(stderr, "dbg2       swathraw_ptr:     %p  %p\n", swathraw_ptr, *swathraw_ptr);
-    fprintf(stderr, "dbg2       swath_ptr:  %p  %p\n", swath_ptr, *swath_ptr);
+    fprintf(stderr, "dbg2       section:    %p\n", section);
+    fprintf(stderr, "dbg2       npings:     %d\n", npings);
+    fprintf(stderr, "dbg2       beams_bath: %d\n", beams_bath);
+  }
+
+  /* initialize contour controls */
+  const double tick_len_map = MAX(section->lonmax - section->lonmin, section->latmax - section->latmin) / 500;
+  const double label_hgt_map = MAX(section->lonmax - section->lonmin, section->latmax - section->latmin) / 100;
+  const int contour_algorithm = MB_CONTOUR_TRIANGLES; /* not MB_CONTOUR_OLD;*/
+  const int contour_ncolor = 10;
+  int status = mb_contour_init(verbose, (struct swath **)swath_ptr, npings, beams_bath, contour_algorithm,
+         true, false, false, false, false, project->cont_int, project->col_int, project->tick_int,
+         project->label_int, tick_len_map, label_hgt_map, 0.0, contour_ncolor, 0, NULL, NULL, NULL, 0.0,
+         0.0, 0.0, 0.0, 0, 0, 0.0, 0.0,
+         project->mbnavadjust_plot, project->mbnavadjust_newpen,
+         project->mbnavadjust_setline, project->mbnavadjust_justify_string,
+         project->mbnavadjust_plot_string,
+         error);
+  struct swath *swath = (struct swath *)*swath_ptr;
+  if (swath != NULL) {
+    swath->beams_bath = beams_bath;
+    swath->npings = 0;
+    swath->triangle_scale = project->triangle_scale;
   }
 
-  int status = MB_SUCCESS;
-
-  /* load specified section */
-  if (project->open && project->num_crossings > 0) {
-    /* set section format and path */
-    mb_pathplus path;
-    snprintf(path, sizeof(mb_pathplus), "%s/nvs_%4.4d_%4.4d.mb71", project->datadir, file_id, section_id);
-    mb_pathplus tpath;
-    snprintf(tpath, sizeof(mb_pathplus), "%s/nvs_%4.4d_%4.4d.mb71.tri", project->datadir, file_id, section_id);
-    const int iformat = MBF_MBLDEOIH;
-    struct mbna_file *file = &(project->files[file_id]);
-    struct mbna_section *section = &(file->sections[section_id]);
-
-    void *imbio_ptr = NULL;
-    const int pings = 1;
-    const int lonflip = 0;
-    double bounds[4] = {-360, 360, -90, 90};
-    int btime_i[7] = {1962, 2, 21, 10, 30, 0, 0};
-    int etime_i[7] = {2062, 2, 21, 10, 30, 0, 0};
-    double btime_d = -248016600.0;
-    double etime_d = 2907743400.0;
-    double speedmin = 0.0;
-    double timegap = 1000000000.0;
-    int beams_bath;
-    int beams_amp;
-    int pixels_ss;
-
-    if ((status = mb_read_init(verbose, path, iformat, pings, lonflip, bounds, btime_i, etime_i, speedmin, timegap,
-             &imbio_ptr, &btime_d, &etime_d, &beams_bath, &beams_amp, &pixels_ss, error)) != MB_SUCCESS) {
-      char *error_message;
-      mb_error(verbose, *error, &error_message);
-      fprintf(stderr, "\nMBIO Error returned from function <mb_read_init>:\n%s\n", error_message);
-      fprintf(stderr, "\nSwath sonar File <%s> not initialized for reading\n", path);
-      exit(0); // TODO(schwehr): Use EXIT_FAILURE
-    }
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       swath_ptr:   %p\n", *swath_ptr);
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
 
-    char *beamflag = NULL;
-    double *bath = NULL;
-    double *amp = NULL;
-    double *bathacrosstrack = NULL;
-    double *bathalongtrack = NULL;
-    double *ss = NULL;
-    double *ssacrosstrack = NULL;
-    double *ssalongtrack = NULL;
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+/* Compact section files (nvs_FFFF_SSSS.mb71.swb) hold the soundings of a
+   section as they are held in memory - a header, the ping records, and
+   then the bathymetry, acrosstrack, alongtrack and beamflag values of all
+   pings as contiguous arrays. The file is mapped into memory and the
+   pingraws pointed into it, so loading a section does not require
+   parsing the section file. The file is written in the byte order of the
+   host and is regenerated whenever it does not match the host or the
+   section file it was made from. */
+
+#define MBNA_SECTION_FILE_TAG 73776174
+#define MBNA_SECTION_FILE_VERSION_MAJOR 1
+#define MBNA_SECTION_FILE_VERSION_MINOR 0
+
+struct mbna_section_file_header {
+  int tag;
+  unsigned short version_major;
+  unsigned short version_minor;
+  int npings;
+  int beams_bath;
+  int nbeams;
+  int unused;
+  int64_t source_size;
+  int64_t source_mtime;
+};
+
+struct mbna_section_file_ping {
+  double time_d;
+  double navlon;
+  double navlat;
+  double heading;
+  double draft;
+  int time_i[7];
+  int beams_bath;
+};
 
-    /* allocate memory for data arrays */
-    if (status == MB_SUCCESS) {
-      if (*error == MB_ERROR_NO_ERROR)
-        status =
-          mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char), (void **)&beamflag, error);
-      if (*error == MB_ERROR_NO_ERROR)
-        status =
-          mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bath, error);
-      if (*error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double), (void **)&amp, error);
-      if (*error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double),
-                 (void **)&bathacrosstrack, error);
-      if (*error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double),
-                 (void **)&bathalongtrack, error);
-      if (*error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ss, error);
-      if (*error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssacrosstrack,
-                 error);
-      if (*error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssalongtrack,
-                 error);
+/*--------------------------------------------------------------------*/
+static int mbnavadjust_section_write_compact(int verbose, struct mbna_project *project, int file_id, int section_id,
+                                             void *swathraw_ptr, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:      %d\n", verbose);
+    fprintf(stderr, "dbg2       project:      %p\n", project);
+    fprintf(stderr, "dbg2       file_id:      %d\n", file_id);
+    fprintf(stderr, "dbg2       section_id:   %d\n", section_id);
+    fprintf(stderr, "dbg2       swathraw_ptr: %p\n", swathraw_ptr);
+  }
 
-      /* if error initializing memory then don't read the file */
-      if (*error != MB_ERROR_NO_ERROR) {
-        char *error_message;
-        mb_error(verbose, *error, &error_message);
-        fprintf(stderr, "\nMBIO Error allocating data arrays:\n%s\n", error_message);
-      }
-    }
+  int status = MB_SUCCESS;
+  *error = MB_ERROR_NO_ERROR;
+  struct mbna_swathraw *swathraw = (struct mbna_swathraw *)swathraw_ptr;
 
-    struct mbna_swathraw *swathraw;
-    struct mbna_pingraw *pingraw;
-    struct swath *swath;
-    int contour_algorithm = MB_CONTOUR_TRIANGLES; /* not MB_CONTOUR_OLD;*/
+  mb_pathplus path;
+  snprintf(path, sizeof(mb_pathplus), "%s/nvs_%4.4d_%4.4d.mb71", project->datadir, file_id, section_id);
+  mb_pathplus spath;
+  snprintf(spath, sizeof(mb_pathplus), "%s/nvs_%4.4d_%4.4d.mb71.swb", project->datadir, file_id, section_id);
+  mb_pathplusplus tmppath;
 
-    /* allocate memory for data arrays */
-    if (status == MB_SUCCESS) {
-      /* get mb_io_ptr */
-      // struct mb_io_struct *imb_io_ptr = (struct mb_io_struct *)imbio_ptr;
-
-      /* initialize data storage */
-      status = mb_mallocd(verbose, __FILE__, __LINE__, sizeof(struct mbna_swathraw), (void **)swathraw_ptr, error);
-      swathraw = (struct mbna_swathraw *)*swathraw_ptr;
-      swathraw->beams_bath = beams_bath;
-      swathraw->npings_max = section->num_pings;
-      swathraw->npings = 0;
-      status = mb_mallocd(verbose, __FILE__, __LINE__, section->num_pings * sizeof(struct mbna_pingraw),
-              (void **)&swathraw->pingraws, error);
-      for (int i = 0; i < swathraw->npings_max; i++) {
-        pingraw = &swathraw->pingraws[i];
-        pingraw->beams_bath = 0;
-        pingraw->beamflag = NULL;
-        pingraw->bath = NULL;
-        pingraw->bathacrosstrack = NULL;
-        pingraw->bathalongtrack = NULL;
-      }
+  struct stat file_status;
+  if (swathraw == NULL || stat(path, &file_status) != 0) {
+    *error = MB_ERROR_OPEN_FAIL;
+    status = MB_FAILURE;
+  }
 
-      /* initialize contour controls */
-      const double tick_len_map = MAX(section->lonmax - section->lonmin, section->latmax - section->latmin) / 500;
-      const double label_hgt_map = MAX(section->lonmax - section->lonmin, section->latmax - section->latmin) / 100;
-      const int contour_ncolor = 10;
-      status = mb_contour_init(verbose, (struct swath **)swath_ptr, section->num_pings, beams_bath, contour_algorithm,
-             true, false, false, false, false, project->cont_int, project->col_int, project->tick_int,
-             project->label_int, tick_len_map, label_hgt_map, 0.0, contour_ncolor, 0, NULL, NULL, NULL, 0.0,
-             0.0, 0.0, 0.0, 0, 0, 0.0, 0.0,
-             project->mbnavadjust_plot, project->mbnavadjust_newpen,
-             project->mbnavadjust_setline, project->mbnavadjust_justify_string,
-             project->mbnavadjust_plot_string,
-             error);
-      swath = (struct swath *)*swath_ptr;
-      swath->beams_bath = beams_bath;
-      swath->npings = 0;
-      swath->triangle_scale = project->triangle_scale;
-
-      /* if error initializing memory then quit */
-      if (*error != MB_ERROR_NO_ERROR) {
-        char *error_message;
-        mb_error(verbose, *error, &error_message);
-        fprintf(stderr, "\nMBIO Error allocating contour control structure:\n%s\n", error_message);
-        fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
-        exit(*error);
+  /* write to a uniquely named temporary file and then rename it so that
+     the compact file is never seen partially written, even when several
+     threads or processes write the same section at once */
+  FILE *sfp = NULL;
+  if (status == MB_SUCCESS) {
+#ifndef _WIN32
+    snprintf(tmppath, sizeof(tmppath), "%s.XXXXXX", spath);
+    const int fd = mkstemp(tmppath);
+    if (fd >= 0) {
+      fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+      if ((sfp = fdopen(fd, "wb")) == NULL) {
+        close(fd);
+        remove(tmppath);
       }
     }
-
-    /* now read the data */
-    if (status == MB_SUCCESS) {
-      struct ping *ping;
-
-      bool done = false;
-      while (!done) {
-        void *istore_ptr = NULL;
-        int kind;
-        int time_i[7];
-        double time_d;
-        double navlon;
-        double navlat;
-        double speed;
-        double heading;
-        double distance;
-        double altitude;
-        double sensordepth;
-        double roll;
-        double pitch;
-        double heave;
-        char comment[MB_COMMENT_MAXLINE];
-
-        /* read the next ping */
-        status = mb_get_all(verbose, imbio_ptr, &istore_ptr, &kind, time_i, &time_d, &navlon, &navlat, &speed,
-                &heading, &distance, &altitude, &sensordepth, &beams_bath, &beams_amp, &pixels_ss, beamflag,
-                bath, amp, bathacrosstrack, bathalongtrack, ss, ssacrosstrack, ssalongtrack, comment, error);
-
-        /* handle successful read */
-        if (status == MB_SUCCESS && kind == MB_DATA_DATA) {
-          /* allocate memory for the raw arrays */
-          pingraw = &swathraw->pingraws[swathraw->npings];
-          status = mb_mallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(char), (void **)&pingraw->beamflag,
-                  error);
-          status = mb_mallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double), (void **)&pingraw->bath,
-                  error);
-          status = mb_mallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
-                  (void **)&pingraw->bathacrosstrack, error);
-          status = mb_mallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
-                  (void **)&pingraw->bathalongtrack, error);
-
-          /* make sure enough memory is allocated for contouring arrays */
-          ping = &swath->pings[swathraw->npings];
-          if (ping->beams_bath_alloc < beams_bath) {
-            status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(char),
-                     (void **)&(ping->beamflag), error);
-            status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
-                     (void **)&(ping->bath), error);
-            status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
-                     (void **)&(ping->bathlon), error);
-            status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
-                     (void **)&(ping->bathlat), error);
-            if (contour_algorithm == MB_CONTOUR_OLD) {
-              status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(int),
-                       (void **)&(ping->bflag[0]), error);
-              status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(int),
-                       (void **)&(ping->bflag[1]), error);
-            }
-            ping->beams_bath_alloc = beams_bath;
-          }
-
-          /* copy arrays and update bookkeeping */
-          if (*error == MB_ERROR_NO_ERROR) {
-            swathraw->npings++;
-            if (swathraw->npings >= swathraw->npings_max)
-              done = true;
-
-            for (int i = 0; i < 7; i++)
-              pingraw->time_i[i] = time_i[i];
-            pingraw->time_d = time_d;
-            pingraw->navlon = navlon;
-            pingraw->navlat = navlat;
-            pingraw->heading = heading;
-            pingraw->draft = sensordepth;
-            pingraw->beams_bath = beams_bath;
-            /* fprintf(stderr,"\nPING %d : %4.4d/%2.2d/%2.2d %2.2d:%2.2d:%2.2d.%6.6d\n",
-               swathraw->npings,time_i[0],time_i[1],time_i[2],time_i[3],time_i[4],time_i[5],time_i[6]); */
-            for (int i = 0; i < beams_bath; i++) {
-              pingraw->beamflag[i] = beamflag[i];
-              if (mb_beam_ok(beamflag[i])) {
-                pingraw->beamflag[i] = beamflag[i];
-                pingraw->bath[i] = bath[i];
-                pingraw->bathacrosstrack[i] = bathacrosstrack[i];
-                pingraw->bathalongtrack[i] = bathalongtrack[i];
-              }
-              else {
-                pingraw->beamflag[i] = MB_FLAG_NULL;
-                pingraw->bath[i] = 0.0;
-                pingraw->bathacrosstrack[i] = 0.0;
-                pingraw->bathalongtrack[i] = 0.0;
-              }
-              /* fprintf(stderr,"BEAM: %d:%d  Flag:%d    %f %f %f\n",
-                 swathraw->npings,i,pingraw->beamflag[i],pingraw->bath[i],pingraw->bathacrosstrack[i],pingraw->bathalongtrack[i]);
-               */
-            }
-          }
-
-          /* extract all nav values */
-          status = mb_extract_nav(verbose, imbio_ptr, istore_ptr, &kind, pingraw->time_i, &pingraw->time_d,
-                &pingraw->navlon, &pingraw->navlat, &speed, &pingraw->heading, &pingraw->draft, &roll,
-                &pitch, &heave, error);
-
-          /*fprintf(stderr, "%d  %4d/%2d/%2d %2d:%2d:%2d.%6.6d  %15.10f %15.10f %d:%d\n",
-             status,
-             ping->time_i[0],ping->time_i[1],ping->time_i[2],
-             ping->time_i[3],ping->time_i[4],ping->time_i[5],ping->time_i[6],
-             ping->navlon, ping->navlat, beams_bath, swath->beams_bath);*/
-
-          if (verbose >= 2) {
-            fprintf(stderr, "\ndbg2  Ping read in program <%s>\n", program_name);
-            fprintf(stderr, "dbg2       kind:     %d\n", kind);
-            fprintf(stderr, "dbg2       npings:   %d\n", swathraw->npings);
-            fprintf(stderr, "dbg2       time:     %4d %2d %2d %2d %2d %2d %6.6d\n", pingraw->time_i[0],
-              pingraw->time_i[1], pingraw->time_i[2], pingraw->time_i[3], pingraw->time_i[4],
-              pingraw->time_i[5], pingraw->time_i[6]);
-            fprintf(stderr, "dbg2       navigation:     %f  %f\n", pingraw->navlon, pingraw->navlat);
-            fprintf(stderr, "dbg2       beams_bath:     %d\n", beams_bath);
-            fprintf(stderr, "dbg2       beams_amp:      %d\n", beams_amp);
-            fprintf(stderr, "dbg2       pixels_ss:      %d\n", pixels_ss);
-            fprintf(stderr, "dbg2       done:     %d\n", done);
-            fprintf(stderr, "dbg2       error:    %d\n", *error);
-            fprintf(stderr, "dbg2       status:   %d\n", status);
-          }
-        }
-        else if (*error > MB_ERROR_NO_ERROR) {
-          status = MB_SUCCESS;
-          *error = MB_ERROR_NO_ERROR;
-          done = true;
-        }
-      }
-
-      status = mb_close(verbose, &imbio_ptr, error);
+#else
+    snprintf(tmppath, sizeof(tmppath), "%s.%d", spath, (int)getpid());
+    sfp = fopen(tmppath, "wb");
+#endif
+    if (sfp == NULL) {
+      *error = MB_ERROR_OPEN_FAIL;
+      status = MB_FAILURE;
     }
+  }
 
-    // translate the raw swath data to the contouring structure
-    status = mbnavadjust_section_translate(verbose, project, file_id, *swathraw_ptr, *swath_ptr, 0.0, error);
+  if (status == MB_SUCCESS) {
+    struct mbna_section_file_header header;
+    memset(&header, 0, sizeof(header));
+    header.tag = MBNA_SECTION_FILE_TAG;
+    header.version_major = MBNA_SECTION_FILE_VERSION_MAJOR;
+    header.version_minor = MBNA_SECTION_FILE_VERSION_MINOR;
+    header.npings = swathraw->npings;
+    for (int iping = 0; iping < swathraw->npings; iping++) {
+      header.beams_bath = MAX(header.beams_bath, swathraw->pingraws[iping].beams_bath);
+      header.nbeams += swathraw->pingraws[iping].beams_bath;
+    }
+    header.source_size = (int64_t)file_status.st_size;
+    header.source_mtime = (int64_t)file_status.st_mtime;
+    bool ok = fwrite(&header, sizeof(header), 1, sfp) == 1;
 
-    // if all good then try to read existing triangularization
-    if (status == MB_SUCCESS && swath->npings > 0) {
-      status = mbnavadjust_read_triangles(verbose, project, file_id, section_id, swath, error);
+    for (int iping = 0; iping < swathraw->npings && ok; iping++) {
+      struct mbna_pingraw *pingraw = &swathraw->pingraws[iping];
+      struct mbna_section_file_ping ping;
+      memset(&ping, 0, sizeof(ping));
+      ping.time_d = pingraw->time_d;
+      ping.navlon = pingraw->navlon;
+      ping.navlat = pingraw->navlat;
+      ping.heading = pingraw->heading;
+      ping.draft = pingraw->draft;
+      for (int i = 0; i < 7; i++)
+        ping.time_i[i] = pingraw->time_i[i];
+      ping.beams_bath = pingraw->beams_bath;
+      ok = fwrite(&ping, sizeof(ping), 1, sfp) == 1;
+    }
+    for (int iping = 0; iping < swathraw->npings && ok; iping++) {
+      struct mbna_pingraw *pingraw = &swathraw->pingraws[iping];
+      ok = fwrite(pingraw->bath, sizeof(double), pingraw->beams_bath, sfp) == (size_t)pingraw->beams_bath;
+    }
+    for (int iping = 0; iping < swathraw->npings && ok; iping++) {
+      struct mbna_pingraw *pingraw = &swathraw->pingraws[iping];
+      ok = fwrite(pingraw->bathacrosstrack, sizeof(double), pingraw->beams_bath, sfp)
+            == (size_t)pingraw->beams_bath;
+    }
+    for (int iping = 0; iping < swathraw->npings && ok; iping++) {
+      struct mbna_pingraw *pingraw = &swathraw->pingraws[iping];
+      ok = fwrite(pingraw->bathalongtrack, sizeof(double), pingraw->beams_bath, sfp)
+            == (size_t)pingraw->beams_bath;
+    }
+    for (int iping = 0; iping < swathraw->npings && ok; iping++) {
+      struct mbna_pingraw *pingraw = &swathraw->pingraws[iping];
+      ok = fwrite(pingraw->beamflag, sizeof(char), pingraw->beams_bath, sfp) == (size_t)pingraw->beams_bath;
+    }
 
-      // if triangles cannot be read then make triangles and write the triangles out
-      if (status == MB_FAILURE) {
-        status = MB_SUCCESS;
-        *error = MB_ERROR_NO_ERROR;
-        fprintf(stderr, "Creating triangles for %4.4d:%2.2d\n", file_id, section_id);
-        status = mb_triangulate(verbose, swath, error);
-        fprintf(stderr, " - Write triangles for %4.4d:%2.2d - %d pts %d triangles\n",
-          file_id, section_id, swath->npts, swath->ntri);
-        if (status == MB_SUCCESS) {
-          status = mbnavadjust_write_triangles(verbose, project, file_id, section_id, swath, error);
-        }
-      }
-      else {
-        fprintf(stderr, "Read triangles for %4.4d:%2.2d - %d pts %d triangles\n",
-          file_id, section_id, swath->npts, swath->ntri);
-      }
+    if (fclose(sfp) != 0)
+      ok = false;
+    if (ok && rename(tmppath, spath) != 0)
+      ok = false;
+    if (!ok) {
+      remove(tmppath);
+      *error = MB_ERROR_WRITE_FAIL;
+      status = MB_FAILURE;
     }
   }
 
@@ -4301,86 +4210,604 @@ int mbnavadjust_section_load(int verbose, struct mbna_project *project,
 
   return (status);
 }
-
 /*--------------------------------------------------------------------*/
-int mbnavadjust_section_unload(int verbose, void **swathraw_ptr, void **swath_ptr, int *error) {
+static int mbnavadjust_section_map(int verbose, struct mbna_project *project, int file_id, int section_id,
+                                   void **swathraw_ptr, void **swath_ptr, int *error) {
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
     fprintf(stderr, "dbg2  Input arguments:\n");
     fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
-    fprintf(stderr, "dbg2       swathraw_ptr:     %p  %p\n", swathraw_ptr, *swathraw_ptr);
-    fprintf(stderr, "dbg2       swath_ptr:  %p  %p\n", swath_ptr, *swath_ptr);
+    fprintf(stderr, "dbg2       project:    %p\n", project);
+    fprintf(stderr, "dbg2       file_id:    %d\n", file_id);
+    fprintf(stderr, "dbg2       section_id: %d\n", section_id);
   }
 
   int status = MB_SUCCESS;
+  *error = MB_ERROR_NO_ERROR;
+  struct mbna_section *section = &(project->files[file_id].sections[section_id]);
 
-  /* unload specified section */
-  struct mbna_swathraw *swathraw = (struct mbna_swathraw *)(*swathraw_ptr);
-  struct swath *swath = (struct swath *)(*swath_ptr);
+  mb_pathplus path;
+  snprintf(path, sizeof(mb_pathplus), "%s/nvs_%4.4d_%4.4d.mb71", project->datadir, file_id, section_id);
+  mb_pathplus spath;
+  snprintf(spath, sizeof(mb_pathplus), "%s/nvs_%4.4d_%4.4d.mb71.swb", project->datadir, file_id, section_id);
 
-  /* free raw swath data */
-  if (swathraw != NULL && swathraw->pingraws != NULL) {
-    for (int i = 0; i < swathraw->npings_max; i++) {
-      struct mbna_pingraw *pingraw = &swathraw->pingraws[i];
-      status = mb_freed(verbose, __FILE__, __LINE__, (void **)&pingraw->beamflag, error);
-      status = mb_freed(verbose, __FILE__, __LINE__, (void **)&pingraw->bath, error);
-      status = mb_freed(verbose, __FILE__, __LINE__, (void **)&pingraw->bathacrosstrack, error);
-      status = mb_freed(verbose, __FILE__, __LINE__, (void **)&pingraw->bathalongtrack, error);
+  /* check that the compact file exists and was made from the current
+     section file */
+  struct stat file_status;
+  struct stat sfile_status;
+  FILE *sfp = NULL;
+  struct mbna_section_file_header header;
+  size_t mapped_size = 0;
+  if (stat(path, &file_status) != 0 || (sfp = fopen(spath, "rb")) == NULL
+      || fstat(fileno(sfp), &sfile_status) != 0
+      || fread(&header, sizeof(header), 1, sfp) != 1) {
+    *error = MB_ERROR_OPEN_FAIL;
+    status = MB_FAILURE;
+  }
+  else {
+    mapped_size = sizeof(header) + header.npings * sizeof(struct mbna_section_file_ping)
+                  + header.nbeams * (3 * sizeof(double) + sizeof(char));
+    if (header.tag != MBNA_SECTION_FILE_TAG || header.version_major != MBNA_SECTION_FILE_VERSION_MAJOR
+        || header.npings < 0 || header.nbeams < 0
+        || header.source_size != (int64_t)file_status.st_size
+        || header.source_mtime != (int64_t)file_status.st_mtime
+        || (size_t)sfile_status.st_size != mapped_size) {
+      *error = MB_ERROR_BAD_FORMAT;
+      status = MB_FAILURE;
     }
-    status = mb_freed(verbose, __FILE__, __LINE__, (void **)&swathraw->pingraws, error);
   }
-  if (swathraw != NULL)
-    status = mb_freed(verbose, __FILE__, __LINE__, (void **)&swathraw, error);
 
-  /* free contours */
-  status = mb_contour_deall(verbose, swath, error);
+  /* map the file into memory, or read it where mapping is not available -
+     the mapping is private so that the soundings may be modified in memory */
+  void *mapped = NULL;
+  if (status == MB_SUCCESS) {
+#ifndef _WIN32
+    mapped = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(sfp), 0);
+    if (mapped == MAP_FAILED)
+      mapped = NULL;
+#else
+    if ((mapped = malloc(mapped_size)) != NULL) {
+      rewind(sfp);
+      if (fread(mapped, mapped_size, 1, sfp) != 1) {
+        free(mapped);
+        mapped = NULL;
+      }
+    }
+#endif
+    if (mapped == NULL) {
+      *error = MB_ERROR_MEMORY_FAIL;
+      status = MB_FAILURE;
+    }
+  }
+  if (sfp != NULL)
+    fclose(sfp);
+
+  /* check that the ping beam counts are consistent with the header, so a
+     damaged file cannot point the pings outside the mapped arrays - such
+     a file is rejected and the section is read from the section file */
+  if (status == MB_SUCCESS) {
+    const struct mbna_section_file_ping *pings
+        = (struct mbna_section_file_ping *)((char *)mapped + sizeof(header));
+    int64_t nbeams = 0;
+    bool ok = header.beams_bath >= 0;
+    for (int iping = 0; iping < header.npings && ok; iping++) {
+      if (pings[iping].beams_bath < 0 || pings[iping].beams_bath > header.beams_bath)
+        ok = false;
+      nbeams += pings[iping].beams_bath;
+    }
+    if (!ok || nbeams != (int64_t)header.nbeams) {
+#ifndef _WIN32
+      munmap(mapped, mapped_size);
+#else
+      free(mapped);
+#endif
+      mapped = NULL;
+      *error = MB_ERROR_BAD_FORMAT;
+      status = MB_FAILURE;
+    }
+  }
+
+  /* point the pingraws into the mapped arrays */
+  if (status == MB_SUCCESS) {
+    status = mb_mallocd(verbose, __FILE__, __LINE__, sizeof(struct mbna_swathraw), swathraw_ptr, error);
+    struct mbna_swathraw *swathraw = (struct mbna_swathraw *)*swathraw_ptr;
+    swathraw->file_id = file_id;
+    swathraw->beams_bath = header.beams_bath;
+    swathraw->npings_max = MAX(header.npings, 1);
+    swathraw->npings = header.npings;
+    swathraw->mapped = mapped;
+    swathraw->mapped_size = mapped_size;
+    status = mb_mallocd(verbose, __FILE__, __LINE__, swathraw->npings_max * sizeof(struct mbna_pingraw),
+                        (void **)&swathraw->pingraws, error);
+
+    const struct mbna_section_file_ping *pings
+        = (struct mbna_section_file_ping *)((char *)mapped + sizeof(header));
+    double *bath = (double *)&pings[header.npings];
+    double *bathacrosstrack = &bath[header.nbeams];
+    double *bathalongtrack = &bathacrosstrack[header.nbeams];
+    char *beamflag = (char *)&bathalongtrack[header.nbeams];
+    int ibeam = 0;
+    for (int iping = 0; iping < header.npings; iping++) {
+      struct mbna_pingraw *pingraw = &swathraw->pingraws[iping];
+      for (int i = 0; i < 7; i++)
+        pingraw->time_i[i] = pings[iping].time_i[i];
+      pingraw->time_d = pings[iping].time_d;
+      pingraw->navlon = pings[iping].navlon;
+      pingraw->navlat = pings[iping].navlat;
+      pingraw->heading = pings[iping].heading;
+      pingraw->draft = pings[iping].draft;
+      pingraw->beams_bath = pings[iping].beams_bath;
+      pingraw->bath = &bath[ibeam];
+      pingraw->bathacrosstrack = &bathacrosstrack[ibeam];
+      pingraw->bathalongtrack = &bathalongtrack[ibeam];
+      pingraw->beamflag = &beamflag[ibeam];
+      ibeam += pings[iping].beams_bath;
+    }
+
+    /* initialize contour controls - every ping of the contouring
+       structure is allocated for the largest ping of the section */
+    status = mbnavadjust_section_swath_init(verbose, project, section, swathraw->npings_max, header.beams_bath,
+                                             swath_ptr, error);
+
+    /* if error initializing memory then quit */
+    if (*error != MB_ERROR_NO_ERROR) {
+      char *error_message;
+      mb_error(verbose, *error, &error_message);
+      fprintf(stderr, "\nMBIO Error allocating contour control structure:\n%s\n", error_message);
+      fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+      exit(*error);
+    }
+  }
 
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
     fprintf(stderr, "dbg2  Return values:\n");
-    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2       swathraw_ptr: %p\n", *swathraw_ptr);
+    fprintf(stderr, "dbg2       swath_ptr:    %p\n", *swath_ptr);
+    fprintf(stderr, "dbg2       error:        %d\n", *error);
     fprintf(stderr, "dbg2  Return status:\n");
-    fprintf(stderr, "dbg2       status:      %d\n", status);
+    fprintf(stderr, "dbg2       status:       %d\n", status);
   }
 
   return (status);
 }
-
 /*--------------------------------------------------------------------*/
-
-int mbnavadjust_fix_section_sensordepth(int verbose, struct mbna_project *project, int *error) {
+/* Read a section file through mbio into the raw swath structure */
+static int mbnavadjust_section_read(int verbose, struct mbna_project *project,
+           int file_id, int section_id,
+           void **swathraw_ptr, void **swath_ptr, int *error) {
   if (verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
     fprintf(stderr, "dbg2  Input arguments:\n");
     fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
     fprintf(stderr, "dbg2       project:    %p\n", project);
+    fprintf(stderr, "dbg2       file_id:    %d\n", file_id);
+    fprintf(stderr, "dbg2       section_id:       %d\n", section_id);
+    fprintf(stderr, "dbg2       swathraw_ptr:     %p  %p\n", swathraw_ptr, *swathraw_ptr);
+    fprintf(stderr, "dbg2       swath_ptr:  %p  %p\n", swath_ptr, *swath_ptr);
   }
 
   int status = MB_SUCCESS;
 
-  /* read specified section, extracting sensordepth values for the snav points */
-  if (project != NULL) {
-    /* mbio read and write values */
-    void *imbio_ptr = NULL;
-    void *istore_ptr = NULL;
-    char *beamflag = NULL;
-    double *bath = NULL;
-    double *bathacrosstrack = NULL;
-    double *bathalongtrack = NULL;
-    double *amp = NULL;
-    double *ss = NULL;
-    double *ssacrosstrack = NULL;
-    double *ssalongtrack = NULL;
-    char comment[MB_COMMENT_MAXLINE];
+  /* set section format and path */
+  mb_pathplus path;
+  snprintf(path, sizeof(mb_pathplus), "%s/nvs_%4.4d_%4.4d.mb71", project->datadir, file_id, section_id);
+  const int iformat = MBF_MBLDEOIH;
+  struct mbna_file *file = &(project->files[file_id]);
+  struct mbna_section *section = &(file->sections[section_id]);
 
-    /* MBIO control parameters */
+  void *imbio_ptr = NULL;
+  const int pings = 1;
+  const int lonflip = 0;
+  double bounds[4] = {-360, 360, -90, 90};
+  int btime_i[7] = {1962, 2, 21, 10, 30, 0, 0};
+  int etime_i[7] = {2062, 2, 21, 10, 30, 0, 0};
+  double btime_d = -248016600.0;
+  double etime_d = 2907743400.0;
+  double speedmin = 0.0;
+  double timegap = 1000000000.0;
+  int beams_bath;
+  int beams_amp;
+  int pixels_ss;
 
-    int isnav;
-    int num_pings;
+  if ((status = mb_read_init(verbose, path, iformat, pings, lonflip, bounds, btime_i, etime_i, speedmin, timegap,
+           &imbio_ptr, &btime_d, &etime_d, &beams_bath, &beams_amp, &pixels_ss, error)) != MB_SUCCESS) {
+    char *error_message;
+    mb_error(verbose, *error, &error_message);
+    fprintf(stderr, "\nMBIO Error returned from function <mb_read_init>:\n%s\n", error_message);
+    fprintf(stderr, "\nSwath sonar File <%s> not initialized for reading\n", path);
+    exit(0); // TODO(schwehr): Use EXIT_FAILURE
+  }
 
-    for (int ifile=0; ifile<project->num_files; ifile++) {
-      struct mbna_file *file = &(project->files[ifile]);
-      for (int isection = 0; isection<file->num_sections; isection++) {
+  char *beamflag = NULL;
+  double *bath = NULL;
+  double *amp = NULL;
+  double *bathacrosstrack = NULL;
+  double *bathalongtrack = NULL;
+  double *ss = NULL;
+  double *ssacrosstrack = NULL;
+  double *ssalongtrack = NULL;
+
+  /* allocate memory for data arrays */
+  if (status == MB_SUCCESS) {
+    if (*error == MB_ERROR_NO_ERROR)
+      status =
+        mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char), (void **)&beamflag, error);
+    if (*error == MB_ERROR_NO_ERROR)
+      status =
+        mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bath, error);
+    if (*error == MB_ERROR_NO_ERROR)
+      status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double), (void **)&amp, error);
+    if (*error == MB_ERROR_NO_ERROR)
+      status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double),
+               (void **)&bathacrosstrack, error);
+    if (*error == MB_ERROR_NO_ERROR)
+      status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double),
+               (void **)&bathalongtrack, error);
+    if (*error == MB_ERROR_NO_ERROR)
+      status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ss, error);
+    if (*error == MB_ERROR_NO_ERROR)
+      status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssacrosstrack,
+               error);
+    if (*error == MB_ERROR_NO_ERROR)
+      status = mb_register_array(verbose, imbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssalongtrack,
+               error);
+
+    /* if error initializing memory then don't read the file */
+    if (*error != MB_ERROR_NO_ERROR) {
+      char *error_message;
+      mb_error(verbose, *error, &error_message);
+      fprintf(stderr, "\nMBIO Error allocating data arrays:\n%s\n", error_message);
+    }
+  }
+
+  struct mbna_swathraw *swathraw;
+  struct mbna_pingraw *pingraw;
+  struct swath *swath;
+  int contour_algorithm = MB_CONTOUR_TRIANGLES; /* not MB_CONTOUR_OLD;*/
+
+  /* allocate memory for data arrays */
+  if (status == MB_SUCCESS) {
+    /* get mb_io_ptr */
+    // struct mb_io_struct *imb_io_ptr = (struct mb_io_struct *)imbio_ptr;
+
+    /* initialize data storage */
+    status = mb_mallocd(verbose, __FILE__, __LINE__, sizeof(struct mbna_swathraw), (void **)swathraw_ptr, error);
+    swathraw = (struct mbna_swathraw *)*swathraw_ptr;
+    swathraw->beams_bath = beams_bath;
+    swathraw->npings_max = section->num_pings;
+    swathraw->npings = 0;
+    swathraw->mapped = NULL;
+    swathraw->mapped_size = 0;
+    status = mb_mallocd(verbose, __FILE__, __LINE__, section->num_pings * sizeof(struct mbna_pingraw),
+            (void **)&swathraw->pingraws, error);
+    for (int i = 0; i < swathraw->npings_max; i++) {
+      pingraw = &swathraw->pingraws[i];
+      pingraw->beams_bath = 0;
+      pingraw->beamflag = NULL;
+      pingraw->bath = NULL;
+      pingraw->bathacrosstrack = NULL;
+      pingraw->bathalongtrack = NULL;
+    }
+
+    /* initialize contour controls */
+    status = mbnavadjust_section_swath_init(verbose, project, section, section->num_pings, beams_bath,
+                                             swath_ptr, error);
+    swath = (struct swath *)*swath_ptr;
+
+    /* if error initializing memory then quit */
+    if (*error != MB_ERROR_NO_ERROR) {
+      char *error_message;
+      mb_error(verbose, *error, &error_message);
+      fprintf(stderr, "\nMBIO Error allocating contour control structure:\n%s\n", error_message);
+      fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+      exit(*error);
+    }
+  }
+
+  /* now read the data */
+  if (status == MB_SUCCESS) {
+    struct ping *ping;
+
+    bool done = false;
+    while (!done) {
+      void *istore_ptr = NULL;
+      int kind;
+      int time_i[7];
+      double time_d;
+      double navlon;
+      double navlat;
+      double speed;
+      double heading;
+      double distance;
+      double altitude;
+      double sensordepth;
+      double roll;
+      double pitch;
+      double heave;
+      char comment[MB_COMMENT_MAXLINE];
+
+      /* read the next ping */
+      status = mb_get_all(verbose, imbio_ptr, &istore_ptr, &kind, time_i, &time_d, &navlon, &navlat, &speed,
+              &heading, &distance, &altitude, &sensordepth, &beams_bath, &beams_amp, &pixels_ss, beamflag,
+              bath, amp, bathacrosstrack, bathalongtrack, ss, ssacrosstrack, ssalongtrack, comment, error);
+
+      /* handle successful read */
+      if (status == MB_SUCCESS && kind == MB_DATA_DATA) {
+        /* allocate memory for the raw arrays */
+        pingraw = &swathraw->pingraws[swathraw->npings];
+        status = mb_mallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(char), (void **)&pingraw->beamflag,
+                error);
+        status = mb_mallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double), (void **)&pingraw->bath,
+                error);
+        status = mb_mallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
+                (void **)&pingraw->bathacrosstrack, error);
+        status = mb_mallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
+                (void **)&pingraw->bathalongtrack, error);
+
+        /* make sure enough memory is allocated for contouring arrays */
+        ping = &swath->pings[swathraw->npings];
+        if (ping->beams_bath_alloc < beams_bath) {
+          status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(char),
+                   (void **)&(ping->beamflag), error);
+          status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
+                   (void **)&(ping->bath), error);
+          status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
+                   (void **)&(ping->bathlon), error);
+          status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
+                   (void **)&(ping->bathlat), error);
+          if (contour_algorithm == MB_CONTOUR_OLD) {
+            status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(int),
+                     (void **)&(ping->bflag[0]), error);
+            status = mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(int),
+                     (void **)&(ping->bflag[1]), error);
+          }
+          ping->beams_bath_alloc = beams_bath;
+        }
+
+        /* copy arrays and update bookkeeping */
+        if (*error == MB_ERROR_NO_ERROR) {
+          swathraw->npings++;
+          if (swathraw->npings >= swathraw->npings_max)
+            done = true;
+
+          for (int i = 0; i < 7; i++)
+            pingraw->time_i[i] = time_i[i];
+          pingraw->time_d = time_d;
+          pingraw->navlon = navlon;
+          pingraw->navlat = navlat;
+          pingraw->heading = heading;
+          pingraw->draft = sensordepth;
+          pingraw->beams_bath = beams_bath;
+          /* fprintf(stderr,"\nPING %d : %4.4d/%2.2d/%2.2d %2.2d:%2.2d:%2.2d.%6.6d\n",
+             swathraw->npings,time_i[0],time_i[1],time_i[2],time_i[3],time_i[4],time_i[5],time_i[6]); */
+          for (int i = 0; i < beams_bath; i++) {
+            pingraw->beamflag[i] = beamflag[i];
+            if (mb_beam_ok(beamflag[i])) {
+              pingraw->beamflag[i] = beamflag[i];
+              pingraw->bath[i] = bath[i];
+              pingraw->bathacrosstrack[i] = bathacrosstrack[i];
+              pingraw->bathalongtrack[i] = bathalongtrack[i];
+            }
+            else {
+              pingraw->beamflag[i] = MB_FLAG_NULL;
+              pingraw->bath[i] = 0.0;
+              pingraw->bathacrosstrack[i] = 0.0;
+              pingraw->bathalongtrack[i] = 0.0;
+            }
+            /* fprintf(stderr,"BEAM: %d:%d  Flag:%d    %f %f %f\n",
+               swathraw->npings,i,pingraw->beamflag[i],pingraw->bath[i],pingraw->bathacrosstrack[i],pingraw->bathalongtrack[i]);
+             */
+          }
+        }
+
+        /* extract all nav values */
+        status = mb_extract_nav(verbose, imbio_ptr, istore_ptr, &kind, pingraw->time_i, &pingraw->time_d,
+              &pingraw->navlon, &pingraw->navlat, &speed, &pingraw->heading, &pingraw->draft, &roll,
+              &pitch, &heave, error);
+
+        /*fprintf(stderr, "%d  %4d/%2d/%2d %2d:%2d:%2d.%6.6d  %15.10f %15.10f %d:%d\n",
+           status,
+           ping->time_i[0],ping->time_i[1],ping->time_i[2],
+           ping->time_i[3],ping->time_i[4],ping->time_i[5],ping->time_i[6],
+           ping->navlon, ping->navlat, beams_bath, swath->beams_bath);*/
+
+        if (verbose >= 2) {
+          fprintf(stderr, "\ndbg2  Ping read in program <%s>\n", program_name);
+          fprintf(stderr, "dbg2       kind:     %d\n", kind);
+          fprintf(stderr, "dbg2       npings:   %d\n", swathraw->npings);
+          fprintf(stderr, "dbg2       time:     %4d %2d %2d %2d %2d %2d %6.6d\n", pingraw->time_i[0],
+            pingraw->time_i[1], pingraw->time_i[2], pingraw->time_i[3], pingraw->time_i[4],
+            pingraw->time_i[5], pingraw->time_i[6]);
+          fprintf(stderr, "dbg2       navigation:     %f  %f\n", pingraw->navlon, pingraw->navlat);
+          fprintf(stderr, "dbg2       beams_bath:     %d\n", beams_bath);
+          fprintf(stderr, "dbg2       beams_amp:      %d\n", beams_amp);
+          fprintf(stderr, "dbg2       pixels_ss:      %d\n", pixels_ss);
+          fprintf(stderr, "dbg2       done:     %d\n", done);
+          fprintf(stderr, "dbg2       error:    %d\n", *error);
+          fprintf(stderr, "dbg2       status:   %d\n", status);
+        }
+      }
+      else if (*error > MB_ERROR_NO_ERROR) {
+        status = MB_SUCCESS;
+        *error = MB_ERROR_NO_ERROR;
+        done = true;
+      }
+    }
+
+    status = mb_close(verbose, &imbio_ptr, error);
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+
+/*--------------------------------------------------------------------*/
+int mbnavadjust_section_load(int verbose, struct mbna_project *project,
+           int file_id, int section_id,
+           void **swathraw_ptr, void **swath_ptr, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       project:    %p\n", project);
+    fprintf(stderr, "dbg2       file_id:    %d\n", file_id);
+    fprintf(stderr, "dbg2       section_id:       %d\n", section_id);
+    fprintf(stderr, "dbg2       swathraw_ptr:     %p  %p\n", swathraw_ptr, *swathraw_ptr);
+    fprintf(stderr, "dbg2       swath_ptr:  %p  %p\n", swath_ptr, *swath_ptr);
+  }
+
+  int status = MB_SUCCESS;
+
+  /* load specified section */
+  if (project->open && project->num_crossings > 0) {
+    /* use the compact copy of the section if it is current, otherwise read
+       the section file and write a compact copy for the next load */
+    status = mbnavadjust_section_map(verbose, project, file_id, section_id, swathraw_ptr, swath_ptr, error);
+    if (status == MB_FAILURE) {
+      *error = MB_ERROR_NO_ERROR;
+      status = mbnavadjust_section_read(verbose, project, file_id, section_id, swathraw_ptr, swath_ptr, error);
+      if (status == MB_SUCCESS) {
+        int error2 = MB_ERROR_NO_ERROR;
+        mbnavadjust_section_write_compact(verbose, project, file_id, section_id, *swathraw_ptr, &error2);
+      }
+    }
+    struct swath *swath = (struct swath *)*swath_ptr;
+
+    // translate the raw swath data to the contouring structure
+    status = mbnavadjust_section_translate(verbose, project, file_id, *swathraw_ptr, *swath_ptr, 0.0, error);
+
+    // if all good then try to read existing triangularization
+    if (status == MB_SUCCESS && swath->npings > 0) {
+      status = mbnavadjust_read_triangles(verbose, project, file_id, section_id, swath, error);
+
+      // if triangles cannot be read then make triangles and write the triangles out
+      if (status == MB_FAILURE) {
+        status = MB_SUCCESS;
+        *error = MB_ERROR_NO_ERROR;
+        fprintf(stderr, "Creating triangles for %4.4d:%2.2d\n", file_id, section_id);
+        status = mb_triangulate(verbose, swath, error);
+        fprintf(stderr, " - Write triangles for %4.4d:%2.2d - %d pts %d triangles\n",
+          file_id, section_id, swath->npts, swath->ntri);
+        if (status == MB_SUCCESS) {
+          status = mbnavadjust_write_triangles(verbose, project, file_id, section_id, swath, error);
+        }
+      }
+      else {
+        fprintf(stderr, "Read triangles for %4.4d:%2.2d - %d pts %d triangles\n",
+          file_id, section_id, swath->npts, swath->ntri);
+      }
+    }
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+
+/*--------------------------------------------------------------------*/
+int mbnavadjust_section_unload(int verbose, void **swathraw_ptr, void **swath_ptr, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       swathraw_ptr:     %p  %p\n", swathraw_ptr, *swathraw_ptr);
+    fprintf(stderr, "dbg2       swath_ptr:  %p  %p\n", swath_ptr, *swath_ptr);
+  }
+
+  int status = MB_SUCCESS;
+
+  /* unload specified section */
+  struct mbna_swathraw *swathraw = (struct mbna_swathraw *)(*swathraw_ptr);
+  struct swath *swath = (struct swath *)(*swath_ptr);
+
+  /* free raw swath data, unmapping the compact section file if the
+     soundings are held there */
+  if (swathraw != NULL && swathraw->mapped != NULL) {
+#ifndef _WIN32
+    munmap(swathraw->mapped, swathraw->mapped_size);
+#else
+    free(swathraw->mapped);
+#endif
+    swathraw->mapped = NULL;
+    swathraw->mapped_size = 0;
+    status = mb_freed(verbose, __FILE__, __LINE__, (void **)&swathraw->pingraws, error);
+  }
+  else if (swathraw != NULL && swathraw->pingraws != NULL) {
+    for (int i = 0; i < swathraw->npings_max; i++) {
+      struct mbna_pingraw *pingraw = &swathraw->pingraws[i];
+      status = mb_freed(verbose, __FILE__, __LINE__, (void **)&pingraw->beamflag, error);
+      status = mb_freed(verbose, __FILE__, __LINE__, (void **)&pingraw->bath, error);
+      status = mb_freed(verbose, __FILE__, __LINE__, (void **)&pingraw->bathacrosstrack, error);
+      status = mb_freed(verbose, __FILE__, __LINE__, (void **)&pingraw->bathalongtrack, error);
+    }
+    status = mb_freed(verbose, __FILE__, __LINE__, (void **)&swathraw->pingraws, error);
+  }
+  if (swathraw != NULL)
+    status = mb_freed(verbose, __FILE__, __LINE__, (void **)&swathraw, error);
+
+  /* free contours */
+  status = mb_contour_deall(verbose, swath, error);
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+
+/*--------------------------------------------------------------------*/
+
+int mbnavadjust_fix_section_sensordepth(int verbose, struct mbna_project *project, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       project:    %p\n", project);
+  }
+
+  int status = MB_SUCCESS;
+
+  /* read specified section, extracting sensordepth values for the snav points */
+  if (project != NULL) {
+    /* mbio read and write values */
+    void *imbio_ptr = NULL;
+    void *istore_ptr = NULL;
+    char *beamflag = NULL;
+    double *bath = NULL;
+    double *bathacrosstrack = NULL;
+    double *bathalongtrack = NULL;
+    double *amp = NULL;
+    double *ss = NULL;
+    double *ssacrosstrack = NULL;
+    double *ssalongtrack = NULL;
+    char comment[MB_COMMENT_MAXLINE];
+
+    /* MBIO control parameters */
+
+    int isnav;
+    int num_pings;
+
+    for (int ifile=0; ifile<project->num_files; ifile++) {
+      struct mbna_file *file = &(project->files[ifile]);
+      for (int isection = 0; isection<file->num_sections; isection++) {
 
         /* set section format and path */
         mb_pathplus path;
@@ -5917,6 +6344,8 @@ int mbnavadjust_reimport_file(int verbose, struct mbna_project *project,
 		  remove(opath);
 		  snprintf(opath, sizeof(mb_path), "%s.tri", spath);
 		  remove(opath);
+		  snprintf(opath, sizeof(mb_path), "%s.swb", spath);
+		  remove(opath);
 		  
 		  /* rename the new section file and make ancilliary files */
 		  snprintf(opath, sizeof(mb_path), "%s/tmp_nvs_%4.4d_%4.4d.mb71", project->datadir, ifile, current_section);
@@ -6061,6 +6490,8 @@ int mbnavadjust_reimport_file(int verbose, struct mbna_project *project,
 		remove(opath);
 		snprintf(opath, sizeof(mb_path), "%s.tri", spath);
 		remove(opath);
+		snprintf(opath, sizeof(mb_path), "%s.swb", spath);
+		remove(opath);
 		
 		/* rename the new section file and make ancilliary files */
 		snprintf(opath, sizeof(mb_path), "%s/tmp_nvs_%4.4d_%4.4d.mb71", project->datadir, ifile, current_section);
@@ -6773,6 +7204,133 @@ int mbnavadjust_findcrossings(int verbose, struct mbna_project *project, int *er
   return (status);
 }
 
+/*--------------------------------------------------------------------*/
+/* Crossing discovery support: sections are placed in a uniform grid by
+   their bounds (with the current navigation offsets applied) so that each
+   section of a file is only compared with sections whose bounds could
+   overlap, and the coverage mask comparisons of the candidate pairs are
+   divided among threads. */
+
+struct mbna_crossing_box {
+  int file;
+  int section;
+  double lonmin;
+  double lonmax;
+  double latmin;
+  double latmax;
+};
+
+struct mbna_crossing_pair {
+  int section_2;
+  int file_1;
+  int section_1;
+  int overlap;
+};
+
+struct mbna_crossing_work {
+  struct mbna_project *project;
+  int ifile;
+  struct mbna_crossing_pair *pairs;
+  int npairs;
+  int ithread;
+  int nthreads;
+};
+
+/* minimum number of candidate pairs for which threads are started */
+#define MBNA_CROSSING_THREAD_MIN 64
+
+/*--------------------------------------------------------------------*/
+static void mbnavadjust_section_bounds(struct mbna_section *section, double *lonmin, double *lonmax, double *latmin,
+                                       double *latmax) {
+  const double lonoffset = section->snav_lon_offset[section->num_snav / 2];
+  const double latoffset = section->snav_lat_offset[section->num_snav / 2];
+  *lonmin = section->lonmin + lonoffset;
+  *lonmax = section->lonmax + lonoffset;
+  *latmin = section->latmin + latoffset;
+  *latmax = section->latmax + latoffset;
+}
+/*--------------------------------------------------------------------*/
+/* return the range of cells along one axis of a coverage mask starting at
+   min with cell size d that may overlap the interval (cmin, cmax) */
+static void mbnavadjust_coverage_range(double min, double d, double cmin, double cmax, int *i0, int *i1) {
+  if (d > 0.0) {
+    *i0 = MAX((int)floor((cmin - min) / d) - 1, 0);
+    *i1 = MIN((int)ceil((cmax - min) / d) + 1, MBNA_MASK_DIM - 1);
+  }
+  else {
+    *i0 = 0;
+    *i1 = MBNA_MASK_DIM - 1;
+  }
+}
+/*--------------------------------------------------------------------*/
+/* check if any covered cell of section2 overlaps a covered cell of section1
+   given the current navigation model */
+static bool mbnavadjust_coverage_overlap(struct mbna_section *section1, struct mbna_section *section2) {
+  double lonmin1, lonmax1, latmin1, latmax1;
+  double lonmin2, lonmax2, latmin2, latmax2;
+  mbnavadjust_section_bounds(section1, &lonmin1, &lonmax1, &latmin1, &latmax1);
+  mbnavadjust_section_bounds(section2, &lonmin2, &lonmax2, &latmin2, &latmax2);
+  const double dx1 = (section1->lonmax - section1->lonmin) / (MBNA_MASK_DIM - 1);
+  const double dy1 = (section1->latmax - section1->latmin) / (MBNA_MASK_DIM - 1);
+  const double dx2 = (section2->lonmax - section2->lonmin) / (MBNA_MASK_DIM - 1);
+  const double dy2 = (section2->latmax - section2->latmin) / (MBNA_MASK_DIM - 1);
+
+  /* for each covered cell of section2 only the cells of section1 near it
+     are checked - the exact comparison is still applied to each */
+  for (int jj2 = 0; jj2 < MBNA_MASK_DIM; jj2++) {
+    const double cell2latmin = latmin2 + jj2 * dy2;
+    const double cell2latmax = latmin2 + (jj2 + 1) * dy2;
+    int jj1min, jj1max;
+    mbnavadjust_coverage_range(latmin1, dy1, cell2latmin, cell2latmax, &jj1min, &jj1max);
+    for (int ii2 = 0; ii2 < MBNA_MASK_DIM; ii2++) {
+      if (section2->coverage[ii2 + jj2 * MBNA_MASK_DIM] != 1)
+        continue;
+      const double cell2lonmin = lonmin2 + ii2 * dx2;
+      const double cell2lonmax = lonmin2 + (ii2 + 1) * dx2;
+      int ii1min, ii1max;
+      mbnavadjust_coverage_range(lonmin1, dx1, cell2lonmin, cell2lonmax, &ii1min, &ii1max);
+      for (int jj1 = jj1min; jj1 <= jj1max; jj1++) {
+        const double cell1latmin = latmin1 + jj1 * dy1;
+        const double cell1latmax = latmin1 + (jj1 + 1) * dy1;
+        if (!(cell2latmin < cell1latmax && cell2latmax > cell1latmin))
+          continue;
+        for (int ii1 = ii1min; ii1 <= ii1max; ii1++) {
+          if (section1->coverage[ii1 + jj1 * MBNA_MASK_DIM] == 1) {
+            const double cell1lonmin = lonmin1 + ii1 * dx1;
+            const double cell1lonmax = lonmin1 + (ii1 + 1) * dx1;
+            if (cell2lonmin < cell1lonmax && cell2lonmax > cell1lonmin)
+              return (true);
+          }
+        }
+      }
+    }
+  }
+  return (false);
+}
+/*--------------------------------------------------------------------*/
+static void *mbnavadjust_crossing_worker(void *arg) {
+  struct mbna_crossing_work *work = (struct mbna_crossing_work *)arg;
+  struct mbna_file *file2 = &work->project->files[work->ifile];
+  for (int ipair = work->ithread; ipair < work->npairs; ipair += work->nthreads) {
+    struct mbna_crossing_pair *pair = &work->pairs[ipair];
+    struct mbna_section *section1 = &work->project->files[pair->file_1].sections[pair->section_1];
+    struct mbna_section *section2 = &file2->sections[pair->section_2];
+    pair->overlap = mbnavadjust_coverage_overlap(section1, section2) ? 1 : 0;
+  }
+  return (NULL);
+}
+/*--------------------------------------------------------------------*/
+static int mbnavadjust_crossing_pair_compare(const void *a, const void *b) {
+  const struct mbna_crossing_pair *pa = (const struct mbna_crossing_pair *)a;
+  const struct mbna_crossing_pair *pb = (const struct mbna_crossing_pair *)b;
+  if (pa->section_2 != pb->section_2)
+    return (pa->section_2 < pb->section_2 ? -1 : 1);
+  if (pa->file_1 != pb->file_1)
+    return (pa->file_1 < pb->file_1 ? -1 : 1);
+  if (pa->section_1 != pb->section_1)
+    return (pa->section_1 < pb->section_1 ? -1 : 1);
+  return (0);
+}
 /*--------------------------------------------------------------------*/
 int mbnavadjust_findcrossingsfile(int verbose, struct mbna_project *project, int ifile, int *error) {
   if (verbose >= 2) {
@@ -6784,140 +7342,270 @@ int mbnavadjust_findcrossingsfile(int verbose, struct mbna_project *project, int
 
   int status = MB_SUCCESS;
 
-  /* loop over files and sections, comparing sections from project->files[ifile] with all previous sections */
-  if (project->open && project->num_files > 0) {
+  /* compare sections from project->files[ifile] with all previous sections */
+  if (project->open && project->num_files > 0 && project->files[ifile].num_sections > 0) {
     struct mbna_file *file2 = &(project->files[ifile]);
 
-    /* loop over all sections */
-    for (int isection = 0; isection < file2->num_sections; isection++) {
-      // double cell1lonmin, cell1lonmax, cell1latmin, cell1latmax;
-      // double cell2lonmin, cell2lonmax, cell2latmin, cell2latmax;
-      struct mbna_section *section2 = &(file2->sections[isection]);
-      const double lonoffset2 = section2->snav_lon_offset[section2->num_snav / 2];
-      const double latoffset2 = section2->snav_lat_offset[section2->num_snav / 2];
-
-      /* get coverage mask adjusted for most recent inversion solution */
-      const double lonmin2 = section2->lonmin + lonoffset2;
-      const double lonmax2 = section2->lonmax + lonoffset2;
-      const double latmin2 = section2->latmin + latoffset2;
-      const double latmax2 = section2->latmax + latoffset2;
-      const double dx2 = (section2->lonmax - section2->lonmin) / (MBNA_MASK_DIM - 1);
-      const double dy2 = (section2->latmax - section2->latmin) / (MBNA_MASK_DIM - 1);
-
-      /* now loop over all previous sections looking for crossings */
-      for (int jfile = 0; jfile <= ifile; jfile++) {
-        struct mbna_file *file1 = &(project->files[jfile]);
-        const int jsectionmax = jfile < ifile ? file1->num_sections : isection;
-        for (int jsection = 0; jsection < jsectionmax; jsection++) {
-          struct mbna_section *section1 = &(file1->sections[jsection]);
-          const double lonoffset1 = section1->snav_lon_offset[section1->num_snav / 2];
-          const double latoffset1 = section1->snav_lat_offset[section1->num_snav / 2];
-
-          /* get coverage mask adjusted for most recent inversion solution */
-          const double lonmin1 = section1->lonmin + lonoffset1;
-          const double lonmax1 = section1->lonmax + lonoffset1;
-          const double latmin1 = section1->latmin + latoffset1;
-          const double latmax1 = section1->latmax + latoffset1;
-          const double dx1 = (section1->lonmax - section1->lonmin) / (MBNA_MASK_DIM - 1);
-          const double dy1 = (section1->latmax - section1->latmin) / (MBNA_MASK_DIM - 1);
-
-          /* check if there is overlap given the current navigation model */
-          int overlap = 0;
-          bool disqualify = false;
-          if (jfile == ifile && jsection == isection - 1 && section2->continuity)
-            disqualify = true;
-          else if (jfile == ifile - 1 && jsection == file1->num_sections - 1 && isection == 0 &&
-             section2->continuity)
-            disqualify = true;
-          else if (!(lonmin2 < lonmax1 && lonmax2 > lonmin1 && latmin2 < latmax1 && latmax2 > latmin1)) {
-            disqualify = true;
-          } else {
-            /* loop over the coverage mask cells looking for overlap */
-            for (int ii2 = 0; ii2 < MBNA_MASK_DIM && overlap == 0; ii2++)
-              for (int jj2 = 0; jj2 < MBNA_MASK_DIM && overlap == 0; jj2++) {
-                const int kk2 = ii2 + jj2 * MBNA_MASK_DIM;
-                if (section2->coverage[kk2] == 1) {
-                  const double cell2lonmin = lonmin2 + ii2 * dx2;
-                  const double cell2lonmax = lonmin2 + (ii2 + 1) * dx2;
-                  const double cell2latmin = latmin2 + jj2 * dy2;
-                  const double cell2latmax = latmin2 + (jj2 + 1) * dy2;
-
-                  for (int ii1 = 0; ii1 < MBNA_MASK_DIM && overlap == 0; ii1++) {
-                    for (int jj1 = 0; jj1 < MBNA_MASK_DIM && overlap == 0; jj1++) {
-                      const int kk1 = ii1 + jj1 * MBNA_MASK_DIM;
-                      if (section1->coverage[kk1] == 1) {
-                        const double cell1lonmin = lonmin1 + ii1 * dx1;
-                        const double cell1lonmax = lonmin1 + (ii1 + 1) * dx1;
-                        const double cell1latmin = latmin1 + jj1 * dy2;
-                        const double cell1latmax = latmin1 + (jj1 + 1) * dy1;
-
-                        /* check if these two cells overlap */
-                        if (cell2lonmin < cell1lonmax && cell2lonmax > cell1lonmin &&
-                            cell2latmin < cell1latmax && cell2latmax > cell1latmin) {
-                          overlap++;
-                        }
-                      }
-                    }
-                  }
-                }
-              }
-          }
+    /* get the bounds of all sections up to and including this file
+       adjusted for the most recent inversion solution */
+    int nbox = 0;
+    for (int jfile = 0; jfile <= ifile; jfile++)
+      nbox += project->files[jfile].num_sections;
+    struct mbna_crossing_box *boxes = (struct mbna_crossing_box *)malloc(nbox * sizeof(struct mbna_crossing_box));
+    int *mark = (int *)malloc(nbox * sizeof(int));
+    if (boxes == NULL || mark == NULL) {
+      free(boxes);
+      free(mark);
+      *error = MB_ERROR_MEMORY_FAIL;
+      return (MB_FAILURE);
+    }
+    double lonmin = 0.0, lonmax = 0.0, latmin = 0.0, latmax = 0.0;
+    double width = 0.0, height = 0.0;
+    int ibox = 0;
+    for (int jfile = 0; jfile <= ifile; jfile++) {
+      struct mbna_file *file1 = &(project->files[jfile]);
+      for (int jsection = 0; jsection < file1->num_sections; jsection++) {
+        struct mbna_crossing_box *box = &boxes[ibox];
+        box->file = jfile;
+        box->section = jsection;
+        mbnavadjust_section_bounds(&file1->sections[jsection], &box->lonmin, &box->lonmax, &box->latmin, &box->latmax);
+        if (ibox == 0 || box->lonmin < lonmin)
+          lonmin = box->lonmin;
+        if (ibox == 0 || box->lonmax > lonmax)
+          lonmax = box->lonmax;
+        if (ibox == 0 || box->latmin < latmin)
+          latmin = box->latmin;
+        if (ibox == 0 || box->latmax > latmax)
+          latmax = box->latmax;
+        width += box->lonmax - box->lonmin;
+        height += box->latmax - box->latmin;
+        mark[ibox] = -1;
+        ibox++;
+      }
+    }
 
-          /* if not disqualified and overlap found, then this is a crossing */
-          /* check to see if the crossing exists, if not add it */
-          if (!disqualify && overlap > 0) {
-            bool found = false;
-            for (int icrossing = 0; icrossing < project->num_crossings && !found; icrossing++) {
-              struct mbna_crossing *crossing = &(project->crossings[icrossing]);
-              if (crossing->file_id_2 == ifile && crossing->file_id_1 == jfile && crossing->section_2 == isection &&
-                  crossing->section_1 == jsection) {
-                found = true;
-              }
-              else if (crossing->file_id_1 == ifile && crossing->file_id_2 == jfile &&
-                 crossing->section_1 == isection && crossing->section_2 == jsection) {
-                found = true;
-              }
-            }
-            if (!found) {
-              /* allocate mbna_crossing array if needed */
-              if (project->num_crossings_alloc <= project->num_crossings) {
-                project->crossings = (struct mbna_crossing *)realloc(
-                  project->crossings, sizeof(struct mbna_crossing) * (project->num_crossings_alloc + ALLOC_NUM));
-                if (project->crossings != NULL)
-                  project->num_crossings_alloc += ALLOC_NUM;
-                else {
-                  status = MB_FAILURE;
-                  *error = MB_ERROR_MEMORY_FAIL;
-                }
-              }
+    /* put the sections into a uniform grid with cells the size of an
+       average section, keeping the number of cells comparable to the
+       number of sections */
+    double dlon = width / nbox;
+    double dlat = height / nbox;
+    if (dlon <= 0.0)
+      dlon = MAX(lonmax - lonmin, 1.0e-9);
+    if (dlat <= 0.0)
+      dlat = MAX(latmax - latmin, 1.0e-9);
+    int nx = MAX(1, MIN((int)((lonmax - lonmin) / dlon) + 1, nbox));
+    int ny = MAX(1, MIN((int)((latmax - latmin) / dlat) + 1, nbox));
+    while ((double)nx * ny > 4.0 * nbox) {
+      nx = MAX(1, nx / 2);
+      ny = MAX(1, ny / 2);
+    }
+    dlon = (lonmax - lonmin) / nx;
+    dlat = (latmax - latmin) / ny;
+#define MBNA_CROSSING_CELL(x, x0, d, n) ((d) > 0.0 ? MAX(0, MIN((int)(((x) - (x0)) / (d)), (n) - 1)) : 0)
+    int *cell_start = (int *)calloc(nx * ny + 1, sizeof(int));
+    int nentry = 0;
+    for (int i = 0; i < nbox && cell_start != NULL; i++) {
+      const int ix0 = MBNA_CROSSING_CELL(boxes[i].lonmin, lonmin, dlon, nx);
+      const int ix1 = MBNA_CROSSING_CELL(boxes[i].lonmax, lonmin, dlon, nx);
+      const int iy0 = MBNA_CROSSING_CELL(boxes[i].latmin, latmin, dlat, ny);
+      const int iy1 = MBNA_CROSSING_CELL(boxes[i].latmax, latmin, dlat, ny);
+      for (int iy = iy0; iy <= iy1; iy++)
+        for (int ix = ix0; ix <= ix1; ix++)
+          cell_start[ix + iy * nx + 1]++;
+      nentry += (ix1 - ix0 + 1) * (iy1 - iy0 + 1);
+    }
+    int *cell_box = (int *)malloc(MAX(nentry, 1) * sizeof(int));
+    int *cell_fill = (int *)malloc((nx * ny + 1) * sizeof(int));
+    if (cell_start == NULL || cell_box == NULL || cell_fill == NULL) {
+      free(boxes);
+      free(mark);
+      free(cell_start);
+      free(cell_box);
+      free(cell_fill);
+      *error = MB_ERROR_MEMORY_FAIL;
+      return (MB_FAILURE);
+    }
+    for (int icell = 0; icell < nx * ny; icell++)
+      cell_start[icell + 1] += cell_start[icell];
+    memcpy(cell_fill, cell_start, (nx * ny + 1) * sizeof(int));
+    for (int i = 0; i < nbox; i++) {
+      const int ix0 = MBNA_CROSSING_CELL(boxes[i].lonmin, lonmin, dlon, nx);
+      const int ix1 = MBNA_CROSSING_CELL(boxes[i].lonmax, lonmin, dlon, nx);
+      const int iy0 = MBNA_CROSSING_CELL(boxes[i].latmin, latmin, dlat, ny);
+      const int iy1 = MBNA_CROSSING_CELL(boxes[i].latmax, latmin, dlat, ny);
+      for (int iy = iy0; iy <= iy1; iy++)
+        for (int ix = ix0; ix <= ix1; ix++)
+          cell_box[cell_fill[ix + iy * nx]++] = i;
+    }
 
-              /* add crossing to list */
-              struct mbna_crossing *crossing = (struct mbna_crossing *)&project->crossings[project->num_crossings];
-              crossing->status = MBNA_CROSSING_STATUS_NONE;
-              crossing->truecrossing = false;
-              crossing->overlap = 0;
-              crossing->file_id_1 = file1->id;
-              crossing->section_1 = jsection;
-              crossing->file_id_2 = file2->id;
-              crossing->section_2 = isection;
-              crossing->num_ties = 0;
-              project->num_crossings++;
-
-              fprintf(stderr, "added crossing: %d  %4d %4d   %4d %4d\n", project->num_crossings - 1,
-                crossing->file_id_1, crossing->section_1, crossing->file_id_2, crossing->section_2);
+    /* find the pairs of sections with overlapping bounds - the sections of
+       this file are the last num_sections boxes */
+    const int ibox2start = nbox - file2->num_sections;
+    int npairs = 0;
+    int npairs_alloc = 0;
+    struct mbna_crossing_pair *pairs = NULL;
+    for (int isection = 0; isection < file2->num_sections && status == MB_SUCCESS; isection++) {
+      struct mbna_section *section2 = &(file2->sections[isection]);
+      const struct mbna_crossing_box *box2 = &boxes[ibox2start + isection];
+      const int ix0 = MBNA_CROSSING_CELL(box2->lonmin, lonmin, dlon, nx);
+      const int ix1 = MBNA_CROSSING_CELL(box2->lonmax, lonmin, dlon, nx);
+      const int iy0 = MBNA_CROSSING_CELL(box2->latmin, latmin, dlat, ny);
+      const int iy1 = MBNA_CROSSING_CELL(box2->latmax, latmin, dlat, ny);
+      for (int iy = iy0; iy <= iy1 && status == MB_SUCCESS; iy++) {
+        for (int ix = ix0; ix <= ix1 && status == MB_SUCCESS; ix++) {
+          const int icell = ix + iy * nx;
+          for (int ientry = cell_start[icell]; ientry < cell_start[icell + 1]; ientry++) {
+            /* only consider each earlier section once */
+            const int i = cell_box[ientry];
+            if (i >= ibox2start + isection || mark[i] == isection)
+              continue;
+            mark[i] = isection;
+            const struct mbna_crossing_box *box1 = &boxes[i];
+            const int jfile = box1->file;
+            const int jsection = box1->section;
+
+            /* check if there is overlap given the current navigation model,
+               ignoring sections that are continuous with this one */
+            if (jfile == ifile && jsection == isection - 1 && section2->continuity)
+              continue;
+            if (jfile == ifile - 1 && jsection == project->files[jfile].num_sections - 1 && isection == 0 &&
+                section2->continuity)
+              continue;
+            if (!(box2->lonmin < box1->lonmax && box2->lonmax > box1->lonmin && box2->latmin < box1->latmax &&
+                  box2->latmax > box1->latmin))
+              continue;
+
+            if (npairs >= npairs_alloc) {
+              struct mbna_crossing_pair *pairs_new = (struct mbna_crossing_pair *)realloc(
+                  pairs, (npairs_alloc + MAX(npairs_alloc, 1024)) * sizeof(struct mbna_crossing_pair));
+              if (pairs_new == NULL) {
+                status = MB_FAILURE;
+                *error = MB_ERROR_MEMORY_FAIL;
+                break;
+              }
+              pairs = pairs_new;
+              npairs_alloc += MAX(npairs_alloc, 1024);
             }
-            /*else
-               fprintf(stderr,"no new crossing:    %4d %4d   %4d %4d   duplicate\n",
-               file2->id,isection,
-               file1->id,jsection);*/
+            pairs[npairs].section_2 = isection;
+            pairs[npairs].file_1 = jfile;
+            pairs[npairs].section_1 = jsection;
+            pairs[npairs].overlap = 0;
+            npairs++;
           }
-          /*else
-             fprintf(stderr,"disqualified:       %4d %4d   %4d %4d   disqualify:%d overlaptxt list:%d\n",
-             file2->id,isection,
-             file1->id,jsection, disqualify, overlap);*/
         }
       }
     }
+#undef MBNA_CROSSING_CELL
+    free(boxes);
+    free(mark);
+    free(cell_start);
+    free(cell_box);
+    free(cell_fill);
+
+    /* compare the coverage masks of the candidate pairs in parallel */
+    if (status == MB_SUCCESS && npairs > 0) {
+      const long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+      int nthreads = ncpu > 0 ? (int)MIN(ncpu, MB_THREAD_MAX) : 1;
+      if (npairs < MBNA_CROSSING_THREAD_MIN)
+        nthreads = 1;
+      struct mbna_crossing_work work[MB_THREAD_MAX];
+      pthread_t threads[MB_THREAD_MAX];
+      int nstarted = 0;
+      for (int ithread = 0; ithread < nthreads; ithread++) {
+        work[ithread].project = project;
+        work[ithread].ifile = ifile;
+        work[ithread].pairs = pairs;
+        work[ithread].npairs = npairs;
+        work[ithread].ithread = ithread;
+        work[ithread].nthreads = nthreads;
+      }
+      for (int ithread = 1; ithread < nthreads; ithread++) {
+        if (pthread_create(&threads[ithread], NULL, mbnavadjust_crossing_worker, &work[ithread]) != 0)
+          break;
+        nstarted++;
+      }
+
+      /* this thread does its own share and that of any thread that failed to start */
+      mbnavadjust_crossing_worker(&work[0]);
+      for (int ithread = nstarted + 1; ithread < nthreads; ithread++)
+        mbnavadjust_crossing_worker(&work[ithread]);
+      for (int ithread = 1; ithread <= nstarted; ithread++)
+        pthread_join(threads[ithread], NULL);
+
+      /* keep the crossings in the order sections are compared */
+      qsort(pairs, npairs, sizeof(struct mbna_crossing_pair), mbnavadjust_crossing_pair_compare);
+    }
+
+    /* get the existing crossings involving this file, as (section of this
+       file, other file, other section), so duplicates are found quickly */
+    int nexisting = 0;
+    struct mbna_crossing_pair *existing = NULL;
+    if (status == MB_SUCCESS && npairs > 0 && project->num_crossings > 0) {
+      existing = (struct mbna_crossing_pair *)malloc(2 * project->num_crossings * sizeof(struct mbna_crossing_pair));
+      if (existing == NULL) {
+        status = MB_FAILURE;
+        *error = MB_ERROR_MEMORY_FAIL;
+      }
+      for (int icrossing = 0; icrossing < project->num_crossings && existing != NULL; icrossing++) {
+        struct mbna_crossing *crossing = &(project->crossings[icrossing]);
+        if (crossing->file_id_2 == ifile) {
+          existing[nexisting].section_2 = crossing->section_2;
+          existing[nexisting].file_1 = crossing->file_id_1;
+          existing[nexisting].section_1 = crossing->section_1;
+          nexisting++;
+        }
+        if (crossing->file_id_1 == ifile) {
+          existing[nexisting].section_2 = crossing->section_1;
+          existing[nexisting].file_1 = crossing->file_id_2;
+          existing[nexisting].section_1 = crossing->section_2;
+          nexisting++;
+        }
+      }
+      if (nexisting > 1)
+        qsort(existing, nexisting, sizeof(struct mbna_crossing_pair), mbnavadjust_crossing_pair_compare);
+    }
+
+    /* add the new crossings */
+    for (int ipair = 0; ipair < npairs && status == MB_SUCCESS; ipair++) {
+      struct mbna_crossing_pair *pair = &pairs[ipair];
+      if (pair->overlap == 0)
+        continue;
+      if (nexisting > 0 && bsearch(pair, existing, nexisting, sizeof(struct mbna_crossing_pair),
+                                   mbnavadjust_crossing_pair_compare) != NULL)
+        continue;
+
+      /* allocate mbna_crossing array if needed */
+      if (project->num_crossings_alloc <= project->num_crossings) {
+        struct mbna_crossing *crossings = (struct mbna_crossing *)realloc(
+          project->crossings, sizeof(struct mbna_crossing) * (project->num_crossings_alloc + ALLOC_NUM));
+        if (crossings != NULL) {
+          project->crossings = crossings;
+          project->num_crossings_alloc += ALLOC_NUM;
+        }
+        else {
+          status = MB_FAILURE;
+          *error = MB_ERROR_MEMORY_FAIL;
+          break;
+        }
+      }
+
+      /* add crossing to list */
+      struct mbna_crossing *crossing = (struct mbna_crossing *)&project->crossings[project->num_crossings];
+      crossing->status = MBNA_CROSSING_STATUS_NONE;
+      crossing->truecrossing = false;
+      crossing->overlap = 0;
+      crossing->file_id_1 = project->files[pair->file_1].id;
+      crossing->section_1 = pair->section_1;
+      crossing->file_id_2 = file2->id;
+      crossing->section_2 = pair->section_2;
+      crossing->num_ties = 0;
+      project->num_crossings++;
+
+      fprintf(stderr, "added crossing: %d  %4d %4d   %4d %4d\n", project->num_crossings - 1,
+        crossing->file_id_1, crossing->section_1, crossing->file_id_2, crossing->section_2);
+    }
+    free(pairs);
+    free(existing);
   }
 
   if (verbose >= 2) {
@@ -7220,3 +7908,1493 @@ int mbnavadjust_info_add(int verbose, struct mbna_project *project, char *info,
 }
 
 /*--------------------------------------------------------------------*/
+/*
+ * In place radix 2 complex FFT of n (a power of two) values stored as
+ * interleaved real and imaginary parts with stride between values, using
+ * the sign of the exponent given by direction (-1 forward, +1 inverse).
+ * The inverse transform is not normalized.
+ */
+static void mbnavadjust_fft(double *data, int n, int stride, int direction) {
+  /* bit reversal permutation */
+  for (int i = 1, j = 0; i < n; i++) {
+    int bit = n >> 1;
+    for (; j & bit; bit >>= 1)
+      j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      double *a = &data[2 * i * stride];
+      double *b = &data[2 * j * stride];
+      const double re = a[0];
+      const double im = a[1];
+      a[0] = b[0];
+      a[1] = b[1];
+      b[0] = re;
+      b[1] = im;
+    }
+  }
+
+  /* butterflies */
+  for (int len = 2; len <= n; len <<= 1) {
+    const double angle = direction * 2.0 * M_PI / len;
+    const double wre = cos(angle);
+    const double wim = sin(angle);
+    for (int i = 0; i < n; i += len) {
+      double ure = 1.0;
+      double uim = 0.0;
+      for (int k = 0; k < len / 2; k++) {
+        double *a = &data[2 * (i + k) * stride];
+        double *b = &data[2 * (i + k + len / 2) * stride];
+        const double tre = b[0] * ure - b[1] * uim;
+        const double tim = b[0] * uim + b[1] * ure;
+        b[0] = a[0] - tre;
+        b[1] = a[1] - tim;
+        a[0] += tre;
+        a[1] += tim;
+        const double nure = ure * wre - uim * wim;
+        uim = ure * wim + uim * wre;
+        ure = nure;
+      }
+    }
+  }
+}
+/*--------------------------------------------------------------------*/
+/*
+ * Two dimensional FFT of an nx by ny complex array stored row by row
+ */
+static void mbnavadjust_fft2d(double *data, int nx, int ny, int direction) {
+  for (int j = 0; j < ny; j++)
+    mbnavadjust_fft(&data[2 * j * nx], nx, 1, direction);
+  for (int i = 0; i < nx; i++)
+    mbnavadjust_fft(&data[2 * i], ny, nx, direction);
+}
+/*--------------------------------------------------------------------*/
+/*
+ * Calculate the 3D misfit volume between two gridded sections using FFT
+ * cross correlations.
+ *
+ * For a lateral offset (ioff, joff) of grid2 relative to grid1 and a z offset c,
+ * the sum over the overlapping cells of (grid2 - grid1 + c)^2 expands into
+ *     S2 + 2 * c * S1 + c * c * N
+ * where N, S1 and S2 are cross correlations of the cell masks, the masked
+ * depths and the masked squared depths of the two grids. These are obtained
+ * for all lateral offsets at once from six forward and three inverse FFTs,
+ * after which each z offset costs O(1) per lateral offset. The results
+ * match the direct summation: gridm holds the sum of squared differences
+ * and gridnm the number of overlapping cells, indexed by
+ * kc + nzmisfitcalc * (ic + jc * gridm_nx) with lateral offsets
+ * ioff = gridm_nx / 2 - ic and joff = gridm_ny / 2 - jc, and z offsets
+ * zmin + kc * zoff_dz - offset_z.
+ */
+int mbnavadjust_misfit_fft(int verbose, int grid_nx, int grid_ny, double *grid1, int *gridn1, double *grid2, int *gridn2,
+                           int gridm_nx, int gridm_ny, int nzmisfitcalc, double zmin, double zoff_dz, double offset_z,
+                           double *gridm, int *gridnm, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2       verbose:         %d\n", verbose);
+    fprintf(stderr, "dbg2       grid_nx:         %d\n", grid_nx);
+    fprintf(stderr, "dbg2       grid_ny:         %d\n", grid_ny);
+    fprintf(stderr, "dbg2       grid1:           %p\n", grid1);
+    fprintf(stderr, "dbg2       gridn1:          %p\n", gridn1);
+    fprintf(stderr, "dbg2       grid2:           %p\n", grid2);
+    fprintf(stderr, "dbg2       gridn2:          %p\n", gridn2);
+    fprintf(stderr, "dbg2       gridm_nx:        %d\n", gridm_nx);
+    fprintf(stderr, "dbg2       gridm_ny:        %d\n", gridm_ny);
+    fprintf(stderr, "dbg2       nzmisfitcalc:    %d\n", nzmisfitcalc);
+    fprintf(stderr, "dbg2       zmin:            %f\n", zmin);
+    fprintf(stderr, "dbg2       zoff_dz:         %f\n", zoff_dz);
+    fprintf(stderr, "dbg2       offset_z:        %f\n", offset_z);
+  }
+
+  int status = MB_SUCCESS;
+  *error = MB_ERROR_NO_ERROR;
+
+  /* pad the transforms so that correlations at the largest offsets do not wrap */
+  int nfx = 1;
+  while (nfx < grid_nx + gridm_nx / 2 + 1)
+    nfx *= 2;
+  int nfy = 1;
+  while (nfy < grid_ny + gridm_ny / 2 + 1)
+    nfy *= 2;
+  const int nf = nfx * nfy;
+
+  /* six transforms of the mask, depth and squared depth of each grid, with
+      depths taken relative to a common reference to limit roundoff */
+  double *fft = (double *)calloc(12 * (size_t)nf, sizeof(double));
+  if (fft == NULL) {
+    *error = MB_ERROR_MEMORY_FAIL;
+    status = MB_FAILURE;
+  }
+  if (status == MB_SUCCESS) {
+    double *m1 = &fft[0];
+    double *a1 = &fft[2 * nf];
+    double *b1 = &fft[4 * nf];
+    double *m2 = &fft[6 * nf];
+    double *a2 = &fft[8 * nf];
+    double *b2 = &fft[10 * nf];
+    double reference = 0.0;
+    int nreference = 0;
+    for (int k = 0; k < grid_nx * grid_ny; k++) {
+      if (gridn1[k] > 0) {
+        reference += grid1[k];
+        nreference++;
+      }
+    }
+    if (nreference > 0)
+      reference /= nreference;
+    for (int j = 0; j < grid_ny; j++) {
+      for (int i = 0; i < grid_nx; i++) {
+        const int k = i + j * grid_nx;
+        const int kf = 2 * (i + j * nfx);
+        if (gridn1[k] > 0) {
+          const double z = grid1[k] - reference;
+          m1[kf] = 1.0;
+          a1[kf] = z;
+          b1[kf] = z * z;
+        }
+        if (gridn2[k] > 0) {
+          const double z = grid2[k] - reference;
+          m2[kf] = 1.0;
+          a2[kf] = z;
+          b2[kf] = z * z;
+        }
+      }
+    }
+    for (int l = 0; l < 6; l++)
+      mbnavadjust_fft2d(&fft[2 * l * nf], nfx, nfy, -1);
+
+    /* cross spectra conj(F1) * F2 combined into N, S1 and S2 - the results
+        overwrite the transforms of grid 1 */
+    for (int kf = 0; kf < 2 * nf; kf += 2) {
+      const double m1re = m1[kf], m1im = -m1[kf + 1];
+      const double a1re = a1[kf], a1im = -a1[kf + 1];
+      const double b1re = b1[kf], b1im = -b1[kf + 1];
+      const double m2re = m2[kf], m2im = m2[kf + 1];
+      const double a2re = a2[kf], a2im = a2[kf + 1];
+      const double b2re = b2[kf], b2im = b2[kf + 1];
+      m1[kf] = m1re * m2re - m1im * m2im;
+      m1[kf + 1] = m1re * m2im + m1im * m2re;
+      a1[kf] = (m1re * a2re - m1im * a2im) - (a1re * m2re - a1im * m2im);
+      a1[kf + 1] = (m1re * a2im + m1im * a2re) - (a1re * m2im + a1im * m2re);
+      b1[kf] = (m1re * b2re - m1im * b2im) + (b1re * m2re - b1im * m2im) - 2.0 * (a1re * a2re - a1im * a2im);
+      b1[kf + 1] = (m1re * b2im + m1im * b2re) + (b1re * m2im + b1im * m2re) - 2.0 * (a1re * a2im + a1im * a2re);
+    }
+    for (int l = 0; l < 3; l++)
+      mbnavadjust_fft2d(&fft[2 * l * nf], nfx, nfy, 1);
+
+    /* evaluate the misfit for each lateral and z offset */
+    for (int ic = 0; ic < gridm_nx; ic++) {
+      const int ioff = gridm_nx / 2 - ic;
+      const int iff = (ioff + nfx) % nfx;
+      for (int jc = 0; jc < gridm_ny; jc++) {
+        const int joff = gridm_ny / 2 - jc;
+        const int jf = (joff + nfy) % nfy;
+        const int kf = 2 * (iff + jf * nfx);
+        const int n = (int)lround(m1[kf] / nf);
+        const double s1 = a1[kf] / nf;
+        const double s2 = b1[kf] / nf;
+        for (int kc = 0; kc < nzmisfitcalc; kc++) {
+          const int lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
+          const double c = zmin + zoff_dz * kc - offset_z;
+          gridnm[lc] = n;
+          gridm[lc] = n > 0 ? MAX(s2 + 2.0 * c * s1 + c * c * n, 0.0) : 0.0;
+        }
+      }
+    }
+    free(fft);
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+/*
+ * Refine the location of a misfit minimum at cell (ic, jc, kc) of a misfit
+ * volume to a fraction of a cell by fitting a parabola through the minimum
+ * and its two neighbors along each axis. Neighbors with nthreshold or fewer
+ * overlapping cells are not used, leaving that component unrefined.
+ */
+int mbnavadjust_misfit_refine(int verbose, int gridm_nx, int gridm_ny, int nzmisfitcalc, double *gridm, int *gridnm,
+                              int nthreshold, int ic, int jc, int kc, double *dic, double *djc, double *dkc, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2       verbose:         %d\n", verbose);
+    fprintf(stderr, "dbg2       gridm_nx:        %d\n", gridm_nx);
+    fprintf(stderr, "dbg2       gridm_ny:        %d\n", gridm_ny);
+    fprintf(stderr, "dbg2       nzmisfitcalc:    %d\n", nzmisfitcalc);
+    fprintf(stderr, "dbg2       gridm:           %p\n", gridm);
+    fprintf(stderr, "dbg2       gridnm:          %p\n", gridnm);
+    fprintf(stderr, "dbg2       nthreshold:      %d\n", nthreshold);
+    fprintf(stderr, "dbg2       ic:              %d\n", ic);
+    fprintf(stderr, "dbg2       jc:              %d\n", jc);
+    fprintf(stderr, "dbg2       kc:              %d\n", kc);
+  }
+
+  const int n[3] = {gridm_nx, gridm_ny, nzmisfitcalc};
+  const int c[3] = {ic, jc, kc};
+  double *d[3] = {dic, djc, dkc};
+  for (int axis = 0; axis < 3; axis++) {
+    *d[axis] = 0.0;
+    if (c[axis] < 1 || c[axis] > n[axis] - 2)
+      continue;
+    double m[3];
+    bool ok = true;
+    for (int s = -1; s <= 1 && ok; s++) {
+      int cc[3] = {ic, jc, kc};
+      cc[axis] += s;
+      const int lc = cc[2] + nzmisfitcalc * (cc[0] + cc[1] * gridm_nx);
+      ok = gridnm[lc] > nthreshold;
+      m[s + 1] = gridm[lc];
+    }
+    const double curvature = m[0] - 2.0 * m[1] + m[2];
+    if (ok && curvature > 0.0)
+      *d[axis] = MAX(-0.5, MIN(0.5, 0.5 * (m[0] - m[2]) / curvature));
+  }
+  *error = MB_ERROR_NO_ERROR;
+  const int status = MB_SUCCESS;
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       dic:         %f\n", *dic);
+    fprintf(stderr, "dbg2       djc:         %f\n", *djc);
+    fprintf(stderr, "dbg2       dkc:         %f\n", *dkc);
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+/*--------------------------------------------------------------------*/
+/* Section swath cache used when many crossings are processed without
+   the interactive program. Each section is loaded once and shared by the
+   crossings that use it; sections not in use are unloaded in least
+   recently used order when the cache grows beyond its memory budget.
+   Cached swaths are translated without a depth offset and are read only. */
+
+struct mbna_section_cache_entry {
+  int file_id;
+  int section_id;
+  struct mbna_swathraw *swathraw;
+  struct swath *swath;
+  size_t size;
+  int users;
+  bool loading;
+  unsigned long last_use;
+};
+
+struct mbna_section_cache {
+  int verbose;
+  struct mbna_project *project;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  size_t size;
+  size_t size_max;
+  unsigned long clock;
+  int num_entries;
+  int num_entries_alloc;
+  struct mbna_section_cache_entry *entries;
+  int num_loads;
+  int num_hits;
+};
+
+/*--------------------------------------------------------------------*/
+int mbnavadjust_section_cache_init(int verbose, struct mbna_project *project, size_t size_max,
+                                   void **cache_ptr, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       project:    %p\n", project);
+    fprintf(stderr, "dbg2       size_max:   %zu\n", size_max);
+  }
+
+  int status = MB_SUCCESS;
+
+  struct mbna_section_cache *cache = (struct mbna_section_cache *)calloc(1, sizeof(struct mbna_section_cache));
+  if (cache == NULL) {
+    *error = MB_ERROR_MEMORY_FAIL;
+    status = MB_FAILURE;
+  }
+  else {
+    cache->verbose = verbose;
+    cache->project = project;
+    cache->size_max = size_max;
+    pthread_mutex_init(&cache->mutex, NULL);
+    pthread_cond_init(&cache->cond, NULL);
+    *error = MB_ERROR_NO_ERROR;
+  }
+  *cache_ptr = (void *)cache;
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       cache:       %p\n", *cache_ptr);
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+/* unload the least recently used sections not in use until the cache is
+   within its memory budget - called with the cache mutex locked */
+static void mbnavadjust_section_cache_trim(struct mbna_section_cache *cache) {
+  while (cache->size > cache->size_max) {
+    int ioldest = -1;
+    for (int i = 0; i < cache->num_entries; i++) {
+      struct mbna_section_cache_entry *entry = &cache->entries[i];
+      if (entry->users == 0 && !entry->loading
+          && (ioldest < 0 || entry->last_use < cache->entries[ioldest].last_use))
+        ioldest = i;
+    }
+    if (ioldest < 0)
+      break;
+    struct mbna_section_cache_entry *entry = &cache->entries[ioldest];
+    int error = MB_ERROR_NO_ERROR;
+    mbnavadjust_section_unload(cache->verbose, (void **)&entry->swathraw, (void **)&entry->swath, &error);
+    cache->size -= entry->size;
+    cache->num_entries--;
+    if (ioldest < cache->num_entries)
+      cache->entries[ioldest] = cache->entries[cache->num_entries];
+  }
+}
+/*--------------------------------------------------------------------*/
+int mbnavadjust_section_cache_get(int verbose, void *cache_ptr, int file_id, int section_id,
+                                  void **swathraw_ptr, void **swath_ptr, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       cache_ptr:  %p\n", cache_ptr);
+    fprintf(stderr, "dbg2       file_id:    %d\n", file_id);
+    fprintf(stderr, "dbg2       section_id: %d\n", section_id);
+  }
+
+  int status = MB_SUCCESS;
+  struct mbna_section_cache *cache = (struct mbna_section_cache *)cache_ptr;
+  *swathraw_ptr = NULL;
+  *swath_ptr = NULL;
+  *error = MB_ERROR_NO_ERROR;
+
+  pthread_mutex_lock(&cache->mutex);
+
+  /* use the section if it is already loaded, waiting for it if another
+     thread is loading it */
+  bool done = false;
+  while (!done) {
+    struct mbna_section_cache_entry *entry = NULL;
+    for (int i = 0; i < cache->num_entries && entry == NULL; i++) {
+      if (cache->entries[i].file_id == file_id && cache->entries[i].section_id == section_id)
+        entry = &cache->entries[i];
+    }
+    if (entry != NULL && entry->loading) {
+      pthread_cond_wait(&cache->cond, &cache->mutex);
+    }
+    else if (entry != NULL) {
+      entry->users++;
+      entry->last_use = ++cache->clock;
+      *swathraw_ptr = (void *)entry->swathraw;
+      *swath_ptr = (void *)entry->swath;
+      cache->num_hits++;
+      done = true;
+    }
+    else {
+      /* add an entry marked as loading and load the section with the
+         cache unlocked */
+      if (cache->num_entries >= cache->num_entries_alloc) {
+        const int num_alloc = cache->num_entries_alloc + 64;
+        struct mbna_section_cache_entry *entries = (struct mbna_section_cache_entry *)realloc(
+            cache->entries, num_alloc * sizeof(struct mbna_section_cache_entry));
+        if (entries == NULL) {
+          *error = MB_ERROR_MEMORY_FAIL;
+          status = MB_FAILURE;
+          break;
+        }
+        cache->entries = entries;
+        cache->num_entries_alloc = num_alloc;
+      }
+      entry = &cache->entries[cache->num_entries];
+      memset(entry, 0, sizeof(struct mbna_section_cache_entry));
+      entry->file_id = file_id;
+      entry->section_id = section_id;
+      entry->loading = true;
+      entry->users = 1;
+      cache->num_entries++;
+      pthread_mutex_unlock(&cache->mutex);
+
+      struct mbna_swathraw *swathraw = NULL;
+      struct swath *swath = NULL;
+      status = mbnavadjust_section_load(verbose, cache->project, file_id, section_id, (void **)&swathraw,
+                                        (void **)&swath, error);
+      if (status == MB_SUCCESS)
+        status = mbnavadjust_section_translate(verbose, cache->project, file_id, swathraw, swath, 0.0, error);
+      size_t size = sizeof(struct mbna_swathraw) + sizeof(struct swath);
+      if (swathraw != NULL)
+        size += swathraw->npings_max * (sizeof(struct mbna_pingraw)
+                + swathraw->beams_bath * 2 * (sizeof(char) + 3 * sizeof(double)));
+      if (swath != NULL)
+        size += swath->npts_alloc * (3 * sizeof(int) + 3 * sizeof(double)) + swath->ntri_alloc * 12 * sizeof(int);
+
+      pthread_mutex_lock(&cache->mutex);
+
+      /* the entry array may have been reallocated or reordered while loading */
+      entry = NULL;
+      for (int i = 0; i < cache->num_entries && entry == NULL; i++) {
+        if (cache->entries[i].file_id == file_id && cache->entries[i].section_id == section_id)
+          entry = &cache->entries[i];
+      }
+      entry->loading = false;
+      if (status == MB_SUCCESS) {
+        entry->swathraw = swathraw;
+        entry->swath = swath;
+        entry->size = size;
+        entry->last_use = ++cache->clock;
+        cache->size += size;
+        cache->num_loads++;
+        *swathraw_ptr = (void *)swathraw;
+        *swath_ptr = (void *)swath;
+      }
+      else {
+        if (swath != NULL) {
+          int error2 = MB_ERROR_NO_ERROR;
+          mbnavadjust_section_unload(verbose, (void **)&swathraw, (void **)&swath, &error2);
+        }
+        const int ientry = (int)(entry - cache->entries);
+        cache->num_entries--;
+        if (ientry < cache->num_entries)
+          cache->entries[ientry] = cache->entries[cache->num_entries];
+      }
+      mbnavadjust_section_cache_trim(cache);
+      pthread_cond_broadcast(&cache->cond);
+      done = true;
+    }
+  }
+
+  pthread_mutex_unlock(&cache->mutex);
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       swathraw_ptr: %p\n", *swathraw_ptr);
+    fprintf(stderr, "dbg2       swath_ptr:    %p\n", *swath_ptr);
+    fprintf(stderr, "dbg2       error:        %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:       %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+int mbnavadjust_section_cache_release(int verbose, void *cache_ptr, int file_id, int section_id, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       cache_ptr:  %p\n", cache_ptr);
+    fprintf(stderr, "dbg2       file_id:    %d\n", file_id);
+    fprintf(stderr, "dbg2       section_id: %d\n", section_id);
+  }
+
+  int status = MB_SUCCESS;
+  struct mbna_section_cache *cache = (struct mbna_section_cache *)cache_ptr;
+
+  pthread_mutex_lock(&cache->mutex);
+  struct mbna_section_cache_entry *entry = NULL;
+  for (int i = 0; i < cache->num_entries && entry == NULL; i++) {
+    if (cache->entries[i].file_id == file_id && cache->entries[i].section_id == section_id)
+      entry = &cache->entries[i];
+  }
+  if (entry != NULL && entry->users > 0) {
+    entry->users--;
+    mbnavadjust_section_cache_trim(cache);
+    *error = MB_ERROR_NO_ERROR;
+  }
+  else {
+    *error = MB_ERROR_BAD_PARAMETER;
+    status = MB_FAILURE;
+  }
+  pthread_mutex_unlock(&cache->mutex);
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+int mbnavadjust_section_cache_free(int verbose, void **cache_ptr, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:    %d\n", verbose);
+    fprintf(stderr, "dbg2       cache_ptr:  %p\n", *cache_ptr);
+  }
+
+  int status = MB_SUCCESS;
+  struct mbna_section_cache *cache = (struct mbna_section_cache *)*cache_ptr;
+
+  if (cache != NULL) {
+    if (verbose > 0)
+      fprintf(stderr, "Section cache: %d sections loaded, %d reused\n", cache->num_loads, cache->num_hits);
+    for (int i = 0; i < cache->num_entries; i++)
+      mbnavadjust_section_unload(verbose, (void **)&cache->entries[i].swathraw, (void **)&cache->entries[i].swath,
+                                 error);
+    free(cache->entries);
+    pthread_mutex_destroy(&cache->mutex);
+    pthread_cond_destroy(&cache->cond);
+    free(cache);
+    *cache_ptr = NULL;
+  }
+  *error = MB_ERROR_NO_ERROR;
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+/* Misfit between two sections over a range of lateral and vertical offsets
+   about the offsets misfit->offset_x, misfit->offset_y and misfit->offset_z.
+   The soundings of swath 2 have already been shifted vertically by zoffset.
+   The grids are allocated on first use and kept in grid so that they can
+   be displayed and reused; each thread must use its own grid. This is the
+   calculation behind both the interactive misfit display and autopicking. */
+int mbnavadjust_misfit_calc(int verbose, struct mbna_project *project, struct swath *swath1, struct swath *swath2,
+                            double lon_min, double lon_max, double lat_min, double lat_max, double mtodeglon,
+                            double mtodeglat, int misfit_mode, double zoffset, struct mbna_misfit_grid *grid,
+                            struct mbna_misfit *misfit, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:     %d\n", verbose);
+    fprintf(stderr, "dbg2       project:     %p\n", project);
+    fprintf(stderr, "dbg2       swath1:      %p\n", swath1);
+    fprintf(stderr, "dbg2       swath2:      %p\n", swath2);
+    fprintf(stderr, "dbg2       lon_min:     %f\n", lon_min);
+    fprintf(stderr, "dbg2       lon_max:     %f\n", lon_max);
+    fprintf(stderr, "dbg2       lat_min:     %f\n", lat_min);
+    fprintf(stderr, "dbg2       lat_max:     %f\n", lat_max);
+    fprintf(stderr, "dbg2       misfit_mode: %d\n", misfit_mode);
+    fprintf(stderr, "dbg2       zoffset:     %f\n", zoffset);
+    fprintf(stderr, "dbg2       offset_x:    %f\n", misfit->offset_x);
+    fprintf(stderr, "dbg2       offset_y:    %f\n", misfit->offset_y);
+    fprintf(stderr, "dbg2       offset_z:    %f\n", misfit->offset_z);
+  }
+
+  int status = MB_SUCCESS;
+
+  /* figure out lateral extent of grids */
+  grid->grid_nx = MBNA_MISFIT_DIMXY;
+  grid->grid_ny = MBNA_MISFIT_DIMXY;
+  if ((lon_max - lon_min) / mtodeglon > (lat_max - lat_min) / mtodeglat) {
+    grid->grid_dx = (lon_max - lon_min) / (grid->grid_nx - 1);
+    grid->grid_dy = grid->grid_dx * mtodeglat / mtodeglon;
+  }
+  else {
+    grid->grid_dy = (lat_max - lat_min) / (grid->grid_ny - 1);
+    grid->grid_dx = grid->grid_dy * mtodeglon / mtodeglat;
+  }
+  grid->grid_nxy = grid->grid_nx * grid->grid_ny;
+  grid->grid_olon = 0.5 * (lon_min + lon_max) - (grid->grid_nx / 2 + 0.5) * grid->grid_dx;
+  grid->grid_olat = 0.5 * (lat_min + lat_max) - (grid->grid_ny / 2 + 0.5) * grid->grid_dy;
+  const int grid_nx = grid->grid_nx;
+  const int grid_ny = grid->grid_ny;
+  const int grid_nxy = grid->grid_nxy;
+  const double grid_dx = grid->grid_dx;
+  const double grid_dy = grid->grid_dy;
+  const double grid_olon = grid->grid_olon;
+  const double grid_olat = grid->grid_olat;
+
+  /* get 3d misfit grid centered on the offsets */
+  grid->nzmisfitcalc = MBNA_MISFIT_DIMZ;
+  grid->gridm_nx = grid_nx / 2 + 1;
+  grid->gridm_ny = grid->gridm_nx;
+  grid->gridm_nxyz = grid->gridm_nx * grid->gridm_ny * grid->nzmisfitcalc;
+  grid->zmin = misfit->offset_z - 0.5 * project->zoffsetwidth;
+  grid->zmax = misfit->offset_z + 0.5 * project->zoffsetwidth;
+  grid->zoff_dz = project->zoffsetwidth / (grid->nzmisfitcalc - 1);
+  const int nzmisfitcalc = grid->nzmisfitcalc;
+  const int gridm_nx = grid->gridm_nx;
+  const int gridm_ny = grid->gridm_ny;
+  const int gridm_nxyz = grid->gridm_nxyz;
+  const double zmin = grid->zmin;
+  const double zoff_dz = grid->zoff_dz;
+
+  /* the grid dimensions are fixed so the grids are only allocated once */
+  if (grid->grid1 == NULL) {
+    grid->grid1 = (double *)calloc(grid_nxy, sizeof(double));
+    grid->grid2 = (double *)calloc(grid_nxy, sizeof(double));
+    grid->gridn1 = (int *)calloc(grid_nxy, sizeof(int));
+    grid->gridn2 = (int *)calloc(grid_nxy, sizeof(int));
+    grid->gridm = (double *)calloc(gridm_nxyz, sizeof(double));
+    grid->gridnm = (int *)calloc(gridm_nxyz, sizeof(int));
+    if (grid->grid1 == NULL || grid->grid2 == NULL || grid->gridn1 == NULL || grid->gridn2 == NULL
+        || grid->gridm == NULL || grid->gridnm == NULL) {
+      mbnavadjust_misfit_grid_free(verbose, grid, error);
+      *error = MB_ERROR_MEMORY_FAIL;
+      return (MB_FAILURE);
+    }
+  }
+  double *grid1 = grid->grid1;
+  double *grid2 = grid->grid2;
+  int *gridn1 = grid->gridn1;
+  int *gridn2 = grid->gridn2;
+  double *gridm = grid->gridm;
+  int *gridnm = grid->gridnm;
+  memset(grid1, 0, grid_nxy * sizeof(double));
+  memset(grid2, 0, grid_nxy * sizeof(double));
+  memset(gridn1, 0, grid_nxy * sizeof(int));
+  memset(gridn2, 0, grid_nxy * sizeof(int));
+
+  /* grid the soundings of both sections */
+  for (int i = 0; i < swath1->npings; i++) {
+    struct ping *ping = &swath1->pings[i];
+    for (int j = 0; j < ping->beams_bath; j++) {
+      if (mb_beam_ok(ping->beamflag[j])) {
+        const int igx = (int)((ping->bathlon[j] - grid_olon) / grid_dx);
+        const int igy = (int)((ping->bathlat[j] - grid_olat) / grid_dy);
+        if (igx >= 0 && igx < grid_nx && igy >= 0 && igy < grid_ny) {
+          grid1[igx + igy * grid_nx] += ping->bath[j];
+          gridn1[igx + igy * grid_nx]++;
+        }
+      }
+    }
+  }
+  for (int i = 0; i < swath2->npings; i++) {
+    struct ping *ping = &swath2->pings[i];
+    for (int j = 0; j < ping->beams_bath; j++) {
+      if (mb_beam_ok(ping->beamflag[j])) {
+        const int igx = (int)((ping->bathlon[j] + misfit->offset_x - grid_olon) / grid_dx);
+        const int igy = (int)((ping->bathlat[j] + misfit->offset_y - grid_olat) / grid_dy);
+        if (igx >= 0 && igx < grid_nx && igy >= 0 && igy < grid_ny) {
+          grid2[igx + igy * grid_nx] += ping->bath[j];
+          gridn2[igx + igy * grid_nx]++;
+        }
+      }
+    }
+  }
+  for (int k = 0; k < grid_nxy; k++) {
+    if (gridn1[k] > 0)
+      grid1[k] = grid1[k] / gridn1[k];
+    if (gridn2[k] > 0)
+      grid2[k] = grid2[k] / gridn2[k];
+  }
+
+  /* calculate gridded misfit over lateral and z offsets - by default using
+      FFT cross correlations, optionally by direct summation */
+  if (misfit_mode != MBNA_MISFIT_MODE_DIRECT) {
+    status = mbnavadjust_misfit_fft(verbose, grid_nx, grid_ny, grid1, gridn1, grid2, gridn2, gridm_nx, gridm_ny,
+                                    nzmisfitcalc, zmin, zoff_dz, zoffset, gridm, gridnm, error);
+  }
+  if (misfit_mode == MBNA_MISFIT_MODE_DIRECT || status == MB_FAILURE) {
+    status = MB_SUCCESS;
+    *error = MB_ERROR_NO_ERROR;
+    for (int ic = 0; ic < gridm_nx; ic++)
+      for (int jc = 0; jc < gridm_ny; jc++)
+        for (int kc = 0; kc < nzmisfitcalc; kc++) {
+          const int lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
+          const int ioff = (gridm_nx / 2) - ic;
+          const int joff = (gridm_ny / 2) - jc;
+          const double zoff = zmin + zoff_dz * kc - zoffset;
+          const int istart = MAX(-ioff, 0);
+          const int iend = grid_nx - MAX(0, ioff);
+          const int jstart = MAX(-joff, 0);
+          const int jend = grid_ny - MAX(0, joff);
+          gridm[lc] = 0.0;
+          gridnm[lc] = 0;
+          for (int i1 = istart; i1 < iend; i1++)
+            for (int j1 = jstart; j1 < jend; j1++) {
+              const int k1 = i1 + j1 * grid_nx;
+              const int k2 = (i1 + ioff) + (j1 + joff) * grid_nx;
+              if (gridn1[k1] > 0 && gridn2[k2] > 0) {
+                gridm[lc] += (grid2[k2] - grid1[k1] + zoff) * (grid2[k2] - grid1[k1] + zoff);
+                gridnm[lc]++;
+              }
+            }
+        }
+  }
+
+  /* find the minimum misfit, tuning the sounding density threshold down
+     if necessary */
+  misfit->nthreshold = MBNA_MISFIT_NTHRESHOLD;
+  misfit->minmisfit = 0.0;
+  misfit->minmisfit_n = 0;
+  misfit->minmisfit_x = 0.0;
+  misfit->minmisfit_y = 0.0;
+  misfit->minmisfit_z = 0.0;
+  misfit->minmisfit_xh = misfit->offset_x;
+  misfit->minmisfit_yh = misfit->offset_y;
+  misfit->minmisfit_zh = misfit->offset_z;
+  grid->nmisfit = 0;
+  grid->misfit_min = 0.0;
+  grid->misfit_max = 0.0;
+  bool found = false;
+  int icmin = 0;
+  int jcmin = 0;
+  int kcmin = 0;
+  for (int pass = 0; pass < 2 && !found; pass++) {
+    int nthreshold = misfit->nthreshold;
+    if (pass == 1) {
+      misfit->nthreshold /= 10;
+      nthreshold = misfit->nthreshold / 10;
+    }
+    for (int ic = 0; ic < gridm_nx; ic++)
+      for (int jc = 0; jc < gridm_ny; jc++)
+        for (int kc = 0; kc < nzmisfitcalc; kc++) {
+          const int lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
+          if (pass == 0 && gridnm[lc] > 0) {
+            gridm[lc] = sqrt(gridm[lc]) / gridnm[lc];
+            if (gridm[lc] > 0.0)
+              grid->nmisfit++;
+            if (grid->misfit_max == 0.0)
+              grid->misfit_min = gridm[lc];
+            grid->misfit_min = MIN(grid->misfit_min, gridm[lc]);
+            grid->misfit_max = MAX(grid->misfit_max, gridm[lc]);
+          }
+          if (gridnm[lc] > nthreshold && (misfit->minmisfit_n == 0 || gridm[lc] < misfit->minmisfit)) {
+            misfit->minmisfit = gridm[lc];
+            misfit->minmisfit_n = gridnm[lc];
+            misfit->minmisfit_x = (ic - gridm_nx / 2) * grid_dx + misfit->offset_x;
+            misfit->minmisfit_y = (jc - gridm_ny / 2) * grid_dy + misfit->offset_y;
+            misfit->minmisfit_z = zmin + zoff_dz * kc;
+            icmin = ic;
+            jcmin = jc;
+            kcmin = kc;
+            found = true;
+          }
+        }
+  }
+
+  /* refine the minimum misfit location to a fraction of a grid cell */
+  if (found && misfit_mode == MBNA_MISFIT_MODE_FFTREFINE) {
+    double dic, djc, dkc;
+    mbnavadjust_misfit_refine(verbose, gridm_nx, gridm_ny, nzmisfitcalc, gridm, gridnm, misfit->nthreshold, icmin,
+                              jcmin, kcmin, &dic, &djc, &dkc, error);
+    misfit->minmisfit_x += dic * grid_dx;
+    misfit->minmisfit_y += djc * grid_dy;
+    misfit->minmisfit_z += dkc * zoff_dz;
+  }
+
+  if (grid->nmisfit > 0) {
+    /* get minimum misfit in the plane at the current z offset */
+    double misfitxy_min, misfitxy_max;
+    mbnavadjust_misfit_xy(verbose, grid, misfit->offset_z, misfit, &misfitxy_min, &misfitxy_max, error);
+
+    /* estimate the 3 component uncertainty at the minimum misfit point,
+       first getting the longest vector to a misfit value <= 3 times the
+       minimum misfit */
+    const double minmisfitthreshold = misfit->minmisfit * 3.0;
+    misfit->sr1 = 0.0;
+    for (int ic = 0; ic < gridm_nx; ic++)
+      for (int jc = 0; jc < gridm_ny; jc++)
+        for (int kc = 0; kc < nzmisfitcalc; kc++) {
+          const int lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
+          if (gridnm[lc] > misfit->nthreshold && gridm[lc] <= minmisfitthreshold) {
+            const double x = ((ic - gridm_nx / 2) * grid_dx + misfit->offset_x - misfit->minmisfit_x) / mtodeglon;
+            const double y = ((jc - gridm_ny / 2) * grid_dy + misfit->offset_y - misfit->minmisfit_y) / mtodeglat;
+            const double z = zmin + zoff_dz * kc - misfit->minmisfit_z;
+            const double r = sqrt(x * x + y * y + z * z);
+            if (r > misfit->sr1) {
+              misfit->sx1[0] = x;
+              misfit->sx1[1] = y;
+              misfit->sx1[2] = z;
+              misfit->sr1 = r;
+            }
+          }
+        }
+    misfit->sx1[0] /= misfit->sr1;
+    misfit->sx1[1] /= misfit->sr1;
+    misfit->sx1[2] /= misfit->sr1;
+
+    /* horizontal unit vector perpendicular to the longest vector */
+    misfit->sr2 = sqrt(misfit->sx1[0] * misfit->sx1[0] + misfit->sx1[1] * misfit->sx1[1]);
+    if (misfit->sr2 < MBNA_SMALL) {
+      misfit->sx2[0] = 0.0;
+      misfit->sx2[1] = 1.0;
+      misfit->sx2[2] = 0.0;
+    }
+    else {
+      misfit->sx2[0] = misfit->sx1[1] / misfit->sr2;
+      misfit->sx2[1] = -misfit->sx1[0] / misfit->sr2;
+      misfit->sx2[2] = 0.0;
+    }
+
+    /* near-vertical unit vector perpendicular to the longest vector */
+    misfit->sr3 = sqrt(misfit->sx1[0] * misfit->sx1[0] + misfit->sx1[1] * misfit->sx1[1]);
+    if (misfit->sr3 < MBNA_ZSMALL) {
+      misfit->sx3[0] = 0.0;
+      misfit->sx3[1] = 0.0;
+      misfit->sx3[2] = 1.0;
+    }
+    else {
+      const double scale = sqrt(1.0 - misfit->sr3 * misfit->sr3) / misfit->sr3;
+      const double sign = misfit->sx1[2] >= 0.0 ? -1.0 : 1.0;
+      misfit->sx3[0] = sign * misfit->sx1[0] * scale;
+      misfit->sx3[1] = sign * misfit->sx1[1] * scale;
+      misfit->sx3[2] = misfit->sr3;
+    }
+
+    /* now get the longest r values to a misfit value <= 3 times the
+       minimum misfit for both secondary vectors */
+    misfit->sr2 = 0.0;
+    misfit->sr3 = 0.0;
+    double dotproductsave2 = 0.0;
+    double rsave2 = 0.0;
+    double dotproductsave3 = 0.0;
+    double rsave3 = 0.0;
+    for (int ic = 0; ic < gridm_nx; ic++)
+      for (int jc = 0; jc < gridm_ny; jc++)
+        for (int kc = 0; kc < nzmisfitcalc; kc++) {
+          const int lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
+          if (gridnm[lc] > misfit->nthreshold && gridm[lc] <= minmisfitthreshold) {
+            const double x = ((ic - gridm_nx / 2) * grid_dx + misfit->offset_x - misfit->minmisfit_x) / mtodeglon;
+            const double y = ((jc - gridm_ny / 2) * grid_dy + misfit->offset_y - misfit->minmisfit_y) / mtodeglat;
+            const double z = zmin + zoff_dz * kc - misfit->minmisfit_z;
+            const double r = sqrt(x * x + y * y + z * z);
+            if (r > misfit->sr2) {
+              const double dotproduct = (x * misfit->sx2[0] + y * misfit->sx2[1] + z * misfit->sx2[2]) / r;
+              if (fabs(dotproduct) > 0.8)
+                misfit->sr2 = r;
+              if (fabs(dotproduct) > dotproductsave2) {
+                dotproductsave2 = fabs(dotproduct);
+                rsave2 = r;
+              }
+            }
+            if (r > misfit->sr3) {
+              const double dotproduct = (x * misfit->sx3[0] + y * misfit->sx3[1] + z * misfit->sx3[2]) / r;
+              if (fabs(dotproduct) > 0.8)
+                misfit->sr3 = r;
+              if (fabs(dotproduct) > dotproductsave3) {
+                dotproductsave3 = fabs(dotproduct);
+                rsave3 = r;
+              }
+            }
+          }
+        }
+    if (misfit->sr2 < MBNA_SMALL)
+      misfit->sr2 = rsave2;
+    if (misfit->sr3 < MBNA_ZSMALL)
+      misfit->sr3 = rsave3;
+  }
+  else {
+    misfit->sx1[0] = 1.0;
+    misfit->sx1[1] = 0.0;
+    misfit->sx1[2] = 0.0;
+    misfit->sr1 = 100.0;
+    misfit->sx2[0] = 0.0;
+    misfit->sx2[1] = 1.0;
+    misfit->sx2[2] = 0.0;
+    misfit->sr2 = 100.0;
+    misfit->sx3[0] = 0.0;
+    misfit->sx3[1] = 0.0;
+    misfit->sx3[2] = 1.0;
+    misfit->sr3 = 100.0;
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       minmisfit:   %f\n", misfit->minmisfit);
+    fprintf(stderr, "dbg2       minmisfit_n: %d\n", misfit->minmisfit_n);
+    fprintf(stderr, "dbg2       minmisfit_x: %f\n", misfit->minmisfit_x);
+    fprintf(stderr, "dbg2       minmisfit_y: %f\n", misfit->minmisfit_y);
+    fprintf(stderr, "dbg2       minmisfit_z: %f\n", misfit->minmisfit_z);
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+/* Minimum misfit in the plane of the misfit grid closest to the z offset
+   offset_z, and the range of the misfit in that plane */
+int mbnavadjust_misfit_xy(int verbose, struct mbna_misfit_grid *grid, double offset_z, struct mbna_misfit *misfit,
+                          double *misfit_min, double *misfit_max, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:     %d\n", verbose);
+    fprintf(stderr, "dbg2       grid:        %p\n", grid);
+    fprintf(stderr, "dbg2       offset_z:    %f\n", offset_z);
+  }
+
+  const int status = MB_SUCCESS;
+  *misfit_min = 0.0;
+  *misfit_max = 0.0;
+  const int kc = (int)((offset_z - grid->zmin) / grid->zoff_dz);
+  if (grid->gridm != NULL && kc >= 0 && kc < grid->nzmisfitcalc) {
+    bool found = false;
+    for (int ic = 0; ic < grid->gridm_nx; ic++)
+      for (int jc = 0; jc < grid->gridm_ny; jc++) {
+        const int lc = kc + grid->nzmisfitcalc * (ic + jc * grid->gridm_nx);
+        if (grid->gridnm[lc] > misfit->nthreshold) {
+          if (!found || grid->gridm[lc] < *misfit_min) {
+            *misfit_min = grid->gridm[lc];
+            misfit->minmisfit_xh = (ic - grid->gridm_nx / 2) * grid->grid_dx + misfit->offset_x;
+            misfit->minmisfit_yh = (jc - grid->gridm_ny / 2) * grid->grid_dy + misfit->offset_y;
+            misfit->minmisfit_zh = grid->zmin + grid->zoff_dz * kc;
+          }
+          if (!found || grid->gridm[lc] > *misfit_max)
+            *misfit_max = grid->gridm[lc];
+          found = true;
+        }
+      }
+  }
+  *error = MB_ERROR_NO_ERROR;
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       minmisfit_xh: %f\n", misfit->minmisfit_xh);
+    fprintf(stderr, "dbg2       minmisfit_yh: %f\n", misfit->minmisfit_yh);
+    fprintf(stderr, "dbg2       minmisfit_zh: %f\n", misfit->minmisfit_zh);
+    fprintf(stderr, "dbg2       misfit_min:   %f\n", *misfit_min);
+    fprintf(stderr, "dbg2       misfit_max:   %f\n", *misfit_max);
+    fprintf(stderr, "dbg2       error:        %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:       %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+int mbnavadjust_misfit_grid_free(int verbose, struct mbna_misfit_grid *grid, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:     %d\n", verbose);
+    fprintf(stderr, "dbg2       grid:        %p\n", grid);
+  }
+
+  free(grid->grid1);
+  free(grid->grid2);
+  free(grid->gridn1);
+  free(grid->gridn2);
+  free(grid->gridm);
+  free(grid->gridnm);
+  memset(grid, 0, sizeof(struct mbna_misfit_grid));
+  *error = MB_ERROR_NO_ERROR;
+  const int status = MB_SUCCESS;
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+/* Automatic picking of crossing ties without the interactive program. The
+   crossings are picked concurrently using shared cached sections, and the
+   resulting ties are added to the project in crossing order so that the
+   project is the same regardless of the number of threads used. */
+
+struct mbna_autopick_work {
+  int verbose;
+  struct mbna_project *project;
+  void *cache;
+  bool do_vertical;
+  int misfit_mode;
+  int *crossings;
+  struct mbna_autopick_result *results;
+  int ncrossings;
+  int *next;
+  pthread_mutex_t *mutex;
+};
+
+/* number of crossings picked between writes of the project */
+#define MBNA_AUTOPICK_BATCH 256
+
+/*--------------------------------------------------------------------*/
+/* expand the shorter side of a region so that it is square in meters,
+   as the interactive program does to fill its square contour window */
+static void mbnavadjust_autopick_square(double mtodeglon, double mtodeglat, double *lon_min, double *lon_max,
+                                        double *lat_min, double *lat_max) {
+  const double xlength = (*lon_max - *lon_min) / mtodeglon;
+  const double ylength = (*lat_max - *lat_min) / mtodeglat;
+  if (xlength > ylength) {
+    const double lat_mid = 0.5 * (*lat_min + *lat_max);
+    *lat_min = lat_mid - 0.5 * xlength * mtodeglat;
+    *lat_max = lat_mid + 0.5 * xlength * mtodeglat;
+  }
+  else {
+    const double lon_mid = 0.5 * (*lon_min + *lon_max);
+    *lon_min = lon_mid - 0.5 * ylength * mtodeglon;
+    *lon_max = lon_mid + 0.5 * ylength * mtodeglon;
+  }
+}
+/*--------------------------------------------------------------------*/
+/* Pick a tie for one crossing: calculate the misfit over the full extent of
+   both sections, for crossings with more than 50% overlap again centered on
+   the minimum misfit, then over the overlap region and finally over a
+   quarter of the overlap region centered on the focus point. The pick
+   succeeds if the misfit uncertainty is small compared to the overlap
+   region. The misfit is centered on the offsets offset_x, offset_y and
+   offset_z, and the soundings of swath 2 have already been shifted
+   vertically by zoffset. Both the interactive and the batch autopicking
+   use this function. */
+int mbnavadjust_autopick_crossing(int verbose, struct mbna_project *project, int icrossing, struct swath *swath1,
+                                  struct swath *swath2, double offset_x, double offset_y, double offset_z,
+                                  double zoffset, bool do_vertical, int misfit_mode,
+                                  struct mbna_autopick_result *result, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:     %d\n", verbose);
+    fprintf(stderr, "dbg2       project:     %p\n", project);
+    fprintf(stderr, "dbg2       icrossing:   %d\n", icrossing);
+    fprintf(stderr, "dbg2       swath1:      %p\n", swath1);
+    fprintf(stderr, "dbg2       swath2:      %p\n", swath2);
+    fprintf(stderr, "dbg2       offset_x:    %f\n", offset_x);
+    fprintf(stderr, "dbg2       offset_y:    %f\n", offset_y);
+    fprintf(stderr, "dbg2       offset_z:    %f\n", offset_z);
+    fprintf(stderr, "dbg2       zoffset:     %f\n", zoffset);
+    fprintf(stderr, "dbg2       do_vertical: %d\n", do_vertical);
+    fprintf(stderr, "dbg2       misfit_mode: %d\n", misfit_mode);
+  }
+
+  int status = MB_SUCCESS;
+  struct mbna_crossing *crossing = &project->crossings[icrossing];
+  struct mbna_section *section1 = &project->files[crossing->file_id_1].sections[crossing->section_1];
+  struct mbna_section *section2 = &project->files[crossing->file_id_2].sections[crossing->section_2];
+  memset(result, 0, sizeof(struct mbna_autopick_result));
+  struct mbna_misfit_grid grid;
+  memset(&grid, 0, sizeof(struct mbna_misfit_grid));
+
+  struct mbna_misfit *misfit = &result->misfit;
+  misfit->offset_x = offset_x;
+  misfit->offset_y = offset_y;
+  misfit->offset_z = offset_z;
+  double lon_min = MIN(section1->lonmin, section2->lonmin + misfit->offset_x);
+  double lon_max = MAX(section1->lonmax, section2->lonmax + misfit->offset_x);
+  double lat_min = MIN(section1->latmin, section2->latmin + misfit->offset_y);
+  double lat_max = MAX(section1->latmax, section2->latmax + misfit->offset_y);
+  double mtodeglon, mtodeglat;
+  mb_coor_scale(verbose, 0.5 * (lat_min + lat_max), &mtodeglon, &mtodeglat);
+  result->mtodeglon = mtodeglon;
+  result->mtodeglat = mtodeglat;
+
+  /* get misfit over the full extent of both sections */
+  status = mbnavadjust_misfit_calc(verbose, project, swath1, swath2, lon_min, lon_max, lat_min, lat_max,
+                                   mtodeglon, mtodeglat, misfit_mode, zoffset, &grid, misfit, error);
+  mbnavadjust_crossing_overlap(verbose, project, icrossing, error);
+
+  /* if this is a >50% overlap crossing then first set offsets to
+      minimum misfit and then recalculate misfit */
+  if (status == MB_SUCCESS && crossing->overlap > 50) {
+    if (do_vertical) {
+      misfit->offset_x = misfit->minmisfit_x;
+      misfit->offset_y = misfit->minmisfit_y;
+      misfit->offset_z = misfit->minmisfit_z;
+    }
+    else {
+      misfit->offset_x = misfit->minmisfit_xh;
+      misfit->offset_y = misfit->minmisfit_yh;
+      misfit->offset_z = misfit->minmisfit_zh;
+    }
+    status = mbnavadjust_misfit_calc(verbose, project, swath1, swath2, lon_min, lon_max, lat_min, lat_max,
+                                     mtodeglon, mtodeglat, misfit_mode, zoffset, &grid, misfit, error);
+  }
+
+  /* recalculate misfit over the overlap region */
+  double overlap_lon_min, overlap_lon_max, overlap_lat_min, overlap_lat_max;
+  double overlap_scale = 0.0;
+  if (status == MB_SUCCESS) {
+    mbnavadjust_crossing_overlapbounds(verbose, project, icrossing, misfit->offset_x, misfit->offset_y,
+                                       &overlap_lon_min, &overlap_lon_max, &overlap_lat_min, &overlap_lat_max,
+                                       error);
+    lon_min = overlap_lon_min;
+    lon_max = overlap_lon_max;
+    lat_min = overlap_lat_min;
+    lat_max = overlap_lat_max;
+    overlap_scale = MIN((overlap_lon_max - overlap_lon_min) / mtodeglon, (overlap_lat_max - overlap_lat_min) / mtodeglat);
+    mbnavadjust_autopick_square(mtodeglon, mtodeglat, &lon_min, &lon_max, &lat_min, &lat_max);
+    status = mbnavadjust_misfit_calc(verbose, project, swath1, swath2, lon_min, lon_max, lat_min, lat_max,
+                                     mtodeglon, mtodeglat, misfit_mode, zoffset, &grid, misfit, error);
+  }
+
+  /* if the focus point is inside the overlap region recalculate misfit over
+     one-quarter of the overlap region centered on the focus point */
+  if (status == MB_SUCCESS) {
+    int isnav1_focus, isnav2_focus;
+    double lon_focus, lat_focus;
+    mbnavadjust_crossing_focuspoint(verbose, project, icrossing, misfit->offset_x, misfit->offset_y,
+                                    &isnav1_focus, &isnav2_focus, &lon_focus, &lat_focus, error);
+    if (overlap_lon_max > overlap_lon_min && overlap_lat_max > overlap_lat_min
+      && lon_focus >= overlap_lon_min && lon_focus <= overlap_lon_max
+      && lat_focus >= overlap_lat_min && lat_focus <= overlap_lat_max) {
+      const double dlon = 0.25 * (overlap_lon_max - overlap_lon_min);
+      const double dlat = 0.25 * (overlap_lat_max - overlap_lat_min);
+      lon_min = MAX((lon_focus - dlon), overlap_lon_min);
+      lon_max = MIN((lon_focus + dlon), overlap_lon_max);
+      lat_min = MAX((lat_focus - dlat), overlap_lat_min);
+      lat_max = MIN((lat_focus + dlat), overlap_lat_max);
+      mbnavadjust_autopick_square(mtodeglon, mtodeglat, &lon_min, &lon_max, &lat_min, &lat_max);
+      status = mbnavadjust_misfit_calc(verbose, project, swath1, swath2, lon_min, lon_max, lat_min, lat_max,
+                                       mtodeglon, mtodeglat, misfit_mode, zoffset, &grid, misfit, error);
+    }
+  }
+
+  /* check uncertainty estimate for a good pick */
+  if (status == MB_SUCCESS) {
+    result->long_axis = MAX(misfit->sr1, misfit->sr2);
+    result->threshold = 0.5 * overlap_scale;
+    if (MAX(misfit->sr1, misfit->sr2) < 0.5 * overlap_scale && MIN(misfit->sr1, misfit->sr2) > 0.0) {
+      result->success = true;
+      if (do_vertical) {
+        result->offset_x = misfit->minmisfit_x;
+        result->offset_y = misfit->minmisfit_y;
+        result->offset_z = misfit->minmisfit_z;
+      }
+      else {
+        result->offset_x = misfit->minmisfit_xh;
+        result->offset_y = misfit->minmisfit_yh;
+        result->offset_z = misfit->minmisfit_zh;
+      }
+
+      /* tie the nav points closest to the center of the region */
+      const double lon_center = 0.5 * (lon_min + lon_max);
+      const double lat_center = 0.5 * (lat_min + lat_max);
+      double distance = 999999.999;
+      for (int i = 0; i < section1->num_snav; i++) {
+        const double dx = (section1->snav_lon[i] - lon_center) / mtodeglon;
+        const double dy = (section1->snav_lat[i] - lat_center) / mtodeglat;
+        const double d = sqrt(dx * dx + dy * dy);
+        if (d < distance) {
+          distance = d;
+          result->snav_1 = i;
+        }
+      }
+      distance = 999999.999;
+      for (int i = 0; i < section2->num_snav; i++) {
+        const double dx = (section2->snav_lon[i] + result->offset_x - lon_center) / mtodeglon;
+        const double dy = (section2->snav_lat[i] + result->offset_y - lat_center) / mtodeglat;
+        const double d = sqrt(dx * dx + dy * dy);
+        if (d < distance) {
+          distance = d;
+          result->snav_2 = i;
+        }
+      }
+    }
+  }
+
+  result->lon_min = lon_min;
+  result->lon_max = lon_max;
+  result->lat_min = lat_min;
+  result->lat_max = lat_max;
+
+  int error2 = MB_ERROR_NO_ERROR;
+  mbnavadjust_misfit_grid_free(verbose, &grid, &error2);
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       success:     %d\n", result->success);
+    fprintf(stderr, "dbg2       offset_x:    %f\n", result->offset_x);
+    fprintf(stderr, "dbg2       offset_y:    %f\n", result->offset_y);
+    fprintf(stderr, "dbg2       offset_z:    %f\n", result->offset_z);
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+/* pick one crossing of the batch with its sections from the shared cache,
+   starting from the offsets of the current inversion, if any */
+static int mbnavadjust_autopick_cached(int verbose, struct mbna_project *project, void *cache, int icrossing,
+                                       bool do_vertical, int misfit_mode, struct mbna_autopick_result *result,
+                                       int *error) {
+  struct mbna_crossing *crossing = &project->crossings[icrossing];
+  struct mbna_section *section1 = &project->files[crossing->file_id_1].sections[crossing->section_1];
+  struct mbna_section *section2 = &project->files[crossing->file_id_2].sections[crossing->section_2];
+  double offset_x = 0.0;
+  double offset_y = 0.0;
+  double offset_z = 0.0;
+  if (project->inversion_status != MBNA_INVERSION_NONE) {
+    offset_x = section2->snav_lon_offset[0] - section1->snav_lon_offset[0];
+    offset_y = section2->snav_lat_offset[0] - section1->snav_lat_offset[0];
+    offset_z = section2->snav_z_offset[0] - section1->snav_z_offset[0];
+  }
+
+  /* get the sections */
+  struct mbna_swathraw *swathraw1 = NULL;
+  struct mbna_swathraw *swathraw2 = NULL;
+  struct swath *swath1 = NULL;
+  struct swath *swath2 = NULL;
+  int status = mbnavadjust_section_cache_get(verbose, cache, crossing->file_id_1, crossing->section_1,
+                                             (void **)&swathraw1, (void **)&swath1, error);
+  if (status == MB_SUCCESS) {
+    status = mbnavadjust_section_cache_get(verbose, cache, crossing->file_id_2, crossing->section_2,
+                                           (void **)&swathraw2, (void **)&swath2, error);
+    if (status == MB_FAILURE) {
+      int error2 = MB_ERROR_NO_ERROR;
+      mbnavadjust_section_cache_release(verbose, cache, crossing->file_id_1, crossing->section_1, &error2);
+    }
+  }
+  if (status == MB_FAILURE)
+    return (status);
+
+  /* the cached sections are translated without a depth offset */
+  status = mbnavadjust_autopick_crossing(verbose, project, icrossing, swath1, swath2, offset_x, offset_y, offset_z,
+                                         0.0, do_vertical, misfit_mode, result, error);
+
+  int error2 = MB_ERROR_NO_ERROR;
+  mbnavadjust_section_cache_release(verbose, cache, crossing->file_id_1, crossing->section_1, &error2);
+  mbnavadjust_section_cache_release(verbose, cache, crossing->file_id_2, crossing->section_2, &error2);
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+static void *mbnavadjust_autopick_worker(void *arg) {
+  struct mbna_autopick_work *work = (struct mbna_autopick_work *)arg;
+  while (true) {
+    pthread_mutex_lock(work->mutex);
+    const int i = *work->next;
+    if (i < work->ncrossings)
+      (*work->next)++;
+    pthread_mutex_unlock(work->mutex);
+    if (i >= work->ncrossings)
+      break;
+    int error = MB_ERROR_NO_ERROR;
+    if (mbnavadjust_autopick_cached(work->verbose, work->project, work->cache, work->crossings[i],
+                                    work->do_vertical, work->misfit_mode, &work->results[i], &error) == MB_FAILURE)
+      work->results[i].success = false;
+  }
+  return (NULL);
+}
+/*--------------------------------------------------------------------*/
+/* add an autopicked tie to a crossing as the interactive program does */
+static int mbnavadjust_autopick_addtie(int verbose, struct mbna_project *project, int icrossing,
+                                       struct mbna_autopick_result *result, int *error) {
+  int status = MB_SUCCESS;
+  struct mbna_crossing *crossing = &project->crossings[icrossing];
+  if (crossing->num_ties >= MBNA_SNAV_NUM) {
+    *error = MB_ERROR_BAD_PARAMETER;
+    return (MB_FAILURE);
+  }
+  struct mbna_section *section1 = &project->files[crossing->file_id_1].sections[crossing->section_1];
+  struct mbna_section *section2 = &project->files[crossing->file_id_2].sections[crossing->section_2];
+  const int itie = crossing->num_ties;
+  struct mbna_tie *tie = &crossing->ties[itie];
+  crossing->num_ties++;
+  project->num_ties++;
+  if (crossing->status == MBNA_CROSSING_STATUS_NONE) {
+    project->num_crossings_analyzed++;
+    if (crossing->truecrossing)
+      project->num_truecrossings_analyzed++;
+  }
+  crossing->status = MBNA_CROSSING_STATUS_SET;
+
+  tie->status = MBNA_TIE_XYZ;
+  tie->icrossing = icrossing;
+  tie->itie = itie;
+  tie->snav_1 = result->snav_1;
+  tie->snav_2 = result->snav_2;
+  tie->snav_1_time_d = section1->snav_time_d[tie->snav_1];
+  tie->snav_2_time_d = section2->snav_time_d[tie->snav_2];
+  tie->offset_x = result->offset_x;
+  tie->offset_y = result->offset_y;
+  tie->offset_x_m = result->offset_x / result->mtodeglon;
+  tie->offset_y_m = result->offset_y / result->mtodeglat;
+  tie->offset_z_m = result->offset_z;
+  tie->sigmar1 = result->misfit.sr1;
+  tie->sigmar2 = result->misfit.sr2;
+  tie->sigmar3 = result->misfit.sr3;
+  for (int i = 0; i < 3; i++) {
+    tie->sigmax1[i] = result->misfit.sx1[i];
+    tie->sigmax2[i] = result->misfit.sx2[i];
+    tie->sigmax3[i] = result->misfit.sx3[i];
+  }
+  if (tie->sigmar1 < MBNA_SMALL) {
+    tie->sigmar1 = MBNA_SMALL;
+    tie->sigmax1[0] = 1.0;
+    tie->sigmax1[1] = 0.0;
+    tie->sigmax1[2] = 0.0;
+  }
+  if (tie->sigmar2 < MBNA_SMALL) {
+    tie->sigmar2 = MBNA_SMALL;
+    tie->sigmax2[0] = 0.0;
+    tie->sigmax2[1] = 1.0;
+    tie->sigmax2[2] = 0.0;
+  }
+  if (tie->sigmar3 < MBNA_ZSMALL) {
+    tie->sigmar3 = MBNA_ZSMALL;
+    tie->sigmax3[0] = 0.0;
+    tie->sigmax3[1] = 0.0;
+    tie->sigmax3[2] = 1.0;
+  }
+
+  const double invert_offset_x = section2->snav_lon_offset[tie->snav_2] - section1->snav_lon_offset[tie->snav_1];
+  const double invert_offset_y = section2->snav_lat_offset[tie->snav_2] - section1->snav_lat_offset[tie->snav_1];
+  const double invert_offset_z = section2->snav_z_offset[tie->snav_2] - section1->snav_z_offset[tie->snav_1];
+  tie->inversion_status = MBNA_INVERSION_NONE;
+  tie->inversion_offset_x = invert_offset_x;
+  tie->inversion_offset_y = invert_offset_y;
+  tie->inversion_offset_x_m = invert_offset_x / result->mtodeglon;
+  tie->inversion_offset_y_m = invert_offset_y / result->mtodeglat;
+  tie->inversion_offset_z_m = invert_offset_z;
+  if (project->inversion_status == MBNA_INVERSION_CURRENT)
+    project->inversion_status = MBNA_INVERSION_OLD;
+
+  /* reset tie counts for snavs */
+  section1->snav_num_ties[tie->snav_1]++;
+  section2->snav_num_ties[tie->snav_2]++;
+  project->modelplot_uptodate = false;
+
+  /* add info text */
+  char message[MB_PATH_MAXLINE];
+  snprintf(message, sizeof(message), "Add Tie Point %d of Crossing %d\n > Nav points: %2.2d:%4.4d:%2.2d:%2.2d %2.2d:%4.4d:%2.2d:%2.2d\n > Offsets: %f %f %f m\n",
+          itie, icrossing,
+          project->files[crossing->file_id_1].block, crossing->file_id_1, crossing->section_1, tie->snav_1,
+          project->files[crossing->file_id_2].block, crossing->file_id_2, crossing->section_2, tie->snav_2,
+          tie->offset_x_m, tie->offset_y_m, tie->offset_z_m);
+  mbnavadjust_info_add(verbose, project, message, true, error);
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
+int mbnavadjust_autopick_batch(int verbose, struct mbna_project *project, bool do_vertical, int misfit_mode,
+                               int nthreads, size_t cache_size, int *error) {
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
+    fprintf(stderr, "dbg2  Input arguments:\n");
+    fprintf(stderr, "dbg2       verbose:     %d\n", verbose);
+    fprintf(stderr, "dbg2       project:     %p\n", project);
+    fprintf(stderr, "dbg2       do_vertical: %d\n", do_vertical);
+    fprintf(stderr, "dbg2       misfit_mode: %d\n", misfit_mode);
+    fprintf(stderr, "dbg2       nthreads:    %d\n", nthreads);
+    fprintf(stderr, "dbg2       cache_size:  %zu\n", cache_size);
+  }
+
+  int status = MB_SUCCESS;
+  *error = MB_ERROR_NO_ERROR;
+
+  if (project->open && project->num_crossings > 0) {
+    // get the unanalyzed crossings with sufficient overlap for which both
+    // sections are sufficiently long (track length >=0.25 * project->section_length)
+    int *crossings = (int *)malloc(project->num_crossings * sizeof(int));
+    struct mbna_autopick_result *results =
+        (struct mbna_autopick_result *)malloc(MBNA_AUTOPICK_BATCH * sizeof(struct mbna_autopick_result));
+    void *cache = NULL;
+    if (crossings == NULL || results == NULL) {
+      *error = MB_ERROR_MEMORY_FAIL;
+      status = MB_FAILURE;
+    }
+    else {
+      status = mbnavadjust_section_cache_init(verbose, project, cache_size, &cache, error);
+    }
+    int ncrossings = 0;
+    for (int icrossing = 0; status == MB_SUCCESS && icrossing < project->num_crossings; icrossing++) {
+      struct mbna_crossing *crossing = &project->crossings[icrossing];
+      struct mbna_section *section1 = &project->files[crossing->file_id_1].sections[crossing->section_1];
+      struct mbna_section *section2 = &project->files[crossing->file_id_2].sections[crossing->section_2];
+      if (crossing->status == MBNA_CROSSING_STATUS_NONE && crossing->overlap >= MBNA_MEDIOCREOVERLAP_THRESHOLD
+          && section1->distance >= 0.25 * project->section_length
+          && section2->distance >= 0.25 * project->section_length)
+        crossings[ncrossings++] = icrossing;
+    }
+
+    /* get number of threads to use */
+    if (nthreads <= 0) {
+      const long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+      nthreads = ncpu > 0 ? (int)ncpu : 1;
+    }
+    nthreads = MAX(1, MIN(nthreads, MB_THREAD_MAX));
+    if (status == MB_SUCCESS)
+      fprintf(stderr, "Autopicking %d crossings using %d threads...\n", ncrossings, nthreads);
+
+    int nsuccess = 0;
+    for (int ibatch = 0; status == MB_SUCCESS && ibatch < ncrossings; ibatch += MBNA_AUTOPICK_BATCH) {
+      const int nbatch = MIN(MBNA_AUTOPICK_BATCH, ncrossings - ibatch);
+
+      /* pick the crossings of this batch in parallel */
+      int next = 0;
+      pthread_mutex_t mutex;
+      pthread_mutex_init(&mutex, NULL);
+      struct mbna_autopick_work work;
+      work.verbose = verbose;
+      work.project = project;
+      work.cache = cache;
+      work.do_vertical = do_vertical;
+      work.misfit_mode = misfit_mode;
+      work.crossings = &crossings[ibatch];
+      work.results = results;
+      work.ncrossings = nbatch;
+      work.next = &next;
+      work.mutex = &mutex;
+      pthread_t threads[MB_THREAD_MAX];
+      int nstarted = 0;
+      for (int ithread = 1; ithread < MIN(nthreads, nbatch); ithread++) {
+        if (pthread_create(&threads[ithread], NULL, mbnavadjust_autopick_worker, &work) != 0)
+          break;
+        nstarted++;
+      }
+      mbnavadjust_autopick_worker(&work);
+      for (int ithread = 1; ithread <= nstarted; ithread++)
+        pthread_join(threads[ithread], NULL);
+      pthread_mutex_destroy(&mutex);
+
+      /* add the ties in crossing order */
+      for (int i = 0; i < nbatch; i++) {
+        struct mbna_autopick_result *result = &results[i];
+        fprintf(stderr, "Crossing %d: Long misfit axis:%.3f Threshold:%.3f", crossings[ibatch + i],
+                result->long_axis, result->threshold);
+        if (result->success
+            && mbnavadjust_autopick_addtie(verbose, project, crossings[ibatch + i], result, error) == MB_SUCCESS) {
+          fprintf(stderr, " AUTOPICK SUCCEEDED\n");
+          nsuccess++;
+        }
+        else {
+          fprintf(stderr, " AUTOPICK FAILED\n");
+        }
+      }
+
+      /* write updated project */
+      status = mbnavadjust_write_project(verbose, project, __FILE__, __LINE__, __func__, error);
+      project->save_count = 0;
+    }
+    if (status == MB_SUCCESS)
+      fprintf(stderr, "Autopicked %d of %d crossings\n", nsuccess, ncrossings);
+
+    int error2 = MB_ERROR_NO_ERROR;
+    mbnavadjust_section_cache_free(verbose, &cache, &error2);
+    free(crossings);
+    free(results);
+  }
+
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
+    fprintf(stderr, "dbg2  Return values:\n");
+    fprintf(stderr, "dbg2       error:       %d\n", *error);
+    fprintf(stderr, "dbg2  Return status:\n");
+    fprintf(stderr, "dbg2       status:      %d\n", status);
+  }
+
+  return (status);
+}
+/*--------------------------------------------------------------------*/
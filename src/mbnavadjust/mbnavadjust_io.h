@@ -129,6 +129,10 @@
 #define MBNA_MISFIT_DIMXY 61
 #define MBNA_MISFIT_NTHRESHOLD (MBNA_MISFIT_DIMXY * MBNA_MISFIT_DIMXY / 36)
 #define MBNA_MISFIT_DIMZ 51
+#define MBNA_MISFIT_MODE_DIRECT 0
+#define MBNA_MISFIT_MODE_FFT 1
+#define MBNA_MISFIT_MODE_FFTREFINE 2
+#define MBNA_SECTION_CACHE_DEFAULT 2048
 #define MBNA_BIAS_SAME 0
 #define MBNA_BIAS_DIFFERENT 1
 #define MBNA_MEDIOCREOVERLAP_THRESHOLD 10
@@ -422,6 +426,9 @@ struct mbna_project {
   int modelplot_style;
   int modelplot_uptodate;
 
+  /* sections loaded for viewing and analysis, shared across crossings */
+  void *section_cache;
+
   /* function pointers for contour plotting */
   void (*mbnavadjust_plot)(double xx, double yy, int ipen);
   void (*mbnavadjust_newpen)(int icolor);
@@ -469,6 +476,81 @@ struct mbna_swathraw {
   int npings_max;
   int beams_bath;
   struct mbna_pingraw *pingraws;
+
+  /* compact section file mapped into memory, if the beam arrays of
+     the pingraws point into it rather than being allocated */
+  void *mapped;
+  size_t mapped_size;
+};
+struct mbna_misfit_grid {
+  /* gridded soundings of both sections */
+  int grid_nx;
+  int grid_ny;
+  int grid_nxy;
+  double grid_dx;
+  double grid_dy;
+  double grid_olon;
+  double grid_olat;
+  double *grid1;
+  double *grid2;
+  int *gridn1;
+  int *gridn2;
+
+  /* misfit as a function of the lateral and z offsets of the second section */
+  int gridm_nx;
+  int gridm_ny;
+  int nzmisfitcalc;
+  int gridm_nxyz;
+  double zmin;
+  double zmax;
+  double zoff_dz;
+  double *gridm;
+  int *gridnm;
+  int nmisfit;
+  double misfit_min;
+  double misfit_max;
+};
+struct mbna_misfit {
+  /* offsets of the second section at the center of the misfit grid */
+  double offset_x;
+  double offset_y;
+  double offset_z;
+
+  /* minimum misfit in 3D and in the plane of the current z offset */
+  int nthreshold;
+  double minmisfit;
+  int minmisfit_n;
+  double minmisfit_x;
+  double minmisfit_y;
+  double minmisfit_z;
+  double minmisfit_xh;
+  double minmisfit_yh;
+  double minmisfit_zh;
+
+  /* uncertainty axes at the minimum misfit */
+  double sr1;
+  double sx1[3];
+  double sr2;
+  double sx2[3];
+  double sr3;
+  double sx3[3];
+};
+struct mbna_autopick_result {
+  bool success;
+  double long_axis;
+  double threshold;
+  double mtodeglon;
+  double mtodeglat;
+  double lon_min;
+  double lon_max;
+  double lat_min;
+  double lat_max;
+  double offset_x;
+  double offset_y;
+  double offset_z;
+  struct mbna_misfit misfit;
+  int snav_1;
+  int snav_2;
 };
 
 int mbnavadjust_new_project(int verbose, char *projectpath, double section_length, int section_soundings, double cont_int,
@@ -529,5 +611,29 @@ int mbnavadjust_crossing_compare(const void *a, const void *b);
 int mbnavadjust_tie_compare(const void *a, const void *b);
 int mbnavadjust_globaltie_compare(const void *a, const void *b);
 int mbnavadjust_info_add(int verbose, struct mbna_project *project, char *info, bool timetag, int *error);
+int mbnavadjust_misfit_fft(int verbose, int grid_nx, int grid_ny, double *grid1, int *gridn1, double *grid2, int *gridn2,
+                           int gridm_nx, int gridm_ny, int nzmisfitcalc, double zmin, double zoff_dz, double offset_z,
+                           double *gridm, int *gridnm, int *error);
+int mbnavadjust_misfit_refine(int verbose, int gridm_nx, int gridm_ny, int nzmisfitcalc, double *gridm, int *gridnm,
+                              int nthreshold, int ic, int jc, int kc, double *dic, double *djc, double *dkc, int *error);
+int mbnavadjust_misfit_calc(int verbose, struct mbna_project *project, struct swath *swath1, struct swath *swath2,
+                            double lon_min, double lon_max, double lat_min, double lat_max, double mtodeglon,
+                            double mtodeglat, int misfit_mode, double zoffset, struct mbna_misfit_grid *grid,
+                            struct mbna_misfit *misfit, int *error);
+int mbnavadjust_misfit_xy(int verbose, struct mbna_misfit_grid *grid, double offset_z, struct mbna_misfit *misfit,
+                          double *misfit_min, double *misfit_max, int *error);
+int mbnavadjust_misfit_grid_free(int verbose, struct mbna_misfit_grid *grid, int *error);
+int mbnavadjust_autopick_crossing(int verbose, struct mbna_project *project, int icrossing, struct swath *swath1,
+                                  struct swath *swath2, double offset_x, double offset_y, double offset_z,
+                                  double zoffset, bool do_vertical, int misfit_mode,
+                                  struct mbna_autopick_result *result, int *error);
+int mbnavadjust_section_cache_init(int verbose, struct mbna_project *project, size_t size_max,
+                                   void **cache_ptr, int *error);
+int mbnavadjust_section_cache_get(int verbose, void *cache_ptr, int file_id, int section_id,
+                                  void **swathraw_ptr, void **swath_ptr, int *error);
+int mbnavadjust_section_cache_release(int verbose, void *cache_ptr, int file_id, int section_id, int *error);
+int mbnavadjust_section_cache_free(int verbose, void **cache_ptr, int *error);
+int mbnavadjust_autopick_batch(int verbose, struct mbna_project *project, bool do_vertical, int misfit_mode,
+                               int nthreads, size_t cache_size, int *error);
 
 /*--------------------------------------------------------------------*/
@@ -93,7 +93,7 @@ struct swathraw {
 /* id variables */
 static const char program_name[] = "mbnavadjust";
 static const char help_message[] = "mbnavadjust is an interactive navigation adjustment package for swath sonar data.\n";
-static const char usage_message[] = "mbnavadjust [-Iproject -V -H]";
+static const char usage_message[] = "mbnavadjust [-Iproject -Mmisfitmode -P -U -V -H]";
 
 /* status variables */
 int error = MB_ERROR_NO_ERROR;
@@ -171,6 +171,7 @@ double *gridmeq = NULL;
 int *gridn1 = NULL;
 int *gridn2 = NULL;
 int *gridnm = NULL;
+struct mbna_misfit_grid misfit_grid; /* owns grid1, grid2, gridn1, gridn2, gridm and gridnm */
 #define NINTERVALS_MISFIT 80
 int nmisfit_intervals = NINTERVALS_MISFIT;
 double misfit_intervals[NINTERVALS_MISFIT];
@@ -180,6 +181,12 @@ double zmin, zmax;
 double zmisfitmin;
 double zmisfitmax;
 
+/* checksum of the project structure at the last navigation inversion, used
+   to decide if the next inversion can start from its solution - it is only
+   held in memory, so the first inversion of each session is always full */
+bool invert_signature_valid = false;
+unsigned int invert_signature = 0;
+
 /* time, user, host variables */
 time_t right_now;
 char date[32], user[MBP_FILENAMESIZE], *user_ptr, host[MBP_FILENAMESIZE];
@@ -261,6 +268,7 @@ int mbnavadjust_init_globals() {
   mbna_offsetweight = 0.01;
   mbna_zweightfactor = 1.0;
   mbna_misfit_center = MBNA_MISFIT_AUTOCENTER;
+  mbna_misfit_mode = MBNA_MISFIT_MODE_FFT;
   mbna_minmisfit_nthreshold = MBNA_MISFIT_NTHRESHOLD;
   mbna_minmisfit = 0.0;
   mbna_bias_mode = MBNA_BIAS_SAME;
@@ -281,6 +289,8 @@ int mbnavadjust_init_globals() {
   mbna_block_select1 = MBNA_SELECT_NONE;
   mbna_block_select2 = MBNA_SELECT_NONE;
   mbna_reset_crossings = false;
+  mbna_invert_precondition = false;
+  mbna_invert_incremental = false;
   mbna_bin_swathwidth = 160.0;
   mbna_bin_pseudobeamwidth = 1.0;
   mbna_bin_beams_bath = mbna_bin_swathwidth / mbna_bin_pseudobeamwidth + 1;
@@ -341,7 +351,7 @@ int mbnavadjust_init(int argc, char **argv) {
   // bool flag = false;
 
   /* process argument list */
-  while ((c = getopt(argc, argv, "VvHhDdI:i:Rr")) != -1)
+  while ((c = getopt(argc, argv, "VvHhDdI:i:M:m:PpRrUu")) != -1)
     switch (c) {
     case 'H':
     case 'h':
@@ -362,10 +372,24 @@ int mbnavadjust_init(int argc, char **argv) {
       // flag = true;
       fileflag = true;
       break;
+    case 'M':
+    case 'm':
+      sscanf(optarg, "%d", &mbna_misfit_mode);
+      if (mbna_misfit_mode < MBNA_MISFIT_MODE_DIRECT || mbna_misfit_mode > MBNA_MISFIT_MODE_FFTREFINE)
+        mbna_misfit_mode = MBNA_MISFIT_MODE_FFT;
+      break;
+    case 'P':
+    case 'p':
+      mbna_invert_precondition = true;
+      break;
     case 'R':
     case 'r':
       mbna_reset_crossings = true;
       break;
+    case 'U':
+    case 'u':
+      mbna_invert_incremental = true;
+      break;
     case '?':
       errflg = true;
     }
@@ -388,6 +412,8 @@ int mbnavadjust_init(int argc, char **argv) {
     fprintf(stderr, "dbg2       mbna_verbose:         %d\n", mbna_verbose);
     fprintf(stderr, "dbg2       help:            %d\n", help);
     fprintf(stderr, "dbg2       input file:      %s\n", ifile);
+    fprintf(stderr, "dbg2       misfit mode:     %d\n", mbna_misfit_mode);
+    fprintf(stderr, "dbg2       incremental:     %d\n", mbna_invert_incremental);
   }
 
   if (help) {
@@ -3804,14 +3830,17 @@ int mbnavadjust_crossing_load() {
 // __FILE__, __LINE__, __FUNCTION__, mbna_plot_lon_min, mbna_plot_lon_max, mbna_plot_lat_min, mbna_plot_lat_max);
     mb_coor_scale(mbna_verbose, 0.5 * (mbna_lat_min + mbna_lat_max), &mbna_mtodeglon, &mbna_mtodeglat);
 
-    /* load sections */
+    /* load sections, reusing sections held in the project section cache */
+    if (project.section_cache == NULL)
+      mbnavadjust_section_cache_init(mbna_verbose, &project, (size_t)MBNA_SECTION_CACHE_DEFAULT * 1024 * 1024,
+                                     &project.section_cache, &error);
     snprintf(message, sizeof(message), "Loading section 1 of crossing %d...", mbna_current_crossing);
     do_message_update(message);
-    status = mbnavadjust_section_load(mbna_verbose, &project, mbna_file_id_1, mbna_section_1,
+    status = mbnavadjust_section_cache_get(mbna_verbose, project.section_cache, mbna_file_id_1, mbna_section_1,
                                           (void **)&swathraw1, (void **)&swath1, &error);
     snprintf(message, sizeof(message), "Loading section 2 of crossing %d...", mbna_current_crossing);
     do_message_update(message);
-    status = mbnavadjust_section_load(mbna_verbose, &project, mbna_file_id_2, mbna_section_2,
+    status = mbnavadjust_section_cache_get(mbna_verbose, project.section_cache, mbna_file_id_2, mbna_section_2,
                                           (void **)&swathraw2, (void **)&swath2, &error);
 
     /* get lon lat positions for soundings */
@@ -3882,8 +3911,16 @@ int mbnavadjust_crossing_unload() {
 
   /* unload loaded crossing */
   if (mbna_naverr_mode == MBNA_NAVERR_MODE_CROSSING) {
-    status = mbnavadjust_section_unload(mbna_verbose, (void **)&swathraw1, (void **)&swath1, &error);
-    status = mbnavadjust_section_unload(mbna_verbose, (void **)&swathraw2, (void **)&swath2, &error);
+    if (project.section_cache != NULL) {
+      status = mbnavadjust_section_cache_release(mbna_verbose, project.section_cache, mbna_file_id_1, mbna_section_1,
+                                                 &error);
+      status = mbnavadjust_section_cache_release(mbna_verbose, project.section_cache, mbna_file_id_2, mbna_section_2,
+                                                 &error);
+    }
+    swathraw1 = NULL;
+    swath1 = NULL;
+    swathraw2 = NULL;
+    swath2 = NULL;
 
     if (mbna_contour1.vector != NULL && mbna_contour1.nvector_alloc > 0) {
       free(mbna_contour1.vector);
@@ -3905,27 +3942,10 @@ int mbnavadjust_crossing_unload() {
     gridm_nx = 0;
     gridm_ny = 0;
     gridm_nxyz = 0;
-    if (grid1 != NULL) {
-      free(grid1);
-    }
-    if (grid2 != NULL) {
-      free(grid2);
-    }
-    if (gridm != NULL) {
-      free(gridm);
-    }
+    mbnavadjust_misfit_grid_free(mbna_verbose, &misfit_grid, &error);
     if (gridmeq != NULL) {
       free(gridmeq);
     }
-    if (gridn1 != NULL) {
-      free(gridn1);
-    }
-    if (gridn2 != NULL) {
-      free(gridn2);
-    }
-    if (gridnm != NULL) {
-      free(gridnm);
-    }
     grid1 = NULL;
     grid2 = NULL;
     gridm = NULL;
@@ -4338,27 +4358,10 @@ int mbnavadjust_referenceplussection_unload() {
     gridm_nx = 0;
     gridm_ny = 0;
     gridm_nxyz = 0;
-    if (grid1 != NULL) {
-      free(grid1);
-    }
-    if (grid2 != NULL) {
-      free(grid2);
-    }
-    if (gridm != NULL) {
-      free(gridm);
-    }
+    mbnavadjust_misfit_grid_free(mbna_verbose, &misfit_grid, &error);
     if (gridmeq != NULL) {
       free(gridmeq);
     }
-    if (gridn1 != NULL) {
-      free(gridn1);
-    }
-    if (gridn2 != NULL) {
-      free(gridn2);
-    }
-    if (gridnm != NULL) {
-      free(gridnm);
-    }
     grid1 = NULL;
     grid2 = NULL;
     gridm = NULL;
@@ -4522,6 +4525,28 @@ int mbnavadjust_naverr_snavpoints(int ix, int iy) {
   return (status);
 }
 /*--------------------------------------------------------------------*/
+/* copy the misfit calculated by mbnavadjust_misfit_calc() to the globals
+   used for display and for adding ties */
+static void mbnavadjust_misfit_set(const struct mbna_misfit *misfit) {
+  mbna_minmisfit_nthreshold = misfit->nthreshold;
+  mbna_minmisfit = misfit->minmisfit;
+  mbna_minmisfit_n = misfit->minmisfit_n;
+  mbna_minmisfit_x = misfit->minmisfit_x;
+  mbna_minmisfit_y = misfit->minmisfit_y;
+  mbna_minmisfit_z = misfit->minmisfit_z;
+  mbna_minmisfit_xh = misfit->minmisfit_xh;
+  mbna_minmisfit_yh = misfit->minmisfit_yh;
+  mbna_minmisfit_zh = misfit->minmisfit_zh;
+  mbna_minmisfit_sr1 = misfit->sr1;
+  mbna_minmisfit_sr2 = misfit->sr2;
+  mbna_minmisfit_sr3 = misfit->sr3;
+  for (int i = 0; i < 3; i++) {
+    mbna_minmisfit_sx1[i] = misfit->sx1[i];
+    mbna_minmisfit_sx2[i] = misfit->sx2[i];
+    mbna_minmisfit_sx3[i] = misfit->sx3[i];
+  }
+}
+/*--------------------------------------------------------------------*/
 int mbnavadjust_get_misfit() {
   if (mbna_verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
@@ -4529,19 +4554,7 @@ int mbnavadjust_get_misfit() {
 
   int status = MB_SUCCESS;
   double dinterval;
-  double zoff;
-  double minmisfitthreshold, dotproduct;
-  double x, y, z, r;
-  double dotproductsave2;
-  double rsave2;
-  double dotproductsave3;
-  double rsave3;
-  bool found;
-  int igx, igy;
-  int lc;
-  int ioff, joff, istart, iend, jstart, jend;
-  int i2, j2, k1, k2;
-  int k, ll;
+  int ll;
   void *tptr;
 
   if (project.open
@@ -4558,39 +4571,7 @@ int mbnavadjust_get_misfit() {
     if (mbna_verbose > 0)
       fprintf(stderr, "%s\n", message);
 
-    /* reset sounding density threshold for misfit calculation
-        - will be tuned down if necessary */
-    mbna_minmisfit_nthreshold = MBNA_MISFIT_NTHRESHOLD;
-
-    /* figure out lateral extent of grids */
-    grid_nx = MBNA_MISFIT_DIMXY;
-    grid_ny = MBNA_MISFIT_DIMXY;
-    if ((mbna_plot_lon_max - mbna_plot_lon_min) / mbna_mtodeglon > (mbna_plot_lat_max - mbna_plot_lat_min) / mbna_mtodeglat) {
-      grid_dx = (mbna_plot_lon_max - mbna_plot_lon_min) / (grid_nx - 1);
-      grid_dy = grid_dx * mbna_mtodeglat / mbna_mtodeglon;
-//fprintf(stderr,"DEBUG %s %d: grid scale: grid_dx:%f grid_dy:%f\n",
-//__FILE__,__LINE__,
-//grid_dx,grid_dy);
-    }
-    else {
-      grid_dy = (mbna_plot_lat_max - mbna_plot_lat_min) / (grid_ny - 1);
-      grid_dx = grid_dy * mbna_mtodeglon / mbna_mtodeglat;
-      /* fprintf(stderr,"DEBUG %s %d: grid scale: grid_dx:%f grid_dy:%f\n",
-      __FILE__,__LINE__,
-      grid_dx,grid_dy); */
-    }
-    grid_nxy = grid_nx * grid_ny;
-    grid_olon = 0.5 * (mbna_plot_lon_min + mbna_plot_lon_max) - (grid_nx / 2 + 0.5) * grid_dx;
-    grid_olat = 0.5 * (mbna_plot_lat_min + mbna_plot_lat_max) - (grid_ny / 2 + 0.5) * grid_dy;
-//fprintf(stderr,"DEBUG %s %d: grid_olon:%.10f grid_olat:%.10f\n",
-//__FILE__,__LINE__,
-//grid_olon,grid_olat);
-
-    /* get 3d misfit grid */
-    nzmisfitcalc = MBNA_MISFIT_DIMZ;
-    gridm_nx = grid_nx / 2 + 1;
-    gridm_ny = gridm_nx;
-    gridm_nxyz = gridm_nx * gridm_ny * nzmisfitcalc;
+    /* center the misfit grid on zero or on the current offsets */
     if (mbna_misfit_center == MBNA_MISFIT_ZEROCENTER) {
       mbna_misfit_offset_x = 0.0;
       mbna_misfit_offset_y = 0.0;
@@ -4601,56 +4582,42 @@ int mbnavadjust_get_misfit() {
       mbna_misfit_offset_y = mbna_offset_y;
       mbna_misfit_offset_z = mbna_offset_z;
     }
-//fprintf(stderr,"DEBUG %s %d: GRID parameters: dx:%.10f dy:%.10f nx:%d ny:%d  bounds:  grid: %.10f %.10f %.10f %.10f  plot: %.10f %.10f %.10f %.10f\n",
-//__FILE__,__LINE__,
-//grid_dx, grid_dy, grid_nx, grid_ny,
-//grid_olon, grid_olon + grid_nx * grid_dx,
-//grid_olat, grid_olat + grid_ny * grid_dy,
-//mbna_lon_min, mbna_lon_max, mbna_lat_min, mbna_lat_max);
-
-    /* figure out range of z offsets */
-    zmin = mbna_misfit_offset_z - 0.5 * project.zoffsetwidth;
-    zmax = mbna_misfit_offset_z + 0.5 * project.zoffsetwidth;
-    zoff_dz = project.zoffsetwidth / (nzmisfitcalc - 1);
-//fprintf(stderr,"DEBUG %s:%d:%s: mbna_misfit_offset_z:%f project.zoffsetwidth:%f nzmisfitcalc:%d zmin:%f zmax:%f zoff_dz:%f\n",
-//__FILE__,__LINE__, __FUNCTION__, 
-//mbna_misfit_offset_z,project.zoffsetwidth,nzmisfitcalc,zmin,zmax,zoff_dz);
-
-    /* allocate and initialize grids and arrays */
-    if (status == MB_SUCCESS) {
-      tptr = (double *)realloc(grid1, sizeof(double) * (grid_nxy));
-      if (tptr != NULL) {
-        grid1 = tptr;
-        memset(grid1, 0, sizeof(double) * (grid_nxy));
-      }
-      else {
-        free(grid1);
-        status = MB_FAILURE;
-      }
-    }
-    if (status == MB_SUCCESS) {
-      tptr = (double *)realloc(grid2, sizeof(double) * (grid_nxy));
-      if (tptr != NULL) {
-        grid2 = tptr;
-        memset(grid2, 0, sizeof(double) * (grid_nxy));
-      }
-      else {
-        free(grid2);
-        status = MB_FAILURE;
-      }
-    }
-    if (status == MB_SUCCESS) {
-      tptr = (double *)realloc(gridm, sizeof(double) * (gridm_nxyz));
-      if (tptr != NULL) {
-        gridm = tptr;
-        memset(gridm, 0, sizeof(double) * (gridm_nxyz));
-      }
-      else {
-        free(gridm);
-        status = MB_FAILURE;
-      }
-    }
+
+    /* calculate the misfit grid - the soundings of swath2 have been
+        shifted by the current z offset */
+    struct mbna_misfit misfit;
+    memset(&misfit, 0, sizeof(struct mbna_misfit));
+    misfit.offset_x = mbna_misfit_offset_x;
+    misfit.offset_y = mbna_misfit_offset_y;
+    misfit.offset_z = mbna_misfit_offset_z;
+    status = mbnavadjust_misfit_calc(mbna_verbose, &project, swath1, swath2, mbna_plot_lon_min, mbna_plot_lon_max,
+                                     mbna_plot_lat_min, mbna_plot_lat_max, mbna_mtodeglon, mbna_mtodeglat,
+                                     mbna_misfit_mode, mbna_offset_z, &misfit_grid, &misfit, &error);
     if (status == MB_SUCCESS) {
+      mbnavadjust_misfit_set(&misfit);
+      grid_nx = misfit_grid.grid_nx;
+      grid_ny = misfit_grid.grid_ny;
+      grid_nxy = misfit_grid.grid_nxy;
+      grid_dx = misfit_grid.grid_dx;
+      grid_dy = misfit_grid.grid_dy;
+      grid_olon = misfit_grid.grid_olon;
+      grid_olat = misfit_grid.grid_olat;
+      gridm_nx = misfit_grid.gridm_nx;
+      gridm_ny = misfit_grid.gridm_ny;
+      gridm_nxyz = misfit_grid.gridm_nxyz;
+      nzmisfitcalc = misfit_grid.nzmisfitcalc;
+      zmin = misfit_grid.zmin;
+      zmax = misfit_grid.zmax;
+      zoff_dz = misfit_grid.zoff_dz;
+      grid1 = misfit_grid.grid1;
+      grid2 = misfit_grid.grid2;
+      gridn1 = misfit_grid.gridn1;
+      gridn2 = misfit_grid.gridn2;
+      gridm = misfit_grid.gridm;
+      gridnm = misfit_grid.gridnm;
+      misfit_min = 0.99 * misfit_grid.misfit_min;
+      misfit_max = 1.01 * misfit_grid.misfit_max;
+
       tptr = (double *)realloc(gridmeq, sizeof(double) * (gridm_nxyz));
       if (tptr != NULL) {
         gridmeq = tptr;
@@ -4658,429 +4625,50 @@ int mbnavadjust_get_misfit() {
       }
       else {
         free(gridmeq);
+        gridmeq = NULL;
         status = MB_FAILURE;
+        error = MB_ERROR_MEMORY_FAIL;
       }
     }
-    if (status == MB_SUCCESS) {
-      tptr = (int *)realloc(gridn1, sizeof(int) * (grid_nxy));
-      if (tptr != NULL) {
-        gridn1 = tptr;
-        memset(gridn1, 0, sizeof(int) * (grid_nxy));
-      }
-      else {
-        free(gridn1);
-        status = MB_FAILURE;
-      }
-    }
-    if (status == MB_SUCCESS) {
-      tptr = (int *)realloc(gridn2, sizeof(int) * (grid_nxy));
-      if (tptr != NULL) {
-        gridn2 = tptr;
-        memset(gridn2, 0, sizeof(int) * (grid_nxy));
-      }
-      else {
-        free(gridn2);
-        status = MB_FAILURE;
-      }
-    }
-    if (status == MB_SUCCESS) {
-      tptr = (int *)realloc(gridnm, sizeof(int) * (gridm_nxyz));
-      if (tptr != NULL) {
-        gridnm = tptr;
-        memset(gridnm, 0, sizeof(int) * (gridm_nxyz));
-      }
-      else {
-        free(gridnm);
-        status = MB_FAILURE;
-      }
-    }
-
-    /* loop over all beams */
-    for (int i = 0; i < swath1->npings; i++) {
-      for (int j = 0; j < swath1->pings[i].beams_bath; j++) {
-        if (mb_beam_ok(swath1->pings[i].beamflag[j])) {
-          x = (swath1->pings[i].bathlon[j] - grid_olon);
-          y = (swath1->pings[i].bathlat[j] - grid_olat);
-          igx = (int)(x / grid_dx);
-          igy = (int)(y / grid_dy);
-          k = igx + igy * grid_nx;
-          if (igx >= 0 && igx < grid_nx && igy >= 0 && igy < grid_ny) {
-            grid1[k] += swath1->pings[i].bath[j];
-            gridn1[k]++;
-          }
-//else
-//fprintf(stderr,"DEBUG %s %d: BAD swath1: %d %d  %.10f %.10f  %f %f  %d %d\n",
-//__FILE__,__LINE__,
-//i, j, swath1->pings[i].bathlon[j], swath1->pings[i].bathlat[j], x, y, igx, igy);
-        }
-      }
-    }
-
-    /* loop over all beams */
-    for (int i = 0; i < swath2->npings; i++) {
-      for (int j = 0; j < swath2->pings[i].beams_bath; j++) {
-        if (mb_beam_ok(swath2->pings[i].beamflag[j])) {
-          x = (swath2->pings[i].bathlon[j] + mbna_misfit_offset_x - grid_olon);
-          y = (swath2->pings[i].bathlat[j] + mbna_misfit_offset_y - grid_olat);
-          igx = (int)(x / grid_dx);
-          igy = (int)(y / grid_dy);
-          k = igx + igy * grid_nx;
-          if (igx >= 0 && igx < grid_nx && igy >= 0 && igy < grid_ny) {
-            grid2[k] += swath2->pings[i].bath[j];
-            gridn2[k]++;
-          }
-//else
-//fprintf(stderr,"DEBUG %s %d: BAD swath2: %d %d  %.10f %.10f  %f %f  %d %d\n",
-//__FILE__,__LINE__,
-//i, j, swath2->pings[i].bathlon[j], swath2->pings[i].bathlat[j], x, y, igx, igy);
-        }
-      }
-    }
-
-    /* calculate gridded bath */
-    for (int k = 0; k < grid_nxy; k++) {
-      if (gridn1[k] > 0) {
-        grid1[k] = (grid1[k] / gridn1[k]);
-      }
-      if (gridn2[k] > 0) {
-        grid2[k] = (grid2[k] / gridn2[k]);
-      }
-      /* fprintf(stderr,"GRIDDED BATH: k:%d 1:%d %f   2:%d %f\n",
-      k,gridn1[k],grid1[k],gridn2[k],grid2[k]); */
-    }
-
-    /* calculate gridded misfit over lateral and z offsets */
-    for (int ic = 0; ic < gridm_nx; ic++)
-      for (int jc = 0; jc < gridm_ny; jc++)
-        for (int kc = 0; kc < nzmisfitcalc; kc++) {
-          lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
-          gridm[lc] = 0.0;
-          gridnm[lc] = 0;
-
-          ioff = (gridm_nx / 2) - ic;
-          joff = (gridm_ny / 2) - jc;
-          zoff = zmin + zoff_dz * kc;
-
-          istart = MAX(-ioff, 0);
-          iend = grid_nx - MAX(0, ioff);
-          jstart = MAX(-joff, 0);
-          jend = grid_ny - MAX(0, joff);
-          for (int i1 = istart; i1 < iend; i1++)
-            for (int j1 = jstart; j1 < jend; j1++) {
-              i2 = i1 + ioff;
-              j2 = j1 + joff;
-              k1 = i1 + j1 * grid_nx;
-              k2 = i2 + j2 * grid_nx;
-              if (gridn1[k1] > 0 && gridn2[k2] > 0) {
-                gridm[lc] += (grid2[k2] - grid1[k1] + zoff - mbna_offset_z) *
-                             (grid2[k2] - grid1[k1] + zoff - mbna_offset_z);
-                gridnm[lc]++;
-              }
-            }
-        }
-    misfit_min = 0.0;
-    misfit_max = 0.0;
-    mbna_minmisfit = 0.0;
-    mbna_minmisfit_n = 0;
-    mbna_minmisfit_x = 0.0;
-    mbna_minmisfit_y = 0.0;
-    mbna_minmisfit_z = 0.0;
-    found = false;
-//int imin;
-//int jmin;
-//int kmin;
-    for (int ic = 0; ic < gridm_nx; ic++)
-      for (int jc = 0; jc < gridm_ny; jc++)
-        for (int kc = 0; kc < nzmisfitcalc; kc++) {
-          lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
-          if (gridnm[lc] > 0) {
-            gridm[lc] = sqrt(gridm[lc]) / gridnm[lc];
-            if (misfit_max == 0.0) {
-              misfit_min = gridm[lc];
-            }
-            misfit_min = MIN(misfit_min, gridm[lc]);
-            misfit_max = MAX(misfit_max, gridm[lc]);
-            if (gridnm[lc] > mbna_minmisfit_nthreshold && (mbna_minmisfit_n == 0 || gridm[lc] < mbna_minmisfit)) {
-              mbna_minmisfit = gridm[lc];
-              mbna_minmisfit_n = gridnm[lc];
-              mbna_minmisfit_x = (ic - gridm_nx / 2) * grid_dx + mbna_misfit_offset_x;
-              mbna_minmisfit_y = (jc - gridm_ny / 2) * grid_dy + mbna_misfit_offset_y;
-              mbna_minmisfit_z = zmin + zoff_dz * kc;
-//imin = ic;
-//jmin = jc;
-//kmin = kc;
-              found = true;
-//zoff = zmin + zoff_dz * kc;
-//fprintf(stderr,"DEBUG %s %d: ic:%d jc:%d kc:%d misfit:%f %f %d  pos:%f %f %f zoff:%f mbna_ofset_z:%f\n",
-//__FILE__,__LINE__,
-//ic,jc,kc,misfit_min,mbna_minmisfit,mbna_minmisfit_n,mbna_minmisfit_x,mbna_minmisfit_y,mbna_minmisfit_z,
-//zoff,mbna_offset_z);
-            }
-          }
-//if (ic == jc && kc == 0)
-//fprintf(stderr,"DEBUG %s %d: ic:%d jc:%d misfit:%d %f\n",
-//__FILE__,__LINE__,
-//ic,jc,gridnm[lc],gridm[lc]);
-        }
-    if (!found) {
-      mbna_minmisfit_nthreshold /= 10.0;
-      for (int ic = 0; ic < gridm_nx; ic++)
-        for (int jc = 0; jc < gridm_ny; jc++)
-          for (int kc = 0; kc < nzmisfitcalc; kc++) {
-            lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
-            if (gridnm[lc] > mbna_minmisfit_nthreshold / 10 &&
-                (mbna_minmisfit_n == 0 || gridm[lc] < mbna_minmisfit)) {
-              mbna_minmisfit = gridm[lc];
-              mbna_minmisfit_n = gridnm[lc];
-              mbna_minmisfit_x = (ic - gridm_nx / 2) * grid_dx + mbna_misfit_offset_x;
-              mbna_minmisfit_y = (jc - gridm_ny / 2) * grid_dy + mbna_misfit_offset_y;
-              mbna_minmisfit_z = zmin + zoff_dz * kc;
-//imin = ic;
-//jmin = jc;
-//kmin = kc;
-              found = true;
-            }
-//fprintf(stderr,"DEBUG %s %d: ijk:%d %d %d gridm:%d %f  misfit:%f %f %d  pos:%f %f %f\n",
-//__FILE__,__LINE__,
-//ic,jc,kc,gridnm[lc],gridm[lc],misfit_min,mbna_minmisfit,mbna_minmisfit_n,mbna_minmisfit_x,mbna_minmisfit_y,mbna_minmisfit_z);
-          }
-    }
-    misfit_min = 0.99 * misfit_min;
-    misfit_max = 1.01 * misfit_max;
-//if (found)
-//{
-//lc = kmin + nzmisfitcalc * (imin + jmin * gridm_nx);
-//fprintf(stderr,"DEBUG %s %d: min misfit: i:%d j:%d k:%d    n:%d m:%f   offsets: %f %f %f\n",
-//__FILE__,__LINE__,
-//imin, jmin, kmin, gridnm[lc], gridm[lc],
-//mbna_minmisfit_x / mbna_mtodeglon,
-//mbna_minmisfit_y / mbna_mtodeglat,
-//mbna_minmisfit_z);
-//}
-
-//fprintf(stderr,"DEBUG %s %d: Misfit bounds: nmin:%d best:%f min:%f max:%f min loc: %f %f %f\n",
-//__FILE__,__LINE__,
-//mbna_minmisfit_n,mbna_minmisfit,misfit_min,misfit_max,
-//mbna_minmisfit_x/mbna_mtodeglon,mbna_minmisfit_y/mbna_mtodeglat,mbna_minmisfit_z);
-
-    /* set message on */
-    if (mbna_verbose > 1)
-      fprintf(stderr, "Histogram equalizing misfit grid for crossing %d\n", mbna_current_crossing);
-    snprintf(message, sizeof(message), "Histogram equalizing misfit grid for crossing %d\n", mbna_current_crossing);
-    do_message_update(message);
-
-    /* sort the misfit to get histogram equalization */
-    grid_nxyzeq = 0;
-    for (int l = 0; l < gridm_nxyz; l++) {
-      if (gridm[l] > 0.0) {
-        gridmeq[grid_nxyzeq] = gridm[l];
-        grid_nxyzeq++;
-      }
-    }
-
-    if (grid_nxyzeq > 0) {
-      qsort((char *)gridmeq, grid_nxyzeq, sizeof(double), mb_double_compare);
-      dinterval = ((double)grid_nxyzeq) / ((double)(nmisfit_intervals - 1));
-      if (dinterval < 1.0) {
-        for (int l = 0; l < grid_nxyzeq; l++)
-          misfit_intervals[l] = gridmeq[l];
-        for (int l = grid_nxyzeq; l < nmisfit_intervals; l++)
-          misfit_intervals[l] = gridmeq[grid_nxyzeq - 1];
-      }
-      else {
-        misfit_intervals[0] = misfit_min;
-        misfit_intervals[nmisfit_intervals - 1] = misfit_max;
-        for (int l = 1; l < nmisfit_intervals - 1; l++) {
-          ll = (int)(l * dinterval);
-          misfit_intervals[l] = gridmeq[ll];
-        }
-      }
-
-      /* get minimum misfit in 2D plane at current z offset */
-      mbnavadjust_get_misfitxy();
 
+    if (status == MB_SUCCESS) {
       /* set message on */
       if (mbna_verbose > 1)
-        fprintf(stderr, "Estimating 3D uncertainty for crossing %d\n", mbna_current_crossing);
-      snprintf(message, sizeof(message), "Estimating 3D uncertainty for crossing %d\n", mbna_current_crossing);
+        fprintf(stderr, "Histogram equalizing misfit grid for crossing %d\n", mbna_current_crossing);
+      snprintf(message, sizeof(message), "Histogram equalizing misfit grid for crossing %d\n", mbna_current_crossing);
       do_message_update(message);
 
-      /* estimating 3 component uncertainty vector at minimum misfit point */
-      /* first get the longest vector to a misfit value <= 2 times minimum misfit */
-      minmisfitthreshold = mbna_minmisfit * 3.0;
-      mbna_minmisfit_sr1 = 0.0;
-      for (int ic = 0; ic < gridm_nx; ic++)
-        for (int jc = 0; jc < gridm_ny; jc++)
-          for (int kc = 0; kc < nzmisfitcalc; kc++) {
-            lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
-            if (gridnm[lc] > mbna_minmisfit_nthreshold && gridm[lc] <= minmisfitthreshold) {
-              x = ((ic - gridm_nx / 2) * grid_dx + mbna_misfit_offset_x - mbna_minmisfit_x) / mbna_mtodeglon;
-              y = ((jc - gridm_ny / 2) * grid_dy + mbna_misfit_offset_y - mbna_minmisfit_y) / mbna_mtodeglat;
-              z = zmin + zoff_dz * kc - mbna_minmisfit_z;
-              r = sqrt(x * x + y * y + z * z);
-              /* fprintf(stderr,"DEBUG %s %d: %d %d %d gridm[%d]:%f minmisfitthreshold:%f x: %f %f %f  r:%f\n",
-              __FILE__,__LINE__,
-              ic,jc,kc,lc,gridm[lc],minmisfitthreshold,x,y,z,r); */
-              if (r > mbna_minmisfit_sr1) {
-                mbna_minmisfit_sx1[0] = x;
-                mbna_minmisfit_sx1[1] = y;
-                mbna_minmisfit_sx1[2] = z;
-                mbna_minmisfit_sr1 = r;
-              }
-            }
-          }
-      mbna_minmisfit_sx1[0] /= mbna_minmisfit_sr1;
-      mbna_minmisfit_sx1[1] /= mbna_minmisfit_sr1;
-      mbna_minmisfit_sx1[2] /= mbna_minmisfit_sr1;
-      /* fprintf(stderr,"DEBUG %s %d: Longest vector in misfit space. %f %f %f  r:%f\n",
-      __FILE__,__LINE__,
-      mbna_minmisfit_sx1[0],mbna_minmisfit_sx1[1],mbna_minmisfit_sx1[2],mbna_minmisfit_sr1); */
-
-      /* now get a horizontal unit vector perpendicular to the the longest vector
-          and then find the largest r associated with that vector */
-      mbna_minmisfit_sr2 =
-          sqrt(mbna_minmisfit_sx1[0] * mbna_minmisfit_sx1[0] + mbna_minmisfit_sx1[1] * mbna_minmisfit_sx1[1]);
-      if (mbna_minmisfit_sr2 < MBNA_SMALL) {
-        mbna_minmisfit_sx2[0] = 0.0;
-        mbna_minmisfit_sx2[1] = 1.0;
-        mbna_minmisfit_sx2[2] = 0.0;
-        mbna_minmisfit_sr2 = MBNA_SMALL;
-      }
-      else {
-        mbna_minmisfit_sx2[0] = mbna_minmisfit_sx1[1] / mbna_minmisfit_sr2;
-        mbna_minmisfit_sx2[1] = -mbna_minmisfit_sx1[0] / mbna_minmisfit_sr2;
-        mbna_minmisfit_sx2[2] = 0.0;
-        mbna_minmisfit_sr2 =
-            sqrt(mbna_minmisfit_sx2[0] * mbna_minmisfit_sx2[0] + mbna_minmisfit_sx2[1] * mbna_minmisfit_sx2[1] +
-                 mbna_minmisfit_sx2[2] * mbna_minmisfit_sx2[2]);
-      }
-      /* dotproduct = (mbna_minmisfit_sx1[0] * mbna_minmisfit_sx2[0] + mbna_minmisfit_sx1[1] * mbna_minmisfit_sx2[1] +
-      mbna_minmisfit_sx1[2] * mbna_minmisfit_sx2[2]); fprintf(stderr,"DEBUG %s %d: Horizontal perpendicular vector in misfit
-      space. %f %f %f  r:%f dotproduct:%f\n",
-      __FILE__,__LINE__,
-      mbna_minmisfit_sx2[0],mbna_minmisfit_sx2[1],mbna_minmisfit_sx2[2],mbna_minmisfit_sr2,dotproduct); */
-
-      /* now get a near-vertical unit vector perpendicular to the the longest vector
-          and then find the largest r associated with that vector */
-      mbna_minmisfit_sr3 =
-          sqrt(mbna_minmisfit_sx1[0] * mbna_minmisfit_sx1[0] + mbna_minmisfit_sx1[1] * mbna_minmisfit_sx1[1]);
-      if (mbna_minmisfit_sr3 < MBNA_ZSMALL) {
-        mbna_minmisfit_sx3[0] = 0.0;
-        mbna_minmisfit_sx3[1] = 0.0;
-        mbna_minmisfit_sx3[2] = 1.0;
-        mbna_minmisfit_sr3 = MBNA_ZSMALL;
+      /* sort the misfit to get histogram equalization */
+      grid_nxyzeq = 0;
+      for (int l = 0; l < gridm_nxyz; l++) {
+        if (gridm[l] > 0.0) {
+          gridmeq[grid_nxyzeq] = gridm[l];
+          grid_nxyzeq++;
+        }
       }
-      else {
-        if (mbna_minmisfit_sx1[2] >= 0.0) {
-          mbna_minmisfit_sx3[0] =
-              -mbna_minmisfit_sx1[0] * sqrt(1.0 - mbna_minmisfit_sr3 * mbna_minmisfit_sr3) / mbna_minmisfit_sr3;
-          mbna_minmisfit_sx3[1] =
-              -mbna_minmisfit_sx1[1] * sqrt(1.0 - mbna_minmisfit_sr3 * mbna_minmisfit_sr3) / mbna_minmisfit_sr3;
+
+      if (grid_nxyzeq > 0) {
+        qsort((char *)gridmeq, grid_nxyzeq, sizeof(double), mb_double_compare);
+        dinterval = ((double)grid_nxyzeq) / ((double)(nmisfit_intervals - 1));
+        if (dinterval < 1.0) {
+          for (int l = 0; l < grid_nxyzeq; l++)
+            misfit_intervals[l] = gridmeq[l];
+          for (int l = grid_nxyzeq; l < nmisfit_intervals; l++)
+            misfit_intervals[l] = gridmeq[grid_nxyzeq - 1];
         }
         else {
-          mbna_minmisfit_sx3[0] =
-              mbna_minmisfit_sx1[0] * sqrt(1.0 - mbna_minmisfit_sr3 * mbna_minmisfit_sr3) / mbna_minmisfit_sr3;
-          mbna_minmisfit_sx3[1] =
-              mbna_minmisfit_sx1[1] * sqrt(1.0 - mbna_minmisfit_sr3 * mbna_minmisfit_sr3) / mbna_minmisfit_sr3;
-        }
-        mbna_minmisfit_sx3[2] = mbna_minmisfit_sr3;
-        mbna_minmisfit_sr3 =
-            sqrt(mbna_minmisfit_sx3[0] * mbna_minmisfit_sx3[0] + mbna_minmisfit_sx3[1] * mbna_minmisfit_sx3[1] +
-                 mbna_minmisfit_sx3[2] * mbna_minmisfit_sx3[2]);
-      }
-      /* dotproduct = (mbna_minmisfit_sx1[0] * mbna_minmisfit_sx3[0] + mbna_minmisfit_sx1[1] * mbna_minmisfit_sx3[1] +
-      mbna_minmisfit_sx1[2] * mbna_minmisfit_sx3[2]); fprintf(stderr,"DEBUG %s %d: Perpendicular near-vertical vector in
-      misfit space. %f %f %f  r:%f dotproduct:%f\n",
-      __FILE__,__LINE__,
-      mbna_minmisfit_sx3[0],mbna_minmisfit_sx3[1],mbna_minmisfit_sx3[2],mbna_minmisfit_sr2,dotproduct); */
-
-      /* now get the longest r values to a misfit value <= 2 times minimum misfit
-          for both secondary vectors */
-      mbna_minmisfit_sr2 = 0.0;
-      mbna_minmisfit_sr3 = 0.0;
-      dotproductsave2 = 0.0;
-      rsave2 = 0.0;
-      dotproductsave3 = 0.0;
-      rsave3 = 0.0;
-      for (int ic = 0; ic < gridm_nx; ic++)
-        for (int jc = 0; jc < gridm_ny; jc++)
-          for (int kc = 0; kc < nzmisfitcalc; kc++) {
-            lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
-            if (gridnm[lc] > mbna_minmisfit_nthreshold && gridm[lc] <= minmisfitthreshold) {
-              x = ((ic - gridm_nx / 2) * grid_dx + mbna_misfit_offset_x - mbna_minmisfit_x) / mbna_mtodeglon;
-              y = ((jc - gridm_ny / 2) * grid_dy + mbna_misfit_offset_y - mbna_minmisfit_y) / mbna_mtodeglat;
-              z = zmin + zoff_dz * kc - mbna_minmisfit_z;
-              r = sqrt(x * x + y * y + z * z);
-              if (r > mbna_minmisfit_sr2) {
-                dotproduct =
-                    (x * mbna_minmisfit_sx2[0] + y * mbna_minmisfit_sx2[1] + z * mbna_minmisfit_sx2[2]) / r;
-                if (fabs(dotproduct) > 0.8) {
-                  /* fprintf(stderr,"DEBUG %s %d: Vector2: %d %d %d gridm[%d]:%f minmisfitthreshold:%f
-                  dotproduct:%f x: %f %f %f  r:%f\n",
-                  __FILE__,__LINE__,
-                  ic,jc,kc,lc,gridm[lc],minmisfitthreshold,dotproduct,x,y,z,r); */
-                  mbna_minmisfit_sr2 = r;
-                }
-                if (fabs(dotproduct) > dotproductsave2) {
-                  dotproductsave2 = fabs(dotproduct);
-                  rsave2 = r;
-                }
-              }
-              if (r > mbna_minmisfit_sr3) {
-                dotproduct =
-                    (x * mbna_minmisfit_sx3[0] + y * mbna_minmisfit_sx3[1] + z * mbna_minmisfit_sx3[2]) / r;
-                if (fabs(dotproduct) > 0.8) {
-                  /* fprintf(stderr,"DEBUG %s %d: Vector3: %d %d %d gridm[%d]:%f minmisfitthreshold:%f
-                  dotproduct:%f x: %f %f %f  r:%f\n",
-                  __FILE__,__LINE__,
-                  ic,jc,kc,lc,gridm[lc],minmisfitthreshold,dotproduct,x,y,z,r); */
-                  mbna_minmisfit_sr3 = r;
-                }
-                if (fabs(dotproduct) > dotproductsave3) {
-                  dotproductsave3 = fabs(dotproduct);
-                  rsave3 = r;
-                }
-              }
-            }
+          misfit_intervals[0] = misfit_min;
+          misfit_intervals[nmisfit_intervals - 1] = misfit_max;
+          for (int l = 1; l < nmisfit_intervals - 1; l++) {
+            ll = (int)(l * dinterval);
+            misfit_intervals[l] = gridmeq[ll];
           }
-      if (mbna_minmisfit_sr2 < MBNA_SMALL)
-        mbna_minmisfit_sr2 = rsave2;
-      if (mbna_minmisfit_sr3 < MBNA_ZSMALL)
-        mbna_minmisfit_sr3 = rsave3;
+        }
+
+        /* get minimum misfit in 2D plane at current z offset */
+        mbnavadjust_get_misfitxy();
+      }
     }
-    else {
-      mbna_minmisfit_sx1[0] = 1.0;
-      mbna_minmisfit_sx1[1] = 0.0;
-      mbna_minmisfit_sx1[2] = 0.0;
-      mbna_minmisfit_sr1 = 100.0;
-      mbna_minmisfit_sx2[0] = 0.0;
-      mbna_minmisfit_sx2[1] = 1.0;
-      mbna_minmisfit_sx2[2] = 0.0;
-      mbna_minmisfit_sr2 = 100.0;
-      mbna_minmisfit_sx3[0] = 0.0;
-      mbna_minmisfit_sx3[1] = 0.0;
-      mbna_minmisfit_sx3[2] = 1.0;
-      mbna_minmisfit_sr3 = 100.0;
-    }
-    /* fprintf(stderr,"DEBUG %s %d: \nVector1: %f %f %f  mbna_minmisfit_sr1:%f\n",
-    __FILE__,__LINE__,
-    mbna_minmisfit_sx1[0],mbna_minmisfit_sx1[1],mbna_minmisfit_sx1[2],mbna_minmisfit_sr1);
-    fprintf(stderr,"Vector2: %f %f %f  mbna_minmisfit_sr2:%f\n",
-    mbna_minmisfit_sx2[0],mbna_minmisfit_sx2[1],mbna_minmisfit_sx2[2],mbna_minmisfit_sr2);
-    fprintf(stderr,"Vector3: %f %f %f  mbna_minmisfit_sr3:%f\n",
-    mbna_minmisfit_sx3[0],mbna_minmisfit_sx3[1],mbna_minmisfit_sx3[2],mbna_minmisfit_sr3);
-    dotproduct = (mbna_minmisfit_sx1[0] * mbna_minmisfit_sx2[0]
-            + mbna_minmisfit_sx1[1] * mbna_minmisfit_sx2[1]
-            + mbna_minmisfit_sx1[2] * mbna_minmisfit_sx2[2]);
-    fprintf(stderr,"Dot products: 1v2:%f ",dotproduct);
-    dotproduct = (mbna_minmisfit_sx2[0] * mbna_minmisfit_sx3[0]
-            + mbna_minmisfit_sx2[1] * mbna_minmisfit_sx3[1]
-            + mbna_minmisfit_sx2[2] * mbna_minmisfit_sx3[2]);
-    fprintf(stderr,"2v3:%f ",dotproduct);
-    dotproduct = (mbna_minmisfit_sx1[0] * mbna_minmisfit_sx3[0]
-            + mbna_minmisfit_sx1[1] * mbna_minmisfit_sx3[1]
-            + mbna_minmisfit_sx1[2] * mbna_minmisfit_sx3[2]);
-    fprintf(stderr,"3v2:%f\n",dotproduct); */
   }
 
   if (mbna_verbose >= 2) {
@@ -5100,47 +4688,28 @@ int mbnavadjust_get_misfitxy() {
   }
 
   int status = MB_SUCCESS;
-  int kc, lc;
 
   if (project.open
       && ((mbna_naverr_mode == MBNA_NAVERR_MODE_CROSSING && project.num_crossings > 0 && mbna_current_crossing >= 0)
           || (mbna_naverr_mode == MBNA_NAVERR_MODE_SECTION && project.refgrid_status == MBNA_REFGRID_LOADED))) {
-    /* get minimum misfit in plane at current z offset */
-// fprintf(stderr,"DEBUG %s:%d:%s: mbna_misfit_offset_z:%f project.zoffsetwidth:%f nzmisfitcalc:%d zmin:%f zmax:%f zoff_dz:%f\n",
-// __FILE__,__LINE__, __FUNCTION__, 
-// mbna_misfit_offset_z,project.zoffsetwidth,nzmisfitcalc,zmin,zmax,zoff_dz);
+    /* get minimum misfit in plane closest to the current z offset */
     if (grid_nxyzeq > 0) {
-      /* get closest to current zoffset in existing 3d grid */
-      misfit_max = 0.0;
-      misfit_min = 0.0;
-      kc = (int)((mbna_offset_z - zmin) / zoff_dz);
-      for (int ic = 0; ic < gridm_nx; ic++)
-        for (int jc = 0; jc < gridm_ny; jc++) {
-          lc = kc + nzmisfitcalc * (ic + jc * gridm_nx);
-          if (gridnm[lc] > mbna_minmisfit_nthreshold) {
-            if (misfit_max == 0.0) {
-              misfit_min = gridm[lc];
-              misfit_max = gridm[lc];
-            }
-            else if (gridm[lc] < misfit_min) {
-              misfit_min = gridm[lc];
-              mbna_minmisfit_xh = (ic - gridm_nx / 2) * grid_dx + mbna_misfit_offset_x;
-              mbna_minmisfit_yh = (jc - gridm_ny / 2) * grid_dy + mbna_misfit_offset_y;
-              mbna_minmisfit_zh = zmin + zoff_dz * kc;
-            }
-            else if (gridm[lc] > misfit_max) {
-              misfit_max = gridm[lc];
-            }
-          }
-        }
-      //fprintf(stderr,"mbnavadjust_get_misfitxy a mbna_minmisfit_xh:%f mbna_minmisfit_yh:%f mbna_minmisfit_zh:%f\n",
-      //mbna_minmisfit_xh,mbna_minmisfit_yh,mbna_minmisfit_zh);
+      struct mbna_misfit misfit;
+      memset(&misfit, 0, sizeof(struct mbna_misfit));
+      misfit.offset_x = mbna_misfit_offset_x;
+      misfit.offset_y = mbna_misfit_offset_y;
+      misfit.offset_z = mbna_misfit_offset_z;
+      misfit.nthreshold = mbna_minmisfit_nthreshold;
+      misfit.minmisfit_xh = mbna_minmisfit_xh;
+      misfit.minmisfit_yh = mbna_minmisfit_yh;
+      misfit.minmisfit_zh = mbna_minmisfit_zh;
+      status = mbnavadjust_misfit_xy(mbna_verbose, &misfit_grid, mbna_offset_z, &misfit, &misfit_min, &misfit_max,
+                                     &error);
+      mbna_minmisfit_xh = misfit.minmisfit_xh;
+      mbna_minmisfit_yh = misfit.minmisfit_yh;
+      mbna_minmisfit_zh = misfit.minmisfit_zh;
     }
-    //fprintf(stderr,"mbnavadjust_get_misfitxy b mbna_minmisfit_xh:%f mbna_minmisfit_yh:%f mbna_minmisfit_zh:%f\n",
-    //mbna_minmisfit_xh,mbna_minmisfit_yh,mbna_minmisfit_zh);
   }
-  //fprintf(stderr,"mbnavadjust_get_misfitxy c mbna_minmisfit_xh:%f mbna_minmisfit_yh:%f mbna_minmisfit_zh:%f\n",
-  //mbna_minmisfit_xh,mbna_minmisfit_yh,mbna_minmisfit_zh);
 
   if (mbna_verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBnavadjust function <%s> completed\n", __func__);
@@ -6110,11 +5679,8 @@ int mbnavadjust_autopick(bool do_vertical) {
   struct mbna_crossing *crossing;
   struct mbna_file *file1, *file2;
   struct mbna_section *section1, *section2;
-  double dlon, dlat, overlap_scale;
   bool process;
   int nprocess;
-  int isnav1_focus, isnav2_focus;
-  double lon_focus, lat_focus;
 
   // loop over all crossings, autopick those that are in the current view,
   // unanalyzed, have sufficient overlap, and for which both sections are
@@ -6369,117 +5935,33 @@ int mbnavadjust_autopick(bool do_vertical) {
         mbna_minmisfit_x/mbna_mtodeglon,mbna_minmisfit_y/mbna_mtodeglat,mbna_minmisfit_z,
         mbna_minmisfit_xh/mbna_mtodeglon,mbna_minmisfit_yh/mbna_mtodeglat,mbna_minmisfit_zh); */
 
-        /* if this is a >50% overlap crossing then first set offsets to
-            minimum misfit and then recalculate misfit */
-        if (crossing->overlap > 50) {
-          /* set offsets to minimum misfit */
-          if (do_vertical) {
-            mbna_offset_x = mbna_minmisfit_x;
-            mbna_offset_y = mbna_minmisfit_y;
-            mbna_offset_z = mbna_minmisfit_z;
-          }
-          else {
-            mbna_offset_x = mbna_minmisfit_xh;
-            mbna_offset_y = mbna_minmisfit_yh;
-            mbna_offset_z = mbna_minmisfit_zh;
-          }
-          mbna_misfit_offset_x = mbna_offset_x;
-          mbna_misfit_offset_y = mbna_offset_y;
-          mbna_misfit_offset_z = mbna_offset_z;
-          mbnavadjust_crossing_replot();
-
-          /* get misfit */
-          mbnavadjust_get_misfit();
-          /* fprintf(stderr,"mbnavadjust_autopick B crossing:%d overlap:%d overlap_scale:%f current offsets:%f %f %f
-          minmisfit3D:%f %f %f  minmisfit2D:%f %f %f\n", mbna_current_crossing,crossing->overlap,overlap_scale,
-          mbna_offset_x/mbna_mtodeglon,mbna_offset_y/mbna_mtodeglat,mbna_offset_z,
-          mbna_minmisfit_x/mbna_mtodeglon,mbna_minmisfit_y/mbna_mtodeglat,mbna_minmisfit_z,
-          mbna_minmisfit_xh/mbna_mtodeglon,mbna_minmisfit_yh/mbna_mtodeglat,mbna_minmisfit_zh); */
-        }
-
-        /* set plot bounds to overlap region and recalculate misfit */
-        mbnavadjust_crossing_overlapbounds(mbna_verbose, &project, mbna_current_crossing, mbna_offset_x, mbna_offset_y,
-                                                   &mbna_overlap_lon_min, &mbna_overlap_lon_max,
-                                                   &mbna_overlap_lat_min, &mbna_overlap_lat_max,
-                                                   &error);
-        mbna_plot_lon_min = mbna_overlap_lon_min;
-        mbna_plot_lon_max = mbna_overlap_lon_max;
-        mbna_plot_lat_min = mbna_overlap_lat_min;
-        mbna_plot_lat_max = mbna_overlap_lat_max;
-// fprintf(stderr, "%s:%d:%s: mbna_plot_lon_min:%f mbna_plot_lon_max:%f mbna_plot_lat_min:%f mbna_plot_lat_max:%f\n",
-// __FILE__, __LINE__, __FUNCTION__, mbna_plot_lon_min, mbna_plot_lon_max, mbna_plot_lat_min, mbna_plot_lat_max);
-
-                /* get characteristic scale of the overlap region */
-        overlap_scale = MIN((mbna_overlap_lon_max - mbna_overlap_lon_min) / mbna_mtodeglon,
-                            (mbna_overlap_lat_max - mbna_overlap_lat_min) / mbna_mtodeglat);
-
-        /* get naverr plot scaling */
-        mbnavadjust_naverr_scale();
-
-        /* get misfit */
-        mbnavadjust_get_misfit();
-
-        /* The overlap focus point is currently the center of the line
-         * connecting the two closest approach nav points. It could also
-         * be the centroid of the overlap regions. */
-        mbnavadjust_crossing_focuspoint(mbna_verbose, &project, mbna_current_crossing, mbna_offset_x, mbna_offset_y,
-                                           &isnav1_focus, &isnav2_focus, &lon_focus, &lat_focus,
-                                           &error);
-
-        /* If nonzero overlap region and focus point inside the overlap region,
-         * set plot bounds to cover one-quarter
-         * of overlap region centered on the focus point and
-         * recalculate misfit. */
-        if (mbna_overlap_lon_max > mbna_overlap_lon_min && mbna_overlap_lat_max > mbna_overlap_lat_min
-          && lon_focus >= mbna_overlap_lon_min && lon_focus <= mbna_overlap_lon_max
-          && lat_focus >= mbna_overlap_lat_min && lat_focus <= mbna_overlap_lat_max) {
-          dlon =  0.25 * (mbna_overlap_lon_max - mbna_overlap_lon_min);
-          dlat =  0.25 * (mbna_overlap_lat_max - mbna_overlap_lat_min);
-          mbna_plot_lon_min = MAX((lon_focus - dlon), mbna_overlap_lon_min);
-          mbna_plot_lon_max = MIN((lon_focus + dlon), mbna_overlap_lon_max);
-          mbna_plot_lat_min = MAX((lat_focus - dlat), mbna_overlap_lat_min);
-          mbna_plot_lat_max = MIN((lat_focus + dlat), mbna_overlap_lat_max);
-// fprintf(stderr, "%s:%d:%s: mbna_plot_lon_min:%f mbna_plot_lon_max:%f mbna_plot_lat_min:%f mbna_plot_lat_max:%f\n",
-// __FILE__, __LINE__, __FUNCTION__, mbna_plot_lon_min, mbna_plot_lon_max, mbna_plot_lat_min, mbna_plot_lat_max);
+        /* pick the crossing using the same steps as the batch autopicking -
+            the soundings of swath2 have been shifted by the current z offset */
+        struct mbna_autopick_result result;
+        mbnavadjust_autopick_crossing(mbna_verbose, &project, mbna_current_crossing, swath1, swath2, mbna_offset_x,
+                                      mbna_offset_y, mbna_offset_z, mbna_offset_z, do_vertical, mbna_misfit_mode,
+                                      &result, &error);
 
-          /* get naverr plot scaling */
-          mbnavadjust_naverr_scale();
-
-          /* get misfit */
-          mbnavadjust_get_misfit();
-        }
+        fprintf(stderr, "Long misfit axis:%.3f Threshold:%.3f", result.long_axis, result.threshold);
 
-        /* check uncertainty estimate for a good pick */
-        /* fprintf(stderr,"mbnavadjust_autopick C crossing:%d overlap:%d overlap_scale:%f current offsets:%f %f %f
-        minmisfit3D:%f %f %f  minmisfit2D:%f %f %f\n", mbna_current_crossing,crossing->overlap,overlap_scale,
-        mbna_offset_x/mbna_mtodeglon,mbna_offset_y/mbna_mtodeglat,mbna_offset_z,
-        mbna_minmisfit_x/mbna_mtodeglon,mbna_minmisfit_y/mbna_mtodeglat,mbna_minmisfit_z,
-        mbna_minmisfit_xh/mbna_mtodeglon,mbna_minmisfit_yh/mbna_mtodeglat,mbna_minmisfit_zh);
-        fprintf(stderr,"crossing:%d overlap:%d overlap_scale:%f uncertainty axes: %f %f %f",
-        mbna_current_crossing,crossing->overlap,overlap_scale,mbna_minmisfit_sr1,mbna_minmisfit_sr2,mbna_minmisfit_sr3);
-        if (MAX(mbna_minmisfit_sr1,mbna_minmisfit_sr2) < 0.5 * overlap_scale
-        && MIN(mbna_minmisfit_sr1,mbna_minmisfit_sr2) > 0.0)
-        fprintf(stderr," USE PICK");
-        fprintf(stderr,"\n"); */
-
-        fprintf(stderr, "Long misfit axis:%.3f Threshold:%.3f", MAX(mbna_minmisfit_sr1, mbna_minmisfit_sr2),
-                0.5 * overlap_scale);
-
-        if (MAX(mbna_minmisfit_sr1, mbna_minmisfit_sr2) < 0.5 * overlap_scale &&
-            MIN(mbna_minmisfit_sr1, mbna_minmisfit_sr2) > 0.0) {
+        if (result.success) {
           fprintf(stderr, " AUTOPICK SUCCEEDED\n");
 
           /* set offsets to minimum misfit */
-          if (do_vertical) {
-            mbna_offset_x = mbna_minmisfit_x;
-            mbna_offset_y = mbna_minmisfit_y;
-            mbna_offset_z = mbna_minmisfit_z;
-          }
-          else {
-            mbna_offset_x = mbna_minmisfit_xh;
-            mbna_offset_y = mbna_minmisfit_yh;
-            mbna_offset_z = mbna_minmisfit_zh;
-          }
+          mbna_offset_x = result.offset_x;
+          mbna_offset_y = result.offset_y;
+          mbna_offset_z = result.offset_z;
+          mbna_misfit_offset_x = result.misfit.offset_x;
+          mbna_misfit_offset_y = result.misfit.offset_y;
+          mbna_misfit_offset_z = result.misfit.offset_z;
+          mbnavadjust_misfit_set(&result.misfit);
+
+          /* set plot bounds to the region of the final misfit */
+          mbna_plot_lon_min = result.lon_min;
+          mbna_plot_lon_max = result.lon_max;
+          mbna_plot_lat_min = result.lat_min;
+          mbna_plot_lat_max = result.lat_max;
+          mbnavadjust_naverr_scale();
 
           /* add tie */
           mbnavadjust_naverr_addtie();
@@ -6552,6 +6034,30 @@ int mbnavadjust_autopick(bool do_vertical) {
   return (status);
 }
 /*--------------------------------------------------------------------*/
+/* solve the least squares problem held in matrix with LSQR, using the
+   threaded sparse matrix products if the sparse copy can be allocated and
+   the single threaded mb_aprod() otherwise */
+static void mbnavadjust_lsqr(int m, int n, struct mbna_matrix *matrix, double damp, double *u, double *v, double *w,
+                             double *x, double *se, double atol, double btol, double conlim, int itnlim,
+                             int *istop_out, int *itn_out, double *anorm_out, double *acond_out, double *rnorm_out,
+                             double *arnorm_out, double *xnorm_out) {
+  struct mb_sparse_struct sparse;
+  const long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+  const int nthreads = ncpu > 0 ? (int)ncpu : 1;
+  int sparse_error = MB_ERROR_NO_ERROR;
+  if (mb_sparse_init(mbna_verbose, m, n, matrix->ia_dim, matrix->nia, matrix->ia, matrix->a, nthreads,
+                     mbna_invert_precondition, &sparse, &sparse_error) == MB_SUCCESS) {
+    mblsqr_lsqr(m, n, &mb_sparse_aprod, damp, &sparse, u, v, w, x, se, atol, btol, conlim, itnlim, stderr,
+                istop_out, itn_out, anorm_out, acond_out, rnorm_out, arnorm_out, xnorm_out);
+    mb_sparse_unscale(mbna_verbose, &sparse, x, se, &sparse_error);
+    mb_sparse_deall(mbna_verbose, &sparse, &sparse_error);
+  }
+  else {
+    mblsqr_lsqr(m, n, &mb_aprod, damp, matrix, u, v, w, x, se, atol, btol, conlim, itnlim, stderr,
+                istop_out, itn_out, anorm_out, acond_out, rnorm_out, arnorm_out, xnorm_out);
+  }
+}
+/*--------------------------------------------------------------------*/
 int mbnavadjust_autosetsvsvertical() {
   if (mbna_verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
@@ -7173,8 +6679,8 @@ int mbnavadjust_autosetsvsvertical() {
       //  fprintf(stderr," | b:%10.6f\n",u[i]);
       //  }
 
-      mblsqr_lsqr(nrows_ba, ncols_ba, &mb_aprod, damp, &matrix, u, v, w, x, se, atol, btol, conlim, itnlim, stderr,
-                  &istop_out, &itn_out, &anorm_out, &acond_out, &rnorm_out, &arnorm_out, &xnorm_out);
+      mbnavadjust_lsqr(nrows_ba, ncols_ba, &matrix, damp, u, v, w, x, se, atol, btol, conlim, itnlim, &istop_out,
+                       &itn_out, &anorm_out, &acond_out, &rnorm_out, &arnorm_out, &xnorm_out);
 
       /* save solution */
       for (int ifile = 0; ifile < project.num_files; ifile++) {
@@ -7825,6 +7331,38 @@ void mb_aprod(int mode, int m, int n, double x[], double y[], void *UsrWrk) {
 }
 /*--------------------------------------------------------------------*/
 
+/* Checksum of everything that defines the navigation inversion other than
+   the ties themselves - the project, the inversion controls, the surveys,
+   the file status and survey, and the navigation points of each section. */
+static void mbnavadjust_invert_hash(unsigned int *signature, const void *data, size_t size) {
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t i = 0; i < size; i++) {
+    *signature ^= bytes[i];
+    *signature *= 16777619u;
+  }
+}
+static unsigned int mbnavadjust_invert_signature() {
+  unsigned int signature = 2166136261u;
+  mbnavadjust_invert_hash(&signature, project.path, strlen(project.path));
+  mbnavadjust_invert_hash(&signature, &project.smoothing, sizeof(project.smoothing));
+  mbnavadjust_invert_hash(&signature, &mbna_invert_mode, sizeof(mbna_invert_mode));
+  mbnavadjust_invert_hash(&signature, &project.num_surveys, sizeof(project.num_surveys));
+  mbnavadjust_invert_hash(&signature, &project.num_files, sizeof(project.num_files));
+  for (int ifile = 0; ifile < project.num_files; ifile++) {
+    struct mbna_file *file = &project.files[ifile];
+    mbnavadjust_invert_hash(&signature, &file->status, sizeof(file->status));
+    mbnavadjust_invert_hash(&signature, &file->block, sizeof(file->block));
+    mbnavadjust_invert_hash(&signature, &file->num_sections, sizeof(file->num_sections));
+    for (int isection = 0; isection < file->num_sections; isection++) {
+      struct mbna_section *section = &file->sections[isection];
+      mbnavadjust_invert_hash(&signature, &section->continuity, sizeof(section->continuity));
+      mbnavadjust_invert_hash(&signature, &section->num_snav, sizeof(section->num_snav));
+    }
+  }
+  return (signature);
+}
+/*--------------------------------------------------------------------*/
+
 int mbnavadjust_invertnav() {
   if (mbna_verbose >= 2) {
     fprintf(stderr, "\ndbg2  MBIO function <%s> called\n", __func__);
@@ -7919,6 +7457,8 @@ int mbnavadjust_invertnav() {
   double rnorm_out;
   double arnorm_out;
   double xnorm_out;
+  bool incremental = false;
+  unsigned int signature = 0;
 
   /* check if it is ok to invert
       - if there is a project
@@ -7964,6 +7504,15 @@ int mbnavadjust_invertnav() {
   {
     fprintf(stderr, "\nInverting for navigation adjustment model...\n");
 
+    /* if only the ties have changed since the last inversion then optionally
+       start from its solution, skipping the block and chunk stages and
+       solving only for the perturbation that fits the changed ties */
+    signature = mbnavadjust_invert_signature();
+    incremental = mbna_invert_incremental && invert_signature_valid && signature == invert_signature
+                  && project.inversion_status != MBNA_INVERSION_NONE;
+    if (incremental)
+      fprintf(stderr, "Starting from the previous inversion solution\n");
+
     /* set message dialog on */
     snprintf(message, sizeof(message), "Setting up navigation inversion...");
     do_message_on(message);
@@ -7972,15 +7521,17 @@ int mbnavadjust_invertnav() {
     /* Initialize arrays, solution, perturbation                      */
     /*----------------------------------------------------------------*/
 
-    /* zero solution across all navigation */
-    for (int ifile = 0; ifile < project.num_files; ifile++) {
-      file = &project.files[ifile];
-      for (int isection = 0; isection < file->num_sections; isection++) {
-        section = &file->sections[isection];
-        for (int isnav = 0; isnav < section->num_snav; isnav++) {
-          section->snav_lon_offset[isnav] = 0.0;
-          section->snav_lat_offset[isnav] = 0.0;
-          section->snav_z_offset[isnav] = 0.0;
+    /* zero solution across all navigation unless starting from the previous solution */
+    if (!incremental) {
+      for (int ifile = 0; ifile < project.num_files; ifile++) {
+        file = &project.files[ifile];
+        for (int isection = 0; isection < file->num_sections; isection++) {
+          section = &file->sections[isection];
+          for (int isnav = 0; isnav < section->num_snav; isnav++) {
+            section->snav_lon_offset[isnav] = 0.0;
+            section->snav_lat_offset[isnav] = 0.0;
+            section->snav_z_offset[isnav] = 0.0;
+          }
         }
       }
     }
@@ -8325,311 +7876,313 @@ fprintf(stderr, "\nGlobal ties Z %d:\n", nglobaltiez);
     }
 */
 
-    /* deal with xy global and/or fixed ties */
-    for (int igtie = 0; igtie < nglobaltiexy; igtie++) {
+    if (!incremental) {
+      /* deal with xy global and/or fixed ties */
+      for (int igtie = 0; igtie < nglobaltiexy; igtie++) {
 
-      /* Note a conflict if the file for this global tie has xy navigation fixed */
-      if (project.files[global_ties_xy_files[igtie]].status == MBNA_FILE_FIXEDNAV
-          || project.files[global_ties_xy_files[igtie]].status == MBNA_FILE_FIXEDXYNAV) {
-        fprintf(stdout, "MBnavadjust warning: An xy global tie has been defined for a file with xy navigation fixed.\n");
-        fprintf(stdout, "  File: %2.2d:%5.5d %s   Section: %d  Offset: %f m east  %f m north  %f m vertical\n",
-                project.files[global_ties_xy_sections[igtie]].block,
-                global_ties_xy_files[igtie],
-                project.files[global_ties_xy_sections[igtie]].file,
-                global_ties_xy_sections[igtie],
-                project.files[global_ties_xy_files[igtie]].sections[global_ties_xy_sections[igtie]].globaltie.offset_x_m,
-                project.files[global_ties_xy_files[igtie]].sections[global_ties_xy_sections[igtie]].globaltie.offset_y_m,
-                project.files[global_ties_xy_files[igtie]].sections[global_ties_xy_sections[igtie]].globaltie.offset_z_m);
-        fprintf(stdout, "  This global tie will be ignored because the solution offset is constrained to be zero.\n\n");
-      }
-
-      /* deal with this global or fixed tie (global takes precedence if both exist) */
-      int iblock_gtie = project.files[global_ties_xy_files[igtie]].block;
-      int ifile_gtie = global_ties_xy_files[igtie];
-      int isection_gtie = global_ties_xy_sections[igtie];
-      int isnav_gtie;
-      double global_offset_time_d;
-      double global_offset_x_m;
-      double global_offset_y_m;
-      if (project.files[ifile_gtie].sections[isection_gtie].globaltie.status != MBNA_TIE_NONE) {
-        isnav_gtie = project.files[ifile_gtie].sections[isection_gtie].globaltie.snav;
-        global_offset_time_d = project.files[ifile_gtie].sections[isection_gtie].globaltie.snav_time_d;
-        global_offset_x_m = project.files[ifile_gtie].sections[isection_gtie].globaltie.offset_x_m;
-        global_offset_y_m = project.files[ifile_gtie].sections[isection_gtie].globaltie.offset_y_m;
-      }
-      else /* if (project.files[ifile_gtie].sections[isection_gtie].fixedtie.status != MBNA_TIE_NONE) */ {
-        isnav_gtie = project.files[ifile_gtie].sections[isection_gtie].fixedtie.snav;
-        global_offset_time_d = project.files[ifile_gtie].sections[isection_gtie].fixedtie.snav_time_d;
-        global_offset_x_m = project.files[ifile_gtie].sections[isection_gtie].fixedtie.offset_x_m;
-        global_offset_y_m = project.files[ifile_gtie].sections[isection_gtie].fixedtie.offset_y_m;
-      }
-      int ifile_gtie0 = -1;
-      int isection_gtie0 = -1;
-      int isnav_gtie0 = -1;
-      double global_offset0_time_d = 0.0;
-      double global_offset0_x_m = 0.0;
-      double global_offset0_y_m = 0.0;
-      int iblock_gtie1 = -1;
-      int ifile_gtie1 = -1;
-      if (igtie > 0) {
-        ifile_gtie0 = global_ties_xy_files[igtie-1];
-        isection_gtie0 = global_ties_xy_sections[igtie-1];
-        if (project.files[ifile_gtie0].sections[isection_gtie0].globaltie.status != MBNA_TIE_NONE) {
-          isnav_gtie0 = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.snav;
-          global_offset0_time_d = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.snav_time_d;
-          global_offset0_x_m = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.offset_x_m;
-          global_offset0_y_m = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.offset_y_m;
-        }
-        else /* if (project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.status != MBNA_TIE_NONE) */ {
-          isnav_gtie0 = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.snav;
-          global_offset0_time_d = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.snav_time_d;
-          global_offset0_x_m = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.offset_x_m;
-          global_offset0_y_m = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.offset_y_m;
-        }
-      }
-      if (igtie < nglobaltiexy - 1) {
-        iblock_gtie1 = project.files[global_ties_xy_files[igtie+1]].block;
-        ifile_gtie1 = global_ties_xy_files[igtie+1];
-      }
-
-      /* if this is the first global tie in a survey/block then set all previous nav
-          in this block to the same offsets */
-      if (igtie == 0 || project.files[global_ties_xy_files[igtie-1]].block != iblock_gtie) {
-        /* loop over all files and sections up to this point - any in the same block
-            will have the offsets set */
-        for (int ifile = 0; ifile <= ifile_gtie; ifile++) {
-          file = &project.files[ifile];
-          if (file->block == iblock_gtie) {
-            int isectionmax = file->num_sections - 1;
-            if (ifile == ifile_gtie)
-              isectionmax = isection_gtie;
-            for (int isection = 0; isection <= isectionmax; isection++) {
-              section = &file->sections[isection];
-              int isnav_max = section->num_snav - 1;
-              if (ifile == ifile_gtie && isection == isection_gtie)
-                isnav_max = isnav_gtie;
-              for (int isnav = 0; isnav <= isnav_max; isnav++) {
-                section->snav_lon_offset[isnav] = global_offset_x_m * project.mtodeglon;
-                section->snav_lat_offset[isnav] = global_offset_y_m * project.mtodeglat;
+        /* Note a conflict if the file for this global tie has xy navigation fixed */
+        if (project.files[global_ties_xy_files[igtie]].status == MBNA_FILE_FIXEDNAV
+            || project.files[global_ties_xy_files[igtie]].status == MBNA_FILE_FIXEDXYNAV) {
+          fprintf(stdout, "MBnavadjust warning: An xy global tie has been defined for a file with xy navigation fixed.\n");
+          fprintf(stdout, "  File: %2.2d:%5.5d %s   Section: %d  Offset: %f m east  %f m north  %f m vertical\n",
+                  project.files[global_ties_xy_sections[igtie]].block,
+                  global_ties_xy_files[igtie],
+                  project.files[global_ties_xy_sections[igtie]].file,
+                  global_ties_xy_sections[igtie],
+                  project.files[global_ties_xy_files[igtie]].sections[global_ties_xy_sections[igtie]].globaltie.offset_x_m,
+                  project.files[global_ties_xy_files[igtie]].sections[global_ties_xy_sections[igtie]].globaltie.offset_y_m,
+                  project.files[global_ties_xy_files[igtie]].sections[global_ties_xy_sections[igtie]].globaltie.offset_z_m);
+          fprintf(stdout, "  This global tie will be ignored because the solution offset is constrained to be zero.\n\n");
+        }
+
+        /* deal with this global or fixed tie (global takes precedence if both exist) */
+        int iblock_gtie = project.files[global_ties_xy_files[igtie]].block;
+        int ifile_gtie = global_ties_xy_files[igtie];
+        int isection_gtie = global_ties_xy_sections[igtie];
+        int isnav_gtie;
+        double global_offset_time_d;
+        double global_offset_x_m;
+        double global_offset_y_m;
+        if (project.files[ifile_gtie].sections[isection_gtie].globaltie.status != MBNA_TIE_NONE) {
+          isnav_gtie = project.files[ifile_gtie].sections[isection_gtie].globaltie.snav;
+          global_offset_time_d = project.files[ifile_gtie].sections[isection_gtie].globaltie.snav_time_d;
+          global_offset_x_m = project.files[ifile_gtie].sections[isection_gtie].globaltie.offset_x_m;
+          global_offset_y_m = project.files[ifile_gtie].sections[isection_gtie].globaltie.offset_y_m;
+        }
+        else /* if (project.files[ifile_gtie].sections[isection_gtie].fixedtie.status != MBNA_TIE_NONE) */ {
+          isnav_gtie = project.files[ifile_gtie].sections[isection_gtie].fixedtie.snav;
+          global_offset_time_d = project.files[ifile_gtie].sections[isection_gtie].fixedtie.snav_time_d;
+          global_offset_x_m = project.files[ifile_gtie].sections[isection_gtie].fixedtie.offset_x_m;
+          global_offset_y_m = project.files[ifile_gtie].sections[isection_gtie].fixedtie.offset_y_m;
+        }
+        int ifile_gtie0 = -1;
+        int isection_gtie0 = -1;
+        int isnav_gtie0 = -1;
+        double global_offset0_time_d = 0.0;
+        double global_offset0_x_m = 0.0;
+        double global_offset0_y_m = 0.0;
+        int iblock_gtie1 = -1;
+        int ifile_gtie1 = -1;
+        if (igtie > 0) {
+          ifile_gtie0 = global_ties_xy_files[igtie-1];
+          isection_gtie0 = global_ties_xy_sections[igtie-1];
+          if (project.files[ifile_gtie0].sections[isection_gtie0].globaltie.status != MBNA_TIE_NONE) {
+            isnav_gtie0 = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.snav;
+            global_offset0_time_d = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.snav_time_d;
+            global_offset0_x_m = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.offset_x_m;
+            global_offset0_y_m = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.offset_y_m;
+          }
+          else /* if (project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.status != MBNA_TIE_NONE) */ {
+            isnav_gtie0 = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.snav;
+            global_offset0_time_d = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.snav_time_d;
+            global_offset0_x_m = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.offset_x_m;
+            global_offset0_y_m = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.offset_y_m;
+          }
+        }
+        if (igtie < nglobaltiexy - 1) {
+          iblock_gtie1 = project.files[global_ties_xy_files[igtie+1]].block;
+          ifile_gtie1 = global_ties_xy_files[igtie+1];
+        }
+
+        /* if this is the first global tie in a survey/block then set all previous nav
+            in this block to the same offsets */
+        if (igtie == 0 || project.files[global_ties_xy_files[igtie-1]].block != iblock_gtie) {
+          /* loop over all files and sections up to this point - any in the same block
+              will have the offsets set */
+          for (int ifile = 0; ifile <= ifile_gtie; ifile++) {
+            file = &project.files[ifile];
+            if (file->block == iblock_gtie) {
+              int isectionmax = file->num_sections - 1;
+              if (ifile == ifile_gtie)
+                isectionmax = isection_gtie;
+              for (int isection = 0; isection <= isectionmax; isection++) {
+                section = &file->sections[isection];
+                int isnav_max = section->num_snav - 1;
+                if (ifile == ifile_gtie && isection == isection_gtie)
+                  isnav_max = isnav_gtie;
+                for (int isnav = 0; isnav <= isnav_max; isnav++) {
+                  section->snav_lon_offset[isnav] = global_offset_x_m * project.mtodeglon;
+                  section->snav_lat_offset[isnav] = global_offset_y_m * project.mtodeglat;
+                }
               }
             }
           }
         }
-      }
 
-      /* else if the previous global tie is in the same block linearly interpolate
-          the offsets to the current global tie */
-      else {
-        for (int ifile = ifile_gtie0; ifile <= ifile_gtie; ifile++) {
-          file = &project.files[ifile];
-          if (file->block == iblock_gtie) {
-            int isectionmin = 0;
-            if (ifile == ifile_gtie0)
-              isectionmin = isection_gtie0;
-            int isectionmax = file->num_sections - 1;
-            if (ifile == ifile_gtie)
-              isectionmax = isection_gtie;
-            for (int isection = isectionmin; isection <= isectionmax; isection++) {
-              section = &file->sections[isection];
-              double fraction = 0.0;
-              int isnav_min = 0;
-              if (ifile == ifile_gtie0 && isection == isection_gtie0)
-                isnav_min = isnav_gtie0;
-              int isnav_max = section->num_snav - 1;
-              if (ifile == ifile_gtie && isection == isection_gtie)
-                isnav_max = isnav_gtie;
-              for (int isnav = isnav_min; isnav <= isnav_max; isnav++) {
-                if (global_offset_time_d > global_offset0_time_d)
-                  fraction = (section->snav_time_d[isnav] - global_offset0_time_d)
-                                    / (global_offset_time_d - global_offset0_time_d);
-                section->snav_lon_offset[isnav] = (global_offset0_x_m
-                      + fraction * (global_offset_x_m - global_offset0_x_m)) * project.mtodeglon;
-                section->snav_lat_offset[isnav] = (global_offset0_y_m
-                      + fraction * (global_offset_y_m - global_offset0_y_m)) * project.mtodeglat;
+        /* else if the previous global tie is in the same block linearly interpolate
+            the offsets to the current global tie */
+        else {
+          for (int ifile = ifile_gtie0; ifile <= ifile_gtie; ifile++) {
+            file = &project.files[ifile];
+            if (file->block == iblock_gtie) {
+              int isectionmin = 0;
+              if (ifile == ifile_gtie0)
+                isectionmin = isection_gtie0;
+              int isectionmax = file->num_sections - 1;
+              if (ifile == ifile_gtie)
+                isectionmax = isection_gtie;
+              for (int isection = isectionmin; isection <= isectionmax; isection++) {
+                section = &file->sections[isection];
+                double fraction = 0.0;
+                int isnav_min = 0;
+                if (ifile == ifile_gtie0 && isection == isection_gtie0)
+                  isnav_min = isnav_gtie0;
+                int isnav_max = section->num_snav - 1;
+                if (ifile == ifile_gtie && isection == isection_gtie)
+                  isnav_max = isnav_gtie;
+                for (int isnav = isnav_min; isnav <= isnav_max; isnav++) {
+                  if (global_offset_time_d > global_offset0_time_d)
+                    fraction = (section->snav_time_d[isnav] - global_offset0_time_d)
+                                      / (global_offset_time_d - global_offset0_time_d);
+                  section->snav_lon_offset[isnav] = (global_offset0_x_m
+                        + fraction * (global_offset_x_m - global_offset0_x_m)) * project.mtodeglon;
+                  section->snav_lat_offset[isnav] = (global_offset0_y_m
+                        + fraction * (global_offset_y_m - global_offset0_y_m)) * project.mtodeglat;
+                }
               }
             }
           }
         }
-      }
 
-      /* if this is the last global tie in a survey/block then set all following nav
-          in this block to the same offsets */
-      if (igtie == nglobaltiexy - 1 || iblock_gtie != iblock_gtie1) {
-        /* loop over all files and sections following this point - any in the same block
-            will have the offsets set */
-        int ifilemax = project.num_files - 1;
-        if (iblock_gtie1 > 0 && ifile_gtie1 > ifile_gtie)
-          ifilemax = ifile_gtie1 - 1;
-        for (int ifile = ifile_gtie; ifile <= ifilemax; ifile++) {
-          file = &project.files[ifile];
-          if (file->block == iblock_gtie) {
-            int isectionmin = 0;
-            if (ifile == ifile_gtie)
-              isectionmin = isection_gtie;
-            int isectionmax = file->num_sections - 1;
-            for (int isection = isectionmin; isection <= isectionmax; isection++) {
-              section = &file->sections[isection];
-              int isnav_min = 0;
-              if (ifile == ifile_gtie && isection == isection_gtie)
-                isnav_min = isnav_gtie;
-              int isnav_max = section->num_snav - 1;
-              for (int isnav = isnav_min; isnav <= isnav_max; isnav++) {
-                section->snav_lon_offset[isnav] = global_offset_x_m * project.mtodeglon;
-                section->snav_lat_offset[isnav] = global_offset_y_m * project.mtodeglat;
+        /* if this is the last global tie in a survey/block then set all following nav
+            in this block to the same offsets */
+        if (igtie == nglobaltiexy - 1 || iblock_gtie != iblock_gtie1) {
+          /* loop over all files and sections following this point - any in the same block
+              will have the offsets set */
+          int ifilemax = project.num_files - 1;
+          if (iblock_gtie1 > 0 && ifile_gtie1 > ifile_gtie)
+            ifilemax = ifile_gtie1 - 1;
+          for (int ifile = ifile_gtie; ifile <= ifilemax; ifile++) {
+            file = &project.files[ifile];
+            if (file->block == iblock_gtie) {
+              int isectionmin = 0;
+              if (ifile == ifile_gtie)
+                isectionmin = isection_gtie;
+              int isectionmax = file->num_sections - 1;
+              for (int isection = isectionmin; isection <= isectionmax; isection++) {
+                section = &file->sections[isection];
+                int isnav_min = 0;
+                if (ifile == ifile_gtie && isection == isection_gtie)
+                  isnav_min = isnav_gtie;
+                int isnav_max = section->num_snav - 1;
+                for (int isnav = isnav_min; isnav <= isnav_max; isnav++) {
+                  section->snav_lon_offset[isnav] = global_offset_x_m * project.mtodeglon;
+                  section->snav_lat_offset[isnav] = global_offset_y_m * project.mtodeglat;
+                }
               }
             }
           }
         }
-      }
-    } // end nglobaltiexy
+      } // end nglobaltiexy
 
-    /* deal with z global ties */
-    for (int igtie = 0; igtie < nglobaltiez; igtie++) {
+      /* deal with z global ties */
+      for (int igtie = 0; igtie < nglobaltiez; igtie++) {
 
-      /* Note a conflict if the file for this global tie has z navigation fixed */
-      if (project.files[global_ties_z_files[igtie]].status == MBNA_FILE_FIXEDNAV
-          || project.files[global_ties_z_files[igtie]].status == MBNA_FILE_FIXEDZNAV) {
-        fprintf(stdout, "MBnavadjust warning: A z global tie has been defined for a file with z navigation fixed.\n");
-        fprintf(stdout, "  File: %2.2d:%5.5d %s   Section: %d  Offset: %f m east  %f m north  %f m vertical\n",
-                project.files[global_ties_z_sections[igtie]].block,
-                global_ties_z_files[igtie],
-                project.files[global_ties_z_sections[igtie]].file,
-                global_ties_z_sections[igtie],
-                project.files[global_ties_z_files[igtie]].sections[global_ties_z_sections[igtie]].globaltie.offset_x_m,
-                project.files[global_ties_z_files[igtie]].sections[global_ties_z_sections[igtie]].globaltie.offset_y_m,
-                project.files[global_ties_z_files[igtie]].sections[global_ties_z_sections[igtie]].globaltie.offset_z_m);
-        fprintf(stdout, "  This global tie will be ignored because the solution offset is constrained to be zero.\n\n");
-      }
-
-      /* deal with this global or fixed tie (global takes precedence if both exist) */
-      int iblock_gtie = project.files[global_ties_xy_files[igtie]].block;
-      int ifile_gtie = global_ties_xy_files[igtie];
-      int isection_gtie = global_ties_xy_sections[igtie];
-      int isnav_gtie = -1;
-      double global_offset_time_d = 0.0;
-      double global_offset_z_m = 0.0;
-      if (project.files[ifile_gtie].sections[isection_gtie].globaltie.status != MBNA_TIE_NONE) {
-        isnav_gtie = project.files[ifile_gtie].sections[isection_gtie].globaltie.snav;
-        global_offset_time_d = project.files[ifile_gtie].sections[isection_gtie].globaltie.snav_time_d;
-        global_offset_z_m = project.files[ifile_gtie].sections[isection_gtie].globaltie.offset_z_m;
-      }
-      else /* if (project.files[ifile_gtie].sections[isection_gtie].fixedtie.status != MBNA_TIE_NONE) */ {
-        isnav_gtie = project.files[ifile_gtie].sections[isection_gtie].fixedtie.snav;
-        global_offset_time_d = project.files[ifile_gtie].sections[isection_gtie].fixedtie.snav_time_d;
-        global_offset_z_m = project.files[ifile_gtie].sections[isection_gtie].fixedtie.offset_z_m;
-      }
-      int ifile_gtie0 = -1;
-      int isection_gtie0 = -1;
-      int isnav_gtie0 = -1;
-      double global_offset0_time_d = 0.0;
-      double global_offset0_z_m = 0.0;
-      int iblock_gtie1 = -1;
-      int ifile_gtie1 = -1;
-      if (igtie > 0) {
-        ifile_gtie0 = global_ties_z_files[igtie-1];
-        isection_gtie0 = global_ties_z_sections[igtie-1];
-        if (project.files[ifile_gtie0].sections[isection_gtie0].globaltie.status != MBNA_TIE_NONE) {
-          isnav_gtie0 = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.snav;
-          global_offset0_time_d = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.snav_time_d;
-          global_offset0_z_m = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.offset_z_m;
-        }
-        else /* if (project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.status != MBNA_TIE_NONE) */ {
-          isnav_gtie0 = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.snav;
-          global_offset0_time_d = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.snav_time_d;
-          global_offset0_z_m = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.offset_z_m;
-        }
-      }
-      if (igtie < nglobaltiez - 1) {
-        iblock_gtie1 = project.files[global_ties_z_files[igtie+1]].block;
-        ifile_gtie1 = global_ties_z_files[igtie+1];
-      }
-
-      /* if this is the first global tie in a survey/block then set all previous nav
-          in this block to the same offsets */
-      if (igtie == 0 || project.files[global_ties_z_files[igtie-1]].block != iblock_gtie) {
-        /* loop over all files and sections up to this point - any in the same block
-            will have the offsets set */
-        for (int ifile = 0; ifile <= ifile_gtie; ifile++) {
-          file = &project.files[ifile];
-          if (file->block == iblock_gtie) {
-            int isectionmax = file->num_sections - 1;
-            if (ifile == ifile_gtie)
-              isectionmax = isection_gtie;
-            for (int isection = 0; isection <= isectionmax; isection++) {
-              section = &file->sections[isection];
-              for (int isnav = 0; isnav < section->num_snav; isnav++) {
-                section->snav_z_offset[isnav] = global_offset_z_m;
+        /* Note a conflict if the file for this global tie has z navigation fixed */
+        if (project.files[global_ties_z_files[igtie]].status == MBNA_FILE_FIXEDNAV
+            || project.files[global_ties_z_files[igtie]].status == MBNA_FILE_FIXEDZNAV) {
+          fprintf(stdout, "MBnavadjust warning: A z global tie has been defined for a file with z navigation fixed.\n");
+          fprintf(stdout, "  File: %2.2d:%5.5d %s   Section: %d  Offset: %f m east  %f m north  %f m vertical\n",
+                  project.files[global_ties_z_sections[igtie]].block,
+                  global_ties_z_files[igtie],
+                  project.files[global_ties_z_sections[igtie]].file,
+                  global_ties_z_sections[igtie],
+                  project.files[global_ties_z_files[igtie]].sections[global_ties_z_sections[igtie]].globaltie.offset_x_m,
+                  project.files[global_ties_z_files[igtie]].sections[global_ties_z_sections[igtie]].globaltie.offset_y_m,
+                  project.files[global_ties_z_files[igtie]].sections[global_ties_z_sections[igtie]].globaltie.offset_z_m);
+          fprintf(stdout, "  This global tie will be ignored because the solution offset is constrained to be zero.\n\n");
+        }
+
+        /* deal with this global or fixed tie (global takes precedence if both exist) */
+        int iblock_gtie = project.files[global_ties_xy_files[igtie]].block;
+        int ifile_gtie = global_ties_xy_files[igtie];
+        int isection_gtie = global_ties_xy_sections[igtie];
+        int isnav_gtie = -1;
+        double global_offset_time_d = 0.0;
+        double global_offset_z_m = 0.0;
+        if (project.files[ifile_gtie].sections[isection_gtie].globaltie.status != MBNA_TIE_NONE) {
+          isnav_gtie = project.files[ifile_gtie].sections[isection_gtie].globaltie.snav;
+          global_offset_time_d = project.files[ifile_gtie].sections[isection_gtie].globaltie.snav_time_d;
+          global_offset_z_m = project.files[ifile_gtie].sections[isection_gtie].globaltie.offset_z_m;
+        }
+        else /* if (project.files[ifile_gtie].sections[isection_gtie].fixedtie.status != MBNA_TIE_NONE) */ {
+          isnav_gtie = project.files[ifile_gtie].sections[isection_gtie].fixedtie.snav;
+          global_offset_time_d = project.files[ifile_gtie].sections[isection_gtie].fixedtie.snav_time_d;
+          global_offset_z_m = project.files[ifile_gtie].sections[isection_gtie].fixedtie.offset_z_m;
+        }
+        int ifile_gtie0 = -1;
+        int isection_gtie0 = -1;
+        int isnav_gtie0 = -1;
+        double global_offset0_time_d = 0.0;
+        double global_offset0_z_m = 0.0;
+        int iblock_gtie1 = -1;
+        int ifile_gtie1 = -1;
+        if (igtie > 0) {
+          ifile_gtie0 = global_ties_z_files[igtie-1];
+          isection_gtie0 = global_ties_z_sections[igtie-1];
+          if (project.files[ifile_gtie0].sections[isection_gtie0].globaltie.status != MBNA_TIE_NONE) {
+            isnav_gtie0 = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.snav;
+            global_offset0_time_d = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.snav_time_d;
+            global_offset0_z_m = project.files[ifile_gtie0].sections[isection_gtie0].globaltie.offset_z_m;
+          }
+          else /* if (project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.status != MBNA_TIE_NONE) */ {
+            isnav_gtie0 = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.snav;
+            global_offset0_time_d = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.snav_time_d;
+            global_offset0_z_m = project.files[ifile_gtie0].sections[isection_gtie0].fixedtie.offset_z_m;
+          }
+        }
+        if (igtie < nglobaltiez - 1) {
+          iblock_gtie1 = project.files[global_ties_z_files[igtie+1]].block;
+          ifile_gtie1 = global_ties_z_files[igtie+1];
+        }
+
+        /* if this is the first global tie in a survey/block then set all previous nav
+            in this block to the same offsets */
+        if (igtie == 0 || project.files[global_ties_z_files[igtie-1]].block != iblock_gtie) {
+          /* loop over all files and sections up to this point - any in the same block
+              will have the offsets set */
+          for (int ifile = 0; ifile <= ifile_gtie; ifile++) {
+            file = &project.files[ifile];
+            if (file->block == iblock_gtie) {
+              int isectionmax = file->num_sections - 1;
+              if (ifile == ifile_gtie)
+                isectionmax = isection_gtie;
+              for (int isection = 0; isection <= isectionmax; isection++) {
+                section = &file->sections[isection];
+                for (int isnav = 0; isnav < section->num_snav; isnav++) {
+                  section->snav_z_offset[isnav] = global_offset_z_m;
+                }
               }
             }
           }
         }
-      }
 
-      /* else if the previous global tie is in the same block linearly interpolate
-          the offsets to the current global tie */
-      else {
-        for (int ifile = global_ties_z_files[igtie-1]; ifile <= ifile_gtie; ifile++) {
-          file = &project.files[ifile];
-          if (file->block == iblock_gtie) {
-            int isectionmin = 0;
-            if (ifile == ifile_gtie0)
-              isectionmin = isection_gtie0;
-            int isectionmax = file->num_sections - 1;
-            if (ifile == ifile_gtie)
-              isectionmax = isection_gtie;
-            for (int isection = isectionmin; isection <= isectionmax; isection++) {
-              section = &file->sections[isection];
-              double fraction = 0.0;
-              int isnav_min = 0;
-              if (ifile == ifile_gtie0 && isection == isection_gtie0)
-                isnav_min = isnav_gtie0;
-              int isnav_max = section->num_snav - 1;
-              if (ifile == ifile_gtie && isection == isection_gtie)
-                isnav_max = isnav_gtie;
-              for (int isnav = isnav_min; isnav <= isnav_max; isnav++) {
-                if (global_offset_time_d > global_offset0_time_d)
-                  fraction = (section->snav_time_d[isnav] - global_offset0_time_d)
-                                    / (global_offset_time_d - global_offset0_time_d);
-                section->snav_z_offset[isnav] = (global_offset0_z_m
-                      + fraction * (global_offset_z_m - global_offset0_z_m));
+        /* else if the previous global tie is in the same block linearly interpolate
+            the offsets to the current global tie */
+        else {
+          for (int ifile = global_ties_z_files[igtie-1]; ifile <= ifile_gtie; ifile++) {
+            file = &project.files[ifile];
+            if (file->block == iblock_gtie) {
+              int isectionmin = 0;
+              if (ifile == ifile_gtie0)
+                isectionmin = isection_gtie0;
+              int isectionmax = file->num_sections - 1;
+              if (ifile == ifile_gtie)
+                isectionmax = isection_gtie;
+              for (int isection = isectionmin; isection <= isectionmax; isection++) {
+                section = &file->sections[isection];
+                double fraction = 0.0;
+                int isnav_min = 0;
+                if (ifile == ifile_gtie0 && isection == isection_gtie0)
+                  isnav_min = isnav_gtie0;
+                int isnav_max = section->num_snav - 1;
+                if (ifile == ifile_gtie && isection == isection_gtie)
+                  isnav_max = isnav_gtie;
+                for (int isnav = isnav_min; isnav <= isnav_max; isnav++) {
+                  if (global_offset_time_d > global_offset0_time_d)
+                    fraction = (section->snav_time_d[isnav] - global_offset0_time_d)
+                                      / (global_offset_time_d - global_offset0_time_d);
+                  section->snav_z_offset[isnav] = (global_offset0_z_m
+                        + fraction * (global_offset_z_m - global_offset0_z_m));
+                }
               }
             }
           }
         }
-      }
 
-      /* if this is the last global tie in a survey/block then set all following nav
-          in this block to the same offsets */
-      if (igtie == nglobaltiexy - 1 || iblock_gtie != iblock_gtie1) {
-        /* loop over all files and sections following this point - any in the same block
-            will have the offsets set */
-        int ifilemax = project.num_files - 1;
-        if (iblock_gtie1 > 0 && ifile_gtie1 > ifile_gtie)
-          ifilemax = ifile_gtie1 - 1;
-        for (int ifile = ifile_gtie; ifile <= ifilemax; ifile++) {
-          file = &project.files[ifile];
-          if (file->block == iblock_gtie) {
-            int isectionmin = 0;
-            if (ifile == ifile_gtie)
-              isectionmin = isection_gtie;
-            int isectionmax = file->num_sections - 1;
-            for (int isection = isectionmin; isection <= isectionmax; isection++) {
-              section = &file->sections[isection];
-              int isnav_min = 0;
-              if (ifile == ifile_gtie && isection == isection_gtie)
-                isnav_min = isnav_gtie;
-              int isnav_max = section->num_snav - 1;
-              for (int isnav = isnav_min; isnav <= isnav_max; isnav++) {
-                section->snav_z_offset[isnav] = global_offset_z_m;
+        /* if this is the last global tie in a survey/block then set all following nav
+            in this block to the same offsets */
+        if (igtie == nglobaltiexy - 1 || iblock_gtie != iblock_gtie1) {
+          /* loop over all files and sections following this point - any in the same block
+              will have the offsets set */
+          int ifilemax = project.num_files - 1;
+          if (iblock_gtie1 > 0 && ifile_gtie1 > ifile_gtie)
+            ifilemax = ifile_gtie1 - 1;
+          for (int ifile = ifile_gtie; ifile <= ifilemax; ifile++) {
+            file = &project.files[ifile];
+            if (file->block == iblock_gtie) {
+              int isectionmin = 0;
+              if (ifile == ifile_gtie)
+                isectionmin = isection_gtie;
+              int isectionmax = file->num_sections - 1;
+              for (int isection = isectionmin; isection <= isectionmax; isection++) {
+                section = &file->sections[isection];
+                int isnav_min = 0;
+                if (ifile == ifile_gtie && isection == isection_gtie)
+                  isnav_min = isnav_gtie;
+                int isnav_max = section->num_snav - 1;
+                for (int isnav = isnav_min; isnav <= isnav_max; isnav++) {
+                  section->snav_z_offset[isnav] = global_offset_z_m;
+                }
               }
             }
           }
         }
-      }
-    } // end nglobaltiez
+      } // end nglobaltiez
 
-    fprintf(stderr, "\nApplied global ties to initial adjustment model:\n\tnglobaltiexy:%d\n\tnglobaltiez:%d\n",
-            nglobaltiexy, nglobaltiez);
+      fprintf(stderr, "\nApplied global ties to initial adjustment model:\n\tnglobaltiexy:%d\n\tnglobaltiez:%d\n",
+              nglobaltiexy, nglobaltiez);
+    }
 
     /*
     fprintf(stderr, "\nInitial adjustment model:\n");
@@ -8769,7 +8322,7 @@ fprintf(stderr, "\nGlobal ties Z %d:\n", nglobaltiez);
     }
 
     /* only do block average solution if there is more than one block */
-    if (nblock > 1) {
+    if (nblock > 1 && !incremental) {
 
       /* allocate block average offset arrays */
       status = mb_mallocd(mbna_verbose, __FILE__, __LINE__, nblock * (nblock + 1) / 2 * sizeof(int), (void **)&nbxy, &error);
@@ -8991,7 +8544,7 @@ fprintf(stderr, "\nGlobal ties Z %d:\n", nglobaltiez);
     /*----------------------------------------------------------------*/
     /* Create block offset inversion matrix problem                   */
     /*----------------------------------------------------------------*/
-    if (nblock > 1) {
+    if (nblock > 1 && !incremental) {
       matrix.m = nrows_ba;
       matrix.n = ncols_ba;
       matrix.ia_dim = ncols_ba;
@@ -9176,8 +8729,8 @@ fprintf(stderr, "\nGlobal ties Z %d:\n", nglobaltiez);
       //  fprintf(stderr," | b:%10.6f\n",u[i]);
       //  }
 
-      mblsqr_lsqr(nrows_ba, ncols_ba, &mb_aprod, damp, &matrix, u, v, w, x, se, atol, btol, conlim, itnlim, stderr,
-                  &istop_out, &itn_out, &anorm_out, &acond_out, &rnorm_out, &arnorm_out, &xnorm_out);
+      mbnavadjust_lsqr(nrows_ba, ncols_ba, &matrix, damp, u, v, w, x, se, atol, btol, conlim, itnlim, &istop_out,
+                       &itn_out, &anorm_out, &acond_out, &rnorm_out, &arnorm_out, &xnorm_out);
 
       /* save solution */
       double rms_solution = 0.0;
@@ -9344,6 +8897,7 @@ fprintf(stderr, "\nGlobal ties Z %d:\n", nglobaltiez);
          * many multi-survey navigation adjustment problems.
          */
 
+    if (!incremental) {
         /* loop over all ties applying the offsets to the chunks partitioned according to survey quality */
         n_iteration = 100000;
         convergence = 1000.0;
@@ -9833,6 +9387,7 @@ fprintf(stderr, "\nGlobal ties Z %d:\n", nglobaltiez);
                     rms_solution, rms_solution_total, rms_misfit_initial,
                     rms_misfit_previous, rms_misfit_current, convergence);
         } // iteration
+    }
 
     /* set message dialog on */
     snprintf(message, sizeof(message), "Completed chunk inversion...");
@@ -9850,7 +9405,7 @@ fprintf(stderr, "\nGlobal ties Z %d:\n", nglobaltiez);
     /* the whole project using all ties to fit the remmaining misfit.          */
     /*-------------------------------------------------------------------------*/
 
-    for (int isurvey = -1; isurvey <= project.num_surveys; isurvey++) {
+    for (int isurvey = incremental ? project.num_surveys : -1; isurvey <= project.num_surveys; isurvey++) {
       matrix_scale = 1000.0;
       convergence = 1000.0;
       smooth_exp = project.smoothing;
@@ -10533,8 +10088,8 @@ fprintf(stderr, "\nGlobal ties Z %d:\n", nglobaltiez);
       //  fprintf(stderr," | b:%10.6f\n",u[i]);
       //  }
 
-      mblsqr_lsqr(matrix.m, matrix.n, &mb_aprod, damp, &matrix, u, v, w, x, se, atol, btol, conlim, itnlim, stderr, &istop_out,
-                  &itn_out, &anorm_out, &acond_out, &rnorm_out, &arnorm_out, &xnorm_out);
+      mbnavadjust_lsqr(matrix.m, matrix.n, &matrix, damp, u, v, w, x, se, atol, btol, conlim, itnlim, &istop_out,
+                       &itn_out, &anorm_out, &acond_out, &rnorm_out, &arnorm_out, &xnorm_out);
 
       fprintf(stderr, "\nInversion by LSQR completed\n");
       fprintf(stderr, "\tReason for termination:       %d\n", istop_out);
@@ -10894,6 +10449,8 @@ offset_x, offset_y, offset_z); */
 
     /* write updated project */
     project.inversion_status = MBNA_INVERSION_CURRENT;
+    invert_signature = signature;
+    invert_signature_valid = true;
         project.modelplot_uptodate = false;
     project.grid_status = MBNA_GRID_OLD;
     mbnavadjust_write_project(mbna_verbose, &project, __FILE__, __LINE__, __FUNCTION__, &error);
@@ -114,6 +114,8 @@
 #define MOD_MODE_REMOVE_FILE 58
 #define MOD_MODE_REMAKE_MB166_FILES 59
 #define MOD_MODE_FIX_SENSORDEPTH 60
+#define MOD_MODE_AUTOPICK 61
+#define MOD_MODE_AUTOPICK_HORIZONTAL 62
 #define IMPORT_NONE 0
 #define IMPORT_TIE 1
 #define IMPORT_GLOBALTIE 2
@@ -210,6 +212,9 @@ static char usage_message[] =
     "\t--remove-file=file\n"
     "\t--remake-mb166-files\n"
     "\t--fix-sensordepth\n"
+    "\t--autopick[=nthreads]\n"
+    "\t--autopick-horizontal[=nthreads]\n"
+    "\t--autopick-cache=size_mb\n"
     "\t--shift-global-ties=shiftx/shifty\n"
     "\t--verbose --help]\n";
 
@@ -240,6 +245,8 @@ int main(int argc, char **argv) {
   double minimum_section_length = 0.0;
   int minimum_section_soundings = 0;
   int ifile_remove = 0;
+  int autopick_nthreads = 0;
+  int autopick_cache_size = MBNA_SECTION_CACHE_DEFAULT;
 
   {
   static struct option options[] = {{"verbose", no_argument, NULL, 0},
@@ -309,6 +316,9 @@ int main(int argc, char **argv) {
                                     {"remove-file", required_argument, NULL, 0},
                                     {"remake-mb166-files", no_argument, NULL, 0},
                                     {"fix-sensordepth", no_argument, NULL, 0},
+                                    {"autopick", optional_argument, NULL, 0},
+                                    {"autopick-horizontal", optional_argument, NULL, 0},
+                                    {"autopick-cache", required_argument, NULL, 0},
                                     {NULL, 0, NULL, 0}};
 
   int option_index;
@@ -1535,6 +1545,39 @@ int main(int argc, char **argv) {
         }
       }
 
+      /*-------------------------------------------------------
+       * Autopick ties for all unanalyzed crossings with sufficient overlap
+       * using multiple threads, optionally only in the horizontal
+          --autopick[=nthreads]
+          --autopick-horizontal[=nthreads]
+          --autopick-cache=size_mb */
+      else if (strcmp("autopick", options[option_index].name) == 0
+               || strcmp("autopick-horizontal", options[option_index].name) == 0) {
+        if (num_mods < NUMBER_MODS_MAX) {
+          if (optarg != NULL && sscanf(optarg, "%d", &autopick_nthreads) != 1) {
+            fprintf(stderr, "Failure to parse --%s=%s\n\tmod command ignored\n\n", options[option_index].name, optarg);
+          }
+          else {
+            if (strcmp("autopick", options[option_index].name) == 0)
+              mods[num_mods].mode = MOD_MODE_AUTOPICK;
+            else
+              mods[num_mods].mode = MOD_MODE_AUTOPICK_HORIZONTAL;
+            num_mods++;
+          }
+        }
+        else {
+          fprintf(stderr,
+                  "Maximum number of mod commands reached:\n\t%s command ignored\n\n", options[option_index].name);
+        }
+      }
+      else if (strcmp("autopick-cache", options[option_index].name) == 0) {
+        if (sscanf(optarg, "%d", &autopick_cache_size) != 1 || autopick_cache_size <= 0) {
+          fprintf(stderr, "Failure to parse --autopick-cache=%s\n\tdefault of %d MB used\n\n", optarg,
+                  MBNA_SECTION_CACHE_DEFAULT);
+          autopick_cache_size = MBNA_SECTION_CACHE_DEFAULT;
+        }
+      }
+
       /*-------------------------------------------------------*/
 
       break;
@@ -3833,6 +3876,19 @@ int main(int argc, char **argv) {
       }
       break;
 
+    case MOD_MODE_AUTOPICK:
+    case MOD_MODE_AUTOPICK_HORIZONTAL:
+      fprintf(stderr, "\nCommand %s\n", mods[imod].mode == MOD_MODE_AUTOPICK ? "autopick" : "autopick-horizontal");
+      status = mbnavadjust_autopick_batch(verbose, &project_output, mods[imod].mode == MOD_MODE_AUTOPICK,
+                                          MBNA_MISFIT_MODE_FFT, autopick_nthreads,
+                                          (size_t)autopick_cache_size * 1024 * 1024, &error);
+      if (status == MB_FAILURE) {
+        fprintf(stderr, "**FAILED to autopick crossings\n");
+        status = MB_SUCCESS;
+        error = MB_ERROR_NO_ERROR;
+      }
+      break;
+
     }
   }
 
@@ -221,7 +221,7 @@ JanitorInitializer::JanitorInitializer()
 
 #endif                              // end of SimulateExceptions
 
-Tracer* Tracer::last;               // will be set to zero
+thread_local Tracer* Tracer::last; // will be set to zero
 
 
 void Terminate()
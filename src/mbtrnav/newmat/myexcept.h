@@ -73,7 +73,7 @@ public:
    void ReName(const char*);
    static void PrintTrace();             // for printing trace
    static void AddTrace();               // insert trace in exception record
-   static Tracer* last;                  // points to Tracer list
+   static thread_local Tracer* last;     // points to Tracer list (one per thread)
    friend class BaseException;
 };
 
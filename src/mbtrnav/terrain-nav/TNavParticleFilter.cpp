@@ -14,6 +14,13 @@
 #include "TNavPFLog.h"
 #include "mapio.h"
 
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <thread>
+
 #define _STR(x) #x
 #define STR(x) _STR(x)
 
@@ -28,6 +35,55 @@
 #define USE_SUBCLOUD_COMPARISON 0
 
 
+//Number of threads to use for nItems particles
+static int numParticleThreads(int nItems) {
+	int nThreads = (int)std::thread::hardware_concurrency();
+	nThreads = std::min(nThreads, MAX_PF_THREADS);
+	nThreads = std::min(nThreads, nItems / MIN_PF_THREAD_PARTICLES);
+	return std::max(nThreads, 1);
+}
+
+//Calls func(thread, begin, end) for nThreads contiguous ranges covering
+//[0, nItems), the calling thread taking the first range.  If a thread cannot
+//be started its range is done by the calling thread.  An exception thrown in
+//any range is rethrown once all of the threads have finished.
+static void forParticleRanges(int nItems, int nThreads,
+							  const std::function<void(int, int, int)>& func) {
+	std::vector<std::thread> threads;
+	std::vector<std::exception_ptr> errors(nThreads);
+	auto run = [&](int ithread) {
+		try {
+			func(ithread, (int)((long)nItems * ithread / nThreads),
+				 (int)((long)nItems * (ithread + 1) / nThreads));
+		} catch(...) {
+			errors[ithread] = std::current_exception();
+		}
+	};
+
+	int nStarted = 1;
+	for(int ithread = 1; ithread < nThreads; ithread++) {
+		try {
+			threads.push_back(std::thread(run, ithread));
+			nStarted++;
+		} catch(const std::system_error&) {
+			break;
+		}
+	}
+	run(0);
+	for(int ithread = nStarted; ithread < nThreads; ithread++) {
+		run(ithread);
+	}
+	for(size_t ithread = 0; ithread < threads.size(); ithread++) {
+		threads[ithread].join();
+	}
+	for(int ithread = 0; ithread < nThreads; ithread++) {
+		if(errors[ithread]) {
+			std::rethrow_exception(errors[ithread]);
+		}
+	}
+}
+
+
 //TNavParticleFilter:: //Reload Map Issue
 //TNavParticleFilter(char* mapName, char* vehicleSpecs, char* directory, const double* windowVar,
 //				   const int& mapType) : TNavFilter(mapName, vehicleSpecs, directory, windowVar, mapType) {
@@ -210,75 +266,70 @@ measUpdate(measT& currMeas) {
 			{
 				this->useBeam[i]=true;
 			}
+			computeExpectedMeasDiffs(beamsVF, tempBeamsVF, attitude, currMeas.ranges, beamIndices, mapVar);
+
+			//A beam is used for normal weighting only if every particle has a
+			//good expectation for it. Unless weighting by subclouds, a
+			//measurement is skipped if any particle has no good beams.
+			const bool subcloudWeighting = (TRN_WT_SUBCL == this->useModifiedWeighting || TRN_FORCE_SUBCL == this->useModifiedWeighting);
+			int lastParticle = nParticles - 1;
+			nBeamsUsed = 0;
 			for(i = 0; i < nParticles; i++) {
-				if(!ALLOW_ATTITUDE_SEARCH && SEARCH_PSI_BERG)
-				{
-					//
-					// tempBeamsVF stores beamsVF so that each particle does its own rotation.
-					tempAttitude[0] = attitude[0];
-					tempAttitude[1] = attitude[1];
-					tempAttitude[2] = attitude[2] - allParticles[i].psiBerg;
-
-					beamsVF = applyRotation(tempAttitude, tempBeamsVF);
-				}
-				//Edit to allow using only one beam from a measurement
-				// sets this->tempUseBeam
-
-
-				getExpectedMeasDiffParticle(allParticles[i], beamsVF, currMeas.ranges, beamIndices, mapVar);
-
-				for( int indx=0; indx < beamsVF.Ncols(); indx++ )
-				{
-					this->useBeam[indx] = this->useBeam[indx] && this->tempUseBeam[indx];
-				}
-
-				//
-				// Check for this particular particle:
 				nBeamsUsed = 0;
 				for(int j = 0; j < beamsVF.Ncols(); j++) {
-					if(this->tempUseBeam[j]){
+					if(!ISNIN(particleStore.measDiff[(size_t)j * nParticles + i])) {
 						nBeamsUsed++;
+					} else {
+						this->useBeam[j] = false;
 					}
 				}
+				if(nBeamsUsed == 0 && !subcloudWeighting) {
+					lastParticle = i;
+					break;
+				}
+			}
+			for(int j = 0; j < beamsVF.Ncols(); j++) {
+				this->tempUseBeam[j] = !ISNIN(particleStore.measDiff[(size_t)j * nParticles + lastParticle]);
+			}
 
-				pfLog->setUsedBeams(nBeamsUsed);
-
-				bool atLeastOneBeamGood = nBeamsUsed > 0;
+			pfLog->setUsedBeams(nBeamsUsed);
 
-				//if(!getExpectedMeasDiffParticle(allParticles[i], beamsVF, currMeas.ranges, beamIndices, mapVar)) {
-				//if any of the measurement projections fail due to falling in NaN region of map!
+			//Leave beamsVF rotated for the last particle as the sequential loop did
+			if(!ALLOW_ATTITUDE_SEARCH && SEARCH_PSI_BERG)
+			{
+				tempAttitude[0] = attitude[0];
+				tempAttitude[1] = attitude[1];
+				tempAttitude[2] = attitude[2] - allParticles[lastParticle].psiBerg;
 
+				beamsVF = applyRotation(tempAttitude, tempBeamsVF);
+			}
 
-				//if(!atLeastOneBeamGood && !USE_SUBCLOUD_COMPARISON){
-				if(!atLeastOneBeamGood && (TRN_WT_SUBCL != this->useModifiedWeighting  && TRN_FORCE_SUBCL != this->useModifiedWeighting)){
-					//none of the beams was good for this particular particle.
-					logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),
-						"TNavPF::Measurement from time = %.2f sec. not included.",currMeas.time);
-					//"encountered NaN values in the correlation map segment for all beams on one particle.\n",
-					logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),
-						"Particle[%d] has NaN for all beam ranges, with roll = %.1f, "
-						"pitch = %.1f, yaw = %.1f degrees.\n",
-						i, allParticles[i].attitude[0]*180./PI,
-						allParticles[i].attitude[1]*180./PI,
-						allParticles[i].attitude[2]*180./PI);
-					logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),
-						"x = %.1f, y = %.1f z = %.1f.\n",
-						allParticles[i].position[0],
-						allParticles[i].position[1],
-						allParticles[i].position[2]);
-					logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),
-						"[ %.1f  %.1f  %.1f  %.3f  %.3f  %.3f];\n",
-						allParticles[i].position[0],
-						allParticles[i].position[1],
-						allParticles[i].position[2],
-						allParticles[i].attitude[0],
-						allParticles[i].attitude[1],
-						allParticles[i].attitude[2]);
-					return false;
-				}
-				// release resources allocated in call to
-				// getExpectedMeasDiffParticle(), above
-				//if( (i+1) != nParticles) delete [] useBeam;
+			if(nBeamsUsed == 0 && !subcloudWeighting){
+				//none of the beams was good for this particular particle.
+				i = lastParticle;
+				logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),
+					"TNavPF::Measurement from time = %.2f sec. not included.",currMeas.time);
+				//"encountered NaN values in the correlation map segment for all beams on one particle.\n",
+				logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),
+					"Particle[%d] has NaN for all beam ranges, with roll = %.1f, "
+					"pitch = %.1f, yaw = %.1f degrees.\n",
+					i, allParticles[i].attitude[0]*180./PI,
+					allParticles[i].attitude[1]*180./PI,
+					allParticles[i].attitude[2]*180./PI);
+				logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),
+					"x = %.1f, y = %.1f z = %.1f.\n",
+					allParticles[i].position[0],
+					allParticles[i].position[1],
+					allParticles[i].position[2]);
+				logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),
+					"[ %.1f  %.1f  %.1f  %.3f  %.3f  %.3f];\n",
+					allParticles[i].position[0],
+					allParticles[i].position[1],
+					allParticles[i].position[2],
+					allParticles[i].attitude[0],
+					allParticles[i].attitude[1],
+					allParticles[i].attitude[2]);
+				return false;
 			}
 
 			bool temp = false;
@@ -713,62 +764,29 @@ measUpdate(measT& currMeas) {
 
 			//Loop through & compute measurement update weights for all particles
 			double sumSquaredError = 0.;
-			double sumWeightedError = 0.;
 			double sumInvVar = 0.;
-			double currDepthBias = 0.;
 
-//		TODO: Beam Variance can be computed ahead of time (implement later)
-//		for (int beamInd = 0; beamInd < beamsVF.Ncols(); beamInd++) sumInvVar += (1.0/(totalVar[beamInd]));
-
-			for(i = 0; i < nParticles; i++) {
-				sumSquaredError = 0.;
-				sumWeightedError = 0.;
-				sumInvVar = 0.;
-
-				currMeasWeights[i] = 1;
-
-				for(int beamInd = 0; beamInd < beamsVF.Ncols(); beamInd++) {
-					if(this->useBeam[beamInd]){	//edit to allow using any good beams from measurement
-
-						//As we already have the expected measurement difference, just apply the measurement model to it
-						sumWeightedError += (1.0 / (totalVar[beamInd])) * allParticles[i].expectedMeasDiff[beamInd]; //Weighted mean error
-						sumSquaredError += (1.0 / (totalVar[beamInd])) * pow(allParticles[i].expectedMeasDiff[beamInd], 2); //Weighted Squared Error
-						sumInvVar += (1.0 / (totalVar[beamInd]));		//Beam Variance
-						//					logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),"TNavPF:totalVar[%i] is %f\n",beamInd,totalVar[beamInd]);
-						if(ISNIN(sumSquaredError))
-						{
-							logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),"TNavPF:Sum of squared error for particle %i beam %i is nan \n", i, beamInd);
-
-						  pfLog->write();
-
-							return false;
-							//		     logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),"TNavPF:totalVar[%i] is %f\n",beamInd,totalVar[beamInd]);
-							//		     logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),"TNavPF:expectedMeasDiff[%i] is %f \n",beamInd,allParticles[i].expectedMeasDiff[beamInd]);
-						}
-					}
+			for(int beamInd = 0; beamInd < beamsVF.Ncols(); beamInd++) {
+				if(this->useBeam[beamInd]){	//edit to allow using any good beams from measurement
+					sumInvVar += (1.0 / (totalVar[beamInd]));		//Beam Variance
 				}
+			}
 
-				//Compute new measurement weight
-				if(USE_CONTOUR_MATCHING && !USE_RANGE_CORR) {
-					currDepthBias = (1.0 / sumInvVar) * sumWeightedError;
-					allParticles[i].position[2] -= currDepthBias;
-					for(int beamInd = 0; beamInd < beamsVF.Ncols(); beamInd++) {
-						if(this->useBeam[beamInd]){	//edit to allow using any good beams from measurement
-							allParticles[i].expectedMeasDiff[beamInd] -= currDepthBias;
-						}
-					}
+			int badParticle = computeMeasWeights(totalVar, beamsVF.Ncols(), sumInvVar);
+			if(badParticle >= 0) {
+				logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),"TNavPF:Sum of squared error for particle %i beam %i is nan \n",
+					badParticle, particleStore.firstBadBeam[badParticle]);
 
-					//calculate likelihood equation.
-					//currMeasWeights[i] = exp(-0.5*(sumSquaredError-2*currDepthBias*sumWeightedError+pow(currDepthBias,2)*sumInvVar));
-					currMeasWeights[i] = exp(-0.5 * (sumSquaredError - currDepthBias * sumWeightedError));
-					//newWeight *= exp(-0.5*(currDepthBias*currDepthBias));
-				} else {
-					currMeasWeights[i] = exp(-0.5 * sumSquaredError);
-				}
+				pfLog->write();
+
+				return false;
+			}
 
+			for(i = 0; i < nParticles; i++) {
 				sumWeights += allParticles[i].weight * currMeasWeights[i];
 				sumMeasWeights += currMeasWeights[i];
 			}
+			sumSquaredError = particleStore.sumSquaredError[nParticles - 1];
 
 			logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),"TNavPF:: sumSquaredError = %f \n", sumSquaredError);
 			logs(TL_OMASK(TL_TNAV_PARTICLE_FILTER, TL_LOG),"TNavPF:: sumWeights = %f \n", sumWeights);
@@ -1643,6 +1661,15 @@ homerMeasUpdate(const measT& currMeas) {
 bool
 TNavParticleFilter::
 getExpectedMeasDiffParticle(particleT& particle, const Matrix& beamsSF, double* beamRanges, const int* beamIndices, double& mapVar) {
+	return getExpectedMeasDiffParticle(particle, beamsSF, beamRanges, beamIndices, mapVar, this->tempUseBeam);
+}
+
+//********************************************************************************
+
+bool
+TNavParticleFilter::
+getExpectedMeasDiffParticle(particleT& particle, const Matrix& beamsSF, double* beamRanges, const int* beamIndices, double& mapVar,
+							bool* usableBeams) {
 //Update Expected Measurement Differences
 // This function takes in a particle (particle) and the beams in the ??? frame
 // (beamsSF), and the ranges (beamRanges)
@@ -1711,7 +1738,7 @@ getExpectedMeasDiffParticle(particleT& particle, const Matrix& beamsSF, double*
 		// if(isnan(tempExpectedMeasDiff[i])){
 		if(ISNIN(tempExpectedMeasDiff[i])){
 			//tempExpectedMeasDiff[i] = 0;
-			this->tempUseBeam[i] = false; //beam hit map hole or missed -> don't use this beam to compare particles
+			usableBeams[i] = false; //beam hit map hole or missed -> don't use this beam to compare particles
 			/*if(!USE_MAP_NAN){
 				return false;
 			}
@@ -1719,7 +1746,7 @@ getExpectedMeasDiffParticle(particleT& particle, const Matrix& beamsSF, double*
 		}
 		else
 		{
-			this->tempUseBeam[i] = true;
+			usableBeams[i] = true;
 			goodBeams = true;            // OK, at least one beam is good
 		}
 
@@ -1731,6 +1758,132 @@ getExpectedMeasDiffParticle(particleT& particle, const Matrix& beamsSF, double*
 
 //********************************************************************************
 
+void
+TNavParticleFilter::
+computeExpectedMeasDiffs(const Matrix& beamsVF, const Matrix& tempBeamsVF, const double* attitude, double* beamRanges,
+						 const int* beamIndices, double& mapVar) {
+	const int nBeams = beamsVF.Ncols();
+	const double initialMapVar = mapVar;
+	particleStore.resize(nParticles, nBeams);
+
+	//Map lookups are only made concurrently if the map allows it
+	int nThreads = 1;
+	if(terrainMap->GetRangeErrorIsThreadSafe()) {
+		nThreads = numParticleThreads(nParticles);
+	}
+	std::vector<double> threadMapVar(nThreads, initialMapVar);
+
+	forParticleRanges(nParticles, nThreads, [&](int ithread, int begin, int end) {
+		std::unique_ptr<bool[]> usableBeams(new bool[std::max(nBeams, 1)]);
+		Matrix rotatedBeamsVF;
+		double particleMapVar = initialMapVar;
+		for(int i = begin; i < end; i++) {
+			const Matrix* particleBeamsVF = &beamsVF;
+			if(!ALLOW_ATTITUDE_SEARCH && SEARCH_PSI_BERG)
+			{
+				//each particle does its own rotation
+				double tempAttitude[3] = {attitude[0], attitude[1], attitude[2] - allParticles[i].psiBerg};
+				rotatedBeamsVF = applyRotation(tempAttitude, tempBeamsVF);
+				particleBeamsVF = &rotatedBeamsVF;
+			}
+
+			getExpectedMeasDiffParticle(allParticles[i], *particleBeamsVF, beamRanges, beamIndices, particleMapVar,
+										usableBeams.get());
+
+			for(int j = 0; j < nBeams; j++) {
+				particleStore.measDiff[(size_t)j * nParticles + i] = allParticles[i].expectedMeasDiff[j];
+			}
+		}
+		threadMapVar[ithread] = particleMapVar;
+	});
+
+	//The map variance is the last one set, which is in the last range that
+	//changed it
+	for(int ithread = nThreads - 1; ithread >= 0; ithread--) {
+		if(threadMapVar[ithread] != initialMapVar) {
+			mapVar = threadMapVar[ithread];
+			break;
+		}
+	}
+}
+
+//********************************************************************************
+
+int
+TNavParticleFilter::
+computeMeasWeights(const double* totalVar, int nBeams, double sumInvVar) {
+	const int nThreads = numParticleThreads(nParticles);
+	double* sumWeightedError = particleStore.sumWeightedError.data();
+	double* sumSquaredError = particleStore.sumSquaredError.data();
+	int* firstBadBeam = particleStore.firstBadBeam.data();
+
+	//Accumulate the error sums beam by beam; the terms for each particle are
+	//added in beam order so the sums are those of a loop over beams per
+	//particle, while the inner loops run over contiguous particles
+	forParticleRanges(nParticles, nThreads, [&](int ithread, int begin, int end) {
+		for(int i = begin; i < end; i++) {
+			sumWeightedError[i] = 0.;
+			sumSquaredError[i] = 0.;
+			firstBadBeam[i] = -1;
+		}
+		for(int beamInd = 0; beamInd < nBeams; beamInd++) {
+			if(!this->useBeam[beamInd]) {	//edit to allow using any good beams from measurement
+				continue;
+			}
+			const double invVar = 1.0 / totalVar[beamInd];
+			const double* measDiff = &particleStore.measDiff[(size_t)beamInd * nParticles];
+			bool nanError = false;
+			for(int i = begin; i < end; i++) {
+				sumWeightedError[i] += invVar * measDiff[i];                 //Weighted mean error
+				sumSquaredError[i] += invVar * (measDiff[i] * measDiff[i]);  //Weighted Squared Error
+				nanError |= ISNIN(sumSquaredError[i]);
+			}
+			if(nanError) {
+				for(int i = begin; i < end; i++) {
+					if(firstBadBeam[i] < 0 && ISNIN(sumSquaredError[i])) {
+						firstBadBeam[i] = beamInd;
+					}
+				}
+			}
+		}
+	});
+
+	//Only particles before the first with a NaN error sum are weighted
+	int badParticle = -1;
+	for(int i = 0; i < nParticles; i++) {
+		if(firstBadBeam[i] >= 0) {
+			badParticle = i;
+			currMeasWeights[i] = 1;
+			break;
+		}
+	}
+	const int nWeighted = (badParticle >= 0) ? badParticle : nParticles;
+
+	//Compute new measurement weights
+	forParticleRanges(nWeighted, numParticleThreads(nWeighted), [&](int ithread, int begin, int end) {
+		for(int i = begin; i < end; i++) {
+			if(USE_CONTOUR_MATCHING && !USE_RANGE_CORR) {
+				double currDepthBias = (1.0 / sumInvVar) * sumWeightedError[i];
+				allParticles[i].position[2] -= currDepthBias;
+				for(int beamInd = 0; beamInd < nBeams; beamInd++) {
+					if(this->useBeam[beamInd]){	//edit to allow using any good beams from measurement
+						allParticles[i].expectedMeasDiff[beamInd] -= currDepthBias;
+					}
+				}
+
+				//calculate likelihood equation.
+				currMeasWeights[i] = exp(-0.5 * (sumSquaredError[i] - currDepthBias * sumWeightedError[i]));
+			} else {
+				currMeasWeights[i] = exp(-0.5 * sumSquaredError[i]);
+			}
+		}
+	});
+
+	return badParticle;
+}
+
+//********************************************************************************
+
 // Assume that diffPose is inertially referenced.  diffPose.psi is inertial heading change.
 
 void
@@ -2040,22 +2193,38 @@ resampParticleDist() {
 
 	//Use the low-variance sampling algorithm as outlined in
 	//"Probabilistic Robotics" by Thrun, Burgard, Fox - pg. 110
+	//The cumulative weights are summed in particle order, so each draw can be
+	//found by binary search and the particles copied in parallel.
 	step = 1.0 / N;
 	r = (rand() + 1) * (1.0 / (RAND_MAX + 1.0)) * 1.0 / nParticles;
+	particleStore.cumWeight.resize(nParticles);
+	particleStore.resampIndex.resize(std::max(N, 0));
 	c = allParticles[0].weight;
+	particleStore.cumWeight[0] = c;
+	for(i = 1; i < nParticles; i++) {
+		c += allParticles[i].weight;
+		particleStore.cumWeight[i] = c;
+	}
+	i = 0;
 	for(m = 0; m < N; m++) {
 		double U = r + m * step;
 
-		while(c < U) {
-			i++;
-			c += allParticles[i].weight;
+		i = (int)(std::lower_bound(particleStore.cumWeight.begin() + i, particleStore.cumWeight.end(), U)
+			- particleStore.cumWeight.begin());
+		if(i >= nParticles) {
+			i = nParticles - 1;
 		}
-
-		//copy state of current particles to resampled particles
-		resampParticles[m + M] = allParticles[i];
-		resampParticles[m + M].weight = 1.0 / nParticles;
+		particleStore.resampIndex[m] = i;
 	}
 
+	//copy state of current particles to resampled particles
+	forParticleRanges(N, numParticleThreads(N), [&](int ithread, int begin, int end) {
+		for(int j = begin; j < end; j++) {
+			resampParticles[j + M] = allParticles[particleStore.resampIndex[j]];
+			resampParticles[j + M].weight = 1.0 / nParticles;
+		}
+	});
+
 	//if(saveDirectory != NULL)
 	//   writeParticlesToFile(resampParticles, resampParticlesFile);
 
@@ -128,6 +128,34 @@ struct particleT {
 
 };
 
+/*!particleStoreT holds the quantities used in the particle measurement
+ * update and resampling as a structure of arrays.  The expected measurement
+ * differences are gathered beam by beam, measDiff[beam*nParticles + particle],
+ * so that the weight computation runs over contiguous arrays of particles,
+ * which the compiler vectorizes, and splits cleanly between threads.*/
+struct particleStoreT {
+  int nParticles;
+  int nBeams;
+  std::vector<double> measDiff;          //expected measurement differences
+  std::vector<double> sumWeightedError;  //variance weighted error sums
+  std::vector<double> sumSquaredError;   //variance weighted squared error sums
+  std::vector<int> firstBadBeam;         //beam at which the sum went NaN or -1
+  std::vector<double> cumWeight;         //cumulative particle weights
+  std::vector<int> resampIndex;          //particle drawn by each resample
+
+  particleStoreT() : nParticles(0), nBeams(0) {}
+
+  void resize(int numParticles, int numBeams)
+    {
+      nParticles = numParticles;
+      nBeams = numBeams;
+      measDiff.resize((size_t)numParticles * numBeams);
+      sumWeightedError.resize(numParticles);
+      sumSquaredError.resize(numParticles);
+      firstBadBeam.resize(numParticles);
+    }
+};
+
 /*!
  * Class: TNavParticleFilter
  * 
@@ -220,6 +248,13 @@ class TNavParticleFilter : public TNavFilter
 	bool getExpectedMeasDiffParticle(particleT& particle, const Matrix& beamsSF, 
 								double* beamRanges, const int* beamIndices, double& mapVar);
 
+	/*! As above, but sets usableBeams rather than tempUseBeam so that several
+	 * particles may be processed at once by different threads.
+	 */
+	bool getExpectedMeasDiffParticle(particleT& particle, const Matrix& beamsSF,
+								double* beamRanges, const int* beamIndices, double& mapVar,
+								bool* usableBeams);
+
 
   /* Function: motionUpdate
    * Usage: motionUpdate(currNavPose);
@@ -342,6 +377,31 @@ class TNavParticleFilter : public TNavFilter
   void motionUpdateParticle(particleT& particle, const poseT& diffPose,
 			    double* velocity_sf_sigma, const double& gyroStddev);   
 
+  /* Function: computeExpectedMeasDiffs
+   * Usage: computeExpectedMeasDiffs(beamsVF, tempBeamsVF, attitude, ranges,
+   * beamIndices, mapVar);
+   * -------------------------------------------------------------------------*/
+  /*! Calls getExpectedMeasDiffParticle for every particle, in parallel when
+   * the terrain map allows it, and gathers the differences into
+   * particleStore.  mapVar is left as the sequential loop would leave it.
+   */
+  void computeExpectedMeasDiffs(const Matrix& beamsVF, const Matrix& tempBeamsVF,
+				const double* attitude, double* beamRanges,
+				const int* beamIndices, double& mapVar);
+
+
+  /* Function: computeMeasWeights
+   * Usage: badParticle = computeMeasWeights(totalVar, nBeams, sumInvVar);
+   * -------------------------------------------------------------------------*/
+  /*! Computes currMeasWeights for all particles from the expected measurement
+   * differences in particleStore and the beam variances totalVar, using the
+   * beams flagged in useBeam.  Returns the index of the first particle whose
+   * squared error sum is NaN, in which case only the particles before it are
+   * weighted, or -1.
+   */
+  int computeMeasWeights(const double* totalVar, int nBeams, double sumInvVar);
+
+
   /* Function: resampParticleDist
    * Usage: resampParticleDist();
    * -------------------------------------------------------------------------*/
@@ -504,6 +564,9 @@ class TNavParticleFilter : public TNavFilter
   //!int keeping track of how many particles the filter is using
   int nParticles;
 
+  //!structure of arrays used in the measurement update and resampling
+  particleStoreT particleStore;
+
   //!int showing whether map has been plotted for matlab debugging
   int mapPlotted;
 
@@ -32,6 +32,8 @@ class TerrainMap{
 		virtual ~TerrainMap(void){}
 		
 		virtual double GetRangeError(double& mapVariance, const double* const startPoint, const double* const directionVector, double expectedDistance) = 0;
+		//true if GetRangeError may be called from several threads at once
+		virtual bool GetRangeErrorIsThreadSafe(void){ return false; }
 		//virtual double QueryMap(double const * const queryPoint) = 0;
 		
 		virtual int loadSubMap(const double xcen, const double ycen, double* mapWidth,
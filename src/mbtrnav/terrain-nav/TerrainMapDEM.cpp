@@ -64,6 +64,15 @@ GetRangeError(double& mapVariance, const double* const startPoint, const double*
 	}
     return rangeError;
 }
+
+bool
+TerrainMapDEM::
+GetRangeErrorIsThreadSafe(void) {
+	//Lookups in the low resolution map read its netCDF file and spline
+	//interpolation uses the Matlab engine, neither of which is reentrant.
+	//Otherwise only the extracted sub-map is read.
+	return (this->refMap->lowResSrc == NULL) && (this->interpMapMethod != 3);
+}
 /*
 double
 TerrainMapDEM::
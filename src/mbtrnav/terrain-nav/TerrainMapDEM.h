@@ -51,6 +51,7 @@ Documentation form TNavFilter and ParticleFilter is grouped together at the bott
 class TerrainMapDEM : public TerrainMap{
 	public:
 		double GetRangeError(double& mapVariance, const double* const startPoint, const double* const directionVector, double expectedDistance);
+		bool GetRangeErrorIsThreadSafe(void);
 		//double QueryMap(double const * const queryPoint);
 		
 		int loadSubMap(const double xcen, const double ycen, double* mapWidth,
@@ -71,4 +71,16 @@
 #ifndef DHDT_RESAMP_STDDEV    //Std dev of Gaussian noise added to resampled
 #define DHDT_RESAMP_STDDEV 0  //particle terrain Heading rate coordinate
 #endif
+
+/******************************************************************************
+ FILTER THREADING PARAMETERS
+******************************************************************************/
+
+#ifndef MAX_PF_THREADS        //Maximum number of threads used to update and
+#define MAX_PF_THREADS 8      //resample the particles (1 disables threading)
+#endif
+
+#ifndef MIN_PF_THREAD_PARTICLES  //Minimum number of particles given to each
+#define MIN_PF_THREAD_PARTICLES 500 //thread, below which threads cost more
+#endif                           //than they save
 #endif
@@ -2466,8 +2466,8 @@ int mbvt_process_multibeam() {
 					/* call raytracing without keeping
 					plotting list */
 					status =
-					    mb_rt(verbose, rt_svp, sensordepth, ping[k].angles[i], 0.5 * ping[k].ttimes[i], anglemode, ping[k].ssv,
-					          ping[k].angles_null[i], 0, NULL, NULL, NULL, NULL, &acrosstrack[i], &depth[i], &ttime, &ray_stat, &error);
+					    mb_rt_table(verbose, rt_svp, sensordepth, ping[k].angles[i], 0.5 * ping[k].ttimes[i], anglemode, ping[k].ssv,
+					                ping[k].angles_null[i], &acrosstrack[i], &depth[i], &ttime, &ray_stat, &error);
 				}
 				else {
 					/* call raytracing keeping
@@ -1651,6 +1651,7 @@ int main(int argc, char **argv) {
   char commentfile[MB_PATH_MAXLINE] = "";
   bool insertcomments = false;
   bool bathonly = false;
+  bool controls_set = false;
   int iformat = 0;
   int oformat = 0;
   int mformat = 0;
@@ -1671,6 +1672,7 @@ int main(int argc, char **argv) {
       case 'B':
       case 'b':
       {
+        controls_set = true;
         double seconds;
         sscanf(optarg, "%d/%d/%d/%d/%d/%lf", &btime_i[0], &btime_i[1], &btime_i[2], &btime_i[3], &btime_i[4], &seconds);
         btime_i[5] = (int)floor(seconds);
@@ -1679,6 +1681,7 @@ int main(int argc, char **argv) {
       }
       case 'C':
       case 'c':
+        controls_set = true;
         sscanf(optarg, "%1023s", commentfile);
         insertcomments = true;
         break;
@@ -1689,6 +1692,7 @@ int main(int argc, char **argv) {
       case 'E':
       case 'e':
       {
+        controls_set = true;
         double seconds;
         sscanf(optarg, "%d/%d/%d/%d/%d/%lf", &etime_i[0], &etime_i[1], &etime_i[2], &etime_i[3], &etime_i[4], &seconds);
         etime_i[5] = (int)floor(seconds);
@@ -1713,11 +1717,13 @@ int main(int argc, char **argv) {
         break;
       case 'L':
       case 'l':
+        controls_set = true;
         sscanf(optarg, "%d", &lonflip);
         break;
       case 'M':
       case 'm':
       {
+        controls_set = true;
         const int i = sscanf(optarg, "%1023s", mfile);
         if (i == 1)
           merge = true;
@@ -1725,6 +1731,7 @@ int main(int argc, char **argv) {
       }
       case 'N':
       case 'n':
+        controls_set = true;
         if (stripmode == MBCOPY_STRIPMODE_NONE) {
           stripmode = MBCOPY_STRIPMODE_COMMENTS;
         } else if (stripmode == MBCOPY_STRIPMODE_COMMENTS) {
@@ -1740,23 +1747,28 @@ int main(int argc, char **argv) {
         break;
       case 'P':
       case 'p':
+        controls_set = true;
         sscanf(optarg, "%d", &pings);
         break;
       case 'Q':
       case 'q':
+        controls_set = true;
         sscanf(optarg, "%lf", &sleep_factor);
         use_sleep = true;
         break;
       case 'R':
       case 'r':
+        controls_set = true;
         mb_get_bounds(optarg, bounds);
         break;
       case 'S':
       case 's':
+        controls_set = true;
         sscanf(optarg, "%lf", &speedmin);
         break;
       case 'T':
       case 't':
+        controls_set = true;
         sscanf(optarg, "%lf", &timegap);
         break;
       case 'V':
@@ -1969,6 +1981,20 @@ int main(int argc, char **argv) {
     exit(error);
   }
 
+  /* a bathymetry only copy to mbldeoih with the default controls is the fbt
+      file that mb_make_info() makes, so use the same libmbio function */
+  if (bathonly && oformat == MBF_MBLDEOIH && !controls_set) {
+    if (mb_make_info_fbt(verbose, ifile, iformat, ofile, &error) != MB_SUCCESS) {
+      char *message;
+      mb_error(verbose, error, &message);
+      fprintf(stderr, "\nMBIO Error returned from function <mb_make_info_fbt>:\n%s\n", message);
+      fprintf(stderr, "\nMultibeam File <%s> not copied to <%s>\n", ifile, ofile);
+      fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+      exit(error);
+    }
+    exit(MB_ERROR_NO_ERROR);
+  }
+
   /* initialize reading the input swath sonar file */
   if (mb_read_init(verbose, ifile, iformat, pings, lonflip, bounds, btime_i, etime_i, speedmin, timegap, &imbio_ptr,
                              &btime_d, &etime_d, &ibeams_bath, &ibeams_amp, &ipixels_ss, &error) != MB_SUCCESS) {
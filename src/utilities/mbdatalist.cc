@@ -31,12 +31,19 @@
  */
 
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <getopt.h>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
 #include <unistd.h>
+#include <vector>
 
 #include "mb_define.h"
 #include "mb_format.h"
@@ -48,7 +55,85 @@ constexpr char help_message[] =
     "mbdatalist parses recursive datalist files and outputs the\n"
     "complete list of data files and formats. The results are dumped to stdout.";
 constexpr char usage_message[] =
-    "mbdatalist [-C -D -Fformat -Ifile -N -O -P -Q -Rw/e/s/n -S -U -Y -Z -V -H]";
+    "mbdatalist [-C -D -Fformat -Ifile -N -O -P -Q -Rw/e/s/n -S -U -Y -Z -V -H --threads=nthreads]";
+
+/*--------------------------------------------------------------------*/
+/*
+ * When ancillary files are made (-N or -O) the files of the datalist are
+ * first listed and then handed to a pool of threads that pull them from a
+ * shared queue, largest file first, so that the reading of several files
+ * overlaps. The ancillary files are made within libmbio by mb_make_info(),
+ * without running other programs. The number of threads bounds the number
+ * of files being read at once.
+ */
+
+/* file needing ancillary files */
+struct mbdatalist_job_struct {
+  std::string file;
+  int format;
+  off_t size;
+};
+
+/* ancillary file queue and worker pool */
+struct mbdatalist_pool_struct {
+  int verbose;
+  bool force_update;
+  std::vector<mbdatalist_job_struct> jobs;
+  std::atomic<size_t> next_job;
+  std::mutex mutex; /* protects the status and error */
+  int status;
+  int error;
+};
+
+/*--------------------------------------------------------------------*/
+/*
+ * Worker thread - makes the ancillary files of queued files until the
+ * queue is empty
+ */
+void mbdatalist_worker(struct mbdatalist_pool_struct *pool) {
+  mb_path file;
+  while (true) {
+    const size_t ijob = pool->next_job++;
+    if (ijob >= pool->jobs.size())
+      break;
+    const struct mbdatalist_job_struct *job = &pool->jobs[ijob];
+
+    strcpy(file, job->file.c_str());
+    int error = MB_ERROR_NO_ERROR;
+    const int status = mb_make_info(pool->verbose, pool->force_update, file, job->format, &error);
+    if (status != MB_SUCCESS) {
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      pool->status = status;
+      pool->error = error;
+    }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Makes the ancillary files of all queued files using n_threads threads
+ */
+void mbdatalist_run(struct mbdatalist_pool_struct *pool, unsigned int n_threads) {
+  /* start the largest files first so that they do not finish last */
+  if (n_threads > 1)
+    std::stable_sort(pool->jobs.begin(), pool->jobs.end(),
+                     [](const mbdatalist_job_struct &a, const mbdatalist_job_struct &b) { return a.size > b.size; });
+
+  pool->next_job = 0;
+  pool->status = MB_SUCCESS;
+  pool->error = MB_ERROR_NO_ERROR;
+  n_threads = MIN(n_threads, (unsigned int)pool->jobs.size());
+  if (n_threads > 1) {
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < n_threads; i++)
+      threads.emplace_back(mbdatalist_worker, pool);
+    for (unsigned int i = 0; i < n_threads; i++)
+      threads[i].join();
+  }
+  else {
+    mbdatalist_worker(pool);
+  }
+}
 
 /*--------------------------------------------------------------------*/
 
@@ -77,6 +162,7 @@ int main(int argc, char **argv) {
 	bool remove_locks = false;
 	bool make_datalistp = false;
 	bool reportdatalists = false;
+	unsigned int n_threads = 1;
 	FILE *output = nullptr;
 
 	{
@@ -98,6 +184,7 @@ int main(int argc, char **argv) {
 	                {"raw", no_argument, nullptr, 0},
 	                {"unlock", no_argument, nullptr, 0},
 	                {"datalistp", no_argument, nullptr, 0},
+	                {"threads", required_argument, nullptr, 0},
 	                {nullptr, 0, nullptr, 0}};
 
 		bool errflg = false;
@@ -155,6 +242,9 @@ int main(int argc, char **argv) {
 				else if (strcmp("datalistp", options[option_index].name) == 0) {
 					make_datalistp = true;
 				}
+				else if (strcmp("threads", options[option_index].name) == 0) {
+					sscanf(optarg, "%u", &n_threads);
+				}
 
 				break;
 
@@ -259,6 +349,7 @@ int main(int argc, char **argv) {
 			fprintf(output, "dbg2       problem_report:      %d\n", problem_report);
 			fprintf(output, "dbg2       make_datalistp:      %d\n", make_datalistp);
 			fprintf(output, "dbg2       remove_locks:        %d\n", remove_locks);
+			fprintf(output, "dbg2       n_threads:           %u\n", n_threads);
 			fprintf(output, "dbg2       pings:               %d\n", pings);
 			fprintf(output, "dbg2       lonflip:             %d\n", lonflip);
 			fprintf(output, "dbg2       bounds[0]:           %f\n", bounds[0]);
@@ -428,6 +519,15 @@ int main(int argc, char **argv) {
 
 	/* else parse datalist */
 	else {
+		/* get number of threads to use for making ancillary files */
+		const unsigned int n_concurrency = std::thread::hardware_concurrency();
+		if (n_concurrency > 0)
+			n_threads = MIN(n_threads, n_concurrency);
+		n_threads = MAX(1, MIN(n_threads, MB_THREAD_MAX));
+		struct mbdatalist_pool_struct pool;
+		pool.verbose = verbose;
+		pool.force_update = force_update;
+
 		if (mb_datalist_open(verbose, &datalist, read_file, look_processed, &error) != MB_SUCCESS) {
 			fprintf(stderr, "\nUnable to open data list file: %s\n", read_file);
 			fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
@@ -443,9 +543,14 @@ int main(int argc, char **argv) {
 			mb_get_relative_path(verbose, file, pwd, &error);
 			mb_get_relative_path(verbose, dfile, pwd, &error);
 
-			/* generate inf fnv fbt files */
+			/* queue the file for generating inf fnv fbt files */
 			if (make_inf) {
-				status = mb_make_info(verbose, force_update, file, format, &error);
+				struct mbdatalist_job_struct job;
+				job.file = file;
+				job.format = format;
+				struct stat file_status;
+				job.size = stat(file, &file_status) == 0 ? file_status.st_size : 0;
+				pool.jobs.push_back(job);
 			}
 
 			/* or generate problem reports */
@@ -563,6 +668,13 @@ int main(int argc, char **argv) {
 			}
 		}
 		mb_datalist_close(verbose, &datalist, &error);
+
+		/* generate inf fnv fbt files for the queued files */
+		if (make_inf) {
+			mbdatalist_run(&pool, n_threads);
+			status = pool.status;
+			error = pool.error;
+		}
 	}
 
 	/* set program status */
@@ -46,14 +46,21 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <deque>
 #include <getopt.h>
 #include <limits>
+#include <mutex>
+#include <queue>
+#include <thread>
 #include <unistd.h>
+#include <vector>
 
 #include "mb_aux.h"
 #include "mb_define.h"
@@ -150,7 +157,8 @@ constexpr char usage_message[] =
     "mbgrid   -Ifilelist -Oroot [-Adatatype -Bborder -Cclip[/mode] -Dxdim/ydim\n"
     "          -Edx/dy/units[!]  -Fmode[/threshold] -Ggridkind -Jprojection\n"
     "          -Kbackground -Llonflip -M -N -Ppings -Q  -Rwest/east/south/north\n"
-    "          -Rfactor  -Sspeed  -Ttension  -Utime  -V -Wscale -Xextend]";
+    "          -Rfactor  -Sspeed  -Ttension  -Utime  -V -Wscale -Xextend\n"
+    "          --threads=nthreads --median-memory=megabytes --readahead=nrecords]";
 
 /*--------------------------------------------------------------------*/
 /* approximate error function altered from numerical recipes */
@@ -429,6 +437,1250 @@ int mbgrid_weight(int verbose, double foot_a, double foot_b, double pcx, double
   return (status);
 }
 
+/*--------------------------------------------------------------------*/
+/*
+ * Multithreaded gridding engine used for the weighted mean, minimum,
+ * maximum and weighted footprint algorithms when --threads is set.
+ *
+ * Reader threads decode the swath (or xyz triples) files concurrently and
+ * hand the soundings that fall within the grid to the main thread in
+ * chunks, file by file in datalist order. Readers working ahead of the
+ * file currently being gridded block once MBGRID_THREAD_BUFFER_MAX
+ * soundings are buffered, so memory use does not grow with the survey.
+ * The main thread applies the -U time check to each chunk and then the
+ * worker threads accumulate it into the grid, each worker owning an
+ * interleaved set of MBGRID_THREAD_STRIP wide column strips. Since every
+ * bin receives its contributions in the same order and with the same
+ * arithmetic as in the single threaded loops, the grids are identical.
+ */
+
+/* number of soundings passed from a reader at a time */
+constexpr size_t MBGRID_THREAD_CHUNK = 65536;
+
+/* maximum number of soundings buffered ahead of the gridding */
+constexpr size_t MBGRID_THREAD_BUFFER_MAX = 2097152;
+
+/* width in grid columns of the strips owned by each worker */
+constexpr int MBGRID_THREAD_STRIP = 16;
+
+struct mbgrid_sounding_struct {
+  double x;             /* position in grid coordinates */
+  double y;
+  double value;         /* unscaled value, see mbgrid_file_struct.vfactor */
+  double time_d;
+  double foot_dxn;      /* footprint orientation and size */
+  double foot_dyn;
+  double foot_hwidth;
+  double foot_hlength;
+  int ix;               /* grid bin */
+  int iy;
+  int foot_dix;         /* footprint bin range, < 0 for point data */
+  int foot_diy;
+  bool time_ok;         /* set by the time check */
+  bool reset;
+};
+
+struct mbgrid_file_struct {
+  int format;
+  int pstatus;
+  int astatus;
+  double file_weight;
+  mb_path path;
+  mb_path ppath;
+  mb_path apath;
+  mb_path rfile;
+  double vfactor;       /* topofactor for depths, 1.0 for amplitude and sidescan */
+  bool file_in_bounds;
+  int error;            /* nonzero if the file could not be read */
+  const char *error_source;
+  bool done;
+  std::deque<std::vector<mbgrid_sounding_struct>> chunks;
+};
+
+struct mbgrid_engine_struct {
+  /* control parameters */
+  int verbose;
+  grid_alg_t grid_mode;
+  grid_data_t datatype;
+  int pings;
+  int lonflip;
+  double bounds[4];
+  int btime_i[7];
+  int etime_i[7];
+  double speedmin;
+  double timegap;
+  int readahead;
+  bool use_projection;
+  char *projection_id;
+  bool check_time;
+  bool first_in_stays;
+  double timediff;
+
+  /* grid parameters */
+  double wbnd[4];
+  double dx;
+  double dy;
+  int gxdim;
+  int gydim;
+  int xtradim;
+  double factor;
+  double topofactor;
+  double scale;
+  double mtodeglon;
+  double mtodeglat;
+  double *grid;
+  double *norm;
+  double *sigma;
+  double *firsttime;
+  int *num;
+  int *cnt;
+
+  /* files and reader state */
+  std::vector<mbgrid_file_struct> files;
+  std::mutex read_mutex;
+  std::condition_variable read_cond;
+  size_t next_file;
+  size_t head;
+  size_t nbuffered;
+  std::atomic<bool> abort;
+
+  /* worker state */
+  int n_workers;
+  std::vector<int> column_owner;
+  const std::vector<mbgrid_sounding_struct> *chunk;
+  const mbgrid_file_struct *chunk_file;
+  unsigned long generation;
+  int nfinished;
+  bool quit;
+  int removed[MB_THREAD_MAX];
+  std::mutex work_mutex;
+  std::condition_variable work_cond;
+  std::condition_variable done_cond;
+};
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_thread_push passes a chunk of soundings from a reader to
+ * the gridding, blocking while too much is buffered unless the file is
+ * the one currently being gridded
+ */
+void mbgrid_thread_push(mbgrid_engine_struct *engine, size_t ifile, std::vector<mbgrid_sounding_struct> *soundings,
+                        bool done) {
+  std::unique_lock<std::mutex> lock(engine->read_mutex);
+  engine->read_cond.wait(lock, [&] {
+    return engine->abort || engine->head == ifile || engine->nbuffered < MBGRID_THREAD_BUFFER_MAX;
+  });
+  mbgrid_file_struct *gfile = &engine->files[ifile];
+  if (!soundings->empty()) {
+    engine->nbuffered += soundings->size();
+    gfile->chunks.push_back(std::move(*soundings));
+    soundings->clear();
+    soundings->reserve(MBGRID_THREAD_CHUNK);
+  }
+  if (done)
+    gfile->done = true;
+  engine->read_cond.notify_all();
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_thread_read_swath decodes one swath file, keeping the
+ * soundings that fall within the grid
+ */
+void mbgrid_thread_read_swath(mbgrid_engine_struct *engine, size_t ifile, void *pjptr) {
+  const int verbose = engine->verbose;
+  mbgrid_file_struct *gfile = &engine->files[ifile];
+  const bool footprint = engine->grid_mode == MBGRID_WEIGHTED_FOOTPRINT;
+  const double dx = engine->dx;
+  const double dy = engine->dy;
+  const int gxdim = engine->gxdim;
+  const int gydim = engine->gydim;
+  int error = MB_ERROR_NO_ERROR;
+
+  /* apply pstatus */
+  if (gfile->pstatus == MB_PROCESSED_USE)
+    strcpy(gfile->rfile, gfile->ppath);
+  else
+    strcpy(gfile->rfile, gfile->path);
+  gfile->vfactor = (engine->datatype == MBGRID_DATA_BATHYMETRY || engine->datatype == MBGRID_DATA_TOPOGRAPHY)
+                    ? engine->topofactor : 1.0;
+
+  /* check for mbinfo file - get file bounds if possible */
+  int rformat = gfile->format;
+  if (mb_check_info(verbose, gfile->rfile, engine->lonflip, engine->bounds, &gfile->file_in_bounds, &error)
+      == MB_FAILURE) {
+    gfile->file_in_bounds = true;
+    error = MB_ERROR_NO_ERROR;
+  }
+  std::vector<mbgrid_sounding_struct> soundings;
+  soundings.reserve(MBGRID_THREAD_CHUNK);
+  if (!gfile->file_in_bounds) {
+    mbgrid_thread_push(engine, ifile, &soundings, true);
+    return;
+  }
+
+  /* check for "fast bathymetry" or "fbt" file */
+  if (engine->datatype == MBGRID_DATA_TOPOGRAPHY || engine->datatype == MBGRID_DATA_BATHYMETRY)
+    mb_get_fbt(verbose, gfile->rfile, &rformat, &error);
+
+  /* initialize the swath sonar file */
+  void *mbio_ptr = nullptr;
+  double btime_d;
+  double etime_d;
+  int beams_bath;
+  int beams_amp;
+  int pixels_ss;
+  if (mb_read_init_altnav(verbose, gfile->rfile, rformat, engine->pings, engine->lonflip, engine->bounds,
+                          engine->btime_i, engine->etime_i, engine->speedmin, engine->timegap, gfile->astatus,
+                          gfile->apath, &mbio_ptr, &btime_d, &etime_d, &beams_bath, &beams_amp, &pixels_ss,
+                          &error) != MB_SUCCESS) {
+    gfile->error = error;
+    gfile->error_source = "mb_read_init_altnav";
+    mbgrid_thread_push(engine, ifile, &soundings, true);
+    return;
+  }
+  struct mb_io_struct *mb_io_ptr = (struct mb_io_struct *)mbio_ptr;
+
+  /* get topography type */
+  int topo_type = MB_TOPOGRAPHY_TYPE_UNKNOWN;
+  if (footprint)
+    mb_sonartype(verbose, mbio_ptr, mb_io_ptr->store_data, &topo_type, &error);
+
+  /* allocate memory for reading data arrays */
+  char *beamflag = nullptr;
+  double *bath = nullptr;
+  double *amp = nullptr;
+  double *bathlon = nullptr;
+  double *bathlat = nullptr;
+  double *ss = nullptr;
+  double *sslon = nullptr;
+  double *sslat = nullptr;
+  if (error == MB_ERROR_NO_ERROR)
+    mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char), (void **)&beamflag, &error);
+  if (error == MB_ERROR_NO_ERROR)
+    mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bath, &error);
+  if (error == MB_ERROR_NO_ERROR)
+    mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double), (void **)&amp, &error);
+  if (error == MB_ERROR_NO_ERROR)
+    mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathlon, &error);
+  if (error == MB_ERROR_NO_ERROR)
+    mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathlat, &error);
+  if (error == MB_ERROR_NO_ERROR)
+    mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ss, &error);
+  if (error == MB_ERROR_NO_ERROR)
+    mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&sslon, &error);
+  if (error == MB_ERROR_NO_ERROR)
+    mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&sslat, &error);
+  if (error != MB_ERROR_NO_ERROR) {
+    gfile->error = error;
+    gfile->error_source = "mb_register_array";
+    mb_close(verbose, &mbio_ptr, &error);
+    mbgrid_thread_push(engine, ifile, &soundings, true);
+    return;
+  }
+
+  /* decode records in a background thread if requested, falling back
+      to reading in this thread for formats that do not support it */
+  if (engine->readahead > 0) {
+    int readahead_error = MB_ERROR_NO_ERROR;
+    mb_readahead_init(verbose, mbio_ptr, engine->readahead, &readahead_error);
+  }
+
+  /* loop over reading */
+  int kind;
+  int rpings;
+  int time_i[7];
+  double time_d;
+  double navlon;
+  double navlat;
+  double speed;
+  double heading;
+  double distance;
+  double altitude;
+  double sensordepth;
+  char comment[MB_COMMENT_MAXLINE];
+  while (error <= MB_ERROR_NO_ERROR && !engine->abort) {
+    mb_read(verbose, mbio_ptr, &kind, &rpings, time_i, &time_d, &navlon, &navlat, &speed, &heading,
+            &distance, &altitude, &sensordepth, &beams_bath, &beams_amp, &pixels_ss, beamflag, bath,
+            amp, bathlon, bathlat, ss, sslon, sslat, comment, &error);
+
+    /* time gaps are not a problem here */
+    if (error == MB_ERROR_TIME_GAP)
+      error = MB_ERROR_NO_ERROR;
+    if (error != MB_ERROR_NO_ERROR)
+      continue;
+
+    /* the beam widths are kept in the mbio descriptor, which is shared
+        with the read ahead thread */
+    double beamwidth_xtrack = 0.0;
+    double beamwidth_ltrack = 0.0;
+    if (footprint) {
+      int beamwidth_error = MB_ERROR_NO_ERROR;
+      mb_beamwidths(verbose, mbio_ptr, &beamwidth_xtrack, &beamwidth_ltrack, &beamwidth_error);
+    }
+
+    /* set the positions and values of the data to be gridded */
+    int ndata = 0;
+    char *flags = beamflag;
+    double *xdata = bathlon;
+    double *ydata = bathlat;
+    double *vdata = bath;
+    if (engine->datatype == MBGRID_DATA_BATHYMETRY || engine->datatype == MBGRID_DATA_TOPOGRAPHY) {
+      ndata = beams_bath;
+
+      /* if needed try again to get topography type */
+      if (footprint && topo_type == MB_TOPOGRAPHY_TYPE_UNKNOWN) {
+        mb_sonartype(verbose, mbio_ptr, mb_io_ptr->store_data, &topo_type, &error);
+        if (topo_type == MB_TOPOGRAPHY_TYPE_UNKNOWN
+            && beamwidth_xtrack > 0.0 && beamwidth_ltrack > 0.0) {
+          topo_type = MB_TOPOGRAPHY_TYPE_MULTIBEAM;
+        }
+      }
+      if (footprint && engine->use_projection)
+        mb_proj_forward(verbose, pjptr, navlon, navlat, &navlon, &navlat, &error);
+    }
+    else if (engine->datatype == MBGRID_DATA_AMPLITUDE) {
+      ndata = beams_amp;
+      vdata = amp;
+    }
+    else if (engine->datatype == MBGRID_DATA_SIDESCAN) {
+      ndata = pixels_ss;
+      flags = nullptr;
+      xdata = sslon;
+      ydata = sslat;
+      vdata = ss;
+    }
+
+    for (int ib = 0; ib < ndata; ib++) {
+      if (flags != nullptr ? !mb_beam_ok(flags[ib]) : !(vdata[ib] > MB_SIDESCAN_NULL))
+        continue;
+
+      /* reproject position if necessary */
+      if (engine->use_projection)
+        mb_proj_forward(verbose, pjptr, xdata[ib], ydata[ib], &xdata[ib], &ydata[ib], &error);
+
+      /* get position in grid */
+      const int ix = (xdata[ib] - engine->wbnd[0] + 0.5 * dx) / dx;
+      const int iy = (ydata[ib] - engine->wbnd[2] + 0.5 * dy) / dy;
+      if (ix < 0 || ix >= gxdim || iy < 0 || iy >= gydim)
+        continue;
+
+      mbgrid_sounding_struct sounding;
+      sounding.x = xdata[ib];
+      sounding.y = ydata[ib];
+      sounding.value = vdata[ib];
+      sounding.time_d = time_d;
+      sounding.ix = ix;
+      sounding.iy = iy;
+      sounding.foot_dix = -1;
+      sounding.foot_diy = -1;
+      sounding.time_ok = true;
+      sounding.reset = false;
+
+      /* calculate the footprint of multibeam soundings */
+      if (footprint && topo_type == MB_TOPOGRAPHY_TYPE_MULTIBEAM) {
+        double foot_dx;
+        double foot_dy;
+        if (engine->use_projection) {
+          foot_dx = (bathlon[ib] - navlon);
+          foot_dy = (bathlat[ib] - navlat);
+        }
+        else {
+          foot_dx = (bathlon[ib] - navlon) / engine->mtodeglon;
+          foot_dy = (bathlat[ib] - navlat) / engine->mtodeglat;
+        }
+        const double foot_lateral = sqrt(foot_dx * foot_dx + foot_dy * foot_dy);
+        if (foot_lateral > 0.0) {
+          sounding.foot_dxn = foot_dx / foot_lateral;
+          sounding.foot_dyn = foot_dy / foot_lateral;
+        }
+        else {
+          sounding.foot_dxn = 1.0;
+          sounding.foot_dyn = 0.0;
+        }
+        const double foot_range = sqrt(foot_lateral * foot_lateral + altitude * altitude);
+        if (foot_range > 0.0) {
+          const double foot_theta = RTD * atan2(foot_lateral, (bath[ib] - sensordepth));
+          double foot_dtheta = 0.5 * engine->scale * beamwidth_xtrack;
+          double foot_dphi = 0.5 * engine->scale * beamwidth_ltrack;
+          if (foot_dtheta <= 0.0)
+            foot_dtheta = 1.0;
+          if (foot_dphi <= 0.0)
+            foot_dphi = 1.0;
+          sounding.foot_hwidth = (bath[ib] - sensordepth) * tan(DTR * (foot_theta + foot_dtheta)) - foot_lateral;
+          sounding.foot_hlength = foot_range * tan(DTR * foot_dphi);
+
+          /* get range of bins around footprint to examine */
+          int foot_wix;
+          int foot_wiy;
+          int foot_lix;
+          int foot_liy;
+          if (engine->use_projection) {
+            foot_wix = fabs(sounding.foot_hwidth * cos(DTR * foot_theta) / dx);
+            foot_wiy = fabs(sounding.foot_hwidth * sin(DTR * foot_theta) / dx);
+            foot_lix = fabs(sounding.foot_hlength * sin(DTR * foot_theta) / dy);
+            foot_liy = fabs(sounding.foot_hlength * cos(DTR * foot_theta) / dy);
+          }
+          else {
+            foot_wix = fabs(sounding.foot_hwidth * cos(DTR * foot_theta) * engine->mtodeglon / dx);
+            foot_wiy = fabs(sounding.foot_hwidth * sin(DTR * foot_theta) * engine->mtodeglon / dx);
+            foot_lix = fabs(sounding.foot_hlength * sin(DTR * foot_theta) * engine->mtodeglat / dy);
+            foot_liy = fabs(sounding.foot_hlength * cos(DTR * foot_theta) * engine->mtodeglat / dy);
+          }
+          sounding.foot_dix = 2 * std::max(foot_wix, foot_lix);
+          sounding.foot_diy = 2 * std::max(foot_wiy, foot_liy);
+        }
+      }
+
+      soundings.push_back(sounding);
+      if (soundings.size() >= MBGRID_THREAD_CHUNK)
+        mbgrid_thread_push(engine, ifile, &soundings, false);
+    }
+  }
+  mb_close(verbose, &mbio_ptr, &error);
+
+  mbgrid_thread_push(engine, ifile, &soundings, true);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_thread_read_triples reads one lon,lat,value triples file,
+ * keeping the values that contribute to the grid
+ */
+void mbgrid_thread_read_triples(mbgrid_engine_struct *engine, size_t ifile, void *pjptr) {
+  const int verbose = engine->verbose;
+  mbgrid_file_struct *gfile = &engine->files[ifile];
+  const int xtradim = engine->grid_mode == MBGRID_WEIGHTED_MEAN ? engine->xtradim : 0;
+  int error = MB_ERROR_NO_ERROR;
+
+  strcpy(gfile->rfile, gfile->path);
+  gfile->vfactor = engine->topofactor;
+  gfile->file_in_bounds = true;
+  std::vector<mbgrid_sounding_struct> soundings;
+  soundings.reserve(MBGRID_THREAD_CHUNK);
+
+  FILE *rfp = fopen(gfile->path, "r");
+  if (rfp == nullptr) {
+    gfile->error = MB_ERROR_OPEN_FAIL;
+    gfile->error_source = "fopen";
+    mbgrid_thread_push(engine, ifile, &soundings, true);
+    return;
+  }
+
+  double tlon;
+  double tlat;
+  double tvalue;
+  while (fscanf(rfp, "%lf %lf %lf", &tlon, &tlat, &tvalue) != EOF && !engine->abort) {
+    /* reproject data positions if necessary */
+    if (engine->use_projection)
+      mb_proj_forward(verbose, pjptr, tlon, tlat, &tlon, &tlat, &error);
+
+    /* get position in grid */
+    const int ix = (tlon - engine->wbnd[0] + 0.5 * engine->dx) / engine->dx;
+    const int iy = (tlat - engine->wbnd[2] + 0.5 * engine->dy) / engine->dy;
+    if (ix < -xtradim || ix >= engine->gxdim + xtradim || iy < -xtradim || iy >= engine->gydim + xtradim)
+      continue;
+
+    mbgrid_sounding_struct sounding;
+    sounding.x = tlon;
+    sounding.y = tlat;
+    sounding.value = tvalue;
+    sounding.time_d = 0.0;
+    sounding.ix = ix;
+    sounding.iy = iy;
+    sounding.foot_dix = -1;
+    sounding.foot_diy = -1;
+    sounding.time_ok = true;
+    sounding.reset = false;
+    soundings.push_back(sounding);
+    if (soundings.size() >= MBGRID_THREAD_CHUNK)
+      mbgrid_thread_push(engine, ifile, &soundings, false);
+  }
+  fclose(rfp);
+
+  mbgrid_thread_push(engine, ifile, &soundings, true);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_thread_reader claims files in datalist order and
+ * decodes them until none remain
+ */
+void mbgrid_thread_reader(mbgrid_engine_struct *engine) {
+  const int verbose = engine->verbose;
+  int error = MB_ERROR_NO_ERROR;
+
+  /* projections are not shared between threads */
+  void *pjptr = nullptr;
+  if (engine->use_projection)
+    mb_proj_init(verbose, engine->projection_id, &pjptr, &error);
+
+  while (true) {
+    size_t ifile;
+    {
+      std::unique_lock<std::mutex> lock(engine->read_mutex);
+      if (engine->abort || engine->next_file >= engine->files.size())
+        break;
+      ifile = engine->next_file++;
+
+      /* the GSF library is not reentrant, so GSF files are only
+          decoded once they are the file being gridded */
+      if (engine->files[ifile].format == MBF_GSFGENMB)
+        engine->read_cond.wait(lock, [&] { return engine->abort || engine->head == ifile; });
+      if (engine->abort)
+        break;
+    }
+    if (engine->files[ifile].format > 0)
+      mbgrid_thread_read_swath(engine, ifile, pjptr);
+    else
+      mbgrid_thread_read_triples(engine, ifile, pjptr);
+  }
+
+  if (pjptr != nullptr)
+    mb_proj_free(verbose, &pjptr, &error);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_thread_accumulate adds the current chunk of soundings to
+ * the grid columns owned by one worker, returning the number of soundings
+ * removed from the grid by time check resets
+ */
+int mbgrid_thread_accumulate(mbgrid_engine_struct *engine, int iworker) {
+  const int verbose = engine->verbose;
+  const grid_alg_t grid_mode = engine->grid_mode;
+  const int *owner = engine->column_owner.data();
+  const double file_weight = engine->chunk_file->file_weight;
+  const double topofactor = engine->chunk_file->vfactor;
+  const double *wbnd = engine->wbnd;
+  const double dx = engine->dx;
+  const double dy = engine->dy;
+  const int gxdim = engine->gxdim;
+  const int gydim = engine->gydim;
+  const int xtradim = engine->xtradim;
+  const double factor = engine->factor;
+  double *grid = engine->grid;
+  double *norm = engine->norm;
+  double *sigma = engine->sigma;
+  int *num = engine->num;
+  int *cnt = engine->cnt;
+  int error = MB_ERROR_NO_ERROR;
+  int removed = 0;
+
+  for (const mbgrid_sounding_struct &sounding : *engine->chunk) {
+    if (!sounding.time_ok)
+      continue;
+    const int ix = sounding.ix;
+    const int iy = sounding.iy;
+    const bool own_bin = ix >= 0 && ix < gxdim && owner[ix] == iworker;
+
+    /* clear the bin if the time check found older data */
+    if (sounding.reset && own_bin) {
+      const int kgrid = ix * gydim + iy;
+      removed += cnt[kgrid];
+      norm[kgrid] = 0.0;
+      grid[kgrid] = 0.0;
+      sigma[kgrid] = 0.0;
+      num[kgrid] = 0;
+      cnt[kgrid] = 0;
+    }
+
+    if (grid_mode == MBGRID_WEIGHTED_MEAN) {
+      const int ix1 = std::max(ix - xtradim, 0);
+      const int ix2 = std::min(ix + xtradim, gxdim - 1);
+      const int iy1 = std::max(iy - xtradim, 0);
+      const int iy2 = std::min(iy + xtradim, gydim - 1);
+      for (int ii = ix1; ii <= ix2; ii++) {
+        if (owner[ii] != iworker)
+          continue;
+        for (int jj = iy1; jj <= iy2; jj++) {
+          const int kgrid = ii * gydim + jj;
+          const double xx = wbnd[0] + ii * dx - sounding.x;
+          const double yy = wbnd[2] + jj * dy - sounding.y;
+          const double weight = file_weight * exp(-(xx * xx + yy * yy) * factor);
+          norm[kgrid] = norm[kgrid] + weight;
+          grid[kgrid] = grid[kgrid] + weight * topofactor * sounding.value;
+          sigma[kgrid] = sigma[kgrid] + weight * topofactor * topofactor * sounding.value * sounding.value;
+          num[kgrid]++;
+          if (ii == ix && jj == iy)
+            cnt[kgrid]++;
+        }
+      }
+    }
+    else if (grid_mode == MBGRID_MINIMUM_FILTER || grid_mode == MBGRID_MAXIMUM_FILTER) {
+      if (own_bin) {
+        const int kgrid = ix * gydim + iy;
+        if ((num[kgrid] > 0 && grid_mode == MBGRID_MINIMUM_FILTER && grid[kgrid] > topofactor * sounding.value) ||
+            (num[kgrid] > 0 && grid_mode == MBGRID_MAXIMUM_FILTER && grid[kgrid] < topofactor * sounding.value) ||
+            num[kgrid] <= 0) {
+          norm[kgrid] = 1.0;
+          grid[kgrid] = topofactor * sounding.value;
+          sigma[kgrid] = topofactor * topofactor * sounding.value * sounding.value;
+          num[kgrid] = 1;
+          cnt[kgrid] = 1;
+        }
+      }
+    }
+    else if (sounding.foot_dix < 0) {
+      /* point data without footprint */
+      if (own_bin) {
+        const int kgrid = ix * gydim + iy;
+        norm[kgrid] = norm[kgrid] + file_weight;
+        grid[kgrid] = grid[kgrid] + file_weight * topofactor * sounding.value;
+        sigma[kgrid] = sigma[kgrid] + file_weight * topofactor * topofactor * sounding.value * sounding.value;
+        num[kgrid]++;
+        cnt[kgrid]++;
+      }
+    }
+    else {
+      /* loop over neighborhood of bins covered by the footprint */
+      const int ix1 = std::max(ix - sounding.foot_dix, 0);
+      const int ix2 = std::min(ix + sounding.foot_dix, gxdim - 1);
+      const int iy1 = std::max(iy - sounding.foot_diy, 0);
+      const int iy2 = std::min(iy + sounding.foot_diy, gydim - 1);
+      const double sbath = topofactor * sounding.value;
+      const double foot_dxn = sounding.foot_dxn;
+      const double foot_dyn = sounding.foot_dyn;
+      for (int ii = ix1; ii <= ix2; ii++) {
+        if (owner[ii] != iworker)
+          continue;
+        for (int jj = iy1; jj <= iy2; jj++) {
+          /* find center and corners of bin from sounding center */
+          const int kgrid = ii * gydim + jj;
+          const double xx = (wbnd[0] + ii * dx + 0.5 * dx - sounding.x);
+          const double yy = (wbnd[2] + jj * dy + 0.5 * dy - sounding.y);
+          double xx0;
+          double yy0;
+          double bdx;
+          double bdy;
+          if (engine->use_projection) {
+            xx0 = xx;
+            yy0 = yy;
+            bdx = 0.5 * dx;
+            bdy = 0.5 * dy;
+          }
+          else {
+            xx0 = xx / engine->mtodeglon;
+            yy0 = yy / engine->mtodeglat;
+            bdx = 0.5 * dx / engine->mtodeglon;
+            bdy = 0.5 * dy / engine->mtodeglat;
+          }
+          const double xx1 = xx0 - bdx;
+          const double xx2 = xx0 + bdx;
+          const double yy1 = yy0 - bdy;
+          const double yy2 = yy0 + bdy;
+
+          /* rotate center and corners of bin to footprint coordinates */
+          double prx[5];
+          double pry[5];
+          prx[0] = xx0 * foot_dxn + yy0 * foot_dyn;
+          pry[0] = -xx0 * foot_dyn + yy0 * foot_dxn;
+          prx[1] = xx1 * foot_dxn + yy1 * foot_dyn;
+          pry[1] = -xx1 * foot_dyn + yy1 * foot_dxn;
+          prx[2] = xx2 * foot_dxn + yy1 * foot_dyn;
+          pry[2] = -xx2 * foot_dyn + yy1 * foot_dxn;
+          prx[3] = xx1 * foot_dxn + yy2 * foot_dyn;
+          pry[3] = -xx1 * foot_dyn + yy2 * foot_dxn;
+          prx[4] = xx2 * foot_dxn + yy2 * foot_dyn;
+          pry[4] = -xx2 * foot_dyn + yy2 * foot_dxn;
+
+          /* get weight integrated over bin */
+          double weight;
+          grid_use_t use_weight;
+          mbgrid_weight(verbose, sounding.foot_hwidth, sounding.foot_hlength, prx[0], pry[0], bdx, bdy, &prx[1],
+                        &pry[1], &weight, &use_weight, &error);
+
+          if (use_weight != MBGRID_USE_NO && weight > 0.000001) {
+            weight *= file_weight;
+            norm[kgrid] = norm[kgrid] + weight;
+            grid[kgrid] = grid[kgrid] + weight * sbath;
+            sigma[kgrid] = sigma[kgrid] + weight * sbath * sbath;
+            if (use_weight == MBGRID_USE_YES) {
+              num[kgrid]++;
+              if (ii == ix && jj == iy)
+                cnt[kgrid]++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return (removed);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_thread_worker accumulates each chunk of soundings
+ * dispatched by mbgrid_thread_grid into its own grid columns
+ */
+void mbgrid_thread_worker(mbgrid_engine_struct *engine, int iworker) {
+  unsigned long generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(engine->work_mutex);
+      engine->work_cond.wait(lock, [&] { return engine->quit || engine->generation != generation; });
+      if (engine->quit)
+        return;
+      generation = engine->generation;
+    }
+    const int removed = mbgrid_thread_accumulate(engine, iworker);
+    {
+      std::unique_lock<std::mutex> lock(engine->work_mutex);
+      engine->removed[iworker] = removed;
+      engine->nfinished++;
+      if (engine->nfinished == engine->n_workers)
+        engine->done_cond.notify_one();
+    }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_thread_grid reads and grids all of the files in the
+ * datalist using n_threads reader and worker threads, writing the
+ * contributing files to the datalist dfp and returning the total
+ * number of data gridded
+ */
+int mbgrid_thread_grid(mbgrid_engine_struct *engine, char *filelist, unsigned int n_threads, FILE *dfp,
+                       int *ndata, int *error) {
+  const int verbose = engine->verbose;
+  int memclear_error = MB_ERROR_NO_ERROR;
+
+  /* read the datalist up front - only the file list is held in memory */
+  void *datalist = nullptr;
+  const int look_processed = MB_DATALIST_LOOK_UNSET;
+  if (mb_datalist_open(verbose, &datalist, filelist, look_processed, error) != MB_SUCCESS) {
+    *error = MB_ERROR_OPEN_FAIL;
+    fprintf(outfp, "\nUnable to open data list file: %s\n", filelist);
+    fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
+    mb_memory_clear(verbose, &memclear_error);
+    exit(*error);
+  }
+  mbgrid_file_struct gfile;
+  mb_path dpath;
+  while (mb_datalist_read3(verbose, datalist, &gfile.pstatus, gfile.path, gfile.ppath, &gfile.astatus, gfile.apath,
+                           dpath, &gfile.format, &gfile.file_weight, error) == MB_SUCCESS) {
+    if (gfile.path[0] == '#' || gfile.format < 0
+        || (gfile.format == 0 && engine->grid_mode == MBGRID_WEIGHTED_FOOTPRINT))
+      continue;
+    gfile.rfile[0] = '\0';
+    gfile.vfactor = 1.0;
+    gfile.file_in_bounds = false;
+    gfile.error = MB_ERROR_NO_ERROR;
+    gfile.error_source = nullptr;
+    gfile.done = false;
+    engine->files.push_back(gfile);
+  }
+  mb_datalist_close(verbose, &datalist, error);
+  *error = MB_ERROR_NO_ERROR;
+
+  /* start the reader and worker threads */
+  engine->next_file = 0;
+  engine->head = 0;
+  engine->nbuffered = 0;
+  engine->abort = false;
+  engine->n_workers = n_threads;
+  engine->column_owner.resize(engine->gxdim);
+  for (int i = 0; i < engine->gxdim; i++)
+    engine->column_owner[i] = (i / MBGRID_THREAD_STRIP) % engine->n_workers;
+  engine->chunk = nullptr;
+  engine->chunk_file = nullptr;
+  engine->generation = 0;
+  engine->nfinished = 0;
+  engine->quit = false;
+  std::thread readerThreads[MB_THREAD_MAX];
+  std::thread workerThreads[MB_THREAD_MAX];
+  for (unsigned int i = 0; i < n_threads; i++) {
+    readerThreads[i] = std::thread(mbgrid_thread_reader, engine);
+    workerThreads[i] = std::thread(mbgrid_thread_worker, engine, (int)i);
+  }
+
+  /* grid the files in datalist order */
+  *ndata = 0;
+  const int gydim = engine->gydim;
+  mbgrid_file_struct *failed = nullptr;
+  for (size_t ifile = 0; ifile < engine->files.size() && failed == nullptr; ifile++) {
+    mbgrid_file_struct *gfile = &engine->files[ifile];
+    const bool triples = gfile->format == 0;
+    int ndatafile = 0;
+    bool first = true;
+    double dmin = 0.0;
+    double dmax = 0.0;
+
+    while (true) {
+      std::vector<mbgrid_sounding_struct> chunk;
+      {
+        std::unique_lock<std::mutex> lock(engine->read_mutex);
+        engine->read_cond.wait(lock, [&] { return !gfile->chunks.empty() || gfile->done; });
+        if (gfile->chunks.empty())
+          break;
+        chunk = std::move(gfile->chunks.front());
+        gfile->chunks.pop_front();
+        engine->nbuffered -= chunk.size();
+        engine->read_cond.notify_all();
+      }
+
+      /* check if within allowed time */
+      for (mbgrid_sounding_struct &sounding : chunk) {
+        const int ix = sounding.ix;
+        const int iy = sounding.iy;
+        const bool in_grid = ix >= 0 && ix < engine->gxdim && iy >= 0 && iy < gydim;
+        if (engine->check_time && in_grid) {
+          const int kgrid = ix * gydim + iy;
+          if (triples) {
+            sounding.time_ok = !(engine->firsttime[kgrid] > 0.0);
+          }
+          else if (engine->firsttime[kgrid] <= 0.0) {
+            engine->firsttime[kgrid] = sounding.time_d;
+          }
+          else if (fabs(sounding.time_d - engine->firsttime[kgrid]) > engine->timediff) {
+            if (engine->first_in_stays) {
+              sounding.time_ok = false;
+            }
+            else {
+              sounding.reset = true;
+              engine->firsttime[kgrid] = sounding.time_d;
+            }
+          }
+        }
+
+        if (sounding.time_ok) {
+          (*ndata)++;
+          ndatafile++;
+          const double value = gfile->vfactor * sounding.value;
+          if (first) {
+            first = false;
+            dmin = value;
+            dmax = value;
+          } else {
+            dmin = std::min(value, dmin);
+            dmax = std::max(value, dmax);
+          }
+        }
+      }
+
+      /* accumulate the chunk into the grid */
+      {
+        std::unique_lock<std::mutex> lock(engine->work_mutex);
+        engine->chunk = &chunk;
+        engine->chunk_file = gfile;
+        engine->nfinished = 0;
+        engine->generation++;
+        engine->work_cond.notify_all();
+        engine->done_cond.wait(lock, [&] { return engine->nfinished == engine->n_workers; });
+      }
+      for (int i = 0; i < engine->n_workers; i++) {
+        *ndata -= engine->removed[i];
+        ndatafile -= engine->removed[i];
+      }
+    }
+
+    if (gfile->error != MB_ERROR_NO_ERROR) {
+      failed = gfile;
+      break;
+    }
+
+    if (verbose >= 2)
+      fprintf(outfp, "\n");
+    if (verbose > 0 || (triples ? ndatafile > 0 : gfile->file_in_bounds))
+      fprintf(outfp, "%d data points processed in %s (minmax: %f %f)\n", ndatafile, gfile->rfile, dmin, dmax);
+
+    /* add to datalist if data actually contributed */
+    if (ndatafile > 0 && dfp != nullptr) {
+      if (gfile->pstatus == MB_PROCESSED_USE && gfile->astatus == MB_ALTNAV_USE)
+        fprintf(dfp, "A:%s %d %f %s\n", gfile->path, gfile->format, gfile->file_weight, gfile->apath);
+      else if (gfile->pstatus == MB_PROCESSED_USE)
+        fprintf(dfp, "P:%s %d %f\n", gfile->path, gfile->format, gfile->file_weight);
+      else
+        fprintf(dfp, "R:%s %d %f\n", gfile->path, gfile->format, gfile->file_weight);
+      fflush(dfp);
+    }
+
+    /* release the buffered data of this file and move on */
+    {
+      std::unique_lock<std::mutex> lock(engine->read_mutex);
+      engine->head = ifile + 1;
+      engine->read_cond.notify_all();
+    }
+  }
+
+  /* stop the threads */
+  {
+    std::unique_lock<std::mutex> lock(engine->read_mutex);
+    engine->abort = failed != nullptr;
+    engine->read_cond.notify_all();
+  }
+  {
+    std::unique_lock<std::mutex> lock(engine->work_mutex);
+    engine->quit = true;
+    engine->work_cond.notify_all();
+  }
+  for (unsigned int i = 0; i < n_threads; i++) {
+    readerThreads[i].join();
+    workerThreads[i].join();
+  }
+
+  /* quit if a file could not be read */
+  if (failed != nullptr) {
+    *error = failed->error;
+    if (strcmp(failed->error_source, "fopen") == 0) {
+      fprintf(outfp, "\nUnable to open lon,lat,value triples data file: %s\n", failed->path);
+    }
+    else if (strcmp(failed->error_source, "mb_register_array") == 0) {
+      char *message = nullptr;
+      mb_error(verbose, *error, &message);
+      fprintf(outfp, "\nMBIO Error allocating data arrays:\n%s\n", message);
+    }
+    else {
+      char *message = nullptr;
+      mb_error(verbose, *error, &message);
+      fprintf(outfp, "\nMBIO Error returned from function <%s>:\n%s\n", failed->error_source, message);
+      fprintf(outfp, "\nMultibeam File <%s> not initialized for reading\n", failed->rfile);
+    }
+    fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
+    mb_memory_clear(verbose, &memclear_error);
+    exit(*error);
+  }
+
+  return (MB_SUCCESS);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Out-of-core median filter gridding used when --median-memory is set.
+ *
+ * Rather than holding a growing array of values for every bin, the
+ * (bin, value) pairs are appended to a single buffer of bounded size.
+ * Whenever the buffer fills it is sorted by bin and written to a
+ * temporary run file next to the output grid; runs are merged
+ * MBGRID_MEDIAN_MERGE at a time so that only a few files are open at
+ * once. At the end the runs are merged into bin order and the median of
+ * each bin is found by selection (std::nth_element) rather than a full
+ * sort. Each value carries the reset count of its bin so that data
+ * discarded by the -U time check are dropped during the final merge.
+ */
+
+/* number of runs merged together at a time */
+constexpr int MBGRID_MEDIAN_MERGE = 16;
+
+/* io buffer size for run files */
+constexpr size_t MBGRID_MEDIAN_IOBUFFER = 262144;
+
+struct mbgrid_median_record_struct {
+  int kgrid;
+  int epoch;
+  double value;
+};
+
+struct mbgrid_median_run_struct {
+  mb_path path;
+  FILE *fp;
+  char *iobuffer;
+  int level;
+};
+
+struct mbgrid_median_struct {
+  size_t nbuffer_max;
+  std::vector<mbgrid_median_record_struct> buffer;
+  std::vector<int> epoch;
+  std::vector<mbgrid_median_run_struct> runs;
+  mb_path fileroot;
+  int nrun_total;
+};
+
+/* merge input - either a run file or the sorted in memory buffer */
+struct mbgrid_median_cursor_struct {
+  FILE *fp;
+  const mbgrid_median_record_struct *records;
+  size_t nrecord;
+  size_t irecord;
+  mbgrid_median_record_struct record;
+};
+
+/*--------------------------------------------------------------------*/
+bool mbgrid_median_cursor_next(mbgrid_median_cursor_struct *cursor) {
+  if (cursor->fp != nullptr)
+    return fread(&cursor->record, sizeof(mbgrid_median_record_struct), 1, cursor->fp) == 1;
+  if (cursor->irecord >= cursor->nrecord)
+    return false;
+  cursor->record = cursor->records[cursor->irecord++];
+  return true;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_median_merge merges the sorted cursors either into
+ * the run file ofp or, if ofp is null, into the median and standard
+ * deviation of each bin
+ */
+int mbgrid_median_merge(int verbose, mbgrid_median_struct *median, std::vector<mbgrid_median_cursor_struct> *cursors,
+                        FILE *ofp, double *grid, double *sigma, int *error) {
+  if (verbose >= 2) {
+    fprintf(outfp, "\ndbg2  Function <%s> called\n", __func__);
+    fprintf(outfp, "dbg2  Input arguments:\n");
+    fprintf(outfp, "dbg2       verbose:    %d\n", verbose);
+    fprintf(outfp, "dbg2       ncursor:    %zu\n", cursors->size());
+    fprintf(outfp, "dbg2       ofp:        %p\n", (void *)ofp);
+  }
+
+  /* heap of cursors ordered by the bin of their current record */
+  auto later = [cursors](size_t a, size_t b) { return (*cursors)[a].record.kgrid > (*cursors)[b].record.kgrid; };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heap(later);
+  for (size_t i = 0; i < cursors->size(); i++)
+    if (mbgrid_median_cursor_next(&(*cursors)[i]))
+      heap.push(i);
+
+  int status = MB_SUCCESS;
+  std::vector<double> values;
+  int kgrid = -1;
+  while (!heap.empty() || kgrid >= 0) {
+    const bool more = !heap.empty();
+    const mbgrid_median_record_struct *record = more ? &(*cursors)[heap.top()].record : nullptr;
+
+    /* write to the output run */
+    if (ofp != nullptr) {
+      if (!more)
+        break;
+      if (fwrite(record, sizeof(mbgrid_median_record_struct), 1, ofp) != 1) {
+        status = MB_FAILURE;
+        *error = MB_ERROR_WRITE_FAIL;
+        break;
+      }
+    }
+
+    /* or get the median of each bin once all of its values are in hand */
+    else {
+      if (kgrid >= 0 && (!more || record->kgrid != kgrid)) {
+        if (!values.empty()) {
+          const size_t n = values.size();
+          std::nth_element(values.begin(), values.begin() + n / 2, values.end());
+          grid[kgrid] = values[n / 2];
+          sigma[kgrid] = 0.0;
+          for (size_t k = 0; k < n; k++)
+            sigma[kgrid] += (values[k] - grid[kgrid]) * (values[k] - grid[kgrid]);
+          if (n > 1)
+            sigma[kgrid] = sqrt(sigma[kgrid] / (n - 1));
+          else
+            sigma[kgrid] = 0.0;
+        }
+        values.clear();
+        kgrid = -1;
+      }
+      if (!more)
+        break;
+      kgrid = record->kgrid;
+      if (record->epoch == median->epoch[kgrid])
+        values.push_back(record->value);
+    }
+
+    const size_t icursor = heap.top();
+    heap.pop();
+    if (mbgrid_median_cursor_next(&(*cursors)[icursor]))
+      heap.push(icursor);
+  }
+
+  if (verbose >= 2) {
+    fprintf(outfp, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(outfp, "dbg2  Return values:\n");
+    fprintf(outfp, "dbg2       error:      %d\n", *error);
+    fprintf(outfp, "dbg2  Return status:\n");
+    fprintf(outfp, "dbg2       status:     %d\n", status);
+  }
+
+  return (status);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_median_run_open creates a new run file at the given
+ * merge level, buffered with its own MBGRID_MEDIAN_IOBUFFER byte buffer
+ */
+int mbgrid_median_run_open(mbgrid_median_struct *median, int level, mbgrid_median_run_struct *run, int *error) {
+  snprintf(run->path, sizeof(run->path), "%s.median%d.tmp", median->fileroot, median->nrun_total++);
+  run->level = level;
+  if ((run->fp = fopen(run->path, "w+b")) == nullptr) {
+    *error = MB_ERROR_OPEN_FAIL;
+    return (MB_FAILURE);
+  }
+  if ((run->iobuffer = (char *)malloc(MBGRID_MEDIAN_IOBUFFER)) != nullptr)
+    setvbuf(run->fp, run->iobuffer, _IOFBF, MBGRID_MEDIAN_IOBUFFER);
+  return (MB_SUCCESS);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_median_run_close closes and removes a run file
+ */
+void mbgrid_median_run_close(mbgrid_median_run_struct *run) {
+  fclose(run->fp);
+  remove(run->path);
+  free(run->iobuffer);
+  run->fp = nullptr;
+  run->iobuffer = nullptr;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_median_close closes and removes all of the run files
+ */
+void mbgrid_median_close(mbgrid_median_struct *median) {
+  for (size_t i = 0; i < median->runs.size(); i++)
+    mbgrid_median_run_close(&median->runs[i]);
+  median->runs.clear();
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_median_spill sorts the buffered values by bin and writes
+ * them to a new run file, merging runs of the same size as needed
+ */
+int mbgrid_median_spill(int verbose, mbgrid_median_struct *median, int *error) {
+  std::sort(median->buffer.begin(), median->buffer.end(),
+            [](const mbgrid_median_record_struct &a, const mbgrid_median_record_struct &b) { return a.kgrid < b.kgrid; });
+
+  mbgrid_median_run_struct run;
+  if (mbgrid_median_run_open(median, 0, &run, error) != MB_SUCCESS) {
+    mbgrid_median_close(median);
+    return (MB_FAILURE);
+  }
+  if (fwrite(median->buffer.data(), sizeof(mbgrid_median_record_struct), median->buffer.size(), run.fp)
+      != median->buffer.size()) {
+    *error = MB_ERROR_WRITE_FAIL;
+    mbgrid_median_run_close(&run);
+    mbgrid_median_close(median);
+    return (MB_FAILURE);
+  }
+  median->buffer.clear();
+  median->runs.push_back(run);
+
+  /* merge the last runs while MBGRID_MEDIAN_MERGE of them share a level */
+  int status = MB_SUCCESS;
+  while (status == MB_SUCCESS && median->runs.size() >= (size_t)MBGRID_MEDIAN_MERGE) {
+    const size_t first = median->runs.size() - MBGRID_MEDIAN_MERGE;
+    const int level = median->runs.back().level;
+    bool same = true;
+    for (size_t i = first; i < median->runs.size(); i++)
+      if (median->runs[i].level != level)
+        same = false;
+    if (!same)
+      break;
+
+    mbgrid_median_run_struct merged;
+    if (mbgrid_median_run_open(median, level + 1, &merged, error) != MB_SUCCESS) {
+      mbgrid_median_close(median);
+      return (MB_FAILURE);
+    }
+    std::vector<mbgrid_median_cursor_struct> cursors(MBGRID_MEDIAN_MERGE);
+    for (int i = 0; i < MBGRID_MEDIAN_MERGE; i++) {
+      rewind(median->runs[first + i].fp);
+      cursors[i].fp = median->runs[first + i].fp;
+    }
+    status = mbgrid_median_merge(verbose, median, &cursors, merged.fp, nullptr, nullptr, error);
+    for (size_t i = first; i < median->runs.size(); i++)
+      mbgrid_median_run_close(&median->runs[i]);
+    median->runs.resize(first);
+    median->runs.push_back(merged);
+  }
+
+  /* a failed merge leaves a partial run, so drop every run file */
+  if (status != MB_SUCCESS)
+    mbgrid_median_close(median);
+
+  return (status);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_median_init sets up median filter gridding of ncell bins
+ * holding at most memory bytes of values in memory
+ */
+int mbgrid_median_init(int verbose, mbgrid_median_struct *median, int ncell, size_t memory, const char *fileroot,
+                       int *error) {
+  median->nbuffer_max = std::max(memory / sizeof(mbgrid_median_record_struct), (size_t)1024);
+  median->buffer.reserve(median->nbuffer_max);
+  median->epoch.assign(ncell, 0);
+  median->runs.clear();
+  strcpy(median->fileroot, fileroot);
+  median->nrun_total = 0;
+  *error = MB_ERROR_NO_ERROR;
+
+  if (verbose >= 2) {
+    fprintf(outfp, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(outfp, "dbg2  Return values:\n");
+    fprintf(outfp, "dbg2       nbuffer_max: %zu\n", median->nbuffer_max);
+    fprintf(outfp, "dbg2       error:       %d\n", *error);
+  }
+
+  return (MB_SUCCESS);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_median_add adds a value to bin kgrid
+ */
+int mbgrid_median_add(int verbose, mbgrid_median_struct *median, int kgrid, double value, int *error) {
+  mbgrid_median_record_struct record;
+  record.kgrid = kgrid;
+  record.epoch = median->epoch[kgrid];
+  record.value = value;
+  median->buffer.push_back(record);
+  if (median->buffer.size() >= median->nbuffer_max)
+    return (mbgrid_median_spill(verbose, median, error));
+  return (MB_SUCCESS);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_median_reset discards the values already added to bin kgrid
+ */
+void mbgrid_median_reset(mbgrid_median_struct *median, int kgrid) {
+  median->epoch[kgrid]++;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * function mbgrid_median_grid sets the median and standard deviation of
+ * every bin holding data and removes the run files
+ */
+int mbgrid_median_grid(int verbose, mbgrid_median_struct *median, double *grid, double *sigma, int *error) {
+  if (verbose >= 2) {
+    fprintf(outfp, "\ndbg2  Function <%s> called\n", __func__);
+    fprintf(outfp, "dbg2  Input arguments:\n");
+    fprintf(outfp, "dbg2       verbose:    %d\n", verbose);
+    fprintf(outfp, "dbg2       nbuffer:    %zu\n", median->buffer.size());
+    fprintf(outfp, "dbg2       nrun:       %zu\n", median->runs.size());
+  }
+
+  std::sort(median->buffer.begin(), median->buffer.end(),
+            [](const mbgrid_median_record_struct &a, const mbgrid_median_record_struct &b) { return a.kgrid < b.kgrid; });
+  std::vector<mbgrid_median_cursor_struct> cursors(median->runs.size() + 1);
+  for (size_t i = 0; i < median->runs.size(); i++) {
+    rewind(median->runs[i].fp);
+    cursors[i].fp = median->runs[i].fp;
+  }
+  mbgrid_median_cursor_struct *cursor = &cursors.back();
+  cursor->fp = nullptr;
+  cursor->records = median->buffer.data();
+  cursor->nrecord = median->buffer.size();
+  cursor->irecord = 0;
+
+  const int status = mbgrid_median_merge(verbose, median, &cursors, nullptr, grid, sigma, error);
+
+  mbgrid_median_close(median);
+  std::vector<mbgrid_median_record_struct>().swap(median->buffer);
+
+  if (verbose >= 2) {
+    fprintf(outfp, "\ndbg2  MBIO function <%s> completed\n", __func__);
+    fprintf(outfp, "dbg2  Return values:\n");
+    fprintf(outfp, "dbg2       error:      %d\n", *error);
+    fprintf(outfp, "dbg2  Return status:\n");
+    fprintf(outfp, "dbg2       status:     %d\n", status);
+  }
+
+  return (status);
+}
+
 /*--------------------------------------------------------------------*/
 
 int main(int argc, char **argv) {
@@ -487,15 +1739,42 @@ int main(int argc, char **argv) {
   bool spacing_priority = false;
   bool set_dimensions = false;
   grid_interp_t clipmode = MBGRID_INTERP_NONE;
+  unsigned int n_threads = 1;
+  size_t median_memory = 0;
+  int readahead = 0;
 
   {
+    int option_index;
+    const struct option options[] = {
+        {"threads", required_argument, nullptr, 0},
+        {"median-memory", required_argument, nullptr, 0},
+        {"readahead", required_argument, nullptr, 0},
+        {nullptr, 0, nullptr, 0}};
+
     bool errflg = false;
     int c;
     bool help = false;
-    while ((c = getopt(argc, argv, "A:a:B:b:C:c:D:d:E:e:F:f:G:g:HhI:i:J:j:K:k:L:l:MmNnO:o:P:p:QqR:r:S:s:T:t:U:u:VvW:w:X:x:Y:y:")) !=
-           -1)
+    while ((c = getopt_long(argc, argv, "A:a:B:b:C:c:D:d:E:e:F:f:G:g:HhI:i:J:j:K:k:L:l:MmNnO:o:P:p:QqR:r:S:s:T:t:U:u:VvW:w:X:x:Y:y:",
+                            options, &option_index)) != -1)
     {
       switch (c) {
+      /* long options */
+      case 0:
+        if (strcmp("threads", options[option_index].name) == 0) {
+          sscanf(optarg, "%u", &n_threads);
+          if (n_threads < 1)
+            n_threads = 1;
+        }
+        else if (strcmp("median-memory", options[option_index].name) == 0) {
+          int megabytes = 0;
+          sscanf(optarg, "%d", &megabytes);
+          median_memory = megabytes > 0 ? (size_t)megabytes * 1048576 : 0;
+        }
+        else if (strcmp("readahead", options[option_index].name) == 0) {
+          sscanf(optarg, "%d", &readahead);
+          readahead = MAX(readahead, 0);
+        }
+        break;
       case 'A':
       case 'a':
       {
@@ -761,6 +2040,9 @@ int main(int argc, char **argv) {
       fprintf(outfp, "dbg2       projection_pars_f:    %d\n", projection_pars_f);
       fprintf(outfp, "dbg2       projection_id:        %s\n", projection_id);
       fprintf(outfp, "dbg2       minormax_weighted_mean_threshold: %f\n", minormax_weighted_mean_threshold);
+      fprintf(outfp, "dbg2       n_threads:            %u\n", n_threads);
+      fprintf(outfp, "dbg2       median_memory:        %zu\n", median_memory);
+      fprintf(outfp, "dbg2       readahead:            %d\n", readahead);
 
     }
 
@@ -883,7 +2165,7 @@ int main(int argc, char **argv) {
   float *sgrid = nullptr;
   int *cnt = nullptr;
   int *num = nullptr;
-  double **data;
+  double **data = nullptr;
   double *value = nullptr;
   int ndata, ndatafile, nbackground;
   double zmin, zmax, zclip;
@@ -960,6 +2242,19 @@ int main(int argc, char **argv) {
     outclipvalue = std::numeric_limits<float>::quiet_NaN();
   }
 
+  const unsigned int n_concurrency = std::thread::hardware_concurrency();
+  if (n_concurrency > 0)
+    n_threads = MIN(n_threads, n_concurrency);
+  n_threads = MIN(n_threads, MB_THREAD_MAX);
+  /* the spline interpolation is multithreaded for all algorithms */
+  const int n_threads_surface = n_threads;
+
+  /* only the weighted mean, minimum, maximum and footprint algorithms
+      are multithreaded */
+  if (grid_mode != MBGRID_WEIGHTED_MEAN && grid_mode != MBGRID_MINIMUM_FILTER
+      && grid_mode != MBGRID_MAXIMUM_FILTER && grid_mode != MBGRID_WEIGHTED_FOOTPRINT)
+    n_threads = 1;
+
   bool use_projection = false;
 
   /* deal with projected gridding */
@@ -1378,7 +2673,9 @@ int main(int argc, char **argv) {
     else
       fprintf(outfp, "Unknown?\n");
     fprintf(outfp, "Gridding algorithm:  ");
-    if (grid_mode == MBGRID_MEDIAN_FILTER)
+    if (grid_mode == MBGRID_MEDIAN_FILTER && median_memory > 0)
+      fprintf(outfp, "Median Filter (out-of-core, %zu MB in memory)\n", median_memory / 1048576);
+    else if (grid_mode == MBGRID_MEDIAN_FILTER)
       fprintf(outfp, "Median Filter\n");
     else if (grid_mode == MBGRID_MINIMUM_FILTER)
       fprintf(outfp, "Minimum Filter\n");
@@ -1394,6 +2691,10 @@ int main(int argc, char **argv) {
       fprintf(outfp, "Maximum Gaussian Weighted Mean\n");
     else
       fprintf(outfp, "Gaussian Weighted Mean\n");
+    if (n_threads > 1)
+      fprintf(outfp, "Gridding threads:    %u\n", n_threads);
+    if (readahead > 0)
+      fprintf(outfp, "Read ahead records:  %d\n", readahead);
     fprintf(outfp, "Grid projection: %s\n", projection_id);
     if (use_projection) {
       fprintf(outfp, "Projection ID: %s\n", projection_id);
@@ -1891,6 +3192,12 @@ int main(int argc, char **argv) {
             exit(error);
           }
 
+          /* decode records in a background thread if requested */
+          if (readahead > 0) {
+            int readahead_error = MB_ERROR_NO_ERROR;
+            mb_readahead_init(verbose, mbio_ptr, readahead, &readahead_error);
+          }
+
           /* loop over reading */
           while (error <= MB_ERROR_NO_ERROR) {
             status = mb_read(verbose, mbio_ptr, &kind, &rpings, time_i, &time_d, &navlon, &navlat, &speed, &heading,
@@ -2034,8 +3341,8 @@ int main(int argc, char **argv) {
 
     /* do the interpolation */
     fprintf(outfp, "\nDoing Surface spline interpolation with %d data points...\n", ndata);
-    mb_surface(verbose, ndata, sxdata, sydata, szdata, (wbnd[0] - bdata_origin_x), (wbnd[1] - bdata_origin_x),
-               (wbnd[2] - bdata_origin_y), (wbnd[3] - bdata_origin_y), sdx, sdy, tension, sgrid);
+    mb_surface_threads(verbose, ndata, sxdata, sydata, szdata, (wbnd[0] - bdata_origin_x), (wbnd[1] - bdata_origin_x),
+               (wbnd[2] - bdata_origin_y), (wbnd[3] - bdata_origin_y), sdx, sdy, tension, n_threads_surface, sgrid);
 #else
     /* allocate and initialize sgrid */
     status = mb_mallocd(verbose, __FILE__, __LINE__, 3 * ndata * sizeof(float), (void **)&sdata, &error);
@@ -2082,7 +3389,8 @@ int main(int argc, char **argv) {
     float ddx = (float)sdx;
     float ddy = (float)sdy;
     fprintf(outfp, "\nDoing Zgrid spline interpolation with %d data points...\n", ndata);
-    mb_zgrid2(sgrid, &sxdim, &sydim, &xmin, &ymin, &ddx, &ddy, sdata, &ndata, work1, work2, work3, &cay, &sclip);
+    mb_zgrid2_threads(sgrid, &sxdim, &sydim, &xmin, &ymin, &ddx, &ddy, sdata, &ndata, work1, work2, work3, &cay, &sclip,
+                      n_threads_surface);
 #endif
 
     // float zflag = 5.0e34f;
@@ -2223,6 +3531,12 @@ int main(int argc, char **argv) {
             exit(error);
           }
 
+          /* decode records in a background thread if requested */
+          if (readahead > 0) {
+            int readahead_error = MB_ERROR_NO_ERROR;
+            mb_readahead_init(verbose, mbio_ptr, readahead, &readahead_error);
+          }
+
           /* loop over reading */
           while (error <= MB_ERROR_NO_ERROR) {
             status = mb_read(verbose, mbio_ptr, &kind, &rpings, time_i, &time_d, &navlon, &navlat, &speed, &heading,
@@ -2235,6 +3549,13 @@ int main(int argc, char **argv) {
               status = MB_SUCCESS;
             }
 
+            /* the beam widths are kept in the mbio descriptor, which is shared
+                with the read ahead thread */
+            double beamwidth_xtrack = 0.0;
+            double beamwidth_ltrack = 0.0;
+            int beamwidth_error = MB_ERROR_NO_ERROR;
+            mb_beamwidths(verbose, mbio_ptr, &beamwidth_xtrack, &beamwidth_ltrack, &beamwidth_error);
+
             if (verbose >= 2) {
               fprintf(outfp, "\ndbg2  Ping read in program <%s>\n", program_name);
               fprintf(outfp, "dbg2       kind:           %d\n", kind);
@@ -2252,7 +3573,7 @@ int main(int argc, char **argv) {
                             if (topo_type == MB_TOPOGRAPHY_TYPE_UNKNOWN) {
                                 status = mb_sonartype(verbose, mbio_ptr, mb_io_ptr->store_data, &topo_type, &error);
                                 if (topo_type == MB_TOPOGRAPHY_TYPE_UNKNOWN
-                                    && mb_io_ptr->beamwidth_xtrack > 0.0 && mb_io_ptr->beamwidth_ltrack > 0.0) {
+                                    && beamwidth_xtrack > 0.0 && beamwidth_ltrack > 0.0) {
                                     topo_type = MB_TOPOGRAPHY_TYPE_MULTIBEAM;
                                 }
                             }
@@ -2391,8 +3712,8 @@ int main(int argc, char **argv) {
                       foot_theta = RTD * atan2(foot_lateral, beam_altitude);
                       if (foot_range > 0.0 && foot_theta < FOOT_THETA_MAX) {
                         footprint_ok = true;
-                        foot_dtheta = 0.5 * scale * mb_io_ptr->beamwidth_xtrack;
-                        foot_dphi = 0.5 * scale * mb_io_ptr->beamwidth_ltrack;
+                        foot_dtheta = 0.5 * scale * beamwidth_xtrack;
+                        foot_dphi = 0.5 * scale * beamwidth_ltrack;
                         if (foot_dtheta <= 0.0)
                           foot_dtheta = 1.0;
                         if (foot_dphi <= 0.0)
@@ -2558,6 +3879,114 @@ int main(int argc, char **argv) {
     /***** end of weighted footprint slope gridding *****/
   }
 
+/* -------------------------------------------------------------------------- */
+  /***** do weighted mean, min/max or weighted footprint gridding with
+          several threads *****/
+  else if (n_threads > 1) {
+
+    /* allocate memory for additional arrays */
+    if (status == MB_SUCCESS)
+      status = mb_mallocd(verbose, __FILE__, __LINE__, gxdim * gydim * sizeof(double), (void **)&norm, &error);
+
+    /* if error initializing memory then quit */
+    if (error != MB_ERROR_NO_ERROR) {
+      char *message = nullptr;
+      mb_error(verbose, error, &message);
+      fprintf(outfp, "\nMBIO Error allocating data arrays:\n%s\n", message);
+      fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
+      mb_memory_clear(verbose, &memclear_error);
+      exit(error);
+    }
+
+    /* initialize arrays */
+    for (int i = 0; i < gxdim; i++)
+      for (int j = 0; j < gydim; j++) {
+        kgrid = i * gydim + j;
+        grid[kgrid] = 0.0;
+        norm[kgrid] = 0.0;
+        sigma[kgrid] = 0.0;
+        firsttime[kgrid] = 0.0;
+        num[kgrid] = 0;
+        cnt[kgrid] = 0;
+      }
+
+    /* set up the gridding engine */
+    mbgrid_engine_struct engine;
+    engine.verbose = verbose;
+    engine.grid_mode = grid_mode;
+    engine.datatype = datatype;
+    engine.pings = pings;
+    engine.lonflip = lonflip;
+    for (int i = 0; i < 4; i++)
+      engine.bounds[i] = bounds[i];
+    for (int i = 0; i < 7; i++) {
+      engine.btime_i[i] = btime_i[i];
+      engine.etime_i[i] = etime_i[i];
+    }
+    engine.speedmin = speedmin;
+    engine.timegap = timegap;
+    engine.readahead = readahead;
+    engine.use_projection = use_projection;
+    engine.projection_id = projection_id;
+    engine.check_time = check_time;
+    engine.first_in_stays = first_in_stays;
+    engine.timediff = timediff;
+    for (int i = 0; i < 4; i++)
+      engine.wbnd[i] = wbnd[i];
+    engine.dx = dx;
+    engine.dy = dy;
+    engine.gxdim = gxdim;
+    engine.gydim = gydim;
+    engine.xtradim = xtradim;
+    engine.factor = factor;
+    engine.topofactor = topofactor;
+    engine.scale = scale;
+    engine.mtodeglon = mtodeglon;
+    engine.mtodeglat = mtodeglat;
+    engine.grid = grid;
+    engine.norm = norm;
+    engine.sigma = sigma;
+    engine.firsttime = firsttime;
+    engine.num = num;
+    engine.cnt = cnt;
+
+    /* read in and grid the data */
+    fprintf(outfp, "\nDoing single pass to generate grid using %u threads...\n", n_threads);
+    mbgrid_thread_grid(&engine, filelist, n_threads, dfp, &ndata, &error);
+    fprintf(outfp, "\n%d total data points processed\n", ndata);
+
+    /* close datalist if necessary */
+    if (dfp != nullptr) {
+      fclose(dfp);
+      dfp = nullptr;
+    }
+
+    /* now loop over all points in the output grid */
+    if (verbose >= 1)
+      fprintf(outfp, "\nMaking raw grid...\n");
+    nbinset = 0;
+    nbinzero = 0;
+    nbinspline = 0;
+    nbinbackground = 0;
+    for (int i = 0; i < gxdim; i++)
+      for (int j = 0; j < gydim; j++) {
+        kgrid = i * gydim + j;
+        if ((grid_mode == MBGRID_WEIGHTED_FOOTPRINT && num[kgrid] > 0)
+            || (grid_mode != MBGRID_WEIGHTED_FOOTPRINT && cnt[kgrid] > 0)) {
+          grid[kgrid] = grid[kgrid] / norm[kgrid];
+          factor = sigma[kgrid] / norm[kgrid] - grid[kgrid] * grid[kgrid];
+          sigma[kgrid] = sqrt(fabs(factor));
+          nbinset++;
+        }
+        else {
+          grid[kgrid] = clipvalue;
+          sigma[kgrid] = 0.0;
+        }
+      }
+
+    /***** end of multithreaded gridding *****/
+  }
+
 /* -------------------------------------------------------------------------- */
   /***** do weighted footprint gridding *****/
   else if (grid_mode == MBGRID_WEIGHTED_FOOTPRINT) {
@@ -2675,6 +4104,12 @@ int main(int argc, char **argv) {
             exit(error);
           }
 
+          /* decode records in a background thread if requested */
+          if (readahead > 0) {
+            int readahead_error = MB_ERROR_NO_ERROR;
+            mb_readahead_init(verbose, mbio_ptr, readahead, &readahead_error);
+          }
+
           /* loop over reading */
           while (error <= MB_ERROR_NO_ERROR) {
             status = mb_read(verbose, mbio_ptr, &kind, &rpings, time_i, &time_d, &navlon, &navlat, &speed, &heading,
@@ -2687,6 +4122,13 @@ int main(int argc, char **argv) {
               status = MB_SUCCESS;
             }
 
+            /* the beam widths are kept in the mbio descriptor, which is shared
+                with the read ahead thread */
+            double beamwidth_xtrack = 0.0;
+            double beamwidth_ltrack = 0.0;
+            int beamwidth_error = MB_ERROR_NO_ERROR;
+            mb_beamwidths(verbose, mbio_ptr, &beamwidth_xtrack, &beamwidth_ltrack, &beamwidth_error);
+
             if (verbose >= 2) {
               fprintf(outfp, "\ndbg2  Ping read in program <%s>\n", program_name);
               fprintf(outfp, "dbg2       kind:           %d\n", kind);
@@ -2704,7 +4146,7 @@ int main(int argc, char **argv) {
                             if (topo_type == MB_TOPOGRAPHY_TYPE_UNKNOWN) {
                                 status = mb_sonartype(verbose, mbio_ptr, mb_io_ptr->store_data, &topo_type, &error);
                                 if (topo_type == MB_TOPOGRAPHY_TYPE_UNKNOWN
-                                    && mb_io_ptr->beamwidth_xtrack > 0.0 && mb_io_ptr->beamwidth_ltrack > 0.0) {
+                                    && beamwidth_xtrack > 0.0 && beamwidth_ltrack > 0.0) {
                                     topo_type = MB_TOPOGRAPHY_TYPE_MULTIBEAM;
                                 }
                             }
@@ -2815,8 +4257,8 @@ int main(int argc, char **argv) {
                       foot_range = sqrt(foot_lateral * foot_lateral + altitude * altitude);
                       if (foot_range > 0.0) {
                         foot_theta = RTD * atan2(foot_lateral, (bath[ib] - sensordepth));
-                        foot_dtheta = 0.5 * scale * mb_io_ptr->beamwidth_xtrack;
-                        foot_dphi = 0.5 * scale * mb_io_ptr->beamwidth_ltrack;
+                        foot_dtheta = 0.5 * scale * beamwidth_xtrack;
+                        foot_dphi = 0.5 * scale * beamwidth_ltrack;
                         if (foot_dtheta <= 0.0)
                           foot_dtheta = 1.0;
                         if (foot_dphi <= 0.0)
@@ -2998,8 +4440,13 @@ int main(int argc, char **argv) {
   /***** else do median filtering gridding *****/
   else if (grid_mode == MBGRID_MEDIAN_FILTER) {
 
-    /* allocate memory for additional arrays */
-    status = mb_mallocd(verbose, __FILE__, __LINE__, gxdim * gydim * sizeof(double *), (void **)&data, &error);
+    /* allocate memory for additional arrays, or set up the out-of-core
+        gridding if a memory limit has been set */
+    mbgrid_median_struct median;
+    if (median_memory > 0)
+      status = mbgrid_median_init(verbose, &median, gxdim * gydim, median_memory, fileroot, &error);
+    else
+      status = mb_mallocd(verbose, __FILE__, __LINE__, gxdim * gydim * sizeof(double *), (void **)&data, &error);
 
     /* if error initializing memory then quit */
     if (error != MB_ERROR_NO_ERROR) {
@@ -3019,8 +4466,11 @@ int main(int argc, char **argv) {
         sigma[kgrid] = 0.0;
         firsttime[kgrid] = 0.0;
         cnt[kgrid] = 0;
+        if (median_memory > 0)
+          mbgrid_median_reset(&median, kgrid);
         num[kgrid] = 0;
-        data[kgrid] = nullptr;
+        if (data != nullptr)
+          data[kgrid] = nullptr;
       }
 
     /* read in data */
@@ -3114,6 +4564,12 @@ int main(int argc, char **argv) {
             exit(error);
           }
 
+          /* decode records in a background thread if requested */
+          if (readahead > 0) {
+            int readahead_error = MB_ERROR_NO_ERROR;
+            mb_readahead_init(verbose, mbio_ptr, readahead, &readahead_error);
+          }
+
           /* loop over reading */
           while (error <= MB_ERROR_NO_ERROR) {
             status = mb_read(verbose, mbio_ptr, &kind, &rpings, time_i, &time_d, &navlon, &navlat, &speed, &heading,
@@ -3171,6 +4627,8 @@ int main(int argc, char **argv) {
                           ndata = ndata - cnt[kgrid];
                           ndatafile = ndatafile - cnt[kgrid];
                           cnt[kgrid] = 0;
+                          if (median_memory > 0)
+                            mbgrid_median_reset(&median, kgrid);
                         }
                       }
                       else
@@ -3178,7 +4636,7 @@ int main(int argc, char **argv) {
                     }
 
                     /* make sure there is space for the data */
-                    if (time_ok && cnt[kgrid] >= num[kgrid]) {
+                    if (time_ok && median_memory == 0 && cnt[kgrid] >= num[kgrid]) {
                       num[kgrid] += REALLOC_STEP_SIZE;
                       if ((data[kgrid] = (double *)realloc(data[kgrid], num[kgrid] * sizeof(double))) ==
                           nullptr) {
@@ -3198,8 +4656,20 @@ int main(int argc, char **argv) {
 
                     /* process it */
                     if (time_ok) {
-                      value = data[kgrid];
-                      value[cnt[kgrid]] = topofactor * bath[ib];
+                      if (median_memory > 0) {
+                        if (mbgrid_median_add(verbose, &median, kgrid, topofactor * bath[ib], &error) != MB_SUCCESS) {
+                          char *message = nullptr;
+                          mb_error(verbose, error, &message);
+                          fprintf(outfp, "\nMBIO Error writing median filter temporary file:\n%s\n", message);
+                          fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
+                          mb_memory_clear(verbose, &memclear_error);
+                          exit(error);
+                        }
+                      }
+                      else {
+                        value = data[kgrid];
+                        value[cnt[kgrid]] = topofactor * bath[ib];
+                      }
                       cnt[kgrid]++;
                       ndata++;
                       ndatafile++;
@@ -3249,6 +4719,8 @@ int main(int argc, char **argv) {
                           ndata = ndata - cnt[kgrid];
                           ndatafile = ndatafile - cnt[kgrid];
                           cnt[kgrid] = 0;
+                          if (median_memory > 0)
+                            mbgrid_median_reset(&median, kgrid);
                         }
                       }
                       else
@@ -3256,7 +4728,7 @@ int main(int argc, char **argv) {
                     }
 
                     /* make sure there is space for the data */
-                    if (time_ok && cnt[kgrid] >= num[kgrid]) {
+                    if (time_ok && median_memory == 0 && cnt[kgrid] >= num[kgrid]) {
                       num[kgrid] += REALLOC_STEP_SIZE;
                       if ((data[kgrid] = (double *)realloc(data[kgrid], num[kgrid] * sizeof(double))) ==
                           nullptr) {
@@ -3276,8 +4748,20 @@ int main(int argc, char **argv) {
 
                     /* process it */
                     if (time_ok) {
-                      value = data[kgrid];
-                      value[cnt[kgrid]] = amp[ib];
+                      if (median_memory > 0) {
+                        if (mbgrid_median_add(verbose, &median, kgrid, amp[ib], &error) != MB_SUCCESS) {
+                          char *message = nullptr;
+                          mb_error(verbose, error, &message);
+                          fprintf(outfp, "\nMBIO Error writing median filter temporary file:\n%s\n", message);
+                          fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
+                          mb_memory_clear(verbose, &memclear_error);
+                          exit(error);
+                        }
+                      }
+                      else {
+                        value = data[kgrid];
+                        value[cnt[kgrid]] = amp[ib];
+                      }
                       cnt[kgrid]++;
                       ndata++;
                       ndatafile++;
@@ -3326,6 +4810,8 @@ int main(int argc, char **argv) {
                           ndata = ndata - cnt[kgrid];
                           ndatafile = ndatafile - cnt[kgrid];
                           cnt[kgrid] = 0;
+                          if (median_memory > 0)
+                            mbgrid_median_reset(&median, kgrid);
                         }
                       }
                       else
@@ -3333,7 +4819,7 @@ int main(int argc, char **argv) {
                     }
 
                     /* make sure there is space for the data */
-                    if (time_ok && cnt[kgrid] >= num[kgrid]) {
+                    if (time_ok && median_memory == 0 && cnt[kgrid] >= num[kgrid]) {
                       num[kgrid] += REALLOC_STEP_SIZE;
                       if ((data[kgrid] = (double *)realloc(data[kgrid], num[kgrid] * sizeof(double))) ==
                           nullptr) {
@@ -3353,8 +4839,20 @@ int main(int argc, char **argv) {
 
                     /* process it */
                     if (time_ok) {
-                      value = data[kgrid];
-                      value[cnt[kgrid]] = ss[ib];
+                      if (median_memory > 0) {
+                        if (mbgrid_median_add(verbose, &median, kgrid, ss[ib], &error) != MB_SUCCESS) {
+                          char *message = nullptr;
+                          mb_error(verbose, error, &message);
+                          fprintf(outfp, "\nMBIO Error writing median filter temporary file:\n%s\n", message);
+                          fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
+                          mb_memory_clear(verbose, &memclear_error);
+                          exit(error);
+                        }
+                      }
+                      else {
+                        value = data[kgrid];
+                        value[cnt[kgrid]] = ss[ib];
+                      }
                       cnt[kgrid]++;
                       ndata++;
                       ndatafile++;
@@ -3429,7 +4927,7 @@ int main(int argc, char **argv) {
             }
 
             /* make sure there is space for the data */
-            if (time_ok && cnt[kgrid] >= num[kgrid]) {
+            if (time_ok && median_memory == 0 && cnt[kgrid] >= num[kgrid]) {
               num[kgrid] += REALLOC_STEP_SIZE;
               if ((data[kgrid] = (double *)realloc(data[kgrid], num[kgrid] * sizeof(double))) == nullptr) {
                 error = MB_ERROR_MEMORY_FAIL;
@@ -3448,8 +4946,20 @@ int main(int argc, char **argv) {
 
             /* process it */
             if (time_ok) {
-              value = data[kgrid];
-              value[cnt[kgrid]] = topofactor * tvalue;
+              if (median_memory > 0) {
+                if (mbgrid_median_add(verbose, &median, kgrid, topofactor * tvalue, &error) != MB_SUCCESS) {
+                  char *message = nullptr;
+                  mb_error(verbose, error, &message);
+                  fprintf(outfp, "\nMBIO Error writing median filter temporary file:\n%s\n", message);
+                  fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
+                  mb_memory_clear(verbose, &memclear_error);
+                  exit(error);
+                }
+              }
+              else {
+                value = data[kgrid];
+                value[cnt[kgrid]] = topofactor * tvalue;
+              }
               cnt[kgrid]++;
               ndata++;
               ndatafile++;
@@ -3501,33 +5011,53 @@ int main(int argc, char **argv) {
     nbinzero = 0;
     nbinspline = 0;
     nbinbackground = 0;
-    for (int i = 0; i < gxdim; i++)
-      for (int j = 0; j < gydim; j++) {
-        kgrid = i * gydim + j;
-        if (cnt[kgrid] > 0) {
-          value = data[kgrid];
-          qsort((char *)value, cnt[kgrid], sizeof(double), mb_double_compare);
-          grid[kgrid] = value[cnt[kgrid] / 2];
-          sigma[kgrid] = 0.0;
-          for (int k = 0; k < cnt[kgrid]; k++)
-            sigma[kgrid] += (value[k] - grid[kgrid]) * (value[k] - grid[kgrid]);
-          if (cnt[kgrid] > 1)
-            sigma[kgrid] = sqrt(sigma[kgrid] / (cnt[kgrid] - 1));
+    if (median_memory > 0) {
+      if (mbgrid_median_grid(verbose, &median, grid, sigma, &error) != MB_SUCCESS) {
+        char *message = nullptr;
+        mb_error(verbose, error, &message);
+        fprintf(outfp, "\nMBIO Error reading median filter temporary file:\n%s\n", message);
+        fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
+        mb_memory_clear(verbose, &memclear_error);
+        exit(error);
+      }
+      for (int i = 0; i < gxdim; i++)
+        for (int j = 0; j < gydim; j++) {
+          kgrid = i * gydim + j;
+          if (cnt[kgrid] > 0)
+            nbinset++;
           else
+            grid[kgrid] = clipvalue;
+        }
+    }
+    else {
+      for (int i = 0; i < gxdim; i++)
+        for (int j = 0; j < gydim; j++) {
+          kgrid = i * gydim + j;
+          if (cnt[kgrid] > 0) {
+            value = data[kgrid];
+            qsort((char *)value, cnt[kgrid], sizeof(double), mb_double_compare);
+            grid[kgrid] = value[cnt[kgrid] / 2];
             sigma[kgrid] = 0.0;
-          nbinset++;
+            for (int k = 0; k < cnt[kgrid]; k++)
+              sigma[kgrid] += (value[k] - grid[kgrid]) * (value[k] - grid[kgrid]);
+            if (cnt[kgrid] > 1)
+              sigma[kgrid] = sqrt(sigma[kgrid] / (cnt[kgrid] - 1));
+            else
+              sigma[kgrid] = 0.0;
+            nbinset++;
+          }
+          else
+            grid[kgrid] = clipvalue;
         }
-        else
-          grid[kgrid] = clipvalue;
-      }
 
-    /* now deallocate space for the data */
-    for (int i = 0; i < gxdim; i++)
-      for (int j = 0; j < gydim; j++) {
-        kgrid = i * gydim + j;
-        if (cnt[kgrid] > 0)
-          free(data[kgrid]);
-      }
+      /* now deallocate space for the data */
+      for (int i = 0; i < gxdim; i++)
+        for (int j = 0; j < gydim; j++) {
+          kgrid = i * gydim + j;
+          if (cnt[kgrid] > 0)
+            free(data[kgrid]);
+        }
+    }
 
     /***** end of median filter gridding *****/
   }
@@ -3655,6 +5185,12 @@ int main(int argc, char **argv) {
             exit(error);
           }
 
+          /* decode records in a background thread if requested */
+          if (readahead > 0) {
+            int readahead_error = MB_ERROR_NO_ERROR;
+            mb_readahead_init(verbose, mbio_ptr, readahead, &readahead_error);
+          }
+
           /* loop over reading */
           while (error <= MB_ERROR_NO_ERROR) {
             status = mb_read(verbose, mbio_ptr, &kind, &rpings, time_i, &time_d, &navlon, &navlat, &speed, &heading,
@@ -4272,6 +5808,12 @@ int main(int argc, char **argv) {
             exit(error);
           }
 
+          /* decode records in a background thread if requested */
+          if (readahead > 0) {
+            int readahead_error = MB_ERROR_NO_ERROR;
+            mb_readahead_init(verbose, mbio_ptr, readahead, &readahead_error);
+          }
+
           /* loop over reading */
           while (error <= MB_ERROR_NO_ERROR) {
             status = mb_read(verbose, mbio_ptr, &kind, &rpings, time_i, &time_d, &navlon, &navlat, &speed, &heading,
@@ -4660,6 +6202,12 @@ int main(int argc, char **argv) {
             exit(error);
           }
 
+          /* decode records in a background thread if requested */
+          if (readahead > 0) {
+            int readahead_error = MB_ERROR_NO_ERROR;
+            mb_readahead_init(verbose, mbio_ptr, readahead, &readahead_error);
+          }
+
           /* loop over reading */
           while (error <= MB_ERROR_NO_ERROR) {
             status = mb_read(verbose, mbio_ptr, &kind, &rpings, time_i, &time_d, &navlon, &navlat, &speed, &heading,
@@ -5064,7 +6612,7 @@ int main(int argc, char **argv) {
     /* if desired set border */
     if (setborder) {
       for (int i = 0; i < gxdim; i++) {
-        j = 0;
+        int j = 0;
         kgrid = i * gydim + j;
         if (grid[kgrid] >= clipvalue) {
           sxdata[ndata] = (float)(wbnd[0] + dx * i - bdata_origin_x);
@@ -5082,7 +6630,7 @@ int main(int argc, char **argv) {
         }
       }
       for (int j = 1; j < gydim - 1; j++) {
-        i = 0;
+        int i = 0;
         kgrid = i * gydim + j;
         if (grid[kgrid] >= clipvalue) {
           sxdata[ndata] = (float)(wbnd[0] + dx * i - bdata_origin_x);
@@ -5103,8 +6651,8 @@ int main(int argc, char **argv) {
 
     /* do the interpolation */
     fprintf(outfp, "\nDoing Surface spline interpolation with %d data points...\n", ndata);
-    mb_surface(verbose, ndata, sxdata, sydata, szdata, (float)(gbnd[0] - bdata_origin_x), (float)(gbnd[1] - bdata_origin_x),
-               (float)(gbnd[2] - bdata_origin_y), (float)(gbnd[3] - bdata_origin_y), dx, dy, tension, sgrid);
+    mb_surface_threads(verbose, ndata, sxdata, sydata, szdata, (float)(gbnd[0] - bdata_origin_x), (float)(gbnd[1] - bdata_origin_x),
+               (float)(gbnd[2] - bdata_origin_y), (float)(gbnd[3] - bdata_origin_y), dx, dy, tension, n_threads_surface, sgrid);
 #else
     /* allocate and initialize sgrid */
     status = mb_mallocd(verbose, __FILE__, __LINE__, 3 * ndata * sizeof(float), (void **)&sdata, &error);
@@ -5194,7 +6742,8 @@ int main(int argc, char **argv) {
     }*/
     if (clipmode == MBGRID_INTERP_ALL)
       clip = std::max(gxdim, gydim);
-    mb_zgrid(sgrid, &gxdim, &gydim, &xmin, &ymin, &ddx, &ddy, sdata, &ndata, work1, work2, work3, &cay, &clip);
+    mb_zgrid_threads(sgrid, &gxdim, &gydim, &xmin, &ymin, &ddx, &ddy, sdata, &ndata, work1, work2, work3, &cay, &clip,
+                     n_threads_surface);
 #endif
 
     if (clipmode == MBGRID_INTERP_GAP)
@@ -5458,9 +7007,9 @@ int main(int argc, char **argv) {
     /* do the interpolation */
     fprintf(outfp, "\nDoing spline interpolation with %d background points...\n", nbackground);
 #ifdef USESURFACE
-    mb_surface(verbose, nbackground, bxdata, bydata, bzdata, (float)(wbnd[0] - bdata_origin_x),
+    mb_surface_threads(verbose, nbackground, bxdata, bydata, bzdata, (float)(wbnd[0] - bdata_origin_x),
                (float)(wbnd[1] - bdata_origin_x), (float)(wbnd[2] - bdata_origin_y), (float)(wbnd[3] - bdata_origin_y), dx,
-               dy, tension, sgrid);
+               dy, tension, n_threads_surface, sgrid);
 #else
     float cay = (float)tension;
     float xmin = (float)(wbnd[0] - 0.5 * dx - bdata_origin_x);
@@ -5469,7 +7018,8 @@ int main(int argc, char **argv) {
     float ddy = (float)dy;
     clip = std::max(gxdim, gydim);
     fprintf(outfp, "\nDoing Zgrid spline interpolation with %d background points...\n", nbackground);
-    mb_zgrid(sgrid, &gxdim, &gydim, &xmin, &ymin, &ddx, &ddy, bdata, &nbackground, work1, work2, work3, &cay, &clip);
+    mb_zgrid_threads(sgrid, &gxdim, &gydim, &xmin, &ymin, &ddx, &ddy, bdata, &nbackground, work1, work2, work3, &cay, &clip,
+                     n_threads_surface);
 #endif
 
     /* translate the interpolation into the grid array
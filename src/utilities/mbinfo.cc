@@ -102,6 +102,7 @@ int main(int argc, char **argv) {
   double maskbounds[4];
   bool print_notices = false;
   bool output_usefile = false;
+  bool controls_set = false;
   int pings_read = 1;
   bool bathy_in_meters = true;
   output_format_t output_format = FREE_TEXT;
@@ -115,15 +116,18 @@ int main(int argc, char **argv) {
       switch (c) {
         case 'B':
         case 'b':
+          controls_set = true;
           sscanf(optarg, "%d/%d/%d/%d/%d/%d", &btime_i[0], &btime_i[1], &btime_i[2], &btime_i[3], &btime_i[4], &btime_i[5]);
           btime_i[6] = 0;
           break;
         case 'C':
         case 'c':
+          controls_set = true;
           comments = true;
           break;
         case 'E':
         case 'e':
+          controls_set = true;
           sscanf(optarg, "%d/%d/%d/%d/%d/%d", &etime_i[0], &etime_i[1], &etime_i[2], &etime_i[3], &etime_i[4], &etime_i[5]);
           etime_i[6] = 0;
           break;
@@ -145,6 +149,7 @@ int main(int argc, char **argv) {
           break;
         case 'L':
         case 'l':
+          controls_set = true;
           sscanf(optarg, "%d", &lonflip);
           lonflip_set = true;
           lonflip_use = lonflip;
@@ -172,6 +177,7 @@ int main(int argc, char **argv) {
           break;
         case 'P':
         case 'p':
+          controls_set = true;
           sscanf(optarg, "%d", &pings_read);
           if (pings_read < 1)
             pings_read = 1;
@@ -180,18 +186,22 @@ int main(int argc, char **argv) {
           break;
         case 'Q':
         case 'q':
+          controls_set = true;
           quick = true;
           break;
         case 'R':
         case 'r':
+          controls_set = true;
           mb_get_bounds(optarg, bounds);
           break;
         case 'S':
         case 's':
+          controls_set = true;
           sscanf(optarg, "%lf", &speedmin);
           break;
         case 'T':
         case 't':
+          controls_set = true;
           sscanf(optarg, "%lf", &timegap);
           break;
         case 'V':
@@ -200,6 +210,7 @@ int main(int argc, char **argv) {
           break;
         case 'W':
         case 'w':
+          controls_set = true;
           bathy_in_meters = false;
           break;
         case 'X':
@@ -317,6 +328,21 @@ int main(int argc, char **argv) {
   else
     bathy_scale = 1.0 / 0.3048;
 
+  /* the inf file of a single swath file with the default controls is the one
+      mb_make_info() makes, so use the same libmbio function */
+  if (output_usefile && output_format == FREE_TEXT && format > 0 && !controls_set && good_nav_only && print_notices &&
+      coverage_mask && !coverage_mask_bounds && mask_nx == MB_MAKE_INFO_MASK_NX && mask_ny == MB_MAKE_INFO_MASK_NY) {
+    if (mb_make_info_inf(verbose, read_file, format, &error) != MB_SUCCESS) {
+      char *message;
+      mb_error(verbose, error, &message);
+      fprintf(stderr, "\nMBIO Error returned from function <mb_make_info_inf>:\n%s\n", message);
+      fprintf(stderr, "\nMultibeam File <%s> not summarized\n", read_file);
+      fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+      exit(error);
+    }
+    exit(MB_ERROR_NO_ERROR);
+  }
+
   /* determine whether to read one file or a list of files */
   const bool read_datalist = format < 0;
   bool read_data;
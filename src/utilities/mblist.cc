@@ -811,6 +811,7 @@ int main(int argc, char **argv) {
   int pixel_end;
   check_t check_values = MBLIST_CHECK_ON;
   bool check_nav = false;
+  bool controls_set = false;
   char output_file[MB_PATH_MAXLINE] = "-";
   bool segment = false;
   segment_mode_t segment_mode = MBLIST_SEGMENT_MODE_NONE;
@@ -842,11 +843,13 @@ int main(int argc, char **argv) {
         break;
       case 'A':
       case 'a':
+        controls_set = true;
         ascii = false;
         netcdf_cdl = false;
         break;
       case 'B':
       case 'b':
+        controls_set = true;
         sscanf(optarg, "%d/%d/%d/%d/%d/%d", &btime_i[0], &btime_i[1], &btime_i[2], &btime_i[3], &btime_i[4], &btime_i[5]);
         btime_i[6] = 0;
         break;
@@ -857,6 +860,7 @@ int main(int argc, char **argv) {
       case 'D':
       case 'd':
         {
+          controls_set = true;
           int tmp;
           sscanf(optarg, "%d", &tmp);
           // TODO(schwehr): Range check tmp.
@@ -873,11 +877,13 @@ int main(int argc, char **argv) {
         }
       case 'E':
       case 'e':
+        controls_set = true;
         sscanf(optarg, "%d/%d/%d/%d/%d/%d", &etime_i[0], &etime_i[1], &etime_i[2], &etime_i[3], &etime_i[4], &etime_i[5]);
         etime_i[6] = 0;
         break;
       case 'G':
       case 'g':
+        controls_set = true;
         sscanf(optarg, "%1023s", delimiter);
         break;
       case 'F':
@@ -890,19 +896,23 @@ int main(int argc, char **argv) {
         break;
       case 'J':
       case 'j':
+        controls_set = true;
         sscanf(optarg, "%1023s", projection_pars);
         use_projection = true;
         break;
       case 'K':
       case 'k':
+        controls_set = true;
         sscanf(optarg, "%d", &decimate);
         break;
       case 'L':
       case 'l':
+        controls_set = true;
         sscanf(optarg, "%d", &lonflip);
         break;
       case 'M':
       case 'm':
+        controls_set = true;
         if (optarg[0] == 'a' || optarg[0] == 'A') {
           beam_set = MBLIST_SET_ALL;
         }
@@ -917,6 +927,7 @@ int main(int argc, char **argv) {
         break;
       case 'N':
       case 'n':
+        controls_set = true;
         if (optarg[0] == 'a' || optarg[0] == 'A') {
           pixel_set = MBLIST_SET_ALL;
         }
@@ -943,22 +954,27 @@ int main(int argc, char **argv) {
         break;
       case 'P':
       case 'p':
+        controls_set = true;
         sscanf(optarg, "%d", &pings);
         break;
       case 'Q':
       case 'q':
+        controls_set = true;
         check_values = MBLIST_CHECK_OFF_RAW;
         break;
       case 'R':
       case 'r':
+        controls_set = true;
         mb_get_bounds(optarg, bounds);
         break;
       case 'S':
       case 's':
+        controls_set = true;
         sscanf(optarg, "%lf", &speedmin);
         break;
       case 'T':
       case 't':
+        controls_set = true;
         sscanf(optarg, "%lf", &timegap);
         break;
       case 'U':
@@ -966,6 +982,7 @@ int main(int argc, char **argv) {
         if (optarg[0] == 'N')
           check_nav = true;
         else {
+          controls_set = true;
           int tmp;
           sscanf(optarg, "%d", &tmp);
           check_values = (check_t)tmp;
@@ -977,6 +994,7 @@ int main(int argc, char **argv) {
         break;
       case 'W':
       case 'w':
+        controls_set = true;
         bathy_in_feet = true;
         break;
       case 'X':
@@ -985,6 +1003,7 @@ int main(int argc, char **argv) {
         break;
       case 'Y':
       case 'y':
+        controls_set = true;
         sscanf(optarg, "%1023s", secondary_file);
         secondary_file_set = true;
         break;
@@ -1084,6 +1103,30 @@ int main(int argc, char **argv) {
   if (format == 0)
     mb_get_format(verbose, read_file, nullptr, &format, &error);
 
+  /* the fnv listing of a single swath file with the default controls is the
+      one mb_make_info() makes, so use the same libmbio function */
+  constexpr char fnv_list[] = "tMXYHScRPr=X=Y+X+Y";
+  if (n_list == (int)strlen(fnv_list) && strncmp(list, fnv_list, n_list) == 0 && check_nav && !controls_set &&
+      !netcdf && !segment && format > 0) {
+    FILE *outfile = stdout;
+    if (0 != strncmp("-", output_file, 2) && (outfile = fopen(output_file, "w")) == nullptr) {
+      fprintf(stderr, "Could not open file: %s\n", output_file);
+      exit(1);
+    }
+    status = mb_make_info_fnv(verbose, read_file, format, outfile, &error);
+    if (outfile != stdout)
+      fclose(outfile);
+    if (status != MB_SUCCESS) {
+      char *message;
+      mb_error(verbose, error, &message);
+      fprintf(stderr, "\nMBIO Error returned from function <mb_make_info_fnv>:\n%s\n", message);
+      fprintf(stderr, "\nMultibeam File <%s> not listed\n", read_file);
+      fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+      exit(error);
+    }
+    exit(MB_ERROR_NO_ERROR);
+  }
+
   double bathy_scale;
   /* set bathymetry scaling */
   if (bathy_in_feet)
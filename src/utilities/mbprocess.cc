@@ -46,16 +46,21 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <getopt.h>
+#include <mutex>
+#include <string>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <thread>
 #include <unistd.h>
+#include <vector>
 
 #include "mb_aux.h"
 #include "mb_define.h"
@@ -443,7 +448,7 @@ int mbprocess_save_edit(int verbose, FILE *esffp, double time_d, int beam, int a
 }
 /*--------------------------------------------------------------------*/
 void process_file(int verbose, int thread_id, struct mb_process_struct *process,
-                  struct mbprocess_grid_struct *grid, int *status, int *error)
+                  struct mbprocess_grid_struct *grid, int readahead, int *status, int *error)
 {
 
   /* MBIO read and write control parameters */
@@ -3995,6 +4000,14 @@ void process_file(int verbose, int thread_id, struct mb_process_struct *process,
     loop over reading input
     --------------------------------------------*/
 
+  /* decode input records in a background thread if requested, so that
+      reading overlaps with processing - formats that cannot copy their
+      records are read in this thread */
+  if (readahead > 0) {
+    int readahead_error = MB_ERROR_NO_ERROR;
+    mb_readahead_init(verbose, imbio_ptr, readahead, &readahead_error);
+  }
+
   /* read and write */
   while (*error <= MB_ERROR_NO_ERROR) {
     /* read some data */
@@ -4558,9 +4571,8 @@ void process_file(int verbose, int thread_id, struct mb_process_struct *process,
             }
 
             /* raytrace */
-            *status = mb_rt(verbose, rt_svp, (depth_offset_use - static_shift), angles[i], 0.5 * ttimes[i],
-                           process->mbp_angle_mode, ssv, angles_null[i], 0, nullptr, nullptr, nullptr, nullptr, &xx, &zz, &ttime,
-                           &ray_stat, error);
+            *status = mb_rt_table(verbose, rt_svp, (depth_offset_use - static_shift), angles[i], 0.5 * ttimes[i],
+                           process->mbp_angle_mode, ssv, angles_null[i], &xx, &zz, &ttime, &ray_stat, error);
 
             /* apply static shift if any */
             zz += static_shift;
@@ -5333,9 +5345,12 @@ void process_file(int verbose, int thread_id, struct mb_process_struct *process,
         if (make_fbt) {
           fstore->sensorhead = sensorhead;
           fstore->topo_type = sensortype;
-          struct mb_io_struct *imb_io_ptr = (struct mb_io_struct *)imbio_ptr;
-          fstore->beam_xwidth = imb_io_ptr->beamwidth_xtrack;
-          fstore->beam_lwidth = imb_io_ptr->beamwidth_ltrack;
+          double beamwidth_xtrack = 0.0;
+          double beamwidth_ltrack = 0.0;
+          int beamwidth_error = MB_ERROR_NO_ERROR;
+          mb_beamwidths(verbose, imbio_ptr, &beamwidth_xtrack, &beamwidth_ltrack, &beamwidth_error);
+          fstore->beam_xwidth = beamwidth_xtrack;
+          fstore->beam_lwidth = beamwidth_ltrack;
           fstore->kind = kind;
           mb_insert_nav(verbose, fmbio_ptr, fstore_ptr, time_i, time_d,
                         navlon, navlat, speed, heading, draft,
@@ -5617,11 +5632,254 @@ void process_file(int verbose, int thread_id, struct mb_process_struct *process,
   }
 
 }
+/*--------------------------------------------------------------------*/
+/*
+ * Files to be processed are first checked in datalist order, then handed
+ * to a pool of worker threads that pull them from a shared queue, largest
+ * file first when more than one thread is used, so that one long file does
+ * not hold up the processing of the others. Each file is locked by the
+ * worker only while it is being processed, so that several instances of
+ * mbprocess may share a datalist.
+ */
+
+/* file waiting to be processed */
+struct mbprocess_job_struct {
+  std::string ifile;
+  std::string ofile;
+  int format;
+  off_t size;
+};
+
+/* topography grids for backscatter correction shared by the processing
+    threads - a grid is only released when no thread is using it */
+struct mbprocess_gridcache_struct {
+  struct mbprocess_grid_struct grids[MB_PR_TOPOGRID_NUM_MAX];
+  bool grids_read[MB_PR_TOPOGRID_NUM_MAX];
+  unsigned int grids_countSinceUsed[MB_PR_TOPOGRID_NUM_MAX];
+  unsigned int grids_users[MB_PR_TOPOGRID_NUM_MAX];
+};
+
+/* processing queue and worker pool */
+struct mbprocess_pool_struct {
+  int verbose;
+  bool strip_comments;
+  bool uselockfiles;
+  int readahead;
+  std::vector<mbprocess_job_struct> jobs;
+  std::atomic<size_t> next_job;
+  std::mutex mutex; /* protects the grid cache, parameter reads, locking and output */
+  struct mbprocess_gridcache_struct gridcache;
+  size_t njob_done;
+  double bytes_done;
+  std::chrono::steady_clock::time_point start;
+};
+
+/*--------------------------------------------------------------------*/
+/*
+ * Returns the topography grid file, reading it if needed. This is called
+ * with the pool mutex held. Because there are no more threads than grid
+ * slots a slot that is not in use can always be found.
+ */
+struct mbprocess_grid_struct *mbprocess_grid_acquire(int verbose, struct mbprocess_gridcache_struct *cache,
+                                                     const char *file, int *error) {
+  struct mbprocess_grid_struct *grids = cache->grids;
+
+  // Check if this grid has already been read
+  int igrid_use = -1;
+  for (int i = 0; i < MB_PR_TOPOGRID_NUM_MAX; i++) {
+    if (cache->grids_read[i]) {
+      if (igrid_use < 0 && strcmp(file, grids[i].file) == 0) {
+        igrid_use = i;
+        cache->grids_countSinceUsed[i] = 0;
+      } else {
+        cache->grids_countSinceUsed[i]++;
+      }
+    }
+  }
+
+  // Delete any grids in memory that haven't been used recently
+  for (int i = 0; i < MB_PR_TOPOGRID_NUM_MAX; i++) {
+    if (cache->grids_read[i] && cache->grids_users[i] == 0 && cache->grids_countSinceUsed[i] > MB_PR_TOPOGRID_NONUSE_MAX) {
+      mb_freed(verbose, __FILE__, __LINE__, (void **)&grids[i].data, error);
+      memset(&grids[i], 0, sizeof(struct mbprocess_grid_struct));
+      cache->grids_read[i] = false;
+      cache->grids_countSinceUsed[i] = 0;
+    }
+  }
+
+  // If necessary read new grid
+  if (igrid_use < 0) {
+    // find the first available grid slot or delete an unused grid to make room
+    int igrid_delete = -1;
+    int largest_count_since_used = -1;
+    for (int i = 0; i < MB_PR_TOPOGRID_NUM_MAX && igrid_use == -1; i++) {
+      if (!cache->grids_read[i]) {
+        igrid_use = i;
+      } else if (cache->grids_users[i] == 0 && (int)cache->grids_countSinceUsed[i] > largest_count_since_used) {
+        largest_count_since_used = cache->grids_countSinceUsed[i];
+        igrid_delete = i;
+      }
+    }
+    if (igrid_use < 0 && igrid_delete >= 0) {
+      mb_freed(verbose, __FILE__, __LINE__, (void **)&grids[igrid_delete].data, error);
+      memset(&grids[igrid_delete], 0, sizeof(struct mbprocess_grid_struct));
+      cache->grids_read[igrid_delete] = false;
+      cache->grids_countSinceUsed[igrid_delete] = 0;
+      igrid_use = igrid_delete;
+    }
+    if (igrid_use < 0) {
+      fprintf(stderr, "\nUnable to clear memory to read topography grid file: %s\n", file);
+      return (nullptr);
+    }
+
+    // read the grid
+    struct mbprocess_grid_struct *grid = &grids[igrid_use];
+    grid->data = nullptr;
+    strcpy(grid->file, file);
+    const int status = mb_read_gmt_grd(verbose, grid->file, &grid->projection_mode, grid->projection_id, &grid->nodatavalue,
+                                       &grid->nxy, &grid->n_columns, &grid->n_rows, &grid->min, &grid->max, &grid->xmin,
+                                       &grid->xmax, &grid->ymin, &grid->ymax, &grid->dx, &grid->dy, &grid->data, nullptr,
+                                       nullptr, error);
+    if (status != MB_SUCCESS) {
+      fprintf(stderr, "\nUnable to read topography grid file: %s\n", grid->file);
+      return (nullptr);
+    }
+    cache->grids_read[igrid_use] = true;
+    cache->grids_countSinceUsed[igrid_use] = 0;
+  }
+
+  cache->grids_users[igrid_use]++;
+  return (&grids[igrid_use]);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Releases a topography grid returned by mbprocess_grid_acquire(); this
+ * is called with the pool mutex held.
+ */
+void mbprocess_grid_release(struct mbprocess_gridcache_struct *cache, struct mbprocess_grid_struct *grid) {
+  if (grid != nullptr)
+    cache->grids_users[grid - cache->grids]--;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Worker thread - processes files from the queue until it is empty
+ */
+void mbprocess_worker(struct mbprocess_pool_struct *pool, int thread_id) {
+  const int verbose = pool->verbose;
+  struct mb_process_struct process;
+  mb_path ifile;
+
+  while (true) {
+    const size_t ijob = pool->next_job++;
+    if (ijob >= pool->jobs.size())
+      break;
+    const struct mbprocess_job_struct *job = &pool->jobs[ijob];
+
+    /* lock the file and load its parameters */
+    struct mbprocess_grid_struct *grid_use = nullptr;
+    int status = MB_SUCCESS;
+    int error = MB_ERROR_NO_ERROR;
+    {
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      strcpy(ifile, job->ifile.c_str());
+      if (pool->uselockfiles) {
+        int lock_error = MB_ERROR_NO_ERROR;
+        if (mb_pr_lockswathfile(verbose, ifile, MBP_LOCK_PROCESS, program_name, &lock_error) != MB_SUCCESS) {
+          if (lock_error == MB_ERROR_FILE_LOCKED)
+            fprintf(stderr, "Data skipped - locked by another program: %s\n", ifile);
+          else
+            fprintf(stderr, "Data skipped - unable to set lock: %s\n", ifile);
+          pool->njob_done++;
+          continue;
+        }
+      }
+      if (mb_pr_readpar(verbose, ifile, false, &process, &error) != MB_SUCCESS) {
+        fprintf(stderr, "Data skipped - processing unknown: %s\n", ifile);
+        if (pool->uselockfiles)
+          mb_pr_unlockswathfile(verbose, ifile, MBP_LOCK_PROCESS, program_name, &error);
+        pool->njob_done++;
+        continue;
+      }
+      process.mbp_strip_comments = pool->strip_comments;
+      strcpy(process.mbp_ofile, job->ofile.c_str());
+      process.mbp_format = job->format;
+
+      // if needed get the specified topography grid for backscatter correction
+      // - if this has already been read in then use the existing structure
+      if ((process.mbp_ampcorr_mode == MBP_AMPCORR_ON &&
+           (process.mbp_ampcorr_slope == MBP_AMPCORR_USETOPO || process.mbp_ampcorr_slope == MBP_AMPCORR_USETOPOSLOPE)) ||
+          (process.mbp_sscorr_mode == MBP_SSCORR_ON &&
+           (process.mbp_sscorr_slope == MBP_SSCORR_USETOPO || process.mbp_sscorr_slope == MBP_SSCORR_USETOPOSLOPE))) {
+        grid_use = mbprocess_grid_acquire(verbose, &pool->gridcache, process.mbp_ampsscorr_topofile, &error);
+        if (grid_use == nullptr) {
+          fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+          exit(MB_ERROR_OPEN_FAIL);
+        }
+      }
+    }
+
+    /* process the file */
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    process_file(verbose, thread_id, &process, grid_use, pool->readahead, &status, &error);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    /* release the grid, unlock the raw swath file and report progress */
+    {
+      std::lock_guard<std::mutex> lock(pool->mutex);
+      mbprocess_grid_release(&pool->gridcache, grid_use);
+      if (pool->uselockfiles) {
+        mb_pr_unlockswathfile(verbose, ifile, MBP_LOCK_PROCESS, program_name, &error);
+      }
+      pool->njob_done++;
+      pool->bytes_done += job->size;
+      const double megabytes = job->size / 1048576.0;
+      fprintf(stderr, "Processed file %zu of %zu (%.1f MB in %.1f s, %.1f MB/s): %s\n", pool->njob_done, pool->jobs.size(),
+              megabytes, seconds, seconds > 0.0 ? megabytes / seconds : 0.0, job->ifile.c_str());
+    }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Processes all queued files using n_threads threads
+ */
+void mbprocess_run(struct mbprocess_pool_struct *pool, unsigned int n_threads) {
+  /* start the largest files first so that they do not finish last */
+  if (n_threads > 1)
+    std::stable_sort(pool->jobs.begin(), pool->jobs.end(),
+                     [](const mbprocess_job_struct &a, const mbprocess_job_struct &b) { return a.size > b.size; });
+
+  pool->next_job = 0;
+  pool->njob_done = 0;
+  pool->bytes_done = 0.0;
+  pool->start = std::chrono::steady_clock::now();
+  n_threads = MIN(n_threads, (unsigned int)pool->jobs.size());
+  if (n_threads > 1) {
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < n_threads; i++)
+      threads.emplace_back(mbprocess_worker, pool, (int)i);
+    for (unsigned int i = 0; i < n_threads; i++)
+      threads[i].join();
+  }
+  else {
+    mbprocess_worker(pool, 0);
+  }
+
+  if (!pool->jobs.empty()) {
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - pool->start).count();
+    const double megabytes = pool->bytes_done / 1048576.0;
+    fprintf(stderr, "Processed %zu files (%.1f MB in %.1f s, %.1f MB/s) using %u threads\n", pool->njob_done, megabytes,
+            seconds, seconds > 0.0 ? megabytes / seconds : 0.0, MAX(n_threads, 1));
+  }
+}
+
 /*--------------------------------------------------------------------*/
 
 int main(int argc, char **argv) {
   constexpr char usage_message[] =
-      "mbprocess -Iinfile [-C -Fformat -N -Ooutfile -P -S -T -V -H]";
+      "mbprocess -Iinfile [-C -Fformat -N -Ooutfile -P -S -T -V -H --readahead=nrecords]";
 
   int verbose = 0;
   int status = MB_SUCCESS;
@@ -5647,22 +5905,27 @@ int main(int argc, char **argv) {
   bool testonly = false;
 
   unsigned int n_threads = 1;
-
-  /* disable keeping a list of allocated memory because the memory list
-      functionality in mb_mem.c is not thread safe */
-  // TODO: add mutex locking/unlocking to allow testing with memory list
-  //       enabled - we will still want it disabled most of the time for
-  //       performance, but it would be good to be able to check for memory
-  //       leaks again.  DWC December 27 2020
-  mb_mem_list_disable(verbose, &error);
+  int readahead = 0;
 
   /* process argument list */
   {
+    int option_index;
+    const struct option options[] = {
+        {"readahead", required_argument, nullptr, 0},
+        {nullptr, 0, nullptr, 0}};
+
     bool errflg = false;
     int c;
     bool help = false;
-    while ((c = getopt(argc, argv, "VvHhC:c:F:f:I:i:NnO:o:PpSsTt")) != -1)
+    while ((c = getopt_long(argc, argv, "VvHhC:c:F:f:I:i:NnO:o:PpSsTt", options, &option_index)) != -1)
       switch (c) {
+      /* long options */
+      case 0:
+        if (strcmp("readahead", options[option_index].name) == 0) {
+          sscanf(optarg, "%d", &readahead);
+          readahead = MAX(readahead, 0);
+        }
+        break;
       case 'H':
       case 'h':
         help = true;
@@ -5783,6 +6046,7 @@ int main(int argc, char **argv) {
     fprintf(stderr, "dbg2       printfilestatus: %d\n", printfilestatus);
     fprintf(stderr, "dbg2       testonly:        %d\n", testonly);
     fprintf(stderr, "dbg2       n_threads:       %d\n", n_threads);
+    fprintf(stderr, "dbg2       readahead:       %d\n", readahead);
     fprintf(stderr, "dbg2       verbose:         %d\n", verbose);
   }
 
@@ -5804,7 +6068,6 @@ int main(int argc, char **argv) {
   }
 
   /* swath file locking variables */
-  int lock_status;
   int lock_error;
   int lock_purpose = MBP_LOCK_NONE;
   mb_path lock_program;
@@ -5826,27 +6089,34 @@ int main(int argc, char **argv) {
   bool locked;
 
   /* get number of threads to use */
-  unsigned int n_concurrency = std::thread::hardware_concurrency();
-  n_threads = MIN(n_threads, MIN(n_concurrency, MB_THREAD_MAX));
-  unsigned int n_thread_set = 0;
-  std::thread mbprocessThreads[MB_THREAD_MAX];
-  int thread_status[MB_THREAD_MAX];
-  int thread_error[MB_THREAD_MAX];
+  const unsigned int n_concurrency = std::thread::hardware_concurrency();
+  if (n_concurrency > 0)
+    n_threads = MIN(n_threads, n_concurrency);
+  n_threads = MAX(1, MIN(n_threads, MB_THREAD_MAX));
 
-  /* parameter controls */
-  struct mb_process_struct processPars[MB_THREAD_MAX];
+  /* keeping the list of allocated memory slows processing, so it is only
+      kept when debugging - the memory still held at the end is then
+      reported by allocation source location */
+  if (verbose < 4)
+    mb_mem_list_disable(verbose, &error);
 
-  /* topography grids for backscatter correction */
-  struct mbprocess_grid_struct grids[MB_PR_TOPOGRID_NUM_MAX];
-  bool grids_read[MB_PR_TOPOGRID_NUM_MAX];
-  memset(grids_read, 0, sizeof(bool) * MB_PR_TOPOGRID_NUM_MAX);
-  unsigned int grids_countSinceUsed[MB_PR_TOPOGRID_NUM_MAX];
-  memset(grids_countSinceUsed, 0, sizeof(unsigned int) * MB_PR_TOPOGRID_NUM_MAX);
+  /* parameter controls */
+  struct mb_process_struct processPar;
+
+  /* queue of files to be processed and the processing threads */
+  struct mbprocess_pool_struct *pool = new mbprocess_pool_struct;
+  pool->verbose = verbose;
+  pool->strip_comments = strip_comments;
+  pool->uselockfiles = uselockfiles;
+  pool->readahead = readahead;
+  memset(pool->gridcache.grids_read, 0, sizeof(bool) * MB_PR_TOPOGRID_NUM_MAX);
+  memset(pool->gridcache.grids_countSinceUsed, 0, sizeof(unsigned int) * MB_PR_TOPOGRID_NUM_MAX);
+  memset(pool->gridcache.grids_users, 0, sizeof(unsigned int) * MB_PR_TOPOGRID_NUM_MAX);
 
   /* loop over all files to be read */
   while (read_data) {
     /* load parameters */
-    struct mb_process_struct *process = &processPars[n_thread_set];
+    struct mb_process_struct *process = &processPar;
     status = mb_pr_readpar(verbose, mbp_ifile, false, process, &error);
 
     /* set strip_comments */
@@ -5872,11 +6142,13 @@ int main(int argc, char **argv) {
       strcat(process->mbp_ofile, mbp_ofile);
     }
 
-    /* get mod time for the input file */
+    /* get mod time and size for the input file */
     int ifilemodtime = 0;
+    off_t ifilesize = 0;
     int fstat = stat(mbp_ifile, &file_status);
     if (fstat == 0 && (file_status.st_mode & S_IFMT) != S_IFDIR) {
       ifilemodtime = file_status.st_mtime;
+      ifilesize = file_status.st_size;
     }
 
     /* check for existing parameter file */
@@ -5965,24 +6237,12 @@ int main(int argc, char **argv) {
       if (outofdate || !checkuptodate) {
         /* not testing - do it for real */
         if (!testonly) {
-          /* want to process, now try to set a lock of the file to be processed */
+          /* want to process, check that the file is not locked - the
+              lock itself is set by the worker that processes the file */
           if (uselockfiles) {
-            lock_status = mb_pr_lockswathfile(verbose, process->mbp_ifile,
-                                              MBP_LOCK_PROCESS, program_name,
-                                              &lock_error);
-            if (lock_status == MB_SUCCESS) {
-              proceedprocess = true;
-              locked = false;
-            }
-            else if (lock_error == MB_ERROR_FILE_LOCKED) {
-              proceedprocess = false;
-              mb_pr_lockinfo(verbose, process->mbp_ifile, &locked, &lock_purpose, lock_program,
-                                           lock_user, lock_cpu, lock_date, &lock_error);
-            }
-            else if (lock_error == MB_ERROR_OPEN_FAIL) {
-              proceedprocess = false;
-              locked = false;
-            }
+            mb_pr_lockinfo(verbose, process->mbp_ifile, &locked, &lock_purpose, lock_program,
+                                         lock_user, lock_cpu, lock_date, &lock_error);
+            proceedprocess = !locked;
           }
 
           /* want to process, but lock files are disabled */
@@ -6126,103 +6386,15 @@ int main(int argc, char **argv) {
         proceedprocess = false;
     }
 
-    /* now start the processing thread for the input file */
+    /* queue the input file for processing */
     if (proceedprocess) {
-
-      // if needed read in the specified topography grid for backscatter correction
-      // - if this has already been read in then use the existing structure
-      struct mbprocess_grid_struct *grid_use = nullptr;
-      if ((process->mbp_ampcorr_mode == MBP_AMPCORR_ON &&
-           (process->mbp_ampcorr_slope == MBP_AMPCORR_USETOPO || process->mbp_ampcorr_slope == MBP_AMPCORR_USETOPOSLOPE)) ||
-          (process->mbp_sscorr_mode == MBP_SSCORR_ON &&
-           (process->mbp_sscorr_slope == MBP_SSCORR_USETOPO || process->mbp_sscorr_slope == MBP_SSCORR_USETOPOSLOPE))) {
-
-        // Check if this grid has already been read
-        bool found = false;
-        for (int i = 0; i < MB_PR_TOPOGRID_NUM_MAX; i++) {
-          if (grids_read[i]) {
-            if (strcmp(process->mbp_ampsscorr_topofile, grids[i].file) == 0) {
-              found = true;
-              grid_use = &grids[i];
-              grids_countSinceUsed[i] = 0;
-            } else {
-              grids_countSinceUsed[i]++;
-            }
-          }
-        }
-
-        // Delete any grids in memory that haven't been used recently
-        for (int i = 0; i < MB_PR_TOPOGRID_NUM_MAX; i++) {
-          if (grids_read[i] && grids_countSinceUsed[i] > MB_PR_TOPOGRID_NONUSE_MAX) {
-            mb_freed(verbose, __FILE__, __LINE__, (void **)&grids[i].data, &error);
-            memset(&grids[i], 0, sizeof(struct mbprocess_grid_struct));
-            grids_read[i] = false;
-            grids_countSinceUsed[i] = 0;
-          }
-        }
-
-        // If necessary read new grid
-        if (!found) {
-          // find the first available grid slot or delete a grid to make room
-          int igrid_use = -1;
-          int igrid_delete = -1;
-          int largest_count_since_used = -1;
-          for (int i = 0; i < MB_PR_TOPOGRID_NUM_MAX && igrid_use == -1; i++) {
-            if (!grids_read[i]) {
-              igrid_use = i;
-            } else {
-              if (grids_countSinceUsed[i] > largest_count_since_used) {
-                largest_count_since_used = grids_countSinceUsed[i];
-                igrid_delete = i;
-              }
-            }
-          }
-          if (igrid_use < 0 && igrid_delete >= 0) {
-            mb_freed(verbose, __FILE__, __LINE__, (void **)&grids[igrid_delete].data, &error);
-            memset(&grids[igrid_delete], 0, sizeof(struct mbprocess_grid_struct));
-            grids_read[igrid_delete] = false;
-            grids_countSinceUsed[igrid_delete] = 0;
-            igrid_use = igrid_delete;
-          }
-
-          // read the grid
-          if (igrid_use >= 0) {
-            grids[igrid_use].data = nullptr;
-            strcpy(grids[igrid_use].file, process->mbp_ampsscorr_topofile);
-            status = mb_read_gmt_grd(verbose, grids[igrid_use].file, &grids[igrid_use].projection_mode,
-                                    grids[igrid_use].projection_id, &grids[igrid_use].nodatavalue,
-                                    &grids[igrid_use].nxy, &grids[igrid_use].n_columns, &grids[igrid_use].n_rows,
-                                    &grids[igrid_use].min, &grids[igrid_use].max,
-                                    &grids[igrid_use].xmin, &grids[igrid_use].xmax,
-                                    &grids[igrid_use].ymin, &grids[igrid_use].ymax,
-                                    &grids[igrid_use].dx, &grids[igrid_use].dy,
-                                    &grids[igrid_use].data, nullptr, nullptr, &error);
-            if (status == MB_SUCCESS) {
-              grids_read[igrid_use] = true;
-              grids_countSinceUsed[igrid_use] = 0;
-              grid_use = &grids[igrid_use];
-            } else {
-              fprintf(stderr, "\nUnable to read topography grid file: %s\n", grids[igrid_use].file);
-              fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
-              exit(MB_ERROR_OPEN_FAIL);
-            }
-          } else {
-            fprintf(stderr, "\nUnable to clear memory to read topography grid file: %s\n", process->mbp_ampsscorr_topofile);
-            fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
-            exit(MB_ERROR_OPEN_FAIL);
-          }
-        }
-      }
-
-      // Start next processing thread
-      thread_status[n_thread_set] = MB_SUCCESS;
-      thread_error[n_thread_set] = MB_ERROR_NO_ERROR;
-      mbprocessThreads[n_thread_set]
-          = std::thread(process_file, verbose, n_thread_set, &processPars[n_thread_set], grid_use,
-                        &thread_status[n_thread_set], &thread_error[n_thread_set]);
-      n_thread_set++;
-
-    } /* end starting processing thread */
+      struct mbprocess_job_struct job;
+      job.ifile = process->mbp_ifile;
+      job.ofile = process->mbp_ofile;
+      job.format = process->mbp_format;
+      job.size = ifilesize;
+      pool->jobs.push_back(job);
+    }
 
     /* figure out whether and what to read next */
     if (read_datalist) {
@@ -6231,33 +6403,21 @@ int main(int argc, char **argv) {
       read_data = false;
     }
 
-    /* if the full number of processing threads have been started or there are no
-       more files to process, join all of the existing threads in turn until all are completed */
-    if (n_thread_set == n_threads || (!read_data && n_thread_set > 0)) {
-      for (unsigned int ithread = 0; ithread < n_thread_set; ithread++) {
-        /* join the thread (wait until it completes) */
-        mbprocessThreads[ithread].join();
-
-        // unlock the raw swath file
-        if (uselockfiles) {
-          thread_status[ithread] = mb_pr_unlockswathfile(verbose, processPars[ithread].mbp_ifile, MBP_LOCK_PROCESS,
-                                program_name, &thread_error[ithread]);
-        }
-      }
-      n_thread_set = 0;
-    }
-
   } /* end loop over datalist */
 
+  /* process the queued files */
+  mbprocess_run(pool, n_threads);
+
   /* release any grids still in memory */
   for (int i = 0; i < MB_PR_TOPOGRID_NUM_MAX; i++) {
-    if (grids_read[i]) {
-      mb_freed(verbose, __FILE__, __LINE__, (void **)&grids[i].data, &error);
-      memset(&grids[i], 0, sizeof(struct mbprocess_grid_struct));
-      grids_read[i] = false;
-      grids_countSinceUsed[i] = 0;
+    if (pool->gridcache.grids_read[i]) {
+      mb_freed(verbose, __FILE__, __LINE__, (void **)&pool->gridcache.grids[i].data, &error);
+      memset(&pool->gridcache.grids[i], 0, sizeof(struct mbprocess_grid_struct));
+      pool->gridcache.grids_read[i] = false;
+      pool->gridcache.grids_countSinceUsed[i] = 0;
     }
   }
+  delete pool;
 
   if (read_datalist)
     mb_datalist_close(verbose, &datalist, &error);
@@ -6266,6 +6426,8 @@ int main(int argc, char **argv) {
   if ((status = mb_memory_list(verbose, &error)) == MB_FAILURE) {
     fprintf(stderr, "Program %s completed but failed to deallocate all allocated memory - the code has a memory leak somewhere!\n", program_name);
   }
+  if (verbose >= 4)
+    mb_memory_sites(verbose, &error);
 
   exit(error);
 }
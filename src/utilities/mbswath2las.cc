@@ -5,7 +5,7 @@
  *    David W. Caress (caress@mbari.org)
  *      Monterey Bay Aquarium Research Institute
  *      Moss Landing, California, USA
- *    Dale N. Chayes 
+ *    Dale N. Chayes
  *      Center for Coastal and Ocean Mapping
  *      University of New Hampshire
  *      Durham, New Hampshire, USA
@@ -13,7 +13,7 @@
  *      MARUM
  *      University of Bremen
  *      Bremen Germany
- *     
+ *
  *    MB-System was created by Caress and Chayes in 1992 at the
  *      Lamont-Doherty Earth Observatory
  *      Columbia University
@@ -24,18 +24,34 @@
 /*
  * MBswath2las exports swath bathymetry data from swath files to LAS format files.
  *
+ * The unflagged soundings of all files in a datalist are projected and
+ * written as LAS 1.4 point data record format 6 to square tiles, one LAS
+ * file per tile. Each tile has its own writer, so the files are read by
+ * several threads at once while their soundings are streamed to the tiles.
+ * A LAStools compatible spatial index (*.lax) is written next to each tile
+ * so that point cloud tools can read parts of a tile.
+ *
  * Author:  D. W. Caress
  * Date:  November 26, 2020
  *
  */
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <getopt.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <unistd.h>
+#include <utility>
+#include <vector>
 
 #include "mb_define.h"
 #include "mb_format.h"
@@ -44,9 +60,630 @@
 
 constexpr char program_name[] = "mbswath2las";
 constexpr char help_message[] =
-    "MBswath2las exports swath bathymetry data from swath files to LAS format files.";
+    "MBswath2las exports swath bathymetry data from swath files to LAS format files.\n"
+    "The soundings are written to square tiles of LAS 1.4 point format 6 files,\n"
+    "each with a spatial index (*.lax).";
 constexpr char usage_message[] =
-    "mbswath2las [--input=input --output=outputfile --verbose --help]";
+    "mbswath2las [--input=input --output=root --projection=projection --tile-size=meters\n"
+    "\t--threads=nthreads --verbose --help\n"
+    "\t-Byr/mo/dy/hr/mn/sc -Eyr/mo/dy/hr/mn/sc -Fformat -Llonflip -Rw/e/s/n -Sspeed -Ttimegap]";
+
+/* LAS 1.4 header, point data record format 6 and spatial index values */
+constexpr int MBSWATH2LAS_HEADER_SIZE = 375;
+constexpr int MBSWATH2LAS_VLR_HEADER_SIZE = 54;
+constexpr int MBSWATH2LAS_POINT_FORMAT = 6;
+constexpr int MBSWATH2LAS_POINT_SIZE = 30;
+constexpr int MBSWATH2LAS_CLASS_BATHYMETRY = 40;
+constexpr double MBSWATH2LAS_SCALE = 0.001;
+constexpr double MBSWATH2LAS_SCAN_ANGLE_SCALE = 0.006;
+constexpr double MBSWATH2LAS_GPS_EPOCH = 315964800.0;
+constexpr double MBSWATH2LAS_GPS_ADJUST = 1.0e9;
+constexpr double MBSWATH2LAS_TILE_SIZE = 1000.0;
+constexpr double MBSWATH2LAS_INDEX_CELL_MIN = 10.0;
+constexpr int MBSWATH2LAS_INDEX_LEVELS_MAX = 10;
+constexpr size_t MBSWATH2LAS_BATCH_MAX = 8192;
+
+/* times (unix seconds) at which leap seconds were added since the GPS epoch */
+constexpr double mbswath2las_leap_seconds[] = {
+    362793600.0,  394329600.0,  425865600.0,  489024000.0,  567993600.0,  631152000.0,
+    662688000.0,  709948800.0,  741484800.0,  773020800.0,  820454400.0,  867715200.0,
+    915148800.0,  1136073600.0, 1230768000.0, 1341100800.0, 1435708800.0, 1483228800.0};
+
+/*--------------------------------------------------------------------*/
+/*
+ * The files are pulled from a shared list by a pool of reader threads.
+ * Each reader collects the soundings of a file into batches per tile,
+ * and hands a full batch to the tile's writer, which appends it to the
+ * tile file and adds it to the tile's spatial index under the tile mutex.
+ * The projection is shared by the readers under its own mutex.
+ */
+
+/* swath file to export */
+struct mbswath2las_file_struct {
+  std::string file;
+  int format;
+  int source_id;
+};
+
+/* projected sounding */
+struct mbswath2las_point_struct {
+  double x;
+  double y;
+  double z;
+  double gps_time;
+  double scan_angle;
+  int source_id;
+};
+
+/* LAStools compatible spatial index of a tile - a quadtree over the tile
+    with the points of each cell listed as intervals of point numbers */
+struct mbswath2las_index_struct {
+  int levels;
+  float min_x;
+  float max_x;
+  float min_y;
+  float max_y;
+  std::map<int, std::vector<std::pair<uint32_t, uint32_t>>> cells;
+  std::map<int, uint32_t> cell_points;
+};
+
+/* tile writer */
+struct mbswath2las_tile_struct {
+  std::mutex mutex; /* protects everything below */
+  mb_path path;
+  FILE *fp; /* open only while writing so that many tiles do not exhaust the file descriptors */
+  double x_offset;
+  double y_offset;
+  uint64_t npoints;
+  uint64_t nclassified;
+  double min_x;
+  double max_x;
+  double min_y;
+  double max_y;
+  double min_z;
+  double max_z;
+  mbswath2las_index_struct index;
+};
+
+/* export run shared by the reader threads */
+struct mbswath2las_run_struct {
+  int verbose;
+  int pings;
+  int lonflip;
+  double bounds[4];
+  int btime_i[7];
+  int etime_i[7];
+  double speedmin;
+  double timegap;
+  mb_path output_root;
+  double tile_size;
+  std::string wkt;
+  std::vector<mbswath2las_file_struct> files;
+  std::atomic<size_t> next_file;
+  std::mutex proj_mutex; /* protects the projection */
+  void *pjptr;
+  std::mutex tiles_mutex; /* protects the tile map, the status and the error */
+  std::map<std::pair<int, int>, mbswath2las_tile_struct *> tiles;
+  int status;
+  int error;
+};
+
+/*--------------------------------------------------------------------*/
+/*
+ * Convert unix time to LAS adjusted standard GPS time
+ */
+double mbswath2las_gps_time(double time_d) {
+  int leap_seconds = 0;
+  for (double leap_time : mbswath2las_leap_seconds)
+    if (time_d >= leap_time)
+      leap_seconds++;
+  return time_d - MBSWATH2LAS_GPS_EPOCH + leap_seconds - MBSWATH2LAS_GPS_ADJUST;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Write the LAS 1.4 public header block and the WKT coordinate system
+ * variable length record of a tile at the start of the tile file
+ */
+void mbswath2las_write_header(const struct mbswath2las_run_struct *run, struct mbswath2las_tile_struct *tile) {
+  unsigned char header[MBSWATH2LAS_HEADER_SIZE];
+  memset(header, 0, sizeof(header));
+  const int wkt_size = run->wkt.empty() ? 0 : (int)run->wkt.size() + 1;
+  const int nvlr = wkt_size > 0 ? 1 : 0;
+  const int point_offset = MBSWATH2LAS_HEADER_SIZE + nvlr * (MBSWATH2LAS_VLR_HEADER_SIZE + wkt_size);
+  time_t now = time(nullptr);
+  struct tm creation;
+  gmtime_r(&now, &creation);
+
+  memcpy(&header[0], "LASF", 4);
+  /* adjusted standard GPS time and WKT coordinate system */
+  mb_put_binary_short(true, (short)(0x0001 | 0x0010), &header[6]);
+  header[24] = 1;
+  header[25] = 4;
+  snprintf((char *)&header[26], 32, "MB-System");
+  snprintf((char *)&header[58], 32, "%s %s", program_name, MB_VERSION);
+  mb_put_binary_short(true, (short)(creation.tm_yday + 1), &header[90]);
+  mb_put_binary_short(true, (short)(creation.tm_year + 1900), &header[92]);
+  mb_put_binary_short(true, (short)MBSWATH2LAS_HEADER_SIZE, &header[94]);
+  mb_put_binary_int(true, point_offset, &header[96]);
+  mb_put_binary_int(true, nvlr, &header[100]);
+  header[104] = MBSWATH2LAS_POINT_FORMAT;
+  mb_put_binary_short(true, (short)MBSWATH2LAS_POINT_SIZE, &header[105]);
+  mb_put_binary_double(true, MBSWATH2LAS_SCALE, &header[131]);
+  mb_put_binary_double(true, MBSWATH2LAS_SCALE, &header[139]);
+  mb_put_binary_double(true, MBSWATH2LAS_SCALE, &header[147]);
+  mb_put_binary_double(true, tile->x_offset, &header[155]);
+  mb_put_binary_double(true, tile->y_offset, &header[163]);
+  mb_put_binary_double(true, 0.0, &header[171]);
+  mb_put_binary_double(true, tile->npoints > 0 ? tile->max_x : 0.0, &header[179]);
+  mb_put_binary_double(true, tile->npoints > 0 ? tile->min_x : 0.0, &header[187]);
+  mb_put_binary_double(true, tile->npoints > 0 ? tile->max_y : 0.0, &header[195]);
+  mb_put_binary_double(true, tile->npoints > 0 ? tile->min_y : 0.0, &header[203]);
+  mb_put_binary_double(true, tile->npoints > 0 ? tile->max_z : 0.0, &header[211]);
+  mb_put_binary_double(true, tile->npoints > 0 ? tile->min_z : 0.0, &header[219]);
+  mb_put_binary_long(true, (mb_s_long)tile->npoints, &header[247]);
+  /* every sounding is the first of one return */
+  mb_put_binary_long(true, (mb_s_long)tile->npoints, &header[255]);
+
+  fseek(tile->fp, 0, SEEK_SET);
+  fwrite(header, 1, MBSWATH2LAS_HEADER_SIZE, tile->fp);
+  if (nvlr > 0) {
+    unsigned char vlr[MBSWATH2LAS_VLR_HEADER_SIZE];
+    memset(vlr, 0, sizeof(vlr));
+    snprintf((char *)&vlr[2], 16, "LASF_Projection");
+    mb_put_binary_short(true, (short)2112, &vlr[18]);
+    mb_put_binary_short(true, (short)wkt_size, &vlr[20]);
+    snprintf((char *)&vlr[22], 32, "OGC coordinate system WKT");
+    fwrite(vlr, 1, MBSWATH2LAS_VLR_HEADER_SIZE, tile->fp);
+    fwrite(run->wkt.c_str(), 1, wkt_size, tile->fp);
+  }
+  fseek(tile->fp, 0, SEEK_END);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Get the quadtree cell of a point the same way LAStools does, using the
+ * single precision bounds stored in the index
+ */
+int mbswath2las_index_cell(const struct mbswath2las_index_struct *index, double x, double y) {
+  float cell_min_x = index->min_x;
+  float cell_max_x = index->max_x;
+  float cell_min_y = index->min_y;
+  float cell_max_y = index->max_y;
+  int level_index = 0;
+  int level_offset = 0;
+  for (int level = 0; level < index->levels; level++) {
+    level_offset = 4 * level_offset + 1;
+    level_index <<= 2;
+    const float cell_mid_x = (cell_min_x + cell_max_x) / 2;
+    const float cell_mid_y = (cell_min_y + cell_max_y) / 2;
+    if (x < cell_mid_x) {
+      cell_max_x = cell_mid_x;
+    }
+    else {
+      cell_min_x = cell_mid_x;
+      level_index |= 1;
+    }
+    if (y < cell_mid_y) {
+      cell_max_y = cell_mid_y;
+    }
+    else {
+      cell_min_y = cell_mid_y;
+      level_index |= 2;
+    }
+  }
+  return level_offset + level_index;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Get the writer of the tile containing x, y, creating the tile file on
+ * first use
+ */
+struct mbswath2las_tile_struct *mbswath2las_tile(struct mbswath2las_run_struct *run, double x, double y) {
+  const int ix = (int)floor(x / run->tile_size);
+  const int iy = (int)floor(y / run->tile_size);
+
+  std::lock_guard<std::mutex> lock(run->tiles_mutex);
+  auto found = run->tiles.find(std::make_pair(ix, iy));
+  if (found != run->tiles.end())
+    return found->second;
+
+  struct mbswath2las_tile_struct *tile = new mbswath2las_tile_struct;
+  tile->x_offset = ix * run->tile_size;
+  tile->y_offset = iy * run->tile_size;
+  snprintf(tile->path, sizeof(tile->path), "%s_%.0f_%.0f.las", run->output_root, tile->x_offset, tile->y_offset);
+  if ((tile->fp = fopen(tile->path, "wb")) == nullptr) {
+    fprintf(stderr, "\nUnable to open LAS tile file: %s\n", tile->path);
+    fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+    exit(MB_ERROR_OPEN_FAIL);
+  }
+  tile->npoints = 0;
+  tile->nclassified = 0;
+  tile->min_x = tile->max_x = tile->min_y = tile->max_y = tile->min_z = tile->max_z = 0.0;
+
+  /* index cells no smaller than MBSWATH2LAS_INDEX_CELL_MIN */
+  tile->index.levels = 0;
+  while (tile->index.levels < MBSWATH2LAS_INDEX_LEVELS_MAX &&
+         run->tile_size / (2 << tile->index.levels) >= MBSWATH2LAS_INDEX_CELL_MIN)
+    tile->index.levels++;
+  tile->index.min_x = (float)tile->x_offset;
+  tile->index.max_x = (float)(tile->x_offset + run->tile_size);
+  tile->index.min_y = (float)tile->y_offset;
+  tile->index.max_y = (float)(tile->y_offset + run->tile_size);
+
+  mbswath2las_write_header(run, tile);
+  if (fclose(tile->fp) != 0) {
+    fprintf(stderr, "\nError writing LAS tile file: %s\n", tile->path);
+    fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+    exit(MB_ERROR_WRITE_FAIL);
+  }
+  tile->fp = nullptr;
+  run->tiles[std::make_pair(ix, iy)] = tile;
+
+  if (run->verbose > 0)
+    fprintf(stderr, "Created tile %s\n", tile->path);
+
+  return tile;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Append a batch of soundings to a tile file and its spatial index
+ */
+void mbswath2las_tile_write(struct mbswath2las_tile_struct *tile, const std::vector<mbswath2las_point_struct> &points) {
+  std::vector<unsigned char> buffer(points.size() * MBSWATH2LAS_POINT_SIZE, 0);
+
+  std::lock_guard<std::mutex> lock(tile->mutex);
+  for (size_t i = 0; i < points.size(); i++) {
+    const struct mbswath2las_point_struct *point = &points[i];
+    unsigned char *record = &buffer[i * MBSWATH2LAS_POINT_SIZE];
+    mb_put_binary_int(true, (int)lround((point->x - tile->x_offset) / MBSWATH2LAS_SCALE), &record[0]);
+    mb_put_binary_int(true, (int)lround((point->y - tile->y_offset) / MBSWATH2LAS_SCALE), &record[4]);
+    mb_put_binary_int(true, (int)lround(point->z / MBSWATH2LAS_SCALE), &record[8]);
+    /* return 1 of 1 */
+    record[14] = 0x11;
+    record[16] = MBSWATH2LAS_CLASS_BATHYMETRY;
+    mb_put_binary_short(true, (short)lround(point->scan_angle / MBSWATH2LAS_SCAN_ANGLE_SCALE), &record[18]);
+    mb_put_binary_short(true, (short)point->source_id, &record[20]);
+    mb_put_binary_double(true, point->gps_time, &record[22]);
+
+    /* update the bounds */
+    if (tile->npoints == 0) {
+      tile->min_x = tile->max_x = point->x;
+      tile->min_y = tile->max_y = point->y;
+      tile->min_z = tile->max_z = point->z;
+    }
+    else {
+      tile->min_x = MIN(tile->min_x, point->x);
+      tile->max_x = MAX(tile->max_x, point->x);
+      tile->min_y = MIN(tile->min_y, point->y);
+      tile->max_y = MAX(tile->max_y, point->y);
+      tile->min_z = MIN(tile->min_z, point->z);
+      tile->max_z = MAX(tile->max_z, point->z);
+    }
+
+    /* add the point to its cell, extending the last interval of the cell
+        if the point directly follows it */
+    const int cell = mbswath2las_index_cell(&tile->index, point->x, point->y);
+    const uint32_t ipoint = (uint32_t)tile->npoints;
+    std::vector<std::pair<uint32_t, uint32_t>> &intervals = tile->index.cells[cell];
+    if (!intervals.empty() && intervals.back().second + 1 == ipoint)
+      intervals.back().second = ipoint;
+    else
+      intervals.emplace_back(ipoint, ipoint);
+    tile->index.cell_points[cell]++;
+    tile->npoints++;
+  }
+
+  /* reopen the tile file only for the append */
+  if ((tile->fp = fopen(tile->path, "ab")) == nullptr || fwrite(buffer.data(), 1, buffer.size(), tile->fp) != buffer.size()
+      || fclose(tile->fp) != 0) {
+    fprintf(stderr, "\nError writing LAS tile file: %s\n", tile->path);
+    fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+    exit(MB_ERROR_WRITE_FAIL);
+  }
+  tile->fp = nullptr;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Write the spatial index of a tile as a LAStools *.lax file
+ */
+int mbswath2las_write_index(const struct mbswath2las_tile_struct *tile) {
+  mb_path path;
+  snprintf(path, sizeof(path), "%.*sx", (int)strlen(tile->path) - 1, tile->path);
+  FILE *fp = fopen(path, "wb");
+  if (fp == nullptr)
+    return MB_FAILURE;
+
+  unsigned char buffer[12];
+  auto put_int = [&](int value) {
+    mb_put_binary_int(true, value, buffer);
+    fwrite(buffer, 1, 4, fp);
+  };
+  auto put_float = [&](float value) {
+    mb_put_binary_float(true, value, buffer);
+    fwrite(buffer, 1, 4, fp);
+  };
+
+  /* index, quadtree and interval signatures are each followed by version 0 */
+  fwrite("LASX", 1, 4, fp);
+  put_int(0);
+  fwrite("LASS", 1, 4, fp);
+  put_int(0);
+  fwrite("LASQ", 1, 4, fp);
+  put_int(0);
+  put_int(tile->index.levels);
+  put_int(0);
+  put_int(0);
+  put_float(tile->index.min_x);
+  put_float(tile->index.max_x);
+  put_float(tile->index.min_y);
+  put_float(tile->index.max_y);
+  fwrite("LASV", 1, 4, fp);
+  put_int(0);
+  put_int((int)tile->index.cells.size());
+  for (const auto &cell : tile->index.cells) {
+    put_int(cell.first);
+    put_int((int)cell.second.size());
+    put_int((int)tile->index.cell_points.at(cell.first));
+    for (const auto &interval : cell.second) {
+      put_int((int)interval.first);
+      put_int((int)interval.second);
+    }
+  }
+
+  const int status = ferror(fp) ? MB_FAILURE : MB_SUCCESS;
+  fclose(fp);
+  return status;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Reader thread - exports the soundings of listed files until the list
+ * is exhausted
+ */
+void mbswath2las_worker(struct mbswath2las_run_struct *run) {
+  const int verbose = run->verbose;
+  std::map<struct mbswath2las_tile_struct *, std::vector<mbswath2las_point_struct>> batches;
+
+  while (true) {
+    const size_t ifile = run->next_file++;
+    if (ifile >= run->files.size())
+      break;
+    const struct mbswath2las_file_struct *job = &run->files[ifile];
+
+    /* MBIO read values */
+    void *mbio_ptr = nullptr;
+    void *store_ptr = nullptr;
+    mb_path file;
+    double btime_d;
+    double etime_d;
+    int beams_bath;
+    int beams_amp;
+    int pixels_ss;
+    int kind;
+    int time_i[7];
+    double time_d;
+    double navlon;
+    double navlat;
+    double speed;
+    double heading;
+    double distance;
+    double altitude;
+    double sensordepth;
+    char *beamflag = nullptr;
+    double *bath = nullptr;
+    double *bathacrosstrack = nullptr;
+    double *bathalongtrack = nullptr;
+    double *amp = nullptr;
+    double *ss = nullptr;
+    double *ssacrosstrack = nullptr;
+    double *ssalongtrack = nullptr;
+    char comment[MB_COMMENT_MAXLINE];
+    int error = MB_ERROR_NO_ERROR;
+
+    /* initialize reading the swath file */
+    strcpy(file, job->file.c_str());
+    double bounds[4] = {run->bounds[0], run->bounds[1], run->bounds[2], run->bounds[3]};
+    int btime_i[7];
+    int etime_i[7];
+    memcpy(btime_i, run->btime_i, sizeof(btime_i));
+    memcpy(etime_i, run->etime_i, sizeof(etime_i));
+    if (mb_read_init(verbose, file, job->format, run->pings, run->lonflip, bounds, btime_i, etime_i, run->speedmin,
+                     run->timegap, &mbio_ptr, &btime_d, &etime_d, &beams_bath, &beams_amp, &pixels_ss,
+                     &error) != MB_SUCCESS) {
+      char *message;
+      mb_error(verbose, error, &message);
+      fprintf(stderr, "\nMBIO Error returned from function <mb_read_init>:\n%s\n", message);
+      fprintf(stderr, "\nMultibeam File <%s> not initialized for reading\n", file);
+      std::lock_guard<std::mutex> lock(run->tiles_mutex);
+      run->status = MB_FAILURE;
+      run->error = error;
+      continue;
+    }
+
+    /* allocate memory for data arrays */
+    if (error == MB_ERROR_NO_ERROR)
+      mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char), (void **)&beamflag, &error);
+    if (error == MB_ERROR_NO_ERROR)
+      mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bath, &error);
+    if (error == MB_ERROR_NO_ERROR)
+      mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double), (void **)&amp, &error);
+    if (error == MB_ERROR_NO_ERROR)
+      mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathacrosstrack, &error);
+    if (error == MB_ERROR_NO_ERROR)
+      mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathalongtrack, &error);
+    if (error == MB_ERROR_NO_ERROR)
+      mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ss, &error);
+    if (error == MB_ERROR_NO_ERROR)
+      mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssacrosstrack, &error);
+    if (error == MB_ERROR_NO_ERROR)
+      mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssalongtrack, &error);
+
+    /* if error initializing memory then quit */
+    if (error != MB_ERROR_NO_ERROR) {
+      char *message;
+      mb_error(verbose, error, &message);
+      fprintf(stderr, "\nMBIO Error allocating data arrays:\n%s\n", message);
+      fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+      exit(error);
+    }
+
+    /* read and export the soundings */
+    std::vector<double> lon;
+    std::vector<double> lat;
+    std::vector<int> ibeam;
+    int npings = 0;
+    int nsoundings = 0;
+    while (error <= MB_ERROR_NO_ERROR) {
+      /* reset error */
+      error = MB_ERROR_NO_ERROR;
+
+      /* read next data record */
+      mb_get_all(verbose, mbio_ptr, &store_ptr, &kind, time_i, &time_d, &navlon, &navlat, &speed, &heading, &distance,
+                 &altitude, &sensordepth, &beams_bath, &beams_amp, &pixels_ss, beamflag, bath, amp, bathacrosstrack,
+                 bathalongtrack, ss, ssacrosstrack, ssalongtrack, comment, &error);
+
+      /* time gaps are not a problem here */
+      if (error == MB_ERROR_TIME_GAP)
+        error = MB_ERROR_NO_ERROR;
+
+      /* make sure non survey data records are ignored */
+      if (error != MB_ERROR_NO_ERROR || kind != MB_DATA_DATA)
+        continue;
+      npings++;
+
+      /* get the positions of the unflagged soundings */
+      double mtodeglon;
+      double mtodeglat;
+      mb_coor_scale(verbose, navlat, &mtodeglon, &mtodeglat);
+      const double headingx = sin(DTR * heading);
+      const double headingy = cos(DTR * heading);
+      lon.clear();
+      lat.clear();
+      ibeam.clear();
+      for (int j = 0; j < beams_bath; j++) {
+        if (mb_beam_ok(beamflag[j])) {
+          lon.push_back(navlon + headingy * mtodeglon * bathacrosstrack[j] + headingx * mtodeglon * bathalongtrack[j]);
+          lat.push_back(navlat - headingx * mtodeglat * bathacrosstrack[j] + headingy * mtodeglat * bathalongtrack[j]);
+          ibeam.push_back(j);
+        }
+      }
+
+      /* project the soundings and add them to the tile batches */
+      std::vector<double> x(ibeam.size());
+      std::vector<double> y(ibeam.size());
+      {
+        std::lock_guard<std::mutex> lock(run->proj_mutex);
+        for (size_t i = 0; i < ibeam.size(); i++)
+          mb_proj_forward(verbose, run->pjptr, lon[i], lat[i], &x[i], &y[i], &error);
+      }
+      const double gps_time = mbswath2las_gps_time(time_d);
+      for (size_t i = 0; i < ibeam.size(); i++) {
+        const int j = ibeam[i];
+        struct mbswath2las_point_struct point;
+        point.x = x[i];
+        point.y = y[i];
+        point.z = -bath[j];
+        point.gps_time = gps_time;
+        point.scan_angle = RTD * atan2(bathacrosstrack[j], bath[j] - sensordepth);
+        point.source_id = job->source_id;
+        struct mbswath2las_tile_struct *tile = mbswath2las_tile(run, point.x, point.y);
+        std::vector<mbswath2las_point_struct> &batch = batches[tile];
+        batch.push_back(point);
+        if (batch.size() >= MBSWATH2LAS_BATCH_MAX) {
+          mbswath2las_tile_write(tile, batch);
+          batch.clear();
+        }
+      }
+      nsoundings += ibeam.size();
+      error = MB_ERROR_NO_ERROR;
+    }
+
+    /* hand over the rest of the soundings of this file */
+    for (auto &batch : batches) {
+      if (!batch.second.empty()) {
+        mbswath2las_tile_write(batch.first, batch.second);
+        batch.second.clear();
+      }
+    }
+
+    /* close the swath file */
+    mb_close(verbose, &mbio_ptr, &error);
+
+    if (verbose > 0)
+      fprintf(stderr, "%d soundings from %d pings exported from %s\n", nsoundings, npings, file);
+  }
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Get the navigation of the first survey record of a swath file
+ */
+int mbswath2las_first_position(struct mbswath2las_run_struct *run, const struct mbswath2las_file_struct *job, double *navlon,
+                               double *navlat, int *error) {
+  const int verbose = run->verbose;
+  void *mbio_ptr = nullptr;
+  mb_path file;
+  strcpy(file, job->file.c_str());
+  double bounds[4] = {run->bounds[0], run->bounds[1], run->bounds[2], run->bounds[3]};
+  int btime_i[7];
+  int etime_i[7];
+  memcpy(btime_i, run->btime_i, sizeof(btime_i));
+  memcpy(etime_i, run->etime_i, sizeof(etime_i));
+  double btime_d;
+  double etime_d;
+  int beams_bath;
+  int beams_amp;
+  int pixels_ss;
+  if (mb_read_init(verbose, file, job->format, 1, run->lonflip, bounds, btime_i, etime_i, run->speedmin, run->timegap,
+                   &mbio_ptr, &btime_d, &etime_d, &beams_bath, &beams_amp, &pixels_ss, error) != MB_SUCCESS)
+    return MB_FAILURE;
+
+  char *beamflag = nullptr;
+  double *bath = nullptr;
+  double *bathacrosstrack = nullptr;
+  double *bathalongtrack = nullptr;
+  double *amp = nullptr;
+  double *ss = nullptr;
+  double *ssacrosstrack = nullptr;
+  double *ssalongtrack = nullptr;
+  mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char), (void **)&beamflag, error);
+  mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bath, error);
+  mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double), (void **)&amp, error);
+  mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathacrosstrack, error);
+  mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathalongtrack, error);
+  mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ss, error);
+  mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssacrosstrack, error);
+  mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssalongtrack, error);
+
+  int status = MB_FAILURE;
+  int kind = MB_DATA_NONE;
+  while (*error <= MB_ERROR_NO_ERROR && status == MB_FAILURE) {
+    *error = MB_ERROR_NO_ERROR;
+    void *store_ptr = nullptr;
+    int time_i[7];
+    double time_d;
+    double speed;
+    double heading;
+    double distance;
+    double altitude;
+    double sensordepth;
+    char comment[MB_COMMENT_MAXLINE];
+    mb_get_all(verbose, mbio_ptr, &store_ptr, &kind, time_i, &time_d, navlon, navlat, &speed, &heading, &distance,
+               &altitude, &sensordepth, &beams_bath, &beams_amp, &pixels_ss, beamflag, bath, amp, bathacrosstrack,
+               bathalongtrack, ss, ssacrosstrack, ssalongtrack, comment, error);
+    if ((*error == MB_ERROR_NO_ERROR || *error == MB_ERROR_TIME_GAP) && kind == MB_DATA_DATA)
+      status = MB_SUCCESS;
+  }
+  int close_error = MB_ERROR_NO_ERROR;
+  mb_close(verbose, &mbio_ptr, &close_error);
+  if (status == MB_SUCCESS)
+    *error = MB_ERROR_NO_ERROR;
+  return status;
+}
 
 /*--------------------------------------------------------------------*/
 
@@ -54,7 +691,6 @@ int main(int argc, char **argv) {
   int verbose = 0;
   int format;
   int pings;
-  int pings_read;
   int lonflip;
   double bounds[4];
   int btime_i[7];
@@ -63,35 +699,55 @@ int main(int argc, char **argv) {
   double timegap;
   int status = mb_defaults(verbose, &format, &pings, &lonflip, bounds, btime_i, etime_i, &speedmin, &timegap);
 
-  bool input_datalist = true;
   char read_file[MB_PATH_MAXLINE] = "datalist.mb-1";
+  char output_root[MB_PATH_MAXLINE] = "mbswath2las";
   char projection_pars[MB_PATH_MAXLINE] = "";
-  bool use_projection = false;
-
-  /* swathbounds variables */
-  int beam_port = 0;
-  int beam_stbd = 0;
-  int pixel_port = 0;
-  int pixel_stbd = 0;
-
-  /* projected coordinate system */
-  char projection_id[MB_PATH_MAXLINE] = "";
-  int proj_status;
-  void *pjptr = nullptr;
-  double reference_lon, reference_lat;
-  int utm_zone;
-  double naveasting, navnorthing, deasting, dnorthing;
-  double headingx, headingy, mtodeglon, mtodeglat;
+  double tile_size = MBSWATH2LAS_TILE_SIZE;
+  unsigned int n_threads = 1;
 
   /* process argument list */
   {
+    const struct option options[] = {{"verbose", no_argument, nullptr, 0},
+                                     {"help", no_argument, nullptr, 0},
+                                     {"input", required_argument, nullptr, 0},
+                                     {"output", required_argument, nullptr, 0},
+                                     {"projection", required_argument, nullptr, 0},
+                                     {"tile-size", required_argument, nullptr, 0},
+                                     {"threads", required_argument, nullptr, 0},
+                                     {nullptr, 0, nullptr, 0}};
+    int option_index;
     bool errflg = false;
     bool help = false;
     int c;
-    while ((c = getopt(argc, argv, "B:b:E:e:F:f:I:i:J:j:L:l:R:r:S:s:T:t:VvHh")) !=
-           -1)
+    while ((c = getopt_long(argc, argv, "B:b:E:e:F:f:I:i:J:j:L:l:O:o:R:r:S:s:T:t:VvHh", options, &option_index)) != -1)
     {
       switch (c) {
+      /* long options */
+      case 0:
+        if (strcmp("verbose", options[option_index].name) == 0) {
+          verbose++;
+        }
+        else if (strcmp("help", options[option_index].name) == 0) {
+          help = true;
+        }
+        else if (strcmp("input", options[option_index].name) == 0) {
+          sscanf(optarg, "%1023s", read_file);
+        }
+        else if (strcmp("output", options[option_index].name) == 0) {
+          sscanf(optarg, "%1023s", output_root);
+        }
+        else if (strcmp("projection", options[option_index].name) == 0) {
+          sscanf(optarg, "%1023s", projection_pars);
+        }
+        else if (strcmp("tile-size", options[option_index].name) == 0) {
+          sscanf(optarg, "%lf", &tile_size);
+        }
+        else if (strcmp("threads", options[option_index].name) == 0) {
+          sscanf(optarg, "%u", &n_threads);
+        }
+        break;
+
+      /* short options */
       case 'H':
       case 'h':
         help = true;
@@ -121,12 +777,15 @@ int main(int argc, char **argv) {
       case 'J':
       case 'j':
         sscanf(optarg, "%1023s", projection_pars);
-        use_projection = true;
         break;
       case 'L':
       case 'l':
         sscanf(optarg, "%d", &lonflip);
         break;
+      case 'O':
+      case 'o':
+        sscanf(optarg, "%1023s", output_root);
+        break;
       case 'R':
       case 'r':
         mb_get_bounds(optarg, bounds);
@@ -144,6 +803,11 @@ int main(int argc, char **argv) {
       }
     }
 
+    if (tile_size <= 0.0) {
+      fprintf(stderr, "\nThe tile size must be positive: %f\n", tile_size);
+      errflg = true;
+    }
+
     if (errflg) {
       fprintf(stderr, "usage: %s\n", usage_message);
       fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
@@ -183,6 +847,11 @@ int main(int argc, char **argv) {
       fprintf(stderr, "dbg2       etime_i[6]:     %d\n", etime_i[6]);
       fprintf(stderr, "dbg2       speedmin:       %f\n", speedmin);
       fprintf(stderr, "dbg2       timegap:        %f\n", timegap);
+      fprintf(stderr, "dbg2       read_file:      %s\n", read_file);
+      fprintf(stderr, "dbg2       output_root:    %s\n", output_root);
+      fprintf(stderr, "dbg2       projection:     %s\n", projection_pars);
+      fprintf(stderr, "dbg2       tile_size:      %f\n", tile_size);
+      fprintf(stderr, "dbg2       n_threads:      %u\n", n_threads);
     }
 
     if (help) {
@@ -194,222 +863,156 @@ int main(int argc, char **argv) {
 
   int error = MB_ERROR_NO_ERROR;
 
+  struct mbswath2las_run_struct run;
+  run.verbose = verbose;
+  run.pings = pings;
+  run.lonflip = lonflip;
+  memcpy(run.bounds, bounds, sizeof(bounds));
+  memcpy(run.btime_i, btime_i, sizeof(btime_i));
+  memcpy(run.etime_i, etime_i, sizeof(etime_i));
+  run.speedmin = speedmin;
+  run.timegap = timegap;
+  strcpy(run.output_root, output_root);
+  run.tile_size = tile_size;
+  run.pjptr = nullptr;
+  run.status = MB_SUCCESS;
+  run.error = MB_ERROR_NO_ERROR;
+
   if (format == 0)
     mb_get_format(verbose, read_file, nullptr, &format, &error);
 
-  /* determine whether to read one file or a list of files */
-  const bool read_datalist = format < 0;
-  bool read_data;
-  void *datalist;
-  char file[MB_PATH_MAXLINE] = "";
-  char dfile[MB_PATH_MAXLINE] = "";
-  double file_weight;
-
-  /* open file list */
-  if (read_datalist) {
+  /* list the files to be read, numbering them as LAS point sources */
+  if (format < 0) {
+    void *datalist;
+    char file[MB_PATH_MAXLINE] = "";
+    char dfile[MB_PATH_MAXLINE] = "";
+    double file_weight;
     const int look_processed = MB_DATALIST_LOOK_UNSET;
     if (mb_datalist_open(verbose, &datalist, read_file, look_processed, &error) != MB_SUCCESS) {
       fprintf(stderr, "\nUnable to open data list file: %s\n", read_file);
       fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
       exit(MB_ERROR_OPEN_FAIL);
     }
-    read_data = mb_datalist_read(verbose, datalist, file, dfile, &format, &file_weight, &error) == MB_SUCCESS;
-  } else {
-    // else copy single filename to be read
-    strcpy(file, read_file);
-    read_data = true;
+    while (mb_datalist_read(verbose, datalist, file, dfile, &format, &file_weight, &error) == MB_SUCCESS) {
+      const int source_id = (int)(run.files.size() % 65535) + 1;
+      run.files.push_back({file, format, source_id});
+    }
+    mb_datalist_close(verbose, &datalist, &error);
+  }
+  else {
+    run.files.push_back({read_file, format, 1});
+  }
+  error = MB_ERROR_NO_ERROR;
+  if (run.files.empty()) {
+    fprintf(stderr, "\nNo swath files to export from %s\n", read_file);
+    fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+    exit(MB_ERROR_NO_DATA_LOADED);
   }
 
-  double btime_d;
-  double etime_d;
-  int beams_bath;
-  int beams_amp;
-  int pixels_ss;
-
-  /* MBIO read values */
-  void *mbio_ptr = nullptr;
-  void *store_ptr = nullptr;
-  int kind;
-  int time_i[7];
-  double time_d;
-  double navlon;
-  double navlat;
-  double speed;
-  double heading;
-  double distance;
-  double altitude;
-  double sensordepth;
-  double draft;
-  double roll;
-  double pitch;
-  double heave;
-  char *beamflag = nullptr;
-  double *bath = nullptr;
-  double *bathacrosstrack = nullptr;
-  double *bathalongtrack = nullptr;
-  int *detect = nullptr;
-  double *amp = nullptr;
-  double *ss = nullptr;
-  double *ssacrosstrack = nullptr;
-  double *ssalongtrack = nullptr;
-  char comment[MB_COMMENT_MAXLINE];
-  int icomment = 0;
-
-  /* loop over all files to be read */
-  while (read_data) {
-
-    /* initialize reading the swath file */
-    if (mb_read_init(verbose, file, format, pings, lonflip, bounds, btime_i, etime_i, speedmin, timegap, &mbio_ptr,
-                               &btime_d, &etime_d, &beams_bath, &beams_amp, &pixels_ss, &error) != MB_SUCCESS) {
-      char *message;
-      mb_error(verbose, error, &message);
-      fprintf(stderr, "\nMBIO Error returned from function <mb_read_init>:\n%s\n", message);
-      fprintf(stderr, "\nMultibeam File <%s> not initialized for reading\n", file);
+  /* set up the projection - the default is UTM with the zone of the first
+      survey record */
+  char projection_id[MB_PATH_MAXLINE] = "";
+  if (strlen(projection_pars) == 0)
+    strcpy(projection_pars, "U");
+  if (strcmp(projection_pars, "UTM") == 0 || strcmp(projection_pars, "U") == 0 || strcmp(projection_pars, "utm") == 0 ||
+      strcmp(projection_pars, "u") == 0) {
+    double reference_lon = 0.0;
+    double reference_lat = 0.0;
+    bool found = false;
+    for (size_t i = 0; i < run.files.size() && !found; i++)
+      found = mbswath2las_first_position(&run, &run.files[i], &reference_lon, &reference_lat, &error) == MB_SUCCESS;
+    if (!found) {
+      fprintf(stderr, "\nNo survey data found to choose the UTM zone\n");
       fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
-      exit(error);
+      exit(MB_ERROR_NO_DATA_LOADED);
     }
+    if (reference_lon < 180.0)
+      reference_lon += 360.0;
+    if (reference_lon >= 180.0)
+      reference_lon -= 360.0;
+    const int utm_zone = (int)(((reference_lon + 183.0) / 6.0) + 0.5);
+    if (reference_lat >= 0.0)
+      snprintf(projection_id, sizeof(projection_id), "UTM%2.2dN", utm_zone);
+    else
+      snprintf(projection_id, sizeof(projection_id), "UTM%2.2dS", utm_zone);
+  }
+  else {
+    strcpy(projection_id, projection_pars);
+  }
+  if (mb_proj_init(verbose, projection_id, &run.pjptr, &error) != MB_SUCCESS) {
+    fprintf(stderr, "\nOutput projection %s not found in database\n", projection_id);
+    fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+    error = MB_ERROR_BAD_PARAMETER;
+    mb_memory_clear(verbose, &error);
+    exit(MB_ERROR_BAD_PARAMETER);
+  }
+  char wkt[4 * MB_PATH_MAXLINE] = "";
+  if (mb_proj_wkt(verbose, run.pjptr, wkt, sizeof(wkt), &error) == MB_SUCCESS) {
+    run.wkt = wkt;
+  }
+  else {
+    fprintf(stderr, "\nWarning: unable to describe projection %s as WKT, the LAS files will lack a coordinate system\n",
+            projection_id);
+    error = MB_ERROR_NO_ERROR;
+  }
+  if (verbose > 0)
+    fprintf(stderr, "Exporting %zu files with projection %s to tiles of %.1f m\n", run.files.size(), projection_id,
+            tile_size);
 
-    /* allocate memory for data arrays */
-    if (error == MB_ERROR_NO_ERROR)
-      /* status &= */ mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char), (void **)&beamflag, &error);
-    if (error == MB_ERROR_NO_ERROR)
-      /* status &= */ mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bath, &error);
-    if (error == MB_ERROR_NO_ERROR)
-      /* status &= */ mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double), (void **)&amp, &error);
-    if (error == MB_ERROR_NO_ERROR)
-      /* status &= */
-          mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathacrosstrack, &error);
-    if (error == MB_ERROR_NO_ERROR)
-      /* status &= */
-          mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double), (void **)&bathalongtrack, &error);
-    if (error == MB_ERROR_NO_ERROR)
-      /* status &= */ mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ss, &error);
-    if (error == MB_ERROR_NO_ERROR)
-      /* status &= */ mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssacrosstrack, &error);
-    if (error == MB_ERROR_NO_ERROR)
-      /* status &= */ mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double), (void **)&ssalongtrack, &error);
+  /* read the files with a pool of threads */
+  const unsigned int n_concurrency = std::thread::hardware_concurrency();
+  if (n_concurrency > 0)
+    n_threads = MIN(n_threads, n_concurrency);
+  n_threads = MAX(1, MIN(n_threads, MB_THREAD_MAX));
+  n_threads = MIN(n_threads, (unsigned int)run.files.size());
+  run.next_file = 0;
+  if (n_threads > 1) {
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < n_threads; i++)
+      threads.emplace_back(mbswath2las_worker, &run);
+    for (unsigned int i = 0; i < n_threads; i++)
+      threads[i].join();
+  }
+  else {
+    mbswath2las_worker(&run);
+  }
 
-    /* if error initializing memory then quit */
-    if (error != MB_ERROR_NO_ERROR) {
-      char *message;
-      mb_error(verbose, error, &message);
-      fprintf(stderr, "\nMBIO Error allocating data arrays:\n%s\n", message);
-      fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
-      exit(error);
+  /* finish the tiles - rewrite the headers with the final counts and
+      bounds and write the spatial indexes */
+  uint64_t npoints = 0;
+  for (auto &entry : run.tiles) {
+    struct mbswath2las_tile_struct *tile = entry.second;
+    if ((tile->fp = fopen(tile->path, "r+b")) == nullptr) {
+      fprintf(stderr, "\nUnable to open LAS tile file: %s\n", tile->path);
+      run.status = MB_FAILURE;
+      run.error = MB_ERROR_OPEN_FAIL;
     }
-
-    /* read and print data */
-    int nread = 0;
-    bool first = true;
-    while (error <= MB_ERROR_NO_ERROR) {
-      /* reset error */
-      error = MB_ERROR_NO_ERROR;
-
-      /* read next data record */
-      status = mb_get_all(verbose, mbio_ptr, &store_ptr, &kind, time_i, &time_d, &navlon, &navlat, &speed, &heading,
-                          &distance, &altitude, &sensordepth, &beams_bath, &beams_amp, &pixels_ss, beamflag, bath, amp,
-                          bathacrosstrack, bathalongtrack, ss, ssacrosstrack, ssalongtrack, comment, &error);
-
-      /* time gaps are not a problem here */
-      if (error == MB_ERROR_TIME_GAP) {
-        error = MB_ERROR_NO_ERROR;
-        status = MB_SUCCESS;
-      }
-
-      /* if survey data extract nav */
-      if (error == MB_ERROR_NO_ERROR && kind == MB_DATA_DATA)
-        status = mb_extract_nav(verbose, mbio_ptr, store_ptr, &kind, time_i, &time_d, &navlon, &navlat, &speed,
-                                &heading, &draft, &roll, &pitch, &heave, &error);
-
-      /* make sure non survey data records are ignored */
-      if (error == MB_ERROR_NO_ERROR && kind != MB_DATA_DATA)
-        error = MB_ERROR_OTHER;
-
-      /* get projected navigation if needed */
-      if (error <= MB_ERROR_NO_ERROR && kind == MB_DATA_DATA && use_projection) {
-        /* set up projection if this is the first data */
-        if (pjptr == nullptr) {
-          /* Default projection is UTM */
-          if (strlen(projection_pars) == 0)
-            strcpy(projection_pars, "U");
-
-          /* check for UTM with undefined zone */
-          if (strcmp(projection_pars, "UTM") == 0 || strcmp(projection_pars, "U") == 0 ||
-              strcmp(projection_pars, "utm") == 0 || strcmp(projection_pars, "u") == 0) {
-            reference_lon = navlon;
-            if (reference_lon < 180.0)
-              reference_lon += 360.0;
-            if (reference_lon >= 180.0)
-              reference_lon -= 360.0;
-            utm_zone = (int)(((reference_lon + 183.0) / 6.0) + 0.5);
-            reference_lat = navlat;
-            if (reference_lat >= 0.0)
-              snprintf(projection_id, sizeof(projection_id), "UTM%2.2dN", utm_zone);
-            else
-              snprintf(projection_id, sizeof(projection_id), "UTM%2.2dS", utm_zone);
-          }
-          else
-            strcpy(projection_id, projection_pars);
-
-          /* set projection flag */
-          proj_status = mb_proj_init(verbose, projection_id, &(pjptr), &error);
-
-          /* if projection not successfully initialized then quit */
-          if (proj_status != MB_SUCCESS) {
-            fprintf(stderr, "\nOutput projection %s not found in database\n", projection_id);
-            fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
-            error = MB_ERROR_BAD_PARAMETER;
-            mb_memory_clear(verbose, &error);
-            exit(MB_ERROR_BAD_PARAMETER);
-          }
-        }
-
-        /* get projected navigation */
-        mb_proj_forward(verbose, pjptr, navlon, navlat, &naveasting, &navnorthing, &error);
-      }
-
-      if (verbose >= 2) {
-        fprintf(stderr, "\ndbg2  Ping read in program <%s>\n", program_name);
-        fprintf(stderr, "dbg2       kind:           %d\n", kind);
-        fprintf(stderr, "dbg2       error:          %d\n", error);
-        fprintf(stderr, "dbg2       status:         %d\n", status);
-      }
-
-      if (verbose >= 1 && kind == MB_DATA_COMMENT) {
-        if (icomment == 0) {
-          fprintf(stderr, "\nComments:\n");
-          icomment++;
-        }
-        fprintf(stderr, "%s\n", comment);
-      }
-
-      /* get factors for lon lat calculations */
-      if (error == MB_ERROR_NO_ERROR) {
-        mb_coor_scale(verbose, navlat, &mtodeglon, &mtodeglat);
-        headingx = sin(DTR * heading);
-        headingy = cos(DTR * heading);
+    else {
+      mbswath2las_write_header(&run, tile);
+      if (fclose(tile->fp) != 0) {
+        fprintf(stderr, "\nError writing LAS tile file: %s\n", tile->path);
+        run.status = MB_FAILURE;
+        run.error = MB_ERROR_WRITE_FAIL;
       }
-
-      /* now loop over beams */
-      if (error == MB_ERROR_NO_ERROR)
-        for (int j = 0; j <= beams_bath; j++) {
-        }
+      tile->fp = nullptr;
     }
-
-    /* close the swath file */
-    status &= mb_close(verbose, &mbio_ptr, &error);
-
-    /* figure out whether and what to read next */
-    if (read_datalist) {
-      read_data = mb_datalist_read(verbose, datalist, file, dfile, &format, &file_weight, &error) == MB_SUCCESS;
-    } else {
-      read_data = false;
+    if (mbswath2las_write_index(tile) != MB_SUCCESS) {
+      fprintf(stderr, "\nError writing spatial index of LAS tile file: %s\n", tile->path);
+      run.status = MB_FAILURE;
+      run.error = MB_ERROR_WRITE_FAIL;
     }
-
-    /* end loop over files in list */
+    if (verbose > 0)
+      fprintf(stderr, "%llu soundings written to %s\n", (unsigned long long)tile->npoints, tile->path);
+    npoints += tile->npoints;
+    delete tile;
   }
-  if (read_datalist)
-    mb_datalist_close(verbose, &datalist, &error);
+  if (verbose > 0)
+    fprintf(stderr, "\n%llu soundings written to %zu tiles\n", (unsigned long long)npoints, run.tiles.size());
+  run.tiles.clear();
+
+  mb_proj_free(verbose, &run.pjptr, &error);
+  status = run.status;
+  error = run.error;
 
   if (verbose >= 4)
     status &= mb_memory_list(verbose, &error);
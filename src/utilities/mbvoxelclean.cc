@@ -31,10 +31,14 @@
  * applied to the data by the program mbprocess. These are the same edit save
  * files created and/or modified by mbvoxelclean and mbedit.
  * The input data are one swath file or a datalist referencing multiple
- * swath files. Each file is read and processed separately.
+ * swath files. Each file is read and processed separately unless the
+ * --survey option is given, in which case all of the files are read first
+ * and the soundings of overlapping files count toward the same voxels.
  * The rectangular prism including all of the flagged and unflagged soundings
  * is divided into 3D voxels of the specified size. All of the soundings are
- * read into memory and associated with one of the voxels. Once all of
+ * read into memory and associated with one of the voxels. Only voxels
+ * containing soundings are stored, and the voxel space is split between
+ * the --threads threads along the x axis. Once all of
  * data are read, a density filter is applied such that containing more than a
  * specified threshold of soundings are considered to be occupied by a valid target and
  * voxels containing less than the threshold are considered to be empty.
@@ -53,13 +57,16 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <getopt.h>
 #include <sys/stat.h>
+#include <thread>
 #include <unistd.h>
+#include <vector>
 
 #include "mb_define.h"
 #include "mb_format.h"
@@ -98,6 +105,88 @@ typedef enum {
     MBVC_OCCUPIED_UNFLAG = 1,
 } occupied_mode_t;
 
+/* sounding and edit counts of a file or of the whole run */
+struct mbvoxelclean_count_struct {
+  int n_files;
+  int n_pings;
+  int n_beams;
+  int n_beamflag_null;
+  int n_beamflag_good;
+  int n_beamflag_flag;
+  int n_esf_flag;
+  int n_esf_unflag;
+  int n_density_flag;
+  int n_density_unflag;
+  int n_minrange_flag;
+  int n_maxrange_flag;
+  int n_minacrosstrack_flag;
+  int n_maxacrosstrack_flag;
+  int n_minamplitude_flag;
+  int n_maxamplitude_flag;
+};
+
+/* swath file being cleaned */
+struct mbvoxelclean_file_struct {
+  mb_path swathfile;
+  int format;
+  mb_path esffile;
+  struct mb_esf_struct esf;
+  bool esffile_open;
+  int n_pings;
+  int npings_alloc;
+  struct mbvoxelclean_ping_struct *pings;
+  bool bounds_set;
+  double x_min;
+  double x_max;
+  double y_min;
+  double y_max;
+  double z_min;
+  double z_max;
+  struct mbvoxelclean_count_struct count;
+};
+
+/* control parameters */
+struct mbvoxelclean_control_struct {
+  int verbose;
+  FILE *outfp;
+  int defaultpings;
+  int lonflip;
+  double bounds[4];
+  int btime_i[7];
+  int etime_i[7];
+  double speedmin;
+  double timegap;
+  bool uselockfiles;
+  double voxel_size_xy;
+  double voxel_size_z;
+  int occupy_threshold;
+  bool count_flagged;
+  empty_mode_t empty_mode;
+  occupied_mode_t occupied_mode;
+  int neighborhood;
+  bool apply_range_minimum;
+  double range_minimum;
+  bool apply_range_maximum;
+  double range_maximum;
+  bool apply_acrosstrack_minimum;
+  double acrosstrack_minimum;
+  bool apply_acrosstrack_maximum;
+  double acrosstrack_maximum;
+  bool apply_amplitude_minimum;
+  double amplitude_minimum;
+  bool apply_amplitude_maximum;
+  double amplitude_maximum;
+  bool survey;
+  unsigned int n_threads;
+
+  /* local cartesian coordinate system shared by the files cleaned together */
+  bool origin_set;
+  double origin_lon;
+  double origin_lat;
+  double mtodeglon;
+  double mtodeglat;
+};
+
 constexpr char program_name[] = "mbvoxelclean";
 constexpr char help_message[] =
     "mbvoxelclean parses recursive datalist files and outputs the\n"
@@ -118,6 +207,8 @@ constexpr char usage_message[] =
     "\t--unflag-occupied\n"
     "\t--ignore-occupied\n"
     "\t--neighborhood=value\n"
+    "\t--survey\n"
+    "\t--threads=value\n"
     "\t--range-minimum=value\n"
     "\t--range-maximum=value]\n"
     "\t--acrosstrack-minimum=value\n"
@@ -125,6 +216,1063 @@ constexpr char usage_message[] =
     "\t--amplitude-minimum=value\n"
     "\t--amplitude-maximum=value]";
 
+/*--------------------------------------------------------------------*/
+/*
+ * Sparse voxel storage
+ *
+ * Only the voxels that contain soundings are stored, in open addressing
+ * hash tables keyed by the packed voxel indices, so the memory used is
+ * proportional to the number of occupied voxels rather than to the volume
+ * of the bounding prism. The voxel space is divided into slabs along the
+ * x axis, one hash table per slab, and each thread owns one slab: a thread
+ * counts only the soundings falling in its own slab and decides occupancy
+ * only for its own voxels, reading the other slabs when a neighborhood
+ * extends across a slab boundary.
+ */
+
+constexpr int MBVC_VOXEL_INDEX_BITS = 21;
+constexpr int MBVC_VOXEL_INDEX_MAX = (1 << MBVC_VOXEL_INDEX_BITS) - 1;
+constexpr uint64_t MBVC_VOXEL_EMPTY = ~(uint64_t)0;
+constexpr size_t MBVC_VOXEL_SLOTS_MIN = 1024;
+
+struct mbvoxelclean_voxel_struct {
+  uint64_t key;
+  unsigned int count;
+  bool occupied;
+};
+
+struct mbvoxelclean_voxels_struct {
+  size_t n_slots; /* always a power of two */
+  size_t n_used;
+  struct mbvoxelclean_voxel_struct *slots;
+};
+
+/* voxel space of the soundings being cleaned together */
+struct mbvoxelclean_space_struct {
+  double x_min;
+  double y_min;
+  double z_min;
+  int n_voxel_x;
+  int n_voxel_y;
+  int n_voxel_z;
+  int n_partitions;
+  struct mbvoxelclean_voxels_struct *partitions;
+};
+
+/*--------------------------------------------------------------------*/
+
+uint64_t mbvoxelclean_voxel_key(int ix, int iy, int iz) {
+  return ((uint64_t)ix << (2 * MBVC_VOXEL_INDEX_BITS)) | ((uint64_t)iy << MBVC_VOXEL_INDEX_BITS) | (uint64_t)iz;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t mbvoxelclean_voxel_hash(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return (size_t)key;
+}
+
+/*--------------------------------------------------------------------*/
+
+int mbvoxelclean_voxels_alloc(int verbose, struct mbvoxelclean_voxels_struct *voxels, size_t n_slots, int *error) {
+  voxels->n_slots = n_slots;
+  voxels->n_used = 0;
+  voxels->slots = nullptr;
+  const int status = mb_mallocd(verbose, __FILE__, __LINE__, n_slots * sizeof(struct mbvoxelclean_voxel_struct),
+                                (void **)&voxels->slots, error);
+  if (status == MB_SUCCESS) {
+    for (size_t i = 0; i < n_slots; i++) {
+      voxels->slots[i].key = MBVC_VOXEL_EMPTY;
+      voxels->slots[i].count = 0;
+      voxels->slots[i].occupied = false;
+    }
+  }
+  return status;
+}
+
+/*--------------------------------------------------------------------*/
+
+struct mbvoxelclean_voxel_struct *mbvoxelclean_voxels_find(const struct mbvoxelclean_voxels_struct *voxels, uint64_t key) {
+  const size_t mask = voxels->n_slots - 1;
+  for (size_t i = mbvoxelclean_voxel_hash(key) & mask;; i = (i + 1) & mask) {
+    if (voxels->slots[i].key == key)
+      return &voxels->slots[i];
+    if (voxels->slots[i].key == MBVC_VOXEL_EMPTY)
+      return nullptr;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+int mbvoxelclean_voxels_insert(int verbose, struct mbvoxelclean_voxels_struct *voxels, uint64_t key,
+                               struct mbvoxelclean_voxel_struct **voxel, int *error) {
+  int status = MB_SUCCESS;
+  if ((*voxel = mbvoxelclean_voxels_find(voxels, key)) != nullptr)
+    return status;
+
+  /* keep the table at most half full, rehashing into a table twice the size */
+  if (2 * (voxels->n_used + 1) > voxels->n_slots) {
+    struct mbvoxelclean_voxels_struct grown;
+    status = mbvoxelclean_voxels_alloc(verbose, &grown, 2 * voxels->n_slots, error);
+    if (status == MB_FAILURE)
+      return status;
+    const size_t mask = grown.n_slots - 1;
+    for (size_t j = 0; j < voxels->n_slots; j++) {
+      if (voxels->slots[j].key != MBVC_VOXEL_EMPTY) {
+        size_t i = mbvoxelclean_voxel_hash(voxels->slots[j].key) & mask;
+        while (grown.slots[i].key != MBVC_VOXEL_EMPTY)
+          i = (i + 1) & mask;
+        grown.slots[i] = voxels->slots[j];
+      }
+    }
+    grown.n_used = voxels->n_used;
+    mb_freed(verbose, __FILE__, __LINE__, (void **)&voxels->slots, error);
+    *voxels = grown;
+  }
+
+  const size_t mask = voxels->n_slots - 1;
+  size_t i = mbvoxelclean_voxel_hash(key) & mask;
+  while (voxels->slots[i].key != key && voxels->slots[i].key != MBVC_VOXEL_EMPTY)
+    i = (i + 1) & mask;
+  if (voxels->slots[i].key == MBVC_VOXEL_EMPTY) {
+    voxels->slots[i].key = key;
+    voxels->n_used++;
+  }
+  *voxel = &voxels->slots[i];
+
+  return status;
+}
+
+/*--------------------------------------------------------------------*/
+
+int mbvoxelclean_partition(const struct mbvoxelclean_space_struct *space, int ix) {
+  return (int)(((long)ix * space->n_partitions) / space->n_voxel_x);
+}
+
+/*--------------------------------------------------------------------*/
+
+bool mbvoxelclean_voxel_index(const struct mbvoxelclean_control_struct *control,
+                              const struct mbvoxelclean_space_struct *space, double x, double y, double z, int *ix,
+                              int *iy, int *iz) {
+  *ix = (int)((x - space->x_min) / control->voxel_size_xy);
+  *iy = (int)((y - space->y_min) / control->voxel_size_xy);
+  *iz = (int)((z - space->z_min) / control->voxel_size_z);
+  return *ix >= 0 && *ix < space->n_voxel_x && *iy >= 0 && *iy < space->n_voxel_y && *iz >= 0 && *iz < space->n_voxel_z;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Count the soundings of the files falling in one partition of the voxel space
+ */
+void mbvoxelclean_count_partition(const struct mbvoxelclean_control_struct *control,
+                                  struct mbvoxelclean_space_struct *space, struct mbvoxelclean_file_struct **files,
+                                  int n_files, int partition, int *status, int *error) {
+  struct mbvoxelclean_voxels_struct *voxels = &space->partitions[partition];
+  for (int ifile = 0; ifile < n_files && *status == MB_SUCCESS; ifile++) {
+    const struct mbvoxelclean_file_struct *file = files[ifile];
+    for (int i = 0; i < file->n_pings && *status == MB_SUCCESS; i++) {
+      const struct mbvoxelclean_ping_struct *ping = &file->pings[i];
+      for (int j = 0; j < ping->beams_bath; j++) {
+        int ix;
+        int iy;
+        int iz;
+        if (!mb_beam_check_flag_null(ping->beamflag[j])
+            && mbvoxelclean_voxel_index(control, space, ping->bathx[j], ping->bathy[j], ping->bathz[j], &ix, &iy, &iz)
+            && mbvoxelclean_partition(space, ix) == partition) {
+          struct mbvoxelclean_voxel_struct *voxel = nullptr;
+          *status = mbvoxelclean_voxels_insert(control->verbose, voxels, mbvoxelclean_voxel_key(ix, iy, iz), &voxel, error);
+          if (*status == MB_FAILURE)
+            break;
+          if (mb_beam_ok(ping->beamflag[j]) || control->count_flagged)
+            voxel->count++;
+        }
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Decide which voxels of one partition are occupied - those holding at
+ * least the threshold number of soundings and those within the neighborhood
+ * of such a voxel
+ */
+void mbvoxelclean_occupy_partition(const struct mbvoxelclean_control_struct *control,
+                                   struct mbvoxelclean_space_struct *space, int partition) {
+  const int neighborhood = control->neighborhood;
+  const unsigned int threshold = (unsigned int)std::max(control->occupy_threshold, 0);
+  struct mbvoxelclean_voxels_struct *voxels = &space->partitions[partition];
+  for (size_t k = 0; k < voxels->n_slots; k++) {
+    struct mbvoxelclean_voxel_struct *voxel = &voxels->slots[k];
+    if (voxel->key == MBVC_VOXEL_EMPTY)
+      continue;
+    voxel->occupied = voxel->count >= threshold;
+    if (voxel->occupied || neighborhood <= 0)
+      continue;
+    const int ix = (int)(voxel->key >> (2 * MBVC_VOXEL_INDEX_BITS));
+    const int iy = (int)((voxel->key >> MBVC_VOXEL_INDEX_BITS) & MBVC_VOXEL_INDEX_MAX);
+    const int iz = (int)(voxel->key & MBVC_VOXEL_INDEX_MAX);
+    for (int iix = std::max(ix - neighborhood, 0); iix < std::min(ix + neighborhood + 1, space->n_voxel_x) && !voxel->occupied; iix++) {
+      const struct mbvoxelclean_voxels_struct *neighbors = &space->partitions[mbvoxelclean_partition(space, iix)];
+      for (int iiy = std::max(iy - neighborhood, 0); iiy < std::min(iy + neighborhood + 1, space->n_voxel_y) && !voxel->occupied; iiy++) {
+        for (int iiz = std::max(iz - neighborhood, 0); iiz < std::min(iz + neighborhood + 1, space->n_voxel_z) && !voxel->occupied; iiz++) {
+          const struct mbvoxelclean_voxel_struct *neighbor = mbvoxelclean_voxels_find(neighbors, mbvoxelclean_voxel_key(iix, iiy, iiz));
+          if (neighbor != nullptr && neighbor->count >= threshold)
+            voxel->occupied = true;
+        }
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Close the edit save and edit stream files of a file held for the survey
+ * wide density filter so that only one file has them open at a time. The
+ * lock on the swath file is kept until its edits are written.
+ */
+void mbvoxelclean_esf_suspend(struct mbvoxelclean_file_struct *file) {
+  if (file->esf.esffp != nullptr) {
+    fclose(file->esf.esffp);
+    file->esf.esffp = nullptr;
+  }
+  if (file->esf.essfp != nullptr) {
+    fclose(file->esf.essfp);
+    file->esf.essfp = nullptr;
+  }
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Reopen the edit save and edit stream files closed by
+ * mbvoxelclean_esf_suspend(), appending after the edits already written
+ */
+void mbvoxelclean_esf_resume(struct mbvoxelclean_file_struct *file) {
+  if (!file->esffile_open)
+    return;
+  if (file->esf.esffp == nullptr && (file->esf.esffp = fopen(file->esf.esffile, "ab")) == nullptr)
+    fprintf(stderr, "\nUnable to reopen edit save file %s\n", file->esf.esffile);
+  if (file->esf.essfp == nullptr && (file->esf.essfp = fopen(file->esf.esstream, "ab")) == nullptr)
+    fprintf(stderr, "\nUnable to reopen edit save stream file %s\n", file->esf.esstream);
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Apply the density filter to the soundings of the files cleaned together,
+ * which share occupancy of one sparse voxel space
+ */
+int mbvoxelclean_density_filter(struct mbvoxelclean_control_struct *control, struct mbvoxelclean_file_struct **files,
+                                int n_files, int *error) {
+  const int verbose = control->verbose;
+  int status = MB_SUCCESS;
+
+  /* get the bounds of the soundings */
+  bool bounds_set = false;
+  double x_min = 0.0;
+  double x_max = 0.0;
+  double y_min = 0.0;
+  double y_max = 0.0;
+  double z_min = 0.0;
+  double z_max = 0.0;
+  for (int ifile = 0; ifile < n_files; ifile++) {
+    const struct mbvoxelclean_file_struct *file = files[ifile];
+    if (!file->bounds_set)
+      continue;
+    if (!bounds_set) {
+      x_min = file->x_min;
+      x_max = file->x_max;
+      y_min = file->y_min;
+      y_max = file->y_max;
+      z_min = file->z_min;
+      z_max = file->z_max;
+      bounds_set = true;
+    } else {
+      x_min = std::min(x_min, file->x_min);
+      x_max = std::max(x_max, file->x_max);
+      y_min = std::min(y_min, file->y_min);
+      y_max = std::max(y_max, file->y_max);
+      z_min = std::min(z_min, file->z_min);
+      z_max = std::max(z_max, file->z_max);
+    }
+  }
+  if (!bounds_set)
+    return status;
+
+  /* define the voxel space */
+  struct mbvoxelclean_space_struct space;
+  space.n_voxel_x = (x_max - x_min) / control->voxel_size_xy + 3;
+  space.x_min = x_min - 0.5 * control->voxel_size_xy;
+  space.n_voxel_y = (y_max - y_min) / control->voxel_size_xy + 3;
+  space.y_min = y_min - 0.5 * control->voxel_size_xy;
+  space.n_voxel_z = (z_max - z_min) / control->voxel_size_z + 3;
+  space.z_min = z_min - 0.5 * control->voxel_size_z;
+  space.n_partitions = (int)std::min(control->n_threads, (unsigned int)space.n_voxel_x);
+  if (verbose >= 2) {
+    fprintf(stderr, "\ndbg2  final voxel bounds:\n");
+    fprintf(stderr, "dbg2    x_min:        %10.3f m\n", space.x_min);
+    fprintf(stderr, "dbg2    x_max:        %10.3f m\n", space.x_min + space.n_voxel_x * control->voxel_size_xy);
+    fprintf(stderr, "dbg2    y_min:        %10.3f m\n", space.y_min);
+    fprintf(stderr, "dbg2    y_max:        %10.3f m\n", space.y_min + space.n_voxel_y * control->voxel_size_xy);
+    fprintf(stderr, "dbg2    z_min:        %10.3f m\n", space.z_min);
+    fprintf(stderr, "dbg2    z_max:        %10.3f m\n", space.z_min + space.n_voxel_z * control->voxel_size_z);
+    fprintf(stderr, "dbg2    n_voxel_x:    %d\n", space.n_voxel_x);
+    fprintf(stderr, "dbg2    n_voxel_y:    %d\n", space.n_voxel_y);
+    fprintf(stderr, "dbg2    n_voxel_z:    %d\n", space.n_voxel_z);
+    fprintf(stderr, "dbg2    n_partitions: %d\n", space.n_partitions);
+  }
+  if (space.n_voxel_x > MBVC_VOXEL_INDEX_MAX || space.n_voxel_y > MBVC_VOXEL_INDEX_MAX ||
+      space.n_voxel_z > MBVC_VOXEL_INDEX_MAX) {
+    fprintf(stderr, "\nThe soundings span %d x %d x %d voxels, more than the %d voxels allowed along each axis\n",
+            space.n_voxel_x, space.n_voxel_y, space.n_voxel_z, MBVC_VOXEL_INDEX_MAX);
+    fprintf(stderr, "Use a larger voxel size or clean the files separately\n");
+    *error = MB_ERROR_BAD_PARAMETER;
+    return MB_FAILURE;
+  }
+
+  /* allocate the partitions */
+  space.partitions = nullptr;
+  status = mb_mallocd(verbose, __FILE__, __LINE__, space.n_partitions * sizeof(struct mbvoxelclean_voxels_struct),
+                      (void **)&space.partitions, error);
+  for (int p = 0; p < space.n_partitions && status == MB_SUCCESS; p++)
+    status = mbvoxelclean_voxels_alloc(verbose, &space.partitions[p], MBVC_VOXEL_SLOTS_MIN, error);
+  if (status == MB_FAILURE) {
+    char *message = nullptr;
+    mb_error(verbose, MB_ERROR_MEMORY_FAIL, &message);
+    fprintf(control->outfp, "\nMBIO Error allocating voxel storage:\n%s\n", message);
+    fprintf(control->outfp, "\nProgram <%s> Terminated\n", program_name);
+    mb_memory_clear(verbose, error);
+    exit(MB_ERROR_MEMORY_FAIL);
+  }
+
+  /* count the soundings in each voxel, then find the occupied voxels, one
+      thread per partition */
+  std::vector<int> partition_status(space.n_partitions, MB_SUCCESS);
+  std::vector<int> partition_error(space.n_partitions, MB_ERROR_NO_ERROR);
+  if (space.n_partitions > 1) {
+    std::vector<std::thread> threads;
+    for (int p = 0; p < space.n_partitions; p++)
+      threads.emplace_back(mbvoxelclean_count_partition, control, &space, files, n_files, p, &partition_status[p],
+                           &partition_error[p]);
+    for (int p = 0; p < space.n_partitions; p++)
+      threads[p].join();
+    threads.clear();
+    for (int p = 0; p < space.n_partitions; p++)
+      threads.emplace_back(mbvoxelclean_occupy_partition, control, &space, p);
+    for (int p = 0; p < space.n_partitions; p++)
+      threads[p].join();
+  } else {
+    mbvoxelclean_count_partition(control, &space, files, n_files, 0, &partition_status[0], &partition_error[0]);
+    mbvoxelclean_occupy_partition(control, &space, 0);
+  }
+  for (int p = 0; p < space.n_partitions; p++) {
+    if (partition_status[p] == MB_FAILURE) {
+      char *message = nullptr;
+      mb_error(verbose, MB_ERROR_MEMORY_FAIL, &message);
+      fprintf(control->outfp, "\nMBIO Error allocating voxel storage:\n%s\n", message);
+      fprintf(control->outfp, "\nProgram <%s> Terminated\n", program_name);
+      mb_memory_clear(verbose, error);
+      exit(MB_ERROR_MEMORY_FAIL);
+    }
+  }
+  if (verbose >= 2) {
+    size_t n_voxel_used = 0;
+    for (int p = 0; p < space.n_partitions; p++)
+      n_voxel_used += space.partitions[p].n_used;
+    fprintf(stderr, "dbg2    n_voxel_used: %zu\n", n_voxel_used);
+  }
+
+  /* apply density filter to the soundings  */
+  if (control->occupied_mode == MBVC_OCCUPIED_UNFLAG || control->empty_mode == MBVC_EMPTY_FLAG) {
+    for (int ifile = 0; ifile < n_files; ifile++) {
+      struct mbvoxelclean_file_struct *file = files[ifile];
+      if (control->survey)
+        mbvoxelclean_esf_resume(file);
+      for (int i = 0; i < file->n_pings; i++) {
+        struct mbvoxelclean_ping_struct *ping = &file->pings[i];
+        for (int j = 0; j < ping->beams_bath; j++) {
+          int ix;
+          int iy;
+          int iz;
+          if (!mb_beam_check_flag_null(ping->beamflag[j])
+              && mbvoxelclean_voxel_index(control, &space, ping->bathx[j], ping->bathy[j], ping->bathz[j], &ix, &iy, &iz)) {
+            const struct mbvoxelclean_voxel_struct *voxel =
+                mbvoxelclean_voxels_find(&space.partitions[mbvoxelclean_partition(&space, ix)], mbvoxelclean_voxel_key(ix, iy, iz));
+            const bool occupied = voxel != nullptr && voxel->occupied;
+            if (control->occupied_mode == MBVC_OCCUPIED_UNFLAG
+              && occupied
+              && !mb_beam_ok(ping->beamflag[j])) {
+              ping->beamflag[j] = MB_FLAG_NONE;
+              const int action = MBP_EDIT_UNFLAG;
+              mb_ess_save(verbose, &file->esf, ping->time_d,
+                  j + ping->multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
+                  action, error);
+              file->count.n_density_unflag++;
+            }
+            if (control->empty_mode == MBVC_EMPTY_FLAG
+              && !occupied
+              && mb_beam_ok(ping->beamflag[j])) {
+              ping->beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
+              const int action = MBP_EDIT_FILTER;
+              mb_ess_save(verbose, &file->esf, ping->time_d,
+                    j + ping->multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
+                    action, error);
+              file->count.n_density_flag++;
+            }
+          }
+        }
+      }
+      if (control->survey)
+        mbvoxelclean_esf_suspend(file);
+    }
+  }
+
+  /* release the voxels */
+  for (int p = 0; p < space.n_partitions; p++)
+    status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&space.partitions[p].slots, error);
+  status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&space.partitions, error);
+
+  return status;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Apply the acrosstrack and range filters to the soundings of a file
+ */
+void mbvoxelclean_filter_file(const struct mbvoxelclean_control_struct *control, struct mbvoxelclean_file_struct *file,
+                              int *error) {
+  const int verbose = control->verbose;
+  struct mbvoxelclean_ping_struct *pings = file->pings;
+
+  /* apply acrosstrack filter to the soundings */
+  if (control->apply_acrosstrack_minimum || control->apply_acrosstrack_maximum) {
+    for (int i = 0; i < file->n_pings; i++) {
+      for (int j = 0; j< pings[i].beams_bath; j++) {
+        if (!mb_beam_check_flag_null(pings[i].beamflag[j])) {
+          if (control->apply_acrosstrack_minimum
+            && mb_beam_ok(pings[i].beamflag[j])
+            && pings[i].bathacrosstrack[j] < control->acrosstrack_minimum) {
+            pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
+            const int action = MBP_EDIT_FILTER;
+            mb_ess_save(verbose, &file->esf, pings[i].time_d,
+                j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
+                action, error);
+            file->count.n_minacrosstrack_flag++;
+          } else if (control->apply_acrosstrack_maximum
+            && mb_beam_ok(pings[i].beamflag[j])
+            && pings[i].bathacrosstrack[j] > control->acrosstrack_maximum) {
+            pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
+            const int action = MBP_EDIT_FILTER;
+            mb_ess_save(verbose, &file->esf, pings[i].time_d,
+                j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
+                action, error);
+            file->count.n_maxacrosstrack_flag++;
+          }
+        }
+      }
+    }
+  }
+
+  /* apply range filter to the soundings */
+  if (control->apply_range_minimum || control->apply_range_maximum) {
+    for (int i = 0; i < file->n_pings; i++) {
+      for (int j = 0; j< pings[i].beams_bath; j++) {
+        if (!mb_beam_check_flag_null(pings[i].beamflag[j])) {
+          if (control->apply_range_minimum
+            && mb_beam_ok(pings[i].beamflag[j])
+            && pings[i].bathr[j] < control->range_minimum) {
+            pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
+            const int action = MBP_EDIT_FILTER;
+            mb_ess_save(verbose, &file->esf, pings[i].time_d,
+                j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
+                action, error);
+            file->count.n_minrange_flag++;
+          } else if (control->apply_range_maximum
+            && mb_beam_ok(pings[i].beamflag[j])
+            && pings[i].bathr[j] > control->range_maximum) {
+            pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
+            const int action = MBP_EDIT_FILTER;
+            mb_ess_save(verbose, &file->esf, pings[i].time_d,
+                j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
+                action, error);
+            file->count.n_maxrange_flag++;
+          }
+        }
+      }
+    }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Allocate the arrays of a ping for beams_bath beams
+ */
+void mbvoxelclean_ping_alloc(const struct mbvoxelclean_control_struct *control, struct mbvoxelclean_ping_struct *ping,
+                             int beams_bath, int *error) {
+  const int verbose = control->verbose;
+  if (ping->beams_bath_alloc >= beams_bath)
+    return;
+  if (*error == MB_ERROR_NO_ERROR)
+    mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(char), (void **)&ping->beamflag, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(char), (void **)&ping->beamflagorg, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double), (void **)&ping->bathacrosstrack, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double), (void **)&ping->bathz, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double), (void **)&ping->bathx, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double), (void **)&ping->bathy, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double), (void **)&ping->bathr, error);
+  if (*error != MB_ERROR_NO_ERROR) {
+    char *message = nullptr;
+    mb_error(verbose, MB_ERROR_MEMORY_FAIL, &message);
+    fprintf(control->outfp, "\nMBIO Error allocating data arrays within the ping structure:\n%s\n", message);
+    fprintf(control->outfp, "\nProgram <%s> Terminated\n", program_name);
+    mb_memory_clear(verbose, error);
+    exit(*error);
+  }
+  ping->beams_bath_alloc = beams_bath;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Allocate the ping array of a file for at least npings pings
+ */
+void mbvoxelclean_pings_alloc(const struct mbvoxelclean_control_struct *control, struct mbvoxelclean_file_struct *file,
+                              int npings, int *error) {
+  const int verbose = control->verbose;
+  if (file->npings_alloc >= npings)
+    return;
+  mb_reallocd(verbose, __FILE__, __LINE__, npings * sizeof(struct mbvoxelclean_ping_struct),
+              (void **)&file->pings, error);
+  if (*error != MB_ERROR_NO_ERROR) {
+    char *message = nullptr;
+    mb_error(verbose, MB_ERROR_MEMORY_FAIL, &message);
+    fprintf(control->outfp, "\nMBIO Error allocating pings array:\n%s\n", message);
+    fprintf(control->outfp, "\nProgram <%s> Terminated\n", program_name);
+    mb_memory_clear(verbose, error);
+    exit(*error);
+  }
+  memset((void *)&file->pings[file->npings_alloc], 0,
+         (npings - file->npings_alloc) * sizeof(struct mbvoxelclean_ping_struct));
+  file->npings_alloc = npings;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Release the pings of a file
+ */
+void mbvoxelclean_file_free(const struct mbvoxelclean_control_struct *control, struct mbvoxelclean_file_struct *file,
+                            int *error) {
+  const int verbose = control->verbose;
+  for (int i = 0; i < file->npings_alloc; i++) {
+    mb_freed(verbose, __FILE__, __LINE__, (void **)&file->pings[i].beamflag, error);
+    mb_freed(verbose, __FILE__, __LINE__, (void **)&file->pings[i].beamflagorg, error);
+    mb_freed(verbose, __FILE__, __LINE__, (void **)&file->pings[i].bathacrosstrack, error);
+    mb_freed(verbose, __FILE__, __LINE__, (void **)&file->pings[i].bathz, error);
+    mb_freed(verbose, __FILE__, __LINE__, (void **)&file->pings[i].bathx, error);
+    mb_freed(verbose, __FILE__, __LINE__, (void **)&file->pings[i].bathy, error);
+    mb_freed(verbose, __FILE__, __LINE__, (void **)&file->pings[i].bathr, error);
+  }
+  mb_freed(verbose, __FILE__, __LINE__, (void **)&file->pings, error);
+  file->npings_alloc = 0;
+  file->n_pings = 0;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Lock a swath file, load its edit save file and read its soundings into
+ * the local cartesian coordinate system of the control structure. Returns
+ * MB_FAILURE if the file is to be skipped.
+ */
+int mbvoxelclean_read_file(struct mbvoxelclean_control_struct *control, struct mbvoxelclean_file_struct *file,
+                           int *error) {
+  const int verbose = control->verbose;
+  int status = MB_SUCCESS;
+  int format = file->format;
+  int variable_beams;
+  int traveltime;
+  int beam_flagging;  // TODO(schwehr): Make mb_format_flags take a bool
+
+  /* check format and get format flags */
+  if ((status = mb_format_flags(verbose, &format, &variable_beams, &traveltime, &beam_flagging, error)) != MB_SUCCESS) {
+    char *message = nullptr;
+    mb_error(verbose, *error, &message);
+    fprintf(stderr, "\nMBIO Error returned from function <mb_format_flags> regarding input format %d:\n%s\n", format,
+      message);
+    fprintf(stderr, "\nFile <%s> skipped by program <%s>\n", file->swathfile, program_name);
+    *error = MB_ERROR_NO_ERROR;
+    return MB_FAILURE;
+  }
+
+  /* warn if beam flagging not supported for the current data format */
+  if (!beam_flagging) {
+    fprintf(stderr, "\nWarning:\nMBIO format %d does not allow flagging of bad bathymetry data.\n", format);
+    fprintf(stderr,
+      "\nWhen mbprocess applies edits to file:\n\t%s\nthe soundings will be nulled (zeroed) rather than flagged.\n",
+      file->swathfile);
+  }
+
+  char lock_date[25] = "";
+  bool locked = false;
+  /* try to lock file */
+  if (control->uselockfiles) {
+    status = mb_pr_lockswathfile(verbose, file->swathfile, MBP_LOCK_EDITBATHY, program_name, error);
+  } else {
+    int lock_purpose = MBP_LOCK_NONE;
+    mb_path lock_program = "";
+    mb_path lock_user = "";
+    mb_path lock_cpu = "";
+    mb_pr_lockinfo(verbose, file->swathfile, &locked, &lock_purpose, lock_program, lock_user, lock_cpu, lock_date, error);
+
+    /* if locked get lock info */
+    if (*error == MB_ERROR_FILE_LOCKED) {
+      fprintf(stderr, "\nFile %s locked but lock ignored\n", file->swathfile);
+      fprintf(stderr, "File locked by <%s> running <%s>\n", lock_user, lock_program);
+      fprintf(stderr, "on cpu <%s> at <%s>\n", lock_cpu, lock_date);
+      *error = MB_ERROR_NO_ERROR;
+    }
+  }
+
+  /* if locked let the user know file can't be opened */
+  if (status == MB_FAILURE) {
+    /* if locked get lock info */
+    if (*error == MB_ERROR_FILE_LOCKED) {
+      int lock_purpose = MBP_LOCK_NONE;
+      mb_path lock_program = "";
+      mb_path lock_user = "";
+      mb_path lock_cpu = "";
+      mb_pr_lockinfo(verbose, file->swathfile, &locked, &lock_purpose, lock_program, lock_user, lock_cpu,
+                 lock_date, error);
+
+      fprintf(stderr, "\nUnable to open input file:\n");
+      fprintf(stderr, "  %s\n", file->swathfile);
+      fprintf(stderr, "File locked by <%s> running <%s>\n", lock_user, lock_program);
+      fprintf(stderr, "on cpu <%s> at <%s>\n", lock_cpu, lock_date);
+    }
+
+    /* else if unable to create lock file there is a permissions problem */
+    else if (*error == MB_ERROR_OPEN_FAIL) {
+      fprintf(stderr, "Unable to create lock file\n");
+      fprintf(stderr, "for intended input file:\n");
+      fprintf(stderr, "  %s\n", file->swathfile);
+      fprintf(stderr, "-Likely permissions issue\n");
+    }
+
+    /* reset error */
+    *error = MB_ERROR_NO_ERROR;
+    return MB_FAILURE;
+  }
+
+  /* check for *inf file, create if necessary, and load metadata */
+  int formatread = format;
+  struct mb_info_struct mb_info;
+  status = mb_get_info_datalist(verbose, file->swathfile, &formatread, &mb_info, control->lonflip, error);
+
+  /* allocate space to store the bathymetry data */
+  mbvoxelclean_pings_alloc(control, file, std::max(mb_info.nrecords, 1), error);
+  for (int i = 0; i < mb_info.nrecords; i++)
+    mbvoxelclean_ping_alloc(control, &file->pings[i], mb_info.nbeams_bath, error);
+
+  /* define local cartesian coordinate system based on first ping navigation,
+      unless already defined by an earlier file of the same survey, and
+      heading */
+  if (!control->origin_set) {
+    control->origin_lon = mb_info.lon_start;
+    control->origin_lat = mb_info.lat_start;
+    mb_coor_scale(verbose, control->origin_lat, &control->mtodeglon, &control->mtodeglat);
+    control->origin_set = true;
+  }
+  const double mtodeglon = control->mtodeglon;
+  const double mtodeglat = control->mtodeglat;
+  const double headingx = sin(mb_info.heading_start * DTR);
+  const double headingy = cos(mb_info.heading_start * DTR);
+
+  /* check for "fast bathymetry" or "fbt" file */
+  mb_path swathfileread;
+  strcpy(swathfileread, file->swathfile);
+  formatread = format;
+  mb_get_fbt(verbose, swathfileread, &formatread, error);
+
+  /* if verbose output status */
+  if (verbose > 0) {
+    fprintf(stderr, "---------------------------------\n");
+    fprintf(stderr, "Processing %s...\n\tActually reading %s...\n", file->swathfile, swathfileread);
+  }
+
+  /* initialize reading the input swath sonar file */
+  void *mbio_ptr = nullptr;
+  double bounds[4] = {control->bounds[0], control->bounds[1], control->bounds[2], control->bounds[3]};
+  double btime_d;
+  double etime_d;
+  int beams_bath = 0;
+  int beams_amp = 0;
+  int pixels_ss = 0;
+  if (mb_read_init(verbose, swathfileread, formatread, control->defaultpings, control->lonflip, bounds, control->btime_i,
+                   control->etime_i, control->speedmin, control->timegap, &mbio_ptr, &btime_d, &etime_d, &beams_bath,
+                   &beams_amp, &pixels_ss, error) != MB_SUCCESS) {
+    char *message = nullptr;
+    mb_error(verbose, *error, &message);
+    fprintf(stderr, "\nMBIO Error returned from function <mb_read_init>:\n%s\n", message);
+    fprintf(stderr, "\nMultibeam File <%s> not initialized for reading\n", file->swathfile);
+    fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+    exit(*error);
+  }
+
+  /* allocate memory for mb_get() data arrays */
+  char *beamflag = nullptr;
+  double *bath = nullptr;
+  double *bathacrosstrack = nullptr;
+  double *bathalongtrack = nullptr;
+  double *amp = nullptr;
+  double *ss = nullptr;
+  double *ssacrosstrack = nullptr;
+  double *ssalongtrack = nullptr;
+  if (*error == MB_ERROR_NO_ERROR)
+    status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char),
+         (void **)&beamflag, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double),
+         (void **)&bath, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double),
+         (void **)&bathacrosstrack, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double),
+         (void **)&bathalongtrack, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double),
+         (void **)&amp, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double),
+         (void **)&ss, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double),
+          (void **)&ssacrosstrack, error);
+  if (*error == MB_ERROR_NO_ERROR)
+    status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double),
+          (void **)&ssalongtrack, error);
+
+  /* if error initializing memory then quit */
+  if (*error != MB_ERROR_NO_ERROR) {
+    char *message = nullptr;
+    mb_error(verbose, *error, &message);
+    fprintf(stderr, "\nMBIO Error allocating data arrays:\n%s\n", message);
+    fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+    exit(*error);
+  }
+
+  /* now deal with old edit save file */
+  if (status == MB_SUCCESS) {
+    /* reset message */
+    fprintf(stderr, "\tOpening edit save file...\n");
+
+    /* handle esf edits */
+    status = mb_esf_load(verbose, program_name, file->swathfile, true, true, file->esffile, &file->esf, error);
+    if (status == MB_SUCCESS && file->esf.esffp != nullptr)
+      file->esffile_open = true;
+    if (status == MB_FAILURE && *error == MB_ERROR_OPEN_FAIL) {
+      file->esffile_open = false;
+      fprintf(stderr, "\nUnable to open new edit save file %s\n", file->esf.esffile);
+    }
+    else if (status == MB_FAILURE && *error == MB_ERROR_MEMORY_FAIL) {
+      file->esffile_open = false;
+      fprintf(stderr, "\nUnable to allocate memory for edits in esf file %s\n", file->esf.esffile);
+    }
+    /* reset message */
+    if (file->esf.nedit > 0) {
+      fprintf(stderr, "%d old edits sorted...\n", file->esf.nedit);
+    }
+  }
+
+  /* read */
+  struct mbvoxelclean_count_struct *count = &file->count;
+  void *store_ptr = nullptr;
+  int kind = MB_DATA_NONE;
+  int pingsread = 0;
+  int sensorhead = 0;
+  int sensorhead_error = MB_ERROR_NO_ERROR;
+  int time_i[7];
+  double time_d = 0.0;
+  double navlon = 0.0;
+  double navlat = 0.0;
+  double speed = 0.0;
+  double heading = 0.0;
+  double distance = 0.0;
+  double altitude = 0.0;
+  double sensordepth = 0.0;
+  char comment[MB_COMMENT_MAXLINE];
+  bool done = false;
+  while (!done) {
+    if (verbose > 1)
+      fprintf(stderr, "\n");
+
+    /* read next record */
+    *error = MB_ERROR_NO_ERROR;
+    status = mb_get(verbose, mbio_ptr, &kind, &pingsread, time_i, &time_d, &navlon,
+        &navlat, &speed, &heading, &distance, &altitude, &sensordepth,
+        &beams_bath, &beams_amp, &pixels_ss, beamflag, bath, amp,
+        bathacrosstrack, bathalongtrack, ss, ssacrosstrack, ssalongtrack, comment,
+        error);
+    if (verbose >= 2) {
+      fprintf(stderr, "\ndbg2  current data status:\n");
+      fprintf(stderr, "dbg2    kind:     %d\n", kind);
+      fprintf(stderr, "dbg2    status:   %d\n", status);
+    }
+    if (status == MB_SUCCESS && kind == MB_DATA_DATA) {
+      /* allocate space for data if needed */
+      const int n_pings = file->n_pings;
+      if (n_pings >= file->npings_alloc)
+        mbvoxelclean_pings_alloc(control, file, 2 * file->npings_alloc, error);
+      struct mbvoxelclean_ping_struct *ping = &file->pings[n_pings];
+      mbvoxelclean_ping_alloc(control, ping, beams_bath, error);
+
+      /* check for ping multiplicity */
+      status = mb_get_store(verbose, mbio_ptr, &store_ptr, error);
+      const int sensorhead_status = mb_sensorhead(verbose, mbio_ptr, store_ptr, &sensorhead, &sensorhead_error);
+      if (sensorhead_status == MB_SUCCESS) {
+        ping->multiplicity = sensorhead;
+      }
+      else if (n_pings > 0 && fabs(time_d - file->pings[n_pings - 1].time_d) < MB_ESF_MAXTIMEDIFF) {
+        ping->multiplicity = file->pings[n_pings - 1].multiplicity + 1;
+      }
+      else {
+        ping->multiplicity = 0;
+      }
+
+      /* save relevant data */
+      ping->time_d = time_d;
+      ping->navlon = navlon;
+      ping->navlat = navlat;
+      ping->heading = heading;
+      ping->sensordepth = sensordepth;
+      ping->beams_bath = beams_bath;
+      const double sensorx = (navlon - control->origin_lon) / mtodeglon;
+      const double sensory = (navlat - control->origin_lat) / mtodeglat;
+      const double sensorz = -sensordepth;
+      for (int j = 0; j < beams_bath; j++) {
+        ping->beamflag[j] = beamflag[j];
+        ping->beamflagorg[j] = beamflag[j];
+        if (!mb_beam_check_flag_null(beamflag[j])) {
+          ping->bathacrosstrack[j] = bathacrosstrack[j];
+          ping->bathx[j] = sensorx + headingy * bathacrosstrack[j] + headingx * bathalongtrack[j];
+          ping->bathy[j] = sensory - headingx * bathacrosstrack[j] + headingy * bathalongtrack[j];
+          ping->bathz[j] = -bath[j];
+          ping->bathr[j] = sqrt((ping->bathx[j] - sensorx) * (ping->bathx[j] - sensorx)
+                                + (ping->bathy[j] - sensory) * (ping->bathy[j] - sensory)
+                                + (ping->bathz[j] - sensorz) * (ping->bathz[j] - sensorz));
+          if (!file->bounds_set) {
+              file->x_min = ping->bathx[j];
+              file->x_max = ping->bathx[j];
+              file->y_min = ping->bathy[j];
+              file->y_max = ping->bathy[j];
+              file->z_min = ping->bathz[j];
+              file->z_max = ping->bathz[j];
+              file->bounds_set = true;
+          } else {
+              file->x_min = std::min(file->x_min, ping->bathx[j]);
+              file->x_max = std::max(file->x_max, ping->bathx[j]);
+              file->y_min = std::min(file->y_min, ping->bathy[j]);
+              file->y_max = std::max(file->y_max, ping->bathy[j]);
+              file->z_min = std::min(file->z_min, ping->bathz[j]);
+              file->z_max = std::max(file->z_max, ping->bathz[j]);
+          }
+
+          // apply amplitude filter here where amplitude values are available
+          // = note that a density unflag setting could undo flags defined here
+          if (control->apply_amplitude_minimum || control->apply_amplitude_maximum) {
+            if (mb_beam_ok(ping->beamflag[j])) {
+              if (control->apply_amplitude_minimum && amp[j] < control->amplitude_minimum) {
+                ping->beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
+                const int action = MBP_EDIT_FILTER;
+                mb_ess_save(verbose, &file->esf, ping->time_d,
+                    j + ping->multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
+                    action, error);
+                count->n_minamplitude_flag++;
+              }
+              if (control->apply_amplitude_maximum && amp[j] > control->amplitude_maximum) {
+                ping->beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
+                const int action = MBP_EDIT_FILTER;
+                mb_ess_save(verbose, &file->esf, ping->time_d,
+                    j + ping->multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
+                    action, error);
+                count->n_maxamplitude_flag++;
+              }
+            }
+          }
+
+        } else {
+          ping->bathacrosstrack[j] = 0.0;
+          ping->bathx[j] = 0.0;
+          ping->bathy[j] = 0.0;
+          ping->bathz[j] = 0.0;
+          ping->bathr[j] = 0.0;
+        }
+      }
+      if (verbose >= 2) {
+        fprintf(stderr, "\ndbg2  beam locations (ping:beam xxx.xxx yyy.yyy zzz.zzz)\n");
+        for (int j = 0; j < ping->beams_bath; j++) {
+          fprintf(stderr, "dbg2    %d:%3.3d %10.3f %10.3f %10.3f\n",
+          n_pings, j, ping->bathx[j], ping->bathy[j], ping->bathz[j]);
+        }
+
+        fprintf(stderr, "\ndbg2  current voxel bounds:\n");
+        fprintf(stderr, "dbg2    x_min: %10.3f m\n", file->x_min);
+        fprintf(stderr, "dbg2    x_max: %10.3f m\n", file->x_max);
+        fprintf(stderr, "dbg2    y_min: %10.3f m\n", file->y_min);
+        fprintf(stderr, "dbg2    y_max: %10.3f m\n", file->y_max);
+        fprintf(stderr, "dbg2    z_min: %10.3f m\n", file->z_min);
+        fprintf(stderr, "dbg2    z_max: %10.3f m\n", file->z_max);
+      }
+
+      /* update counters */
+      for (int j = 0; j < ping->beams_bath; j++) {
+        if (mb_beam_ok(ping->beamflag[j]))
+             count->n_beamflag_good++;
+        else if (ping->beamflag[j] == MB_FLAG_NULL)
+            count->n_beamflag_null++;
+        else
+            count->n_beamflag_flag++;
+      }
+
+      /* apply saved edits */
+      status &= mb_esf_apply(verbose, &file->esf, ping->time_d, ping->multiplicity, ping->beams_bath,
+                ping->beamflag, error);
+
+      /* update counters */
+      for (int j = 0; j < ping->beams_bath; j++) {
+        if (ping->beamflag[j] != ping->beamflagorg[j]) {
+          if (mb_beam_ok(ping->beamflag[j]))
+            count->n_esf_unflag++;
+          else
+            count->n_esf_flag++;
+        }
+      }
+      count->n_beams += ping->beams_bath;
+      file->n_pings++;
+
+    }
+    else if (*error > MB_ERROR_NO_ERROR) {
+      done = true;
+    }
+  }
+  count->n_pings = file->n_pings;
+
+  /* close the swath file */
+  status = mb_close(verbose, &mbio_ptr, error);
+
+  return MB_SUCCESS;
+}
+
+/*--------------------------------------------------------------------*/
+/*
+ * Write the edits of a file to its edit save file, update its parameter
+ * file and unlock it
+ */
+void mbvoxelclean_write_file(const struct mbvoxelclean_control_struct *control, struct mbvoxelclean_file_struct *file,
+                             int *error) {
+  const int verbose = control->verbose;
+  struct mbvoxelclean_ping_struct *pings = file->pings;
+
+  /* write out edits for beamflags that have changed  */
+  for (int i = 0; i < file->n_pings; i++) {
+    for (int j = 0; j< pings[i].beams_bath; j++) {
+      if (pings[i].beamflag[j] != pings[i].beamflagorg[j]) {
+        int action = MBP_EDIT_ZERO;
+        if (mb_beam_ok(pings[i].beamflag[j])) {
+          action = MBP_EDIT_UNFLAG;
+        }
+        else if (mb_beam_check_flag_filter2(pings[i].beamflag[j])) {
+          action = MBP_EDIT_FILTER;
+        }
+        else if (mb_beam_check_flag_filter(pings[i].beamflag[j])) {
+          action = MBP_EDIT_FILTER;
+        }
+        else if (pings[i].beamflag[j] != MB_FLAG_NULL) {
+          action = MBP_EDIT_FLAG;
+        }
+        else {
+          action = MBP_EDIT_ZERO;
+        }
+        mb_esf_save(verbose, &file->esf, pings[i].time_d,
+                    j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR, action, error);
+      }
+    }
+  }
+
+  /* close edit save file */
+  const int nedit = file->esf.nedit;
+  mb_esf_close(verbose, &file->esf, error);
+
+  /* update mbprocess parameter file */
+  if (file->esffile_open) {
+    /* update mbprocess parameter file */
+    mb_pr_update_format(verbose, file->swathfile, true, file->format, error);
+    mb_pr_update_edit(verbose, file->swathfile, MBP_EDIT_ON, file->esffile, error);
+  }
+
+  /* unlock the raw swath file */
+  if (control->uselockfiles)
+    mb_pr_unlockswathfile(verbose, file->swathfile, MBP_LOCK_EDITBATHY, program_name, error);
+
+  /* check memory */
+  if (verbose >= 4)
+    mb_memory_list(verbose, error);
+
+  /* give the statistics */
+  const struct mbvoxelclean_count_struct *count = &file->count;
+  if (verbose >= 1) {
+    if (control->survey)
+      fprintf(stderr, "---------------------------------\n%s\n", file->swathfile);
+    fprintf(stderr, "%7d survey data records processed\n", count->n_pings);
+    fprintf(stderr, "%7d soundings processed\n", count->n_beams);
+    fprintf(stderr, "%7d beams good originally\n", count->n_beamflag_good);
+    fprintf(stderr, "%7d beams flagged originally\n", count->n_beamflag_flag);
+    fprintf(stderr, "%7d beams null originally\n", count->n_beamflag_null);
+    if (nedit > 0) {
+      fprintf(stderr, "%7d beams flagged in old esf file\n", count->n_esf_flag);
+      fprintf(stderr, "%7d beams unflagged in old esf file\n", count->n_esf_unflag);
+    }
+    fprintf(stderr, "%7d beams flagged by density filter\n", count->n_density_flag);
+    fprintf(stderr, "%7d beams unflagged by density filter\n", count->n_density_unflag);
+    fprintf(stderr, "%7d beams flagged by minimum range filter\n", count->n_minrange_flag);
+    fprintf(stderr, "%7d beams flagged by maximum range filter\n", count->n_maxrange_flag);
+    fprintf(stderr, "%7d beams flagged by minimum acrosstrack filter\n", count->n_minacrosstrack_flag);
+    fprintf(stderr, "%7d beams flagged by maximum acrosstrack filter\n", count->n_maxacrosstrack_flag);
+    fprintf(stderr, "%7d beams flagged by minimum amplitude filter\n", count->n_minamplitude_flag);
+    fprintf(stderr, "%7d beams flagged by maximum amplitude filter\n", count->n_maxamplitude_flag);
+  }
+}
+
+/*--------------------------------------------------------------------*/
+
+void mbvoxelclean_count_add(struct mbvoxelclean_count_struct *total, const struct mbvoxelclean_count_struct *count) {
+  total->n_files++;
+  total->n_pings += count->n_pings;
+  total->n_beams += count->n_beams;
+  total->n_beamflag_null += count->n_beamflag_null;
+  total->n_beamflag_good += count->n_beamflag_good;
+  total->n_beamflag_flag += count->n_beamflag_flag;
+  total->n_esf_flag += count->n_esf_flag;
+  total->n_esf_unflag += count->n_esf_unflag;
+  total->n_density_flag += count->n_density_flag;
+  total->n_density_unflag += count->n_density_unflag;
+  total->n_minrange_flag += count->n_minrange_flag;
+  total->n_maxrange_flag += count->n_maxrange_flag;
+  total->n_minacrosstrack_flag += count->n_minacrosstrack_flag;
+  total->n_maxacrosstrack_flag += count->n_maxacrosstrack_flag;
+  total->n_minamplitude_flag += count->n_minamplitude_flag;
+  total->n_maxamplitude_flag += count->n_maxamplitude_flag;
+}
+
+/*--------------------------------------------------------------------*/
+
 /*--------------------------------------------------------------------*/
 
 int main(int argc, char **argv) {
@@ -170,6 +1318,8 @@ int main(int argc, char **argv) {
   empty_mode_t empty_mode = MBVC_EMPTY_FLAG;
   occupied_mode_t occupied_mode = MBVC_OCCUPIED_IGNORE;
   int neighborhood = 0;
+  bool survey = false;
+  unsigned int n_threads = 1;
 
   /* other mbvoxelclean control parameters */
   bool apply_range_minimum = false;
@@ -202,6 +1352,8 @@ int main(int argc, char **argv) {
         {"unflag-occupied", no_argument, nullptr, 0},
         {"ignore-occupied", no_argument, nullptr, 0},
         {"neighborhood", required_argument, nullptr, 0},
+        {"survey", no_argument, nullptr, 0},
+        {"threads", required_argument, nullptr, 0},
         {"range-minimum", required_argument, nullptr, 0},
         {"range-maximum", required_argument, nullptr, 0},
         {"acrosstrack-minimum", required_argument, nullptr, 0},
@@ -263,6 +1415,12 @@ int main(int argc, char **argv) {
         else if (strcmp("neighborhood", options[option_index].name) == 0) {
           sscanf(optarg, "%d", &neighborhood);
         }
+        else if (strcmp("survey", options[option_index].name) == 0) {
+          survey = true;
+        }
+        else if (strcmp("threads", options[option_index].name) == 0) {
+          sscanf(optarg, "%u", &n_threads);
+        }
         else if (strcmp("range-minimum", options[option_index].name) == 0) {
           apply_range_minimum = true;
           sscanf(optarg, "%lf", &range_minimum);
@@ -343,6 +1501,8 @@ int main(int argc, char **argv) {
       fprintf(outfp, "dbg2       empty_mode:                  %d\n", empty_mode);
       fprintf(outfp, "dbg2       occupied_mode:               %d\n", occupied_mode);
       fprintf(outfp, "dbg2       neighborhood:                %d\n", neighborhood);
+      fprintf(outfp, "dbg2       survey:                      %d\n", survey);
+      fprintf(outfp, "dbg2       n_threads:                   %u\n", n_threads);
       fprintf(outfp, "dbg2       apply_range_minimum:         %d\n", apply_range_minimum);
       fprintf(outfp, "dbg2       range_minimum:               %f\n", range_minimum);
       fprintf(outfp, "dbg2       apply_range_maximum:         %d\n", apply_range_maximum);
@@ -369,6 +1529,47 @@ int main(int argc, char **argv) {
   bool uselockfiles = true;
   mb_uselockfiles(verbose, &uselockfiles);
 
+  /* get number of threads (and voxel space partitions) to use */
+  const unsigned int n_concurrency = std::thread::hardware_concurrency();
+  if (n_concurrency > 0)
+    n_threads = std::min(n_threads, n_concurrency);
+  n_threads = std::max(1u, std::min(n_threads, (unsigned int)MB_THREAD_MAX));
+
+  struct mbvoxelclean_control_struct control;
+  memset((void *)&control, 0, sizeof(control));
+  control.verbose = verbose;
+  control.outfp = outfp;
+  control.defaultpings = defaultpings;
+  control.lonflip = lonflip;
+  memcpy(control.bounds, bounds, sizeof(bounds));
+  memcpy(control.btime_i, btime_i, sizeof(btime_i));
+  memcpy(control.etime_i, etime_i, sizeof(etime_i));
+  control.speedmin = speedmin;
+  control.timegap = timegap;
+  control.uselockfiles = uselockfiles;
+  control.voxel_size_xy = voxel_size_xy;
+  control.voxel_size_z = voxel_size_z;
+  control.occupy_threshold = occupy_threshold;
+  control.count_flagged = count_flagged;
+  control.empty_mode = empty_mode;
+  control.occupied_mode = occupied_mode;
+  control.neighborhood = neighborhood;
+  control.apply_range_minimum = apply_range_minimum;
+  control.range_minimum = range_minimum;
+  control.apply_range_maximum = apply_range_maximum;
+  control.range_maximum = range_maximum;
+  control.apply_acrosstrack_minimum = apply_acrosstrack_minimum;
+  control.acrosstrack_minimum = acrosstrack_minimum;
+  control.apply_acrosstrack_maximum = apply_acrosstrack_maximum;
+  control.acrosstrack_maximum = acrosstrack_maximum;
+  control.apply_amplitude_minimum = apply_amplitude_minimum;
+  control.amplitude_minimum = amplitude_minimum;
+  control.apply_amplitude_maximum = apply_amplitude_maximum;
+  control.amplitude_maximum = amplitude_maximum;
+  control.survey = survey;
+  control.n_threads = n_threads;
+  control.origin_set = false;
+
   /* get format if required */
   if (format == 0)
     mb_get_format(verbose, read_file, nullptr, &format, &error);
@@ -396,842 +1597,46 @@ int main(int argc, char **argv) {
     read_data = true;
   }
 
-  int kind = MB_DATA_NONE;
-  char swathfileread[MB_PATH_MAXLINE];
-  int variable_beams;
-  int traveltime;
-  double btime_d;
-  double etime_d;
-
-  /* processing variables */
-  int sensorhead = 0;
-  int sensorhead_error = MB_ERROR_NO_ERROR;
-  int pingsread = 0;
-  int time_i[7];
-  double time_d = 0.0;
-  double navlon = 0.0;
-  double navlat = 0.0;
-  double speed = 0.0;
-  double heading = 0.0;
-  double distance = 0.0;
-  double altitude = 0.0;
-  double sensordepth = 0.0;
-  int beams_bath = 0;
-  int beams_amp = 0;
-  int pixels_ss = 0;
-  char *beamflag = nullptr;
-  char *beamflagorg = nullptr;
-  double *bath = nullptr;
-  double *bathacrosstrack = nullptr;
-  double *bathalongtrack = nullptr;
-  double *amp = nullptr;
-  double *ss = nullptr;
-  double *ssacrosstrack = nullptr;
-  double *ssalongtrack = nullptr;
-  char comment[MB_COMMENT_MAXLINE];
-
-  /* swath data storage */
-  struct mbvoxelclean_ping_struct *pings = nullptr;
-
-  /* voxel storage */
-  unsigned char *voxel_count = nullptr;
+  /* files read and held for the survey wide density filter */
+  std::vector<struct mbvoxelclean_file_struct *> files;
 
-  /* save file control variables */
-  char esffile[MB_PATH_MAXLINE];
-  struct mb_esf_struct esf;
-  memset((void *)&esf, 0, sizeof(esf));
-
-  int n_files_tot = 0;
-  int n_pings_tot = 0;
-  int n_beams_tot = 0;
-  int n_beamflag_null_tot = 0;
-  int n_beamflag_good_tot = 0;
-  int n_beamflag_flag_tot = 0;
-  int n_esf_flag_tot = 0;
-  int n_esf_unflag_tot = 0;
-  int n_density_flag_tot = 0;
-  int n_density_unflag_tot = 0;
-  int n_minrange_flag_tot = 0;
-  int n_maxrange_flag_tot = 0;
-  int n_minacrosstrack_flag_tot = 0;
-  int n_maxacrosstrack_flag_tot = 0;
-  int n_minamplitude_flag_tot = 0;
-  int n_maxamplitude_flag_tot = 0;
-
-  bool esffile_open = false;
-  bool locked = false;
-  int n_voxel_alloc = 0;
-  int npings_alloc = 0;
+  struct mbvoxelclean_count_struct count_tot;
+  memset((void *)&count_tot, 0, sizeof(count_tot));
 
   /* loop over all files to be read */
   while (read_data) {
-    bool oktoprocess = true;
-    int beam_flagging;  // TODO(schwehr): Make mb_format_flags take a bool
+    struct mbvoxelclean_file_struct *file = new mbvoxelclean_file_struct();
+    strcpy(file->swathfile, swathfile);
+    file->format = format;
 
-    /* check format and get format flags */
-    if ((status = mb_format_flags(verbose, &format, &variable_beams, &traveltime, &beam_flagging, &error)) != MB_SUCCESS) {
-      char *message = nullptr;
-      mb_error(verbose, error, &message);
-      fprintf(stderr, "\nMBIO Error returned from function <mb_format_flags> regarding input format %d:\n%s\n", format,
-        message);
-      fprintf(stderr, "\nFile <%s> skipped by program <%s>\n", swathfile, program_name);
-      oktoprocess = false;
-      status = MB_SUCCESS;
-      error = MB_ERROR_NO_ERROR;
-    }
+    /* each file has its own coordinate system unless cleaning the whole survey */
+    if (!survey)
+      control.origin_set = false;
 
-    /* warn if beam flagging not supported for the current data format */
-    if (!beam_flagging) {
-      fprintf(stderr, "\nWarning:\nMBIO format %d does not allow flagging of bad bathymetry data.\n", format);
-      fprintf(stderr,
-        "\nWhen mbprocess applies edits to file:\n\t%s\nthe soundings will be nulled (zeroed) rather than flagged.\n",
-        swathfile);
+    /* read the file, skipping it if it is locked or of an unknown format */
+    if (mbvoxelclean_read_file(&control, file, &error) == MB_FAILURE) {
+      delete file;
     }
-
-    char lock_date[25] = "";
-    // int lock_status = MB_SUCCESS;
-    /* try to lock file */
-    if (uselockfiles) {
-      status = mb_pr_lockswathfile(verbose, swathfile, MBP_LOCK_EDITBATHY, program_name, &error);
-    } else {
-      /* lock_status = */
-      int lock_purpose = MBP_LOCK_NONE;
-      mb_path lock_program = "";
-      mb_path lock_user = "";
-      mb_path lock_cpu = "";
-      mb_pr_lockinfo(verbose, swathfile, &locked, &lock_purpose, lock_program, lock_user, lock_cpu, lock_date, &error);
-
-      /* if locked get lock info */
-      if (error == MB_ERROR_FILE_LOCKED) {
-        fprintf(stderr, "\nFile %s locked but lock ignored\n", swathfile);
-        fprintf(stderr, "File locked by <%s> running <%s>\n", lock_user, lock_program);
-        fprintf(stderr, "on cpu <%s> at <%s>\n", lock_cpu, lock_date);
-        error = MB_ERROR_NO_ERROR;
-      }
+    else if (survey) {
+      /* apply the filters before the density filter while the edit files
+          are still open, and again after it once all files are read */
+      mbvoxelclean_filter_file(&control, file, &error);
+      mbvoxelclean_esf_suspend(file);
+      files.push_back(file);
     }
-
-    /* if locked let the user know file can't be opened */
-    if (status == MB_FAILURE) {
-      /* if locked get lock info */
-      if (error == MB_ERROR_FILE_LOCKED) {
-        int lock_purpose = MBP_LOCK_NONE;
-        mb_path lock_program = "";
-        mb_path lock_user = "";
-        mb_path lock_cpu = "";
-        /* lock_status = */ mb_pr_lockinfo(verbose, swathfile, &locked, &lock_purpose, lock_program, lock_user, lock_cpu,
-                   lock_date, &error);
-
-        fprintf(stderr, "\nUnable to open input file:\n");
-        fprintf(stderr, "  %s\n", swathfile);
-        fprintf(stderr, "File locked by <%s> running <%s>\n", lock_user, lock_program);
-        fprintf(stderr, "on cpu <%s> at <%s>\n", lock_cpu, lock_date);
-      }
-
-      /* else if unable to create lock file there is a permissions problem */
-      else if (error == MB_ERROR_OPEN_FAIL) {
-        fprintf(stderr, "Unable to create lock file\n");
-        fprintf(stderr, "for intended input file:\n");
-        fprintf(stderr, "  %s\n", swathfile);
-        fprintf(stderr, "-Likely permissions issue\n");
-      }
-
-      /* reset error and status */
-      oktoprocess = false;
-      status = MB_SUCCESS;
-      error = MB_ERROR_NO_ERROR;
-    }
-
-    /* proceed if file locked and format ok */
-    if (oktoprocess) {
-      /* check for *inf file, create if necessary, and load metadata */
-      int formatread = format;
-      struct mb_info_struct mb_info;
-      status = mb_get_info_datalist(verbose, swathfile, &formatread, &mb_info, lonflip, &error);
-
-      /* allocate space to store the bathymetry data */
-      if (npings_alloc <= mb_info.nrecords) {
-        status &= mb_reallocd(verbose, __FILE__, __LINE__, mb_info.nrecords * sizeof(struct mbvoxelclean_ping_struct),
-          (void **)&pings, &error);
-        if (error != MB_ERROR_NO_ERROR) {
-          char *message = nullptr;
-          mb_error(verbose, MB_ERROR_MEMORY_FAIL, &message);
-          fprintf(outfp, "\nMBIO Error allocating pings array:\n%s\n", message);
-          fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
-          mb_memory_clear(verbose, &error);
-          exit(error);
-        }
-        memset((void *)&pings[npings_alloc], 0, (mb_info.nrecords - npings_alloc) * sizeof(struct mbvoxelclean_ping_struct));
-        npings_alloc = mb_info.nrecords;
-      }
-      for (int i = 0; i<mb_info.nrecords; i++) {
-        if (pings[i].beams_bath_alloc < mb_info.nbeams_bath) {
-          if (error == MB_ERROR_NO_ERROR)
-            status &= mb_reallocd(verbose, __FILE__, __LINE__, mb_info.nbeams_bath * sizeof(char),
-                 (void **)&pings[i].beamflag, &error);
-          if (error == MB_ERROR_NO_ERROR)
-            status &= mb_reallocd(verbose, __FILE__, __LINE__, mb_info.nbeams_bath * sizeof(char),
-               (void **)&pings[i].beamflagorg, &error);
-          if (error == MB_ERROR_NO_ERROR)
-            status &= mb_reallocd(verbose, __FILE__, __LINE__, mb_info.nbeams_bath * sizeof(double),
-               (void **)&pings[i].bathacrosstrack, &error);
-          if (error == MB_ERROR_NO_ERROR)
-            status &= mb_reallocd(verbose, __FILE__, __LINE__, mb_info.nbeams_bath * sizeof(double),
-               (void **)&pings[i].bathz, &error);
-          if (error == MB_ERROR_NO_ERROR)
-            status &= mb_reallocd(verbose, __FILE__, __LINE__, mb_info.nbeams_bath * sizeof(double),
-               (void **)&pings[i].bathx, &error);
-          if (error == MB_ERROR_NO_ERROR)
-            status &= mb_reallocd(verbose, __FILE__, __LINE__, mb_info.nbeams_bath * sizeof(double),
-               (void **)&pings[i].bathy, &error);
-          if (error == MB_ERROR_NO_ERROR)
-            status &= mb_reallocd(verbose, __FILE__, __LINE__, mb_info.nbeams_bath * sizeof(double),
-               (void **)&pings[i].bathr, &error);
-          if (error != MB_ERROR_NO_ERROR) {
-            char *message = nullptr;
-            mb_error(verbose, MB_ERROR_MEMORY_FAIL, &message);
-            fprintf(outfp, "\nMBIO Error allocating data arrays within the ping structure:\n%s\n", message);
-            fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
-            mb_memory_clear(verbose, &error);
-            exit(error);
-          }
-          pings[i].beams_bath_alloc = mb_info.nbeams_bath;
-        }
-      }
-
-      /* define local cartesian coordinate system based on first ping navigation and heading */
-      double mtodeglon;
-      double mtodeglat;
-      mb_coor_scale(verbose, mb_info.lat_start, &mtodeglon, &mtodeglat);
-      const double headingx = sin(mb_info.heading_start * DTR);
-      const double headingy = cos(mb_info.heading_start * DTR);
-
-      /* check for "fast bathymetry" or "fbt" file */
-      strcpy(swathfileread, swathfile);
-      formatread = format;
-      mb_get_fbt(verbose, swathfileread, &formatread, &error);
-
-      /* if verbose output status */
-      if (verbose > 0) {
-        fprintf(stderr, "---------------------------------\n");
-        fprintf(stderr, "Processing %s...\n\tActually reading %s...\n", swathfile, swathfileread);
-      }
-
-      /* initialize reading the input swath sonar file */
-      void *mbio_ptr = nullptr;
-      if (mb_read_init(verbose, swathfileread, formatread, defaultpings, lonflip, bounds, btime_i, etime_i, speedmin,
-               timegap, &mbio_ptr, &btime_d, &etime_d, &beams_bath, &beams_amp, &pixels_ss, &error) !=
-          MB_SUCCESS) {
-        char *message = nullptr;
-        mb_error(verbose, error, &message);
-        fprintf(stderr, "\nMBIO Error returned from function <mb_read_init>:\n%s\n", message);
-        fprintf(stderr, "\nMultibeam File <%s> not initialized for reading\n", swathfile);
-        fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
-        exit(error);
-      }
-
-      /* initialize per-file counting variables */
-      int n_pings = 0;
-      int n_beams = 0;
-      int n_beamflag_null = 0;
-      int n_beamflag_good = 0;
-      int n_beamflag_flag = 0;
-      int n_esf_flag = 0;
-      int n_esf_unflag = 0;
-      int n_density_flag = 0;
-      int n_density_unflag = 0;
-      int n_minrange_flag = 0;
-      int n_maxrange_flag = 0;
-      int n_minacrosstrack_flag = 0;
-      int n_maxacrosstrack_flag = 0;
-      int n_minamplitude_flag = 0;
-      int n_maxamplitude_flag = 0;
-
-      /* allocate memory for mb_get() data arrays */
-      if (error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char),
-             (void **)&beamflag, &error);
-      if (error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(char),
-             (void **)&beamflagorg, &error);
-      if (error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double),
-             (void **)&bath, &error);
-      if (error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double),
-             (void **)&bathacrosstrack, &error);
-      if (error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_BATHYMETRY, sizeof(double),
-             (void **)&bathalongtrack, &error);
-      if (error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_AMPLITUDE, sizeof(double),
-             (void **)&amp, &error);
-      if (error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double),
-             (void **)&ss, &error);
-      if (error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double),
-              (void **)&ssacrosstrack, &error);
-      if (error == MB_ERROR_NO_ERROR)
-        status = mb_register_array(verbose, mbio_ptr, MB_MEM_TYPE_SIDESCAN, sizeof(double),
-              (void **)&ssalongtrack, &error);
-
-      /* if error initializing memory then quit */
-      if (error != MB_ERROR_NO_ERROR) {
-        char *message = nullptr;
-        mb_error(verbose, error, &message);
-        fprintf(stderr, "\nMBIO Error allocating data arrays:\n%s\n", message);
+    else {
+      /* apply the filters before and after the density filter */
+      mbvoxelclean_filter_file(&control, file, &error);
+      status = mbvoxelclean_density_filter(&control, &file, 1, &error);
+      if (status == MB_FAILURE) {
         fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
         exit(error);
       }
-
-      void *store_ptr = nullptr;
-      double x_min;
-      double x_max;
-      double y_min;
-      double y_max;
-      double z_min;
-      double z_max;
-
-      /* now deal with old edit save file */
-      if (status == MB_SUCCESS) {
-        /* reset message */
-        fprintf(stderr, "\tOpening edit save file...\n");
-
-        /* handle esf edits */
-        status = mb_esf_load(verbose, program_name, swathfile, true, true, esffile, &esf, &error);
-        if (status == MB_SUCCESS && esf.esffp != nullptr)
-          esffile_open = true;
-        if (status == MB_FAILURE && error == MB_ERROR_OPEN_FAIL) {
-          esffile_open = false;
-          fprintf(stderr, "\nUnable to open new edit save file %s\n", esf.esffile);
-        }
-        else if (status == MB_FAILURE && error == MB_ERROR_MEMORY_FAIL) {
-          esffile_open = false;
-          fprintf(stderr, "\nUnable to allocate memory for edits in esf file %s\n", esf.esffile);
-        }
-        /* reset message */
-        if (esf.nedit > 0) {
-          fprintf(stderr, "%d old edits sorted...\n", esf.nedit);
-        }
-      }
-
-      /* read */
-      bool done = false;
-      bool first = true;
-      while (!done) {
-        if (verbose > 1)
-          fprintf(stderr, "\n");
-
-        /* read next record */
-        error = MB_ERROR_NO_ERROR;
-        status = mb_get(verbose, mbio_ptr, &kind, &pingsread, time_i, &time_d, &navlon,
-            &navlat, &speed, &heading, &distance, &altitude, &sensordepth,
-            &beams_bath, &beams_amp, &pixels_ss, beamflag, bath, amp,
-            bathacrosstrack, bathalongtrack, ss, ssacrosstrack, ssalongtrack, comment,
-            &error);
-        if (verbose >= 2) {
-          fprintf(stderr, "\ndbg2  current data status:\n");
-          fprintf(stderr, "dbg2    kind:     %d\n", kind);
-          fprintf(stderr, "dbg2    status:   %d\n", status);
-        }
-        if (status == MB_SUCCESS && kind == MB_DATA_DATA) {
-          /* allocate space for data if needed */
-          if (beams_bath > pings[n_pings].beams_bath_alloc) {
-            if (error == MB_ERROR_NO_ERROR)
-              status &= mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(char),
-               (void **)&pings[n_pings].beamflag, &error);
-            if (error == MB_ERROR_NO_ERROR)
-              status &= mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(char),
-               (void **)&pings[n_pings].beamflagorg, &error);
-            if (error == MB_ERROR_NO_ERROR)
-              status &= mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
-               (void **)&pings[n_pings].bathacrosstrack, &error);
-            if (error == MB_ERROR_NO_ERROR)
-              status &= mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
-               (void **)&pings[n_pings].bathz, &error);
-            if (error == MB_ERROR_NO_ERROR)
-              status &= mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
-               (void **)&pings[n_pings].bathx, &error);
-            if (error == MB_ERROR_NO_ERROR)
-              status &= mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
-               (void **)&pings[n_pings].bathy, &error);
-            if (error == MB_ERROR_NO_ERROR)
-              status &= mb_reallocd(verbose, __FILE__, __LINE__, beams_bath * sizeof(double),
-               (void **)&pings[n_pings].bathr, &error);
-            if (error != MB_ERROR_NO_ERROR) {
-              char *message = nullptr;
-              mb_error(verbose, MB_ERROR_MEMORY_FAIL, &message);
-              fprintf(outfp, "\nMBIO Error allocating data arrays within the ping structure:\n%s\n", message);
-              fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
-              mb_memory_clear(verbose, &error);
-              exit(error);
-            }
-            pings[n_pings].beams_bath_alloc = beams_bath;
-          }
-
-          /* check for ping multiplicity */
-          status = mb_get_store(verbose, mbio_ptr, &store_ptr, &error);
-          const int sensorhead_status = mb_sensorhead(verbose, mbio_ptr, store_ptr, &sensorhead, &sensorhead_error);
-          if (sensorhead_status == MB_SUCCESS) {
-            pings[n_pings].multiplicity = sensorhead;
-          }
-          else if (n_pings > 0 && fabs(pings[n_pings].time_d - pings[n_pings - 1].time_d) < MB_ESF_MAXTIMEDIFF) {
-            pings[n_pings].multiplicity = pings[n_pings - 1].multiplicity + 1;
-          }
-          else {
-            pings[n_pings].multiplicity = 0;
-          }
-
-          /* save relevant data */
-          pings[n_pings].time_d = time_d;
-          pings[n_pings].navlon = navlon;
-          pings[n_pings].navlat = navlat;
-          pings[n_pings].heading = heading;
-          pings[n_pings].sensordepth = sensordepth;
-          pings[n_pings].beams_bath = beams_bath;
-          const double sensorx = (navlon - mb_info.lon_start) / mtodeglon;
-          const double sensory = (navlat - mb_info.lat_start) / mtodeglat;
-          const double sensorz = -sensordepth;
-          for (int j = 0; j < beams_bath; j++) {
-            pings[n_pings].beamflag[j] = beamflag[j];
-            pings[n_pings].beamflagorg[j] = beamflag[j];
-            if (!mb_beam_check_flag_null(beamflag[j])) {
-              pings[n_pings].bathacrosstrack[j] = bathacrosstrack[j];
-              pings[n_pings].bathx[j] = (navlon - mb_info.lon_start) / mtodeglon +
-                       headingy * bathacrosstrack[j] + headingx * bathalongtrack[j];
-              pings[n_pings].bathy[j] = (navlat - mb_info.lat_start) / mtodeglat -
-                       headingx * bathacrosstrack[j] + headingy * bathalongtrack[j];
-              pings[n_pings].bathz[j] = -bath[j];
-              pings[n_pings].bathr[j] = sqrt((pings[n_pings].bathx[j] - sensorx)
-                    * (pings[n_pings].bathx[j] - sensorx)
-                         + (pings[n_pings].bathy[j] - sensory)
-                    * (pings[n_pings].bathy[j] - sensory)
-                         + (pings[n_pings].bathz[j] - sensorz)
-                    * (pings[n_pings].bathz[j] - sensorz));
-              if (first) {
-                  x_min = pings[n_pings].bathx[j];
-                  x_max = pings[n_pings].bathx[j];
-                  y_min = pings[n_pings].bathy[j];
-                  y_max = pings[n_pings].bathy[j];
-                  z_min = pings[n_pings].bathz[j];
-                  z_max = pings[n_pings].bathz[j];
-                  first = false;
-              } else {
-                  x_min = std::min(x_min, pings[n_pings].bathx[j]);
-                  x_max = std::max(x_max, pings[n_pings].bathx[j]);
-                  y_min = std::min(y_min, pings[n_pings].bathy[j]);
-                  y_max = std::max(y_max, pings[n_pings].bathy[j]);
-                  z_min = std::min(z_min, pings[n_pings].bathz[j]);
-                  z_max = std::max(z_max, pings[n_pings].bathz[j]);
-              }
-
-              // apply amplitude filter here where amplitude values are available
-              // = note that a density unflag setting could undo flags defined here
-              if (apply_amplitude_minimum || apply_amplitude_maximum) {
-                if (mb_beam_ok(pings[n_pings].beamflag[j])) {
-                  if (apply_amplitude_minimum && amp[j] < amplitude_minimum) {
-                    pings[n_pings].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                    const int action = MBP_EDIT_FILTER;
-                    mb_ess_save(verbose, &esf, pings[n_pings].time_d,
-                        j + pings[n_pings].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                        action, &error);
-                    n_minamplitude_flag++;
-                  }
-                  if (apply_amplitude_maximum && amp[j] > amplitude_maximum) {
-                    pings[n_pings].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                    const int action = MBP_EDIT_FILTER;
-                    mb_ess_save(verbose, &esf, pings[n_pings].time_d,
-                        j + pings[n_pings].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                        action, &error);
-                    n_maxamplitude_flag++;
-                  }
-                }
-              }
-
-            } else {
-              pings[n_pings].bathacrosstrack[j] = 0.0;
-              pings[n_pings].bathx[j] = 0.0;
-              pings[n_pings].bathy[j] = 0.0;
-              pings[n_pings].bathz[j] = 0.0;
-              pings[n_pings].bathr[j] = 0.0;
-            }
-          }
-          if (verbose >= 2) {
-            fprintf(stderr, "\ndbg2  beam locations (ping:beam xxx.xxx yyy.yyy zzz.zzz)\n");
-            for (int j = 0; j < pings[n_pings].beams_bath; j++) {
-              fprintf(stderr, "dbg2    %d:%3.3d %10.3f %10.3f %10.3f\n",
-              n_pings, j, pings[n_pings].bathx[j],
-              pings[n_pings].bathy[j], pings[n_pings].bathz[j]);
-            }
-
-            fprintf(stderr, "\ndbg2  current voxel bounds:\n");
-            fprintf(stderr, "dbg2    x_min: %10.3f m\n", x_min);
-            fprintf(stderr, "dbg2    x_max: %10.3f m\n", x_max);
-            fprintf(stderr, "dbg2    y_min: %10.3f m\n", y_min);
-            fprintf(stderr, "dbg2    y_max: %10.3f m\n", y_max);
-            fprintf(stderr, "dbg2    z_min: %10.3f m\n", z_min);
-            fprintf(stderr, "dbg2    z_max: %10.3f m\n", z_max);
-          }
-
-          /* update counters */
-          for (int j = 0; j < pings[n_pings].beams_bath; j++) {
-            if (mb_beam_ok(pings[n_pings].beamflag[j]))
-                 n_beamflag_good++;
-            else if (pings[n_pings].beamflag[j] == MB_FLAG_NULL)
-                n_beamflag_null++;
-            else
-                n_beamflag_flag++;
-          }
-
-          /* apply saved edits */
-          status &= mb_esf_apply(verbose, &esf, pings[n_pings].time_d, pings[n_pings].multiplicity, pings[n_pings].beams_bath,
-                    pings[n_pings].beamflag, &error);
-
-          /* update counters */
-          for (int j = 0; j < pings[n_pings].beams_bath; j++) {
-            if (pings[n_pings].beamflag[j] != pings[n_pings].beamflagorg[j]) {
-              if (mb_beam_ok(pings[n_pings].beamflag[j]))
-                n_esf_unflag++;
-              else
-                n_esf_flag++;
-            }
-          }
-          n_beams += pings[n_pings].beams_bath;
-          n_pings++;
-
-        }
-        else if (error > MB_ERROR_NO_ERROR) {
-          done = true;
-        }
-      }
-
-      /* close the swath file */
-      status = mb_close(verbose, &mbio_ptr, &error);
-
-      /* apply acrosstrack filter to the soundings */
-      if (apply_acrosstrack_minimum || apply_acrosstrack_maximum) {
-        for (int i = 0; i < n_pings; i++) {
-          for (int j = 0; j< pings[i].beams_bath; j++) {
-            if (!mb_beam_check_flag_null(pings[i].beamflag[j])) {
-              if (apply_acrosstrack_minimum
-                && mb_beam_ok(pings[i].beamflag[j])
-                && pings[i].bathacrosstrack[j] < acrosstrack_minimum) {
-                pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                const int action = MBP_EDIT_FILTER;
-                mb_ess_save(verbose, &esf, pings[i].time_d,
-                    j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                    action, &error);
-                n_minacrosstrack_flag++;
-              } else if (apply_acrosstrack_maximum
-                && mb_beam_ok(pings[i].beamflag[j])
-                && pings[i].bathacrosstrack[j] > acrosstrack_maximum) {
-                pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                const int action = MBP_EDIT_FILTER;
-                mb_ess_save(verbose, &esf, pings[i].time_d,
-                    j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                    action, &error);
-                n_maxacrosstrack_flag++;
-              }
-            }
-          }
-        }
-      }
-
-      /* apply range filter to the soundings */
-      if (apply_range_minimum || apply_range_maximum) {
-        for (int i = 0; i < n_pings; i++) {
-          for (int j = 0; j< pings[i].beams_bath; j++) {
-            if (!mb_beam_check_flag_null(pings[i].beamflag[j])) {
-              if (apply_range_minimum
-                && mb_beam_ok(pings[i].beamflag[j])
-                && pings[i].bathr[j] < range_minimum) {
-                pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                const int action = MBP_EDIT_FILTER;
-                mb_ess_save(verbose, &esf, pings[i].time_d,
-                    j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                    action, &error);
-                n_minrange_flag++;
-              } else if (apply_range_maximum
-                && mb_beam_ok(pings[i].beamflag[j])
-                && pings[i].bathr[j] > range_maximum) {
-                pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                const int action = MBP_EDIT_FILTER;
-                mb_ess_save(verbose, &esf, pings[i].time_d,
-                    j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                    action, &error);
-                n_maxrange_flag++;
-              }
-            }
-          }
-        }
-      }
-
-      // allocate arrays of voxel beam counts - use unsigned char so that beam
-      // counts are capped at 255 - ergo the maximum occupied count threshold
-      // is 254
-      const int n_voxel_x = (x_max - x_min) / voxel_size_xy + 3;
-      x_min = x_min - 0.5 * voxel_size_xy;
-      x_max = x_min + n_voxel_x * voxel_size_xy;
-      const int n_voxel_y = (x_max - y_min) / voxel_size_xy + 3;
-      y_min = y_min - 0.5 * voxel_size_xy;
-      y_max = y_min + n_voxel_y * voxel_size_xy;
-      const int n_voxel_z = (z_max - z_min) / voxel_size_z + 3;
-      z_min = z_min - 0.5 * voxel_size_z;
-      z_max = z_min + n_voxel_z * voxel_size_z;
-      int n_voxel = n_voxel_x * n_voxel_y * n_voxel_z;
-      if (verbose >= 2) {
-        fprintf(stderr, "\ndbg2  final voxel bounds:\n");
-        fprintf(stderr, "dbg2    x_min:      %10.3f m\n", x_min);
-        fprintf(stderr, "dbg2    x_max:      %10.3f m\n", x_max);
-        fprintf(stderr, "dbg2    y_min:      %10.3f m\n", y_min);
-        fprintf(stderr, "dbg2    y_max:      %10.3f m\n", y_max);
-        fprintf(stderr, "dbg2    z_min:      %10.3f m\n", z_min);
-        fprintf(stderr, "dbg2    z_max:      %10.3f m\n", z_max);
-        fprintf(stderr, "dbg2    n_voxel_x:  %d\n", n_voxel_x);
-        fprintf(stderr, "dbg2    n_voxel_y:  %d\n", n_voxel_y);
-        fprintf(stderr, "dbg2    n_voxel_z:  %d\n", n_voxel_z);
-        fprintf(stderr, "dbg2    n_voxel:    %d\n", n_voxel);
-      }
-      if (n_voxel_alloc < n_voxel) {
-        status &= mb_reallocd(verbose, __FILE__, __LINE__, (size_t)n_voxel,
-             (void **)&voxel_count, &error);
-        if (error != MB_ERROR_NO_ERROR) {
-          char *message = nullptr;
-          mb_error(verbose, MB_ERROR_MEMORY_FAIL, &message);
-          fprintf(outfp, "\nMBIO Error allocating voxel counting arrays:\n%s\n", message);
-          fprintf(outfp, "\nProgram <%s> Terminated\n", program_name);
-          mb_memory_clear(verbose, &error);
-          exit(error);
-        }
-        memset((void *)voxel_count, 0, (size_t)n_voxel);
-        n_voxel_alloc = n_voxel;
-      }
-
-      /* count the soundings in each voxel */
-      for (int i = 0; i < n_pings; i++) {
-        for (int j = 0; j< pings[i].beams_bath; j++) {
-          if (!mb_beam_check_flag_null(pings[i].beamflag[j])) {
-            const int ix = (pings[i].bathx[j] - x_min) / voxel_size_xy;
-            const int iy = (pings[i].bathy[j] - y_min) / voxel_size_xy;
-            const int iz = (pings[i].bathz[j] - z_min) / voxel_size_z;
-            const int kk = (ix * n_voxel_y + iy) * n_voxel_z + iz;
-            if ((mb_beam_ok(pings[i].beamflag[j]) || count_flagged) && voxel_count[kk] < 254) {
-              voxel_count[kk]++;
-            }
-          }
-        }
-      }
-
-      // apply neighborhood to extend occupied region
-      if (neighborhood > 0) {
-
-        for (int ix=0; ix<n_voxel_x; ix++) {
-          for (int iy=0; iy<n_voxel_y; iy++) {
-            for (int iz=0; iz<n_voxel_z; iz++) {
-              const int kk = (ix * n_voxel_y + iy) * n_voxel_z + iz;
-
-              if (voxel_count[kk] >= occupy_threshold && voxel_count[kk] < 255) {
-                for (int iix=std::max(ix-neighborhood,0); iix<std::min(ix+neighborhood+1,n_voxel_x); iix++) {
-                  for (int iiy=std::max(iy-neighborhood,0); iiy<std::min(iy+neighborhood+1,n_voxel_y); iiy++) {
-                    for (int iiz=std::max(iz-neighborhood,0); iiz<std::min(iz+neighborhood+1,n_voxel_z); iiz++) {
-                      const int kkk = (iix * n_voxel_y + iiy) * n_voxel_z + iiz;
-                      if (voxel_count[kkk] < occupy_threshold) {
-                        voxel_count[kkk] = 255;
-                      }
-                    }
-                  }
-                }
-              }
-
-            }
-          }
-        }
-      }
-
-      // apply threshold to generate binary mask of occupied voxels
-      for (int kk = 0; kk < n_voxel; kk++) {
-        if (voxel_count[kk] >= occupy_threshold) {
-          voxel_count[kk] = 1;
-        }
-        else if (voxel_count[kk] < occupy_threshold) {
-          voxel_count[kk] = 0;
-        }
-      }
-
-      /* apply density filter to the soundings  */
-      if (occupied_mode == MBVC_OCCUPIED_UNFLAG || empty_mode == MBVC_EMPTY_FLAG) {
-        for (int i = 0; i < n_pings; i++) {
-          for (int j = 0; j < pings[i].beams_bath; j++) {
-            if (!mb_beam_check_flag_null(pings[i].beamflag[j])) {
-              const int ix = (pings[i].bathx[j] - x_min) / voxel_size_xy;
-              const int iy = (pings[i].bathy[j] - y_min) / voxel_size_xy;
-              const int iz = (pings[i].bathz[j] - z_min) / voxel_size_z;
-              const int kk = (ix * n_voxel_y + iy) * n_voxel_z + iz;
-              if (occupied_mode == MBVC_OCCUPIED_UNFLAG
-                && voxel_count[kk]
-                && !mb_beam_ok(pings[i].beamflag[j])) {
-                pings[i].beamflag[j] = MB_FLAG_NONE;
-                const int action = MBP_EDIT_UNFLAG;
-                mb_ess_save(verbose, &esf, pings[i].time_d,
-                    j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                    action, &error);
-                n_density_unflag++;
-              }
-              if (empty_mode == MBVC_EMPTY_FLAG
-                && !voxel_count[kk]
-                && mb_beam_ok(pings[i].beamflag[j])) {
-                pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                const int action = MBP_EDIT_FILTER;
-                mb_ess_save(verbose, &esf, pings[i].time_d,
-                      j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                      action, &error);
-                n_density_flag++;
-              }
-            }
-          }
-        }
-      }
-
-      /* apply acrosstrack filter to the soundings */
-      if (apply_acrosstrack_minimum || apply_acrosstrack_maximum) {
-        for (int i = 0; i < n_pings; i++) {
-          for (int j = 0; j< pings[i].beams_bath; j++) {
-            if (!mb_beam_check_flag_null(pings[i].beamflag[j])) {
-              if (apply_acrosstrack_minimum
-                && mb_beam_ok(pings[i].beamflag[j])
-                && pings[i].bathacrosstrack[j] < acrosstrack_minimum) {
-                pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                const int action = MBP_EDIT_FILTER;
-                mb_ess_save(verbose, &esf, pings[i].time_d,
-                    j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                    action, &error);
-                n_minacrosstrack_flag++;
-              } else if (apply_acrosstrack_maximum
-                && mb_beam_ok(pings[i].beamflag[j])
-                && pings[i].bathacrosstrack[j] > acrosstrack_maximum) {
-                pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                const int action = MBP_EDIT_FILTER;
-                mb_ess_save(verbose, &esf, pings[i].time_d,
-                    j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                    action, &error);
-                n_maxacrosstrack_flag++;
-              }
-            }
-          }
-        }
-      }
-
-      /* apply range filter to the soundings */
-      if (apply_range_minimum || apply_range_maximum) {
-        for (int i = 0; i < n_pings; i++) {
-          for (int j = 0; j< pings[i].beams_bath; j++) {
-            if (!mb_beam_check_flag_null(pings[i].beamflag[j])) {
-              if (apply_range_minimum
-                && mb_beam_ok(pings[i].beamflag[j])
-                && pings[i].bathr[j] < range_minimum) {
-                pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                const int action = MBP_EDIT_FILTER;
-                mb_ess_save(verbose, &esf, pings[i].time_d,
-                    j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                    action, &error);
-                n_minrange_flag++;
-              } else if (apply_range_maximum
-                && mb_beam_ok(pings[i].beamflag[j])
-                && pings[i].bathr[j] > range_maximum) {
-                pings[i].beamflag[j] = MB_FLAG_FLAG + MB_FLAG_FILTER;
-                const int action = MBP_EDIT_FILTER;
-                mb_ess_save(verbose, &esf, pings[i].time_d,
-                    j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR,
-                    action, &error);
-                n_maxrange_flag++;
-              }
-            }
-          }
-        }
-      }
-
-      /* write out edits for beamflags that have changed  */
-      for (int i = 0; i < n_pings; i++) {
-        for (int j = 0; j< pings[i].beams_bath; j++) {
-          if (pings[i].beamflag[j] != pings[i].beamflagorg[j]) {
-            int action = MBP_EDIT_ZERO;
-            if (mb_beam_ok(pings[i].beamflag[j])) {
-              action = MBP_EDIT_UNFLAG;
-            }
-            else if (mb_beam_check_flag_filter2(pings[i].beamflag[j])) {
-              action = MBP_EDIT_FILTER;
-            }
-            else if (mb_beam_check_flag_filter(pings[i].beamflag[j])) {
-              action = MBP_EDIT_FILTER;
-            }
-            else if (pings[i].beamflag[j] != MB_FLAG_NULL) {
-              action = MBP_EDIT_FLAG;
-            }
-            else {
-              action = MBP_EDIT_ZERO;
-            }
-            mb_esf_save(verbose, &esf, pings[i].time_d,
-                        j + pings[i].multiplicity * MB_ESF_MULTIPLICITY_FACTOR, action, &error);
-          }
-        }
-      }
-
-      /* close edit save file */
-      status = mb_esf_close(verbose, &esf, &error);
-
-      /* update mbprocess parameter file */
-      if (esffile_open) {
-        /* update mbprocess parameter file */
-        status = mb_pr_update_format(verbose, swathfile, true, format, &error);
-        status = mb_pr_update_edit(verbose, swathfile, MBP_EDIT_ON, esffile, &error);
-      }
-
-      /* unlock the raw swath file */
-      if (uselockfiles)
-        status = mb_pr_unlockswathfile(verbose, swathfile, MBP_LOCK_EDITBATHY, program_name, &error);
-
-      /* check memory */
-      if (verbose >= 4)
-        status = mb_memory_list(verbose, &error);
-
-      /* increment the total counting variables */
-      n_files_tot++;
-      n_pings_tot += n_pings;
-      n_beams_tot += n_beams;
-      n_beamflag_null_tot += n_beamflag_null;
-      n_beamflag_good_tot += n_beamflag_good;
-      n_beamflag_flag_tot += n_beamflag_flag;
-      n_esf_flag_tot += n_esf_flag;
-      n_esf_unflag_tot += n_esf_unflag;
-      n_density_flag_tot += n_density_flag;
-      n_density_unflag_tot += n_density_unflag;
-      n_minrange_flag_tot += n_minrange_flag;
-      n_maxrange_flag_tot += n_maxrange_flag;
-      n_minacrosstrack_flag_tot += n_minacrosstrack_flag;
-      n_maxacrosstrack_flag_tot += n_maxacrosstrack_flag;
-      n_minamplitude_flag_tot += n_minamplitude_flag;
-      n_maxamplitude_flag_tot += n_maxamplitude_flag;
-
-      /* give the statistics */
-      if (verbose >= 1) {
-        fprintf(stderr, "%7d survey data records processed\n", n_pings);
-        fprintf(stderr, "%7d soundings processed\n", n_beams);
-        fprintf(stderr, "%7d beams good originally\n", n_beamflag_good);
-        fprintf(stderr, "%7d beams flagged originally\n", n_beamflag_flag);
-        fprintf(stderr, "%7d beams null originally\n", n_beamflag_null);
-        if (esf.nedit > 0) {
-          fprintf(stderr, "%7d beams flagged in old esf file\n", n_esf_flag);
-          fprintf(stderr, "%7d beams unflagged in old esf file\n", n_esf_unflag);
-        }
-        fprintf(stderr, "%7d beams flagged by density filter\n", n_density_flag);
-        fprintf(stderr, "%7d beams unflagged by density filter\n", n_density_unflag);
-        fprintf(stderr, "%7d beams flagged by minimum range filter\n", n_minrange_flag);
-        fprintf(stderr, "%7d beams flagged by maximum range filter\n", n_maxrange_flag);
-        fprintf(stderr, "%7d beams flagged by minimum acrosstrack filter\n", n_minacrosstrack_flag);
-        fprintf(stderr, "%7d beams flagged by maximum acrosstrack filter\n", n_maxacrosstrack_flag);
-        fprintf(stderr, "%7d beams flagged by minimum amplitude filter\n", n_minamplitude_flag);
-        fprintf(stderr, "%7d beams flagged by maximum amplitude filter\n", n_maxamplitude_flag);
-      }
+      mbvoxelclean_filter_file(&control, file, &error);
+      mbvoxelclean_write_file(&control, file, &error);
+      mbvoxelclean_count_add(&count_tot, &file->count);
+      mbvoxelclean_file_free(&control, file, &error);
+      delete file;
     }
 
     /* figure out whether and what to read next */
@@ -1247,41 +1652,53 @@ int main(int argc, char **argv) {
   if (read_datalist)
     mb_datalist_close(verbose, &datalist, &error);
 
+  /* clean the whole survey at once, all files contributing to the voxel
+      occupancy before any edits are written */
+  if (survey && !files.empty()) {
+    if (verbose > 0) {
+      fprintf(stderr, "---------------------------------\n");
+      fprintf(stderr, "Applying density filter to %zu files...\n", files.size());
+    }
+    status = mbvoxelclean_density_filter(&control, files.data(), (int)files.size(), &error);
+    if (status == MB_FAILURE) {
+      fprintf(stderr, "\nProgram <%s> Terminated\n", program_name);
+      exit(error);
+    }
+
+    /* filter and write the edits one file at a time */
+    for (auto file : files) {
+      mbvoxelclean_esf_resume(file);
+      mbvoxelclean_filter_file(&control, file, &error);
+      mbvoxelclean_write_file(&control, file, &error);
+      mbvoxelclean_count_add(&count_tot, &file->count);
+      mbvoxelclean_file_free(&control, file, &error);
+      delete file;
+    }
+    files.clear();
+  }
+
   /* give the total statistics */
   if (verbose > 0) {
     fprintf(stderr, "\n---------------------------------\n");
     fprintf(stderr, "MBvoxelclean Processing Totals:\n");
     fprintf(stderr, "---------------------------------\n");
-    fprintf(stderr, "%d total swath data files processed\n", n_files_tot);
-    fprintf(stderr, "%d total survey data records processed\n", n_pings_tot);
-    fprintf(stderr, "%d total soundings processed\n", n_beams_tot);
-    fprintf(stderr, "%d total beams good originally\n", n_beamflag_good_tot);
-    fprintf(stderr, "%d total beams flagged originally\n", n_beamflag_flag_tot);
-    fprintf(stderr, "%d total beams null originally\n", n_beamflag_null_tot);
-    fprintf(stderr, "%d total beams flagged in old esf file\n", n_esf_flag_tot);
-    fprintf(stderr, "%d total beams unflagged in old esf file\n", n_esf_unflag_tot);
-    fprintf(stderr, "%d total beams flagged by density filter\n", n_density_flag_tot);
-    fprintf(stderr, "%d total beams unflagged by density filter\n", n_density_unflag_tot);
-    fprintf(stderr, "%d total beams flagged by minimum range filter\n", n_minrange_flag_tot);
-    fprintf(stderr, "%d total beams flagged by maximum range filter\n", n_maxrange_flag_tot);
-    fprintf(stderr, "%d total beams flagged by minimum acrosstrack filter\n", n_minacrosstrack_flag_tot);
-    fprintf(stderr, "%d total beams flagged by maximum acrosstrack filter\n", n_maxacrosstrack_flag_tot);
-    fprintf(stderr, "%d total beams flagged by minimum amplitude filter\n", n_minamplitude_flag_tot);
-    fprintf(stderr, "%d total beams flagged by maximum amplitude filter\n", n_maxamplitude_flag_tot);
-  }
-
-  for (int i = 0; i<npings_alloc; i++) {
-    status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&pings[i].beamflag, &error);
-    status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&pings[i].beamflagorg, &error);
-    status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&pings[i].bathacrosstrack, &error);
-    status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&pings[i].bathz, &error);
-    status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&pings[i].bathx, &error);
-    status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&pings[i].bathy, &error);
-    status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&pings[i].bathr, &error);
-    pings[i].beams_bath_alloc = 0;
+    fprintf(stderr, "%d total swath data files processed\n", count_tot.n_files);
+    fprintf(stderr, "%d total survey data records processed\n", count_tot.n_pings);
+    fprintf(stderr, "%d total soundings processed\n", count_tot.n_beams);
+    fprintf(stderr, "%d total beams good originally\n", count_tot.n_beamflag_good);
+    fprintf(stderr, "%d total beams flagged originally\n", count_tot.n_beamflag_flag);
+    fprintf(stderr, "%d total beams null originally\n", count_tot.n_beamflag_null);
+    fprintf(stderr, "%d total beams flagged in old esf file\n", count_tot.n_esf_flag);
+    fprintf(stderr, "%d total beams unflagged in old esf file\n", count_tot.n_esf_unflag);
+    fprintf(stderr, "%d total beams flagged by density filter\n", count_tot.n_density_flag);
+    fprintf(stderr, "%d total beams unflagged by density filter\n", count_tot.n_density_unflag);
+    fprintf(stderr, "%d total beams flagged by minimum range filter\n", count_tot.n_minrange_flag);
+    fprintf(stderr, "%d total beams flagged by maximum range filter\n", count_tot.n_maxrange_flag);
+    fprintf(stderr, "%d total beams flagged by minimum acrosstrack filter\n", count_tot.n_minacrosstrack_flag);
+    fprintf(stderr, "%d total beams flagged by maximum acrosstrack filter\n", count_tot.n_maxacrosstrack_flag);
+    fprintf(stderr, "%d total beams flagged by minimum amplitude filter\n", count_tot.n_minamplitude_flag);
+    fprintf(stderr, "%d total beams flagged by maximum amplitude filter\n", count_tot.n_maxamplitude_flag);
   }
-  status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&pings, &error);
-  status &= mb_freed(verbose, __FILE__, __LINE__, (void **)&voxel_count, &error);
 
   /* check memory */
   if ((status = mb_memory_list(verbose, &error)) == MB_FAILURE) {
@@ -0,0 +1,129 @@
+// See README file for copying and redistribution conditions.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include "mb_define.h"
+#include "mb_info.h"
+#include "mb_status.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Writes an inf file with a 4 by 4 coverage mask covering only the
+// south west cell, dated in the past so that it may be cached.
+class MbCheckInfoTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    char tmpdir[] = "/tmp/mb_check_info_test_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(tmpdir));
+    dir_ = tmpdir;
+    file_ = dir_ + "/data.mb88";
+    WriteInf(1234, 10.0);
+  }
+
+  void TearDown() override {
+    unlink((file_ + ".inf").c_str());
+    unlink((file_ + ".inb").c_str());
+    rmdir(dir_.c_str());
+  }
+
+  void WriteInf(int nrecords, double lon_min) {
+    const std::string file_inf = file_ + ".inf";
+    FILE *fp = fopen(file_inf.c_str(), "w");
+    ASSERT_NE(nullptr, fp);
+    fprintf(fp, "Number of Records: %d\n", nrecords);
+    fprintf(fp, "Bathymetry Data (400 beams):\n");
+    fprintf(fp, "  Number of Beams:         %8d\n", 400 * nrecords);
+    fprintf(fp, "  Number of Good Beams:    %8d\n", 300 * nrecords);
+    fprintf(fp, "  Number of Zero Beams:    %8d\n", 0);
+    fprintf(fp, "  Number of Flagged Beams: %8d\n", 100 * nrecords);
+    fprintf(fp, "Total Time:            2.5000 hours\n");
+    fprintf(fp, "Minimum Longitude:   %10.6f   Maximum Longitude:   %10.6f\n", lon_min, lon_min + 4.0);
+    fprintf(fp, "Minimum Latitude:     20.000000   Maximum Latitude:     24.000000\n");
+    fprintf(fp, "Minimum Depth:       100.0000   Maximum Depth:      2000.0000\n");
+    fprintf(fp, "PN: 3 DATA PROBLEM (ID=%d): too fast\n", MB_PROBLEM_TOO_FAST);
+    fprintf(fp, "CM dimensions: 4 4\n");
+    fprintf(fp, "CM:   0 0 0 0\n");
+    fprintf(fp, "CM:   0 0 0 0\n");
+    fprintf(fp, "CM:   0 0 0 0\n");
+    fprintf(fp, "CM:   1 0 0 0\n");
+    fclose(fp);
+    struct utimbuf times;
+    times.actime = times.modtime = 1000000000;
+    ASSERT_EQ(0, utime(file_inf.c_str(), &times));
+  }
+
+  bool InBounds(double west, double east, double south, double north) {
+    double bounds[4] = {west, east, south, north};
+    bool file_in_bounds = false;
+    int error = MB_ERROR_NO_ERROR;
+    EXPECT_EQ(MB_SUCCESS, mb_check_info(0, &file_[0], 0, bounds, &file_in_bounds, &error));
+    return file_in_bounds;
+  }
+
+  std::string dir_;
+  std::string file_;
+};
+
+TEST_F(MbCheckInfoTest, GetInfoUsesSidecar) {
+  struct stat file_status;
+  for (int pass = 0; pass < 2; pass++) {
+    struct mb_info_struct mb_info;
+    int error = MB_ERROR_NO_ERROR;
+    ASSERT_EQ(MB_SUCCESS, mb_get_info(0, &file_[0], &mb_info, 0, &error));
+    EXPECT_STREQ(file_.c_str(), mb_info.file);
+    EXPECT_EQ(1234, mb_info.nrecords);
+    EXPECT_EQ(400, mb_info.nbeams_bath);
+    EXPECT_EQ(300 * 1234, mb_info.nbeams_bath_good);
+    EXPECT_EQ(100 * 1234, mb_info.nbeams_bath_flagged);
+    EXPECT_DOUBLE_EQ(2.5, mb_info.time_total);
+    EXPECT_DOUBLE_EQ(10.0, mb_info.lon_min);
+    EXPECT_DOUBLE_EQ(24.0, mb_info.lat_max);
+    EXPECT_DOUBLE_EQ(2000.0, mb_info.depth_max);
+    EXPECT_EQ(3, mb_info.problem_toofast);
+    EXPECT_EQ(0, stat((file_ + ".inb").c_str(), &file_status));
+  }
+}
+
+TEST_F(MbCheckInfoTest, CheckInfoUsesMask) {
+  for (int pass = 0; pass < 2; pass++) {
+    EXPECT_TRUE(InBounds(10.5, 10.8, 20.5, 20.8));
+    EXPECT_FALSE(InBounds(13.2, 13.8, 23.2, 23.8));
+    EXPECT_FALSE(InBounds(0.0, 5.0, 20.0, 24.0));
+  }
+}
+
+TEST_F(MbCheckInfoTest, RewrittenInfReplacesSidecar) {
+  struct mb_info_struct mb_info;
+  int error = MB_ERROR_NO_ERROR;
+  ASSERT_EQ(MB_SUCCESS, mb_get_info(0, &file_[0], &mb_info, 0, &error));
+  EXPECT_EQ(1234, mb_info.nrecords);
+
+  // same modification time but a different size
+  WriteInf(12345, 190.0);
+  ASSERT_EQ(MB_SUCCESS, mb_get_info(0, &file_[0], &mb_info, 0, &error));
+  EXPECT_EQ(12345, mb_info.nrecords);
+  EXPECT_DOUBLE_EQ(-170.0, mb_info.lon_min);
+  ASSERT_EQ(MB_SUCCESS, mb_get_info(0, &file_[0], &mb_info, 1, &error));
+  EXPECT_DOUBLE_EQ(190.0, mb_info.lon_min);
+}
+
+TEST_F(MbCheckInfoTest, MissingInf) {
+  unlink((file_ + ".inf").c_str());
+  struct mb_info_struct mb_info;
+  int error = MB_ERROR_NO_ERROR;
+  EXPECT_EQ(MB_FAILURE, mb_get_info(0, &file_[0], &mb_info, 0, &error));
+  EXPECT_EQ(MB_ERROR_OPEN_FAIL, error);
+  EXPECT_TRUE(InBounds(100.0, 101.0, 0.0, 1.0));
+}
+
+}  // namespace
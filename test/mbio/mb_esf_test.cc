@@ -0,0 +1,105 @@
+// See README file for copying and redistribution conditions.
+
+#include <cstring>
+#include <vector>
+
+#include "mb_define.h"
+#include "mb_process.h"
+#include "mb_status.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+const int kBeams = 16;
+
+class MbEsfApplyTest : public testing::Test {
+ protected:
+  void SetUp() override { memset(&esf_, 0, sizeof(esf_)); }
+
+  void TearDown() override {
+    int error = MB_ERROR_NO_ERROR;
+    EXPECT_EQ(MB_SUCCESS, mb_esf_close(0, &esf_, &error));
+  }
+
+  // Edits must be given in time order, as mb_esf_load() leaves them.
+  void SetEdits(const std::vector<mb_edit_struct> &edits, int mode = MB_ESF_MODE_EXPLICIT) {
+    int error = MB_ERROR_NO_ERROR;
+    esf_.version = 3;
+    esf_.mode = mode;
+    esf_.nedit = edits.size();
+    ASSERT_EQ(MB_SUCCESS, mb_mallocd(0, __FILE__, __LINE__, edits.size() * sizeof(mb_edit_struct),
+                                     reinterpret_cast<void **>(&esf_.edit), &error));
+    memcpy(esf_.edit, edits.data(), edits.size() * sizeof(mb_edit_struct));
+  }
+
+  std::vector<char> Apply(double time_d, int pingmultiplicity = 0) {
+    std::vector<char> beamflag(kBeams, MB_FLAG_NONE);
+    int error = MB_ERROR_NO_ERROR;
+    EXPECT_EQ(MB_SUCCESS, mb_esf_apply(0, &esf_, time_d, pingmultiplicity, kBeams, beamflag.data(), &error));
+    return beamflag;
+  }
+
+  mb_esf_struct esf_;
+};
+
+TEST_F(MbEsfApplyTest, NoEdits) {
+  SetEdits({});
+  for (char flag : Apply(100.0))
+    EXPECT_EQ(MB_FLAG_NONE, flag);
+}
+
+// Pings read out of time order still find their own edits, and only those.
+TEST_F(MbEsfApplyTest, PingsInAnyOrder) {
+  std::vector<mb_edit_struct> edits;
+  for (int iping = 0; iping < 50; iping++)
+    edits.push_back({100.0 + iping, iping % kBeams, MBP_EDIT_FLAG, 0});
+  SetEdits(edits);
+
+  for (int iping : {37, 2, 49, 0, 18, 18}) {
+    const std::vector<char> beamflag = Apply(100.0 + iping);
+    for (int i = 0; i < kBeams; i++) {
+      if (i == iping % kBeams)
+        EXPECT_TRUE(mb_beam_check_flag_manual(beamflag[i])) << iping << " " << i;
+      else
+        EXPECT_EQ(MB_FLAG_NONE, beamflag[i]) << iping << " " << i;
+    }
+  }
+
+  // a ping without edits between two edited pings
+  for (char flag : Apply(110.5))
+    EXPECT_EQ(MB_FLAG_NONE, flag);
+}
+
+// Edits of one beam are applied in the order they were made.
+TEST_F(MbEsfApplyTest, LastEditWins) {
+  SetEdits({{200.0, 3, MBP_EDIT_FLAG, 0},
+            {200.0, 5, MBP_EDIT_FLAG, 0},
+            {200.0, 3, MBP_EDIT_UNFLAG, 0},
+            {200.0, 5, MBP_EDIT_ZERO, 0}});
+  const std::vector<char> beamflag = Apply(200.0);
+  EXPECT_EQ(MB_FLAG_NONE, beamflag[3]);
+  EXPECT_EQ(MB_FLAG_NULL, beamflag[5]);
+}
+
+// Pings sharing a timestamp are told apart by the beam number offset.
+TEST_F(MbEsfApplyTest, PingMultiplicity) {
+  SetEdits({{300.0, 2, MBP_EDIT_FLAG, 0}, {300.0, MB_ESF_MULTIPLICITY_FACTOR + 7, MBP_EDIT_FLAG, 0}});
+  std::vector<char> beamflag = Apply(300.0, 0);
+  EXPECT_TRUE(mb_beam_check_flag_manual(beamflag[2]));
+  EXPECT_EQ(MB_FLAG_NONE, beamflag[7]);
+  beamflag = Apply(300.0, 1);
+  EXPECT_EQ(MB_FLAG_NONE, beamflag[2]);
+  EXPECT_TRUE(mb_beam_check_flag_manual(beamflag[7]));
+}
+
+// In implicit null mode beams without edits are nulled.
+TEST_F(MbEsfApplyTest, ImplicitNull) {
+  SetEdits({{400.0, 4, MBP_EDIT_UNFLAG, 0}}, MB_ESF_MODE_IMPLICIT_NULL);
+  const std::vector<char> beamflag = Apply(400.0);
+  for (int i = 0; i < kBeams; i++)
+    EXPECT_EQ(i == 4 ? MB_FLAG_NONE : MB_FLAG_NULL, beamflag[i]) << i;
+}
+
+}  // namespace
@@ -0,0 +1,108 @@
+// See README file for copying and redistribution conditions.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <unistd.h>
+
+#include "mb_define.h"
+#include "mb_io.h"
+#include "mb_status.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Writes a small file and a ~/.mbio_defaults selecting the requested
+// fileiobuffer mode, then opens the file through mb_fileio_open().
+class MbFileioTest : public testing::TestWithParam<int> {
+ protected:
+  void SetUp() override {
+    char tmpdir[] = "/tmp/mb_fileio_test_XXXXXX";
+    ASSERT_NE(nullptr, mkdtemp(tmpdir));
+    dir_ = tmpdir;
+    const char *home = getenv("HOME");
+    if (home != nullptr)
+      home_ = home;
+    setenv("HOME", dir_.c_str(), 1);
+
+    FILE *fp = fopen((dir_ + "/.mbio_defaults").c_str(), "w");
+    ASSERT_NE(nullptr, fp);
+    fprintf(fp, "fileiobuffer:%d\n", GetParam());
+    fclose(fp);
+
+    file_ = dir_ + "/data.bin";
+    fp = fopen(file_.c_str(), "wb");
+    ASSERT_NE(nullptr, fp);
+    for (int i = 0; i < 256; i++)
+      fputc(i, fp);
+    fclose(fp);
+
+    memset(&mb_io_, 0, sizeof(mb_io_));
+    mb_io_.filemode = MB_FILEMODE_READ;
+    strcpy(mb_io_.file, file_.c_str());
+    mb_io_.mbfp = fopen(mb_io_.file, "rb");
+    ASSERT_NE(nullptr, mb_io_.mbfp);
+    int error = MB_ERROR_NO_ERROR;
+    ASSERT_EQ(MB_SUCCESS, mb_fileio_open(0, &mb_io_, &error));
+  }
+
+  void TearDown() override {
+    int error = MB_ERROR_NO_ERROR;
+    mb_fileio_close(0, &mb_io_, &error);
+    unlink(file_.c_str());
+    unlink((dir_ + "/.mbio_defaults").c_str());
+    rmdir(dir_.c_str());
+    if (!home_.empty())
+      setenv("HOME", home_.c_str(), 1);
+  }
+
+  std::string dir_;
+  std::string home_;
+  std::string file_;
+  struct mb_io_struct mb_io_;
+};
+
+TEST_P(MbFileioTest, GetSeekTell) {
+  const int verbose = 0;
+  int error = MB_ERROR_NO_ERROR;
+  if (GetParam() < 0)
+    EXPECT_NE(nullptr, mb_io_.file_mmap);
+  else
+    EXPECT_EQ(nullptr, mb_io_.file_mmap);
+
+  char buffer[16];
+  size_t size = 4;
+  EXPECT_EQ(MB_SUCCESS, mb_fileio_get(verbose, &mb_io_, buffer, &size, &error));
+  EXPECT_EQ(MB_ERROR_NO_ERROR, error);
+  EXPECT_EQ(4, size);
+  EXPECT_EQ(3, buffer[3]);
+  EXPECT_EQ(4, mb_fileio_tell(verbose, &mb_io_));
+
+  EXPECT_EQ(MB_SUCCESS, mb_fileio_seek(verbose, &mb_io_, 100, SEEK_SET, &error));
+  EXPECT_EQ(100, mb_fileio_tell(verbose, &mb_io_));
+  EXPECT_EQ(MB_SUCCESS, mb_fileio_seek(verbose, &mb_io_, -10, SEEK_CUR, &error));
+  EXPECT_EQ(90, mb_fileio_tell(verbose, &mb_io_));
+
+  char *data = nullptr;
+  size = 8;
+  EXPECT_EQ(MB_SUCCESS, mb_fileio_get_slice(verbose, &mb_io_, buffer, &data, &size, &error));
+  EXPECT_EQ(8, size);
+  EXPECT_EQ(90, static_cast<unsigned char>(data[0]));
+  EXPECT_EQ(97, static_cast<unsigned char>(data[7]));
+
+  // reading past the end returns the remaining bytes and an EOF error
+  EXPECT_EQ(MB_SUCCESS, mb_fileio_seek(verbose, &mb_io_, -2, SEEK_END, &error));
+  size = 4;
+  EXPECT_EQ(MB_FAILURE, mb_fileio_get(verbose, &mb_io_, buffer, &size, &error));
+  EXPECT_EQ(MB_ERROR_EOF, error);
+  EXPECT_EQ(2, size);
+  EXPECT_EQ(255, static_cast<unsigned char>(buffer[1]));
+}
+
+INSTANTIATE_TEST_SUITE_P(Modes, MbFileioTest, testing::Values(0, 64, -1));
+
+}  // namespace
@@ -4,6 +4,8 @@
 
 #include <cstdio>
 #include <cstdlib>
+#include <thread>
+#include <vector>
 
 #include "mb_define.h"
 #include "mb_status.h"
@@ -90,12 +92,70 @@ TEST(MbDebug, FreeNullptr) {
   EXPECT_EQ(MB_ERROR_NO_ERROR, error);
 }
 
-// TODO(schwehr): Test mb_mallocd
-// TODO(schwehr): Test mb_realloc
-// TODO(schwehr): Test mb_reallocd
-// TODO(schwehr): Test mb_freed
-// TODO(schwehr): Test mb_memory_clear
-// TODO(schwehr): Test mb_memory_status
+TEST(MbDebug, ReallocdStatus) {
+  int error = MB_ERROR_NO_ERROR;
+  int verbose = 0;
+  int nalloc = 0;
+  int nallocmax = 0;
+  int overflow = 0;
+  size_t allocsize = 0;
+  EXPECT_EQ(MB_SUCCESS, mb_memory_clear(verbose, &error));
+
+  void *ptr = nullptr;
+  EXPECT_EQ(MB_SUCCESS, mb_mallocd(verbose, __FILE__, __LINE__, 10, &ptr, &error));
+  EXPECT_EQ(MB_SUCCESS, mb_reallocd(verbose, __FILE__, __LINE__, 1000, &ptr, &error));
+  EXPECT_NE(nullptr, ptr);
+  EXPECT_EQ(MB_SUCCESS, mb_memory_status(verbose, &nalloc, &nallocmax, &overflow, &allocsize, &error));
+  EXPECT_EQ(1, nalloc);
+  EXPECT_EQ(0, overflow);
+  EXPECT_EQ(1000, allocsize);
+
+  EXPECT_EQ(MB_SUCCESS, mb_freed(verbose, __FILE__, __LINE__, &ptr, &error));
+  EXPECT_EQ(nullptr, ptr);
+  EXPECT_EQ(MB_SUCCESS, mb_memory_status(verbose, &nalloc, &nallocmax, &overflow, &allocsize, &error));
+  EXPECT_EQ(0, nalloc);
+  EXPECT_EQ(0, allocsize);
+  EXPECT_EQ(MB_ERROR_NO_ERROR, error);
+}
+
+// More allocations than the old fixed size list could hold, made and
+// released from several threads at once.
+TEST(MbDebug, Threads) {
+  int error = MB_ERROR_NO_ERROR;
+  const int verbose = 0;
+  const int nthread = 4;
+  const int nptr = 5000;
+  EXPECT_EQ(MB_SUCCESS, mb_memory_clear(verbose, &error));
+
+  std::vector<std::vector<void *>> ptrs(nthread, std::vector<void *>(nptr, nullptr));
+  std::vector<std::thread> threads;
+  for (int ithread = 0; ithread < nthread; ithread++)
+    threads.emplace_back([&ptrs, ithread]() {
+      int thread_error = MB_ERROR_NO_ERROR;
+      for (int i = 0; i < nptr; i++)
+        mb_mallocd(verbose, __FILE__, __LINE__, 8, &ptrs[ithread][i], &thread_error);
+      for (int i = 0; i < nptr; i += 2)
+        mb_freed(verbose, __FILE__, __LINE__, &ptrs[ithread][i], &thread_error);
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+
+  int nalloc = 0;
+  int nallocmax = 0;
+  int overflow = 0;
+  size_t allocsize = 0;
+  EXPECT_EQ(MB_SUCCESS, mb_memory_status(verbose, &nalloc, &nallocmax, &overflow, &allocsize, &error));
+  EXPECT_EQ(nthread * nptr / 2, nalloc);
+  EXPECT_EQ(0, overflow);
+  EXPECT_EQ(8 * nthread * nptr / 2, allocsize);
+
+  EXPECT_EQ(MB_SUCCESS, mb_memory_clear(verbose, &error));
+  EXPECT_EQ(MB_SUCCESS, mb_memory_status(verbose, &nalloc, &nallocmax, &overflow, &allocsize, &error));
+  EXPECT_EQ(0, nalloc);
+  EXPECT_EQ(MB_SUCCESS, mb_memory_sites(verbose, &error));
+  EXPECT_EQ(MB_ERROR_NO_ERROR, error);
+}
+
 // TODO(schwehr): Test mb_memory_list
 // TODO(schwehr): Test mb_register_array
 // TODO(schwehr): Test mb_update_arrays
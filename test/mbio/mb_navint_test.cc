@@ -0,0 +1,173 @@
+// See README file for copying and redistribution conditions.
+
+#include <memory>
+
+#include "mb_define.h"
+#include "mb_io.h"
+#include "mb_status.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+class MbNavintTest : public testing::Test {
+ protected:
+  void SetUp() override { mb_io_.reset(new mb_io_struct()); }
+
+  void TearDown() override {
+    int error = MB_ERROR_NO_ERROR;
+    EXPECT_EQ(MB_SUCCESS, mb_asynch_deall(0, mb_io_.get(), &error));
+  }
+
+  std::unique_ptr<mb_io_struct> mb_io_;
+};
+
+TEST_F(MbNavintTest, NoData) {
+  int error = MB_ERROR_NO_ERROR;
+  double heading = -1.0;
+  EXPECT_EQ(MB_FAILURE, mb_hedint_interp(0, mb_io_.get(), 10.0, &heading, &error));
+  EXPECT_EQ(MB_ERROR_NOT_ENOUGH_DATA, error);
+  EXPECT_DOUBLE_EQ(0.0, heading);
+}
+
+TEST_F(MbNavintTest, Interpolate) {
+  const int verbose = 0;
+  int error = MB_ERROR_NO_ERROR;
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(MB_SUCCESS, mb_depint_add(verbose, mb_io_.get(), 100.0 + i, 2.0 * i, &error));
+  }
+  // repeated time stamps are ignored
+  EXPECT_EQ(MB_SUCCESS, mb_depint_add(verbose, mb_io_.get(), 100.0, 50.0, &error));
+  EXPECT_EQ(1000, mb_io_->asynch_sensordepth.nsample);
+
+  double sensordepth = 0.0;
+  EXPECT_EQ(MB_SUCCESS, mb_depint_interp(verbose, mb_io_.get(), 100.0, &sensordepth, &error));
+  EXPECT_DOUBLE_EQ(0.0, sensordepth);
+  EXPECT_EQ(MB_SUCCESS, mb_depint_interp(verbose, mb_io_.get(), 600.25, &sensordepth, &error));
+  EXPECT_DOUBLE_EQ(1000.5, sensordepth);
+  EXPECT_EQ(MB_SUCCESS, mb_depint_interp(verbose, mb_io_.get(), 600.75, &sensordepth, &error));
+  EXPECT_DOUBLE_EQ(1001.5, sensordepth);
+  EXPECT_EQ(MB_SUCCESS, mb_depint_interp(verbose, mb_io_.get(), 150.5, &sensordepth, &error));
+  EXPECT_DOUBLE_EQ(101.0, sensordepth);
+  EXPECT_EQ(MB_SUCCESS, mb_depint_interp(verbose, mb_io_.get(), 1099.0, &sensordepth, &error));
+  EXPECT_DOUBLE_EQ(1998.0, sensordepth);
+
+  // outside the data the first or last values are used
+  EXPECT_EQ(MB_SUCCESS, mb_depint_interp(verbose, mb_io_.get(), 50.0, &sensordepth, &error));
+  EXPECT_DOUBLE_EQ(0.0, sensordepth);
+  EXPECT_EQ(MB_SUCCESS, mb_depint_interp(verbose, mb_io_.get(), 2000.0, &sensordepth, &error));
+  EXPECT_DOUBLE_EQ(1998.0, sensordepth);
+}
+
+TEST_F(MbNavintTest, HeadingWraps) {
+  const int verbose = 0;
+  int error = MB_ERROR_NO_ERROR;
+  EXPECT_EQ(MB_SUCCESS, mb_hedint_add(verbose, mb_io_.get(), 1.0, 350.0, &error));
+  EXPECT_EQ(MB_SUCCESS, mb_hedint_add(verbose, mb_io_.get(), 2.0, 10.0, &error));
+  double heading = 0.0;
+  EXPECT_EQ(MB_SUCCESS, mb_hedint_interp(verbose, mb_io_.get(), 1.75, &heading, &error));
+  EXPECT_DOUBLE_EQ(5.0, heading);
+}
+
+// Once full, the buffer keeps the most recent MB_ASYNCH_SAVE_MAX samples.
+TEST_F(MbNavintTest, RingBufferWraps) {
+  const int verbose = 0;
+  int error = MB_ERROR_NO_ERROR;
+  const int nsamples = 2 * MB_ASYNCH_SAVE_MAX + 123;
+  for (int i = 0; i < nsamples; i++) {
+    const double t = 0.005 * i;
+    EXPECT_EQ(MB_SUCCESS, mb_attint_add(verbose, mb_io_.get(), t, 0.1 * i, 0.2 * i, 0.3 * i, &error));
+  }
+  EXPECT_EQ(MB_ASYNCH_SAVE_MAX, mb_io_->asynch_attitude.nsample);
+  EXPECT_EQ(MB_ASYNCH_SAVE_MAX, mb_io_->asynch_attitude.nalloc);
+
+  double heave = 0.0;
+  double roll = 0.0;
+  double pitch = 0.0;
+  const int ioldest = nsamples - MB_ASYNCH_SAVE_MAX;
+  EXPECT_EQ(MB_SUCCESS, mb_attint_interp(verbose, mb_io_.get(), 0.0, &heave, &roll, &pitch, &error));
+  EXPECT_NEAR(0.2 * ioldest, roll, 1.0e-9);
+
+  // interpolate at increasing and then decreasing times across the wrap
+  for (int i = ioldest; i < nsamples - 1; i += 7) {
+    const double t = 0.005 * (i + 0.5);
+    EXPECT_EQ(MB_SUCCESS, mb_attint_interp(verbose, mb_io_.get(), t, &heave, &roll, &pitch, &error));
+    EXPECT_NEAR(0.1 * (i + 0.5), heave, 1.0e-6);
+    EXPECT_NEAR(0.3 * (i + 0.5), pitch, 1.0e-6);
+  }
+  for (int i = nsamples - 2; i >= ioldest; i -= 1013) {
+    const double t = 0.005 * (i + 0.25);
+    EXPECT_EQ(MB_SUCCESS, mb_attint_interp(verbose, mb_io_.get(), t, &heave, &roll, &pitch, &error));
+    EXPECT_NEAR(0.2 * (i + 0.25), roll, 1.0e-6);
+  }
+}
+
+// Samples are copied oldest first into contiguous arrays, one per quantity.
+TEST_F(MbNavintTest, SampleAndUnroll) {
+  const int verbose = 0;
+  int error = MB_ERROR_NO_ERROR;
+  const int nsamples = MB_ASYNCH_SAVE_MAX + 10;
+  for (int i = 0; i < nsamples; i++) {
+    EXPECT_EQ(MB_SUCCESS, mb_navint_add(verbose, mb_io_.get(), 1.0 * i, 2.0 * i, 3.0 * i, &error));
+  }
+
+  double time_d = 0.0;
+  double lonlat[2] = {0.0, 0.0};
+  EXPECT_EQ(MB_SUCCESS, mb_asynch_sample(verbose, &mb_io_->asynch_fix, 0, &time_d, lonlat, &error));
+  EXPECT_DOUBLE_EQ(10.0, time_d);
+  EXPECT_DOUBLE_EQ(30.0, lonlat[1]);
+  EXPECT_EQ(MB_FAILURE, mb_asynch_sample(verbose, &mb_io_->asynch_fix, -1, &time_d, lonlat, &error));
+  EXPECT_EQ(MB_ERROR_NOT_ENOUGH_DATA, error);
+
+  int n = 0;
+  double *times = nullptr;
+  double *values = nullptr;
+  EXPECT_EQ(MB_SUCCESS, mb_asynch_unroll(verbose, &mb_io_->asynch_fix, &n, &times, &values, &error));
+  ASSERT_EQ(MB_ASYNCH_SAVE_MAX, n);
+  for (int i = 0; i < n; i += 997) {
+    EXPECT_DOUBLE_EQ(10.0 + i, times[i]);
+    EXPECT_DOUBLE_EQ(2.0 * (10 + i), values[i]);
+    EXPECT_DOUBLE_EQ(3.0 * (10 + i), values[n + i]);
+  }
+
+  // An unchanged buffer is not copied again, a changed one is.
+  EXPECT_EQ(MB_SUCCESS, mb_asynch_unroll(verbose, &mb_io_->asynch_fix, &n, &times, &values, &error));
+  EXPECT_DOUBLE_EQ(10.0, times[0]);
+  EXPECT_DOUBLE_EQ(3.0 * (nsamples - 1), values[2 * n - 1]);
+  EXPECT_EQ(MB_SUCCESS, mb_navint_add(verbose, mb_io_.get(), 1.0 * nsamples, 2.0 * nsamples, 3.0 * nsamples, &error));
+  EXPECT_EQ(MB_SUCCESS, mb_asynch_unroll(verbose, &mb_io_->asynch_fix, &n, &times, &values, &error));
+  ASSERT_EQ(MB_ASYNCH_SAVE_MAX, n);
+  EXPECT_DOUBLE_EQ(11.0, times[0]);
+  EXPECT_DOUBLE_EQ(1.0 * nsamples, times[n - 1]);
+  EXPECT_DOUBLE_EQ(3.0 * nsamples, values[2 * n - 1]);
+
+  EXPECT_EQ(MB_SUCCESS, mb_asynch_reset(verbose, &mb_io_->asynch_fix, &error));
+  EXPECT_EQ(MB_SUCCESS, mb_asynch_unroll(verbose, &mb_io_->asynch_fix, &n, &times, &values, &error));
+  EXPECT_EQ(0, n);
+  EXPECT_EQ(MB_SUCCESS, mb_navint_add(verbose, mb_io_.get(), 5.0, 6.0, 7.0, &error));
+  EXPECT_EQ(MB_SUCCESS, mb_asynch_sample(verbose, &mb_io_->asynch_fix, 0, &time_d, lonlat, &error));
+  EXPECT_DOUBLE_EQ(5.0, time_d);
+  EXPECT_DOUBLE_EQ(6.0, lonlat[0]);
+}
+
+TEST_F(MbNavintTest, NavExtrapolate) {
+  const int verbose = 0;
+  int error = MB_ERROR_NO_ERROR;
+  EXPECT_EQ(MB_SUCCESS, mb_navint_add(verbose, mb_io_.get(), 10.0, 100.0, 200.0, &error));
+  EXPECT_EQ(MB_SUCCESS, mb_navint_add(verbose, mb_io_.get(), 20.0, 100.0, 300.0, &error));
+  double easting = 0.0;
+  double northing = 0.0;
+  double speed = 0.0;
+  EXPECT_EQ(MB_SUCCESS, mb_navint_prjinterp(verbose, mb_io_.get(), 12.5, 0.0, 0.0, &easting, &northing, &speed, &error));
+  EXPECT_DOUBLE_EQ(100.0, easting);
+  EXPECT_DOUBLE_EQ(225.0, northing);
+  EXPECT_DOUBLE_EQ(36.0, speed);
+
+  // heading north at 10 m/s for another 5 seconds
+  EXPECT_EQ(MB_SUCCESS, mb_navint_prjinterp(verbose, mb_io_.get(), 25.0, 0.0, 0.0, &easting, &northing, &speed, &error));
+  EXPECT_NEAR(100.0, easting, 1.0e-9);
+  EXPECT_NEAR(350.0, northing, 1.0e-9);
+}
+
+}  // namespace
@@ -0,0 +1,149 @@
+// See README file for copying and redistribution conditions.
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include "mb_define.h"
+#include "mb_io.h"
+#include "mb_status.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+const int kRecords = 1000;
+
+// A format whose records hold a sequence number, plus a count that is
+// carried from record to record in the store.
+struct TestStore {
+  int sequence;
+  int carried;
+};
+
+int TestStoreAlloc(int /* verbose */, void * /* mbio_ptr */, void **store_ptr, int *error) {
+  *store_ptr = calloc(1, sizeof(TestStore));
+  *error = MB_ERROR_NO_ERROR;
+  return MB_SUCCESS;
+}
+
+int TestStoreFree(int /* verbose */, void * /* mbio_ptr */, void **store_ptr, int *error) {
+  free(*store_ptr);
+  *store_ptr = nullptr;
+  *error = MB_ERROR_NO_ERROR;
+  return MB_SUCCESS;
+}
+
+int TestCopyRecord(int /* verbose */, void * /* mbio_ptr */, void *store_ptr, void *copy_ptr, int *error) {
+  memcpy(copy_ptr, store_ptr, sizeof(TestStore));
+  *error = MB_ERROR_NO_ERROR;
+  return MB_SUCCESS;
+}
+
+int TestReadPing(int /* verbose */, void *mbio_ptr, void *store_ptr, int *error) {
+  mb_io_struct *mb_io_ptr = static_cast<mb_io_struct *>(mbio_ptr);
+  TestStore *store = static_cast<TestStore *>(store_ptr);
+  if (mb_io_ptr->save1 >= kRecords) {
+    *error = MB_ERROR_EOF;
+    return MB_FAILURE;
+  }
+  store->sequence = mb_io_ptr->save1++;
+  store->carried++;
+  mb_io_ptr->new_kind = store->sequence % 10 == 0 ? MB_DATA_COMMENT : MB_DATA_NAV;
+  mb_io_ptr->new_time_d = store->sequence;
+  *error = MB_ERROR_NO_ERROR;
+  return MB_SUCCESS;
+}
+
+class MbReadaheadTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    mb_io_.reset(new mb_io_struct());
+    mb_io_->mb_io_store_alloc = &TestStoreAlloc;
+    mb_io_->mb_io_store_free = &TestStoreFree;
+    mb_io_->mb_io_copyrecord = &TestCopyRecord;
+    mb_io_->mb_io_read_ping = &TestReadPing;
+    int error = MB_ERROR_NO_ERROR;
+    TestStoreAlloc(0, mb_io_.get(), &mb_io_->store_data, &error);
+  }
+
+  void TearDown() override {
+    int error = MB_ERROR_NO_ERROR;
+    EXPECT_EQ(MB_SUCCESS, mb_readahead_deall(0, mb_io_.get(), &error));
+    EXPECT_EQ(nullptr, mb_io_->readahead);
+    TestStoreFree(0, mb_io_.get(), &mb_io_->store_data, &error);
+  }
+
+  std::unique_ptr<mb_io_struct> mb_io_;
+};
+
+TEST_F(MbReadaheadTest, RequiresCopy) {
+  int error = MB_ERROR_NO_ERROR;
+  mb_io_->mb_io_copyrecord = nullptr;
+  EXPECT_EQ(MB_FAILURE, mb_readahead_init(0, mb_io_.get(), 4, &error));
+  EXPECT_EQ(MB_ERROR_BAD_USAGE, error);
+  EXPECT_EQ(nullptr, mb_io_->readahead);
+}
+
+TEST_F(MbReadaheadTest, PreservesOrder) {
+  int error = MB_ERROR_NO_ERROR;
+  ASSERT_EQ(MB_SUCCESS, mb_readahead_init(0, mb_io_.get(), 4, &error));
+  for (int i = 0; i < kRecords; i++) {
+    int kind = MB_DATA_NONE;
+    ASSERT_EQ(MB_SUCCESS, mb_read_ping(0, mb_io_.get(), nullptr, &kind, &error));
+    const TestStore *store = static_cast<TestStore *>(mb_io_->store_data);
+    EXPECT_EQ(i, store->sequence);
+    EXPECT_EQ(i + 1, store->carried);
+    EXPECT_EQ(i % 10 == 0 ? MB_DATA_COMMENT : MB_DATA_NAV, kind);
+    // the mbio descriptor is shared with the reader thread
+    EXPECT_EQ(MB_SUCCESS, mb_readahead_lock(0, mb_io_.get(), &error));
+    EXPECT_DOUBLE_EQ(i, mb_io_->new_time_d);
+    EXPECT_EQ(MB_SUCCESS, mb_readahead_unlock(0, mb_io_.get(), &error));
+  }
+
+  // the end of file is reported until the file is closed
+  for (int pass = 0; pass < 2; pass++) {
+    int kind = MB_DATA_DATA;
+    EXPECT_EQ(MB_FAILURE, mb_read_ping(0, mb_io_.get(), nullptr, &kind, &error));
+    EXPECT_EQ(MB_ERROR_EOF, error);
+    EXPECT_EQ(MB_DATA_NONE, kind);
+  }
+}
+
+// The mb_access functions lock inside callers that already hold the lock.
+TEST_F(MbReadaheadTest, NestedLock) {
+  int error = MB_ERROR_NO_ERROR;
+  ASSERT_EQ(MB_SUCCESS, mb_readahead_init(0, mb_io_.get(), 2, &error));
+  int kind = MB_DATA_NONE;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(MB_SUCCESS, mb_read_ping(0, mb_io_.get(), nullptr, &kind, &error));
+    EXPECT_EQ(MB_SUCCESS, mb_readahead_lock(0, mb_io_.get(), &error));
+    EXPECT_EQ(MB_SUCCESS, mb_readahead_lock(0, mb_io_.get(), &error));
+    EXPECT_DOUBLE_EQ(i, mb_io_->new_time_d);
+    EXPECT_EQ(MB_SUCCESS, mb_readahead_unlock(0, mb_io_.get(), &error));
+    EXPECT_EQ(MB_SUCCESS, mb_readahead_unlock(0, mb_io_.get(), &error));
+  }
+}
+
+TEST_F(MbReadaheadTest, CopiesIntoCallerStore) {
+  int error = MB_ERROR_NO_ERROR;
+  ASSERT_EQ(MB_SUCCESS, mb_readahead_init(0, mb_io_.get(), 1, &error));
+  TestStore store = {-1, -1};
+  int kind = MB_DATA_NONE;
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(MB_SUCCESS, mb_read_ping(0, mb_io_.get(), &store, &kind, &error));
+    EXPECT_EQ(i, store.sequence);
+  }
+}
+
+// Closing with records still queued stops the reader thread.
+TEST_F(MbReadaheadTest, StopEarly) {
+  int error = MB_ERROR_NO_ERROR;
+  ASSERT_EQ(MB_SUCCESS, mb_readahead_init(0, mb_io_.get(), MB_READAHEAD_MAX, &error));
+  int kind = MB_DATA_NONE;
+  ASSERT_EQ(MB_SUCCESS, mb_read_ping(0, mb_io_.get(), nullptr, &kind, &error));
+  EXPECT_EQ(0, static_cast<TestStore *>(mb_io_->store_data)->sequence);
+}
+
+}  // namespace
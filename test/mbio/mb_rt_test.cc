@@ -0,0 +1,95 @@
+// See README file for copying and redistribution conditions.
+
+#include <cmath>
+#include <vector>
+
+#include "mb_define.h"
+#include "mb_status.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+const double kTolerance = 0.05;
+
+// A deep water profile with a sound channel, sampled like a CTD cast.
+class MbRtTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    for (double z = 0.0; z <= 6000.0; z += z < 200.0 ? 2.0 : 50.0) {
+      const double eta = 2.0 * (z - 1300.0) / 1300.0;
+      depth_.push_back(z);
+      velocity_.push_back(1500.0 * (1.0 + 0.00737 * (eta - 1.0 + exp(-eta))));
+    }
+    int error = MB_ERROR_NO_ERROR;
+    ASSERT_EQ(MB_SUCCESS, mb_rt_init(0, depth_.size(), depth_.data(), velocity_.data(), &model_, &error));
+  }
+
+  void TearDown() override {
+    int error = MB_ERROR_NO_ERROR;
+    EXPECT_EQ(MB_SUCCESS, mb_rt_deall(0, &model_, &error));
+  }
+
+  std::vector<double> depth_;
+  std::vector<double> velocity_;
+  void *model_ = nullptr;
+};
+
+// The table lookup must reproduce full raytracing for any source depth.
+TEST_F(MbRtTest, TableMatchesRaytrace) {
+  int error = MB_ERROR_NO_ERROR;
+  for (double source_depth : {0.0, 5.3, 47.9, 180.0}) {
+    for (double angle = -80.0; angle <= 80.0; angle += 7.3) {
+      for (double ttime : {0.01, 0.4, 1.7, 3.9}) {
+        for (int ssv_mode = 0; ssv_mode < 3; ssv_mode++) {
+          double x = 0.0;
+          double z = 0.0;
+          double travel_time = 0.0;
+          int ray_stat = 0;
+          int nplot = 0;
+          EXPECT_EQ(MB_SUCCESS, mb_rt(0, model_, source_depth, angle, ttime, ssv_mode, 1510.0, 3.0, 0, &nplot, nullptr,
+                                      nullptr, nullptr, &x, &z, &travel_time, &ray_stat, &error));
+          double x_table = 0.0;
+          double z_table = 0.0;
+          double travel_time_table = 0.0;
+          int ray_stat_table = 0;
+          EXPECT_EQ(MB_SUCCESS, mb_rt_table(0, model_, source_depth, angle, ttime, ssv_mode, 1510.0, 3.0, &x_table, &z_table,
+                                            &travel_time_table, &ray_stat_table, &error));
+          EXPECT_NEAR(x, x_table, kTolerance) << source_depth << " " << angle << " " << ttime << " " << ssv_mode;
+          EXPECT_NEAR(z, z_table, kTolerance) << source_depth << " " << angle << " " << ttime << " " << ssv_mode;
+          EXPECT_NEAR(travel_time, travel_time_table, 1.0e-9);
+        }
+      }
+    }
+  }
+}
+
+// Rays leaving the model or starting outside it fall back to raytracing.
+TEST_F(MbRtTest, Fallback) {
+  int error = MB_ERROR_NO_ERROR;
+  double x = 0.0;
+  double z = 0.0;
+  double travel_time = 0.0;
+  int ray_stat = 0;
+  EXPECT_EQ(MB_SUCCESS, mb_rt_table(0, model_, 10.0, 0.0, 10.0, 0, 0.0, 0.0, &x, &z, &travel_time, &ray_stat, &error));
+  EXPECT_DOUBLE_EQ(6000.0, z);
+  EXPECT_LT(travel_time, 10.0);
+  EXPECT_EQ(MB_FAILURE, mb_rt_table(0, model_, 7000.0, 0.0, 1.0, 0, 0.0, 0.0, &x, &z, &travel_time, &ray_stat, &error));
+  EXPECT_EQ(MB_ERROR_BAD_PARAMETER, error);
+
+  // travel times beyond the table limit are traced directly
+  int nplot = 0;
+  double x_rt = 0.0;
+  double z_rt = 0.0;
+  double travel_time_rt = 0.0;
+  int ray_stat_rt = 0;
+  EXPECT_EQ(MB_SUCCESS, mb_rt(0, model_, 10.0, 60.0, 25.0, 0, 0.0, 0.0, 0, &nplot, nullptr, nullptr, nullptr, &x_rt,
+                              &z_rt, &travel_time_rt, &ray_stat_rt, &error));
+  EXPECT_EQ(MB_SUCCESS, mb_rt_table(0, model_, 10.0, 60.0, 25.0, 0, 0.0, 0.0, &x, &z, &travel_time, &ray_stat, &error));
+  EXPECT_DOUBLE_EQ(x_rt, x);
+  EXPECT_DOUBLE_EQ(z_rt, z);
+  EXPECT_DOUBLE_EQ(travel_time_rt, travel_time);
+}
+
+}  // namespace
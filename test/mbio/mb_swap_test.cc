@@ -0,0 +1,101 @@
+// See README file for copying and redistribution conditions.
+
+#include <cstdint>
+#include <cstring>
+
+#include "mb_define.h"
+#include "mb_swap.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Big endian encodings of 0x0102, 0x01020304 and 1.5.
+const unsigned char kShortBig[2] = {0x01, 0x02};
+const unsigned char kIntBig[4] = {0x01, 0x02, 0x03, 0x04};
+const unsigned char kFloatBig[4] = {0x3f, 0xc0, 0x00, 0x00};
+const unsigned char kDoubleBig[8] = {0x3f, 0xf8, 0, 0, 0, 0, 0, 0};
+
+TEST(MbSwapTest, Inline) {
+  short s = 0;
+  mb_get_binary_short_inline(false, kShortBig, &s);
+  EXPECT_EQ(0x0102, s);
+  const unsigned char short_little[2] = {0x02, 0x01};
+  mb_get_binary_short_inline(true, short_little, &s);
+  EXPECT_EQ(0x0102, s);
+
+  int i = 0;
+  mb_get_binary_int_inline(false, kIntBig, &i);
+  EXPECT_EQ(0x01020304, i);
+
+  float f = 0.0f;
+  mb_get_binary_float_inline(false, kFloatBig, &f);
+  EXPECT_FLOAT_EQ(1.5f, f);
+
+  double d = 0.0;
+  mb_get_binary_double_inline(false, kDoubleBig, &d);
+  EXPECT_DOUBLE_EQ(1.5, d);
+}
+
+// The inline and out of line decoders must agree.
+TEST(MbSwapTest, MatchesGetBinary) {
+  for (int swapped = 0; swapped < 2; swapped++) {
+    double a = 0.0;
+    double b = 0.0;
+    mb_get_binary_double(swapped, const_cast<unsigned char *>(kDoubleBig), &a);
+    mb_get_binary_double_inline(swapped, kDoubleBig, &b);
+    EXPECT_EQ(0, memcmp(&a, &b, sizeof(a)));
+    int c = 0;
+    int e = 0;
+    mb_get_binary_int(swapped, const_cast<unsigned char *>(kIntBig), &c);
+    mb_get_binary_int_inline(swapped, kIntBig, &e);
+    EXPECT_EQ(c, e);
+  }
+}
+
+TEST(MbSwapTest, Arrays) {
+  // odd lengths exercise the loop tails left after vectorization
+  const int n = 37;
+  unsigned char buffer[8 * n];
+  for (int k = 0; k < n; k++)
+    memcpy(&buffer[4 * k], kFloatBig, 4);
+  float floats[n];
+  mb_get_binary_float_array(false, buffer, n, floats);
+  for (int k = 0; k < n; k++)
+    EXPECT_FLOAT_EQ(1.5f, floats[k]);
+
+  for (int k = 0; k < n; k++)
+    memcpy(&buffer[8 * k], kDoubleBig, 8);
+  double doubles[n];
+  mb_get_binary_double_array(false, buffer, n, doubles);
+  for (int k = 0; k < n; k++)
+    EXPECT_DOUBLE_EQ(1.5, doubles[k]);
+
+  // in place conversion
+  short shorts[n];
+  for (int k = 0; k < n; k++)
+    memcpy(&shorts[k], kShortBig, 2);
+  mb_get_binary_short_array(false, shorts, n, shorts);
+  for (int k = 0; k < n; k++)
+    EXPECT_EQ(0x0102, shorts[k]);
+  mb_get_binary_short_array(true, shorts, n, shorts);
+  for (int k = 0; k < n; k++)
+    EXPECT_EQ(0x0102, shorts[k]);
+}
+
+TEST(MbSwapTest, Strided) {
+  // records of a float followed by a 3 byte field
+  const int n = 9;
+  const int stride = 7;
+  unsigned char buffer[stride * n];
+  memset(buffer, 0xff, sizeof(buffer));
+  for (int k = 0; k < n; k++)
+    memcpy(&buffer[stride * k], kFloatBig, 4);
+  float floats[n];
+  mb_get_binary_float_strided(false, buffer, stride, n, floats);
+  for (int k = 0; k < n; k++)
+    EXPECT_FLOAT_EQ(1.5f, floats[k]);
+}
+
+}  // namespace
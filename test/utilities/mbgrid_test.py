@@ -8,6 +8,7 @@
 
 import os
 import subprocess
+import tempfile
 import unittest
 
 
@@ -49,7 +50,28 @@ class MbGridTest(unittest.TestCase):
     self.assertIn('lonflip', output)
     self.assertIn('minormax_weighted_mean_threshold:', output)
 
-  # TODO(schwehr): Add tests of actual usage.
+  def testSplineInterpolationThreads(self):
+    # Filling a 100 by 100 grid with the spline interpolation uses the
+    # multithreaded relaxation, whose result must not depend on the number
+    # of threads.
+    datafile = os.path.abspath('testdata/mb21/TN136HS.309.snipped.mb21')
+    with tempfile.TemporaryDirectory() as tmpdir:
+      datalist = os.path.join(tmpdir, 'datalist.mb-1')
+      with open(datalist, 'w') as f:
+        f.write(datafile + ' 21\n')
+      grids = []
+      for threads in (2, 4):
+        root = os.path.join(tmpdir, 'grid%d' % threads)
+        cmd = [self.cmd, '-I' + datalist, '-O' + root, '-A2', '-D100/100', '-G1', '-C100/3',
+               '--threads=%d' % threads]
+        output = subprocess.check_output(cmd, stderr=subprocess.STDOUT).decode()
+        self.assertIn('Applying spline interpolation', output)
+        # skip the header lines naming the user, host and date
+        with open(root + '.asc') as f:
+          grids.append(f.read().splitlines()[2:])
+      self.assertEqual(grids[0], grids[1])
+
+  # TODO(schwehr): Add more tests of actual usage.
 
 
 if __name__ == '__main__':